@@ -44,6 +44,11 @@ bool AnimationResourceFactory::isCacheable(const TypeInfo& productType) const
 	return true;
 }
 
+bool AnimationResourceFactory::isAsyncSafe() const
+{
+	return true;
+}
+
 Ref< Object > AnimationResourceFactory::create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const
 {
 	Ref< Object > object = instance->getObject();
@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include "Core/Io/DynamicMemoryStream.h"
 #include "Core/Log/Log.h"
 #include "Core/Thread/Acquire.h"
 #include "Avalanche/Protocol.h"
@@ -53,40 +55,79 @@ bool Client::ping()
 
 bool Client::have(const Key& key)
 {
-	Ref< net::SocketStream > stream  = establish(c_commandStat);
+	int64_t blobSize = -1;
+	return stat(key, blobSize) && blobSize >= 0;
+}
+
+uint32_t Client::getProtocolVersion()
+{
+	const uint32_t protocolVersion = m_protocolVersion.load(std::memory_order_acquire);
+	if (protocolVersion != 0)
+		return protocolVersion;
+
+	// Only one thread query server, others wait for result.
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_versionLock);
+	if (m_protocolVersion.load(std::memory_order_acquire) != 0)
+		return m_protocolVersion;
+
+	// Always query through a new connection since a pooled connection
+	// might have been closed by server, which is indistinguishable from
+	// a server which doesn't support version query.
+	Ref< net::SocketStream > stream = establish(c_commandVersion, false);
 	if (!stream)
-		return false;
+		return 1;
 
-	if (!key.write(stream))
+	uint8_t reply = 0;
+	uint32_t version = 0;
+	const int64_t nread = stream->read(&reply, sizeof(uint8_t));
+	if (
+		nread == sizeof(uint8_t) &&
+		reply == c_replyOk &&
+		stream->read(&version, sizeof(uint32_t)) == sizeof(uint32_t)
+	)
 	{
-		log::error << L"Unable to write key to server (have)." << Endl;
-		return false;
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		m_streams.push_back(stream);
 	}
-
-	uint8_t reply = 0;
-	if (stream->read(&reply, sizeof(uint8_t)) != sizeof(uint8_t))
+	else if (nread == 0)
 	{
-		log::error << L"Unable to read reply from server (have)." << Endl;
-		return false;
+		// Servers which predate version query terminate connection.
+		version = 1;
 	}
-
-	if (reply == c_replyOk)
+	else
 	{
-		int64_t blobSize = 0;
-		if (stream->read(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
-		{
-			log::error << L"Unable to read blob size from server (have)." << Endl;
-			return false;
-		}
+		// Transient error; fall back to version 1 requests but query again next time.
+		log::warning << L"Unable to query protocol version of avalanche server; will retry." << Endl;
+		return 1;
 	}
 
-	if (reply == c_replyOk || reply == c_replyFailure)
+	m_protocolVersion.store(version, std::memory_order_release);
+	return version;
+}
+
+bool Client::stat(const AlignedVector< Key >& keys, AlignedVector< int64_t >& outBlobSizes)
+{
+	outBlobSizes.resize(keys.size(), -1);
+
+	if (getProtocolVersion() < 2)
 	{
-		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-		m_streams.push_back(stream);
+		for (uint32_t i = 0; i < (uint32_t)keys.size(); ++i)
+		{
+			if (!stat(keys[i], outBlobSizes[i]))
+				return false;
+		}
+		return true;
 	}
 
-	return reply == c_replyOk;
+	return pipeline(c_commandStatBatch, keys, [&](net::SocketStream* stream, uint32_t offset, uint32_t count) {
+		const int64_t nbytes = count * sizeof(int64_t);
+		if (stream->read(&outBlobSizes[offset], nbytes) != nbytes)
+		{
+			log::error << L"Unable to read reply from server (stat)." << Endl;
+			return false;
+		}
+		return true;
+	});
 }
 
 bool Client::touch(const AlignedVector< Key >& keys)
@@ -206,6 +247,67 @@ Ref< IStream > Client::get(const Key& key)
 	return new ClientGetStream(this, stream, blobSize);
 }
 
+bool Client::get(const AlignedVector< Key >& keys, RefArray< IStream >& outBlobs)
+{
+	outBlobs.resize(keys.size());
+
+	if (getProtocolVersion() < 2)
+	{
+		for (uint32_t i = 0; i < (uint32_t)keys.size(); ++i)
+		{
+			Ref< IStream > stream = get(keys[i]);
+			if (!stream)
+			{
+				outBlobs[i] = nullptr;
+				continue;
+			}
+
+			const int64_t blobSize = stream->available();
+
+			Ref< DynamicMemoryStream > blobStream = new DynamicMemoryStream(true, false);
+			blobStream->getBuffer().resize((size_t)blobSize);
+			if (blobSize > 0 && stream->read(blobStream->getBuffer().ptr(), blobSize) != blobSize)
+			{
+				log::error << L"Unable to read blob from server (get)." << Endl;
+				return false;
+			}
+			stream->close();
+
+			outBlobs[i] = blobStream;
+		}
+		return true;
+	}
+
+	return pipeline(c_commandGetBatch, keys, [&](net::SocketStream* stream, uint32_t offset, uint32_t count) {
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			int64_t blobSize = 0;
+			if (stream->read(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
+			{
+				log::error << L"Unable to read blob size from server (get)." << Endl;
+				return false;
+			}
+
+			if (blobSize < 0)
+			{
+				outBlobs[offset + i] = nullptr;
+				continue;
+			}
+
+			Ref< DynamicMemoryStream > blobStream = new DynamicMemoryStream(true, false);
+			blobStream->getBuffer().resize((size_t)blobSize);
+			if (blobSize > 0 && stream->read(blobStream->getBuffer().ptr(), blobSize) != blobSize)
+			{
+				log::error << L"Unable to read blob from server (get)." << Endl;
+				return false;
+			}
+
+			outBlobs[offset + i] = blobStream;
+		}
+		return true;
+	});
+}
+
 Ref< IStream > Client::put(const Key& key)
 {
 	Ref< net::SocketStream > stream = establish(c_commandPut);
@@ -281,9 +383,49 @@ bool Client::getKeys(AlignedVector< Key >& outKeys)
 	return true;
 }
 
-Ref< net::SocketStream > Client::establish(uint8_t command)
+bool Client::stat(const Key& key, int64_t& outBlobSize)
 {
-	for (;;)
+	outBlobSize = -1;
+
+	Ref< net::SocketStream > stream  = establish(c_commandStat);
+	if (!stream)
+		return false;
+
+	if (!key.write(stream))
+	{
+		log::error << L"Unable to write key to server (stat)." << Endl;
+		return false;
+	}
+
+	uint8_t reply = 0;
+	if (stream->read(&reply, sizeof(uint8_t)) != sizeof(uint8_t))
+	{
+		log::error << L"Unable to read reply from server (stat)." << Endl;
+		return false;
+	}
+
+	if (reply == c_replyOk)
+	{
+		if (stream->read(&outBlobSize, sizeof(int64_t)) != sizeof(int64_t))
+		{
+			log::error << L"Unable to read blob size from server (stat)." << Endl;
+			return false;
+		}
+	}
+
+	if (reply == c_replyOk || reply == c_replyFailure)
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		m_streams.push_back(stream);
+		return true;
+	}
+
+	return false;
+}
+
+Ref< net::SocketStream > Client::establish(uint8_t command, bool pooled)
+{
+	while (pooled)
 	{
 		Ref< net::SocketStream > stream;
 		{
@@ -306,6 +448,10 @@ Ref< net::SocketStream > Client::establish(uint8_t command)
 		return nullptr;
 	}
 
+	// Requests are written in multiple small writes, disable Nagle
+	// so they are not held back waiting for acknowledgement.
+	socket->setNoDelay(true);
+
 	Ref< net::SocketStream > stream = new net::SocketStream(socket, true, true, 5000);
 	if (stream->write(&command, sizeof(uint8_t)) != sizeof(uint8_t))
 	{
@@ -316,4 +462,64 @@ Ref< net::SocketStream > Client::establish(uint8_t command)
 	return stream;
 }
 
+bool Client::pipeline(uint8_t command, const AlignedVector< Key >& keys, const std::function< bool (net::SocketStream* stream, uint32_t offset, uint32_t count) >& readReply)
+{
+	if (keys.empty())
+		return true;
+
+	Ref< net::SocketStream > stream = establish(command);
+	if (!stream)
+		return false;
+
+	const uint32_t nkeys = (uint32_t)keys.size();
+	const uint32_t nbatches = (nkeys + c_maxBatchKeys - 1) / c_maxBatchKeys;
+
+	AlignedVector< uint8_t > request;
+	uint32_t sent = 0;
+	uint32_t received = 0;
+
+	while (received < nbatches)
+	{
+		// Keep pipeline filled with requests; server process
+		// requests in order so replies are received in order.
+		while (sent < nbatches && sent - received < c_maxPipelineDepth)
+		{
+			const uint32_t offset = sent * c_maxBatchKeys;
+			const uint32_t count = std::min(nkeys - offset, c_maxBatchKeys);
+
+			// First command has already been sent when connection was established.
+			request.resize(0);
+			if (sent > 0)
+				request.push_back(command);
+			request.insert(request.end(), (const uint8_t*)&count, (const uint8_t*)&count + sizeof(uint32_t));
+
+			DynamicMemoryStream requestStream(request, false, true);
+			for (uint32_t i = 0; i < count; ++i)
+				keys[offset + i].write(&requestStream);
+
+			if (stream->write(request.c_ptr(), request.size()) != (int64_t)request.size())
+			{
+				log::error << L"Unable to write batch request to server." << Endl;
+				return false;
+			}
+
+			++sent;
+		}
+
+		// Read reply of oldest request.
+		const uint32_t offset = received * c_maxBatchKeys;
+		const uint32_t count = std::min(nkeys - offset, c_maxBatchKeys);
+		if (!readReply(stream, offset, count))
+			return false;
+
+		++received;
+	}
+
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		m_streams.push_back(stream);
+	}
+	return true;
+}
+
 }
@@ -8,6 +8,8 @@
  */
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include "Avalanche/Dictionary.h"
 #include "Core/Object.h"
 #include "Core/Ref.h"
@@ -46,12 +48,44 @@ public:
 
 	bool have(const Key& key);
 
+	/*! Get protocol version of server.
+	 *
+	 * Servers which predate version query
+	 * report version 1.
+	 */
+	uint32_t getProtocolVersion();
+
+	/*! Query size of multiple blobs.
+	 *
+	 * Keys are sent in batches and multiple batches
+	 * are kept in flight thus hiding round trip latency.
+	 * If server doesn't support batches then each key
+	 * is queried separately.
+	 *
+	 * \param keys Blob keys.
+	 * \param outBlobSizes Size of each blob, -1 if blob doesn't exist.
+	 * \return True if all replies received.
+	 */
+	bool stat(const AlignedVector< Key >& keys, AlignedVector< int64_t >& outBlobSizes);
+
 	bool touch(const AlignedVector< Key >& keys);
 
 	bool evict(const AlignedVector< Key >& keys);
 
 	Ref< IStream > get(const Key& key);
 
+	/*! Get multiple blobs.
+	 *
+	 * Blobs are read into memory, thus intended for
+	 * many small blobs. If server doesn't support batches
+	 * then each blob is requested separately.
+	 *
+	 * \param keys Blob keys.
+	 * \param outBlobs Stream of each blob, null if blob doesn't exist.
+	 * \return True if all replies received.
+	 */
+	bool get(const AlignedVector< Key >& keys, RefArray< IStream >& outBlobs);
+
 	Ref< IStream > put(const Key& key);
 
 	bool stats(Dictionary::Stats& outStats);
@@ -67,8 +101,14 @@ private:
 	net::SocketAddressIPv4 m_serverAddress;
 	RefArray< net::SocketStream > m_streams;
 	Semaphore m_lock;
+	Semaphore m_versionLock;
+	std::atomic< uint32_t > m_protocolVersion = 0;	//!< Protocol version of server, 0 if not yet queried.
+
+	Ref< net::SocketStream > establish(uint8_t command, bool pooled = true);
+
+	bool stat(const Key& key, int64_t& outBlobSize);
 
-	Ref< net::SocketStream > establish(uint8_t command);
+	bool pipeline(uint8_t command, const AlignedVector< Key >& keys, const std::function< bool (net::SocketStream* stream, uint32_t offset, uint32_t count) >& readReply);
 };
 
 }
@@ -0,0 +1,247 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#if defined(__LINUX__) || defined(__RPI__) || defined(__APPLE__)
+#	include <signal.h>
+#endif
+#include <atomic>
+#include "Avalanche/Client/Client.h"
+#include "Avalanche/Server/Server.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/IStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/CommandLine.h"
+#include "Core/Misc/SafeDestroy.h"
+#include "Core/Settings/PropertyGroup.h"
+#include "Core/Settings/PropertyInteger.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadPool.h"
+#include "Core/Timer/Timer.h"
+#include "Net/Network.h"
+#include "Net/SocketAddressIPv4.h"
+
+using namespace traktor;
+
+#if defined(T_STATIC)
+extern "C" void __module__Traktor_Core();
+#endif
+
+namespace
+{
+
+struct ClientResult
+{
+	double statTime = 0.0;
+	double getTime = 0.0;
+	double singleTime = 0.0;
+	uint32_t hits = 0;
+	uint32_t errors = 0;
+};
+
+Key createKey(int32_t index)
+{
+	return Key(0x41564c54, uint32_t(index + 1), 0x1234abcd, uint32_t(index * 2654435761U));
+}
+
+}
+
+int main(int argc, const char** argv)
+{
+#if defined(T_STATIC)
+	__module__Traktor_Core();
+#endif
+
+#if defined(__LINUX__) || defined(__RPI__) || defined(__APPLE__)
+	{
+		struct sigaction sa = { SIG_IGN };
+		sigaction(SIGPIPE, &sa, nullptr);
+	}
+#endif
+
+	CommandLine cmdLine(argc, argv);
+
+	if (cmdLine.hasOption('h', L"help"))
+	{
+		log::info << L"Usage: Traktor.Avalanche.LoadTest.App (options)" << Endl;
+		log::info << L"    -s, -server           Server host, if omitted a local server is launched." << Endl;
+		log::info << L"    -p, -port             Port number (default 40001)." << Endl;
+		log::info << L"    -c, -clients          Number of concurrent clients (default 8)." << Endl;
+		log::info << L"    -k, -keys             Number of keys (default 10000)." << Endl;
+		log::info << L"    -b, -blob-size        Size of each blob in bytes (default 1024)." << Endl;
+		log::info << L"    -w, -workers          Number of request worker threads in local server (default 4)." << Endl;
+		log::info << L"    -h, -help             Help" << Endl;
+		return 0;
+	}
+
+	const std::wstring host = cmdLine.hasOption('s', L"server") ? cmdLine.getOption('s', L"server").getString() : L"localhost";
+	const int32_t port = cmdLine.hasOption('p', L"port") ? cmdLine.getOption('p', L"port").getInteger() : 40001;
+	const int32_t clientCount = cmdLine.hasOption('c', L"clients") ? cmdLine.getOption('c', L"clients").getInteger() : 8;
+	const int32_t keyCount = cmdLine.hasOption('k', L"keys") ? cmdLine.getOption('k', L"keys").getInteger() : 10000;
+	const int32_t blobSize = cmdLine.hasOption('b', L"blob-size") ? cmdLine.getOption('b', L"blob-size").getInteger() : 1024;
+
+	if (clientCount <= 0 || keyCount <= 0 || blobSize <= 0)
+	{
+		log::error << L"Invalid arguments." << Endl;
+		return 1;
+	}
+
+	if (!net::Network::initialize())
+	{
+		log::error << L"Unable to initialize networking." << Endl;
+		return 1;
+	}
+
+	// Launch a local server unless a remote server is specified.
+	Ref< avalanche::Server > server;
+	Thread* serverThread = nullptr;
+	if (!cmdLine.hasOption('s', L"server"))
+	{
+		Ref< PropertyGroup > settings = new PropertyGroup();
+		settings->setProperty< PropertyInteger >(L"Avalanche.Port", port);
+		if (cmdLine.hasOption('w', L"workers"))
+			settings->setProperty< PropertyInteger >(L"Avalanche.WorkerThreads", cmdLine.getOption('w', L"workers").getInteger());
+
+		server = new avalanche::Server();
+		if (!server->create(settings))
+		{
+			log::error << L"Unable to create local server." << Endl;
+			return 1;
+		}
+
+		ThreadPool::getInstance().spawn([&]()
+			{
+				while (!serverThread->stopped())
+					server->update();
+			},
+			serverThread
+		);
+	}
+
+	const net::SocketAddressIPv4 serverAddress(host, port);
+
+	// Populate server with blobs.
+	{
+		Ref< avalanche::Client > client = new avalanche::Client(serverAddress);
+		if (!client->ping())
+		{
+			log::error << L"Unable to reach server at " << host << L":" << port << L"." << Endl;
+			return 1;
+		}
+
+		AlignedVector< uint8_t > blob(blobSize);
+		for (int32_t i = 0; i < blobSize; ++i)
+			blob[i] = uint8_t(i * 31);
+
+		AlignedVector< Key > keys;
+		for (int32_t i = 0; i < keyCount; ++i)
+			keys.push_back(createKey(i));
+
+		AlignedVector< int64_t > blobSizes;
+		client->stat(keys, blobSizes);
+
+		Timer timer;
+		int32_t npopulated = 0;
+		for (int32_t i = 0; i < keyCount; ++i)
+		{
+			if (blobSizes[i] >= 0)
+				continue;
+
+			Ref< IStream > stream = client->put(keys[i]);
+			if (!stream)
+				continue;
+
+			stream->write(blob.c_ptr(), blob.size());
+			stream->close();
+			++npopulated;
+		}
+
+		log::info << L"Populated " << npopulated << L" blob(s) in " << int32_t(timer.getElapsedTime() * 1000.0) << L" ms." << Endl;
+		client->destroy();
+	}
+
+	// Drive server with concurrent clients.
+	AlignedVector< Thread* > clientThreads(clientCount, nullptr);
+	AlignedVector< ClientResult > results(clientCount);
+
+	for (int32_t i = 0; i < clientCount; ++i)
+	{
+		ThreadPool::getInstance().spawn([&, i]()
+			{
+				ClientResult& result = results[i];
+				Ref< avalanche::Client > client = new avalanche::Client(serverAddress);
+
+				AlignedVector< Key > keys;
+				for (int32_t j = 0; j < keyCount; ++j)
+					keys.push_back(createKey((j + i * 7919) % keyCount));
+
+				// Batched and pipelined stat of all keys.
+				Timer timer;
+				AlignedVector< int64_t > blobSizes;
+				if (!client->stat(keys, blobSizes))
+					result.errors++;
+				result.statTime = timer.getElapsedTime();
+
+				for (auto blobSize : blobSizes)
+				{
+					if (blobSize >= 0)
+						result.hits++;
+				}
+
+				// Batched get of all blobs.
+				timer.reset();
+				RefArray< IStream > blobs;
+				if (!client->get(keys, blobs))
+					result.errors++;
+				result.getTime = timer.getElapsedTime();
+
+				// One round trip per key, for reference.
+				timer.reset();
+				const int32_t singleCount = std::min(keyCount, 1000);
+				for (int32_t j = 0; j < singleCount; ++j)
+				{
+					if (!client->have(keys[j]))
+						result.errors++;
+				}
+				result.singleTime = timer.getElapsedTime() * double(keyCount) / singleCount;
+
+				client->destroy();
+			},
+			clientThreads[i]
+		);
+	}
+
+	for (auto& clientThread : clientThreads)
+		ThreadPool::getInstance().join(clientThread);
+
+	// Report.
+	double statTime = 0.0, getTime = 0.0, singleTime = 0.0;
+	uint32_t hits = 0, errors = 0;
+	for (const auto& result : results)
+	{
+		statTime = std::max(statTime, result.statTime);
+		getTime = std::max(getTime, result.getTime);
+		singleTime = std::max(singleTime, result.singleTime);
+		hits += result.hits;
+		errors += result.errors;
+	}
+
+	const double totalKeys = double(keyCount) * clientCount;
+	log::info << clientCount << L" client(s), " << keyCount << L" key(s) each, " << blobSize << L" byte(s) per blob." << Endl;
+	log::info << L"  Batched stat    : " << int32_t(statTime * 1000.0) << L" ms, " << int32_t(totalKeys / statTime) << L" keys/s" << Endl;
+	log::info << L"  Batched get     : " << int32_t(getTime * 1000.0) << L" ms, " << int32_t(totalKeys / getTime) << L" keys/s, " << int32_t(totalKeys * blobSize / (getTime * 1024.0 * 1024.0)) << L" MiB/s" << Endl;
+	log::info << L"  Single stat     : " << int32_t(singleTime * 1000.0) << L" ms (estimated), " << int32_t(totalKeys / singleTime) << L" keys/s" << Endl;
+	log::info << L"  Hits            : " << hits << L" of " << uint32_t(totalKeys) << Endl;
+	log::info << L"  Errors          : " << errors << Endl;
+
+	if (serverThread)
+		ThreadPool::getInstance().stop(serverThread);
+	safeDestroy(server);
+
+	net::Network::finalize();
+	return errors == 0 ? 0 : 1;
+}
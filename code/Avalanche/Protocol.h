@@ -25,9 +25,16 @@ constexpr static uint8_t c_commandStats			= 0x05;
 constexpr static uint8_t c_commandKeys			= 0x06;
 constexpr static uint8_t c_commandTouch			= 0x07;
 constexpr static uint8_t c_commandEvict			= 0x08;
+constexpr static uint8_t c_commandStatBatch		= 0x09;
+constexpr static uint8_t c_commandGetBatch		= 0x0a;
+constexpr static uint8_t c_commandVersion		= 0x0b;
 
 constexpr static uint8_t c_subCommandPutAppend	= 0x41;
 constexpr static uint8_t c_subCommandPutCommit	= 0x42;
 constexpr static uint8_t c_subCommandPutDiscard	= 0x43;
 
+constexpr static uint32_t c_protocolVersion		= 2;		//!< Version 2 added batch and version commands.
+constexpr static uint32_t c_maxBatchKeys		= 512;		//!< Maximum number of keys in a single batch request.
+constexpr static uint32_t c_maxPipelineDepth	= 4;		//!< Maximum number of batch requests in flight.
+
 }
@@ -276,6 +276,7 @@ int main(int argc, const char** argv)
 		log::info << L"    -p, -port             Port number (default 40001)." << Endl;
 		log::info << L"    -d, -dictionary-path  Path to dictionary blobs." << Endl;
 		log::info << L"    -b, -memory-budget    Memory budget in GiB (default 8)." << Endl;
+		log::info << L"    -w, -workers          Number of request worker threads (default twice number of cores, at least 16)." << Endl;
 #if defined(_WIN32)
 		log::info << L"    -install-service      Install as NT service." << Endl;
 		log::info << L"    -uninstall-service    Uninstall as NT service." << Endl;
@@ -368,6 +369,8 @@ int main(int argc, const char** argv)
 	settings->setProperty< PropertyBoolean >(L"Avalanche.Master", cmdLine.hasOption('m', L"master"));
 	settings->setProperty< PropertyString >(L"Avalanche.Path", cmdLine.getOption('d', L"dictionary-path").getString());
 	settings->setProperty< PropertyInteger >(L"Avalanche.MemoryBudget", cmdLine.getOption('b', L"memory-budget").getInteger());
+	if (cmdLine.hasOption('w', L"workers"))
+		settings->setProperty< PropertyInteger >(L"Avalanche.WorkerThreads", cmdLine.getOption('w', L"workers").getInteger());
 	if (!net::Network::initialize())
 	{
 		log::error << L"Unable to initialize networking." << Endl;
@@ -12,13 +12,40 @@
 #include "Avalanche/Server/Connection.h"
 #include "Core/Io/StreamCopy.h"
 #include "Core/Log/Log.h"
-#include "Core/Thread/ThreadPool.h"
 #include "Net/SocketAddressIPv4.h"
 #include "Net/SocketStream.h"
 #include "Net/TcpSocket.h"
 
 namespace traktor::avalanche
 {
+	namespace
+	{
+
+bool readBatchKeys(IStream* stream, AlignedVector< Key >& outKeys)
+{
+	uint32_t nkeys = 0;
+	if (stream->read(&nkeys, sizeof(uint32_t)) != sizeof(uint32_t))
+		return false;
+	if (nkeys > c_maxBatchKeys)
+		return false;
+
+	// Read all keys in one go instead of one receive per key.
+	uint32_t kv[c_maxBatchKeys * 4];
+	const int64_t nbytes = nkeys * sizeof(kv[0]) * 4;
+	if (stream->read(kv, nbytes) != nbytes)
+		return false;
+
+	outKeys.resize(nkeys);
+	for (uint32_t i = 0; i < nkeys; ++i)
+	{
+		outKeys[i] = Key(kv[i * 4 + 0], kv[i * 4 + 1], kv[i * 4 + 2], kv[i * 4 + 3]);
+		if (!outKeys[i].valid())
+			return false;
+	}
+	return true;
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.avalanche.Connection", Connection, Object)
 
@@ -28,42 +55,41 @@ Connection::Connection(Dictionary* dictionary)
 {
 }
 
-Connection::~Connection()
-{
-	if (m_thread)
-	{
-		ThreadPool::getInstance().stop(m_thread);
-		T_FATAL_ASSERT(m_finished);
-	}
-}
-
 bool Connection::create(net::TcpSocket* clientSocket)
 {
 	m_clientSocket = clientSocket;
 	m_clientStream = new net::SocketStream(clientSocket, true, true, 5000);
 
-	std::wstring name = L"<unknown>";
+	m_name = L"<unknown>";
 
 	auto remoteAddress = dynamic_type_cast< const net::SocketAddressIPv4* >(clientSocket->getRemoteAddress());
 	if (remoteAddress)
-		name = remoteAddress->getHostName();
+		m_name = remoteAddress->getHostName();
 
+	clientSocket->setNoDelay(true);
 	clientSocket->setQuickAck(true);
 
-	auto fn = [=]()
+	log::info << L"Connection with " << m_name << L" established, ready to process requests." << Endl;
+	return true;
+}
+
+bool Connection::process()
+{
+	if (m_finished)
+		return false;
+
+	// Process all requests which are already pending, client might pipeline
+	// requests so no need to return to poller in between.
+	do
 	{
-		log::info << L"Connection with " << name << L" established, ready to process requests." << Endl;
-		while (!m_thread->stopped())
+		if (!processCommand())
 		{
-			if (!process())
-				break;
+			log::info << L"Connection with " << m_name << L" terminated." << Endl;
+			m_finished = true;
+			return false;
 		}
-		log::info << L"Connection with " << name << L" terminated." << Endl;
-		m_finished = true;
-	};
-
-	if (!ThreadPool::getInstance().spawn(fn, m_thread))
-		return false;
+	}
+	while (m_clientSocket->select(true, false, false, 0) > 0);
 
 	return true;
 }
@@ -73,14 +99,8 @@ bool Connection::update()
 	return !m_finished;
 }
 
-bool Connection::process()
+bool Connection::processCommand()
 {
-	const int32_t result = m_clientSocket->select(true, false, false, 500);
-	if (result == 0)
-		return true;
-	else if (result < 0)
-		return false;
-
 	uint8_t cmd = 0;
 	if (m_clientStream->read(&cmd, sizeof(uint8_t)) != sizeof(uint8_t))
 		return false;
@@ -94,6 +114,15 @@ bool Connection::process()
 		}
 		break;
 
+	case c_commandVersion:
+		{
+			if (m_clientStream->write(&c_replyOk, sizeof(uint8_t)) != sizeof(uint8_t))
+				return false;
+			if (m_clientStream->write(&c_protocolVersion, sizeof(uint32_t)) != sizeof(uint32_t))
+				return false;
+		}
+		break;
+
 	case c_commandStat:
 		{
 			const Key key = Key::read(m_clientStream);
@@ -121,6 +150,64 @@ bool Connection::process()
 		}
 		break;
 
+	case c_commandStatBatch:
+		{
+			AlignedVector< Key > keys;
+			if (!readBatchKeys(m_clientStream, keys))
+			{
+				log::warning << L"Failed to read batch keys; terminating connection." << Endl;
+				return false;
+			}
+
+			// Reply with size of each blob, -1 if no such blob, in a single write.
+			AlignedVector< int64_t > blobSizes(keys.size(), -1);
+			for (uint32_t i = 0; i < (uint32_t)keys.size(); ++i)
+			{
+				Ref< const IBlob > blob = m_dictionary->get(keys[i], true);
+				if (blob)
+					blobSizes[i] = blob->size();
+			}
+
+			const int64_t nbytes = (int64_t)(blobSizes.size() * sizeof(int64_t));
+			if (m_clientStream->write(blobSizes.c_ptr(), nbytes) != nbytes)
+				return false;
+		}
+		break;
+
+	case c_commandGetBatch:
+		{
+			AlignedVector< Key > keys;
+			if (!readBatchKeys(m_clientStream, keys))
+			{
+				log::warning << L"Failed to read batch keys; terminating connection." << Endl;
+				return false;
+			}
+
+			uint32_t nsent = 0;
+			for (const auto& key : keys)
+			{
+				Ref< const IBlob > blob = m_dictionary->get(key, false);
+				Ref< IStream > readStream = blob ? blob->read() : nullptr;
+
+				const int64_t blobSize = readStream ? blob->size() : -1;
+				if (m_clientStream->write(&blobSize, sizeof(int64_t)) != sizeof(int64_t))
+					return false;
+
+				if (readStream)
+				{
+					if (!StreamCopy(m_clientStream, readStream).execute(blobSize))
+					{
+						log::error << L"[GET " << key.format() << L"] Unable to send " << blobSize << L" byte(s) to client; terminating connection." << Endl;
+						return false;
+					}
+					++nsent;
+				}
+			}
+
+			log::info << L"[GET BATCH] Sent " << nsent << L" of " << (uint32_t)keys.size() << L" blobs." << Endl;
+		}
+		break;
+
 	case c_commandGet:
 		{
 			const Key key = Key::read(m_clientStream);
@@ -193,7 +280,15 @@ bool Connection::process()
 
 				for (;;)
 				{
-					const int32_t subcmd = m_clientSocket->recv();
+					// Read through stream so a stalled client times out
+					// instead of occupying worker indefinitely.
+					uint8_t subcmd = 0;
+					if (m_clientStream->read(&subcmd, sizeof(uint8_t)) != sizeof(uint8_t))
+					{
+						log::warning << L"[PUT " << key.format() << L"] Client stalled or disconnected; terminating connection." << Endl;
+						return false;
+					}
+
 					if (subcmd == c_subCommandPutAppend)
 					{
 						int64_t chunkSize;
@@ -239,8 +334,7 @@ bool Connection::process()
 					}
 					else
 					{
-						if (subcmd >= 0)
-							log::error << L"[PUT " << key.format() << L"] Invalid sub-command from client; terminating connection." << Endl;
+						log::error << L"[PUT " << key.format() << L"] Invalid sub-command from client; terminating connection." << Endl;
 						return false;
 					}
 				}
@@ -8,6 +8,8 @@
  */
 #pragma once
 
+#include <atomic>
+#include <string>
 #include "Core/Object.h"
 #include "Core/Ref.h"
 
@@ -19,13 +21,6 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
-namespace traktor
-{
-
-class Thread;
-
-}
-
 namespace traktor::net
 {
 
@@ -39,6 +34,12 @@ namespace traktor::avalanche
 
 class Dictionary;
 
+/*! Client connection.
+ *
+ * Connection doesn't own a thread, server poll all
+ * connections and dispatch those with pending requests
+ * to a worker.
+ */
 class T_DLLCLASS Connection : public Object
 {
 	T_RTTI_CLASS;
@@ -46,20 +47,26 @@ class T_DLLCLASS Connection : public Object
 public:
 	explicit Connection(Dictionary* dictionary);
 
-	virtual ~Connection();
-
 	bool create(net::TcpSocket* clientSocket);
 
+	/*! Process all pending requests from client.
+	 *
+	 * \return False if connection has been terminated.
+	 */
+	bool process();
+
 	bool update();
 
+	net::TcpSocket* getSocket() const { return m_clientSocket; }
+
 private:
 	Dictionary* m_dictionary = nullptr;
 	Ref< net::TcpSocket > m_clientSocket;
 	Ref< net::SocketStream > m_clientStream;
-	Thread* m_thread = nullptr;
+	std::wstring m_name;
 	std::atomic< bool > m_finished;
 
-	bool process();
+	bool processCommand();
 };
 
 }
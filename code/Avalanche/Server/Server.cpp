@@ -20,7 +20,11 @@
 #include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
 #include "Core/System/OS.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadPool.h"
 #include "Net/SocketAddressIPv4.h"
+#include "Net/SocketPoller.h"
 #include "Net/TcpSocket.h"
 #include "Net/Discovery/DiscoveryManager.h"
 #include "Net/Discovery/NetworkService.h"
@@ -72,6 +76,82 @@ bool Server::create(const PropertyGroup* settings)
 	m_master = settings->getProperty< bool >(L"Avalanche.Master", false);
 	m_memoryBudget = settings->getProperty< int32_t >(L"Avalanche.MemoryBudget", 8);
 
+	// Create connection poller; connections are polled by a single thread
+	// and requests are processed by a set of workers. Since a worker is
+	// occupied during an entire upload we default to more workers than cores.
+	m_poller = new net::SocketPoller();
+	if (!m_poller->create())
+	{
+		log::error << L"Unable to create connection poller." << Endl;
+		return false;
+	}
+
+	ThreadPool::getInstance().spawn([=, this]()
+		{
+			RefArray< net::Socket > ready;
+			while (!m_pollThread->stopped())
+			{
+				if (m_poller->wait(100, ready) <= 0)
+					continue;
+
+				RefArray< Connection > connections;
+				{
+					T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+					for (auto socket : ready)
+					{
+						auto it = m_connections.find(socket);
+						if (it != m_connections.end())
+							connections.push_back(it->second);
+					}
+				}
+
+				{
+					T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_readyQueueLock);
+					for (auto connection : connections)
+						m_readyQueue.push_back(connection);
+				}
+				m_readyQueueEvent.pulse((int32_t)connections.size());
+			}
+		},
+		m_pollThread
+	);
+
+	const int32_t defaultWorkerCount = std::max< int32_t >(OS::getInstance().getCPUCoreCount() * 2, 16);
+	const int32_t workerCount = std::max(settings->getProperty< int32_t >(L"Avalanche.WorkerThreads", defaultWorkerCount), 1);
+	m_workerThreads.resize(workerCount, nullptr);
+	for (int32_t i = 0; i < workerCount; ++i)
+	{
+		ThreadPool::getInstance().spawn([=, this]()
+			{
+				while (!m_workerThreads[i]->stopped())
+				{
+					Ref< Connection > connection;
+					{
+						T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_readyQueueLock);
+						if (!m_readyQueue.empty())
+						{
+							connection = m_readyQueue.front();
+							m_readyQueue.pop_front();
+						}
+					}
+					if (!connection)
+					{
+						m_readyQueueEvent.wait(100);
+						continue;
+					}
+
+					// Process pending requests; re-arm connection afterwards
+					// so it's polled again.
+					if (connection->process())
+						m_poller->rearm(connection->getSocket());
+					else
+						m_poller->remove(connection->getSocket());
+				}
+			},
+			m_workerThreads[i]
+		);
+	}
+
 	// Broadcast our self on the network.
 	Ref< PropertyGroup > publishSettings = DeepClone(settings).create< PropertyGroup >();
 	publishSettings->setProperty< PropertyInteger >(L"Avalanche.Version.Major", c_majorVersion);
@@ -95,13 +175,34 @@ bool Server::create(const PropertyGroup* settings)
 
 void Server::destroy()
 {
+	if (m_pollThread)
+		ThreadPool::getInstance().stop(m_pollThread);
+
+	for (auto& workerThread : m_workerThreads)
+	{
+		if (workerThread)
+		{
+			m_readyQueueEvent.broadcast();
+			ThreadPool::getInstance().stop(workerThread);
+		}
+	}
+	m_workerThreads.clear();
+
+	m_readyQueue.clear();
 	m_connections.clear();
+	safeDestroy(m_poller);
 	m_peers.clear();
 	safeClose(m_serverSocket);
 	safeDestroy(m_discoveryManager);
 	m_dictionary = nullptr;
 }
 
+size_t Server::getConnectionCount() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+	return m_connections.size();
+}
+
 bool Server::update()
 {
 	// Accept new connections.
@@ -112,19 +213,30 @@ bool Server::update()
 		{
 			Ref< Connection > connection = new Connection(m_dictionary);
 			if (connection->create(clientSocket))
-				m_connections.push_back(connection);
+			{
+				{
+					T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+					m_connections[clientSocket] = connection;
+				}
+				if (!m_poller->add(clientSocket))
+				{
+					log::error << L"Unable to poll connection." << Endl;
+					T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+					m_connections.remove(clientSocket);
+				}
+			}
 		}
 	}
 
 	// Cleanup terminated connections.
 	{
-		auto it = std::remove_if(m_connections.begin(), m_connections.end(), [](Connection* connection) {
-			return !connection->update();
-		});
-		if (it != m_connections.end())
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+		for (auto it = m_connections.begin(); it != m_connections.end(); )
 		{
-			size_t n = std::distance(it, m_connections.end());
-			m_connections.erase(it, m_connections.end());
+			if (!it->second->update())
+				it = m_connections.erase(it);
+			else
+				++it;
 		}
 	}
 
@@ -12,6 +12,10 @@
 #include "Core/Guid.h"
 #include "Core/Ref.h"
 #include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/SmallMap.h"
+#include "Core/Thread/Event.h"
+#include "Core/Thread/Semaphore.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -25,6 +29,7 @@ namespace traktor
 {
 
 class PropertyGroup;
+class Thread;
 
 }
 
@@ -32,6 +37,8 @@ namespace traktor::net
 {
 
 class DiscoveryManager;
+class Socket;
+class SocketPoller;
 class TcpSocket;
 
 }
@@ -49,7 +56,7 @@ class T_DLLCLASS Server : public Object
 
 public:
 	constexpr static int32_t c_majorVersion = 7;
-	constexpr static int32_t c_minorVersion = 0;
+	constexpr static int32_t c_minorVersion = 1;
 
 	bool create(const PropertyGroup* settings);
 
@@ -57,11 +64,18 @@ public:
 
 	bool update();
 
-	size_t getConnectionCount() const { return m_connections.size(); }
+	size_t getConnectionCount() const;
 
 private:
 	Ref< net::TcpSocket > m_serverSocket;
-	RefArray< Connection > m_connections;
+	Ref< net::SocketPoller > m_poller;
+	SmallMap< const net::Socket*, Ref< Connection > > m_connections;
+	mutable Semaphore m_connectionsLock;
+	RefArray< Connection > m_readyQueue;
+	Semaphore m_readyQueueLock;
+	Event m_readyQueueEvent;
+	Thread* m_pollThread = nullptr;
+	AlignedVector< Thread* > m_workerThreads;
 	Ref< net::DiscoveryManager > m_discoveryManager;
 	RefArray< Peer > m_peers;
 	Ref< Dictionary > m_dictionary;
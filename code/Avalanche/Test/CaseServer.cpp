@@ -8,6 +8,7 @@
  */
 #include <cstring>
 #include "Avalanche/Dictionary.h"
+#include "Avalanche/Protocol.h"
 #include "Avalanche/Client/Client.h"
 #include "Avalanche/Server/Server.h"
 #include "Avalanche/Test/CaseServer.h"
@@ -84,6 +85,39 @@ void CaseServer::run()
 		}
 	}
 
+	CASE_ASSERT_EQUAL(client->getProtocolVersion(), c_protocolVersion);
+
+	{
+		AlignedVector< Key > keys;
+		for (uint32_t i = 0; i < 2000; ++i)
+			keys.push_back(Key(5, 6, 7, i + 1));
+		keys[1234] = Key(1, 2, 3, 4);
+
+		AlignedVector< int64_t > blobSizes;
+		CASE_ASSERT(client->stat(keys, blobSizes));
+		CASE_ASSERT_EQUAL(blobSizes.size(), keys.size());
+		if (blobSizes.size() == keys.size())
+		{
+			for (uint32_t i = 0; i < (uint32_t)keys.size(); ++i)
+				CASE_ASSERT_EQUAL(blobSizes[i], (i == 1234) ? (int64_t)sizeof(c_blob) : -1);
+		}
+
+		RefArray< IStream > blobs;
+		CASE_ASSERT(client->get(keys, blobs));
+		CASE_ASSERT_EQUAL(blobs.size(), keys.size());
+		if (blobs.size() == keys.size())
+		{
+			CASE_ASSERT(blobs[0] == nullptr);
+			CASE_ASSERT(blobs[1234] != nullptr);
+			if (blobs[1234])
+			{
+				uint8_t blob[sizeof(c_blob)];
+				CASE_ASSERT_EQUAL(blobs[1234]->read(blob, sizeof(blob)), (int64_t)sizeof(c_blob));
+				CASE_ASSERT(std::memcmp(blob, c_blob, sizeof(c_blob)) == 0);
+			}
+		}
+	}
+
 	client->destroy();
 
 
@@ -0,0 +1,247 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Compress/Lz4/DeflateStreamLz4.h"
+#include "Compress/Lz4/Lz4.h"
+#include "Compress/Lz4/Lz4Dictionary.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/Writer.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/SafeDestroy.h"
+#include "Core/Thread/JobManager.h"
+
+namespace traktor::compress
+{
+
+class DeflateLz4Impl : public RefCountImpl< IRefCount >
+{
+public:
+	explicit DeflateLz4Impl(IStream* stream, uint32_t blockSize, int32_t level, const Lz4Dictionary* dictionary, uint32_t parallelBlocks)
+	:	m_stream(stream)
+	,	m_dictionary(dictionary)
+	,	m_blockSize(blockSize)
+	,	m_level(level)
+	,	m_uncompressedBuffer(blockSize * std::max< uint32_t >(parallelBlocks, 1))
+	,	m_compressedBlocks(std::max< uint32_t >(parallelBlocks, 1))
+	,	m_compressedBlockSizes(std::max< uint32_t >(parallelBlocks, 1), 0)
+	,	m_compressStates(std::max< uint32_t >(parallelBlocks, 1))
+	,	m_uncompressedBufferCount(0)
+	,	m_failed(false)
+	{
+		for (auto& compressedBlock : m_compressedBlocks)
+			compressedBlock.resize(blockSize - 1);
+	}
+
+	void close()
+	{
+		if (m_stream != nullptr)
+		{
+			flush();
+			safeClose(m_stream);
+		}
+	}
+
+	int64_t write(const void* block, int64_t nbytes)
+	{
+		const uint8_t* top = static_cast< const uint8_t* >(block);
+		const uint8_t* ptr = static_cast< const uint8_t* >(block);
+
+		// Stream is broken after a failed write; keep failing.
+		if (m_failed || !m_stream)
+			return -1;
+
+		while (nbytes > 0)
+		{
+			const int64_t ncopy = std::min< int64_t >(nbytes, int64_t(m_uncompressedBuffer.size() - m_uncompressedBufferCount));
+			std::memcpy(&m_uncompressedBuffer[m_uncompressedBufferCount], ptr, ncopy);
+			m_uncompressedBufferCount += ncopy;
+			ptr += ncopy;
+			nbytes -= ncopy;
+
+			if (m_uncompressedBufferCount >= (int64_t)m_uncompressedBuffer.size())
+			{
+				if (!writeBlocks())
+					return -1;
+			}
+		}
+
+		return int64_t(ptr - top);
+	}
+
+	void flush()
+	{
+		if (!m_failed && m_stream && m_uncompressedBufferCount > 0)
+			writeBlocks();
+	}
+
+private:
+	Ref< IStream > m_stream;
+	Ref< const Lz4Dictionary > m_dictionary;
+	uint32_t m_blockSize;
+	int32_t m_level;
+	AlignedVector< uint8_t > m_uncompressedBuffer;
+	AlignedVector< AlignedVector< uint8_t > > m_compressedBlocks;
+	AlignedVector< int32_t > m_compressedBlockSizes;
+	AlignedVector< Lz4CompressState > m_compressStates;	//!< Compression state of each parallel block, reused for all blocks in stream.
+	int64_t m_uncompressedBufferCount;
+	bool m_failed;	//!< Set if write to underlying stream failed, pending data is discarded.
+
+	int32_t getBlockSize(uint32_t block) const
+	{
+		return (int32_t)std::min< int64_t >(m_blockSize, m_uncompressedBufferCount - int64_t(block) * m_blockSize);
+	}
+
+	void compressBlock(uint32_t block)
+	{
+		m_compressedBlockSizes[block] = lz4Compress(
+			m_compressStates[block],
+			&m_uncompressedBuffer[block * m_blockSize],
+			getBlockSize(block),
+			m_compressedBlocks[block].ptr(),
+			(int32_t)m_compressedBlocks[block].size(),
+			m_level,
+			m_dictionary ? m_dictionary->c_ptr() : nullptr,
+			m_dictionary ? m_dictionary->size() : 0
+		);
+	}
+
+	bool writeBlocks()
+	{
+		const uint32_t blockCount = uint32_t((m_uncompressedBufferCount + m_blockSize - 1) / m_blockSize);
+
+		// Compress all pending blocks, concurrently if more than one.
+		if (blockCount > 1)
+		{
+			AlignedVector< Job::task_t > jobs(blockCount);
+			for (uint32_t i = 0; i < blockCount; ++i)
+				jobs[i] = [=, this]() { compressBlock(i); };
+			JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+		}
+		else
+			compressBlock(0);
+
+		// Write blocks in order.
+		for (uint32_t i = 0; i < blockCount; ++i)
+		{
+			const int32_t compressedBlockSize = m_compressedBlockSizes[i];
+			if (compressedBlockSize > 0)
+			{
+				// Write size of compressed block.
+				Writer(m_stream) << uint32_t(compressedBlockSize);
+
+				// Write content of compressed block.
+				if (m_stream->write(m_compressedBlocks[i].c_ptr(), compressedBlockSize) != compressedBlockSize)
+				{
+					log::error << L"Failed to write to LZ4 stream; unable to write compressed block." << Endl;
+					return fail();
+				}
+			}
+			else	// Unable to compress.
+			{
+				const int32_t uncompressedBlockSize = getBlockSize(i);
+
+				// Write size of uncompressed block.
+				Writer(m_stream) << uint32_t(uncompressedBlockSize | 0x80000000UL);
+
+				// Write content of uncompressed block.
+				if (m_stream->write(&m_uncompressedBuffer[i * m_blockSize], uncompressedBlockSize) != uncompressedBlockSize)
+				{
+					log::error << L"Failed to write to LZ4 stream; unable to write uncompressed block." << Endl;
+					return fail();
+				}
+			}
+		}
+
+		m_uncompressedBufferCount = 0;
+		return true;
+	}
+
+	bool fail()
+	{
+		m_uncompressedBufferCount = 0;
+		m_failed = true;
+		return false;
+	}
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.compress.DeflateStreamLz4", DeflateStreamLz4, IStream)
+
+DeflateStreamLz4::DeflateStreamLz4(IStream* stream, uint32_t blockSize, int32_t level, const Lz4Dictionary* dictionary, uint32_t parallelBlocks)
+:	m_impl(new DeflateLz4Impl(stream, blockSize, level, dictionary, parallelBlocks))
+{
+}
+
+DeflateStreamLz4::~DeflateStreamLz4()
+{
+	if (m_impl)
+		m_impl->flush();
+}
+
+void DeflateStreamLz4::close()
+{
+	if (m_impl)
+	{
+		m_impl->close();
+		m_impl = nullptr;
+	}
+}
+
+bool DeflateStreamLz4::canRead() const
+{
+	return false;
+}
+
+bool DeflateStreamLz4::canWrite() const
+{
+	return true;
+}
+
+bool DeflateStreamLz4::canSeek() const
+{
+	return false;
+}
+
+int64_t DeflateStreamLz4::tell() const
+{
+	T_FATAL_ERROR;
+	return 0;
+}
+
+int64_t DeflateStreamLz4::available() const
+{
+	T_FATAL_ERROR;
+	return 0;
+}
+
+int64_t DeflateStreamLz4::seek(SeekOriginType origin, int64_t offset)
+{
+	T_FATAL_ERROR;
+	return 0;
+}
+
+int64_t DeflateStreamLz4::read(void* block, int64_t nbytes)
+{
+	T_FATAL_ERROR;
+	return 0;
+}
+
+int64_t DeflateStreamLz4::write(const void* block, int64_t nbytes)
+{
+	T_ASSERT(m_impl);
+	return m_impl->write(block, nbytes);
+}
+
+void DeflateStreamLz4::flush()
+{
+	T_ASSERT(m_impl);
+	m_impl->flush();
+}
+
+}
@@ -0,0 +1,72 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Core/Io/IStream.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_COMPRESS_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::compress
+{
+
+class DeflateLz4Impl;
+class Lz4Dictionary;
+
+/*! LZ4 deflate stream.
+ * \ingroup Compress
+ *
+ * Stream is split into independently compressed blocks;
+ * if more than one parallel block is requested then
+ * blocks are buffered and compressed concurrently
+ * before being written in order.
+ *
+ * Blocks are plain LZ4, without entropy coding, so
+ * stream favour decompression speed over ratio.
+ */
+class T_DLLCLASS DeflateStreamLz4 : public IStream
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit DeflateStreamLz4(IStream* stream, uint32_t blockSize = 64 * 1024, int32_t level = 4, const Lz4Dictionary* dictionary = nullptr, uint32_t parallelBlocks = 1);
+
+	virtual ~DeflateStreamLz4();
+
+	virtual void close() override final;
+
+	virtual bool canRead() const override final;
+
+	virtual bool canWrite() const override final;
+
+	virtual bool canSeek() const override final;
+
+	virtual int64_t tell() const override final;
+
+	virtual int64_t available() const override final;
+
+	virtual int64_t seek(SeekOriginType origin, int64_t offset) override final;
+
+	virtual int64_t read(void* block, int64_t nbytes) override final;
+
+	virtual int64_t write(const void* block, int64_t nbytes) override final;
+
+	virtual void flush() override final;
+
+private:
+	Ref< DeflateLz4Impl > m_impl;
+};
+
+}
@@ -0,0 +1,245 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Compress/Lz4/InflateStreamLz4.h"
+#include "Compress/Lz4/Lz4.h"
+#include "Compress/Lz4/Lz4Dictionary.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Log/Log.h"
+
+namespace traktor::compress
+{
+
+class InflateLz4Impl : public RefCountImpl< IRefCount >
+{
+public:
+	explicit InflateLz4Impl(IStream* stream, uint32_t blockSize, const Lz4Dictionary* dictionary)
+	:	m_stream(stream)
+	,	m_dictionary(dictionary)
+	,	m_compressedBlock(blockSize)
+	,	m_decompressedBuffer(blockSize)
+	,	m_decompressedBufferOffset(0)
+	,	m_decompressedBufferSize(0)
+	,	m_startPosition(stream->tell())
+	,	m_position(m_startPosition)
+	{
+	}
+
+	void close()
+	{
+		m_stream->close();
+		m_stream = nullptr;
+	}
+
+	int64_t read(void* block, int64_t nbytes)
+	{
+		uint8_t* top = static_cast< uint8_t* >(block);
+		uint8_t* ptr = static_cast< uint8_t* >(block);
+
+		while (nbytes > 0)
+		{
+			// Copy from buffer.
+			if (m_decompressedBufferOffset < m_decompressedBufferSize)
+			{
+				const int64_t ncopy = std::min< int64_t >(m_decompressedBufferSize - m_decompressedBufferOffset, nbytes);
+				std::memcpy(ptr, &m_decompressedBuffer[m_decompressedBufferOffset], ncopy);
+				m_decompressedBufferOffset += ncopy;
+				ptr += ncopy;
+				nbytes -= ncopy;
+				continue;
+			}
+
+			// Decompress directly into destination if requested block size is larger than buffer.
+			uint8_t* output = nbytes >= (int64_t)m_decompressedBuffer.size() ? ptr : m_decompressedBuffer.ptr();
+
+			const int32_t decompressedSize = readBlock(output);
+			if (decompressedSize < 0)
+				return -1;
+			else if (decompressedSize == 0)
+				break;
+
+			if (output == ptr)
+			{
+				ptr += decompressedSize;
+				nbytes -= decompressedSize;
+			}
+			else
+			{
+				m_decompressedBufferOffset = 0;
+				m_decompressedBufferSize = decompressedSize;
+			}
+		}
+
+		m_position += int64_t(ptr - top);
+		return int64_t(ptr - top);
+	}
+
+	int64_t setLogicalPosition(int64_t position)
+	{
+		// Seeking backwards, restart from beginning.
+		if (position < m_position)
+		{
+			m_stream->seek(IStream::SeekSet, m_startPosition);
+			m_decompressedBufferOffset = 0;
+			m_decompressedBufferSize = 0;
+			m_position = m_startPosition;
+		}
+
+		// Read dummy blocks until we're at the desired position.
+		uint8_t dummy[1024];
+		while (m_position < position)
+		{
+			const int64_t nread = read(dummy, std::min< int64_t >(sizeof_array(dummy), position - m_position));
+			if (nread <= 0)
+				return -1;
+		}
+
+		return m_position;
+	}
+
+	int64_t getLogicalPosition() const
+	{
+		return m_position;
+	}
+
+private:
+	Ref< IStream > m_stream;
+	Ref< const Lz4Dictionary > m_dictionary;
+	AlignedVector< uint8_t > m_compressedBlock;
+	AlignedVector< uint8_t > m_decompressedBuffer;
+	int64_t m_decompressedBufferOffset;
+	int64_t m_decompressedBufferSize;
+	int64_t m_startPosition;
+	int64_t m_position;
+
+	/*! Read and decompress next block, output must be at least a block in size. */
+	int32_t readBlock(uint8_t* output)
+	{
+		uint32_t compressedBlockSize = 0;
+		if (m_stream->read(&compressedBlockSize, sizeof(compressedBlockSize)) != sizeof(compressedBlockSize))
+			return 0;
+
+		const bool uncompressedBlock = (compressedBlockSize & 0x80000000UL) != 0;
+		compressedBlockSize &= ~0x80000000UL;
+
+		if (!compressedBlockSize)
+			return 0;
+
+		if (compressedBlockSize > m_decompressedBuffer.size())
+		{
+			log::error << L"Unable to read from LZ4 stream; compressed block size too large." << Endl;
+			return -1;
+		}
+
+		if (uncompressedBlock)
+		{
+			if (m_stream->read(output, compressedBlockSize) != compressedBlockSize)
+			{
+				log::error << L"Unable to read from LZ4 stream; not enough data from stream." << Endl;
+				return -1;
+			}
+			return (int32_t)compressedBlockSize;
+		}
+
+		if (m_stream->read(m_compressedBlock.ptr(), compressedBlockSize) != compressedBlockSize)
+		{
+			log::error << L"Unable to read from LZ4 stream; not enough data from stream." << Endl;
+			return -1;
+		}
+
+		const int32_t decompressedSize = lz4Decompress(
+			m_compressedBlock.c_ptr(),
+			(int32_t)compressedBlockSize,
+			output,
+			(int32_t)m_decompressedBuffer.size(),
+			m_dictionary ? m_dictionary->c_ptr() : nullptr,
+			m_dictionary ? m_dictionary->size() : 0
+		);
+		if (decompressedSize <= 0)
+		{
+			log::error << L"Unable to read from LZ4 stream; corrupt block." << Endl;
+			return -1;
+		}
+
+		return decompressedSize;
+	}
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.compress.InflateStreamLz4", InflateStreamLz4, IStream)
+
+InflateStreamLz4::InflateStreamLz4(IStream* stream, uint32_t blockSize, const Lz4Dictionary* dictionary)
+:	m_impl(new InflateLz4Impl(stream, blockSize, dictionary))
+{
+}
+
+InflateStreamLz4::~InflateStreamLz4()
+{
+	close();
+}
+
+void InflateStreamLz4::close()
+{
+	if (m_impl)
+	{
+		m_impl->close();
+		m_impl = nullptr;
+	}
+}
+
+bool InflateStreamLz4::canRead() const
+{
+	return true;
+}
+
+bool InflateStreamLz4::canWrite() const
+{
+	return false;
+}
+
+bool InflateStreamLz4::canSeek() const
+{
+	return true;
+}
+
+int64_t InflateStreamLz4::tell() const
+{
+	return m_impl->getLogicalPosition();
+}
+
+int64_t InflateStreamLz4::available() const
+{
+	T_FATAL_ERROR;
+	return 0;
+}
+
+int64_t InflateStreamLz4::seek(SeekOriginType origin, int64_t offset)
+{
+	T_ASSERT_M (origin != SeekEnd, L"SeekEnd is not allowed");
+	if (origin == SeekCurrent)
+		offset += m_impl->getLogicalPosition();
+	return m_impl->setLogicalPosition(offset);
+}
+
+int64_t InflateStreamLz4::read(void* block, int64_t nbytes)
+{
+	return m_impl->read(block, nbytes);
+}
+
+int64_t InflateStreamLz4::write(const void* block, int64_t nbytes)
+{
+	T_FATAL_ERROR;
+	return 0;
+}
+
+void InflateStreamLz4::flush()
+{
+}
+
+}
@@ -0,0 +1,64 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Core/Io/IStream.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_COMPRESS_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::compress
+{
+
+class InflateLz4Impl;
+class Lz4Dictionary;
+
+/*! LZ4 inflate stream.
+ * \ingroup Compress
+ */
+class T_DLLCLASS InflateStreamLz4 : public IStream
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit InflateStreamLz4(IStream* stream, uint32_t blockSize = 64 * 1024, const Lz4Dictionary* dictionary = nullptr);
+
+	virtual ~InflateStreamLz4();
+
+	virtual void close() override final;
+
+	virtual bool canRead() const override final;
+
+	virtual bool canWrite() const override final;
+
+	virtual bool canSeek() const override final;
+
+	virtual int64_t tell() const override final;
+
+	virtual int64_t available() const override final;
+
+	virtual int64_t seek(SeekOriginType origin, int64_t offset) override final;
+
+	virtual int64_t read(void* block, int64_t nbytes) override final;
+
+	virtual int64_t write(const void* block, int64_t nbytes) override final;
+
+	virtual void flush() override final;
+
+private:
+	Ref< InflateLz4Impl > m_impl;
+};
+
+}
@@ -0,0 +1,332 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include "Compress/Lz4/Lz4.h"
+
+namespace traktor::compress
+{
+	namespace
+	{
+
+const int32_t c_minMatch = 4;
+const int32_t c_lastLiterals = 5;
+const int32_t c_mfLimit = 12;
+const int32_t c_maxOffset = 65535;
+const int32_t c_hashLog = 16;
+
+T_FORCE_INLINE uint32_t read32(const uint8_t* p)
+{
+	uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+T_FORCE_INLINE uint32_t hash4(const uint8_t* p)
+{
+	return (read32(p) * 2654435761U) >> (32 - c_hashLog);
+}
+
+T_FORCE_INLINE int32_t countMatch(const uint8_t* a, const uint8_t* b, const uint8_t* bEnd)
+{
+	const uint8_t* start = b;
+	while (b < bEnd && *a == *b)
+	{
+		++a;
+		++b;
+	}
+	return int32_t(b - start);
+}
+
+T_FORCE_INLINE bool writeLength(uint8_t*& op, const uint8_t* opEnd, int32_t length)
+{
+	while (length >= 255)
+	{
+		if (op >= opEnd)
+			return false;
+		*op++ = 255;
+		length -= 255;
+	}
+	if (op >= opEnd)
+		return false;
+	*op++ = uint8_t(length);
+	return true;
+}
+
+bool writeSequence(uint8_t*& op, const uint8_t* opEnd, const uint8_t* literals, int32_t literalLength, int32_t offset, int32_t matchLength)
+{
+	if (op >= opEnd)
+		return false;
+
+	uint8_t* token = op++;
+
+	if (literalLength >= 15)
+	{
+		*token = 15 << 4;
+		if (!writeLength(op, opEnd, literalLength - 15))
+			return false;
+	}
+	else
+		*token = uint8_t(literalLength << 4);
+
+	if (opEnd - op < literalLength)
+		return false;
+
+	std::memcpy(op, literals, literalLength);
+	op += literalLength;
+
+	// Last sequence only contain literals.
+	if (matchLength <= 0)
+		return true;
+
+	if (opEnd - op < 2)
+		return false;
+
+	*op++ = uint8_t(offset & 255);
+	*op++ = uint8_t(offset >> 8);
+
+	const int32_t ml = matchLength - c_minMatch;
+	if (ml >= 15)
+	{
+		*token |= 15;
+		if (!writeLength(op, opEnd, ml - 15))
+			return false;
+	}
+	else
+		*token |= uint8_t(ml);
+
+	return true;
+}
+
+/*! Read extended length, length is bounded by remaining output thus cannot overflow. */
+T_FORCE_INLINE bool readLength(const uint8_t*& ip, const uint8_t* ipEnd, int32_t maxLength, int32_t& inoutLength)
+{
+	for (;;)
+	{
+		if (ip >= ipEnd)
+			return false;
+		const uint8_t s = *ip++;
+		inoutLength += s;
+		if (inoutLength > maxLength)
+			return false;
+		if (s != 255)
+			break;
+	}
+	return true;
+}
+
+	}
+
+int32_t lz4CompressBound(int32_t sourceSize)
+{
+	return sourceSize + sourceSize / 255 + 16;
+}
+
+int32_t lz4Compress(Lz4CompressState& state, const void* source, int32_t sourceSize, void* destination, int32_t destinationCapacity, int32_t level, const uint8_t* dictionary, int32_t dictionarySize)
+{
+	// Only last 64k of dictionary are reachable.
+	if (dictionarySize > c_maxOffset)
+	{
+		dictionary += dictionarySize - c_maxOffset;
+		dictionarySize = c_maxOffset;
+	}
+	if (!dictionary)
+		dictionarySize = 0;
+
+	// Put dictionary and source into a single window so matches can span both.
+	const int32_t start = dictionarySize;
+	const int32_t end = dictionarySize + sourceSize;
+
+	state.window.resize(end);
+	if (dictionarySize > 0)
+		std::memcpy(state.window.ptr(), dictionary, dictionarySize);
+	if (sourceSize > 0)
+		std::memcpy(state.window.ptr() + start, source, sourceSize);
+
+	// Positions in head are offset by an epoch, which is advanced for each
+	// block, so head doesn't need to be cleared; only when epoch wraps.
+	if (state.head.empty() || state.epoch > std::numeric_limits< int32_t >::max() - end - 1)
+	{
+		state.head.resize(size_t(1) << c_hashLog);
+		std::fill(state.head.begin(), state.head.end(), -1);
+		state.epoch = 0;
+	}
+
+	// Chain entries are always written before being read.
+	if ((int32_t)state.chain.size() < end)
+		state.chain.resize(end);
+
+	const uint8_t* base = state.window.c_ptr();
+	const int32_t matchLimit = end - c_lastLiterals;
+	const int32_t mfLimit = end - c_mfLimit;
+	const int32_t maxAttempts = 1 << (std::clamp(level, 1, 9) - 1);
+	const int32_t epoch = state.epoch;
+	int32_t* head = state.head.ptr();
+	int32_t* chain = state.chain.ptr();
+
+	state.epoch += end + 1;
+
+	auto insert = [=](int32_t p) {
+		const uint32_t h = hash4(base + p);
+		chain[p] = std::max(head[h] - epoch, -1);
+		head[h] = epoch + p;
+	};
+
+	for (int32_t p = 0; p + c_minMatch <= start && p < mfLimit; ++p)
+		insert(p);
+
+	uint8_t* op = static_cast< uint8_t* >(destination);
+	const uint8_t* opStart = op;
+	const uint8_t* opEnd = op + destinationCapacity;
+
+	int32_t anchor = start;
+	int32_t p = start;
+
+	while (p < mfLimit)
+	{
+		int32_t bestLength = 0;
+		int32_t bestOffset = 0;
+
+		const uint32_t v = read32(base + p);
+		int32_t attempts = maxAttempts;
+		for (int32_t candidate = head[hash4(base + p)] - epoch; candidate >= 0 && p - candidate <= c_maxOffset && attempts-- > 0; candidate = chain[candidate])
+		{
+			if (read32(base + candidate) != v)
+				continue;
+
+			const int32_t length = c_minMatch + countMatch(base + candidate + c_minMatch, base + p + c_minMatch, base + matchLimit);
+			if (length > bestLength)
+			{
+				bestLength = length;
+				bestOffset = p - candidate;
+			}
+		}
+
+		insert(p);
+
+		if (bestLength < c_minMatch)
+		{
+			++p;
+			continue;
+		}
+
+		if (!writeSequence(op, opEnd, base + anchor, p - anchor, bestOffset, bestLength))
+			return 0;
+
+		// Register positions covered by match so later matches can reference them.
+		const int32_t matchEnd = p + bestLength;
+		for (++p; p < matchEnd && p < mfLimit; ++p)
+			insert(p);
+
+		p = matchEnd;
+		anchor = p;
+	}
+
+	if (!writeSequence(op, opEnd, base + anchor, end - anchor, 0, 0))
+		return 0;
+
+	return int32_t(op - opStart);
+}
+
+int32_t lz4Compress(const void* source, int32_t sourceSize, void* destination, int32_t destinationCapacity, int32_t level, const uint8_t* dictionary, int32_t dictionarySize)
+{
+	Lz4CompressState state;
+	return lz4Compress(state, source, sourceSize, destination, destinationCapacity, level, dictionary, dictionarySize);
+}
+
+int32_t lz4Decompress(const void* source, int32_t sourceSize, void* destination, int32_t destinationCapacity, const uint8_t* dictionary, int32_t dictionarySize)
+{
+	const uint8_t* ip = static_cast< const uint8_t* >(source);
+	const uint8_t* ipEnd = ip + sourceSize;
+	uint8_t* op = static_cast< uint8_t* >(destination);
+	uint8_t* opStart = op;
+	const uint8_t* opEnd = op + destinationCapacity;
+
+	if (!dictionary)
+		dictionarySize = 0;
+
+	for (;;)
+	{
+		if (ip >= ipEnd)
+			return -1;
+
+		const uint8_t token = *ip++;
+
+		// Copy literals.
+		int32_t literalLength = token >> 4;
+		if (literalLength == 15 && !readLength(ip, ipEnd, int32_t(opEnd - op), literalLength))
+			return -1;
+
+		if (ipEnd - ip < literalLength || opEnd - op < literalLength)
+			return -1;
+
+		std::memcpy(op, ip, literalLength);
+		op += literalLength;
+		ip += literalLength;
+
+		// Last sequence has no match.
+		if (ip >= ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return -1;
+
+		const int32_t offset = int32_t(ip[0]) | (int32_t(ip[1]) << 8);
+		ip += 2;
+		if (offset == 0)
+			return -1;
+
+		int32_t matchLength = token & 15;
+		if (matchLength == 15 && !readLength(ip, ipEnd, int32_t(opEnd - op), matchLength))
+			return -1;
+		matchLength += c_minMatch;
+
+		if (opEnd - op < matchLength)
+			return -1;
+
+		const int32_t position = int32_t(op - opStart);
+		if (offset > position)
+		{
+			// Match begins in dictionary, might continue into output.
+			const int32_t back = offset - position;
+			if (back > dictionarySize)
+				return -1;
+
+			const uint8_t* match = dictionary + dictionarySize - back;
+			const int32_t ncopy = std::min(matchLength, back);
+			std::memcpy(op, match, ncopy);
+			op += ncopy;
+			matchLength -= ncopy;
+
+			for (const uint8_t* m = opStart; matchLength > 0; --matchLength)
+				*op++ = *m++;
+		}
+		else
+		{
+			const uint8_t* match = op - offset;
+			if (offset >= 8 && opEnd - op >= matchLength + 8)
+			{
+				// Non-overlapping chunks; allowed to write past match end.
+				for (int32_t i = 0; i < matchLength; i += 8)
+					std::memcpy(op + i, match + i, 8);
+				op += matchLength;
+			}
+			else
+			{
+				for (; matchLength > 0; --matchLength)
+					*op++ = *match++;
+			}
+		}
+	}
+
+	return int32_t(op - opStart);
+}
+
+}
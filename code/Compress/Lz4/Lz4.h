@@ -0,0 +1,90 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Config.h"
+#include "Core/Containers/AlignedVector.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_COMPRESS_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::compress
+{
+
+/*! LZ4 compression state.
+ * \ingroup Compress
+ *
+ * Window and match search tables used while compressing
+ * a block; keep state when compressing multiple blocks
+ * to avoid allocating tables for each block.
+ */
+struct T_DLLCLASS Lz4CompressState
+{
+	AlignedVector< uint8_t > window;	//!< Dictionary followed by source data.
+	AlignedVector< int32_t > head;		//!< Last position, offset by epoch, of each hash.
+	AlignedVector< int32_t > chain;		//!< Previous position with same hash.
+	int32_t epoch = 0;					//!< Offset of positions in head of current block; older entries are stale.
+};
+
+/*! Worst case size of a compressed block.
+ * \ingroup Compress
+ */
+int32_t T_DLLCLASS lz4CompressBound(int32_t sourceSize);
+
+/*! Compress block into LZ4 block format.
+ * \ingroup Compress
+ *
+ * Matches are searched through hash chains; higher
+ * level search deeper thus compress better at the
+ * expense of compression speed, decompression speed
+ * is unaffected.
+ *
+ * This is the plain LZ4 block format, there is no entropy
+ * coding stage such as in zstd or deflate, thus ratio is
+ * lower than those but decompression is considerably faster.
+ *
+ * \param state Compression state, reused between blocks.
+ * \param source Uncompressed data.
+ * \param sourceSize Size of uncompressed data.
+ * \param destination Output buffer.
+ * \param destinationCapacity Size of output buffer.
+ * \param level Compression level, 1 (fast) to 9 (best).
+ * \param dictionary Optional dictionary, implicitly preceding source data.
+ * \param dictionarySize Size of dictionary in bytes.
+ * \return Size of compressed block, 0 if output buffer is too small.
+ */
+int32_t T_DLLCLASS lz4Compress(Lz4CompressState& state, const void* source, int32_t sourceSize, void* destination, int32_t destinationCapacity, int32_t level, const uint8_t* dictionary = nullptr, int32_t dictionarySize = 0);
+
+/*! Compress block into LZ4 block format.
+ * \ingroup Compress
+ *
+ * Convenience when compressing a single block, state is
+ * allocated for this block only.
+ */
+int32_t T_DLLCLASS lz4Compress(const void* source, int32_t sourceSize, void* destination, int32_t destinationCapacity, int32_t level, const uint8_t* dictionary = nullptr, int32_t dictionarySize = 0);
+
+/*! Decompress LZ4 block.
+ * \ingroup Compress
+ *
+ * \param source Compressed block.
+ * \param sourceSize Size of compressed block.
+ * \param destination Output buffer.
+ * \param destinationCapacity Size of output buffer.
+ * \param dictionary Dictionary used when block was compressed.
+ * \param dictionarySize Size of dictionary in bytes.
+ * \return Size of decompressed data, -1 if block is malformed.
+ */
+int32_t T_DLLCLASS lz4Decompress(const void* source, int32_t sourceSize, void* destination, int32_t destinationCapacity, const uint8_t* dictionary = nullptr, int32_t dictionarySize = 0);
+
+}
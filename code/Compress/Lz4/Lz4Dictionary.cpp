@@ -0,0 +1,124 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Compress/Lz4/Lz4Dictionary.h"
+
+namespace traktor::compress
+{
+	namespace
+	{
+
+const uint32_t c_segmentSize = 32;		//!< Size of dictionary segments.
+const uint32_t c_kmerSize = 8;			//!< Size of hashed k-mers within segments.
+const uint32_t c_hashLog = 20;
+const uint32_t c_maxDictionarySize = 65535;
+
+uint32_t hashKmer(const uint8_t* p)
+{
+	uint64_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return uint32_t((v * 0x9E3779B185EBCA87ULL) >> (64 - c_hashLog));
+}
+
+struct Segment
+{
+	const uint8_t* data;
+	uint32_t score;
+};
+
+uint32_t scoreSegment(const uint8_t* data, const AlignedVector< uint32_t >& frequencies)
+{
+	uint32_t score = 0;
+	for (uint32_t i = 0; i + c_kmerSize <= c_segmentSize; ++i)
+		score += frequencies[hashKmer(data + i)];
+	return score;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.compress.Lz4Dictionary", Lz4Dictionary, Object)
+
+Lz4Dictionary::Lz4Dictionary(const AlignedVector< uint8_t >& data)
+:	m_data(data)
+{
+}
+
+Ref< Lz4Dictionary > Lz4Dictionary::train(const AlignedVector< sample_t >& samples, uint32_t dictionarySize)
+{
+	dictionarySize = std::min(dictionarySize, c_maxDictionarySize);
+
+	// Count in how many samples each k-mer occurs; only count once per sample
+	// so a single repetitive sample doesn't dominate.
+	AlignedVector< uint32_t > frequencies(size_t(1) << c_hashLog, 0);
+	AlignedVector< uint32_t > lastSample(size_t(1) << c_hashLog, ~0U);
+	for (uint32_t i = 0; i < (uint32_t)samples.size(); ++i)
+	{
+		const uint8_t* data = static_cast< const uint8_t* >(samples[i].first);
+		const uint32_t size = samples[i].second;
+		for (uint32_t j = 0; j + c_kmerSize <= size; ++j)
+		{
+			const uint32_t h = hashKmer(data + j);
+			if (lastSample[h] != i)
+			{
+				lastSample[h] = i;
+				frequencies[h]++;
+			}
+		}
+	}
+
+	// Gather candidate segments.
+	AlignedVector< Segment > candidates;
+	for (const auto& sample : samples)
+	{
+		const uint8_t* data = static_cast< const uint8_t* >(sample.first);
+		for (uint32_t j = 0; j + c_segmentSize <= sample.second; j += c_segmentSize / 2)
+			candidates.push_back({ data + j, scoreSegment(data + j, frequencies) });
+	}
+
+	// Greedily pick best segments, k-mers of picked segments are no longer
+	// valuable so lazily re-score candidates when they reach top.
+	auto compare = [](const Segment& lh, const Segment& rh) { return lh.score < rh.score; };
+	std::make_heap(candidates.begin(), candidates.end(), compare);
+
+	AlignedVector< const uint8_t* > picked;
+	const uint32_t maxPicked = dictionarySize / c_segmentSize;
+	while (!candidates.empty() && picked.size() < maxPicked)
+	{
+		std::pop_heap(candidates.begin(), candidates.end(), compare);
+		Segment segment = candidates.back();
+		candidates.pop_back();
+
+		const uint32_t score = scoreSegment(segment.data, frequencies);
+		if (score <= 1)
+			continue;
+
+		if (score < segment.score && !candidates.empty() && score < candidates.front().score)
+		{
+			segment.score = score;
+			candidates.push_back(segment);
+			std::push_heap(candidates.begin(), candidates.end(), compare);
+			continue;
+		}
+
+		picked.push_back(segment.data);
+		for (uint32_t i = 0; i + c_kmerSize <= c_segmentSize; ++i)
+			frequencies[hashKmer(segment.data + i)] = 0;
+	}
+
+	// Most valuable segment last.
+	AlignedVector< uint8_t > data;
+	data.reserve(picked.size() * c_segmentSize);
+	for (auto it = picked.rbegin(); it != picked.rend(); ++it)
+		data.insert(data.end(), *it, *it + c_segmentSize);
+
+	return new Lz4Dictionary(data);
+}
+
+}
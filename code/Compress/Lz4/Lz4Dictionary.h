@@ -0,0 +1,69 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <utility>
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_COMPRESS_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::compress
+{
+
+/*! LZ4 shared dictionary.
+ * \ingroup Compress
+ *
+ * Dictionary implicitly precede each compressed block
+ * thus small blobs with similar content can reference
+ * common data.
+ */
+class T_DLLCLASS Lz4Dictionary : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	typedef std::pair< const void*, uint32_t > sample_t;
+
+	Lz4Dictionary() = default;
+
+	explicit Lz4Dictionary(const AlignedVector< uint8_t >& data);
+
+	/*! Train dictionary from sample blobs.
+	 *
+	 * Segments which are most frequently occurring
+	 * across samples are selected; most valuable
+	 * segments are placed last in dictionary since
+	 * they are then reachable from furthest into
+	 * each block.
+	 *
+	 * \param samples Sample blobs.
+	 * \param dictionarySize Maximum size of dictionary, at most 64 KiB.
+	 * \return Trained dictionary.
+	 */
+	static Ref< Lz4Dictionary > train(const AlignedVector< sample_t >& samples, uint32_t dictionarySize = 16 * 1024);
+
+	const uint8_t* c_ptr() const { return m_data.c_ptr(); }
+
+	int32_t size() const { return (int32_t)m_data.size(); }
+
+	const AlignedVector< uint8_t >& getData() const { return m_data; }
+
+private:
+	AlignedVector< uint8_t > m_data;
+};
+
+}
@@ -9,6 +9,9 @@
 #include "Core/Rtti/TypeInfo.h"
 
 #if defined(T_STATIC)
+#	include "Compress/Lz4/DeflateStreamLz4.h"
+#	include "Compress/Lz4/InflateStreamLz4.h"
+#	include "Compress/Lz4/Lz4Dictionary.h"
 #	include "Compress/Lzf/DeflateStreamLzf.h"
 #	include "Compress/Lzf/InflateStreamLzf.h"
 #	include "Compress/Zip/DeflateStreamZip.h"
@@ -19,6 +22,9 @@ namespace traktor::compress
 
 extern "C" void __module__Traktor_Compress()
 {
+	T_FORCE_LINK_REF(DeflateStreamLz4);
+	T_FORCE_LINK_REF(InflateStreamLz4);
+	T_FORCE_LINK_REF(Lz4Dictionary);
 	T_FORCE_LINK_REF(DeflateStreamLzf);
 	T_FORCE_LINK_REF(InflateStreamLzf);
 	T_FORCE_LINK_REF(DeflateStreamZip);
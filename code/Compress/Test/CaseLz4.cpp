@@ -0,0 +1,246 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include <functional>
+#include "Compress/Test/CaseLz4.h"
+#include "Compress/Lz4/DeflateStreamLz4.h"
+#include "Compress/Lz4/InflateStreamLz4.h"
+#include "Compress/Lz4/Lz4.h"
+#include "Compress/Lz4/Lz4Dictionary.h"
+#include "Compress/Lzf/DeflateStreamLzf.h"
+#include "Compress/Lzf/InflateStreamLzf.h"
+#include "Compress/Zip/DeflateStreamZip.h"
+#include "Compress/Zip/InflateStreamZip.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::compress::test
+{
+	namespace
+	{
+
+/*! Generate semi-compressible data, words picked from a small vocabulary. */
+void generateData(AlignedVector< uint8_t >& outData, uint32_t size, uint32_t seed)
+{
+	const char* c_words[] = { "traktor ", "resource ", "database ", "instance ", "<object type=\"", "\">\n", "</object>\n", "guid ", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "\t" };
+
+	uint32_t state = seed;
+	outData.resize(0);
+	while (outData.size() < size)
+	{
+		state = state * 1664525 + 1013904223;
+		if ((state >> 28) == 0)
+			outData.push_back(uint8_t(state >> 16));
+		else
+		{
+			const char* word = c_words[(state >> 16) % sizeof_array(c_words)];
+			outData.insert(outData.end(), (const uint8_t*)word, (const uint8_t*)word + std::strlen(word));
+		}
+	}
+	outData.resize(size);
+}
+
+bool roundTrip(
+	const AlignedVector< uint8_t >& source,
+	const std::function< Ref< IStream >(IStream*) >& createDeflate,
+	const std::function< Ref< IStream >(IStream*) >& createInflate,
+	int64_t& outCompressedSize,
+	double& outDeflateTime,
+	double& outInflateTime
+)
+{
+	AlignedVector< uint8_t > compressed;
+	AlignedVector< uint8_t > destination(source.size(), 0);
+
+	Timer timer;
+
+	DynamicMemoryStream deflateDestinationStream(compressed, false, true);
+	Ref< IStream > deflateStream = createDeflate(&deflateDestinationStream);
+	for (size_t i = 0; i < source.size(); i += 4096)
+	{
+		const int64_t nwrite = std::min< int64_t >(4096, source.size() - i);
+		if (deflateStream->write(&source[i], nwrite) != nwrite)
+			return false;
+	}
+	deflateStream->flush();
+	deflateStream = nullptr;
+
+	outDeflateTime = timer.getElapsedTime();
+	outCompressedSize = (int64_t)compressed.size();
+
+	timer.reset();
+
+	MemoryStream inflateSourceStream(compressed.c_ptr(), compressed.size());
+	Ref< IStream > inflateStream = createInflate(&inflateSourceStream);
+	int64_t offset = 0;
+	while (offset < (int64_t)destination.size())
+	{
+		const int64_t nread = inflateStream->read(&destination[offset], std::min< int64_t >(4096, destination.size() - offset));
+		if (nread <= 0)
+			break;
+		offset += nread;
+	}
+	inflateStream = nullptr;
+
+	outInflateTime = timer.getElapsedTime();
+
+	return offset == (int64_t)source.size() && std::memcmp(source.c_ptr(), destination.c_ptr(), source.size()) == 0;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.compress.test.CaseLz4", 0, CaseLz4, traktor::test::Case)
+
+void CaseLz4::run()
+{
+	int64_t compressedSize;
+	double deflateTime, inflateTime;
+
+	// Round trip of random data, incompressible blocks are stored.
+	{
+		AlignedVector< uint8_t > source(size_t(100000), 0);
+		for (size_t i = 0; i < source.size(); ++i)
+			source[i] = uint8_t(std::rand() & 255);
+
+		const bool result = roundTrip(
+			source,
+			[](IStream* stream) { return new DeflateStreamLz4(stream); },
+			[](IStream* stream) { return new InflateStreamLz4(stream); },
+			compressedSize,
+			deflateTime,
+			inflateTime
+		);
+		CASE_ASSERT(result);
+	}
+
+	// Round trip of compressible data with all levels.
+	AlignedVector< uint8_t > source;
+	generateData(source, 4 * 1024 * 1024, 1234);
+
+	for (int32_t level = 1; level <= 9; level += 4)
+	{
+		const bool result = roundTrip(
+			source,
+			[=](IStream* stream) { return new DeflateStreamLz4(stream, 64 * 1024, level); },
+			[](IStream* stream) { return new InflateStreamLz4(stream); },
+			compressedSize,
+			deflateTime,
+			inflateTime
+		);
+		CASE_ASSERT(result);
+		CASE_ASSERT(compressedSize < (int64_t)source.size());
+	}
+
+	// Parallel blocks must produce identical result as sequential.
+	{
+		const bool result = roundTrip(
+			source,
+			[](IStream* stream) { return new DeflateStreamLz4(stream, 64 * 1024, 4, nullptr, 8); },
+			[](IStream* stream) { return new InflateStreamLz4(stream); },
+			compressedSize,
+			deflateTime,
+			inflateTime
+		);
+		CASE_ASSERT(result);
+	}
+
+	// Small blobs compressed with a trained dictionary.
+	{
+		AlignedVector< AlignedVector< uint8_t > > blobs(64);
+		AlignedVector< Lz4Dictionary::sample_t > samples;
+		for (uint32_t i = 0; i < (uint32_t)blobs.size(); ++i)
+		{
+			generateData(blobs[i], 1024, 100 + i);
+			if (i < 32)
+				samples.push_back({ blobs[i].c_ptr(), (uint32_t)blobs[i].size() });
+		}
+
+		Ref< Lz4Dictionary > dictionary = Lz4Dictionary::train(samples, 4096);
+		CASE_ASSERT(dictionary != nullptr);
+		CASE_ASSERT(dictionary->size() > 0);
+
+		int64_t totalWithout = 0, totalWith = 0;
+		for (uint32_t i = 32; i < (uint32_t)blobs.size(); ++i)
+		{
+			bool result = roundTrip(
+				blobs[i],
+				[](IStream* stream) { return new DeflateStreamLz4(stream); },
+				[](IStream* stream) { return new InflateStreamLz4(stream); },
+				compressedSize,
+				deflateTime,
+				inflateTime
+			);
+			CASE_ASSERT(result);
+			totalWithout += compressedSize;
+
+			result = roundTrip(
+				blobs[i],
+				[=](IStream* stream) { return new DeflateStreamLz4(stream, 64 * 1024, 4, dictionary); },
+				[=](IStream* stream) { return new InflateStreamLz4(stream, 64 * 1024, dictionary); },
+				compressedSize,
+				deflateTime,
+				inflateTime
+			);
+			CASE_ASSERT(result);
+			totalWith += compressedSize;
+		}
+		CASE_ASSERT(totalWith < totalWithout);
+		log::info << L"LZ4 small blobs; " << totalWithout << L" bytes without dictionary, " << totalWith << L" bytes with dictionary" << Endl;
+	}
+
+	// Failed write to underlying stream is reported, stream can still be flushed and closed.
+	{
+		AlignedVector< uint8_t > data(size_t(64 * 1024), 0);
+		for (size_t i = 0; i < data.size(); ++i)
+			data[i] = uint8_t(std::rand() & 255);
+
+		uint8_t small[256];
+		MemoryStream smallStream(small, sizeof(small), false, true);
+		Ref< IStream > deflateStream = new DeflateStreamLz4(&smallStream, 4096);
+		CASE_ASSERT(deflateStream->write(data.c_ptr(), data.size()) < 0);
+		CASE_ASSERT(deflateStream->write(data.c_ptr(), data.size()) < 0);
+		deflateStream->flush();
+		deflateStream->close();
+	}
+
+	// Corrupt extended length is rejected before it can overflow.
+	{
+		AlignedVector< uint8_t > corrupt(size_t(16 * 1024 * 1024), 255);
+		uint8_t output[1024];
+		CASE_ASSERT(lz4Decompress(corrupt.c_ptr(), (int32_t)corrupt.size(), output, sizeof(output), nullptr, 0) < 0);
+	}
+
+	// Benchmark against other codecs.
+	struct Codec
+	{
+		const wchar_t* name;
+		std::function< Ref< IStream >(IStream*) > createDeflate;
+		std::function< Ref< IStream >(IStream*) > createInflate;
+	}
+	codecs[] =
+	{
+		{ L"LZF", [](IStream* stream) { return new DeflateStreamLzf(stream); }, [](IStream* stream) { return new InflateStreamLzf(stream); } },
+		{ L"Zip", [](IStream* stream) { return new DeflateStreamZip(stream); }, [](IStream* stream) { return new InflateStreamZip(stream); } },
+		{ L"LZ4 (1)", [](IStream* stream) { return new DeflateStreamLz4(stream, 64 * 1024, 1); }, [](IStream* stream) { return new InflateStreamLz4(stream); } },
+		{ L"LZ4 (9)", [](IStream* stream) { return new DeflateStreamLz4(stream, 64 * 1024, 9); }, [](IStream* stream) { return new InflateStreamLz4(stream); } },
+		{ L"LZ4 (4, parallel)", [](IStream* stream) { return new DeflateStreamLz4(stream, 64 * 1024, 4, nullptr, 16); }, [](IStream* stream) { return new InflateStreamLz4(stream); } }
+	};
+
+	const double megaBytes = source.size() / (1024.0 * 1024.0);
+	for (const auto& codec : codecs)
+	{
+		const bool result = roundTrip(source, codec.createDeflate, codec.createInflate, compressedSize, deflateTime, inflateTime);
+		CASE_ASSERT(result);
+		log::info << codec.name << L"; ratio " << (double(compressedSize) / source.size()) << L", deflate " << (megaBytes / deflateTime) << L" MiB/s, inflate " << (megaBytes / inflateTime) << L" MiB/s" << Endl;
+	}
+}
+
+}
@@ -12,8 +12,13 @@
 #if T_REGISTRY_SIZE != 0 && !defined(_WIN32)
 #	include <alloca.h>
 #endif
+#include <algorithm>
+#include <cstring>
+#include <vector>
 #include "Core/Misc/TString.h"
 #include "Core/Rtti/TypeInfo.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Semaphore.h"
 
 namespace traktor
 {
@@ -34,6 +39,55 @@ static const TypeInfo** s_typeInfoRegistry = 0;
 static const TypeInfo* s_typeInfoRegistry[T_REGISTRY_SIZE];
 #endif
 
+// Index built lazily from registry, immutable once published.
+struct TypeIndex
+{
+	uint32_t generation;
+	const TypeInfo** preOrder;
+	const TypeInfo** hash;
+	uint32_t hashMask;
+	TypeIndex* nextRetired;
+};
+
+// Current index; superseded indices are retired and released once no
+// reader is accessing an index. Current index is never released since
+// types can be queried while static objects are being destroyed.
+static std::atomic< uint32_t > s_registryVersion = 0;
+static std::atomic< TypeIndex* > s_typeIndex = nullptr;
+static std::atomic< int32_t > s_indexReaders = 0;
+static TypeIndex* s_retiredIndices = nullptr;
+
+// Lock is allocated on first use and never destroyed, types are registered
+// and queried both during static initialization and destruction.
+Semaphore& indexLock()
+{
+	static Semaphore* s_lock = new Semaphore();
+	return *s_lock;
+}
+
+/*! Keep index alive while reading from it. */
+class IndexReader
+{
+public:
+	IndexReader()
+	{
+		s_indexReaders++;
+		m_index = s_typeIndex.load();
+	}
+
+	~IndexReader()
+	{
+		s_indexReaders--;
+	}
+
+	const TypeIndex* operator -> () const { return m_index; }
+
+	operator bool () const { return m_index != nullptr; }
+
+private:
+	const TypeIndex* m_index;
+};
+
 int32_t safeStringCompare(const wchar_t* a, const wchar_t* b)
 {
 	int32_t ca = 0, cb = 0;
@@ -52,6 +106,17 @@ int32_t safeStringCompare(const wchar_t* a, const wchar_t* b)
 		return 0;
 }
 
+uint32_t hashTypeName(const wchar_t* name)
+{
+	uint32_t hash = 2166136261U;
+	while (*name)
+	{
+		hash ^= uint32_t(*name++);
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
 	}
 
 void __registerTypeInfo(const TypeInfo* typeInfo)
@@ -145,13 +210,18 @@ TypeInfo::TypeInfo(
 ,	m_super(super)
 ,	m_factory(factory)
 ,	m_tag(0)
+,	m_interval(0)
 {
 	__registerTypeInfo(this);
+	s_registryVersion++;
+	ms_indexValid.store(false);
 }
 
 TypeInfo::~TypeInfo()
 {
 	__unregisterTypeInfo(this);
+	s_registryVersion++;
+	ms_indexValid.store(false);
 	if (m_factory)
 		delete m_factory;
 }
@@ -166,22 +236,17 @@ ITypedObject* TypeInfo::createInstance(void* memory) const
 
 const TypeInfo* TypeInfo::find(const wchar_t* name)
 {
-	uint32_t first = 0;
-	uint32_t last = s_typeInfoCount;
+	if (!ms_indexValid.load(std::memory_order_acquire))
+		updateIndex();
 
-	while (first < last)
+	IndexReader index;
+	if (!index)
+		return nullptr;
+
+	for (uint32_t i = hashTypeName(name) & index->hashMask; index->hash[i] != nullptr; i = (i + 1) & index->hashMask)
 	{
-		const uint32_t index = (last + first) >> 1;
-		T_ASSERT(index >= first && index < last);
-
-		const wchar_t* typeName = s_typeInfoRegistry[index]->getName();
-		const int32_t res = safeStringCompare(typeName, name);
-		if (res == 0)
-			return s_typeInfoRegistry[index];
-		else if (res > 0)
-			last = index;
-		else if (res < 0)
-			first = index + 1;
+		if (safeStringCompare(index->hash[i]->getName(), name) == 0)
+			return index->hash[i];
 	}
 
 	return nullptr;
@@ -189,13 +254,34 @@ const TypeInfo* TypeInfo::find(const wchar_t* name)
 
 TypeInfoSet TypeInfo::findAllOf(bool inclusive) const
 {
+	if (!ms_indexValid.load(std::memory_order_acquire))
+		updateIndex();
+
+	IndexReader index;
+	const uint64_t interval = m_interval.load(std::memory_order_acquire);
+
 	TypeInfoSet typeInfoSet;
-	for (uint32_t i = 0; i < s_typeInfoCount; ++i)
+	if (index && interval != 0 && intervalGeneration(interval) == index->generation)
 	{
-		if (is_type_of(*this, *s_typeInfoRegistry[i]))
+		// All derived types are stored consecutively in pre-order; sort
+		// range by address first so set is built by appending.
+		std::vector< const TypeInfo* > typeInfos(
+			index->preOrder + (inclusive ? intervalFirst(interval) : intervalFirst(interval) + 1),
+			index->preOrder + intervalLast(interval)
+		);
+		std::sort(typeInfos.begin(), typeInfos.end());
+		for (const TypeInfo* typeInfo : typeInfos)
+			typeInfoSet.insert(typeInfo);
+	}
+	else
+	{
+		for (uint32_t i = 0; i < s_typeInfoCount; ++i)
 		{
-			if (inclusive || s_typeInfoRegistry[i] != this)
-				typeInfoSet.insert(s_typeInfoRegistry[i]);
+			if (is_type_of(*this, *s_typeInfoRegistry[i]))
+			{
+				if (inclusive || s_typeInfoRegistry[i] != this)
+					typeInfoSet.insert(s_typeInfoRegistry[i]);
+			}
 		}
 	}
 	return typeInfoSet;
@@ -212,6 +298,138 @@ void TypeInfo::setTag(uint32_t tag) const
 	m_tag = tag;
 }
 
+std::atomic< bool > TypeInfo::ms_indexValid = false;
+
+void TypeInfo::updateIndex()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(indexLock());
+
+	// Another thread might have rebuilt index while we were waiting.
+	if (ms_indexValid.load(std::memory_order_acquire))
+		return;
+
+	const uint32_t version = s_registryVersion;
+	TypeIndex* previous = s_typeIndex.load(std::memory_order_acquire);
+	const uint32_t count = s_typeInfoCount;
+
+	// Never use generation zero since it denote type isn't indexed.
+	uint32_t generation = previous ? ((previous->generation + 1) & 0xffff) : 1;
+	if (generation == 0)
+		generation = 1;
+
+	// Map from type to registry index, last index is a virtual root.
+	std::vector< std::pair< const TypeInfo*, uint32_t > > registryIndices(count);
+	for (uint32_t i = 0; i < count; ++i)
+		registryIndices[i] = { s_typeInfoRegistry[i], i };
+	std::sort(registryIndices.begin(), registryIndices.end());
+
+	auto findRegistryIndex = [&](const TypeInfo* type) -> uint32_t {
+		const auto it = std::lower_bound(registryIndices.begin(), registryIndices.end(), std::make_pair(type, 0U));
+		return (it != registryIndices.end() && it->first == type) ? it->second : ~0U;
+	};
+
+	std::vector< uint32_t > firstChild(count + 1, ~0U);
+	std::vector< uint32_t > nextSibling(count);
+	std::vector< uint32_t > stack(count + 1);
+	std::vector< uint32_t > first(count);
+	std::vector< uint32_t > last(count);
+
+	// Link types with closest registered super type.
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		uint32_t parent = count;
+		for (const TypeInfo* super = s_typeInfoRegistry[i]->m_super; super != nullptr; super = super->m_super)
+		{
+			if ((parent = findRegistryIndex(super)) != ~0U)
+				break;
+		}
+		if (parent == ~0U)
+			parent = count;
+
+		nextSibling[i] = firstChild[parent];
+		firstChild[parent] = i;
+	}
+
+	TypeIndex* index = new TypeIndex();
+	index->generation = generation;
+	index->nextRetired = nullptr;
+	index->preOrder = new const TypeInfo* [count + 1];
+
+	// Number types in pre-order, first child is used as cursor while traversing.
+	uint32_t order = 0;
+	uint32_t depth = 0;
+	stack[depth++] = count;
+	while (depth > 0)
+	{
+		const uint32_t node = stack[depth - 1];
+		const uint32_t child = firstChild[node];
+		if (child != ~0U)
+		{
+			firstChild[node] = nextSibling[child];
+			first[child] = order;
+			index->preOrder[order++] = s_typeInfoRegistry[child];
+			stack[depth++] = child;
+		}
+		else
+		{
+			if (node < count)
+				last[node] = order;
+			--depth;
+		}
+	}
+	T_ASSERT(order == count);
+
+	// Build name lookup.
+	uint32_t hashSize = 1;
+	while (hashSize < count * 2)
+		hashSize <<= 1;
+
+	index->hash = new const TypeInfo* [hashSize];
+	index->hashMask = hashSize - 1;
+	std::memset(index->hash, 0, hashSize * sizeof(const TypeInfo*));
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		uint32_t slot = hashTypeName(s_typeInfoRegistry[i]->getName()) & index->hashMask;
+		while (index->hash[slot] != nullptr)
+			slot = (slot + 1) & index->hashMask;
+		index->hash[slot] = s_typeInfoRegistry[i];
+	}
+
+	// Publish intervals; each is stamped with generation so concurrent readers
+	// comparing types from different generations fall back to traversing inheritance chain.
+	for (uint32_t i = 0; i < count; ++i)
+		s_typeInfoRegistry[i]->m_interval.store(
+			(uint64_t(generation) << 48) | (uint64_t(last[i]) << 24) | uint64_t(first[i]),
+			std::memory_order_release
+		);
+
+	s_typeIndex.store(index);
+
+	// Retire previous index; retired indices are released when there are no
+	// readers since any reader entering after this point will get new index.
+	if (previous)
+	{
+		previous->nextRetired = s_retiredIndices;
+		s_retiredIndices = previous;
+	}
+	if (s_indexReaders.load() == 0)
+	{
+		while (s_retiredIndices)
+		{
+			TypeIndex* retired = s_retiredIndices;
+			s_retiredIndices = retired->nextRetired;
+			delete[] retired->preOrder;
+			delete[] retired->hash;
+			delete retired;
+		}
+	}
+
+	// Index is still invalid if types has been registered while building.
+	ms_indexValid.store(true);
+	if (s_registryVersion != version)
+		ms_indexValid.store(false);
+}
+
 TypeInfoSet makeTypeInfoSet(const TypeInfo& t1)
 {
 	TypeInfoSet typeSet;
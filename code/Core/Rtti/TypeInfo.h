@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Config.h"
 #include "Core/Containers/SmallSet.h"
 #include "Core/Meta/Traits.h"
@@ -131,6 +132,35 @@ public:
 	 */
 	ITypedObject* createInstance(void* memory = 0) const;
 
+	/*! Check if this type is, or is derived from, a base type.
+	 *
+	 * Registered types are numbered in pre-order of the
+	 * inheritance tree thus all types derived from a base
+	 * type are found within the base type's interval.
+	 *
+	 * \param base Base type.
+	 * \return True if this type is of base type.
+	 */
+	bool isTypeOf(const TypeInfo& base) const
+	{
+		if (!ms_indexValid.load(std::memory_order_acquire))
+			updateIndex();
+
+		// Intervals are only comparable if both are from same index.
+		const uint64_t interval = m_interval.load(std::memory_order_acquire);
+		const uint64_t baseInterval = base.m_interval.load(std::memory_order_acquire);
+		if (interval != 0 && intervalGeneration(interval) == intervalGeneration(baseInterval))
+			return intervalFirst(interval) >= intervalFirst(baseInterval) && intervalFirst(interval) < intervalLast(baseInterval);
+
+		// Unnamed types are not registered; need to traverse inheritance chain.
+		for (const TypeInfo* type = this; type; type = type->m_super)
+		{
+			if (type == &base)
+				return true;
+		}
+		return false;
+	}
+
 	/*! Find type from string representation.
 	 *
 	 * \return Type pointer, null if type not found.
@@ -162,6 +192,7 @@ public:
 	uint32_t getTag() const { return m_tag; }
 
 private:
+	static std::atomic< bool > ms_indexValid;
 	const wchar_t* m_name;
 	uint32_t m_size;
 	int32_t m_version;
@@ -169,6 +200,16 @@ private:
 	const TypeInfo* m_super;
 	const IInstanceFactory* m_factory;
 	mutable uint32_t m_tag;
+	mutable std::atomic< uint64_t > m_interval;	//!< Pre-order index of type (bits 0-23), one past index of last derived type (24-47) and index generation (48-63); zero if type isn't indexed.
+
+	static uint32_t intervalFirst(uint64_t interval) { return uint32_t(interval & 0xffffff); }
+
+	static uint32_t intervalLast(uint64_t interval) { return uint32_t((interval >> 24) & 0xffffff); }
+
+	static uint32_t intervalGeneration(uint64_t interval) { return uint32_t(interval >> 48); }
+
+	/*! Update name lookup and inheritance intervals of all registered types. */
+	static void updateIndex();
 };
 
 /*! Create type info set from single type.
@@ -214,13 +255,7 @@ inline bool is_type_a(const TypeInfo& base, const TypeInfo& type)
  */
 inline bool is_type_of(const TypeInfo& base, const TypeInfo& type)
 {
-	if (is_type_a(base, type))
-		return true;
-
-	if (!type.getSuper())
-		return false;
-
-	return is_type_of(base, *type.getSuper());
+	return type.isTypeOf(base);
 }
 
 /*! Return type difference.
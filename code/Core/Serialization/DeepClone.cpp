@@ -6,33 +6,357 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstring>
+#include <unordered_map>
+#include "Core/Guid.h"
+#include "Core/Io/Path.h"
+#include "Core/Math/Color4ub.h"
+#include "Core/Math/Color4f.h"
+#include "Core/Math/Matrix33.h"
+#include "Core/Math/Matrix44.h"
+#include "Core/Math/Quaternion.h"
+#include "Core/RefArray.h"
 #include "Core/Serialization/DeepClone.h"
-#include "Core/Serialization/BinarySerializer.h"
-#include "Core/Io/DynamicMemoryStream.h"
-#include "Core/Io/MemoryStream.h"
+#include "Core/Serialization/ISerializable.h"
+#include "Core/Serialization/MemberArray.h"
+#include "Core/Serialization/MemberComplex.h"
+#include "Core/Serialization/MemberEnum.h"
+#include "Core/Serialization/Serializer.h"
 
 namespace traktor
 {
 	namespace
 	{
 
-const uint32_t c_initialCapacity = 4096;	//!< Estimated initial size of clone; used to reduce number of allocation of m_copy array.
+const uint32_t c_initialCapacity = 4096;	//!< Estimated initial size of clone; used to reduce number of allocation of m_data array.
 
+#define T_CHECK_STATUS \
+	if (failed()) return;
+
+/*! Serializer which copy member values to and from plain arrays.
+ *
+ * Values are stored in native representation, only object
+ * references and types are recorded in addition to values.
+ */
+class DeepCloneSerializer : public Serializer
+{
+	T_RTTI_CLASS;
+
+public:
+	//! Create serializer which capture values.
+	explicit DeepCloneSerializer(
+		AlignedVector< uint8_t >& data,
+		AlignedVector< std::wstring >& wideStrings,
+		AlignedVector< std::string >& strings
+	)
+	:	m_direction(Direction::Write)
+	,	m_data(data)
+	,	m_wideStrings(wideStrings)
+	,	m_strings(strings)
+	,	m_outData(&data)
+	,	m_outWideStrings(&wideStrings)
+	,	m_outStrings(&strings)
+	{
+	}
+
+	//! Create serializer which populate objects from captured values.
+	explicit DeepCloneSerializer(
+		const AlignedVector< uint8_t >& data,
+		const AlignedVector< std::wstring >& wideStrings,
+		const AlignedVector< std::string >& strings
+	)
+	:	m_direction(Direction::Read)
+	,	m_data(data)
+	,	m_wideStrings(wideStrings)
+	,	m_strings(strings)
+	{
+	}
+
+	virtual int32_t getVersion() const override final
+	{
+		T_ASSERT(!m_objects.empty());
+		return type_of(m_objects.back()).getVersion();
+	}
+
+	virtual int32_t getVersion(const TypeInfo& typeInfo) const override final
+	{
+		// Source and clone always share type versions; no need to record versions.
+		T_ASSERT(!m_objects.empty());
+		return is_type_of(typeInfo, type_of(m_objects.back())) ? typeInfo.getVersion() : 0;
 	}
 
+	virtual Direction getDirection() const override final
+	{
+		return m_direction;
+	}
+
+	virtual void operator >> (const Member< bool >& m) override final { copy< bool >(m); }
+
+	virtual void operator >> (const Member< int8_t >& m) override final { copy< int8_t >(m); }
+
+	virtual void operator >> (const Member< uint8_t >& m) override final { copy< uint8_t >(m); }
+
+	virtual void operator >> (const Member< int16_t >& m) override final { copy< int16_t >(m); }
+
+	virtual void operator >> (const Member< uint16_t >& m) override final { copy< uint16_t >(m); }
+
+	virtual void operator >> (const Member< int32_t >& m) override final { copy< int32_t >(m); }
+
+	virtual void operator >> (const Member< uint32_t >& m) override final { copy< uint32_t >(m); }
+
+	virtual void operator >> (const Member< int64_t >& m) override final { copy< int64_t >(m); }
+
+	virtual void operator >> (const Member< uint64_t >& m) override final { copy< uint64_t >(m); }
+
+	virtual void operator >> (const Member< float >& m) override final { copy< float >(m); }
+
+	virtual void operator >> (const Member< double >& m) override final { copy< double >(m); }
+
+	virtual void operator >> (const Member< std::string >& m) override final
+	{
+		T_CHECK_STATUS;
+		if (m_direction == Direction::Read)
+		{
+			if (ensure(m_stringIndex < m_strings.size()))
+				*m = m_strings[m_stringIndex++];
+		}
+		else
+			m_outStrings->push_back(*m);
+	}
+
+	virtual void operator >> (const Member< std::wstring >& m) override final
+	{
+		T_CHECK_STATUS;
+		if (m_direction == Direction::Read)
+		{
+			if (ensure(m_wideStringIndex < m_wideStrings.size()))
+				*m = m_wideStrings[m_wideStringIndex++];
+		}
+		else
+			m_outWideStrings->push_back(*m);
+	}
+
+	virtual void operator >> (const Member< Guid >& m) override final { copy< Guid >(m); }
+
+	virtual void operator >> (const Member< Path >& m) override final
+	{
+		T_CHECK_STATUS;
+		if (m_direction == Direction::Read)
+		{
+			if (ensure(m_wideStringIndex < m_wideStrings.size()))
+				*m = Path(m_wideStrings[m_wideStringIndex++]);
+		}
+		else
+			m_outWideStrings->push_back(m->getOriginal());
+	}
+
+	virtual void operator >> (const Member< Color4ub >& m) override final { copy< Color4ub >(m); }
+
+	virtual void operator >> (const Member< Color4f >& m) override final { copy< Color4f >(m); }
+
+	virtual void operator >> (const Member< Scalar >& m) override final { copy< Scalar >(m); }
+
+	virtual void operator >> (const Member< Vector2 >& m) override final { copy< Vector2 >(m); }
+
+	virtual void operator >> (const Member< Vector4 >& m) override final { copy< Vector4 >(m); }
+
+	virtual void operator >> (const Member< Matrix33 >& m) override final { copy< Matrix33 >(m); }
+
+	virtual void operator >> (const Member< Matrix44 >& m) override final { copy< Matrix44 >(m); }
+
+	virtual void operator >> (const Member< Quaternion >& m) override final { copy< Quaternion >(m); }
+
+	virtual void operator >> (const Member< ISerializable* >& m) override final
+	{
+		T_CHECK_STATUS;
+		if (m_direction == Direction::Read)
+		{
+			// Zero is null, odd is reference to already created object and even is new object.
+			uint32_t tag = 0;
+			if (!read(&tag, sizeof(tag)))
+				return;
+
+			Ref< ISerializable > object;
+			if (tag & 1)
+			{
+				const uint32_t id = tag >> 1;
+				if (!ensure(id < m_readObjects.size()))
+					return;
+				object = m_readObjects[id];
+			}
+			else if (tag != 0)
+			{
+				const TypeInfo* type = nullptr;
+				if (!read(&type, sizeof(type)))
+					return;
+
+				object = checked_type_cast< ISerializable* >(type->createInstance());
+				if (!ensure(object != nullptr))
+					return;
+
+				m_readObjects.push_back(object);
+				serializeObject(object);
+			}
+
+			m = object;
+		}
+		else
+		{
+			ISerializable* object = *m;
+			if (object)
+			{
+				const auto it = m_writeObjects.find(object);
+				if (it == m_writeObjects.end())
+				{
+					const TypeInfo* type = &type_of(object);
+					T_ASSERT(type->isInstantiable());
+
+					const uint32_t id = (uint32_t)m_writeObjects.size();
+					m_writeObjects.insert(std::make_pair(object, id));
+
+					write< uint32_t >((id + 1) << 1);
+					write< const TypeInfo* >(type);
+					serializeObject(object);
+				}
+				else
+					write< uint32_t >((it->second << 1) | 1);
+			}
+			else
+				write< uint32_t >(0);
+		}
+	}
+
+	virtual void operator >> (const Member< void* >& m) override final
+	{
+		T_CHECK_STATUS;
+		if (m_direction == Direction::Read)
+		{
+			uint32_t size = 0;
+			if (!read(&size, sizeof(size)))
+				return;
+			if (!ensure(m.setBlobSize(size)))
+				return;
+			if (size > 0)
+				read(m.getBlob(), size);
+		}
+		else
+		{
+			const uint32_t size = (uint32_t)m.getBlobSize();
+			write< uint32_t >(size);
+			if (size > 0)
+			{
+				const size_t offset = m_outData->size();
+				m_outData->resize(offset + size);
+				std::memcpy(m_outData->ptr() + offset, m.getBlob(), size);
+			}
+		}
+	}
+
+	virtual void operator >> (const MemberArray& m) override final
+	{
+		T_CHECK_STATUS;
+		if (m_direction == Direction::Read)
+		{
+			uint32_t size = 0;
+			if (!read(&size, sizeof(size)))
+				return;
+
+			m.reserve(size, size);
+			for (uint32_t i = 0; i < size; ++i)
+			{
+				T_CHECK_STATUS;
+				m.read(*this);
+			}
+		}
+		else
+		{
+			const uint32_t size = (uint32_t)m.size();
+			write< uint32_t >(size);
+			for (uint32_t i = 0; i < size; ++i)
+			{
+				T_CHECK_STATUS;
+				m.write(*this);
+			}
+		}
+	}
+
+	virtual void operator >> (const MemberComplex& m) override final
+	{
+		T_CHECK_STATUS;
+		m.serialize(*this);
+	}
+
+	virtual void operator >> (const MemberEnumBase& m) override final
+	{
+		T_CHECK_STATUS;
+		m.serialize(*this);
+	}
+
+private:
+	Direction m_direction;
+	const AlignedVector< uint8_t >& m_data;
+	const AlignedVector< std::wstring >& m_wideStrings;
+	const AlignedVector< std::string >& m_strings;
+	AlignedVector< uint8_t >* m_outData = nullptr;
+	AlignedVector< std::wstring >* m_outWideStrings = nullptr;
+	AlignedVector< std::string >* m_outStrings = nullptr;
+	uint32_t m_dataOffset = 0;
+	uint32_t m_wideStringIndex = 0;
+	uint32_t m_stringIndex = 0;
+	RefArray< ISerializable > m_readObjects;
+	std::unordered_map< const ISerializable*, uint32_t > m_writeObjects;
+	AlignedVector< const ISerializable* > m_objects;
+
+	void serializeObject(ISerializable* object)
+	{
+		m_objects.push_back(object);
+		object->serialize(*this);
+		m_objects.pop_back();
+	}
+
+	template < typename T >
+	void copy(const Member< T >& m)
+	{
+		T_CHECK_STATUS;
+		if (m_direction == Direction::Read)
+			read(&(*m), sizeof(T));
+		else
+			write< T >(*m);
+	}
+
+	template < typename T >
+	void write(const T& value)
+	{
+		const size_t offset = m_outData->size();
+		m_outData->resize(offset + sizeof(T));
+		std::memcpy(m_outData->ptr() + offset, &value, sizeof(T));
+	}
+
+	bool read(void* value, uint32_t size)
+	{
+		if (!ensure(m_dataOffset + size <= m_data.size()))
+			return false;
+		std::memcpy(value, m_data.c_ptr() + m_dataOffset, size);
+		m_dataOffset += size;
+		return true;
+	}
+};
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.DeepCloneSerializer", DeepCloneSerializer, Serializer)
+
 T_IMPLEMENT_RTTI_CLASS(L"traktor.DeepClone", DeepClone, Object)
 
 DeepClone::DeepClone(const ISerializable* source)
 {
-	m_copy.reserve(c_initialCapacity);
-	DynamicMemoryStream stream(m_copy, false, true);
-	BinarySerializer(&stream).writeObject(source);
+	m_data.reserve(c_initialCapacity);
+	DeepCloneSerializer(m_data, m_wideStrings, m_strings).writeObject(source);
 }
 
 Ref< ISerializable > DeepClone::create() const
 {
-	MemoryStream stream(m_copy.c_ptr(), m_copy.size());
-	return BinarySerializer(&stream).readObject();
+	return DeepCloneSerializer(m_data, m_wideStrings, m_strings).readObject();
 }
 
 }
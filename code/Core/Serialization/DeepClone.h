@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <string>
 #include "Core/Ref.h"
 #include "Core/Object.h"
 #include "Core/Containers/AlignedVector.h"
@@ -30,6 +31,11 @@ class ISerializable;
  *
  * Creates a clone of an object through
  * serialization.
+ *
+ * Member values of source object are captured
+ * directly, without encoding, when clone is
+ * constructed; each created instance is
+ * populated from captured values.
  */
 class T_DLLCLASS DeepClone : public Object
 {
@@ -49,7 +55,9 @@ public:
 	}
 
 private:
-	AlignedVector< uint8_t > m_copy;
+	AlignedVector< uint8_t > m_data;	//!< Primitive member values, object references and types.
+	AlignedVector< std::wstring > m_wideStrings;	//!< Wide string and path member values.
+	AlignedVector< std::string > m_strings;	//!< String member values.
 };
 
 }
@@ -6,12 +6,21 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Guid.h"
+#include "Core/RefArray.h"
 #include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Transform.h"
+#include "Core/Misc/String.h"
 #include "Core/Serialization/BinarySerializer.h"
 #include "Core/Serialization/DeepClone.h"
+#include "Core/Serialization/MemberComposite.h"
+#include "Core/Serialization/MemberRef.h"
+#include "Core/Serialization/MemberRefArray.h"
 #include "Core/Settings/PropertyBoolean.h"
 #include "Core/Settings/PropertyGroup.h"
 #include "Core/Test/CaseClone.h"
+#include "Core/Timer/Timer.h"
 
 namespace traktor::test
 {
@@ -39,6 +48,29 @@ public:
 	}
 };
 
+class Clone_Node : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	Guid m_id;
+	std::wstring m_name;
+	Transform m_transform;
+	RefArray< Clone_Node > m_children;
+	Ref< Clone_Node > m_shared;
+
+	virtual void serialize(ISerializer& s) override
+	{
+		s >> Member< Guid >(L"id", m_id);
+		s >> Member< std::wstring >(L"name", m_name);
+		s >> MemberComposite< Transform >(L"transform", m_transform);
+		s >> MemberRefArray< Clone_Node >(L"children", m_children);
+		s >> MemberRef< Clone_Node >(L"shared", m_shared);
+	}
+};
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseClone.Clone_Node", 0, Clone_Node, ISerializable)
+
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseClone.Clone_Base", 1, Clone_Base, ISerializable)
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseClone.Clone_Derived", 2, Clone_Derived, Clone_Base)
@@ -82,6 +114,75 @@ void CaseClone::run()
 		CASE_ASSERT_NOT_EQUAL(copy->getProperty(L"Test"), sourceChild);
 		CASE_ASSERT_EQUAL(copy->getProperty(L"Test")->getReferenceCount(), 1);
 	}
+
+	// Deep clone shared references.
+	{
+		Ref< Clone_Node > shared = new Clone_Node();
+		shared->m_name = L"Shared";
+
+		Ref< Clone_Node > source = new Clone_Node();
+		source->m_id = Guid::create();
+		source->m_name = L"Root";
+		source->m_transform = Transform(Vector4(1.0f, 2.0f, 3.0f));
+		source->m_children.push_back(shared);
+		source->m_shared = shared;
+
+		DeepClone clone(source);
+		source->m_name = L"Modified";
+
+		Ref< Clone_Node > copy = clone.create< Clone_Node >();
+		CASE_ASSERT_NOT_EQUAL(copy, nullptr);
+		if (copy)
+		{
+			CASE_ASSERT(copy->m_id == source->m_id);
+			CASE_ASSERT_EQUAL(copy->m_name, L"Root");
+			CASE_ASSERT(copy->m_transform.translation() == source->m_transform.translation());
+			CASE_ASSERT_EQUAL(copy->m_children.size(), 1);
+			CASE_ASSERT_NOT_EQUAL(copy->m_shared, shared);
+			CASE_ASSERT(copy->m_shared == copy->m_children.front());
+			CASE_ASSERT_EQUAL(copy->m_shared->m_name, L"Shared");
+		}
+
+		Ref< Clone_Node > copy2 = clone.create< Clone_Node >();
+		CASE_ASSERT_NOT_EQUAL(copy2, copy);
+	}
+
+	// Deep clone performance compared to binary serialization round-trip.
+	{
+		Ref< Clone_Node > root = new Clone_Node();
+		for (int32_t i = 0; i < 100; ++i)
+		{
+			Ref< Clone_Node > entity = new Clone_Node();
+			entity->m_id = Guid::create();
+			entity->m_name = L"Entity_" + toString(i);
+			for (int32_t j = 0; j < 4; ++j)
+			{
+				Ref< Clone_Node > component = new Clone_Node();
+				component->m_id = Guid::create();
+				component->m_name = L"Component_" + toString(j);
+				entity->m_children.push_back(component);
+			}
+			root->m_children.push_back(entity);
+		}
+
+		const int32_t iterations = 100;
+
+		Timer timer;
+		for (int32_t i = 0; i < iterations; ++i)
+		{
+			DynamicMemoryStream wms(false, true);
+			BinarySerializer(&wms).writeObject(root);
+			DynamicMemoryStream rms(wms.getBuffer(), true, false);
+			BinarySerializer(&rms).readObject();
+		}
+		const double binaryTime = timer.getDeltaTime();
+
+		for (int32_t i = 0; i < iterations; ++i)
+			DeepClone(root).create();
+		const double cloneTime = timer.getDeltaTime();
+
+		log::info << L"Clone 501 objects; binary " << int32_t(binaryTime * 1e6 / iterations) << L" us, deep clone " << int32_t(cloneTime * 1e6 / iterations) << L" us" << Endl;
+	}
 }
 
 }
@@ -0,0 +1,119 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include "Core/Serialization/DeepClone.h"
+#include "Core/Test/CaseMetrics.h"
+#include "Core/Timer/Metrics.h"
+#include "Core/Timer/MetricsSnapshot.h"
+
+namespace traktor::test
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseMetrics", 0, CaseMetrics, Case)
+
+void CaseMetrics::run()
+{
+	Metrics& metrics = Metrics::getInstance();
+
+	const Metrics::handle_t counter = metrics.registerCounter(L"CaseMetrics/Counter");
+	const Metrics::handle_t gauge = metrics.registerGauge(L"CaseMetrics/Gauge");
+	const Metrics::handle_t histogram = metrics.registerHistogram(L"CaseMetrics/Histogram", 0.001, 1.0);
+	CASE_ASSERT(counter != Metrics::InvalidHandle);
+	CASE_ASSERT(gauge != Metrics::InvalidHandle);
+	CASE_ASSERT(histogram != Metrics::InvalidHandle);
+
+	// Registering same name should return same metric, unless type differ.
+	CASE_ASSERT_EQUAL(metrics.registerCounter(L"CaseMetrics/Counter"), counter);
+	CASE_ASSERT_EQUAL(metrics.registerGauge(L"CaseMetrics/Counter"), Metrics::InvalidHandle);
+
+	metrics.increment(counter);
+	metrics.increment(counter, 4);
+	metrics.set(gauge, 1.0);
+	metrics.set(gauge, 2.5);
+
+	// Uniform distribution between 1 and 1000 ms.
+	for (int32_t i = 1; i <= 1000; ++i)
+		metrics.record(histogram, i / 1000.0);
+
+	// Outliers end up in first and last bucket.
+	metrics.record(histogram, 0.0);
+	metrics.record(histogram, 10.0);
+
+	MetricsSnapshot snapshot;
+	metrics.snapshot(snapshot);
+
+	const MetricsSnapshot::Entry* c = snapshot.find(L"CaseMetrics/Counter");
+	CASE_ASSERT(c != nullptr);
+	if (c)
+		CASE_ASSERT_EQUAL(c->count, 5);
+
+	const MetricsSnapshot::Entry* g = snapshot.find(L"CaseMetrics/Gauge");
+	CASE_ASSERT(g != nullptr);
+	if (g)
+		CASE_ASSERT_EQUAL(g->value, 2.5);
+
+	const MetricsSnapshot::Entry* h = snapshot.find(L"CaseMetrics/Histogram");
+	CASE_ASSERT(h != nullptr);
+	if (h)
+	{
+		CASE_ASSERT_EQUAL(h->count, 1002);
+		CASE_ASSERT_EQUAL(h->buckets[0], 1);
+		CASE_ASSERT_EQUAL(h->buckets[Metrics::HistogramBuckets - 1], 2);	// 1.0 and 10.0
+		CASE_ASSERT(std::abs(h->mean() - (500.5 + 10.0) / 1002.0) < 0.0001);
+
+		// Buckets are roughly 25% wide thus estimates are within that.
+		const double p50 = h->percentile(0.5);
+		const double p99 = h->percentile(0.99);
+		CASE_ASSERT(p50 > 0.4 && p50 < 0.6);
+		CASE_ASSERT(p99 > 0.8 && p99 <= 1.0);
+	}
+
+	// Snapshot is serializable in order to be sent to editor.
+	Ref< MetricsSnapshot > clone = DeepClone(&snapshot).create< MetricsSnapshot >();
+	CASE_ASSERT(clone != nullptr);
+	if (clone)
+	{
+		const MetricsSnapshot::Entry* ch = clone->find(L"CaseMetrics/Histogram");
+		CASE_ASSERT(ch != nullptr);
+		if (ch && h)
+			CASE_ASSERT_EQUAL(ch->percentile(0.99), h->percentile(0.99));
+	}
+
+	// Delta only contain values recorded since previous snapshot.
+	{
+		for (int32_t i = 0; i < 100; ++i)
+			metrics.record(histogram, 0.9);
+		metrics.increment(counter, 2);
+
+		MetricsSnapshot current;
+		metrics.snapshot(current);
+
+		MetricsSnapshot delta;
+		current.delta(snapshot, delta);
+
+		const MetricsSnapshot::Entry* dc = delta.find(L"CaseMetrics/Counter");
+		CASE_ASSERT(dc != nullptr);
+		if (dc)
+			CASE_ASSERT_EQUAL(dc->count, 2);
+
+		// Gauge hasn't been set since previous snapshot.
+		CASE_ASSERT(delta.find(L"CaseMetrics/Gauge") == nullptr);
+
+		const MetricsSnapshot::Entry* dh = delta.find(L"CaseMetrics/Histogram");
+		CASE_ASSERT(dh != nullptr);
+		if (dh)
+		{
+			CASE_ASSERT_EQUAL(dh->count, 100);
+			CASE_ASSERT(std::abs(dh->mean() - 0.9) < 0.0001);
+			CASE_ASSERT(dh->percentile(0.5) > 0.8 && dh->percentile(0.5) <= 1.0);
+		}
+	}
+}
+
+}
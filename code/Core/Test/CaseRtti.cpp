@@ -0,0 +1,126 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Log/Log.h"
+#include "Core/Rtti/TypeInfo.h"
+#include "Core/Test/CaseRtti.h"
+#include "Core/Timer/Timer.h"
+
+namespace traktor::test
+{
+
+class Rtti_A : public Object
+{
+	T_RTTI_CLASS;
+};
+
+class Rtti_B : public Rtti_A
+{
+	T_RTTI_CLASS;
+};
+
+class Rtti_C : public Rtti_B
+{
+	T_RTTI_CLASS;
+};
+
+class Rtti_D : public Rtti_C
+{
+	T_RTTI_CLASS;
+};
+
+class Rtti_E : public Rtti_D
+{
+	T_RTTI_CLASS;
+};
+
+class Rtti_F : public Rtti_E
+{
+	T_RTTI_CLASS;
+};
+
+class Rtti_G : public Rtti_F
+{
+	T_RTTI_CLASS;
+};
+
+class Rtti_H : public Rtti_G
+{
+	T_RTTI_CLASS;
+};
+
+class Rtti_X : public Rtti_B
+{
+	T_RTTI_CLASS;
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_A", Rtti_A, Object)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_B", Rtti_B, Rtti_A)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_C", Rtti_C, Rtti_B)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_D", Rtti_D, Rtti_C)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_E", Rtti_E, Rtti_D)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_F", Rtti_F, Rtti_E)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_G", Rtti_G, Rtti_F)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_H", Rtti_H, Rtti_G)
+T_IMPLEMENT_RTTI_CLASS(L"traktor.test.CaseRtti.Rtti_X", Rtti_X, Rtti_B)
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.test.CaseRtti", 0, CaseRtti, Case)
+
+void CaseRtti::run()
+{
+	// Subtype checks.
+	CASE_ASSERT(is_type_of< Rtti_A >(type_of< Rtti_H >()));
+	CASE_ASSERT(is_type_of< Rtti_G >(type_of< Rtti_H >()));
+	CASE_ASSERT(is_type_of< Rtti_H >(type_of< Rtti_H >()));
+	CASE_ASSERT(is_type_of< Object >(type_of< Rtti_X >()));
+	CASE_ASSERT(!is_type_of< Rtti_H >(type_of< Rtti_A >()));
+	CASE_ASSERT(!is_type_of< Rtti_C >(type_of< Rtti_X >()));
+	CASE_ASSERT(!is_type_of< Rtti_X >(type_of< Rtti_H >()));
+
+	// Find by name.
+	CASE_ASSERT(TypeInfo::find(L"traktor.test.CaseRtti.Rtti_E") == &type_of< Rtti_E >());
+	CASE_ASSERT(TypeInfo::find(L"traktor.test.CaseRtti.Rtti_Y") == nullptr);
+
+	// Find all derived types.
+	{
+		const TypeInfoSet inclusive = type_of< Rtti_B >().findAllOf(true);
+		CASE_ASSERT_EQUAL(inclusive.size(), 8);
+		CASE_ASSERT(inclusive.find(&type_of< Rtti_B >()) != inclusive.end());
+		CASE_ASSERT(inclusive.find(&type_of< Rtti_X >()) != inclusive.end());
+		CASE_ASSERT(inclusive.find(&type_of< Rtti_A >()) == inclusive.end());
+
+		const TypeInfoSet exclusive = type_of< Rtti_B >().findAllOf(false);
+		CASE_ASSERT_EQUAL(exclusive.size(), 7);
+		CASE_ASSERT(exclusive.find(&type_of< Rtti_B >()) == exclusive.end());
+	}
+
+	// Cast performance across deep hierarchy.
+	{
+		Ref< Object > objects[] = { new Rtti_A(), new Rtti_D(), new Rtti_H(), new Rtti_X() };
+		const int32_t iterations = 1000000;
+
+		Timer timer;
+		int32_t count = 0;
+		for (int32_t i = 0; i < iterations; ++i)
+		{
+			const Object* object = objects[i & 3];
+			if (dynamic_type_cast< const Rtti_C* >(object))
+				++count;
+			if (dynamic_type_cast< const Rtti_H* >(object))
+				++count;
+			if (dynamic_type_cast< const Rtti_X* >(object))
+				++count;
+		}
+		const double time = timer.getElapsedTime();
+
+		CASE_ASSERT_EQUAL(count, iterations);
+		log::info << L"RTTI; " << int32_t(3.0 * iterations / time / 1e6) << L" M casts/s" << Endl;
+	}
+}
+
+}
@@ -0,0 +1,180 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cmath>
+#include "Core/Log/Log.h"
+#include "Core/Singleton/SingletonManager.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Timer/Metrics.h"
+#include "Core/Timer/MetricsSnapshot.h"
+
+namespace traktor
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.Metrics", Metrics, Object)
+
+Metrics& Metrics::getInstance()
+{
+	static Metrics* s_instance = nullptr;
+	if (!s_instance)
+	{
+		s_instance = new Metrics();
+		s_instance->addRef(nullptr);
+		SingletonManager::getInstance().add(s_instance);
+	}
+	return *s_instance;
+}
+
+Metrics::handle_t Metrics::registerCounter(const std::wstring& name)
+{
+	return registerMetric(name, Type::Counter, 0.0, 0.0);
+}
+
+Metrics::handle_t Metrics::registerGauge(const std::wstring& name)
+{
+	return registerMetric(name, Type::Gauge, 0.0, 0.0);
+}
+
+Metrics::handle_t Metrics::registerHistogram(const std::wstring& name, double minValue, double maxValue)
+{
+	T_ASSERT(minValue > 0.0 && maxValue > minValue);
+	return registerMetric(name, Type::Histogram, minValue, maxValue);
+}
+
+void Metrics::increment(handle_t metric, int64_t delta)
+{
+	if (metric == InvalidHandle)
+		return;
+
+	Metric& m = m_metrics[metric];
+	T_ASSERT(m.type == Type::Counter);
+	m.count.fetch_add(delta, std::memory_order_relaxed);
+}
+
+void Metrics::set(handle_t metric, double value)
+{
+	if (metric == InvalidHandle)
+		return;
+
+	Metric& m = m_metrics[metric];
+	T_ASSERT(m.type == Type::Gauge);
+	m.value.store(value, std::memory_order_relaxed);
+	m.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::record(handle_t metric, double value)
+{
+	if (metric == InvalidHandle)
+		return;
+
+	Metric& m = m_metrics[metric];
+	T_ASSERT(m.type == Type::Histogram);
+
+	int32_t bucket;
+	if (value < m.minValue)
+		bucket = 0;
+	else if (value >= m.maxValue)
+		bucket = HistogramBuckets - 1;
+	else
+		bucket = std::clamp(1 + (int32_t)((std::log(value) - m.logMin) * m.bucketScale), 1, HistogramBuckets - 2);
+
+	m.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	m.count.fetch_add(1, std::memory_order_relaxed);
+
+	double sum = m.value.load(std::memory_order_relaxed);
+	while (!m.value.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed))
+		;
+}
+
+void Metrics::snapshot(MetricsSnapshot& outSnapshot) const
+{
+	const int32_t count = m_count.load(std::memory_order_acquire);
+
+	auto& entries = outSnapshot.getEntries();
+	entries.resize(count);
+
+	for (int32_t i = 0; i < count; ++i)
+	{
+		const Metric& m = m_metrics[i];
+		auto& e = entries[i];
+
+		e.name = m.name;
+		e.type = m.type;
+		e.count = m.count.load(std::memory_order_relaxed);
+		e.value = m.value.load(std::memory_order_relaxed);
+		e.minValue = m.minValue;
+		e.maxValue = m.maxValue;
+
+		if (m.type == Type::Histogram)
+		{
+			for (int32_t j = 0; j < HistogramBuckets; ++j)
+				e.buckets[j] = m.buckets[j].load(std::memory_order_relaxed);
+		}
+	}
+}
+
+Metrics::Metrics()
+:	m_count(0)
+{
+	for (auto& m : m_metrics)
+	{
+		m.count = 0;
+		m.value = 0.0;
+		for (auto& b : m.buckets)
+			b = 0;
+	}
+}
+
+void Metrics::destroy()
+{
+	T_SAFE_RELEASE(this);
+}
+
+Metrics::handle_t Metrics::registerMetric(const std::wstring& name, Type type, double minValue, double maxValue)
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_lock);
+
+	// Modules might register same metric multiple times, return existing if same type.
+	const int32_t count = m_count.load(std::memory_order_relaxed);
+	for (int32_t i = 0; i < count; ++i)
+	{
+		if (m_metrics[i].name == name)
+		{
+			if (m_metrics[i].type != type)
+			{
+				log::error << L"Unable to register metric \"" << name << L"\"; already registered as another type." << Endl;
+				return InvalidHandle;
+			}
+			return i;
+		}
+	}
+
+	if (count >= MaxMetrics)
+	{
+		log::error << L"Unable to register metric \"" << name << L"\"; too many metrics." << Endl;
+		return InvalidHandle;
+	}
+
+	Metric& m = m_metrics[count];
+	m.name = name;
+	m.type = type;
+	m.minValue = minValue;
+	m.maxValue = maxValue;
+	if (type == Type::Histogram)
+	{
+		m.logMin = std::log(minValue);
+		m.bucketScale = (HistogramBuckets - 2) / (std::log(maxValue) - m.logMin);
+	}
+
+	// Publish new metric after it's been initialized.
+	m_count.store(count + 1, std::memory_order_release);
+	return count;
+}
+
+}
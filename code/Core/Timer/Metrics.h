@@ -0,0 +1,120 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "Core/Object.h"
+#include "Core/Singleton/ISingleton.h"
+#include "Core/Thread/SpinLock.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_CORE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class MetricsSnapshot;
+
+/*! Runtime metrics registry.
+ * \ingroup Core
+ *
+ * Any module can register named counters, gauges
+ * and fixed bucket histograms. Recording values is
+ * lock-free and can be done from any thread; only
+ * registration is serialized.
+ */
+class T_DLLCLASS Metrics
+:	public Object
+,	public ISingleton
+{
+	T_RTTI_CLASS;
+
+public:
+	enum
+	{
+		MaxMetrics = 256,
+		HistogramBuckets = 32
+	};
+
+	enum class Type : uint8_t
+	{
+		Counter,
+		Gauge,
+		Histogram
+	};
+
+	typedef int32_t handle_t;
+
+	static constexpr handle_t InvalidHandle = -1;
+
+	static Metrics& getInstance();
+
+	/*! Register counter, accumulated value. */
+	handle_t registerCounter(const std::wstring& name);
+
+	/*! Register gauge, last set value. */
+	handle_t registerGauge(const std::wstring& name);
+
+	/*! Register histogram.
+	 *
+	 * Values are distributed into buckets with exponential
+	 * spacing between minValue and maxValue, values outside
+	 * of range are put in first or last bucket.
+	 */
+	handle_t registerHistogram(const std::wstring& name, double minValue, double maxValue);
+
+	/*! Increment counter. */
+	void increment(handle_t metric, int64_t delta = 1);
+
+	/*! Set gauge value. */
+	void set(handle_t metric, double value);
+
+	/*! Record value into histogram. */
+	void record(handle_t metric, double value);
+
+	/*! Capture current values of all metrics.
+	 *
+	 * Values are accumulated since registration; intended
+	 * to be called once per frame.
+	 */
+	void snapshot(MetricsSnapshot& outSnapshot) const;
+
+protected:
+	Metrics();
+
+	virtual void destroy() override final;
+
+private:
+	struct Metric
+	{
+		std::wstring name;
+		Type type = Type::Counter;
+		double minValue = 0.0;
+		double maxValue = 0.0;
+		double logMin = 0.0;
+		double bucketScale = 0.0;
+		std::atomic< int64_t > count;
+		std::atomic< double > value;
+		std::atomic< uint64_t > buckets[HistogramBuckets];
+	};
+
+	SpinLock m_lock;
+	Metric m_metrics[MaxMetrics];
+	std::atomic< int32_t > m_count;
+
+	handle_t registerMetric(const std::wstring& name, Type type, double minValue, double maxValue);
+};
+
+}
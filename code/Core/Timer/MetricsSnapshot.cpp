@@ -0,0 +1,153 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include "Core/Io/OutputStream.h"
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/Member.h"
+#include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/MemberComposite.h"
+#include "Core/Serialization/MemberEnum.h"
+#include "Core/Serialization/MemberStaticArray.h"
+#include "Core/Timer/MetricsSnapshot.h"
+
+namespace traktor
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.MetricsSnapshot", 0, MetricsSnapshot, ISerializable)
+
+double MetricsSnapshot::Entry::mean() const
+{
+	return count > 0 ? value / count : 0.0;
+}
+
+double MetricsSnapshot::Entry::percentile(double p) const
+{
+	if (type != Metrics::Type::Histogram || count <= 0)
+		return 0.0;
+
+	// Buckets, except first and last, cover exponentially growing ranges between min and max.
+	const double ratio = std::pow(maxValue / minValue, 1.0 / (Metrics::HistogramBuckets - 2));
+	const double target = p * count;
+
+	uint64_t accumulated = 0;
+	for (int32_t i = 0; i < Metrics::HistogramBuckets; ++i)
+	{
+		if (buckets[i] == 0 || accumulated + buckets[i] < target)
+		{
+			accumulated += buckets[i];
+			continue;
+		}
+
+		if (i == 0)
+			return minValue;
+		else if (i == Metrics::HistogramBuckets - 1)
+			return maxValue;
+
+		// Interpolate within bucket.
+		const double f = (target - accumulated) / buckets[i];
+		return minValue * std::pow(ratio, (i - 1) + f);
+	}
+
+	return maxValue;
+}
+
+void MetricsSnapshot::Entry::serialize(ISerializer& s)
+{
+	const MemberEnum< Metrics::Type >::Key c_Type_Keys[] =
+	{
+		{ L"Counter", Metrics::Type::Counter },
+		{ L"Gauge", Metrics::Type::Gauge },
+		{ L"Histogram", Metrics::Type::Histogram },
+		{ 0 }
+	};
+
+	s >> Member< std::wstring >(L"name", name);
+	s >> MemberEnum< Metrics::Type >(L"type", type, c_Type_Keys);
+	s >> Member< int64_t >(L"count", count);
+	s >> Member< double >(L"value", value);
+	if (type == Metrics::Type::Histogram)
+	{
+		s >> Member< double >(L"minValue", minValue);
+		s >> Member< double >(L"maxValue", maxValue);
+		s >> MemberStaticArray< uint64_t, Metrics::HistogramBuckets >(L"buckets", buckets);
+	}
+}
+
+void MetricsSnapshot::delta(const MetricsSnapshot& previous, MetricsSnapshot& outDelta) const
+{
+	auto& deltaEntries = outDelta.getEntries();
+	deltaEntries.resize(0);
+
+	for (size_t i = 0; i < m_entries.size(); ++i)
+	{
+		const Entry& entry = m_entries[i];
+
+		// Metrics are never unregistered thus entries are usually at same index.
+		const auto& previousEntries = previous.getEntries();
+		const Entry* previousEntry = (i < previousEntries.size() && previousEntries[i].name == entry.name) ? &previousEntries[i] : previous.find(entry.name);
+
+		if (!previousEntry)
+		{
+			if (entry.count != 0)
+				deltaEntries.push_back(entry);
+			continue;
+		}
+
+		if (entry.count == previousEntry->count)
+			continue;
+
+		Entry& deltaEntry = deltaEntries.push_back();
+		deltaEntry = entry;
+		deltaEntry.count = entry.count - previousEntry->count;
+		if (entry.type == Metrics::Type::Histogram)
+		{
+			deltaEntry.value = entry.value - previousEntry->value;
+			for (int32_t j = 0; j < Metrics::HistogramBuckets; ++j)
+				deltaEntry.buckets[j] = entry.buckets[j] - previousEntry->buckets[j];
+		}
+	}
+}
+
+const MetricsSnapshot::Entry* MetricsSnapshot::find(const std::wstring& name) const
+{
+	for (const auto& entry : m_entries)
+	{
+		if (entry.name == name)
+			return &entry;
+	}
+	return nullptr;
+}
+
+void MetricsSnapshot::report(OutputStream& os) const
+{
+	for (const auto& entry : m_entries)
+	{
+		switch (entry.type)
+		{
+		case Metrics::Type::Counter:
+			os << entry.name << L" count=" << entry.count << Endl;
+			break;
+
+		case Metrics::Type::Gauge:
+			os << entry.name << L" value=" << entry.value << Endl;
+			break;
+
+		case Metrics::Type::Histogram:
+			os << entry.name << L" samples=" << entry.count << L" mean=" << entry.mean() << L" p50=" << entry.percentile(0.5) << L" p90=" << entry.percentile(0.9) << L" p99=" << entry.percentile(0.99) << Endl;
+			break;
+		}
+	}
+}
+
+void MetricsSnapshot::serialize(ISerializer& s)
+{
+	s >> MemberAlignedVector< Entry, MemberComposite< Entry > >(L"entries", m_entries);
+}
+
+}
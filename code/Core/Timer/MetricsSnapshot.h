@@ -0,0 +1,80 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Serialization/ISerializable.h"
+#include "Core/Timer/Metrics.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_CORE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class OutputStream;
+
+/*! Snapshot of metrics registry.
+ * \ingroup Core
+ */
+class T_DLLCLASS MetricsSnapshot : public ISerializable
+{
+	T_RTTI_CLASS;
+
+public:
+	struct Entry
+	{
+		std::wstring name;
+		Metrics::Type type = Metrics::Type::Counter;
+		int64_t count = 0;		//!< Counter value, or number of gauge updates or histogram samples.
+		double value = 0.0;		//!< Gauge value or sum of histogram samples.
+		double minValue = 0.0;
+		double maxValue = 0.0;
+		uint64_t buckets[Metrics::HistogramBuckets] = { 0 };
+
+		/*! Mean of histogram samples. */
+		double mean() const;
+
+		/*! Estimate percentile, 0 - 1, of histogram samples. */
+		double percentile(double p) const;
+
+		void serialize(ISerializer& s);
+	};
+
+	/*! Get metrics changed since previous snapshot.
+	 *
+	 * Counters and histograms only contain values recorded
+	 * since previous snapshot, thus percentiles are of that
+	 * interval. Unchanged metrics are omitted.
+	 */
+	void delta(const MetricsSnapshot& previous, MetricsSnapshot& outDelta) const;
+
+	/*! Find entry by name, null if not found. */
+	const Entry* find(const std::wstring& name) const;
+
+	/*! Write human readable report of all metrics. */
+	void report(OutputStream& os) const;
+
+	AlignedVector< Entry >& getEntries() { return m_entries; }
+
+	const AlignedVector< Entry >& getEntries() const { return m_entries; }
+
+	virtual void serialize(ISerializer& s) override final;
+
+private:
+	AlignedVector< Entry > m_entries;
+};
+
+}
@@ -134,4 +134,10 @@ IProviderGroup* CompactDatabase::getRootGroup()
 	return m_rootGroup;
 }
 
+int32_t CompactDatabase::getMaxConcurrentReads() const
+{
+	// All instances are read from a single block file which serialize access.
+	return 2;
+}
+
 }
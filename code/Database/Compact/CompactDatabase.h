@@ -49,6 +49,8 @@ public:
 
 	virtual IProviderGroup* getRootGroup() override final;
 
+	virtual int32_t getMaxConcurrentReads() const override final;
+
 private:
 	CompactContext m_context;
 	Ref< CompactGroup > m_rootGroup;
@@ -10,6 +10,7 @@
 
 #include <list>
 #include "Core/Guid.h"
+#include "Core/Ref.h"
 #include "Core/RefArray.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Serialization/ISerializable.h"
@@ -10,6 +10,7 @@
 
 #if defined(T_STATIC)
 #	include "Database/Compact/CompactDatabase.h"
+#	include "Database/Compact/PackedDatabase.h"
 
 namespace traktor
 {
@@ -19,6 +20,7 @@ namespace traktor
 extern "C" void __module__Traktor_Database_Compact()
 {
 	T_FORCE_LINK_REF(CompactDatabase);
+	T_FORCE_LINK_REF(PackedDatabase);
 }
 
 	}
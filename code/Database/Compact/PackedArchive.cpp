@@ -0,0 +1,173 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Core/Guid.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IMappedFile.h"
+#include "Core/Io/MemoryStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/Murmur3.h"
+#include "Core/Misc/TString.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Database/Compact/CompactRegistry.h"
+#include "Database/Compact/PackedArchive.h"
+
+namespace traktor::db
+{
+	namespace
+	{
+
+/*! Read stream view, keep archive mapped as long as stream is alive. */
+class PackedReadStream : public MemoryStream
+{
+public:
+	explicit PackedReadStream(IMappedFile* file, const uint8_t* data, int64_t size)
+	:	MemoryStream((void*)data, size, true, false)
+	,	m_file(file)
+	{
+	}
+
+	virtual void close() override final
+	{
+		MemoryStream::close();
+		m_file = nullptr;
+	}
+
+private:
+	Ref< IMappedFile > m_file;
+};
+
+int32_t compareEntry(const PackedArchive::Entry& entry, const uint8_t* guid, uint32_t dataHash)
+{
+	const int32_t r = std::memcmp(entry.guid, guid, 16);
+	if (r != 0)
+		return r;
+	else if (entry.dataHash < dataHash)
+		return -1;
+	else if (entry.dataHash > dataHash)
+		return 1;
+	else
+		return 0;
+}
+
+/*! Check if range is inside file, written to not overflow. */
+bool inside(uint64_t offset, uint64_t size, uint64_t fileSize)
+{
+	return offset <= fileSize && size <= fileSize - offset;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.db.PackedArchive", PackedArchive, Object)
+
+PackedArchive::~PackedArchive()
+{
+	close();
+}
+
+bool PackedArchive::open(const Path& fileName)
+{
+	m_file = FileSystem::getInstance().map(fileName);
+	if (!m_file)
+		return false;
+
+	const uint8_t* base = (const uint8_t*)m_file->getBase();
+	const int64_t size = m_file->getSize();
+
+	if (size < (int64_t)sizeof(Header))
+	{
+		close();
+		return false;
+	}
+
+	const Header* header = (const Header*)base;
+	if (header->magic != Magic || header->version != Version)
+	{
+		close();
+		return false;
+	}
+
+	if (
+		!inside(header->indexOffset, (uint64_t)header->entryCount * sizeof(Entry), (uint64_t)size) ||
+		!inside(header->registryOffset, header->registrySize, (uint64_t)size)
+	)
+	{
+		log::error << L"Packed archive \"" << fileName.getPathName() << L"\" truncated." << Endl;
+		close();
+		return false;
+	}
+
+	m_entries = (const Entry*)(base + header->indexOffset);
+	m_entryCount = header->entryCount;
+
+	// Validate entries once so read views never reach outside of mapped file.
+	for (uint32_t i = 0; i < m_entryCount; ++i)
+	{
+		const Entry& entry = m_entries[i];
+		if (!inside(entry.offset, entry.size, (uint64_t)size))
+		{
+			log::error << L"Packed archive \"" << fileName.getPathName() << L"\" has entry outside of archive." << Endl;
+			close();
+			return false;
+		}
+		if (entry.flags != 0)
+		{
+			log::error << L"Packed archive \"" << fileName.getPathName() << L"\" has entry with unsupported flags." << Endl;
+			close();
+			return false;
+		}
+	}
+
+	MemoryStream registryStream(base + header->registryOffset, (int64_t)header->registrySize);
+	m_registry = BinarySerializer(&registryStream).readObject< CompactRegistry >();
+	if (!m_registry)
+	{
+		log::error << L"Packed archive \"" << fileName.getPathName() << L"\" has corrupt registry." << Endl;
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void PackedArchive::close()
+{
+	m_registry = nullptr;
+	m_entries = nullptr;
+	m_entryCount = 0;
+	m_file = nullptr;
+}
+
+Ref< IStream > PackedArchive::read(const Guid& guid, uint32_t dataHash) const
+{
+	const uint8_t* g = guid;
+	const Entry* end = m_entries + m_entryCount;
+	const Entry* it = std::lower_bound(m_entries, end, 0, [&](const Entry& entry, int) {
+		return compareEntry(entry, g, dataHash) < 0;
+	});
+	if (it == end || compareEntry(*it, g, dataHash) != 0)
+		return nullptr;
+
+	const uint8_t* base = (const uint8_t*)m_file->getBase();
+	return new PackedReadStream(m_file, base + it->offset, (int64_t)it->size);
+}
+
+uint32_t PackedArchive::hashDataName(const std::wstring& dataName)
+{
+	// Hash UTF-8 encoded name so archives are portable between platforms of different wchar_t size.
+	const std::string name = wstombs(dataName);
+	Murmur3 hash;
+	hash.begin();
+	hash.feedBuffer(name.c_str(), name.length());
+	hash.end();
+	return std::max< uint32_t >(hash.get(), 1);
+}
+
+}
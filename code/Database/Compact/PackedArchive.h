@@ -0,0 +1,94 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Ref.h"
+
+namespace traktor
+{
+
+class Guid;
+class IMappedFile;
+class IStream;
+class Path;
+
+}
+
+namespace traktor::db
+{
+
+class CompactRegistry;
+
+/*! Packed, read-only, archive.
+ * \ingroup Database
+ *
+ * The whole archive is memory mapped and entries
+ * are located through a Guid sorted index; read
+ * streams are views directly into mapped memory thus
+ * no locking is required when reading from multiple
+ * threads.
+ */
+class PackedArchive : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	static constexpr uint32_t Magic = 0x5450414b;	//!< "TPAK"
+	static constexpr uint32_t Version = 1;
+
+#pragma pack(1)
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t reserved;
+		uint64_t indexOffset;
+		uint64_t registryOffset;
+		uint64_t registrySize;
+	};
+
+	struct Entry
+	{
+		uint8_t guid[16];
+		uint32_t dataHash;		//!< Hash of data name, 0 if instance object.
+		uint32_t flags;			//!< Reserved for per-entry compression, must be 0; archives with flags set are rejected.
+		uint64_t offset;
+		uint64_t size;
+	};
+#pragma pack()
+
+	virtual ~PackedArchive();
+
+	bool open(const Path& fileName);
+
+	void close();
+
+	CompactRegistry* getRegistry() const { return m_registry; }
+
+	/*! Read entry through a stream view into mapped memory.
+	 *
+	 * \param guid Instance guid.
+	 * \param dataHash Data name hash, 0 if instance object.
+	 * \return Read stream, null if no such entry.
+	 */
+	Ref< IStream > read(const Guid& guid, uint32_t dataHash) const;
+
+	/*! Calculate hash of data name. */
+	static uint32_t hashDataName(const std::wstring& dataName);
+
+private:
+	Ref< IMappedFile > m_file;
+	const Entry* m_entries = nullptr;
+	uint32_t m_entryCount = 0;
+	Ref< CompactRegistry > m_registry;
+};
+
+}
@@ -0,0 +1,245 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cstring>
+#include "Core/Guid.h"
+#include "Core/Io/DynamicMemoryStream.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Core/Thread/Acquire.h"
+#include "Database/Compact/CompactRegistry.h"
+#include "Database/Compact/PackedArchiveWriter.h"
+
+namespace traktor::db
+{
+	namespace
+	{
+
+const uint64_t c_alignment = 16;
+
+/*! Write stream, buffer written data until stream is closed. */
+class PackedWriteStream : public IStream
+{
+public:
+	explicit PackedWriteStream(PackedArchiveWriter* writer, const Guid& guid, const std::wstring& dataName)
+	:	m_writer(writer)
+	,	m_guid(guid)
+	,	m_dataName(dataName)
+	{
+	}
+
+	virtual ~PackedWriteStream()
+	{
+		close();
+	}
+
+	virtual void close() override final
+	{
+		if (m_writer)
+		{
+			m_writer->write(m_guid, m_dataName, m_buffer.c_ptr(), (int64_t)m_buffer.size());
+			m_writer = nullptr;
+		}
+	}
+
+	virtual bool canRead() const override final { return false; }
+
+	virtual bool canWrite() const override final { return true; }
+
+	virtual bool canSeek() const override final { return false; }
+
+	virtual int64_t tell() const override final { return (int64_t)m_buffer.size(); }
+
+	virtual int64_t available() const override final { return 0; }
+
+	virtual int64_t seek(SeekOriginType origin, int64_t offset) override final { return -1; }
+
+	virtual int64_t read(void* block, int64_t nbytes) override final { return -1; }
+
+	virtual int64_t write(const void* block, int64_t nbytes) override final
+	{
+		if (!m_writer || nbytes < 0)
+			return -1;
+		const uint8_t* data = (const uint8_t*)block;
+		m_buffer.insert(m_buffer.end(), data, data + nbytes);
+		return nbytes;
+	}
+
+	virtual void flush() override final {}
+
+private:
+	Ref< PackedArchiveWriter > m_writer;
+	Guid m_guid;
+	std::wstring m_dataName;
+	AlignedVector< uint8_t > m_buffer;
+};
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.db.PackedArchiveWriter", PackedArchiveWriter, Object)
+
+PackedArchiveWriter::~PackedArchiveWriter()
+{
+	T_ASSERT(!m_stream);
+}
+
+bool PackedArchiveWriter::create(const Path& fileName)
+{
+	if (FileSystem::getInstance().exist(fileName))
+	{
+		if (!FileSystem::getInstance().remove(fileName))
+			return false;
+	}
+
+	m_stream = FileSystem::getInstance().open(fileName, File::FmWrite);
+	if (!m_stream)
+		return false;
+
+	// Reserve space for header; written when archive is closed.
+	PackedArchive::Header header = {};
+	m_offset = 0;
+	return writeAligned(&header, sizeof(header));
+}
+
+bool PackedArchiveWriter::write(const Guid& guid, const std::wstring& dataName, const void* data, int64_t size)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	if (!m_stream)
+		return false;
+
+	const EntryKey key = { guid, !dataName.empty() ? PackedArchive::hashDataName(dataName) : 0 };
+	EntryName* entryName = reserveEntry(key, dataName);
+	if (!entryName)
+		return false;
+
+	PackedArchive::Entry entry = {};
+	std::memcpy(entry.guid, (const uint8_t*)guid, sizeof(entry.guid));
+	entry.dataHash = key.dataHash;
+	entry.flags = 0;
+	entry.offset = m_offset;
+	entry.size = (uint64_t)size;
+
+	if (!writeAligned(data, size))
+		return false;
+
+	// Replace existing entry; rewritten entries leave unreferenced data in archive.
+	if (entryName->index != ~0U)
+		m_entries[entryName->index] = entry;
+	else
+	{
+		entryName->index = (uint32_t)m_entries.size();
+		m_entries.push_back(entry);
+	}
+
+	return true;
+}
+
+bool PackedArchiveWriter::close(const CompactRegistry* registry)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	if (!m_stream)
+		return false;
+
+	PackedArchive::Header header = {};
+	header.magic = PackedArchive::Magic;
+	header.version = PackedArchive::Version;
+
+	// Write registry.
+	DynamicMemoryStream registryStream(false, true);
+	if (!BinarySerializer(&registryStream).writeObject(registry))
+	{
+		log::error << L"Unable to write packed archive; failed to serialize registry." << Endl;
+		return false;
+	}
+
+	header.registryOffset = m_offset;
+	header.registrySize = registryStream.getBuffer().size();
+	if (!writeAligned(registryStream.getBuffer().c_ptr(), (int64_t)registryStream.getBuffer().size()))
+		return false;
+
+	// Write sorted index.
+	std::sort(m_entries.begin(), m_entries.end(), [](const PackedArchive::Entry& lh, const PackedArchive::Entry& rh) {
+		const int32_t r = std::memcmp(lh.guid, rh.guid, sizeof(lh.guid));
+		if (r != 0)
+			return r < 0;
+		else
+			return lh.dataHash < rh.dataHash;
+	});
+
+	header.entryCount = (uint32_t)m_entries.size();
+	header.indexOffset = m_offset;
+	if (!writeAligned(m_entries.c_ptr(), (int64_t)(m_entries.size() * sizeof(PackedArchive::Entry))))
+		return false;
+
+	// Finally rewrite header.
+	m_stream->seek(IStream::SeekSet, 0);
+	if (m_stream->write(&header, sizeof(header)) != sizeof(header))
+		return false;
+
+	m_stream->close();
+	m_stream = nullptr;
+
+	m_entries.clear();
+	m_entryNames.clear();
+	return true;
+}
+
+Ref< IStream > PackedArchiveWriter::createWriteStream(const Guid& guid, const std::wstring& dataName)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	// Reserve name already so collisions are detected before anything is written.
+	const EntryKey key = { guid, !dataName.empty() ? PackedArchive::hashDataName(dataName) : 0 };
+	if (!reserveEntry(key, dataName))
+		return nullptr;
+
+	return new PackedWriteStream(this, guid, dataName);
+}
+
+bool PackedArchiveWriter::writeAligned(const void* data, int64_t size)
+{
+	if (size > 0 && m_stream->write(data, size) != size)
+		return false;
+
+	m_offset += size;
+
+	const uint8_t zero[c_alignment] = { 0 };
+	const uint64_t padding = (c_alignment - (m_offset % c_alignment)) % c_alignment;
+	if (padding > 0 && m_stream->write(zero, padding) != (int64_t)padding)
+		return false;
+
+	m_offset += padding;
+	return true;
+}
+
+PackedArchiveWriter::EntryName* PackedArchiveWriter::reserveEntry(const EntryKey& key, const std::wstring& dataName)
+{
+	EntryName& entryName = m_entryNames[key];
+	if (entryName.index == ~0U && entryName.dataName.empty())
+		entryName.dataName = dataName;
+	else if (entryName.dataName != dataName)
+	{
+		log::error << L"Unable to write packed archive; data name \"" << dataName << L"\" of instance " << key.guid.format() << L" has same hash as \"" << entryName.dataName << L"\"." << Endl;
+		return nullptr;
+	}
+	return &entryName;
+}
+
+size_t PackedArchiveWriter::EntryKeyHash::operator () (const EntryKey& key) const
+{
+	uint64_t h;
+	std::memcpy(&h, (const uint8_t*)key.guid, sizeof(h));
+	return (size_t)(h ^ (key.dataHash * 0x9e3779b97f4a7c15ull));
+}
+
+}
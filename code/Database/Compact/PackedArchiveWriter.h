@@ -0,0 +1,94 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include "Core/Guid.h"
+#include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Thread/Semaphore.h"
+#include "Database/Compact/PackedArchive.h"
+
+namespace traktor::db
+{
+
+/*! Packed archive writer.
+ * \ingroup Database
+ *
+ * Entries are appended to the archive as they
+ * are written; the registry and sorted index
+ * are written when archive is closed.
+ */
+class PackedArchiveWriter : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual ~PackedArchiveWriter();
+
+	bool create(const Path& fileName);
+
+	/*! Write entry into archive.
+	 *
+	 * \param guid Instance guid.
+	 * \param dataName Data name, empty if instance object.
+	 * \param data Entry data.
+	 * \param size Size of entry data in bytes.
+	 * \return True if entry was written, false if failed or data name hash collide with another name.
+	 */
+	bool write(const Guid& guid, const std::wstring& dataName, const void* data, int64_t size);
+
+	/*! Finalize archive; write registry and index.
+	 *
+	 * \param registry Registry of groups and instances.
+	 * \return True if archive was finalized.
+	 */
+	bool close(const CompactRegistry* registry);
+
+	/*! Create a write stream which add an entry when closed.
+	 *
+	 * \param guid Instance guid.
+	 * \param dataName Data name, empty if instance object.
+	 * \return Write stream, null if data name hash collide with another name.
+	 */
+	Ref< IStream > createWriteStream(const Guid& guid, const std::wstring& dataName);
+
+private:
+	struct EntryKey
+	{
+		Guid guid;
+		uint32_t dataHash;
+
+		bool operator == (const EntryKey& rh) const { return guid == rh.guid && dataHash == rh.dataHash; }
+	};
+
+	struct EntryKeyHash
+	{
+		size_t operator () (const EntryKey& key) const;
+	};
+
+	struct EntryName
+	{
+		std::wstring dataName;
+		uint32_t index = ~0U;	//!< Index into entries, ~0U until written.
+	};
+
+	Ref< IStream > m_stream;
+	AlignedVector< PackedArchive::Entry > m_entries;
+	std::unordered_map< EntryKey, EntryName, EntryKeyHash > m_entryNames;
+	Semaphore m_lock;
+	uint64_t m_offset = 0;
+
+	bool writeAligned(const void* data, int64_t size);
+
+	EntryName* reserveEntry(const EntryKey& key, const std::wstring& dataName);
+};
+
+}
@@ -0,0 +1,24 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Database/Compact/CompactRegistry.h"
+#include "Database/Compact/PackedArchive.h"
+#include "Database/Compact/PackedArchiveWriter.h"
+#include "Database/Compact/PackedContext.h"
+
+namespace traktor::db
+{
+
+PackedContext::PackedContext(PackedArchive* archive, PackedArchiveWriter* writer, CompactRegistry* registry)
+:	m_archive(archive)
+,	m_writer(writer)
+,	m_registry(registry)
+{
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+
+namespace traktor::db
+{
+
+class CompactRegistry;
+class PackedArchive;
+class PackedArchiveWriter;
+
+/*! Packed database context
+ * \ingroup Database
+ */
+class PackedContext
+{
+public:
+	PackedContext() = default;
+
+	explicit PackedContext(PackedArchive* archive, PackedArchiveWriter* writer, CompactRegistry* registry);
+
+	PackedArchive* getArchive() { return m_archive; }
+
+	PackedArchiveWriter* getWriter() { return m_writer; }
+
+	CompactRegistry* getRegistry() { return m_registry; }
+
+	bool isReadOnly() const { return m_writer == nullptr; }
+
+private:
+	Ref< PackedArchive > m_archive;
+	Ref< PackedArchiveWriter > m_writer;
+	Ref< CompactRegistry > m_registry;
+};
+
+}
@@ -0,0 +1,110 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Log/Log.h"
+#include "Database/ConnectionString.h"
+#include "Database/Compact/CompactRegistry.h"
+#include "Database/Compact/PackedArchive.h"
+#include "Database/Compact/PackedArchiveWriter.h"
+#include "Database/Compact/PackedDatabase.h"
+#include "Database/Compact/PackedGroup.h"
+
+namespace traktor::db
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.PackedDatabase", 0, PackedDatabase, IProviderDatabase)
+
+bool PackedDatabase::create(const ConnectionString& connectionString)
+{
+	if (!connectionString.have(L"fileName"))
+	{
+		log::error << L"Unable to create packed database; fileName missing." << Endl;
+		return false;
+	}
+
+	const Path fileName = connectionString.get(L"fileName");
+
+	Ref< PackedArchiveWriter > writer = new PackedArchiveWriter();
+	if (!writer->create(fileName))
+	{
+		log::error << L"Unable to create packed database \"" << fileName.getPathName() << L"\"." << Endl;
+		return false;
+	}
+
+	Ref< CompactRegistry > registry = new CompactRegistry();
+
+	Ref< CompactGroupEntry > rootGroupEntry = registry->createGroupEntry();
+	rootGroupEntry->setName(L"#Root");
+	registry->setRootGroup(rootGroupEntry);
+
+	m_context = PackedContext(nullptr, writer, registry);
+
+	m_rootGroup = new PackedGroup(m_context);
+	if (!m_rootGroup->internalCreate(rootGroupEntry))
+		return false;
+
+	return true;
+}
+
+bool PackedDatabase::open(const ConnectionString& connectionString)
+{
+	if (!connectionString.have(L"fileName"))
+	{
+		log::error << L"Unable to open packed database; fileName missing." << Endl;
+		return false;
+	}
+
+	const Path fileName = connectionString.get(L"fileName");
+
+	Ref< PackedArchive > archive = new PackedArchive();
+	if (!archive->open(fileName))
+	{
+		log::error << L"Unable to open packed database \"" << fileName.getPathName() << L"\"; missing or corrupt." << Endl;
+		return false;
+	}
+
+	m_context = PackedContext(archive, nullptr, archive->getRegistry());
+
+	m_rootGroup = new PackedGroup(m_context);
+	if (!m_rootGroup->internalCreate(archive->getRegistry()->getRootGroup()))
+		return false;
+
+	return true;
+}
+
+void PackedDatabase::close()
+{
+	if (m_context.getWriter() != nullptr)
+	{
+		if (!m_context.getWriter()->close(m_context.getRegistry()))
+			log::error << L"Unable to finalize packed database." << Endl;
+	}
+	if (m_context.getArchive() != nullptr)
+		m_context.getArchive()->close();
+
+	m_rootGroup = nullptr;
+	m_context = PackedContext();
+}
+
+IProviderBus* PackedDatabase::getBus()
+{
+	return nullptr;
+}
+
+IProviderGroup* PackedDatabase::getRootGroup()
+{
+	return m_rootGroup;
+}
+
+int32_t PackedDatabase::getMaxConcurrentReads() const
+{
+	// Archive is read-only thus no synchronization between reads.
+	return 4;
+}
+
+}
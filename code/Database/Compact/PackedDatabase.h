@@ -0,0 +1,64 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Database/Compact/PackedContext.h"
+#include "Database/Provider/IProviderDatabase.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_DATABASE_COMPACT_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor
+{
+
+class Path;
+
+}
+
+namespace traktor::db
+{
+
+class PackedGroup;
+
+/*! Packed database provider
+ * \ingroup Database
+ *
+ * Read-only database backed by a memory mapped
+ * packed archive. When created the database is
+ * write-only and the archive is emitted as the
+ * database is closed.
+ */
+class T_DLLCLASS PackedDatabase : public IProviderDatabase
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual bool create(const ConnectionString& connectionString) override final;
+
+	virtual bool open(const ConnectionString& connectionString) override final;
+
+	virtual void close() override final;
+
+	virtual IProviderBus* getBus() override final;
+
+	virtual IProviderGroup* getRootGroup() override final;
+
+	virtual int32_t getMaxConcurrentReads() const override final;
+
+private:
+	PackedContext m_context;
+	Ref< PackedGroup > m_rootGroup;
+};
+
+}
@@ -0,0 +1,210 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Io/IStream.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Database/Types.h"
+#include "Database/Compact/CompactRegistry.h"
+#include "Database/Compact/PackedArchive.h"
+#include "Database/Compact/PackedArchiveWriter.h"
+#include "Database/Compact/PackedContext.h"
+#include "Database/Compact/PackedInstance.h"
+
+namespace traktor::db
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.db.PackedInstance", PackedInstance, IProviderInstance)
+
+PackedInstance::PackedInstance(PackedContext& context)
+:	m_context(context)
+{
+}
+
+bool PackedInstance::internalCreate(CompactInstanceEntry* instanceEntry)
+{
+	m_instanceEntry = instanceEntry;
+	return true;
+}
+
+std::wstring PackedInstance::getPrimaryTypeName() const
+{
+	T_ASSERT(m_instanceEntry);
+	return m_instanceEntry->getPrimaryTypeName();
+}
+
+bool PackedInstance::openTransaction()
+{
+	T_ASSERT(m_instanceEntry);
+	return true;
+}
+
+bool PackedInstance::commitTransaction()
+{
+	T_ASSERT(m_instanceEntry);
+	return true;
+}
+
+bool PackedInstance::closeTransaction()
+{
+	T_ASSERT(m_instanceEntry);
+	return true;
+}
+
+std::wstring PackedInstance::getName() const
+{
+	T_ASSERT(m_instanceEntry);
+	return m_instanceEntry->getName();
+}
+
+bool PackedInstance::setName(const std::wstring& name)
+{
+	T_ASSERT(m_instanceEntry);
+	if (m_context.isReadOnly())
+		return false;
+	m_instanceEntry->setName(name);
+	return true;
+}
+
+Guid PackedInstance::getGuid() const
+{
+	T_ASSERT(m_instanceEntry);
+	return m_instanceEntry->getGuid();
+}
+
+bool PackedInstance::setGuid(const Guid& guid)
+{
+	T_ASSERT(m_instanceEntry);
+
+	// Entries are keyed by guid thus cannot change after object has been written.
+	if (m_context.isReadOnly() || m_instanceEntry->getObjectBlock() != nullptr)
+		return false;
+
+	m_instanceEntry->setGuid(guid);
+	return true;
+}
+
+bool PackedInstance::getLastModifyDate(DateTime& outModifyDate) const
+{
+	return false;
+}
+
+uint32_t PackedInstance::getFlags() const
+{
+	return IfNormal;
+}
+
+bool PackedInstance::remove()
+{
+	T_ASSERT(m_instanceEntry);
+
+	if (m_context.isReadOnly())
+		return false;
+
+	if (!m_context.getRegistry()->removeInstance(m_instanceEntry))
+		return false;
+
+	m_instanceEntry = nullptr;
+	return true;
+}
+
+Ref< IStream > PackedInstance::readObject(const TypeInfo*& outSerializerType) const
+{
+	T_ASSERT(m_instanceEntry);
+
+	PackedArchive* archive = m_context.getArchive();
+	if (!archive)
+		return nullptr;
+
+	Ref< IStream > objectStream = archive->read(m_instanceEntry->getGuid(), 0);
+	if (!objectStream)
+		return nullptr;
+
+	outSerializerType = &type_of< BinarySerializer >();
+	return objectStream;
+}
+
+Ref< IStream > PackedInstance::writeObject(const std::wstring& primaryTypeName, const TypeInfo*& outSerializerType)
+{
+	T_ASSERT(m_instanceEntry);
+
+	PackedArchiveWriter* writer = m_context.getWriter();
+	if (!writer)
+		return nullptr;
+
+	// Tag instance as having an object written; block identifier is not used by packed archives.
+	if (!m_instanceEntry->getObjectBlock())
+		m_instanceEntry->setObjectBlock(m_context.getRegistry()->createBlockEntry());
+
+	m_instanceEntry->setPrimaryTypeName(primaryTypeName);
+
+	outSerializerType = &type_of< BinarySerializer >();
+	return writer->createWriteStream(m_instanceEntry->getGuid(), L"");
+}
+
+uint32_t PackedInstance::getDataNames(AlignedVector< std::wstring >& outDataNames) const
+{
+	T_ASSERT(m_instanceEntry);
+
+	const auto& dataBlocks = m_instanceEntry->getDataBlocks();
+	for (auto it : dataBlocks)
+		outDataNames.push_back(it.first);
+
+	return uint32_t(outDataNames.size());
+}
+
+bool PackedInstance::getDataLastWriteTime(const std::wstring& dataName, DateTime& outLastWriteTime) const
+{
+	return false;
+}
+
+bool PackedInstance::removeAllData()
+{
+	T_ASSERT(m_instanceEntry);
+
+	if (m_context.isReadOnly())
+		return false;
+
+	m_instanceEntry->getDataBlocks().clear();
+	return true;
+}
+
+Ref< IStream > PackedInstance::readData(const std::wstring& dataName) const
+{
+	T_ASSERT(m_instanceEntry);
+
+	PackedArchive* archive = m_context.getArchive();
+	if (!archive)
+		return nullptr;
+
+	const auto& dataBlocks = m_instanceEntry->getDataBlocks();
+	if (dataBlocks.find(dataName) == dataBlocks.end())
+		return nullptr;
+
+	return archive->read(m_instanceEntry->getGuid(), PackedArchive::hashDataName(dataName));
+}
+
+Ref< IStream > PackedInstance::writeData(const std::wstring& dataName)
+{
+	T_ASSERT(m_instanceEntry);
+
+	PackedArchiveWriter* writer = m_context.getWriter();
+	if (!writer)
+		return nullptr;
+
+	Ref< IStream > dataStream = writer->createWriteStream(m_instanceEntry->getGuid(), dataName);
+	if (!dataStream)
+		return nullptr;
+
+	auto& dataBlocks = m_instanceEntry->getDataBlocks();
+	if (!dataBlocks[dataName])
+		dataBlocks[dataName] = m_context.getRegistry()->createBlockEntry();
+
+	return dataStream;
+}
+
+}
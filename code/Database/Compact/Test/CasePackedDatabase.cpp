@@ -0,0 +1,264 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <atomic>
+#include <cstring>
+#include <map>
+#include "Core/Guid.h"
+#include "Core/RefArray.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/IStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/String.h"
+#include "Core/Thread/JobManager.h"
+#include "Core/Timer/Timer.h"
+#include "Database/ConnectionString.h"
+#include "Database/Compact/CompactDatabase.h"
+#include "Database/Compact/CompactRegistry.h"
+#include "Database/Compact/PackedArchive.h"
+#include "Database/Compact/PackedArchiveWriter.h"
+#include "Database/Compact/PackedDatabase.h"
+#include "Database/Compact/Test/CasePackedDatabase.h"
+#include "Database/Provider/IProviderGroup.h"
+#include "Database/Provider/IProviderInstance.h"
+
+namespace traktor::db::test
+{
+	namespace
+	{
+
+const int32_t c_instanceCount = 2000;
+const int32_t c_blobSize = 16 * 1024;
+const int32_t c_readerCount = 8;
+
+void fillBlob(uint8_t* blob, int32_t index)
+{
+	for (int32_t i = 0; i < c_blobSize; ++i)
+		blob[i] = uint8_t((i * 31 + index * 7) & 255);
+}
+
+bool populate(IProviderDatabase* database)
+{
+	AlignedVector< uint8_t > blob(c_blobSize);
+	for (int32_t i = 0; i < c_instanceCount; ++i)
+	{
+		Ref< IProviderInstance > instance = database->getRootGroup()->createInstance(L"Instance" + toString(i), Guid::create());
+		if (!instance)
+			return false;
+
+		fillBlob(blob.ptr(), i);
+
+		const TypeInfo* serializerType = nullptr;
+		Ref< IStream > objectStream = instance->writeObject(L"traktor.Object", serializerType);
+		if (!objectStream || objectStream->write(blob.c_ptr(), c_blobSize) != c_blobSize)
+			return false;
+		objectStream->close();
+
+		Ref< IStream > dataStream = instance->writeData(L"Data");
+		if (!dataStream || dataStream->write(blob.c_ptr(), c_blobSize / 2) != c_blobSize / 2)
+			return false;
+		dataStream->close();
+	}
+	return true;
+}
+
+int32_t instanceIndex(const IProviderInstance* instance)
+{
+	return parseString< int32_t >(instance->getName().substr(8), -1);
+}
+
+/*! Read all instances from multiple threads, return number of correctly read instances. */
+int32_t readConcurrent(IProviderDatabase* database, double& outDuration)
+{
+	RefArray< IProviderGroup > childGroups;
+	RefArray< IProviderInstance > childInstances;
+	database->getRootGroup()->getChildren(childGroups, childInstances);
+
+	// Order of children isn't defined; sort by index in name so instances match their blobs.
+	childInstances.sort([](const IProviderInstance* lh, const IProviderInstance* rh) {
+		return instanceIndex(lh) < instanceIndex(rh);
+	});
+
+	std::atomic< int32_t > correct = 0;
+
+	Job::task_t jobs[c_readerCount];
+	for (int32_t i = 0; i < c_readerCount; ++i)
+	{
+		jobs[i] = [&](){
+			AlignedVector< uint8_t > expected(c_blobSize);
+			AlignedVector< uint8_t > blob(c_blobSize);
+			for (int32_t j = 0; j < (int32_t)childInstances.size(); ++j)
+			{
+				const TypeInfo* serializerType = nullptr;
+				Ref< IStream > objectStream = childInstances[j]->readObject(serializerType);
+				if (!objectStream)
+					continue;
+
+				const int64_t nread = objectStream->read(blob.ptr(), c_blobSize);
+				objectStream->close();
+
+				fillBlob(expected.ptr(), j);
+				if (nread == c_blobSize && std::memcmp(blob.c_ptr(), expected.c_ptr(), c_blobSize) == 0)
+					correct++;
+			}
+		};
+	}
+
+	Timer timer;
+	JobManager::getInstance().fork(jobs, sizeof_array(jobs));
+	outDuration = timer.getElapsedTime();
+
+	return correct;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.test.CasePackedDatabase", 0, CasePackedDatabase, traktor::test::Case)
+
+void CasePackedDatabase::run()
+{
+	const double totalBytes = double(c_readerCount) * c_instanceCount * c_blobSize;
+
+	// Create both databases with identical content.
+	{
+		Ref< CompactDatabase > compactDatabase = new CompactDatabase();
+		CASE_ASSERT(compactDatabase->create(ConnectionString(L"fileName=CasePackedDatabase.compact")));
+		CASE_ASSERT(populate(compactDatabase));
+		compactDatabase->close();
+
+		Ref< PackedDatabase > packedDatabase = new PackedDatabase();
+		CASE_ASSERT(packedDatabase->create(ConnectionString(L"fileName=CasePackedDatabase.pak")));
+		CASE_ASSERT(populate(packedDatabase));
+		packedDatabase->close();
+	}
+
+	// Read back concurrently from both databases.
+	{
+		Ref< CompactDatabase > compactDatabase = new CompactDatabase();
+		CASE_ASSERT(compactDatabase->open(ConnectionString(L"fileName=CasePackedDatabase.compact;readOnly=true")));
+
+		double duration = 0.0;
+		const int32_t correct = readConcurrent(compactDatabase, duration);
+		CASE_ASSERT_EQUAL(correct, c_readerCount * c_instanceCount);
+		log::info << L"Compact: " << (totalBytes / (1024.0 * 1024.0)) / duration << L" MiB/s (" << duration * 1000.0 << L" ms)" << Endl;
+
+		compactDatabase->close();
+	}
+	{
+		Ref< PackedDatabase > packedDatabase = new PackedDatabase();
+		CASE_ASSERT(packedDatabase->open(ConnectionString(L"fileName=CasePackedDatabase.pak")));
+
+		double duration = 0.0;
+		const int32_t correct = readConcurrent(packedDatabase, duration);
+		CASE_ASSERT_EQUAL(correct, c_readerCount * c_instanceCount);
+		log::info << L"Packed: " << (totalBytes / (1024.0 * 1024.0)) / duration << L" MiB/s (" << duration * 1000.0 << L" ms)" << Endl;
+
+		// Data names are resolved through hashed index.
+		RefArray< IProviderGroup > childGroups;
+		RefArray< IProviderInstance > childInstances;
+		packedDatabase->getRootGroup()->getChildren(childGroups, childInstances);
+		CASE_ASSERT_EQUAL((int32_t)childInstances.size(), c_instanceCount);
+		if (!childInstances.empty())
+		{
+			Ref< IStream > dataStream = childInstances.front()->readData(L"Data");
+			CASE_ASSERT(dataStream != nullptr);
+			if (dataStream)
+				CASE_ASSERT_EQUAL(dataStream->available(), (int64_t)(c_blobSize / 2));
+			CASE_ASSERT(childInstances.front()->readData(L"Missing") == nullptr);
+		}
+
+		packedDatabase->close();
+	}
+
+	// Data names with colliding hashes must not overwrite each other.
+	{
+		std::wstring names[2];
+		std::map< uint32_t, std::wstring > hashes;
+		for (int32_t i = 0; names[0].empty(); ++i)
+		{
+			const std::wstring name = L"Data" + toString(i);
+			const uint32_t hash = PackedArchive::hashDataName(name);
+			auto it = hashes.find(hash);
+			if (it != hashes.end())
+			{
+				names[0] = it->second;
+				names[1] = name;
+			}
+			else
+				hashes.insert(std::make_pair(hash, name));
+		}
+
+		Ref< PackedArchiveWriter > writer = new PackedArchiveWriter();
+		CASE_ASSERT(writer->create(L"CasePackedDatabase.collision.pak"));
+
+		const Guid guid = Guid::create();
+		const uint8_t data[] = { 1, 2, 3, 4 };
+		CASE_ASSERT(writer->write(guid, names[0], data, sizeof(data)));
+		CASE_ASSERT(writer->write(guid, names[0], data, sizeof(data)));
+		CASE_ASSERT(!writer->write(guid, names[1], data, sizeof(data)));
+		CASE_ASSERT(writer->createWriteStream(guid, names[1]) == nullptr);
+		CASE_ASSERT(writer->createWriteStream(Guid::create(), names[1]) != nullptr);
+
+		Ref< CompactRegistry > registry = new CompactRegistry();
+		CASE_ASSERT(writer->close(registry));
+	}
+
+	// Archive with entry outside of file must be rejected.
+	{
+		Ref< PackedArchiveWriter > writer = new PackedArchiveWriter();
+		CASE_ASSERT(writer->create(L"CasePackedDatabase.corrupt.pak"));
+
+		const uint8_t data[] = { 1, 2, 3, 4 };
+		CASE_ASSERT(writer->write(Guid::create(), L"", data, sizeof(data)));
+
+		Ref< CompactRegistry > registry = new CompactRegistry();
+		CASE_ASSERT(writer->close(registry));
+
+		Ref< PackedArchive > archive = new PackedArchive();
+		CASE_ASSERT(archive->open(L"CasePackedDatabase.corrupt.pak"));
+		archive->close();
+
+		// Patch size of entry so it reach beyond end of file.
+		AlignedVector< uint8_t > content;
+		{
+			Ref< IStream > file = FileSystem::getInstance().open(L"CasePackedDatabase.corrupt.pak", File::FmRead);
+			CASE_ASSERT(file != nullptr);
+			if (!file)
+				return;
+			content.resize((size_t)file->available());
+			CASE_ASSERT(file->read(content.ptr(), (int64_t)content.size()) == (int64_t)content.size());
+			file->close();
+		}
+
+		PackedArchive::Header header;
+		std::memcpy(&header, content.c_ptr(), sizeof(header));
+
+		PackedArchive::Entry entry;
+		std::memcpy(&entry, content.c_ptr() + header.indexOffset, sizeof(entry));
+		entry.size = ~0ULL - entry.offset + 1;
+		std::memcpy(content.ptr() + header.indexOffset, &entry, sizeof(entry));
+
+		{
+			Ref< IStream > file = FileSystem::getInstance().open(L"CasePackedDatabase.corrupt.pak", File::FmWrite);
+			CASE_ASSERT(file != nullptr);
+			if (!file)
+				return;
+			CASE_ASSERT(file->write(content.c_ptr(), (int64_t)content.size()) == (int64_t)content.size());
+			file->close();
+		}
+
+		CASE_ASSERT(!archive->open(L"CasePackedDatabase.corrupt.pak"));
+	}
+
+	FileSystem::getInstance().remove(L"CasePackedDatabase.compact");
+	FileSystem::getInstance().remove(L"CasePackedDatabase.pak");
+	FileSystem::getInstance().remove(L"CasePackedDatabase.collision.pak");
+	FileSystem::getInstance().remove(L"CasePackedDatabase.corrupt.pak");
+}
+
+}
@@ -7,8 +7,10 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include <limits>
+#include "Core/Io/IStream.h"
 #include "Core/Log/Log.h"
 #include "Core/Misc/StringSplit.h"
+#include "Core/Serialization/ISerializable.h"
 #include "Core/Thread/Acquire.h"
 #include "Database/Database.h"
 #include "Database/Group.h"
@@ -22,6 +24,7 @@
 #include "Database/Events/EvtInstanceRenamed.h"
 #include "Database/Provider/IProviderDatabase.h"
 #include "Database/Provider/IProviderBus.h"
+#include "Database/Provider/IProviderInstance.h"
 
 namespace traktor::db
 {
@@ -286,6 +289,53 @@ Ref< ISerializable > Database::getObjectReadOnly(const Guid& guid) const
 	return i->second->getObject();
 }
 
+bool Database::getObjects(const RefArray< Instance >& instances, RefArray< ISerializable >& outObjects) const
+{
+	T_ASSERT(m_providerDatabase);
+
+	outObjects.resize(0);
+
+	RefArray< IProviderInstance > providerInstances;
+	providerInstances.reserve(instances.size());
+	for (auto instance : instances)
+		providerInstances.push_back(instance->m_providerInstance);
+
+	RefArray< IStream > streams;
+	AlignedVector< const TypeInfo* > serializerTypes;
+	if (!m_providerDatabase->readObjects(providerInstances, streams, serializerTypes))
+		return false;
+	if (streams.size() != instances.size() || serializerTypes.size() != instances.size())
+		return false;
+
+	outObjects.reserve(instances.size());
+	for (size_t i = 0; i < instances.size(); ++i)
+	{
+		if (streams[i] && serializerTypes[i])
+			outObjects.push_back(instances[i]->readObject(streams[i], serializerTypes[i]));
+		else
+			outObjects.push_back(nullptr);
+	}
+
+	return true;
+}
+
+bool Database::readData(const RefArray< Instance >& instances, const std::wstring& dataName, RefArray< IStream >& outStreams) const
+{
+	T_ASSERT(m_providerDatabase);
+
+	RefArray< IProviderInstance > providerInstances;
+	providerInstances.reserve(instances.size());
+	for (auto instance : instances)
+		providerInstances.push_back(instance->m_providerInstance);
+
+	return m_providerDatabase->readData(providerInstances, dataName, outStreams);
+}
+
+int32_t Database::getMaxConcurrentReads() const
+{
+	return m_providerDatabase ? m_providerDatabase->getMaxConcurrentReads() : 1;
+}
+
 bool Database::getEvent(Ref< const IEvent >& outEvent, bool& outRemote)
 {
 	T_ASSERT(m_providerDatabase);
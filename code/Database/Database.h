@@ -11,6 +11,7 @@
 #include "Core/Guid.h"
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/RefArray.h"
 #include "Core/Containers/SmallMap.h"
 #include "Core/Thread/Semaphore.h"
 #include "Database/ConnectionString.h"
@@ -30,6 +31,7 @@ namespace traktor
 {
 
 class ISerializable;
+class IStream;
 
 }
 
@@ -132,6 +134,30 @@ public:
 		return dynamic_type_cast< T* >(object);
 	}
 
+	/*! Get objects of multiple instances.
+	 *
+	 * Objects are read in a single batch if supported by
+	 * provider, thus more efficient than reading objects
+	 * one instance at a time.
+	 *
+	 * \param instances Instances to read objects from.
+	 * \param outObjects Objects, same order as instances; null if object couldn't be read.
+	 * \return True if successful.
+	 */
+	virtual bool getObjects(const RefArray< Instance >& instances, RefArray< ISerializable >& outObjects) const;
+
+	/*! Read data of multiple instances.
+	 *
+	 * \param instances Instances to read data from.
+	 * \param dataName Name of data.
+	 * \param outStreams Data streams, same order as instances; null if data couldn't be read.
+	 * \return True if successful.
+	 */
+	virtual bool readData(const RefArray< Instance >& instances, const std::wstring& dataName, RefArray< IStream >& outStreams) const;
+
+	/*! Get number of instances which can be read concurrently from provider. */
+	virtual int32_t getMaxConcurrentReads() const;
+
 	/*! Get event from bus.
 	 *
 	 * \note
@@ -117,28 +117,13 @@ Ref< ISerializable > Instance::getObject() const
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	T_ASSERT(m_providerInstance);
 
-	Ref< ISerializable > object;
 	const TypeInfo* serializerType = nullptr;
 
 	Ref< IStream > stream = m_providerInstance->readObject(serializerType);
 	if (!stream || !serializerType)
 		return nullptr;
 
-	Ref< Serializer > serializer;
-	if (serializerType == &type_of< BinarySerializer >())
-		serializer = new BinarySerializer(stream);
-	else if (serializerType == &type_of< xml::XmlDeserializer >())
-		serializer = new xml::XmlDeserializer(stream, getPath());
-	else
-	{
-		stream->close();
-		return nullptr;
-	}
-
-	object = serializer->readObject();
-
-	stream->close();
-	return object;
+	return readObject(stream, serializerType);
 }
 
 uint32_t Instance::getDataNames(AlignedVector< std::wstring >& dataNames) const
@@ -417,4 +402,23 @@ void Instance::internalFlush()
 	m_cachedFlags = 0;
 }
 
+Ref< ISerializable > Instance::readObject(IStream* stream, const TypeInfo* serializerType) const
+{
+	Ref< Serializer > serializer;
+	if (serializerType == &type_of< BinarySerializer >())
+		serializer = new BinarySerializer(stream);
+	else if (serializerType == &type_of< xml::XmlDeserializer >())
+		serializer = new xml::XmlDeserializer(stream, getPath());
+	else
+	{
+		stream->close();
+		return nullptr;
+	}
+
+	Ref< ISerializable > object = serializer->readObject();
+
+	stream->close();
+	return object;
+}
+
 }
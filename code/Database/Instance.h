@@ -143,6 +143,9 @@ private:
 	void internalDestroy();
 
 	void internalFlush();
+
+	/*! Deserialize object from stream, stream is closed when done. */
+	Ref< ISerializable > readObject(IStream* stream, const TypeInfo* serializerType) const;
 };
 
 }
@@ -7,16 +7,19 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Database/Local/Context.h"
+#include "Database/Local/IFileStore.h"
+#include "Database/Local/MetaIndex.h"
 
 namespace traktor::db
 {
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.db.Context", Context, Object)
 
-Context::Context(bool preferBinary, IFileStore* fileStore)
+Context::Context(bool preferBinary, IFileStore* fileStore, MetaIndex* metaIndex)
 :	m_sessionGuid(Guid::create())
 ,	m_preferBinary(preferBinary)
 ,	m_fileStore(fileStore)
+,	m_metaIndex(metaIndex)
 {
 }
 
@@ -35,4 +38,9 @@ IFileStore* Context::getFileStore() const
 	return m_fileStore;
 }
 
+MetaIndex* Context::getMetaIndex() const
+{
+	return m_metaIndex;
+}
+
 }
@@ -16,6 +16,7 @@ namespace traktor::db
 {
 
 class IFileStore;
+class MetaIndex;
 
 /*! Local database context.
  * \ingroup Database
@@ -27,7 +28,7 @@ class Context : public Object
 public:
 	Context() = default;
 
-	explicit Context(bool preferBinary, IFileStore* fileStore);
+	explicit Context(bool preferBinary, IFileStore* fileStore, MetaIndex* metaIndex);
 
 	const Guid& getSessionGuid() const;
 
@@ -35,10 +36,14 @@ public:
 
 	IFileStore* getFileStore() const;
 
+	/*! Get instance meta index, null if index is disabled. */
+	MetaIndex* getMetaIndex() const;
+
 private:
 	Guid m_sessionGuid;
 	bool m_preferBinary = false;
 	Ref< IFileStore > m_fileStore;
+	Ref< MetaIndex > m_metaIndex;
 };
 
 }
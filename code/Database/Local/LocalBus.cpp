@@ -15,6 +15,7 @@
 #include "Core/System/OS.h"
 #include "Database/IEvent.h"
 #include "Database/Local/LocalBus.h"
+#include "Database/Local/MetaIndex.h"
 
 namespace traktor::db
 {
@@ -46,9 +47,10 @@ struct EntryHeader
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.db.LocalBus", LocalBus, IProviderBus)
 
-LocalBus::LocalBus(const std::wstring& journalFileName)
+LocalBus::LocalBus(const std::wstring& journalFileName, MetaIndex* metaIndex)
 :	m_localGuid(Guid::create())
 ,	m_journalFileName(journalFileName)
+,	m_metaIndex(metaIndex)
 {
 	m_shm = OS::getInstance().createSharedMemory(journalFileName, c_maxJournalSize);
 	T_FATAL_ASSERT(m_shm != nullptr);
@@ -138,6 +140,12 @@ bool LocalBus::getEvent(uint64_t& inoutSqnr, Ref< const IEvent >& outEvent, bool
 				outRemote = (bool)(Guid(eh->sender) != m_localGuid);
 
 				m_shm->releaseReadPointer();
+
+				// Another process has modified the database; indexed
+				// meta might be stale.
+				if (outRemote && m_metaIndex)
+					m_metaIndex->invalidateAll();
+
 				return true;
 			}
 			erp += sizeof(EntryHeader) + eh->size;
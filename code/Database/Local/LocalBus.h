@@ -21,6 +21,8 @@ class ISharedMemory;
 namespace traktor::db
 {
 
+class MetaIndex;
+
 /*! Local database event bus.
  * \ingroup Database
  *
@@ -32,7 +34,7 @@ class LocalBus : public IProviderBus
 	T_RTTI_CLASS;
 
 public:
-	explicit LocalBus(const std::wstring& journalFileName);
+	explicit LocalBus(const std::wstring& journalFileName, MetaIndex* metaIndex);
 
 	virtual ~LocalBus();
 
@@ -46,6 +48,7 @@ private:
 	Guid m_localGuid;
 	std::wstring m_journalFileName;
 	Ref< ISharedMemory > m_shm;
+	Ref< MetaIndex > m_metaIndex;
 };
 
 }
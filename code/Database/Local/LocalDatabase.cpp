@@ -9,13 +9,16 @@
 #include "Core/Io/FileSystem.h"
 #include "Core/Io/IStream.h"
 #include "Core/Log/Log.h"
+#include "Core/Misc/Murmur3.h"
 #include "Core/Misc/String.h"
+#include "Core/System/OS.h"
 #include "Database/ConnectionString.h"
 #include "Database/Local/Context.h"
 #include "Database/Local/DefaultFileStore.h"
 #include "Database/Local/LocalBus.h"
 #include "Database/Local/LocalDatabase.h"
 #include "Database/Local/LocalGroup.h"
+#include "Database/Local/MetaIndex.h"
 #include "Xml/XmlDeserializer.h"
 #include "Xml/XmlSerializer.h"
 
@@ -50,6 +53,7 @@ bool LocalDatabase::open(const ConnectionString& connectionString)
 	const Path groupPath = FileSystem::getInstance().getAbsolutePath(connectionString.get(L"groupPath"));
 	const bool journal = connectionString.have(L"journal") ? parseString< bool >(connectionString.get(L"journal")) : true;
 	const bool binary = connectionString.have(L"binary") ? parseString< bool >(connectionString.get(L"binary")) : false;
+	const bool index = connectionString.have(L"index") ? parseString< bool >(connectionString.get(L"index")) : false;
 
 	// Ensure group path exists.
 	if (!FileSystem::getInstance().makeAllDirectories(groupPath))
@@ -91,10 +95,27 @@ bool LocalDatabase::open(const ConnectionString& connectionString)
 		}
 	}
 
+	// Create instance meta index; load persisted index from previous
+	// session and scan for new or modified instances. Index is persisted
+	// in user's writable folder, keyed by group path, to not pollute data tree.
+	if (index)
+	{
+		Murmur3 cs;
+		cs.begin();
+		cs.feed(groupPath.getPathName());
+		cs.end();
+
+		m_metaIndex = new MetaIndex();
+		m_metaIndexFileName = OS::getInstance().getWritableFolderPath() + L"/Traktor/Database/" + str(L"%08x.index", cs.get());
+		m_metaIndex->load(m_metaIndexFileName);
+		m_metaIndex->scan(groupPath);
+	}
+
 	// Create context.
 	m_context = Context(
 		binary,
-		fileStore
+		fileStore,
+		m_metaIndex
 	);
 
 	// Create event journal file.
@@ -107,7 +128,7 @@ bool LocalDatabase::open(const ConnectionString& connectionString)
 			return false;
 		}
 
-		m_bus = new LocalBus(eventPath.getPathName());
+		m_bus = new LocalBus(eventPath.getPathName(), m_metaIndex);
 	}
 
 	m_rootGroup = new LocalGroup(m_context, groupPath, GfNormal);
@@ -125,6 +146,13 @@ void LocalDatabase::close()
 		m_bus = nullptr;
 	}
 
+	if (m_metaIndex)
+	{
+		if (!m_metaIndex->save(m_metaIndexFileName))
+			log::warning << L"Unable to save database index \"" << m_metaIndexFileName << L"\"." << Endl;
+		m_metaIndex = nullptr;
+	}
+
 	if (m_context.getFileStore())
 	{
 		m_context.getFileStore()->destroy();
@@ -142,4 +170,10 @@ IProviderGroup* LocalDatabase::getRootGroup()
 	return m_rootGroup;
 }
 
+int32_t LocalDatabase::getMaxConcurrentReads() const
+{
+	// Each instance is stored in separate files.
+	return 4;
+}
+
 }
@@ -32,6 +32,7 @@ namespace traktor::db
 class Context;
 class LocalBus;
 class LocalGroup;
+class MetaIndex;
 
 /*! Local database provider.
  * \ingroup Database
@@ -51,10 +52,14 @@ public:
 
 	virtual IProviderGroup* getRootGroup() override final;
 
+	virtual int32_t getMaxConcurrentReads() const override final;
+
 private:
 	Context m_context;
 	Ref< LocalBus > m_bus;
 	Ref< LocalGroup > m_rootGroup;
+	Ref< MetaIndex > m_metaIndex;
+	std::wstring m_metaIndexFileName;
 };
 
 }
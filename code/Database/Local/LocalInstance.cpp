@@ -17,6 +17,7 @@
 #include "Database/Local/IFileStore.h"
 #include "Database/Local/LocalInstance.h"
 #include "Database/Local/LocalInstanceMeta.h"
+#include "Database/Local/MetaIndex.h"
 #include "Database/Local/Transaction.h"
 #include "Database/Local/ActionSetGuid.h"
 #include "Database/Local/ActionSetName.h"
@@ -57,8 +58,7 @@ bool LocalInstance::internalCreateNew(const Guid& instanceGuid)
 
 std::wstring LocalInstance::getPrimaryTypeName() const
 {
-	const Path instanceMetaPath = getInstanceMetaPath(m_instancePath);
-	Ref< LocalInstanceMeta > instanceMeta = readPhysicalObject< LocalInstanceMeta >(instanceMetaPath);
+	Ref< const LocalInstanceMeta > instanceMeta = getMeta();
 	return instanceMeta ? instanceMeta->getPrimaryType() : L"";
 }
 
@@ -86,7 +86,18 @@ bool LocalInstance::commitTransaction()
 		return false;
 	}
 
-	if (!m_transaction->commit(m_context))
+	const bool result = m_transaction->commit(m_context);
+
+	// Meta of instance might have been modified, even if commit failed
+	// since it might have been partially committed.
+	if (MetaIndex* metaIndex = m_context.getMetaIndex())
+	{
+		metaIndex->invalidate(getInstanceMetaPath(m_instancePath));
+		if (!m_transactionName.empty())
+			metaIndex->invalidate(getInstanceMetaPath(m_instancePath.getPathOnly() + L"/" + m_transactionName));
+	}
+
+	if (!result)
 	{
 		log::error << L"commitTransaction failed; commit failed." << Endl;
 		return false;
@@ -129,8 +140,7 @@ bool LocalInstance::setName(const std::wstring& name)
 
 Guid LocalInstance::getGuid() const
 {
-	const Path instanceMetaPath = getInstanceMetaPath(m_instancePath);
-	Ref< LocalInstanceMeta > instanceMeta = readPhysicalObject< LocalInstanceMeta >(instanceMetaPath);
+	Ref< const LocalInstanceMeta > instanceMeta = getMeta();
 	return instanceMeta ? instanceMeta->getGuid() : Guid();
 }
 
@@ -234,9 +244,7 @@ Ref< IStream > LocalInstance::writeObject(const std::wstring& primaryTypeName, c
 
 uint32_t LocalInstance::getDataNames(AlignedVector< std::wstring >& outDataNames) const
 {
-	const Path instanceMetaPath = getInstanceMetaPath(m_instancePath);
-
-	Ref< LocalInstanceMeta > instanceMeta = readPhysicalObject< LocalInstanceMeta >(instanceMetaPath);
+	Ref< const LocalInstanceMeta > instanceMeta = getMeta();
 	if (!instanceMeta)
 		return 0;
 
@@ -293,4 +301,13 @@ Ref< IStream > LocalInstance::writeData(const std::wstring& dataName)
 	return action->getWriteStream();
 }
 
+Ref< const LocalInstanceMeta > LocalInstance::getMeta() const
+{
+	const Path instanceMetaPath = getInstanceMetaPath(m_instancePath);
+	if (MetaIndex* metaIndex = m_context.getMetaIndex())
+		return metaIndex->get(instanceMetaPath);
+	else
+		return readPhysicalObject< LocalInstanceMeta >(instanceMetaPath);
+}
+
 }
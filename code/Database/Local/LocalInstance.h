@@ -16,6 +16,7 @@ namespace traktor::db
 
 class Context;
 class LocalGroup;
+class LocalInstanceMeta;
 class Transaction;
 
 /*! Local instance.
@@ -71,6 +72,8 @@ private:
 	Path m_instancePath;
 	Ref< Transaction > m_transaction;
 	std::wstring m_transactionName;
+
+	Ref< const LocalInstanceMeta > getMeta() const;
 };
 
 }
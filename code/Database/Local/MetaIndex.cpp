@@ -0,0 +1,266 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <atomic>
+#include "Core/Guid.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Io/BufferedStream.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/Reader.h"
+#include "Core/Io/Writer.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/String.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobManager.h"
+#include "Database/Local/LocalInstanceMeta.h"
+#include "Database/Local/MetaIndex.h"
+#include "Database/Local/PhysicalAccess.h"
+
+namespace traktor::db
+{
+	namespace
+	{
+
+const uint32_t c_indexMagic = 0x54444d49;	// "TDMI"
+const uint32_t c_indexVersion = 2;
+const uint32_t c_maxScanJobs = 16;
+
+struct ScanFile
+{
+	Path metaPath;
+	uint64_t lastWriteTime;
+	uint64_t size;
+	Ref< const LocalInstanceMeta > meta;
+};
+
+void collectMetaFiles(const Path& groupPath, AlignedVector< ScanFile >& outFiles)
+{
+	RefArray< File > groupFiles = FileSystem::getInstance().find(groupPath.getPathName() + L"/*.*");
+	for (auto groupFile : groupFiles)
+	{
+		const Path& path = groupFile->getPath();
+		if (groupFile->isDirectory())
+		{
+			if (path.getFileName() != L"." && path.getFileName() != L"..")
+				collectMetaFiles(path, outFiles);
+		}
+		else if (compareIgnoreCase(path.getExtension(), L"xdm") == 0)
+			outFiles.push_back({ path, groupFile->getLastWriteTime().getSecondsSinceEpoch(), groupFile->getSize(), nullptr });
+	}
+}
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.db.MetaIndex", MetaIndex, Object)
+
+void MetaIndex::scan(const Path& groupPath)
+{
+	AlignedVector< ScanFile > files;
+	collectMetaFiles(groupPath, files);
+
+	// Reuse already indexed meta which hasn't been modified; time stamps
+	// are only in seconds so size must also match.
+	{
+		T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
+		for (auto& file : files)
+		{
+			auto it = m_entries.find(file.metaPath.getPathName());
+			if (it != m_entries.end() && it->second.lastWriteTime == file.lastWriteTime && it->second.size == file.size)
+				file.meta = it->second.meta;
+		}
+	}
+
+	AlignedVector< ScanFile* > pending;
+	for (auto& file : files)
+	{
+		if (!file.meta)
+			pending.push_back(&file);
+	}
+
+	// Read remaining meta files in parallel.
+	if (!pending.empty())
+	{
+		const uint32_t jobCount = std::min< uint32_t >(std::min< uint32_t >(OS::getInstance().getCPUCoreCount(), c_maxScanJobs), (uint32_t)pending.size());
+		std::atomic< uint32_t > next = 0;
+
+		AlignedVector< Job::task_t > tasks(jobCount, [&]() {
+			for (;;)
+			{
+				const uint32_t index = next++;
+				if (index >= pending.size())
+					break;
+
+				ScanFile* file = pending[index];
+				file->meta = readPhysicalObject< LocalInstanceMeta >(file->metaPath);
+			}
+		});
+		JobManager::getInstance().fork(tasks.c_ptr(), tasks.size());
+	}
+
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+	m_entries.clear();
+	for (const auto& file : files)
+	{
+		if (file.meta)
+			m_entries[file.metaPath.getPathName()] = { file.meta, file.lastWriteTime, file.size };
+	}
+	m_generation++;
+	m_modified |= !pending.empty();
+}
+
+bool MetaIndex::load(const Path& indexPath)
+{
+	Ref< IStream > file = FileSystem::getInstance().open(indexPath, File::FmRead);
+	if (!file)
+		return false;
+
+	BufferedStream stream(file);
+	Reader r(&stream);
+
+	uint32_t magic = 0, version = 0, count = 0;
+	r >> magic;
+	r >> version;
+	if (magic != c_indexMagic || version != c_indexVersion)
+	{
+		file->close();
+		return false;
+	}
+
+	std::map< std::wstring, Entry > entries;
+
+	r >> count;
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		std::wstring metaPath;
+		Entry entry;
+
+		r >> metaPath;
+		r >> entry.lastWriteTime;
+		r >> entry.size;
+		entry.meta = BinarySerializer(&stream).readObject< LocalInstanceMeta >();
+		if (!entry.meta)
+		{
+			log::warning << L"Corrupt database index \"" << indexPath.getPathName() << L"\"; ignored." << Endl;
+			file->close();
+			return false;
+		}
+
+		entries.insert(std::make_pair(metaPath, entry));
+	}
+
+	file->close();
+
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+	m_entries.swap(entries);
+	m_generation++;
+	m_modified = false;
+	return true;
+}
+
+bool MetaIndex::save(const Path& indexPath)
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+
+	if (!m_modified)
+		return true;
+
+	if (!FileSystem::getInstance().makeAllDirectories(indexPath.getPathOnly()))
+		return false;
+
+	// Write into uniquely named temporary file first so a partial
+	// index is never read, even if several processes save concurrently.
+	const Path tempPath(indexPath.getPathName() + L"." + Guid::create().format() + L"~");
+
+	Ref< IStream > file = FileSystem::getInstance().open(tempPath, File::FmWrite);
+	if (!file)
+		return false;
+
+	BufferedStream stream(file);
+	Writer w(&stream);
+
+	w << c_indexMagic;
+	w << c_indexVersion;
+	w << (uint32_t)m_entries.size();
+
+	for (const auto& it : m_entries)
+	{
+		w << it.first;
+		w << it.second.lastWriteTime;
+		w << it.second.size;
+		if (!BinarySerializer(&stream).writeObject(it.second.meta))
+		{
+			stream.close();
+			FileSystem::getInstance().remove(tempPath);
+			return false;
+		}
+	}
+
+	stream.close();
+
+	if (!FileSystem::getInstance().move(indexPath, tempPath, true))
+	{
+		FileSystem::getInstance().remove(tempPath);
+		return false;
+	}
+
+	m_modified = false;
+	return true;
+}
+
+Ref< const LocalInstanceMeta > MetaIndex::get(const Path& instanceMetaPath)
+{
+	const std::wstring key = instanceMetaPath.getPathName();
+	uint32_t generation;
+
+	{
+		T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
+		auto it = m_entries.find(key);
+		if (it != m_entries.end())
+			return it->second.meta;
+		generation = m_generation;
+	}
+
+	// Stat before reading so a concurrent modification
+	// will be detected when index is loaded next time.
+	Ref< File > metaFile = FileSystem::getInstance().get(instanceMetaPath);
+	if (!metaFile)
+		return nullptr;
+
+	Ref< const LocalInstanceMeta > meta = readPhysicalObject< LocalInstanceMeta >(instanceMetaPath);
+	if (!meta)
+		return nullptr;
+
+	// Do not index meta if index has been invalidated while we've
+	// been reading since meta read might already be outdated.
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+	if (m_generation == generation)
+	{
+		m_entries[key] = { meta, metaFile->getLastWriteTime().getSecondsSinceEpoch(), metaFile->getSize() };
+		m_modified = true;
+	}
+	return meta;
+}
+
+void MetaIndex::invalidate(const Path& instanceMetaPath)
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+	if (m_entries.erase(instanceMetaPath.getPathName()) > 0)
+		m_modified = true;
+	m_generation++;
+}
+
+void MetaIndex::invalidateAll()
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+	m_modified |= !m_entries.empty();
+	m_entries.clear();
+	m_generation++;
+}
+
+}
@@ -0,0 +1,80 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <map>
+#include <string>
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Thread/ReaderWriterLock.h"
+
+namespace traktor
+{
+
+class Path;
+
+}
+
+namespace traktor::db
+{
+
+class LocalInstanceMeta;
+
+/*! In-memory index of instance meta.
+ * \ingroup Database
+ *
+ * Instance meta is read from physical files on demand and
+ * kept in memory until invalidated, thus queries such as
+ * primary type or guid doesn't need to touch the disk.
+ * The index can be populated up front with a parallel scan
+ * and persisted between sessions; persisted entries are
+ * validated by last write time and size of the meta files.
+ */
+class MetaIndex : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	/*! Scan group hierarchy for instances.
+	 *
+	 * Meta files which are not already indexed, or have
+	 * been modified since, are read in parallel.
+	 */
+	void scan(const Path& groupPath);
+
+	/*! Load persisted index. */
+	bool load(const Path& indexPath);
+
+	/*! Save index, only written if index has changed. */
+	bool save(const Path& indexPath);
+
+	/*! Get instance meta, read from file if not indexed. */
+	Ref< const LocalInstanceMeta > get(const Path& instanceMetaPath);
+
+	/*! Invalidate indexed meta of an instance. */
+	void invalidate(const Path& instanceMetaPath);
+
+	/*! Invalidate all indexed meta. */
+	void invalidateAll();
+
+private:
+	struct Entry
+	{
+		Ref< const LocalInstanceMeta > meta;
+		uint64_t lastWriteTime = 0;
+		uint64_t size = 0;
+	};
+
+	ReaderWriterLock m_lock;
+	std::map< std::wstring, Entry > m_entries;
+	uint32_t m_generation = 0;	//!< Incremented when entries are invalidated or replaced.
+	bool m_modified = false;
+};
+
+}
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include "Core/Io/FileOutputStream.h"
 #include "Core/Io/FileSystem.h"
 #include "Core/Io/IStream.h"
@@ -17,6 +18,7 @@
 #include "Core/Log/LogStreamTarget.h"
 #include "Core/Misc/CommandLine.h"
 #include "Core/Misc/TString.h"
+#include "Core/Serialization/ISerializable.h"
 #include "Core/Settings/PropertyGroup.h"
 #include "Core/Settings/PropertyString.h"
 #include "Core/Settings/PropertyStringSet.h"
@@ -48,21 +50,18 @@ int32_t countGroups(db::Group* group)
 	return localCount;
 }
 
+const size_t c_batchSize = 16;
+
 /*! Migrate instance from source into target group.
  *
  * \param sourceInstance Source instance to migrate.
+ * \param sourceObject Object read from source instance.
+ * \param dataNames Names of source instance data.
+ * \param sourceStreams Source data streams, same order as data names.
  * \param targetGroup Migrate into target group.
  */
-bool migrateInstance(Ref< db::Instance > sourceInstance, Ref< db::Group > targetGroup, const DateTime& modifiedSince)
+bool migrateInstance(Ref< db::Instance > sourceInstance, const ISerializable* sourceObject, const AlignedVector< std::wstring >& dataNames, const RefArray< IStream >& sourceStreams, Ref< db::Group > targetGroup)
 {
-	// First check if source instance has been modified since last migration, if not
-	// then we can quickly ignore migration of instance.
-	DateTime sourceModifyDate;
-	sourceInstance->getLastModifyDate(sourceModifyDate);
-	if (sourceModifyDate < modifiedSince)
-		return true;
-
-	Ref< ISerializable > sourceObject = sourceInstance->getObject();
 	if (!sourceObject)
 	{
 		traktor::log::error << L"Failed, unable to get source object." << Endl;
@@ -71,9 +70,6 @@ bool migrateInstance(Ref< db::Instance > sourceInstance, Ref< db::Group > target
 
 	Guid sourceGuid = sourceInstance->getGuid();
 
-	AlignedVector< std::wstring > dataNames;
-	sourceInstance->getDataNames(dataNames);
-
 	Ref< db::Instance > targetInstance = targetGroup->createInstance(sourceInstance->getName(), db::CifReplaceExisting, &sourceGuid);
 	if (!targetInstance)
 	{
@@ -83,9 +79,11 @@ bool migrateInstance(Ref< db::Instance > sourceInstance, Ref< db::Group > target
 
 	targetInstance->setObject(sourceObject);
 
-	for (const auto& dataName : dataNames)
+	for (size_t i = 0; i < dataNames.size(); ++i)
 	{
-		Ref< IStream > sourceStream = sourceInstance->readData(dataName);
+		const std::wstring& dataName = dataNames[i];
+
+		Ref< IStream > sourceStream = sourceStreams[i];
 		if (!sourceStream)
 		{
 			traktor::log::error << L"Failed, unable to open source stream \"" << dataName << L"." << Endl;
@@ -118,15 +116,84 @@ bool migrateInstance(Ref< db::Instance > sourceInstance, Ref< db::Group > target
 	return true;
 }
 
+/*! Migrate batch of instances.
+ *
+ * Objects and data are read in batches thus only
+ * a few round trips are required if source is
+ * a remote database.
+ *
+ * \param sourceDb Source database.
+ * \param sourceInstances Source instances to migrate.
+ * \param targetGroup Migrate into target group.
+ */
+bool migrateInstances(db::Database* sourceDb, const RefArray< db::Instance >& sourceInstances, db::Group* targetGroup)
+{
+	RefArray< ISerializable > sourceObjects;
+	if (!sourceDb->getObjects(sourceInstances, sourceObjects))
+	{
+		traktor::log::error << L"Failed, unable to read source objects." << Endl;
+		return false;
+	}
+
+	AlignedVector< AlignedVector< std::wstring > > dataNames(sourceInstances.size());
+	AlignedVector< RefArray< IStream > > sourceStreams(sourceInstances.size());
+	SmallSet< std::wstring > uniqueDataNames;
+
+	for (size_t i = 0; i < sourceInstances.size(); ++i)
+	{
+		sourceInstances[i]->getDataNames(dataNames[i]);
+		sourceStreams[i].resize(dataNames[i].size());
+		uniqueDataNames.insert(dataNames[i].begin(), dataNames[i].end());
+	}
+
+	// Read data of same name from all instances in a single batch.
+	for (const auto& dataName : uniqueDataNames)
+	{
+		RefArray< db::Instance > dataInstances;
+		AlignedVector< std::pair< size_t, size_t > > dataSlots;
+
+		for (size_t i = 0; i < sourceInstances.size(); ++i)
+		{
+			for (size_t j = 0; j < dataNames[i].size(); ++j)
+			{
+				if (dataNames[i][j] == dataName)
+				{
+					dataInstances.push_back(sourceInstances[i]);
+					dataSlots.push_back(std::make_pair(i, j));
+				}
+			}
+		}
+
+		RefArray< IStream > streams;
+		if (!sourceDb->readData(dataInstances, dataName, streams) || streams.size() != dataSlots.size())
+		{
+			traktor::log::error << L"Failed, unable to read source data \"" << dataName << L"." << Endl;
+			return false;
+		}
+
+		for (size_t i = 0; i < dataSlots.size(); ++i)
+			sourceStreams[dataSlots[i].first][dataSlots[i].second] = streams[i];
+	}
+
+	for (size_t i = 0; i < sourceInstances.size(); ++i)
+	{
+		if (!migrateInstance(sourceInstances[i], sourceObjects[i], dataNames[i], sourceStreams[i], targetGroup))
+			return false;
+	}
+
+	return true;
+}
+
 /* Migrate instances sequentially.
  *
+ * \param sourceDb Source database
  * \param targetGroup Target group
  * \param sourceGroup Source group
  * \param groupIndex Index of current group.
  * \param groupCount Number of groups to migrate.
  * \return True if successful.
  */
-bool migrateGroup(db::Group* targetGroup, db::Group* sourceGroup, const DateTime& modifiedSince, int32_t& groupIndex, int32_t groupCount)
+bool migrateGroup(db::Database* sourceDb, db::Group* targetGroup, db::Group* sourceGroup, const DateTime& modifiedSince, int32_t& groupIndex, int32_t groupCount)
 {
 	T_ANONYMOUS_VAR(ScopeIndent)(log::info);
 	traktor::log::info << IncreaseIndent;
@@ -136,9 +203,24 @@ bool migrateGroup(db::Group* targetGroup, db::Group* sourceGroup, const DateTime
 	RefArray< db::Instance > childInstances;
 	sourceGroup->getChildInstances(childInstances);
 
+	// First check if source instances has been modified since last migration, if not
+	// then we can quickly ignore migration of instance.
+	RefArray< db::Instance > modifiedInstances;
 	for (auto childInstance : childInstances)
 	{
-		if (!migrateInstance(childInstance, targetGroup, modifiedSince))
+		DateTime sourceModifyDate;
+		childInstance->getLastModifyDate(sourceModifyDate);
+		if (sourceModifyDate >= modifiedSince)
+			modifiedInstances.push_back(childInstance);
+	}
+
+	for (size_t i = 0; i < modifiedInstances.size(); i += c_batchSize)
+	{
+		RefArray< db::Instance > batchInstances;
+		for (size_t j = i; j < std::min(i + c_batchSize, modifiedInstances.size()); ++j)
+			batchInstances.push_back(modifiedInstances[j]);
+
+		if (!migrateInstances(sourceDb, batchInstances, targetGroup))
 			return false;
 	}
 
@@ -157,7 +239,7 @@ bool migrateGroup(db::Group* targetGroup, db::Group* sourceGroup, const DateTime
 				return false;
 		}
 
-		if (!migrateGroup(targetChildGroup, childGroup, modifiedSince, groupIndex, groupCount))
+		if (!migrateGroup(sourceDb, targetChildGroup, childGroup, modifiedSince, groupIndex, groupCount))
 			return false;
 	}
 
@@ -341,7 +423,7 @@ int main(int argc, const char** argv)
 		if (verbose)
 			traktor::log::info << L"Migrating " << groupCount << L" group(s)..." << Endl;
 
-		if (!migrateGroup(targetGroup, sourceGroup, modifiedSince, groupIndex, groupCount))
+		if (!migrateGroup(sourceDb, targetGroup, sourceGroup, modifiedSince, groupIndex, groupCount))
 			return 5;
 	}
 
@@ -6,11 +6,39 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Io/IStream.h"
 #include "Database/Provider/IProviderDatabase.h"
+#include "Database/Provider/IProviderInstance.h"
 
 namespace traktor::db
 {
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.db.IProviderDatabase", IProviderDatabase, Object)
 
+bool IProviderDatabase::readObjects(const RefArray< IProviderInstance >& instances, RefArray< IStream >& outStreams, AlignedVector< const TypeInfo* >& outSerializerTypes)
+{
+	outStreams.resize(0);
+	outSerializerTypes.resize(0);
+
+	for (auto instance : instances)
+	{
+		const TypeInfo* serializerType = nullptr;
+		Ref< IStream > s = instance->readObject(serializerType);
+		outStreams.push_back(s);
+		outSerializerTypes.push_back(s ? serializerType : nullptr);
+	}
+
+	return true;
+}
+
+bool IProviderDatabase::readData(const RefArray< IProviderInstance >& instances, const std::wstring& dataName, RefArray< IStream >& outStreams)
+{
+	outStreams.resize(0);
+
+	for (auto instance : instances)
+		outStreams.push_back(instance->readData(dataName));
+
+	return true;
+}
+
 }
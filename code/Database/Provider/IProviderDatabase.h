@@ -8,8 +8,11 @@
  */
 #pragma once
 
+#include <string>
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
 
 // import/export mechanism.
 #undef T_DLLCLASS
@@ -19,12 +22,20 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class IStream;
+
+}
+
 namespace traktor::db
 {
 
 class ConnectionString;
 class IProviderBus;
 class IProviderGroup;
+class IProviderInstance;
 
 /*! Provider database interface.
  * \ingroup Database
@@ -62,6 +73,38 @@ public:
 	 * \return Root group.
 	 */
 	virtual IProviderGroup* getRootGroup() = 0;
+
+	/*! Get number of instances which can be read concurrently.
+	 *
+	 * Used as a hint by systems which read instances
+	 * from multiple threads, such as asynchronous
+	 * resource loading.
+	 *
+	 * \return Number of concurrent reads.
+	 */
+	virtual int32_t getMaxConcurrentReads() const { return 1; }
+
+	/*! Read objects from multiple instances.
+	 *
+	 * Default implementation read each instance in turn;
+	 * providers which can batch reads, such as remote
+	 * databases, should override this method.
+	 *
+	 * \param instances Instances to read objects from.
+	 * \param outStreams Object streams, same order as instances; null if read failed.
+	 * \param outSerializerTypes Serializer types, same order as instances.
+	 * eturn True if successful.
+	 */
+	virtual bool readObjects(const RefArray< IProviderInstance >& instances, RefArray< IStream >& outStreams, AlignedVector< const TypeInfo* >& outSerializerTypes);
+
+	/*! Read data from multiple instances.
+	 *
+	 * \param instances Instances to read data from.
+	 * \param dataName Name of data.
+	 * \param outStreams Data streams, same order as instances; null if read failed.
+	 * eturn True if successful.
+	 */
+	virtual bool readData(const RefArray< IProviderInstance >& instances, const std::wstring& dataName, RefArray< IStream >& outStreams);
 };
 
 }
@@ -0,0 +1,166 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Thread/Acquire.h"
+#include "Database/Events/EvtGroupRenamed.h"
+#include "Database/Events/EvtInstanceCreated.h"
+#include "Database/Events/EvtInstanceGuidChanged.h"
+#include "Database/Remote/Client/GroupEpochs.h"
+
+namespace traktor::db
+{
+	namespace
+	{
+
+const uint32_t c_retired = ~0U;
+
+std::wstring parentPath(const std::wstring& groupPath)
+{
+	const size_t p = groupPath.find_last_of(L'/');
+	return p != groupPath.npos ? groupPath.substr(0, p) : L"";
+}
+
+bool isSubPath(const std::wstring& groupPath, const std::wstring& path)
+{
+	if (groupPath.empty())
+		return true;
+	if (path.size() < groupPath.size() || path.compare(0, groupPath.size(), groupPath) != 0)
+		return false;
+	return path.size() == groupPath.size() || path[groupPath.size()] == L'/';
+}
+
+	}
+
+uint32_t GroupEpochs::begin() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	return m_sequence;
+}
+
+uint32_t GroupEpochs::stamp(const std::wstring& groupPath, uint32_t sequence)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	if (m_barrier > sequence)
+		return 0;
+
+	// First time group is seen; any invalidation during the
+	// request would have inserted the group, thus metadata is valid.
+	auto it = m_groups.find(groupPath);
+	if (it == m_groups.end())
+	{
+		m_groups.insert(std::make_pair(groupPath, sequence));
+		return sequence;
+	}
+
+	if (it->second == c_retired || it->second > sequence)
+		return 0;
+
+	return it->second;
+}
+
+bool GroupEpochs::valid(const std::wstring& groupPath, uint32_t epoch) const
+{
+	if (epoch == 0)
+		return false;
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	auto it = m_groups.find(groupPath);
+	return it != m_groups.end() && it->second == epoch;
+}
+
+void GroupEpochs::setInstanceGroup(const Guid& instanceGuid, const std::wstring& groupPath)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	m_instanceGroups[instanceGuid] = groupPath;
+}
+
+void GroupEpochs::invalidateGroup(const std::wstring& groupPath)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	uint32_t& epoch = m_groups[groupPath];
+	if (epoch != c_retired)
+		epoch = ++m_sequence;
+}
+
+void GroupEpochs::invalidateInstance(const Guid& instanceGuid)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	auto it = m_instanceGroups.find(instanceGuid);
+	if (it != m_instanceGroups.end())
+	{
+		uint32_t& epoch = m_groups[it->second];
+		if (epoch != c_retired)
+			epoch = ++m_sequence;
+	}
+	else
+	{
+		// Unknown instance; cannot be cached but might be
+		// part of a request in flight.
+		m_barrier = ++m_sequence;
+	}
+}
+
+void GroupEpochs::retireGroup(const std::wstring& groupPath)
+{
+	invalidateTree(groupPath, true);
+	invalidateGroup(parentPath(groupPath));
+}
+
+void GroupEpochs::invalidateAll()
+{
+	invalidateTree(L"", false);
+}
+
+void GroupEpochs::invalidate(const IEvent* event)
+{
+	if (auto instanceCreated = dynamic_type_cast< const EvtInstanceCreated* >(event))
+		invalidateGroup(instanceCreated->getGroupPath());
+	else if (auto instanceGuidChanged = dynamic_type_cast< const EvtInstanceGuidChanged* >(event))
+	{
+		invalidateInstance(instanceGuidChanged->getInstancePreviousGuid());
+		invalidateInstance(instanceGuidChanged->getInstanceGuid());
+	}
+	else if (auto instance = dynamic_type_cast< const EvtInstance* >(event))
+		invalidateInstance(instance->getInstanceGuid());
+	else if (auto groupRenamed = dynamic_type_cast< const EvtGroupRenamed* >(event))
+	{
+		const std::wstring& previousPath = groupRenamed->getPreviousPath();
+		retireGroup(previousPath);
+		invalidateTree(childPath(parentPath(previousPath), groupRenamed->getName()), false);
+	}
+	else
+		invalidateAll();
+}
+
+std::wstring GroupEpochs::childPath(const std::wstring& groupPath, const std::wstring& childName)
+{
+	return !groupPath.empty() ? groupPath + L"/" + childName : childName;
+}
+
+void GroupEpochs::invalidateTree(const std::wstring& groupPath, bool retire)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	// Ensure group itself is tracked; retired groups are never
+	// revived since provider objects might still refer to old path.
+	const uint32_t epoch = retire ? c_retired : ++m_sequence;
+	m_groups.insert(std::make_pair(groupPath, 0));
+
+	for (auto& it : m_groups)
+	{
+		if (it.second != c_retired && isSubPath(groupPath, it.first))
+			it.second = epoch;
+	}
+
+	// Sub tree might be part of a request in flight.
+	m_barrier = ++m_sequence;
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <map>
+#include <string>
+#include "Core/Guid.h"
+#include "Core/Thread/Semaphore.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_DATABASE_REMOTE_CLIENT_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::db
+{
+
+class IEvent;
+
+/*! Metadata cache epochs of remote groups.
+ * \ingroup Database
+ *
+ * Each group, identified by path, has an epoch which
+ * is bumped when the group's children, or metadata of
+ * those children, might have changed. Cached metadata
+ * is stamped with the group's epoch and is only
+ * valid as long as the epoch remain the same.
+ */
+class T_DLLCLASS GroupEpochs
+{
+public:
+	/*! Get sequence number, called before a metadata request is sent. */
+	uint32_t begin() const;
+
+	/*! Get epoch to stamp metadata of group with.
+	 *
+	 * \param groupPath Path of group.
+	 * \param sequence Sequence number from before request was sent.
+	 * \return Epoch, 0 if group has been invalidated since request was sent.
+	 */
+	uint32_t stamp(const std::wstring& groupPath, uint32_t sequence);
+
+	/*! Check if metadata stamped with epoch is still valid. */
+	bool valid(const std::wstring& groupPath, uint32_t epoch) const;
+
+	/*! Associate instance with group so instance events can be mapped to group. */
+	void setInstanceGroup(const Guid& instanceGuid, const std::wstring& groupPath);
+
+	/*! Invalidate group, ie. group's children have changed. */
+	void invalidateGroup(const std::wstring& groupPath);
+
+	/*! Invalidate group which contain instance. */
+	void invalidateInstance(const Guid& instanceGuid);
+
+	/*! Retire group and entire sub tree, ie. group has been renamed or removed. */
+	void retireGroup(const std::wstring& groupPath);
+
+	/*! Invalidate all groups. */
+	void invalidateAll();
+
+	/*! Invalidate groups affected by database event. */
+	void invalidate(const IEvent* event);
+
+	/*! Get path of child group. */
+	static std::wstring childPath(const std::wstring& groupPath, const std::wstring& childName);
+
+private:
+	mutable Semaphore m_lock;
+	std::map< std::wstring, uint32_t > m_groups;
+	std::map< Guid, std::wstring > m_instanceGroups;
+	uint32_t m_sequence = 1;
+	uint32_t m_barrier = 0;	//!< Sequence of last invalidation which couldn't be mapped to a group.
+
+	void invalidateTree(const std::wstring& groupPath, bool retire);
+};
+
+}
@@ -46,6 +46,9 @@ bool RemoteBus::getEvent(uint64_t& inoutSqnr, Ref< const IEvent >& outEvent, boo
 	if (!result->getEvent())
 		return false;
 
+	// Invalidate cached metadata of groups affected by event.
+	m_connection->getGroupEpochs().invalidate(result->getEvent());
+
 	inoutSqnr = result->getSequenceNumber();
 	outEvent = result->getEvent();
 	outRemote = result->getRemote();
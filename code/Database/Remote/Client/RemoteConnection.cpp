@@ -14,6 +14,12 @@
 
 namespace traktor::db
 {
+	namespace
+	{
+
+const uint32_t c_maxPipelineDepth = 64;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.db.RemoteConnection", RemoteConnection, Object)
 
@@ -60,4 +66,37 @@ Ref< IMessage > RemoteConnection::sendMessage(const IMessage& message)
 	return reply;
 }
 
+bool RemoteConnection::sendMessages(const RefArray< IMessage >& messages, RefArray< IMessage >& outReplies)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_transportLock);
+
+	outReplies.resize(0);
+	outReplies.reserve(messages.size());
+
+	if (!m_transport || !m_transport->connected())
+		return false;
+
+	m_transport->flush< IMessage >();
+
+	// Keep a bounded number of messages in flight so neither
+	// side can stall on a full socket buffer.
+	uint32_t sent = 0;
+	while (outReplies.size() < messages.size())
+	{
+		while (sent < messages.size() && sent - outReplies.size() < c_maxPipelineDepth)
+		{
+			if (!m_transport->send(messages[sent++]))
+				return false;
+		}
+
+		Ref< IMessage > reply;
+		if (m_transport->recv(60000, reply) != net::BidirectionalObjectTransport::Result::Success)
+			return false;
+
+		outReplies.push_back(reply);
+	}
+
+	return true;
+}
+
 }
@@ -9,7 +9,9 @@
 #pragma once
 
 #include "Core/Object.h"
+#include "Core/RefArray.h"
 #include "Core/Thread/Semaphore.h"
+#include "Database/Remote/Client/GroupEpochs.h"
 #include "Database/Remote/Messages/MsgStatus.h"
 #include "Net/SocketAddressIPv4.h"
 
@@ -47,11 +49,31 @@ public:
 		return dynamic_type_cast< ReplyMessageType* >(reply);
 	}
 
+	/*! Send multiple messages and receive all replies.
+	 *
+	 * Messages are pipelined, i.e. sent without waiting
+	 * for each reply, thus a batch only cost a single
+	 * round trip. Replies are returned in the same order
+	 * as the messages.
+	 */
+	bool sendMessages(const RefArray< IMessage >& messages, RefArray< IMessage >& outReplies);
+
+	/*! Set protocol version of server, determined when database is opened. */
+	void setServerVersion(int32_t serverVersion) { m_serverVersion = serverVersion; }
+
+	/*! Get protocol version of server. */
+	int32_t getServerVersion() const { return m_serverVersion; }
+
+	/*! Get metadata cache epochs of groups. */
+	GroupEpochs& getGroupEpochs() { return m_groupEpochs; }
+
 private:
 	Ref< net::Socket > m_socket;
 	net::SocketAddressIPv4 m_streamServerAddr;
 	Ref< net::BidirectionalObjectTransport > m_transport;
 	Semaphore m_transportLock;
+	GroupEpochs m_groupEpochs;
+	int32_t m_serverVersion = 1;
 
 	Ref< IMessage > sendMessage(const IMessage& message);
 };
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include "Core/Log/Log.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Misc/String.h"
@@ -14,6 +15,8 @@
 #include "Database/Remote/Client/RemoteBus.h"
 #include "Database/Remote/Client/RemoteDatabase.h"
 #include "Database/Remote/Client/RemoteGroup.h"
+#include "Database/Remote/Client/RemoteInstance.h"
+#include "Database/Remote/Messages/CnmGetVersion.h"
 #include "Database/Remote/Messages/DbmOpen.h"
 #include "Database/Remote/Messages/DbmClose.h"
 #include "Database/Remote/Messages/DbmGetBus.h"
@@ -26,6 +29,33 @@
 
 namespace traktor::db
 {
+	namespace
+	{
+
+Ref< RemoteConnection > connect(const std::wstring& host, uint16_t port)
+{
+	Ref< net::TcpSocket > socket = new net::TcpSocket();
+	if (!socket->connect(net::SocketAddressIPv4(host, port)))
+		return nullptr;
+
+	return new RemoteConnection(socket);
+}
+
+/*! Get remote instances, false if any instance isn't a remote instance. */
+bool getRemoteInstances(const RefArray< IProviderInstance >& instances, RefArray< RemoteInstance >& outRemoteInstances)
+{
+	outRemoteInstances.reserve(instances.size());
+	for (auto instance : instances)
+	{
+		RemoteInstance* remoteInstance = dynamic_type_cast< RemoteInstance* >(instance);
+		if (!remoteInstance)
+			return false;
+		outRemoteInstances.push_back(remoteInstance);
+	}
+	return true;
+}
+
+	}
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.RemoteDatabase", 0, RemoteDatabase, IProviderDatabase)
 
@@ -56,14 +86,28 @@ bool RemoteDatabase::open(const ConnectionString& connectionString)
 		host = host.substr(0, p);
 	}
 
-	Ref< net::TcpSocket > socket = new net::TcpSocket();
-	if (!socket->connect(net::SocketAddressIPv4(host, port)))
+	if ((m_connection = connect(host, port)) == nullptr)
 	{
 		log::error << L"Failed to open database; unable to connect to server \"" << host << L"\" (port " << port << L")." << Endl;
 		return false;
 	}
 
-	m_connection = new RemoteConnection(socket);
+	// Query server protocol version; servers of first version
+	// terminate connection on unknown messages thus we need
+	// to reconnect if we don't get a reply.
+	Ref< MsgIntResult > version = m_connection->sendMessage< MsgIntResult >(CnmGetVersion());
+	if (!version)
+	{
+		safeDestroy(m_connection);
+		if ((m_connection = connect(host, port)) == nullptr)
+		{
+			log::error << L"Failed to open database; unable to reconnect to server \"" << host << L"\" (port " << port << L")." << Endl;
+			return false;
+		}
+		m_connection->setServerVersion(1);
+	}
+	else
+		m_connection->setServerVersion(std::min((int32_t)version->get(), c_protocolVersion));
 
 	Ref< MsgIntResult > result = m_connection->sendMessage< MsgIntResult >(DbmOpen(database));
 	if (!result)
@@ -121,10 +165,28 @@ IProviderGroup* RemoteDatabase::getRootGroup()
 	{
 		Ref< MsgHandleResult > result = m_connection->sendMessage< MsgHandleResult >(DbmGetRootGroup());
 		if (result)
-			m_rootGroup = new RemoteGroup(m_connection, result->get());
+			m_rootGroup = new RemoteGroup(m_connection, result->get(), L"");
 	}
 
 	return m_rootGroup;
 }
 
+bool RemoteDatabase::readObjects(const RefArray< IProviderInstance >& instances, RefArray< IStream >& outStreams, AlignedVector< const TypeInfo* >& outSerializerTypes)
+{
+	RefArray< RemoteInstance > remoteInstances;
+	if (getRemoteInstances(instances, remoteInstances))
+		return RemoteInstance::readObjects(remoteInstances, outStreams, outSerializerTypes);
+	else
+		return IProviderDatabase::readObjects(instances, outStreams, outSerializerTypes);
+}
+
+bool RemoteDatabase::readData(const RefArray< IProviderInstance >& instances, const std::wstring& dataName, RefArray< IStream >& outStreams)
+{
+	RefArray< RemoteInstance > remoteInstances;
+	if (getRemoteInstances(instances, remoteInstances))
+		return RemoteInstance::readData(remoteInstances, dataName, outStreams);
+	else
+		return IProviderDatabase::readData(instances, dataName, outStreams);
+}
+
 }
@@ -41,6 +41,10 @@ public:
 
 	virtual IProviderGroup* getRootGroup() override final;
 
+	virtual bool readObjects(const RefArray< IProviderInstance >& instances, RefArray< IStream >& outStreams, AlignedVector< const TypeInfo* >& outSerializerTypes) override final;
+
+	virtual bool readData(const RefArray< IProviderInstance >& instances, const std::wstring& dataName, RefArray< IStream >& outStreams) override final;
+
 private:
 	Ref< RemoteConnection > m_connection;
 	Ref< IProviderBus > m_bus;
@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Thread/Acquire.h"
 #include "Database/Types.h"
 #include "Database/Remote/Client/RemoteGroup.h"
 #include "Database/Remote/Client/RemoteInstance.h"
@@ -17,13 +19,22 @@
 #include "Database/Remote/Messages/DbmCreateGroup.h"
 #include "Database/Remote/Messages/DbmCreateInstance.h"
 #include "Database/Remote/Messages/DbmGetChildren.h"
+#include "Database/Remote/Messages/DbmGetSubTree.h"
 #include "Database/Remote/Messages/MsgGetChildrenResult.h"
 #include "Database/Remote/Messages/MsgStringResult.h"
 #include "Database/Remote/Messages/MsgHandleResult.h"
 #include "Database/Remote/Messages/MsgHandleArrayResult.h"
+#include "Database/Remote/Messages/MsgSubTreeResult.h"
 
 namespace traktor::db
 {
+	namespace
+	{
+
+/*! Number of levels prefetched, children of deeper groups are fetched on demand. */
+const int32_t c_prefetchDepth = 2;
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.db.RemoteGroup", RemoteGroup, IProviderGroup)
 
@@ -33,6 +44,14 @@ RemoteGroup::RemoteGroup(RemoteConnection* connection, uint32_t handle)
 {
 }
 
+RemoteGroup::RemoteGroup(RemoteConnection* connection, uint32_t handle, const std::wstring& path)
+:	m_connection(connection)
+,	m_handle(handle)
+,	m_path(path)
+,	m_tracked(true)
+{
+}
+
 RemoteGroup::~RemoteGroup()
 {
 	if (m_connection)
@@ -41,8 +60,21 @@ RemoteGroup::~RemoteGroup()
 
 std::wstring RemoteGroup::getName() const
 {
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	GroupEpochs& groupEpochs = m_connection->getGroupEpochs();
+	if (m_tracked && groupEpochs.valid(m_path, m_nameEpoch))
+		return m_name;
+
+	const uint32_t sequence = groupEpochs.begin();
+
 	Ref< const MsgStringResult > result = m_connection->sendMessage< MsgStringResult >(DbmGetGroupName(m_handle));
-	return result ? result->get() : L"";
+	if (!result)
+		return L"";
+
+	m_name = result->get();
+	m_nameEpoch = m_tracked ? groupEpochs.stamp(m_path, sequence) : 0;
+	return m_name;
 }
 
 uint32_t RemoteGroup::getFlags() const
@@ -53,29 +85,64 @@ uint32_t RemoteGroup::getFlags() const
 bool RemoteGroup::rename(const std::wstring& name)
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmRenameGroup(m_handle));
+	retire();
 	return result ? result->getStatus() == StSuccess : false;
 }
 
 bool RemoteGroup::remove()
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmRemoveGroup(m_handle));
+	retire();
 	return result ? result->getStatus() == StSuccess : false;
 }
 
 Ref< IProviderGroup > RemoteGroup::createGroup(const std::wstring& groupName)
 {
 	Ref< const MsgHandleResult > result = m_connection->sendMessage< MsgHandleResult >(DbmCreateGroup(m_handle, groupName));
-	return result ? new RemoteGroup(m_connection, result->get()) : nullptr;
+	invalidate();
+	if (!result)
+		return nullptr;
+
+	if (m_tracked)
+		return new RemoteGroup(m_connection, result->get(), GroupEpochs::childPath(m_path, groupName));
+	else
+		return new RemoteGroup(m_connection, result->get());
 }
 
 Ref< IProviderInstance > RemoteGroup::createInstance(const std::wstring& instanceName, const Guid& instanceGuid)
 {
 	Ref< const MsgHandleResult > result = m_connection->sendMessage< MsgHandleResult >(DbmCreateInstance(m_handle, instanceName, instanceGuid));
-	return result ? new RemoteInstance(m_connection, result->get()) : nullptr;
+	invalidate();
+	if (!result)
+		return nullptr;
+
+	if (m_tracked)
+		return new RemoteInstance(m_connection, result->get(), m_path);
+	else
+		return new RemoteInstance(m_connection, result->get());
 }
 
 bool RemoteGroup::getChildren(RefArray< IProviderGroup >& outChildGroups, RefArray< IProviderInstance >& outChildInstances)
 {
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	// Children are cached from a sub tree prefetch; if cache is stale
+	// then we prefetch our sub tree again. Only groups of known path
+	// can be cached since events identify groups by path.
+	if (
+		m_tracked &&
+		m_connection->getServerVersion() >= 2 &&
+		(m_connection->getGroupEpochs().valid(m_path, m_childrenEpoch) || prefetchSubTree())
+	)
+	{
+		for (auto childGroup : m_childGroups)
+			outChildGroups.push_back(childGroup);
+		for (auto childInstance : m_childInstances)
+			outChildInstances.push_back(childInstance);
+		return true;
+	}
+
+	// Untracked group or server predates sub tree prefetch; get children only.
 	Ref< MsgGetChildrenResult > result = m_connection->sendMessage< MsgGetChildrenResult >(DbmGetChildren(m_handle));
 	if (!result)
 		return false;
@@ -89,4 +156,82 @@ bool RemoteGroup::getChildren(RefArray< IProviderGroup >& outChildGroups, RefArr
 	return true;
 }
 
+bool RemoteGroup::prefetchSubTree()
+{
+	GroupEpochs& groupEpochs = m_connection->getGroupEpochs();
+	const uint32_t sequence = groupEpochs.begin();
+
+	Ref< const MsgSubTreeResult > result = m_connection->sendMessage< MsgSubTreeResult >(DbmGetSubTree(m_handle, c_prefetchDepth));
+	if (!result || result->getGroups().empty())
+		return false;
+
+	const auto& groups = result->getGroups();
+	const auto& instances = result->getInstances();
+
+	// Create provider objects for sub tree, cached metadata
+	// is stamped with epoch of each group unless group has been
+	// invalidated since request was sent. Children of groups at
+	// max depth are not included thus not stamped.
+	RefArray< RemoteGroup > remoteGroups(groups.size());
+	AlignedVector< uint32_t > epochs(groups.size());
+	for (size_t i = 0; i < groups.size(); ++i)
+	{
+		Ref< RemoteGroup > remoteGroup;
+		if (i > 0)
+		{
+			const RemoteGroup* parentGroup = remoteGroups[groups[i].parent];
+			remoteGroup = new RemoteGroup(m_connection, groups[i].handle, GroupEpochs::childPath(parentGroup->m_path, groups[i].name));
+		}
+		else
+			remoteGroup = this;
+
+		epochs[i] = groupEpochs.stamp(remoteGroup->m_path, sequence);
+
+		remoteGroup->m_name = groups[i].name;
+		remoteGroup->m_nameEpoch = epochs[i];
+		remoteGroup->m_childGroups.resize(0);
+		remoteGroup->m_childInstances.resize(0);
+		remoteGroup->m_childrenEpoch = groups[i].complete ? epochs[i] : 0;
+		remoteGroups[i] = remoteGroup;
+
+		if (groups[i].parent >= 0)
+			remoteGroups[groups[i].parent]->m_childGroups.push_back(remoteGroup);
+	}
+
+	for (const auto& instance : instances)
+	{
+		RemoteGroup* parentGroup = remoteGroups[instance.parent];
+		groupEpochs.setInstanceGroup(instance.guid, parentGroup->m_path);
+
+		Ref< RemoteInstance > remoteInstance = new RemoteInstance(
+			m_connection,
+			instance.handle,
+			parentGroup->m_path,
+			instance.name,
+			instance.guid,
+			instance.primaryType,
+			epochs[instance.parent]
+		);
+		parentGroup->m_childInstances.push_back(remoteInstance);
+	}
+
+	return true;
+}
+
+void RemoteGroup::invalidate()
+{
+	if (m_tracked)
+		m_connection->getGroupEpochs().invalidateGroup(m_path);
+	else
+		m_connection->getGroupEpochs().invalidateAll();
+}
+
+void RemoteGroup::retire()
+{
+	if (m_tracked)
+		m_connection->getGroupEpochs().retireGroup(m_path);
+	else
+		m_connection->getGroupEpochs().invalidateAll();
+}
+
 }
@@ -8,12 +8,15 @@
  */
 #pragma once
 
+#include "Core/RefArray.h"
+#include "Core/Thread/Semaphore.h"
 #include "Database/Provider/IProviderGroup.h"
 
 namespace traktor::db
 {
 
 class RemoteConnection;
+class RemoteInstance;
 
 /*! Remote group.
  * \ingroup Database
@@ -25,6 +28,9 @@ class RemoteGroup : public IProviderGroup
 public:
 	explicit RemoteGroup(RemoteConnection* connection, uint32_t handle);
 
+	/*! Create group of known path, path is required to cache metadata. */
+	explicit RemoteGroup(RemoteConnection* connection, uint32_t handle, const std::wstring& path);
+
 	virtual ~RemoteGroup();
 
 	virtual std::wstring getName() const override final;
@@ -44,6 +50,23 @@ public:
 private:
 	Ref< RemoteConnection > m_connection;
 	uint32_t m_handle;
+	std::wstring m_path;
+	bool m_tracked = false;	//!< If path of group is known.
+	mutable Semaphore m_lock;
+	mutable std::wstring m_name;
+	mutable uint32_t m_nameEpoch = 0;
+	RefArray< RemoteGroup > m_childGroups;
+	RefArray< RemoteInstance > m_childInstances;
+	uint32_t m_childrenEpoch = 0;
+
+	/*! Prefetch metadata of sub tree, limited in depth, in a single request. */
+	bool prefetchSubTree();
+
+	/*! Invalidate cached children of this group. */
+	void invalidate();
+
+	/*! Retire this group's sub tree after being renamed or removed. */
+	void retire();
 };
 
 }
@@ -45,6 +45,34 @@ RemoteInstance::RemoteInstance(RemoteConnection* connection, uint32_t handle)
 {
 }
 
+RemoteInstance::RemoteInstance(RemoteConnection* connection, uint32_t handle, const std::wstring& groupPath)
+:	m_connection(connection)
+,	m_handle(handle)
+,	m_groupPath(groupPath)
+,	m_groupTracked(true)
+{
+}
+
+RemoteInstance::RemoteInstance(
+	RemoteConnection* connection,
+	uint32_t handle,
+	const std::wstring& groupPath,
+	const std::wstring& name,
+	const Guid& guid,
+	const std::wstring& primaryTypeName,
+	uint32_t epoch
+)
+:	m_connection(connection)
+,	m_handle(handle)
+,	m_groupPath(groupPath)
+,	m_groupTracked(true)
+,	m_name(name)
+,	m_guid(guid)
+,	m_primaryTypeName(primaryTypeName)
+,	m_epoch(epoch)
+{
+}
+
 RemoteInstance::~RemoteInstance()
 {
 	if (m_connection)
@@ -53,6 +81,9 @@ RemoteInstance::~RemoteInstance()
 
 std::wstring RemoteInstance::getPrimaryTypeName() const
 {
+	if (m_groupTracked && m_connection->getGroupEpochs().valid(m_groupPath, m_epoch))
+		return m_primaryTypeName;
+
 	Ref< const MsgStringResult > result = m_connection->sendMessage< MsgStringResult >(DbmGetInstancePrimaryType(m_handle));
 	return result ? result->get() : L"";
 }
@@ -66,6 +97,7 @@ bool RemoteInstance::openTransaction()
 bool RemoteInstance::commitTransaction()
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmCommitTransaction(m_handle));
+	invalidate();
 	return result ? result->getStatus() == StSuccess : false;
 }
 
@@ -77,6 +109,9 @@ bool RemoteInstance::closeTransaction()
 
 std::wstring RemoteInstance::getName() const
 {
+	if (m_groupTracked && m_connection->getGroupEpochs().valid(m_groupPath, m_epoch))
+		return m_name;
+
 	Ref< const MsgStringResult > result = m_connection->sendMessage< MsgStringResult >(DbmGetInstanceName(m_handle));
 	return result ? result->get() : L"";
 }
@@ -84,11 +119,15 @@ std::wstring RemoteInstance::getName() const
 bool RemoteInstance::setName(const std::wstring& name)
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmSetInstanceName(m_handle, name));
+	invalidate();
 	return result ? result->getStatus() == StSuccess : false;
 }
 
 Guid RemoteInstance::getGuid() const
 {
+	if (m_groupTracked && m_connection->getGroupEpochs().valid(m_groupPath, m_epoch))
+		return m_guid;
+
 	Ref< const MsgGuidResult > result = m_connection->sendMessage< MsgGuidResult >(DbmGetInstanceGuid(m_handle));
 	return result ? result->get() : Guid();
 }
@@ -96,6 +135,7 @@ Guid RemoteInstance::getGuid() const
 bool RemoteInstance::setGuid(const Guid& guid)
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmSetInstanceGuid(m_handle, guid));
+	invalidate();
 	return result ? result->getStatus() == StSuccess : false;
 }
 
@@ -112,6 +152,7 @@ uint32_t RemoteInstance::getFlags() const
 bool RemoteInstance::remove()
 {
 	Ref< const MsgStatus > result = m_connection->sendMessage< MsgStatus >(DbmRemoveInstance(m_handle));
+	invalidate();
 	return result ? result->getStatus() == StSuccess : false;
 }
 
@@ -196,4 +237,93 @@ Ref< IStream > RemoteInstance::writeData(const std::wstring& dataName)
 	return BufferedStream::createIfNotAlready(s);
 }
 
+bool RemoteInstance::readObjects(const RefArray< RemoteInstance >& instances, RefArray< IStream >& outStreams, AlignedVector< const TypeInfo* >& outSerializerTypes)
+{
+	outStreams.resize(0);
+	outSerializerTypes.resize(0);
+
+	if (instances.empty())
+		return true;
+
+	RemoteConnection* connection = instances.front()->m_connection;
+
+	RefArray< IMessage > messages;
+	messages.reserve(instances.size());
+	for (auto instance : instances)
+	{
+		T_ASSERT(instance->m_connection == connection);
+		messages.push_back(new DbmReadObject(instance->m_handle));
+	}
+
+	RefArray< IMessage > replies;
+	if (!connection->sendMessages(messages, replies))
+		return false;
+
+	for (auto reply : replies)
+	{
+		Ref< IStream > s;
+
+		const DbmReadObjectResult* result = dynamic_type_cast< const DbmReadObjectResult* >(reply);
+		const TypeInfo* serializerType = result ? TypeInfo::find(result->getSerializerTypeName().c_str()) : nullptr;
+		if (serializerType)
+		{
+			s = net::RemoteStream::connect(connection->getStreamServerAddr(), result->getStreamId());
+			if (s)
+				s = BufferedStream::createIfNotAlready(s);
+		}
+
+		outStreams.push_back(s);
+		outSerializerTypes.push_back(s ? serializerType : nullptr);
+	}
+
+	return true;
+}
+
+bool RemoteInstance::readData(const RefArray< RemoteInstance >& instances, const std::wstring& dataName, RefArray< IStream >& outStreams)
+{
+	outStreams.resize(0);
+
+	if (instances.empty())
+		return true;
+
+	RemoteConnection* connection = instances.front()->m_connection;
+
+	RefArray< IMessage > messages;
+	messages.reserve(instances.size());
+	for (auto instance : instances)
+	{
+		T_ASSERT(instance->m_connection == connection);
+		messages.push_back(new DbmReadData(instance->m_handle, dataName));
+	}
+
+	RefArray< IMessage > replies;
+	if (!connection->sendMessages(messages, replies))
+		return false;
+
+	for (auto reply : replies)
+	{
+		Ref< IStream > s;
+
+		const MsgHandleResult* result = dynamic_type_cast< const MsgHandleResult* >(reply);
+		if (result)
+		{
+			s = net::RemoteStream::connect(connection->getStreamServerAddr(), result->get());
+			if (s)
+				s = BufferedStream::createIfNotAlready(s);
+		}
+
+		outStreams.push_back(s);
+	}
+
+	return true;
+}
+
+void RemoteInstance::invalidate() const
+{
+	if (m_groupTracked)
+		m_connection->getGroupEpochs().invalidateGroup(m_groupPath);
+	else
+		m_connection->getGroupEpochs().invalidateAll();
+}
+
 }
@@ -8,6 +8,8 @@
  */
 #pragma once
 
+#include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Database/Provider/IProviderInstance.h"
 #include "Net/SocketAddressIPv4.h"
 
@@ -26,6 +28,24 @@ class RemoteInstance : public IProviderInstance
 public:
 	explicit RemoteInstance(RemoteConnection* connection, uint32_t handle);
 
+	/*! Create instance in group of known path. */
+	explicit RemoteInstance(RemoteConnection* connection, uint32_t handle, const std::wstring& groupPath);
+
+	/*! Create instance with prefetched metadata.
+	 *
+	 * Metadata is valid as long as epoch of
+	 * instance's group match given epoch.
+	 */
+	explicit RemoteInstance(
+		RemoteConnection* connection,
+		uint32_t handle,
+		const std::wstring& groupPath,
+		const std::wstring& name,
+		const Guid& guid,
+		const std::wstring& primaryTypeName,
+		uint32_t epoch
+	);
+
 	virtual ~RemoteInstance();
 
 	virtual std::wstring getPrimaryTypeName() const override final;
@@ -64,9 +84,34 @@ public:
 
 	virtual Ref< IStream > writeData(const std::wstring& dataName) override final;
 
+	/*! Read objects from multiple instances.
+	 *
+	 * All requests are pipelined thus only a single round trip
+	 * is required; instances must share the same connection.
+	 * Failed reads are returned as null streams.
+	 */
+	static bool readObjects(const RefArray< RemoteInstance >& instances, RefArray< IStream >& outStreams, AlignedVector< const TypeInfo* >& outSerializerTypes);
+
+	/*! Read data from multiple instances.
+	 *
+	 * All requests are pipelined thus only a single round trip
+	 * is required; instances must share the same connection.
+	 * Failed reads are returned as null streams.
+	 */
+	static bool readData(const RefArray< RemoteInstance >& instances, const std::wstring& dataName, RefArray< IStream >& outStreams);
+
 private:
 	Ref< RemoteConnection > m_connection;
 	uint32_t m_handle;
+	std::wstring m_groupPath;
+	bool m_groupTracked = false;	//!< If path of group is known.
+	std::wstring m_name;
+	Guid m_guid;
+	std::wstring m_primaryTypeName;
+	uint32_t m_epoch = 0;	//!< Epoch of prefetched metadata, 0 if not prefetched.
+
+	/*! Invalidate cached metadata of group containing this instance. */
+	void invalidate() const;
 };
 
 }
@@ -0,0 +1,89 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Guid.h"
+#include "Database/Events/EvtGroupRenamed.h"
+#include "Database/Events/EvtInstanceCommitted.h"
+#include "Database/Events/EvtInstanceCreated.h"
+#include "Database/Remote/Client/GroupEpochs.h"
+#include "Database/Remote/Client/Test/CaseGroupEpochs.h"
+
+namespace traktor::db::test
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.test.CaseGroupEpochs", 0, CaseGroupEpochs, traktor::test::Case)
+
+void CaseGroupEpochs::run()
+{
+	const Guid instanceGuid = Guid::create();
+
+	// Stamp sub tree as if fetched in a single request.
+	{
+		GroupEpochs groupEpochs;
+		const uint32_t sequence = groupEpochs.begin();
+		const uint32_t rootEpoch = groupEpochs.stamp(L"", sequence);
+		const uint32_t aEpoch = groupEpochs.stamp(L"A", sequence);
+		const uint32_t bEpoch = groupEpochs.stamp(L"A/B", sequence);
+		const uint32_t cEpoch = groupEpochs.stamp(L"C", sequence);
+		groupEpochs.setInstanceGroup(instanceGuid, L"A/B");
+
+		CASE_ASSERT(groupEpochs.valid(L"", rootEpoch));
+		CASE_ASSERT(groupEpochs.valid(L"A", aEpoch));
+		CASE_ASSERT(groupEpochs.valid(L"A/B", bEpoch));
+		CASE_ASSERT(groupEpochs.valid(L"C", cEpoch));
+		CASE_ASSERT(!groupEpochs.valid(L"D", 0));
+
+		// Change in instance only invalidates instance's group.
+		const EvtInstanceCommitted committed(instanceGuid);
+		groupEpochs.invalidate(&committed);
+		CASE_ASSERT(groupEpochs.valid(L"", rootEpoch));
+		CASE_ASSERT(groupEpochs.valid(L"A", aEpoch));
+		CASE_ASSERT(!groupEpochs.valid(L"A/B", bEpoch));
+		CASE_ASSERT(groupEpochs.valid(L"C", cEpoch));
+
+		// New instance only invalidates group it's created in.
+		const EvtInstanceCreated created(L"C", Guid::create());
+		groupEpochs.invalidate(&created);
+		CASE_ASSERT(groupEpochs.valid(L"", rootEpoch));
+		CASE_ASSERT(groupEpochs.valid(L"A", aEpoch));
+		CASE_ASSERT(!groupEpochs.valid(L"C", cEpoch));
+
+		// Renamed group retires sub tree and invalidates parent.
+		const EvtGroupRenamed renamed(L"E", L"A");
+		groupEpochs.invalidate(&renamed);
+		CASE_ASSERT(!groupEpochs.valid(L"", rootEpoch));
+		CASE_ASSERT(!groupEpochs.valid(L"A", aEpoch));
+
+		const uint32_t sequence2 = groupEpochs.begin();
+		CASE_ASSERT(groupEpochs.stamp(L"A", sequence2) == 0);
+		CASE_ASSERT(groupEpochs.stamp(L"A/B", sequence2) == 0);
+		CASE_ASSERT(groupEpochs.stamp(L"E", sequence2) != 0);
+		CASE_ASSERT(groupEpochs.stamp(L"E/B", sequence2) != 0);
+	}
+
+	// Invalidation while request is in flight.
+	{
+		GroupEpochs groupEpochs;
+		const uint32_t rootEpoch = groupEpochs.stamp(L"", groupEpochs.begin());
+
+		const uint32_t sequence = groupEpochs.begin();
+		const EvtInstanceCreated created(L"A", Guid::create());
+		groupEpochs.invalidate(&created);
+		CASE_ASSERT(groupEpochs.stamp(L"A", sequence) == 0);
+		CASE_ASSERT(groupEpochs.stamp(L"", sequence) == rootEpoch);
+
+		// Unknown instance might belong to any group in flight.
+		const EvtInstanceCommitted committed(Guid::create());
+		groupEpochs.invalidate(&committed);
+		CASE_ASSERT(groupEpochs.valid(L"", rootEpoch));
+		CASE_ASSERT(groupEpochs.stamp(L"", sequence) == 0);
+		CASE_ASSERT(groupEpochs.stamp(L"", groupEpochs.begin()) == rootEpoch);
+	}
+}
+
+}
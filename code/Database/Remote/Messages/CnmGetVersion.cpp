@@ -0,0 +1,20 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Database/Remote/Messages/CnmGetVersion.h"
+
+namespace traktor::db
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.CnmGetVersion", 0, CnmGetVersion, IMessage)
+
+void CnmGetVersion::serialize(ISerializer& s)
+{
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Database/Remote/IMessage.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_DATABASE_REMOTE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::db
+{
+
+/*! Remote database protocol version.
+ *
+ * 1 - Initial protocol.
+ * 2 - Added CnmGetVersion and DbmGetSubTree.
+ */
+const int32_t c_protocolVersion = 2;
+
+/*! Get server protocol version.
+ * \ingroup Database
+ *
+ * Server reply with MsgIntResult containing protocol version.
+ * Servers of version 1 doesn't recognize this message and
+ * will terminate the connection.
+ */
+class T_DLLCLASS CnmGetVersion : public IMessage
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void serialize(ISerializer& s) override final;
+};
+
+}
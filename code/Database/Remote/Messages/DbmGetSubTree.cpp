@@ -0,0 +1,30 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/Member.h"
+#include "Database/Remote/Messages/DbmGetSubTree.h"
+
+namespace traktor::db
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.DbmGetSubTree", 0, DbmGetSubTree, IMessage)
+
+DbmGetSubTree::DbmGetSubTree(uint32_t handle, int32_t maxDepth)
+:	m_handle(handle)
+,	m_maxDepth(maxDepth)
+{
+}
+
+void DbmGetSubTree::serialize(ISerializer& s)
+{
+	s >> Member< uint32_t >(L"handle", m_handle);
+	s >> Member< int32_t >(L"maxDepth", m_maxDepth);
+}
+
+}
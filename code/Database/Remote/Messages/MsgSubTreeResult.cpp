@@ -0,0 +1,53 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Serialization/ISerializer.h"
+#include "Core/Serialization/Member.h"
+#include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/MemberComposite.h"
+#include "Database/Remote/Messages/MsgSubTreeResult.h"
+
+namespace traktor::db
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.MsgSubTreeResult", 0, MsgSubTreeResult, IMessage)
+
+void MsgSubTreeResult::addGroup(const Group& group)
+{
+	m_groups.push_back(group);
+}
+
+void MsgSubTreeResult::addInstance(const Instance& instance)
+{
+	m_instances.push_back(instance);
+}
+
+void MsgSubTreeResult::serialize(ISerializer& s)
+{
+	s >> MemberAlignedVector< Group, MemberComposite< Group > >(L"groups", m_groups);
+	s >> MemberAlignedVector< Instance, MemberComposite< Instance > >(L"instances", m_instances);
+}
+
+void MsgSubTreeResult::Group::serialize(ISerializer& s)
+{
+	s >> Member< uint32_t >(L"handle", handle);
+	s >> Member< int32_t >(L"parent", parent);
+	s >> Member< std::wstring >(L"name", name);
+	s >> Member< bool >(L"complete", complete);
+}
+
+void MsgSubTreeResult::Instance::serialize(ISerializer& s)
+{
+	s >> Member< uint32_t >(L"handle", handle);
+	s >> Member< int32_t >(L"parent", parent);
+	s >> Member< std::wstring >(L"name", name);
+	s >> Member< Guid >(L"guid", guid);
+	s >> Member< std::wstring >(L"primaryType", primaryType);
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+#include "Core/Guid.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Database/Remote/IMessage.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_DATABASE_REMOTE_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::db
+{
+
+/*! Group sub tree result.
+ * \ingroup Database
+ *
+ * Groups are stored in pre-order thus a parent group
+ * always precede it's children; first group is the
+ * root of the sub tree.
+ */
+class T_DLLCLASS MsgSubTreeResult : public IMessage
+{
+	T_RTTI_CLASS;
+
+public:
+	struct Group
+	{
+		uint32_t handle = 0;
+		int32_t parent = -1;	//!< Index of parent group, -1 for root of sub tree.
+		std::wstring name;
+		bool complete = true;	//!< If group's children are included, false for groups at max depth.
+
+		void serialize(ISerializer& s);
+	};
+
+	struct Instance
+	{
+		uint32_t handle = 0;
+		int32_t parent = -1;	//!< Index of parent group.
+		std::wstring name;
+		Guid guid;
+		std::wstring primaryType;
+
+		void serialize(ISerializer& s);
+	};
+
+	void addGroup(const Group& group);
+
+	void addInstance(const Instance& instance);
+
+	const AlignedVector< Group >& getGroups() const { return m_groups; }
+
+	const AlignedVector< Instance >& getInstances() const { return m_instances; }
+
+	virtual void serialize(ISerializer& s) override final;
+
+private:
+	AlignedVector< Group > m_groups;
+	AlignedVector< Instance > m_instances;
+};
+
+}
@@ -34,7 +34,6 @@ Connection::Connection(
 )
 :	m_streamServer(streamServer)
 ,	m_clientSocket(clientSocket)
-,	m_nextHandle(1)
 {
 	m_transport = new net::BidirectionalObjectTransport(clientSocket);
 
@@ -100,20 +99,22 @@ void Connection::sendReply(const IMessage& message)
 
 uint32_t Connection::putObject(Object* object)
 {
-	uint32_t handle = m_nextHandle++;
-	m_objectStore[handle] = object;
-	return handle;
+	return m_objectStore.put(object);
+}
+
+uint32_t Connection::putObject(Object* object, const std::wstring& key)
+{
+	return m_objectStore.put(object, key);
 }
 
 Object* Connection::getObject(uint32_t handle)
 {
-	auto it = m_objectStore.find(handle);
-	return it != m_objectStore.end() ? it->second : nullptr;
+	return m_objectStore.get(handle);
 }
 
 void Connection::releaseObject(uint32_t handle)
 {
-	m_objectStore.remove(handle);
+	m_objectStore.release(handle);
 }
 
 void Connection::setDatabase(IProviderDatabase* database)
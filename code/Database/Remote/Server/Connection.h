@@ -12,6 +12,7 @@
 #include "Core/Object.h"
 #include "Core/RefArray.h"
 #include "Core/Containers/SmallMap.h"
+#include "Database/Remote/Server/ObjectStore.h"
 
 namespace traktor
 {
@@ -57,6 +58,9 @@ public:
 
 	uint32_t putObject(Object* object);
 
+	/*! Put object identified by key, handle is reused if key is already stored. */
+	uint32_t putObject(Object* object, const std::wstring& key);
+
 	Object* getObject(uint32_t handle);
 
 	void releaseObject(uint32_t handle);
@@ -80,8 +84,7 @@ private:
 	Ref< net::TcpSocket > m_clientSocket;
 	Ref< net::BidirectionalObjectTransport > m_transport;
 	RefArray< IMessageListener > m_messageListeners;
-	SmallMap< uint32_t, Ref< Object > > m_objectStore;
-	uint32_t m_nextHandle;
+	ObjectStore m_objectStore;
 	Ref< IProviderDatabase > m_database;
 
 	void messageThread();
@@ -8,7 +8,9 @@
  */
 #include "Database/Remote/Server/ConnectionMessageListener.h"
 #include "Database/Remote/Server/Connection.h"
+#include "Database/Remote/Messages/CnmGetVersion.h"
 #include "Database/Remote/Messages/CnmReleaseObject.h"
+#include "Database/Remote/Messages/MsgIntResult.h"
 #include "Database/Remote/Messages/MsgStatus.h"
 
 namespace traktor
@@ -21,9 +23,16 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.db.ConnectionMessageListener", ConnectionMessag
 ConnectionMessageListener::ConnectionMessageListener(Connection* connection)
 :	m_connection(connection)
 {
+	registerMessage< CnmGetVersion >(&ConnectionMessageListener::messageGetVersion);
 	registerMessage< CnmReleaseObject >(&ConnectionMessageListener::messageReleaseObject);
 }
 
+bool ConnectionMessageListener::messageGetVersion(const CnmGetVersion* message)
+{
+	m_connection->sendReply(MsgIntResult(c_protocolVersion));
+	return true;
+}
+
 bool ConnectionMessageListener::messageReleaseObject(const CnmReleaseObject* message)
 {
 	m_connection->releaseObject(message->getHandle());
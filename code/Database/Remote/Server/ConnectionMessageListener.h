@@ -30,6 +30,8 @@ public:
 private:
 	Connection* m_connection;
 
+	bool messageGetVersion(const class CnmGetVersion* message);
+
 	bool messageReleaseObject(const class CnmReleaseObject* message);
 };
 
@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include "Core/Misc/String.h"
 #include "Database/Provider/IProviderGroup.h"
 #include "Database/Provider/IProviderInstance.h"
 #include "Database/Remote/Server/Connection.h"
@@ -16,16 +18,62 @@
 #include "Database/Remote/Messages/DbmCreateGroup.h"
 #include "Database/Remote/Messages/DbmCreateInstance.h"
 #include "Database/Remote/Messages/DbmGetChildren.h"
+#include "Database/Remote/Messages/DbmGetSubTree.h"
 #include "Database/Remote/Messages/MsgGetChildrenResult.h"
 #include "Database/Remote/Messages/MsgStatus.h"
 #include "Database/Remote/Messages/MsgStringResult.h"
 #include "Database/Remote/Messages/MsgHandleResult.h"
 #include "Database/Remote/Messages/MsgHandleArrayResult.h"
+#include "Database/Remote/Messages/MsgSubTreeResult.h"
 
 namespace traktor
 {
 	namespace db
 	{
+		namespace
+		{
+
+bool buildSubTree(Connection* connection, IProviderGroup* group, uint32_t groupHandle, int32_t groupIndex, int32_t depth, MsgSubTreeResult& outResult)
+{
+	RefArray< IProviderGroup > childGroups;
+	RefArray< IProviderInstance > childInstances;
+
+	if (!group->getChildren(childGroups, childInstances))
+		return false;
+
+	for (auto childInstance : childInstances)
+	{
+		MsgSubTreeResult::Instance instance;
+		instance.parent = groupIndex;
+		instance.name = childInstance->getName();
+		instance.guid = childInstance->getGuid();
+		instance.primaryType = childInstance->getPrimaryTypeName();
+
+		// Instances are identified by guid so repeated fetches reuse same handle.
+		instance.handle = connection->putObject(childInstance, L"I" + instance.guid.format());
+		outResult.addInstance(instance);
+	}
+
+	for (auto childGroup : childGroups)
+	{
+		MsgSubTreeResult::Group subGroup;
+		subGroup.parent = groupIndex;
+		subGroup.name = childGroup->getName();
+		subGroup.complete = (depth > 1);
+
+		// Groups are identified by parent handle and name.
+		subGroup.handle = connection->putObject(childGroup, L"G" + toString(groupHandle) + L"/" + subGroup.name);
+		outResult.addGroup(subGroup);
+
+		// Children of groups at max depth are fetched on demand by client.
+		if (subGroup.complete && !buildSubTree(connection, childGroup, subGroup.handle, (int32_t)outResult.getGroups().size() - 1, depth - 1, outResult))
+			return false;
+	}
+
+	return true;
+}
+
+		}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.db.GroupMessageListener", GroupMessageListener, IMessageListener)
 
@@ -38,6 +86,7 @@ GroupMessageListener::GroupMessageListener(Connection* connection)
 	registerMessage< DbmCreateGroup >(&GroupMessageListener::messageCreateGroup);
 	registerMessage< DbmCreateInstance >(&GroupMessageListener::messageCreateInstance);
 	registerMessage< DbmGetChildren >(&GroupMessageListener::messageGetChildren);
+	registerMessage< DbmGetSubTree >(&GroupMessageListener::messageGetSubTree);
 }
 
 bool GroupMessageListener::messageGetGroupName(const DbmGetGroupName* message)
@@ -157,5 +206,32 @@ bool GroupMessageListener::messageGetChildren(const DbmGetChildren* message)
 	return true;
 }
 
+bool GroupMessageListener::messageGetSubTree(const DbmGetSubTree* message)
+{
+	const uint32_t groupHandle = message->getHandle();
+	Ref< IProviderGroup > group = m_connection->getObject< IProviderGroup >(groupHandle);
+	if (!group)
+	{
+		m_connection->sendReply(MsgStatus(StFailure));
+		return true;
+	}
+
+	// Root of sub tree is the requested group itself; thus no new handle.
+	MsgSubTreeResult result;
+	MsgSubTreeResult::Group root;
+	root.handle = groupHandle;
+	root.name = group->getName();
+	result.addGroup(root);
+
+	if (!buildSubTree(m_connection, group, groupHandle, 0, std::max(message->getMaxDepth(), 1), result))
+	{
+		m_connection->sendReply(MsgStatus(StFailure));
+		return true;
+	}
+
+	m_connection->sendReply(result);
+	return true;
+}
+
 	}
 }
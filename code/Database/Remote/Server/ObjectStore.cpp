@@ -0,0 +1,69 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Database/Remote/Server/ObjectStore.h"
+
+namespace traktor::db
+{
+
+uint32_t ObjectStore::put(Object* object)
+{
+	const uint32_t handle = m_nextHandle++;
+	Entry& entry = m_objects[handle];
+	entry.object = object;
+	entry.references = 1;
+	return handle;
+}
+
+uint32_t ObjectStore::put(Object* object, const std::wstring& key)
+{
+	auto it = m_keys.find(key);
+	if (it != m_keys.end())
+	{
+		// Replace object since the item might have been
+		// moved or renamed since it was put.
+		Entry& entry = m_objects[it->second];
+		entry.object = object;
+		entry.references++;
+		return it->second;
+	}
+
+	const uint32_t handle = put(object);
+	m_objects[handle].key = key;
+	m_keys.insert(std::make_pair(key, handle));
+	return handle;
+}
+
+Object* ObjectStore::get(uint32_t handle) const
+{
+	auto it = m_objects.find(handle);
+	return it != m_objects.end() ? it->second.object.ptr() : nullptr;
+}
+
+void ObjectStore::release(uint32_t handle)
+{
+	auto it = m_objects.find(handle);
+	if (it == m_objects.end())
+		return;
+
+	if (--it->second.references > 0)
+		return;
+
+	if (!it->second.key.empty())
+		m_keys.erase(it->second.key);
+
+	m_objects.erase(it);
+}
+
+void ObjectStore::clear()
+{
+	m_objects.clear();
+	m_keys.clear();
+}
+
+}
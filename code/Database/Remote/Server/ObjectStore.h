@@ -0,0 +1,70 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <map>
+#include <string>
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/SmallMap.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_DATABASE_REMOTE_SERVER_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::db
+{
+
+/*! Handle store of objects referenced by a client.
+ * \ingroup Database
+ *
+ * Objects can be associated with a key identifying
+ * the database item, putting an object with a key already
+ * in the store reuses the same handle and replaces the
+ * stored object. Each put must be matched by a release.
+ */
+class T_DLLCLASS ObjectStore
+{
+public:
+	/*! Put object into store, always allocates a new handle. */
+	uint32_t put(Object* object);
+
+	/*! Put object into store, reuse handle of same key if any. */
+	uint32_t put(Object* object, const std::wstring& key);
+
+	/*! Get object from handle. */
+	Object* get(uint32_t handle) const;
+
+	/*! Release reference to handle. */
+	void release(uint32_t handle);
+
+	/*! Release all handles. */
+	void clear();
+
+	/*! Number of live handles. */
+	uint32_t size() const { return (uint32_t)m_objects.size(); }
+
+private:
+	struct Entry
+	{
+		Ref< Object > object;
+		std::wstring key;
+		int32_t references = 0;
+	};
+
+	SmallMap< uint32_t, Entry > m_objects;
+	std::map< std::wstring, uint32_t > m_keys;
+	uint32_t m_nextHandle = 1;
+};
+
+}
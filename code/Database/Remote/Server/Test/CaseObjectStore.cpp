@@ -0,0 +1,70 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Database/Remote/Server/ObjectStore.h"
+#include "Database/Remote/Server/Test/CaseObjectStore.h"
+
+namespace traktor::db::test
+{
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.db.test.CaseObjectStore", 0, CaseObjectStore, traktor::test::Case)
+
+void CaseObjectStore::run()
+{
+	ObjectStore objectStore;
+
+	Ref< Object > object1 = new Object();
+	Ref< Object > object2 = new Object();
+	Ref< Object > object3 = new Object();
+
+	// Objects without key always get new handles.
+	const uint32_t handle1 = objectStore.put(object1);
+	const uint32_t handle2 = objectStore.put(object1);
+	CASE_ASSERT(handle1 != handle2);
+
+	// Same key reuse handle and replace object.
+	const uint32_t handle3 = objectStore.put(object1, L"A");
+	const uint32_t handle4 = objectStore.put(object2, L"A");
+	const uint32_t handle5 = objectStore.put(object3, L"B");
+	CASE_ASSERT(handle3 == handle4);
+	CASE_ASSERT(handle3 != handle5);
+	CASE_ASSERT(objectStore.get(handle3) == object2);
+	CASE_ASSERT(objectStore.get(handle5) == object3);
+	CASE_ASSERT_EQUAL(objectStore.size(), 4);
+
+	// Repeated fetches of same items doesn't grow store.
+	for (int32_t i = 0; i < 100; ++i)
+	{
+		CASE_ASSERT(objectStore.put(object2, L"A") == handle3);
+		CASE_ASSERT(objectStore.put(object3, L"B") == handle5);
+	}
+	CASE_ASSERT_EQUAL(objectStore.size(), 4);
+
+	// Handle remain until every put has been released.
+	for (int32_t i = 0; i < 100; ++i)
+		objectStore.release(handle5);
+	CASE_ASSERT(objectStore.get(handle5) == object3);
+	objectStore.release(handle5);
+	CASE_ASSERT(objectStore.get(handle5) == nullptr);
+
+	// Released key get a new handle.
+	const uint32_t handle6 = objectStore.put(object3, L"B");
+	CASE_ASSERT(handle6 != handle5);
+	CASE_ASSERT(objectStore.get(handle6) == object3);
+
+	objectStore.release(handle1);
+	objectStore.release(handle2);
+	CASE_ASSERT(objectStore.get(handle1) == nullptr);
+	CASE_ASSERT(objectStore.get(handle2) == nullptr);
+	CASE_ASSERT_EQUAL(objectStore.size(), 2);
+
+	objectStore.clear();
+	CASE_ASSERT(objectStore.get(handle3) == nullptr);
+}
+
+}
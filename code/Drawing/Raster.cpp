@@ -6,6 +6,9 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <atomic>
+#include <cmath>
+#include <limits>
 #include <agg_alpha_mask_u8.h>
 #include <agg_conv_curve.h>
 #include <agg_conv_stroke.h>
@@ -23,9 +26,13 @@
 #include <agg_scanline_u.h>
 #include <agg_span_allocator.h>
 #include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/StaticVector.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Envelope.h"
+#include "Core/Math/MathUtils.h"
 #include "Core/Misc/Align.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobManager.h"
 #include "Drawing/Image.h"
 #include "Drawing/Raster.h"
 
@@ -47,6 +54,8 @@ Color4f operator * (const Color4f& c, float v)
 namespace traktor::drawing
 {
 
+const int32_t c_autoTiledHeight = 256;	//!< Minimum image height where tiled backend is used automatically.
+
 int32_t cycle(float f)
 {
 	int32_t n = int32_t(f);
@@ -59,6 +68,10 @@ class IRasterImpl : public IRefCount
 public:
 	virtual void setMask(Image* image) = 0;
 
+	virtual void setClipBox(int32_t x1, int32_t y1, int32_t x2, int32_t y2) = 0;
+
+	virtual void resetClipBox() = 0;
+
 	virtual void clearStyles() = 0;
 
 	virtual int32_t defineSolidStyle(const Color4f& color) = 0;
@@ -434,48 +447,85 @@ private:
 	AlignedVector< IStyle< agg::rgba8 >* > m_styles;
 };
 
-/*! Rasterizer implementation. */
-template < typename pixfmt_type, typename color_type >
-class RasterImpl : public RefCountImpl< IRasterImpl >
+/*! Vertex source reading path storage by index.
+ *
+ * Path storage keep iteration state internally thus
+ * cannot be read concurrently; this adapter keep its
+ * own iteration state.
+ */
+class PathVertexSource
 {
 public:
-	explicit RasterImpl(Image* image)
-	:	m_rbuffer((agg::int8u*)image->getData(), image->getWidth(), image->getHeight(), image->getWidth() * image->getPixelFormat().getByteSize())
-	,	m_pf(m_rbuffer)
-	,	m_renderer(m_pf)
+	explicit PathVertexSource(const agg::path_storage& path)
+	:	m_path(path)
 	{
 	}
 
-	virtual void setMask(Image* image) override final
+	void rewind(unsigned pathId)
 	{
-		m_mask = image;
+		m_index = pathId;
 	}
 
-	virtual void clearStyles() override final
+	unsigned vertex(double* x, double* y)
 	{
-		m_styleHandler.clearStyles();
+		if (m_index < m_path.total_vertices())
+			return m_path.vertex(m_index++, x, y);
+		else
+			return agg::path_cmd_stop;
 	}
 
-	virtual int32_t defineSolidStyle(const Color4f& color) override final
-	{
-		return m_styleHandler.defineSolidStyle(color);
-	}
+private:
+	const agg::path_storage& m_path;
+	unsigned m_index = 0;
+};
 
-	virtual int32_t defineLinearGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors) override final
-	{
-		return m_styleHandler.defineLinearGradientStyle(gradientMatrix, colors);
-	}
+/*! Setup stroke converter. */
+template < typename stroke_type >
+void setupStroke(stroke_type& outline, float width, Raster::StrokeJoin join, Raster::StrokeCap cap)
+{
+	outline.width(width);
 
-	virtual int32_t defineRadialGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors) override final
+	switch (join)
 	{
-		return m_styleHandler.defineRadialGradientStyle(gradientMatrix, colors);
+	case Raster::StrokeJoin::Miter:
+		outline.line_join(agg::miter_join);
+		break;
+
+	case Raster::StrokeJoin::Round:
+		outline.line_join(agg::round_join);
+		break;
+
+	case Raster::StrokeJoin::Bevel:
+		outline.line_join(agg::bevel_join);
+		break;
+
+	default:
+		break;
 	}
 
-	virtual int32_t defineImageStyle(const Matrix33& imageMatrix, const Image* image, bool repeat) override final
+	switch (cap)
 	{
-		return m_styleHandler.defineImageStyle(imageMatrix, image, repeat);
+	case Raster::StrokeCap::Butt:
+		outline.line_cap(agg::butt_cap);
+		break;
+
+	case Raster::StrokeCap::Square:
+		outline.line_cap(agg::square_cap);
+		break;
+
+	case Raster::StrokeCap::Round:
+		outline.line_cap(agg::round_cap);
+		break;
+
+	default:
+		break;
 	}
+}
 
+/*! Path building shared by rasterizer implementations. */
+class PathRasterImpl : public RefCountImpl< IRasterImpl >
+{
+public:
 	virtual void clear() override final
 	{
 		m_paths.resize(0);
@@ -531,6 +581,77 @@ public:
 		current().concat_path(e);
 	}
 
+protected:
+	AlignedVector< std::pair< agg::path_storage, bool > > m_paths;
+	std::pair< agg::path_storage, bool >* m_current = nullptr;
+
+	agg::path_storage& current()
+	{
+		if (!m_current)
+		{
+			m_paths.push_back();
+			m_current = &m_paths.back();
+			m_current->second = false;
+		}
+		T_FATAL_ASSERT(m_current->second == false);
+		return m_current->first;
+	}
+};
+
+/*! Rasterizer implementation. */
+template < typename pixfmt_type, typename color_type >
+class RasterImpl : public PathRasterImpl
+{
+public:
+	explicit RasterImpl(Image* image)
+	:	m_rbuffer((agg::int8u*)image->getData(), image->getWidth(), image->getHeight(), image->getWidth() * image->getPixelFormat().getByteSize())
+	,	m_pf(m_rbuffer)
+	,	m_renderer(m_pf)
+	{
+	}
+
+	virtual void setMask(Image* image) override final
+	{
+		m_mask = image;
+	}
+
+	virtual void setClipBox(int32_t x1, int32_t y1, int32_t x2, int32_t y2) override final
+	{
+		m_renderer.clip_box(x1, y1, x2 - 1, y2 - 1);
+		m_rasterizer.clip_box(x1, y1, x2, y2);
+	}
+
+	virtual void resetClipBox() override final
+	{
+		m_renderer.reset_clipping(true);
+		m_rasterizer.reset_clipping();
+	}
+
+	virtual void clearStyles() override final
+	{
+		m_styleHandler.clearStyles();
+	}
+
+	virtual int32_t defineSolidStyle(const Color4f& color) override final
+	{
+		return m_styleHandler.defineSolidStyle(color);
+	}
+
+	virtual int32_t defineLinearGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors) override final
+	{
+		return m_styleHandler.defineLinearGradientStyle(gradientMatrix, colors);
+	}
+
+	virtual int32_t defineRadialGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors) override final
+	{
+		return m_styleHandler.defineRadialGradientStyle(gradientMatrix, colors);
+	}
+
+	virtual int32_t defineImageStyle(const Matrix33& imageMatrix, const Image* image, bool repeat) override final
+	{
+		return m_styleHandler.defineImageStyle(imageMatrix, image, repeat);
+	}
+
 	virtual void fill(int32_t style0, int32_t style1, Raster::FillRule fillRule) override final
 	{
 		for (auto& path : m_paths)
@@ -562,43 +683,7 @@ public:
 
 			agg::conv_curve< agg::path_storage > curve(p);
 			agg::conv_stroke< agg::conv_curve< agg::path_storage > > outline(curve);
-			outline.width(width);
-
-			switch (join)
-			{
-			case Raster::StrokeJoin::Miter:
-				outline.line_join(agg::miter_join);
-				break;
-
-			case Raster::StrokeJoin::Round:
-				outline.line_join(agg::round_join);
-				break;
-
-			case Raster::StrokeJoin::Bevel:
-				outline.line_join(agg::bevel_join);
-				break;
-
-			default:
-				break;
-			}
-
-			switch (cap)
-			{
-			case Raster::StrokeCap::Butt:
-				outline.line_cap(agg::butt_cap);
-				break;
-
-			case Raster::StrokeCap::Square:
-				outline.line_cap(agg::square_cap);
-				break;
-
-			case Raster::StrokeCap::Round:
-				outline.line_cap(agg::round_cap);
-				break;
-
-			default:
-				break;
-			}
+			setupStroke(outline, width, join, cap);
 
 			m_rasterizer.filling_rule(agg::fill_non_zero);
 			m_rasterizer.styles(-1, style);
@@ -631,25 +716,285 @@ private:
 	pixfmt_type m_pf;
 	agg::renderer_base< pixfmt_type > m_renderer;
 	agg::rasterizer_compound_aa<> m_rasterizer;
-	AlignedVector< std::pair< agg::path_storage, bool > > m_paths;
-	std::pair< agg::path_storage, bool >* m_current = nullptr;
+};
 
-	agg::path_storage& current()
+/*! Tiled rasterizer implementation.
+ *
+ * Fill and stroke operations are recorded until submit
+ * where they are binned into horizontal tiles by their
+ * bounds. Each tile is rasterized by a rasterizer clipped
+ * to the tile's rows so tiles can be rasterized in parallel
+ * without writing to same pixels.
+ */
+template < typename pixfmt_type, typename color_type >
+class TiledRasterImpl : public PathRasterImpl
+{
+public:
+	explicit TiledRasterImpl(Image* image)
+	:	m_rbuffer((agg::int8u*)image->getData(), image->getWidth(), image->getHeight(), image->getWidth() * image->getPixelFormat().getByteSize())
+	,	m_width(image->getWidth())
+	,	m_height(image->getHeight())
 	{
-		if (!m_current)
+		resetClipBox();
+		m_tileOperations.resize((m_height + c_tileHeight - 1) / c_tileHeight);
+	}
+
+	virtual void setMask(Image* image) override final
+	{
+		m_mask = image;
+	}
+
+	virtual void setClipBox(int32_t x1, int32_t y1, int32_t x2, int32_t y2) override final
+	{
+		m_clipBox[0] = clamp(x1, 0, m_width);
+		m_clipBox[1] = clamp(y1, 0, m_height);
+		m_clipBox[2] = clamp(x2, 0, m_width);
+		m_clipBox[3] = clamp(y2, 0, m_height);
+	}
+
+	virtual void resetClipBox() override final
+	{
+		m_clipBox[0] = 0;
+		m_clipBox[1] = 0;
+		m_clipBox[2] = m_width;
+		m_clipBox[3] = m_height;
+	}
+
+	virtual void clearStyles() override final
+	{
+		m_styleHandler.clearStyles();
+	}
+
+	virtual int32_t defineSolidStyle(const Color4f& color) override final
+	{
+		return m_styleHandler.defineSolidStyle(color);
+	}
+
+	virtual int32_t defineLinearGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors) override final
+	{
+		return m_styleHandler.defineLinearGradientStyle(gradientMatrix, colors);
+	}
+
+	virtual int32_t defineRadialGradientStyle(const Matrix33& gradientMatrix, const AlignedVector< std::pair< Color4f, float > >& colors) override final
+	{
+		return m_styleHandler.defineRadialGradientStyle(gradientMatrix, colors);
+	}
+
+	virtual int32_t defineImageStyle(const Matrix33& imageMatrix, const Image* image, bool repeat) override final
+	{
+		return m_styleHandler.defineImageStyle(imageMatrix, image, repeat);
+	}
+
+	virtual void fill(int32_t style0, int32_t style1, Raster::FillRule fillRule) override final
+	{
+		for (auto& path : m_paths)
 		{
-			m_paths.push_back();
-			m_current = &m_paths.back();
-			m_current->second = false;
+			m_fillingRule = (fillRule == Raster::FillRule::NonZero) ? agg::fill_non_zero : agg::fill_even_odd;
+
+			Operation& op = m_operations.push_back();
+			op.path = path.first;
+			op.path.align_all_paths();
+			op.style0 = style0;
+			op.style1 = style1;
+			op.fillingRule = m_fillingRule;
+			op.stroke = false;
+			op.width = 0.0f;
+			op.join = Raster::StrokeJoin::Miter;
+			op.cap = Raster::StrokeCap::Butt;
+			bin(uint32_t(m_operations.size() - 1), 1.0f);
+		}
+	}
+
+	virtual void stroke(int32_t style, float width, Raster::StrokeJoin join, Raster::StrokeCap cap) override final
+	{
+		for (auto& path : m_paths)
+		{
+			m_fillingRule = agg::fill_non_zero;
+
+			Operation& op = m_operations.push_back();
+			op.path = path.first;
+			op.path.align_all_paths();
+			if (path.second)
+				op.path.close_polygon();
+			op.style0 = -1;
+			op.style1 = style;
+			op.fillingRule = m_fillingRule;
+			op.stroke = true;
+			op.width = width;
+			op.join = join;
+			op.cap = cap;
+
+			// Miter joins can extend up to miter limit (4) times half width.
+			bin(uint32_t(m_operations.size() - 1), width * 2.0f + 1.0f);
+		}
+	}
+
+	virtual void submit() override final
+	{
+		m_activeTiles.resize(0);
+		for (int32_t i = 0; i < int32_t(m_tileOperations.size()); ++i)
+		{
+			if (!m_tileOperations[i].empty())
+				m_activeTiles.push_back(i);
+		}
+
+		const int32_t jobCount = std::min< int32_t >(
+			int32_t(m_activeTiles.size()),
+			std::min< int32_t >(OS::getInstance().getCPUCoreCount(), c_maxJobs)
+		);
+
+		if (jobCount > 1)
+		{
+			std::atomic< int32_t > next(0);
+			const auto rasterizeTiles = [&]() {
+				agg::rasterizer_compound_aa<> rasterizer;
+				agg::span_allocator< color_type > alloc;
+				for (int32_t i = next++; i < int32_t(m_activeTiles.size()); i = next++)
+					rasterizeTile(rasterizer, alloc, m_activeTiles[i]);
+			};
+
+			StaticVector< Job::task_t, c_maxJobs > jobs;
+			for (int32_t i = 0; i < jobCount; ++i)
+				jobs.push_back(rasterizeTiles);
+			JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+		}
+		else
+		{
+			for (int32_t tile : m_activeTiles)
+				rasterizeTile(m_rasterizer, m_alloc, tile);
+		}
+
+		for (int32_t tile : m_activeTiles)
+			m_tileOperations[tile].resize(0);
+		m_operations.resize(0);
+	}
+
+private:
+	constexpr static int32_t c_tileHeight = 64;
+	constexpr static int32_t c_maxJobs = 16;
+	constexpr static double c_clipRange = 1e6;
+
+	struct Operation
+	{
+		agg::path_storage path;
+		int32_t style0;
+		int32_t style1;
+		agg::filling_rule_e fillingRule;
+		bool stroke;
+		float width;
+		Raster::StrokeJoin join;
+		Raster::StrokeCap cap;
+	};
+
+	StyleHandler< color_type > m_styleHandler;
+	Ref< Image > m_mask;
+	agg::rendering_buffer m_rbuffer;
+	int32_t m_width;
+	int32_t m_height;
+	int32_t m_clipBox[4];
+	agg::filling_rule_e m_fillingRule = agg::fill_non_zero;
+	AlignedVector< Operation > m_operations;
+	AlignedVector< AlignedVector< uint32_t > > m_tileOperations;
+	AlignedVector< int32_t > m_activeTiles;
+	agg::rasterizer_compound_aa<> m_rasterizer;
+	agg::span_allocator< color_type > m_alloc;
+
+	/*! Add operation to all tiles overlapped by its path. */
+	void bin(uint32_t index, float margin)
+	{
+		const agg::path_storage& path = m_operations[index].path;
+
+		double minY = std::numeric_limits< double >::max();
+		double maxY = -std::numeric_limits< double >::max();
+		for (unsigned i = 0; i < path.total_vertices(); ++i)
+		{
+			double x, y;
+			if (agg::is_vertex(path.vertex(i, &x, &y)))
+			{
+				minY = std::min(minY, y);
+				maxY = std::max(maxY, y);
+			}
+		}
+		if (minY > maxY)
+			return;
+
+		const int32_t y0 = std::max< int32_t >(int32_t(std::floor(minY - margin)), m_clipBox[1]);
+		const int32_t y1 = std::min< int32_t >(int32_t(std::ceil(maxY + margin)), m_clipBox[3] - 1);
+		if (y0 > y1)
+			return;
+
+		for (int32_t tile = y0 / c_tileHeight; tile <= y1 / c_tileHeight; ++tile)
+			m_tileOperations[tile].push_back(index);
+	}
+
+	/*! Rasterize all operations overlapping tile, clipped to tile's rows. */
+	void rasterizeTile(agg::rasterizer_compound_aa<>& rasterizer, agg::span_allocator< color_type >& alloc, int32_t tile)
+	{
+		const int32_t y0 = std::max(tile * c_tileHeight, m_clipBox[1]);
+		const int32_t y1 = std::min((tile + 1) * c_tileHeight, m_clipBox[3]);
+		if (y0 >= y1 || m_clipBox[0] >= m_clipBox[2])
+			return;
+
+		rasterizer.reset();
+		rasterizer.clip_box(-c_clipRange, y0, c_clipRange, y1);
+
+		for (uint32_t index : m_tileOperations[tile])
+		{
+			const Operation& op = m_operations[index];
+
+			PathVertexSource source(op.path);
+			agg::conv_curve< PathVertexSource > curve(source);
+
+			rasterizer.filling_rule(op.fillingRule);
+			rasterizer.styles(op.style0, op.style1);
+
+			if (!op.stroke)
+				rasterizer.add_path(curve);
+			else
+			{
+				agg::conv_stroke< agg::conv_curve< PathVertexSource > > outline(curve);
+				setupStroke(outline, op.width, op.join, op.cap);
+				rasterizer.add_path(outline);
+			}
+		}
+
+		// Filling rule is evaluated when sweeping thus only last rule
+		// set is used, same as when not tiled.
+		rasterizer.filling_rule(m_fillingRule);
+
+		pixfmt_type pf(m_rbuffer);
+		agg::renderer_base< pixfmt_type > renderer(pf);
+		renderer.clip_box(m_clipBox[0], y0, m_clipBox[2] - 1, y1 - 1);
+
+		if (!m_mask)
+		{
+			agg::scanline_u8 sl;
+			agg::render_scanlines_compound_layered(rasterizer, sl, renderer, alloc, m_styleHandler);
+		}
+		else
+		{
+			agg::rendering_buffer mrb((agg::int8u*)m_mask->getData(), m_mask->getWidth(), m_mask->getHeight(), m_mask->getWidth() * m_mask->getPixelFormat().getByteSize());
+			agg::alpha_mask_gray8 mask(mrb);
+			agg::scanline_u8_am< agg::alpha_mask_gray8 > sl(mask);
+			agg::render_scanlines_compound_layered(rasterizer, sl, renderer, alloc, m_styleHandler);
 		}
-		T_FATAL_ASSERT(m_current->second == false);
-		return m_current->first;
 	}
 };
 
+/*! Create rasterizer implementation for pixel format. */
+template < typename pixfmt_type, typename color_type >
+Ref< IRasterImpl > createRasterImpl(Image* image, bool tiled)
+{
+	if (tiled)
+		return new TiledRasterImpl< pixfmt_type, color_type >(image);
+	else
+		return new RasterImpl< pixfmt_type, color_type >(image);
+}
+
 T_IMPLEMENT_RTTI_CLASS(L"traktor.drawing.Raster", Raster, Object)
 
-Raster::Raster(Image* image)
+Raster::Raster(Image* image, Backend backend)
+:	m_backend(backend)
 {
 	setImage(image);
 }
@@ -663,16 +1008,23 @@ bool Raster::setImage(Image* image)
 {
 	m_impl = nullptr;
 
+	const bool tiled =
+		m_backend == Backend::Tiled ||
+		(m_backend == Backend::Auto && image->getHeight() >= c_autoTiledHeight && OS::getInstance().getCPUCoreCount() > 1);
+
 	if (image->getPixelFormat() == PixelFormat::getA8B8G8R8())
-		m_impl = new RasterImpl< agg::pixfmt_rgba32_plain, agg::rgba8 >(image);
+		m_impl = createRasterImpl< agg::pixfmt_rgba32_plain, agg::rgba8 >(image, tiled);
 	else if (image->getPixelFormat() == PixelFormat::getB8G8R8A8())
-		m_impl = new RasterImpl< agg::pixfmt_argb32_plain, agg::rgba8 >(image);
+		m_impl = createRasterImpl< agg::pixfmt_argb32_plain, agg::rgba8 >(image, tiled);
 	else if (image->getPixelFormat() == PixelFormat::getA8R8G8B8())
-		m_impl = new RasterImpl< agg::pixfmt_bgra32_plain, agg::rgba8 >(image);
+		m_impl = createRasterImpl< agg::pixfmt_bgra32_plain, agg::rgba8 >(image, tiled);
 	else if (image->getPixelFormat() == PixelFormat::getR8G8B8A8())
-		m_impl = new RasterImpl< agg::pixfmt_abgr32_plain, agg::rgba8 >(image);
+		m_impl = createRasterImpl< agg::pixfmt_abgr32_plain, agg::rgba8 >(image, tiled);
 	else if (image->getPixelFormat() == PixelFormat::getA8())
-		m_impl = new RasterImpl< agg::pixfmt_gray8, agg::gray8 >(image);
+		m_impl = createRasterImpl< agg::pixfmt_gray8, agg::gray8 >(image, tiled);
+
+	if (m_impl && m_clip)
+		m_impl->setClipBox(m_clipRect[0], m_clipRect[1], m_clipRect[2], m_clipRect[3]);
 
 	return valid();
 }
@@ -682,6 +1034,22 @@ void Raster::setMask(Image* image)
 	m_impl->setMask(image);
 }
 
+void Raster::setClipRect(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+	m_clipRect[0] = x;
+	m_clipRect[1] = y;
+	m_clipRect[2] = x + width;
+	m_clipRect[3] = y + height;
+	m_clip = true;
+	m_impl->setClipBox(m_clipRect[0], m_clipRect[1], m_clipRect[2], m_clipRect[3]);
+}
+
+void Raster::resetClipRect()
+{
+	m_clip = false;
+	m_impl->resetClipBox();
+}
+
 void Raster::clearStyles()
 {
 	m_impl->clearStyles();
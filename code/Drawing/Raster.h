@@ -61,9 +61,17 @@ public:
 		NonZero
 	};
 
+	/*! Rasterizer backend. */
+	enum class Backend
+	{
+		Auto,		//!< Tiled backend for large images, serial otherwise.
+		Serial,		//!< Rasterize entirely on calling thread.
+		Tiled		//!< Bin paths into tiles which are rasterized in parallel.
+	};
+
 	Raster() = default;
 
-	explicit Raster(Image* image);
+	explicit Raster(Image* image, Backend backend = Backend::Auto);
 
 	bool valid() const;
 
@@ -71,6 +79,21 @@ public:
 
 	void setMask(Image* image);
 
+	/*! Restrict rasterization to a rectangle.
+	 *
+	 * Pixels outside of rectangle are left untouched; clip
+	 * rectangle persist when image is replaced.
+	 *
+	 * \param x Left edge in pixels.
+	 * \param y Top edge in pixels.
+	 * \param width Width in pixels.
+	 * \param height Height in pixels.
+	 */
+	void setClipRect(int32_t x, int32_t y, int32_t width, int32_t height);
+
+	/*! Remove clip rectangle; entire image is writable. */
+	void resetClipRect();
+
 	void clearStyles();
 
 	int32_t defineSolidStyle(const Color4f& color);
@@ -125,6 +148,9 @@ public:
 
 private:
 	Ref< IRasterImpl > m_impl;
+	Backend m_backend = Backend::Auto;
+	int32_t m_clipRect[4] = { 0, 0, 0, 0 };
+	bool m_clip = false;
 };
 
 }
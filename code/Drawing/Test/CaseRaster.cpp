@@ -0,0 +1,206 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Core/Log/Log.h"
+#include "Core/Math/Color4f.h"
+#include "Core/Math/Const.h"
+#include "Core/Math/Matrix33.h"
+#include "Core/Timer/Timer.h"
+#include "Drawing/Image.h"
+#include "Drawing/PixelFormat.h"
+#include "Drawing/Raster.h"
+#include "Drawing/Test/CaseRaster.h"
+
+namespace traktor::drawing::test
+{
+	namespace
+	{
+
+const int32_t c_tolerance = 4;	//!< Maximum channel difference allowed between backends.
+
+class Random
+{
+public:
+	explicit Random(uint32_t seed)
+	:	m_state(seed)
+	{
+	}
+
+	float next(float mn, float mx)
+	{
+		m_state = m_state * 1664525 + 1013904223;
+		return mn + (mx - mn) * float(m_state >> 8) / float(1 << 24);
+	}
+
+private:
+	uint32_t m_state;
+};
+
+/*! Render a random scene of filled and stroked shapes. */
+void renderScene(Raster& raster, int32_t width, int32_t height, int32_t shapeCount, uint32_t seed)
+{
+	Random rnd(seed);
+
+	const float w = float(width);
+	const float h = float(height);
+
+	for (int32_t i = 0; i < shapeCount; ++i)
+	{
+		const Color4f c1(rnd.next(0.0f, 1.0f), rnd.next(0.0f, 1.0f), rnd.next(0.0f, 1.0f), rnd.next(0.25f, 1.0f));
+		const Color4f c2(rnd.next(0.0f, 1.0f), rnd.next(0.0f, 1.0f), rnd.next(0.0f, 1.0f), rnd.next(0.25f, 1.0f));
+
+		int32_t style = -1;
+		switch (i % 3)
+		{
+		case 0:
+			style = raster.defineSolidStyle(c1);
+			break;
+
+		case 1:
+			style = raster.defineLinearGradientStyle(
+				scale(1.0f / w, 1.0f) * rotate(rnd.next(0.0f, TWO_PI)),
+				{ { c1, 0.0f }, { c2, 1.0f } }
+			);
+			break;
+
+		case 2:
+			style = raster.defineRadialGradientStyle(
+				scale(4.0f / w, 4.0f / h) * translate(-rnd.next(0.0f, w), -rnd.next(0.0f, h)),
+				{ { c1, 0.0f }, { c2, 1.0f } }
+			);
+			break;
+		}
+
+		raster.clear();
+		switch ((i / 3) % 4)
+		{
+		case 0:
+			{
+				raster.moveTo(rnd.next(0.0f, w), rnd.next(0.0f, h));
+				for (int32_t j = 0; j < 6; ++j)
+					raster.lineTo(rnd.next(0.0f, w), rnd.next(0.0f, h));
+				raster.close();
+				raster.fill(-1, style, (i & 1) ? Raster::FillRule::OddEven : Raster::FillRule::NonZero);
+			}
+			break;
+
+		case 1:
+			{
+				raster.moveTo(rnd.next(0.0f, w), rnd.next(0.0f, h));
+				raster.cubicTo(rnd.next(0.0f, w), rnd.next(0.0f, h), rnd.next(0.0f, w), rnd.next(0.0f, h), rnd.next(0.0f, w), rnd.next(0.0f, h));
+				raster.quadricTo(rnd.next(0.0f, w), rnd.next(0.0f, h), rnd.next(0.0f, w), rnd.next(0.0f, h));
+				raster.stroke(style, rnd.next(1.0f, 12.0f), Raster::StrokeJoin::Round, Raster::StrokeCap::Round);
+			}
+			break;
+
+		case 2:
+			{
+				raster.circle(rnd.next(0.0f, w), rnd.next(0.0f, h), rnd.next(4.0f, w / 4.0f));
+				raster.fill(-1, style, Raster::FillRule::NonZero);
+			}
+			break;
+
+		case 3:
+			{
+				raster.rect(rnd.next(-w / 4.0f, w), rnd.next(-h / 4.0f, h), rnd.next(8.0f, w / 2.0f), rnd.next(8.0f, h / 2.0f), rnd.next(0.0f, 16.0f));
+				raster.close();
+				raster.fill(-1, style, Raster::FillRule::NonZero);
+				raster.stroke(raster.defineSolidStyle(c2), rnd.next(1.0f, 4.0f), Raster::StrokeJoin::Miter, Raster::StrokeCap::Butt);
+			}
+			break;
+		}
+
+		// Submit in batches to also exercise multiple shapes per submit.
+		if ((i % 8) == 7)
+			raster.submit();
+	}
+	raster.submit();
+}
+
+Ref< Image > renderImage(Raster::Backend backend, int32_t width, int32_t height, int32_t shapeCount, uint32_t seed, double& outTime)
+{
+	Ref< Image > image = new Image(PixelFormat::getA8B8G8R8(), width, height);
+	image->clear(Color4f(0.0f, 0.0f, 0.0f, 0.0f));
+
+	Timer timer;
+
+	Raster raster(image, backend);
+	if (raster.valid())
+		renderScene(raster, width, height, shapeCount, seed);
+
+	outTime = timer.getElapsedTime();
+	return image;
+}
+
+/*! Compare images, return max channel difference and number of differing pixels. */
+int32_t compareImages(const Image* imageA, const Image* imageB, int32_t& outDifferingPixels)
+{
+	const uint8_t* a = (const uint8_t*)imageA->getData();
+	const uint8_t* b = (const uint8_t*)imageB->getData();
+	const int32_t pixelCount = imageA->getWidth() * imageA->getHeight();
+
+	int32_t maxDifference = 0;
+	outDifferingPixels = 0;
+
+	for (int32_t i = 0; i < pixelCount; ++i, a += 4, b += 4)
+	{
+		if (std::memcmp(a, b, 4) == 0)
+			continue;
+
+		for (int32_t j = 0; j < 4; ++j)
+			maxDifference = std::max(maxDifference, std::abs(int32_t(a[j]) - int32_t(b[j])));
+
+		++outDifferingPixels;
+	}
+
+	return maxDifference;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.drawing.test.CaseRaster", 0, CaseRaster, traktor::test::Case)
+
+void CaseRaster::run()
+{
+	double serialTime, tiledTime;
+	int32_t differingPixels;
+
+	// Image comparison, tiled backend must match serial within tolerance.
+	for (uint32_t seed = 1; seed <= 4; ++seed)
+	{
+		Ref< Image > serial = renderImage(Raster::Backend::Serial, 512, 512, 64, seed, serialTime);
+		Ref< Image > tiled = renderImage(Raster::Backend::Tiled, 512, 512, 64, seed, tiledTime);
+
+		const int32_t maxDifference = compareImages(serial, tiled, differingPixels);
+		CASE_ASSERT(maxDifference <= c_tolerance);
+		CASE_ASSERT(differingPixels <= 512 * 512 / 100);
+	}
+
+	// Image not multiple of tile size.
+	{
+		Ref< Image > serial = renderImage(Raster::Backend::Serial, 333, 199, 32, 99, serialTime);
+		Ref< Image > tiled = renderImage(Raster::Backend::Tiled, 333, 199, 32, 99, tiledTime);
+
+		const int32_t maxDifference = compareImages(serial, tiled, differingPixels);
+		CASE_ASSERT(maxDifference <= c_tolerance);
+	}
+
+	// Benchmark large image.
+	{
+		Ref< Image > serial = renderImage(Raster::Backend::Serial, 4096, 4096, 256, 1234, serialTime);
+		Ref< Image > tiled = renderImage(Raster::Backend::Tiled, 4096, 4096, 256, 1234, tiledTime);
+
+		const int32_t maxDifference = compareImages(serial, tiled, differingPixels);
+		CASE_ASSERT(maxDifference <= c_tolerance);
+
+		log::info << L"Raster 4096x4096; serial " << int32_t(serialTime * 1000.0) << L" ms, tiled " << int32_t(tiledTime * 1000.0) << L" ms, " << differingPixels << L" pixels differ" << Endl;
+	}
+}
+
+}
@@ -73,6 +73,7 @@
 #include "Editor/App/WorkspaceDialog.h"
 #include "Editor/Pipeline/PipelineBuilder.h"
 #include "Editor/Pipeline/PipelineDbFlat.h"
+#include "Editor/Pipeline/PipelineDependencyCache.h"
 #include "Editor/Pipeline/PipelineDependsIncremental.h"
 #include "Editor/Pipeline/PipelineDependsParallel.h"
 #include "Editor/Pipeline/PipelineFactory.h"
@@ -1752,6 +1753,16 @@ void EditorForm::buildAssetsThread(AlignedVector< Guid > assetGuids, bool rebuil
 	PipelineDependencySet dependencySet;
 	PipelineInstanceCache instanceCache(m_sourceDatabase, cachePath);
 
+	// Load dependency cache, ignored when rebuilding so all dependencies are rescanned.
+	const std::wstring dependencyCachePath = m_mergedSettings->getProperty< std::wstring >(L"Pipeline.DependencyCache");
+	Ref< PipelineDependencyCache > dependencyCache;
+	if (!dependencyCachePath.empty())
+	{
+		dependencyCache = new PipelineDependencyCache(dependencyCachePath);
+		if (!rebuild)
+			dependencyCache->load();
+	}
+
 	// Build dependencies.
 	Ref< IPipelineDepends > pipelineDepends;
 	if (m_mergedSettings->getProperty< bool >(L"Pipeline.DependsThreads", true))
@@ -1762,7 +1773,8 @@ void EditorForm::buildAssetsThread(AlignedVector< Guid > assetGuids, bool rebuil
 			m_outputDatabase,
 			&dependencySet,
 			m_pipelineDb,
-			&instanceCache
+			&instanceCache,
+			dependencyCache
 		);
 	}
 	else
@@ -1792,6 +1804,9 @@ void EditorForm::buildAssetsThread(AlignedVector< Guid > assetGuids, bool rebuil
 	const bool result = pipelineDepends->waitUntilFinished();
 	if (result)
 	{
+		if (dependencyCache)
+			dependencyCache->save();
+
 		if (verbose)
 		{
 			const double elapsedDependencies = timerBuild.getElapsedTime();
@@ -8,9 +8,11 @@
  */
 #pragma once
 
+#include <utility>
 #include "Core/Guid.h"
 #include "Core/Object.h"
 #include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Misc/Key.h"
 #include "Editor/PipelineTypes.h"
 
@@ -47,6 +49,14 @@ public:
 	 */
 	virtual void destroy() = 0;
 
+	/*! Prefetch entries which are about to be read.
+	 *
+	 * Cache can look up multiple entries in
+	 * a single request before each entry is
+	 * read through get.
+	 */
+	virtual void prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries) = 0;
+
 	/*!
 	 */
 	virtual Ref< IStream > get(const Guid& guid, const PipelineDependencyHash& hash) = 0;
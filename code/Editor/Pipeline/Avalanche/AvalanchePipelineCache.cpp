@@ -17,12 +17,28 @@
 #include "Core/Settings/PropertyGroup.h"
 #include "Core/Settings/PropertyInteger.h"
 #include "Core/Settings/PropertyString.h"
+#include "Core/Thread/Acquire.h"
 #include "Core/Thread/JobManager.h"
 #include "Editor/Pipeline/Avalanche/AvalanchePipelineCache.h"
 #include "Net/Network.h"
 
 namespace traktor::editor
 {
+	namespace
+	{
+
+const int64_t c_maxPrefetchBlobSize = 1 * 1024 * 1024;	//!< Larger blobs are streamed when read.
+const int64_t c_maxPrefetchSize = 64 * 1024 * 1024;		//!< Maximum size of all prefetched blobs.
+
+Key combinedKey(const Guid& guid, const PipelineDependencyHash& hash)
+{
+	// Combine guid and hash to generate 128-bit storage key.
+	const Guid gk = guid.permutation(Guid((const uint8_t*)&hash));
+	const uint32_t* kv = (const uint32_t*)(const uint8_t*)gk;
+	return Key(kv[0], kv[1], kv[2], kv[3]);
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.editor.AvalanchePipelineCache", AvalanchePipelineCache, IPipelineCache)
 
@@ -61,6 +77,53 @@ void AvalanchePipelineCache::destroy()
 		m_statsJob = nullptr;
 	}
 	safeDestroy(m_client);
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_prefetchedLock);
+	m_prefetched.clear();
+}
+
+void AvalanchePipelineCache::prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries)
+{
+	if (!m_accessRead || entries.empty())
+		return;
+
+	AlignedVector< Key > keys;
+	keys.reserve(entries.size());
+	for (const auto& entry : entries)
+		keys.push_back(combinedKey(entry.first, entry.second));
+
+	// Query existence of all entries in a batch.
+	AlignedVector< int64_t > blobSizes;
+	if (!m_client->stat(keys, blobSizes))
+		return;
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_prefetchedLock);
+	m_prefetched.clear();
+
+	// Missing entries are recorded so get doesn't need to ask server; small
+	// blobs are read in a batch while large blobs are streamed when read.
+	AlignedVector< Key > getKeys;
+	int64_t prefetchSize = 0;
+	for (uint32_t i = 0; i < (uint32_t)keys.size(); ++i)
+	{
+		if (blobSizes[i] < 0)
+			m_prefetched[keys[i]] = nullptr;
+		else if (blobSizes[i] <= c_maxPrefetchBlobSize && prefetchSize + blobSizes[i] <= c_maxPrefetchSize)
+		{
+			getKeys.push_back(keys[i]);
+			prefetchSize += blobSizes[i];
+		}
+	}
+
+	RefArray< IStream > blobs;
+	if (!m_client->get(getKeys, blobs))
+		return;
+
+	for (uint32_t i = 0; i < (uint32_t)getKeys.size(); ++i)
+	{
+		if (blobs[i])
+			m_prefetched[getKeys[i]] = blobs[i];
+	}
 }
 
 Ref< IStream > AvalanchePipelineCache::get(const Guid& guid, const PipelineDependencyHash& hash)
@@ -68,12 +131,24 @@ Ref< IStream > AvalanchePipelineCache::get(const Guid& guid, const PipelineDepen
 	if (!m_accessRead)
 		return nullptr;
 
-	// Combine guid and hash to generate 128-bit storage key.
-	const Guid gk = guid.permutation(Guid((const uint8_t*)&hash));
-	const uint32_t* kv = (const uint32_t*)(const uint8_t*)gk;
-	const Key key(kv[0], kv[1], kv[2], kv[3]);
+	const Key key = combinedKey(guid, hash);
+
+	Ref< IStream > stream;
+	bool prefetched = false;
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_prefetchedLock);
+		auto it = m_prefetched.find(key);
+		if (it != m_prefetched.end())
+		{
+			stream = it->second;
+			prefetched = true;
+			m_prefetched.erase(it);
+		}
+	}
+
+	if (!prefetched)
+		stream = m_client->get(key);
 
-	Ref< IStream > stream = m_client->get(key);
 	if (!stream)
 	{
 		m_misses++;
@@ -89,10 +164,13 @@ Ref< IStream > AvalanchePipelineCache::put(const Guid& guid, const PipelineDepen
 	if (!m_accessWrite)
 		return nullptr;
 
-	// Combine guid and hash to generate 128-bit storage key.
-	const Guid gk = guid.permutation(Guid((const uint8_t*)&hash));
-	const uint32_t* kv = (const uint32_t*)(const uint8_t*)gk;
-	const Key key(kv[0], kv[1], kv[2], kv[3]);
+	const Key key = combinedKey(guid, hash);
+
+	// Entry is about to be replaced; prefetched entry is stale.
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_prefetchedLock);
+		m_prefetched.erase(key);
+	}
 
 	Ref< IStream > stream = m_client->put(key);
 	if (!stream)
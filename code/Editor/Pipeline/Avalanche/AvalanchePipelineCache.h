@@ -8,7 +8,9 @@
  */
 #pragma once
 
+#include <map>
 #include "Avalanche/Dictionary.h"
+#include "Core/Thread/Semaphore.h"
 #include "Editor/IPipelineCache.h"
 
 // import/export mechanism.
@@ -47,6 +49,8 @@ public:
 
 	virtual void destroy() override final;
 
+	virtual void prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries) override final;
+
 	virtual Ref< IStream > get(const Guid& guid, const PipelineDependencyHash& hash) override final;
 
 	virtual Ref< IStream > put(const Guid& guid, const PipelineDependencyHash& hash) override final;
@@ -67,6 +71,8 @@ private:
 	uint32_t m_misses = 0;
 	Ref< Job > m_statsJob;
 	avalanche::Dictionary::Stats m_stats;
+	Semaphore m_prefetchedLock;
+	std::map< Key, Ref< IStream > > m_prefetched;	//!< Prefetched blobs, null if blob doesn't exist.
 };
 
 }
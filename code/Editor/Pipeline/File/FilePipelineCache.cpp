@@ -35,6 +35,10 @@ void FilePipelineCache::destroy()
 {
 }
 
+void FilePipelineCache::prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries)
+{
+}
+
 Ref< IStream > FilePipelineCache::get(const Guid& guid, const PipelineDependencyHash& hash)
 {
 	if (!m_accessRead)
@@ -24,6 +24,10 @@ void MemoryPipelineCache::destroy()
 {
 }
 
+void MemoryPipelineCache::prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries)
+{
+}
+
 Ref< IStream > MemoryPipelineCache::get(const Guid& guid, const PipelineDependencyHash& hash)
 {
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
@@ -33,6 +33,8 @@ public:
 
 	virtual void destroy() override final;
 
+	virtual void prefetch(const AlignedVector< std::pair< Guid, PipelineDependencyHash > >& entries) override final;
+
 	virtual Ref< IStream > get(const Guid& guid, const PipelineDependencyHash& hash) override final;
 
 	virtual Ref< IStream > put(const Guid& guid, const PipelineDependencyHash& hash) override final;
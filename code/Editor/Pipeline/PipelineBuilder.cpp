@@ -309,6 +309,33 @@ bool PipelineBuilder::build(const PipelineDependencySet* dependencySet, bool reb
 
 	T_DEBUG(L"Pipeline build; analyzed build reasons in " << formatDuration(timer.getDeltaTime()) << L".");
 
+	// Let cache look up output of entire work set at once.
+	if (m_cache)
+	{
+		AlignedVector< std::pair< Guid, PipelineDependencyHash > > cacheEntries;
+		for (const auto& w : workSet)
+		{
+			if ((w.dependency->flags & PdfBuild) == 0 || !w.dependency->pipelineType)
+				continue;
+
+			Ref< IPipeline > pipeline = m_pipelineFactory->findPipeline(*w.dependency->pipelineType);
+			if (!pipeline || !pipeline->shouldCache())
+				continue;
+
+			PipelineDependencyHash dependencyHash;
+			calculateGlobalHash(
+				dependencySet,
+				w.dependency,
+				dependencyHash.pipelineHash,
+				dependencyHash.sourceAssetHash,
+				dependencyHash.sourceDataHash,
+				dependencyHash.filesHash
+			);
+			cacheEntries.push_back({ w.dependency->outputGuid, dependencyHash });
+		}
+		m_cache->prefetch(cacheEntries);
+	}
+
 	if (m_verbose && !workSet.empty())
 		log::info << L"Dispatching " << (int32_t)workSet.size() << L" build(s)..." << Endl;
 
@@ -0,0 +1,173 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Io/BufferedStream.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Log/Log.h"
+#include "Core/Serialization/BinarySerializer.h"
+#include "Core/Serialization/MemberAlignedVector.h"
+#include "Core/Serialization/MemberComposite.h"
+#include "Core/Serialization/MemberSmallMap.h"
+#include "Core/Serialization/MemberStl.h"
+#include "Core/Thread/Acquire.h"
+#include "Editor/Pipeline/PipelineDependencyCache.h"
+
+namespace traktor::editor
+{
+	namespace
+	{
+
+const uint32_t c_version = 1;
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.editor.PipelineDependencyCache", PipelineDependencyCache, Object)
+
+PipelineDependencyCache::PipelineDependencyCache(const std::wstring& fileName)
+:	m_fileName(fileName)
+{
+}
+
+bool PipelineDependencyCache::load()
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+
+	m_entries.clear();
+	m_changes = 0;
+
+	// If cache file doesn't exist we assume this is the first run; ie. don't fail.
+	if (!FileSystem::getInstance().exist(m_fileName))
+		return FileSystem::getInstance().makeAllDirectories(Path(m_fileName).getPathOnly());
+
+	Ref< IStream > f = FileSystem::getInstance().open(m_fileName, File::FmRead);
+	if (!f)
+	{
+		log::error << L"Unable to load pipeline dependency cache; failed to open file." << Endl;
+		return false;
+	}
+
+	BufferedStream bs(f);
+	BinarySerializer s(&bs);
+
+	uint32_t version = 0;
+	s >> Member< uint32_t >(L"version", version);
+
+	if (version == c_version)
+	{
+		s >> MemberSmallMap<
+			Guid,
+			Entry,
+			Member< Guid >,
+			MemberComposite< Entry >
+		>(L"entries", m_entries);
+	}
+	else
+		log::warning << L"Pipeline dependency cache version mismatch; cache purged and full dependency scan is required." << Endl;
+
+	bs.close();
+	f = nullptr;
+
+	return true;
+}
+
+bool PipelineDependencyCache::save()
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+
+	if (m_changes == 0)
+		return true;
+
+	// Write into intermediate file first so an interrupted save
+	// doesn't leave a truncated cache behind.
+	const std::wstring intermediateFileName = m_fileName + L"~";
+
+	Ref< IStream > f = FileSystem::getInstance().open(intermediateFileName, File::FmWrite);
+	if (!f)
+	{
+		log::error << L"Unable to save pipeline dependency cache; failed to create file." << Endl;
+		return false;
+	}
+
+	BufferedStream bs(f);
+	BinarySerializer s(&bs);
+
+	uint32_t version = c_version;
+	s >> Member< uint32_t >(L"version", version);
+
+	s >> MemberSmallMap<
+		Guid,
+		Entry,
+		Member< Guid >,
+		MemberComposite< Entry >
+	>(L"entries", m_entries);
+
+	bs.close();
+	f = nullptr;
+
+	if (!FileSystem::getInstance().move(m_fileName, intermediateFileName, true))
+	{
+		log::error << L"Unable to save pipeline dependency cache; failed to replace file." << Endl;
+		return false;
+	}
+
+	m_changes = 0;
+	return true;
+}
+
+bool PipelineDependencyCache::get(const Guid& instanceGuid, Entry& outEntry) const
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
+	const auto it = m_entries.find(instanceGuid);
+	if (it == m_entries.end())
+		return false;
+	outEntry = it->second;
+	return true;
+}
+
+void PipelineDependencyCache::put(const Guid& instanceGuid, const Entry& entry)
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+	m_entries[instanceGuid] = entry;
+	m_changes++;
+}
+
+void PipelineDependencyCache::remove(const Guid& instanceGuid)
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireWriter)(m_lock);
+	if (m_entries.remove(instanceGuid))
+		m_changes++;
+}
+
+uint32_t PipelineDependencyCache::size() const
+{
+	T_ANONYMOUS_VAR(ReaderWriterLock::AcquireReader)(m_lock);
+	return (uint32_t)m_entries.size();
+}
+
+void PipelineDependencyCache::Child::serialize(ISerializer& s)
+{
+	s >> Member< Guid >(L"guid", guid);
+	s >> Member< uint32_t >(L"flags", flags);
+}
+
+void PipelineDependencyCache::Entry::serialize(ISerializer& s)
+{
+	s >> MemberComposite< DateTime >(L"lastModifyDate", lastModifyDate);
+	s >> MemberSmallMap< std::wstring, DateTime, Member< std::wstring >, MemberComposite< DateTime > >(L"dataLastWriteTimes", dataLastWriteTimes);
+	s >> Member< std::wstring >(L"assetType", assetType);
+	s >> MemberSmallMap< std::wstring, uint32_t >(L"pipelineHashes", pipelineHashes);
+	s >> MemberSmallMap< Guid, DateTime, Member< Guid >, MemberComposite< DateTime > >(L"reads", reads);
+	s >> Member< uint32_t >(L"pipelineHash", pipelineHash);
+	s >> Member< uint32_t >(L"sourceAssetHash", sourceAssetHash);
+	s >> Member< uint32_t >(L"sourceDataHash", sourceDataHash);
+	s >> Member< uint32_t >(L"filesHash", filesHash);
+	s >> MemberStlList< PipelineDependency::ExternalFile, MemberComposite< PipelineDependency::ExternalFile > >(L"files", files);
+	s >> MemberAlignedVector< Child, MemberComposite< Child > >(L"children", children);
+}
+
+}
@@ -0,0 +1,88 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/SmallMap.h"
+#include "Core/Thread/ReaderWriterLock.h"
+#include "Editor/PipelineDependency.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_EDITOR_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::editor
+{
+
+/*! Persistent pipeline dependency cache.
+ * \ingroup Editor
+ *
+ * Keep scanned dependencies of source instances between builds
+ * so dependency walkers only need to rescan instances which
+ * have been modified since last build.
+ */
+class T_DLLCLASS PipelineDependencyCache : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	struct Child
+	{
+		Guid guid;
+		uint32_t flags = 0;
+
+		void serialize(ISerializer& s);
+	};
+
+	struct Entry
+	{
+		DateTime lastModifyDate;							/*!< Modify date of source instance. */
+		SmallMap< std::wstring, DateTime > dataLastWriteTimes;	/*!< Last write time of each source instance data. */
+		std::wstring assetType;								/*!< Type of source asset. */
+		SmallMap< std::wstring, uint32_t > pipelineHashes;	/*!< Hash of each pipeline consulted during scan, keyed by asset type. */
+		SmallMap< Guid, DateTime > reads;					/*!< Modify date of other instances read during scan. */
+		uint32_t pipelineHash = 0;
+		uint32_t sourceAssetHash = 0;
+		uint32_t sourceDataHash = 0;
+		uint32_t filesHash = 0;
+		PipelineDependency::external_files_t files;
+		AlignedVector< Child > children;
+
+		void serialize(ISerializer& s);
+	};
+
+	explicit PipelineDependencyCache(const std::wstring& fileName);
+
+	/*! Load cache from file, missing or outdated file results in an empty cache. */
+	bool load();
+
+	/*! Save cache to file, only written if modified since load. */
+	bool save();
+
+	bool get(const Guid& instanceGuid, Entry& outEntry) const;
+
+	void put(const Guid& instanceGuid, const Entry& entry);
+
+	void remove(const Guid& instanceGuid);
+
+	uint32_t size() const;
+
+private:
+	mutable ReaderWriterLock m_lock;
+	std::wstring m_fileName;
+	SmallMap< Guid, Entry > m_entries;
+	uint32_t m_changes = 0;
+};
+
+}
@@ -30,11 +30,23 @@
 #include "Editor/PipelineDependencySet.h"
 #include "Editor/IPipelineInstanceCache.h"
 #include "Editor/PipelineDependency.h"
+#include "Editor/Pipeline/PipelineDependencyCache.h"
 #include "Editor/Pipeline/PipelineDependsParallel.h"
 #include "Editor/Pipeline/PipelineFactory.h"
 
 namespace traktor::editor
 {
+	namespace
+	{
+
+/*! Dependency cache entry being recorded while scanning an instance. */
+struct CacheRecord
+{
+	PipelineDependencyCache::Entry entry;
+	bool cacheable = true;
+};
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.editor.PipelineDependsParallel", PipelineDependsParallel, IPipelineDepends)
 
@@ -44,7 +56,8 @@ PipelineDependsParallel::PipelineDependsParallel(
 	db::Database* outputDatabase,
 	PipelineDependencySet* dependencySet,
 	IPipelineDb* pipelineDb,
-	IPipelineInstanceCache* instanceCache
+	IPipelineInstanceCache* instanceCache,
+	PipelineDependencyCache* dependencyCache
 )
 :	m_pipelineFactory(pipelineFactory)
 ,	m_sourceDatabase(sourceDatabase)
@@ -52,6 +65,7 @@ PipelineDependsParallel::PipelineDependsParallel(
 ,	m_dependencySet(dependencySet)
 ,	m_pipelineDb(pipelineDb)
 ,	m_instanceCache(instanceCache)
+,	m_dependencyCache(dependencyCache)
 ,	m_result(true)
 {
 }
@@ -84,6 +98,10 @@ void PipelineDependsParallel::addDependency(const ISerializable* sourceAsset)
 		// Merge hash of dependent pipeline with parent's pipeline hash.
 		if (parentDependency)
 			parentDependency->pipelineHash += pipelineHash;
+
+		CacheRecord* record = reinterpret_cast< CacheRecord* >(m_currentCacheEntry.get());
+		if (record)
+			record->entry.pipelineHashes[type_name(sourceAsset)] = pipelineHash;
 	}
 	else
 	{
@@ -103,6 +121,11 @@ void PipelineDependsParallel::addDependency(const ISerializable* sourceAsset, co
 	Ref< const ISerializable > sourceAssetRef = sourceAsset;
 	Ref< PipelineDependency > parentDependency = reinterpret_cast< PipelineDependency* >(m_currentDependency.get());
 
+	// Embedded assets cannot be restored from dependency cache.
+	CacheRecord* record = reinterpret_cast< CacheRecord* >(m_currentCacheEntry.get());
+	if (record)
+		record->cacheable = false;
+
 	Ref< Job > job = JobManager::getInstance().add([=](){
 		jobAddDependency(parentDependency, sourceAssetRef, outputPath, outputGuid, flags);
 	});
@@ -126,6 +149,10 @@ void PipelineDependsParallel::addDependency(db::Instance* sourceAssetInstance, u
 	Ref< db::Instance > sourceAssetInstanceRef = sourceAssetInstance;
 	Ref< PipelineDependency > parentDependency = reinterpret_cast< PipelineDependency* >(m_currentDependency.get());
 
+	CacheRecord* record = reinterpret_cast< CacheRecord* >(m_currentCacheEntry.get());
+	if (record)
+		record->entry.children.push_back({ sourceAssetInstance->getGuid(), flags });
+
 	Ref< Job > job = JobManager::getInstance().add([=](){
 		jobAddDependency(parentDependency, sourceAssetInstanceRef, flags);
 	});
@@ -148,6 +175,10 @@ void PipelineDependsParallel::addDependency(const Guid& sourceAssetGuid, uint32_
 
 	Ref< PipelineDependency > parentDependency = reinterpret_cast< PipelineDependency* >(m_currentDependency.get());
 
+	CacheRecord* record = reinterpret_cast< CacheRecord* >(m_currentCacheEntry.get());
+	if (record)
+		record->entry.children.push_back({ sourceAssetGuid, flags });
+
 	Ref< Job > job = JobManager::getInstance().add([=](){
 		jobAddDependency(parentDependency, sourceAssetGuid, flags);
 	});
@@ -188,6 +219,10 @@ void PipelineDependsParallel::addDependency(
 			{
 				log::error << L"Unable to add dependency to \"" << filePath.getPathName() << L"\"; no such file." << Endl;
 				m_result = false;
+
+				CacheRecord* record = reinterpret_cast< CacheRecord* >(m_currentCacheEntry.get());
+				if (record)
+					record->cacheable = false;
 			}
 		}
 	}
@@ -213,6 +248,10 @@ void PipelineDependsParallel::addDependency(
 
 		// Merge hash of dependent pipeline with parent pipeline hash.
 		parentDependency->pipelineHash += pipelineHash;
+
+		CacheRecord* record = reinterpret_cast< CacheRecord* >(m_currentCacheEntry.get());
+		if (record)
+			record->entry.pipelineHashes[sourceAssetType.getName()] = pipelineHash;
 	}
 }
 
@@ -235,15 +274,33 @@ bool PipelineDependsParallel::waitUntilFinished()
 
 db::Database* PipelineDependsParallel::getSourceDatabase() const
 {
+	// Pipeline might resolve dependencies by querying database directly, which
+	// we cannot track; thus such dependency cannot be restored from cache.
+	CacheRecord* record = reinterpret_cast< CacheRecord* >(m_currentCacheEntry.get());
+	if (record)
+		record->cacheable = false;
+
 	return m_sourceDatabase;
 }
 
 Ref< const ISerializable > PipelineDependsParallel::getObjectReadOnly(const Guid& instanceGuid)
 {
-	if (instanceGuid.isNotNull())
-		return m_instanceCache->getObjectReadOnly(instanceGuid);
-	else
+	if (instanceGuid.isNull())
 		return nullptr;
+
+	// Keep modify date of read instance so cached dependency is invalidated if it changes.
+	CacheRecord* record = reinterpret_cast< CacheRecord* >(m_currentCacheEntry.get());
+	if (record)
+	{
+		Ref< db::Instance > instance = m_sourceDatabase->getInstance(instanceGuid);
+		DateTime lastModifyDate;
+		if (instance && instance->getLastModifyDate(lastModifyDate))
+			record->entry.reads[instanceGuid] = lastModifyDate;
+		else
+			record->cacheable = false;
+	}
+
+	return m_instanceCache->getObjectReadOnly(instanceGuid);
 }
 
 Ref< PipelineDependency > PipelineDependsParallel::findOrCreateDependency(
@@ -323,10 +380,17 @@ void PipelineDependsParallel::addUniqueDependency(
 
 	bool result = true;
 
+	// Record scanned dependencies of instances so we can skip scanning next time.
+	CacheRecord record;
+	record.cacheable = (m_dependencyCache != nullptr && sourceInstance != nullptr);
+
 	// Scan child dependencies.
 	{
 		Ref< PipelineDependency > previousDependency = reinterpret_cast< PipelineDependency* >(m_currentDependency.get());
+		void* previousCacheEntry = m_currentCacheEntry.get();
+
 		m_currentDependency.set(currentDependency);
+		m_currentCacheEntry.set(record.cacheable ? &record : nullptr);
 
 		result = pipeline->buildDependencies(
 			this,
@@ -336,6 +400,7 @@ void PipelineDependsParallel::addUniqueDependency(
 			currentDependency->outputGuid
 		);
 
+		m_currentCacheEntry.set(previousCacheEntry);
 		m_currentDependency.set(previousDependency);
 	}
 
@@ -346,6 +411,145 @@ void PipelineDependsParallel::addUniqueDependency(
 		currentDependency->flags |= PdfFailed;
 		m_result = false;
 	}
+
+	if (!m_dependencyCache || !sourceInstance)
+		return;
+
+	// Store scanned dependency in cache.
+	PipelineDependencyCache::Entry& entry = record.entry;
+	if (record.cacheable && m_result && (currentDependency->flags & PdfFailed) == 0)
+		record.cacheable = sourceInstance->getLastModifyDate(entry.lastModifyDate);
+
+	if (record.cacheable)
+	{
+		AlignedVector< std::wstring > dataNames;
+		sourceInstance->getDataNames(dataNames);
+		for (const auto& dataName : dataNames)
+		{
+			if (!sourceInstance->getDataLastWriteTime(dataName, entry.dataLastWriteTimes[dataName]))
+			{
+				record.cacheable = false;
+				break;
+			}
+		}
+	}
+
+	if (record.cacheable)
+	{
+		entry.assetType = type_name(sourceAsset);
+		entry.pipelineHashes[entry.assetType] = pipelineHash;
+		entry.pipelineHash = currentDependency->pipelineHash;
+		entry.sourceAssetHash = currentDependency->sourceAssetHash;
+		entry.sourceDataHash = currentDependency->sourceDataHash;
+		entry.filesHash = currentDependency->filesHash;
+		entry.files = currentDependency->files;
+		m_dependencyCache->put(sourceInstance->getGuid(), entry);
+	}
+	else
+		m_dependencyCache->remove(sourceInstance->getGuid());
+}
+
+bool PipelineDependsParallel::restoreDependency(
+	PipelineDependency* currentDependency,
+	const db::Instance* sourceInstance,
+	const ISerializable* sourceAsset
+)
+{
+	PipelineDependencyCache::Entry entry;
+	if (!m_dependencyCache->get(sourceInstance->getGuid(), entry))
+		return false;
+
+	// Ensure source instance hasn't been modified since entry was recorded.
+	DateTime lastModifyDate;
+	if (!sourceInstance->getLastModifyDate(lastModifyDate) || lastModifyDate != entry.lastModifyDate)
+		return false;
+
+	if (entry.assetType != type_name(sourceAsset))
+		return false;
+
+	AlignedVector< std::wstring > dataNames;
+	sourceInstance->getDataNames(dataNames);
+	if (dataNames.size() != entry.dataLastWriteTimes.size())
+		return false;
+
+	for (const auto& dataName : dataNames)
+	{
+		const auto it = entry.dataLastWriteTimes.find(dataName);
+		if (it == entry.dataLastWriteTimes.end())
+			return false;
+
+		DateTime lastWriteTime;
+		if (!sourceInstance->getDataLastWriteTime(dataName, lastWriteTime) || lastWriteTime != it->second)
+			return false;
+	}
+
+	// Ensure external files are unmodified.
+	for (const auto& dependencyFile : entry.files)
+	{
+		Ref< File > file = FileSystem::getInstance().get(dependencyFile.filePath);
+		if (!file || file->getLastWriteTime() != dependencyFile.lastWriteTime)
+			return false;
+	}
+
+	// Ensure other instances read during scan are unmodified.
+	for (const auto& read : entry.reads)
+	{
+		Ref< db::Instance > instance = m_sourceDatabase->getInstance(read.first);
+		if (!instance || !instance->getLastModifyDate(lastModifyDate) || lastModifyDate != read.second)
+			return false;
+	}
+
+	// Ensure pipelines haven't changed settings.
+	const TypeInfo* pipelineType = nullptr;
+	for (const auto& it : entry.pipelineHashes)
+	{
+		const TypeInfo* assetType = TypeInfo::find(it.first.c_str());
+		if (!assetType)
+			return false;
+
+		const TypeInfo* assetPipelineType;
+		uint32_t pipelineHash;
+		if (!m_pipelineFactory->findPipelineType(*assetType, assetPipelineType, pipelineHash) || pipelineHash != it.second)
+			return false;
+
+		if (it.first == entry.assetType)
+			pipelineType = assetPipelineType;
+	}
+	if (!pipelineType)
+		return false;
+
+	// Restore dependency.
+	currentDependency->pipelineType = pipelineType;
+	currentDependency->pipelineHash = entry.pipelineHash;
+	currentDependency->sourceInstanceGuid = sourceInstance->getGuid();
+	currentDependency->sourceAsset = sourceAsset;
+	currentDependency->files = entry.files;
+	currentDependency->outputPath = sourceInstance->getPath();
+	currentDependency->outputGuid = sourceInstance->getGuid();
+	currentDependency->sourceAssetHash = entry.sourceAssetHash;
+	currentDependency->sourceDataHash = entry.sourceDataHash;
+	currentDependency->filesHash = entry.filesHash;
+
+	// Add child dependencies; each child is also restored from cache if possible.
+	Ref< PipelineDependency > parentDependency = currentDependency;
+	for (const auto& child : entry.children)
+	{
+		const Guid childGuid = child.guid;
+		const uint32_t childFlags = child.flags;
+
+		Ref< Job > job = JobManager::getInstance().add([this, parentDependency, childGuid, childFlags](){
+			jobAddDependency(parentDependency, childGuid, childFlags);
+		});
+		if (job)
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_jobsLock);
+			m_jobs.push_back(job);
+		}
+		else
+			m_result = false;
+	}
+
+	return true;
 }
 
 void PipelineDependsParallel::updateDependencyHashes(
@@ -515,6 +719,10 @@ void PipelineDependsParallel::jobAddDependency(Ref< PipelineDependency > parentD
 		return;
 	}
 
+	// Restore from cache if instance hasn't been modified.
+	if (m_dependencyCache && restoreDependency(currentDependency, sourceAssetInstance, sourceAsset))
+		return;
+
 	addUniqueDependency(
 		parentDependency,
 		currentDependency,
@@ -556,6 +764,10 @@ void PipelineDependsParallel::jobAddDependency(Ref< PipelineDependency > parentD
 		return;
 	}
 
+	// Restore from cache if instance hasn't been modified.
+	if (m_dependencyCache && restoreDependency(currentDependency, sourceAssetInstance, sourceAsset))
+		return;
+
 	addUniqueDependency(
 		parentDependency,
 		currentDependency,
@@ -33,6 +33,7 @@ namespace traktor::editor
 {
 
 class IPipelineDb;
+class PipelineDependencyCache;
 class PipelineDependencySet;
 class IPipelineInstanceCache;
 class PipelineFactory;
@@ -51,7 +52,8 @@ public:
 		db::Database* outputDatabase,
 		PipelineDependencySet* dependencySet,
 		IPipelineDb* pipelineDb,
-		IPipelineInstanceCache* instanceCache
+		IPipelineInstanceCache* instanceCache,
+		PipelineDependencyCache* dependencyCache = nullptr
 	);
 
 	virtual ~PipelineDependsParallel();
@@ -100,7 +102,9 @@ private:
 	Ref< PipelineDependencySet > m_dependencySet;
 	Ref< IPipelineDb > m_pipelineDb;
 	Ref< IPipelineInstanceCache > m_instanceCache;
+	Ref< PipelineDependencyCache > m_dependencyCache;
 	ThreadLocal m_currentDependency;
+	ThreadLocal m_currentCacheEntry;
 	ReaderWriterLock m_readCacheLock;
 	Semaphore m_jobsLock;
 	Semaphore m_dependencySetLock;
@@ -122,6 +126,12 @@ private:
 		const Guid& outputGuid
 	);
 
+	bool restoreDependency(
+		PipelineDependency* currentDependency,
+		const db::Instance* sourceInstance,
+		const ISerializable* sourceAsset
+	);
+
 	void updateDependencyHashes(
 		PipelineDependency* dependency,
 		const IPipeline* pipeline,
@@ -61,7 +61,7 @@ bool MeshAssetRasterizer::generate(const editor::IEditor* editor, const MeshAsse
 	const auto& materialShaders = asset->getMaterialShaders();
 
 	// Bind texture references in material maps.
-	for (auto& material : model->getMaterials())
+	for (auto& material : model->editMaterials())
 	{
 		auto diffuseMap = material.getDiffuseMap();
 		auto it = materialTextures.find(diffuseMap.name);
@@ -74,7 +74,7 @@ bool MeshAssetRasterizer::generate(const editor::IEditor* editor, const MeshAsse
 
 	// Load texture images and attach to materials.
 	SmallMap< Path, Ref< drawing::Image > > images;
-	for (auto& material : model->getMaterials())
+	for (auto& material : model->editMaterials())
 	{
 		const auto it = materialShaders.find(material.getName());
 		if (it != materialShaders.end())
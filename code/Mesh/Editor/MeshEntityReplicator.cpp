@@ -89,7 +89,7 @@ Ref< model::Model > MeshEntityReplicator::createModel(
 	const auto& materialShaders = meshAsset->getMaterialShaders();
 
 	// Bind texture references in material maps.
-	for (auto& material : model->getMaterials())
+	for (auto& material : model->editMaterials())
 	{
 		auto diffuseMap = material.getDiffuseMap();
 		auto it = materialTextures.find(diffuseMap.name);
@@ -100,7 +100,7 @@ Ref< model::Model > MeshEntityReplicator::createModel(
 		}
 	}
 
-	for (auto& material : model->getMaterials())
+	for (auto& material : model->editMaterials())
 	{
 		const auto it = materialShaders.find(material.getName());
 		if (it != materialShaders.end())
@@ -0,0 +1,73 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/IRefCount.h"
+#include "Core/Ref.h"
+
+namespace traktor::model
+{
+
+/*! Copy-on-write value container.
+ * \ingroup Model
+ *
+ * Value is shared between copies of the container
+ * until write access is requested; thus only the
+ * values which are modified are duplicated.
+ */
+template < typename ValueType >
+class CopyOnWrite
+{
+public:
+	CopyOnWrite()
+	:	m_shared(new Shared())
+	{
+	}
+
+	explicit CopyOnWrite(const ValueType& value)
+	:	m_shared(new Shared(value))
+	{
+	}
+
+	/*! Get value for read-only access. */
+	const ValueType& read() const
+	{
+		return m_shared->value;
+	}
+
+	/*! Get value for write access, value is copied first if it's shared. */
+	ValueType& write()
+	{
+		if (m_shared->isShared())
+			m_shared = new Shared(m_shared->value);
+		return m_shared->value;
+	}
+
+private:
+	struct Shared : public RefCountImpl< IRefCount >
+	{
+		ValueType value;
+
+		Shared() = default;
+
+		explicit Shared(const ValueType& v)
+		:	value(v)
+		{
+		}
+
+		bool isShared() const
+		{
+			return this->m_refCount > 1;
+		}
+	};
+
+	Ref< Shared > m_shared;
+};
+
+}
@@ -81,35 +81,35 @@ bool shouldReplace(const Vertex& existing, const Vertex& replaceWith)
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.model.Model", 4, Model, PropertyGroup)
 
 Model::Model()
-:	m_positions(0.5f)
-,	m_colors(0.1f)
-,	m_normals(0.1f)
-,	m_texCoords(0.1f)
+:	m_positions(Grid3< Vector4 >(0.5f))
+,	m_colors(Grid3< Vector4 >(0.1f))
+,	m_normals(Grid3< Vector4 >(0.1f))
+,	m_texCoords(Grid2< Vector2 >(0.1f))
 {
 }
 
 void Model::clear(uint32_t clearFlags)
 {
 	if (clearFlags & CfMaterials)
-		m_materials.resize(0);
+		m_materials.write().resize(0);
 	if (clearFlags & CfVertices)
-		m_vertices.clear();
+		m_vertices.write().clear();
 	if (clearFlags & CfPolygons)
-		m_polygons.resize(0);
+		m_polygons.write().resize(0);
 	if (clearFlags & CfPositions)
-		m_positions.clear();
+		m_positions.write().clear();
 	if (clearFlags & CfColors)
-		m_colors.clear();
+		m_colors.write().clear();
 	if (clearFlags & CfNormals)
-		m_normals.clear();
+		m_normals.write().clear();
 	if (clearFlags & CfTexCoords)
-		m_texCoords.clear();
+		m_texCoords.write().clear();
 	if (clearFlags & CfJoints)
-		m_joints.resize(0);
+		m_joints.write().resize(0);
 
 	if ((clearFlags & (CfPositions | CfColors | CfNormals | CfTexCoords | CfJoints)) != 0)
 	{
-		AlignedVector< Vertex > vertices = m_vertices.values();
+		AlignedVector< Vertex > vertices = m_vertices.read().values();
 		for (auto& vertex : vertices)
 		{
 			if (clearFlags & CfPositions)
@@ -127,10 +127,10 @@ void Model::clear(uint32_t clearFlags)
 			if (clearFlags & CfJoints)
 				vertex.clearJointInfluences();
 		}
-		m_vertices.replace(vertices);
+		m_vertices.write().replace(vertices);
 	}
 
-	for (auto& polygon : m_polygons)
+	for (auto& polygon : m_polygons.write())
 	{
 		if (clearFlags & CfMaterials)
 			polygon.setMaterial(c_InvalidIndex);
@@ -144,27 +144,27 @@ void Model::clear(uint32_t clearFlags)
 Aabb3 Model::getBoundingBox() const
 {
 	Aabb3 boundingBox;
-	for (const auto& position : m_positions.values())
+	for (const auto& position : m_positions.read().values())
 		boundingBox.contain(position);
 	return boundingBox;
 }
 
 uint32_t Model::addMaterial(const Material& material)
 {
-	return addId(m_materials, material);
+	return addId(m_materials.write(), material);
 }
 
 uint32_t Model::addUniqueMaterial(const Material& material)
 {
-	return addUniqueId(m_materials, material, MaterialPredicate());
+	return addUniqueId(m_materials.write(), material, MaterialPredicate());
 }
 
 bool Model::removeMaterial(uint32_t index)
 {
-	if (index >= m_materials.size())
+	if (index >= m_materials.read().size())
 		return false;
 
-	for (auto& polygon : m_polygons)
+	for (auto& polygon : m_polygons.write())
 	{
 		const uint32_t m = polygon.getMaterial();
 		if (m > index)
@@ -173,89 +173,90 @@ bool Model::removeMaterial(uint32_t index)
 			polygon.setMaterial(c_InvalidIndex);
 	}
 
-	m_materials.erase(m_materials.begin() + index);
+	auto& materials = m_materials.write();
+	materials.erase(materials.begin() + index);
 	return true;
 }
 
 uint32_t Model::addVertex(const Vertex& vertex)
 {
-	return m_vertices.add(vertex);
+	return m_vertices.write().add(vertex);
 }
 
 uint32_t Model::addUniqueVertex(const Vertex& vertex)
 {
-	const uint32_t id = m_vertices.find(vertex);
-	return id != m_vertices.InvalidIndex ? id : m_vertices.add(vertex);
+	const uint32_t id = m_vertices.read().find(vertex);
+	return id != c_InvalidIndex ? id : m_vertices.write().add(vertex);
 }
 
 uint32_t Model::addPolygon(const Polygon& polygon)
 {
-	return addId(m_polygons, polygon);
+	return addId(m_polygons.write(), polygon);
 }
 
 uint32_t Model::addUniquePolygon(const Polygon& polygon)
 {
-	return addUniqueId< AlignedVector< Polygon >, Polygon, DefaultPredicate< Polygon > >(m_polygons, polygon);
+	return addUniqueId< AlignedVector< Polygon >, Polygon, DefaultPredicate< Polygon > >(m_polygons.write(), polygon);
 }
 
 void Model::reservePositions(uint32_t positionCapacity)
 {
-	m_positions.reserve(positionCapacity);
+	m_positions.write().reserve(positionCapacity);
 }
 
 uint32_t Model::addPosition(const Vector4& position)
 {
-	return m_positions.add(position);
+	return m_positions.write().add(position);
 }
 
 uint32_t Model::addUniquePosition(const Vector4& position, float distance)
 {
-	const uint32_t id = m_positions.get(position, distance);
-	return id != m_positions.InvalidIndex ? id : m_positions.add(position);
+	const uint32_t id = m_positions.read().get(position, distance);
+	return id != c_InvalidIndex ? id : m_positions.write().add(position);
 }
 
 uint32_t Model::addColor(const Vector4& color)
 {
-	return m_colors.add(color);
+	return m_colors.write().add(color);
 }
 
 uint32_t Model::addUniqueColor(const Vector4& color)
 {
-	const uint32_t id = m_colors.get(color, 1.0f / (4.0f * 256.0f));
-	return id != m_colors.InvalidIndex ? id : m_colors.add(color);
+	const uint32_t id = m_colors.read().get(color, 1.0f / (4.0f * 256.0f));
+	return id != c_InvalidIndex ? id : m_colors.write().add(color);
 }
 
 void Model::reserveColors(uint32_t colorCapacity)
 {
-	m_colors.reserve(colorCapacity);
+	m_colors.write().reserve(colorCapacity);
 }
 
 uint32_t Model::addNormal(const Vector4& normal)
 {
-	return m_normals.add(normal);
+	return m_normals.write().add(normal);
 }
 
 uint32_t Model::addUniqueNormal(const Vector4& normal)
 {
 	const Vector4 quantizedNormal = ((normal * 255.0_simd).floor() / 255.0_simd).xyz0();
-	const uint32_t id = m_normals.get(quantizedNormal, 0.1f / 255.0f);
-	return id != m_normals.InvalidIndex ? id : m_normals.add(quantizedNormal);
+	const uint32_t id = m_normals.read().get(quantizedNormal, 0.1f / 255.0f);
+	return id != c_InvalidIndex ? id : m_normals.write().add(quantizedNormal);
 }
 
 void Model::reserveNormals(uint32_t normalCapacity)
 {
-	m_normals.reserve(normalCapacity);
+	m_normals.write().reserve(normalCapacity);
 }
 
 uint32_t Model::addTexCoord(const Vector2& texCoord)
 {
-	return m_texCoords.add(texCoord);
+	return m_texCoords.write().add(texCoord);
 }
 
 uint32_t Model::addUniqueTexCoord(const Vector2& texCoord)
 {
-	const uint32_t id = m_texCoords.get(texCoord);
-	return id != m_texCoords.InvalidIndex ? id : m_texCoords.add(texCoord);
+	const uint32_t id = m_texCoords.read().get(texCoord);
+	return id != c_InvalidIndex ? id : m_texCoords.write().add(texCoord);
 }
 
 uint32_t Model::addUniqueTexCoordChannel(const std::wstring& channelId)
@@ -277,58 +278,62 @@ uint32_t Model::getTexCoordChannel(const std::wstring& channelId) const
 
 uint32_t Model::addJoint(const Joint& joint)
 {
-	return addId(m_joints, joint);
+	return addId(m_joints.write(), joint);
 }
 
 uint32_t Model::addUniqueJoint(const Joint& joint)
 {
-	return addUniqueId< AlignedVector< Joint >, Joint, DefaultPredicate< Joint > >(m_joints, joint);
+	return addUniqueId< AlignedVector< Joint >, Joint, DefaultPredicate< Joint > >(m_joints.write(), joint);
 }
 
 void Model::setJoints(const AlignedVector< Joint >& joints)
 {
-	m_joints = joints;
+	m_joints.write() = joints;
 }
 
 uint32_t Model::findJointIndex(const std::wstring& jointName) const
 {
-	const auto i = std::find_if(m_joints.begin(), m_joints.end(), [&](const Joint& j) {
+	const auto& joints = m_joints.read();
+	const auto i = std::find_if(joints.begin(), joints.end(), [&](const Joint& j) {
 		return j.getName() == jointName;
 	});
-	return i != m_joints.end() ? uint32_t(std::distance(m_joints.begin(), i)) : c_InvalidIndex;
+	return i != joints.end() ? uint32_t(std::distance(joints.begin(), i)) : c_InvalidIndex;
 }
 
 void Model::findChildJoints(uint32_t jointId, AlignedVector< uint32_t >& outChildJoints) const
 {
-	for (uint32_t i = 0; i < m_joints.size(); ++i)
+	const auto& joints = m_joints.read();
+	for (uint32_t i = 0; i < joints.size(); ++i)
 	{
-		if (m_joints[i].getParent() == jointId)
+		if (joints[i].getParent() == jointId)
 			outChildJoints.push_back(i);
 	}
 }
 
 Transform Model::getJointGlobalTransform(uint32_t jointId) const
 {
+	const auto& joints = m_joints.read();
 	Transform Tglobal = Transform::identity();
 	while (jointId != c_InvalidIndex)
 	{
-		Tglobal = m_joints[jointId].getTransform() * Tglobal;	// ABC order (A root)
-		jointId = m_joints[jointId].getParent();
+		Tglobal = joints[jointId].getTransform() * Tglobal;	// ABC order (A root)
+		jointId = joints[jointId].getParent();
 	}
 	return Tglobal;
 }
 
 void Model::setJointRotation(uint32_t jointId, const Quaternion& rotation)
 {
-	Joint& joint = m_joints[jointId];
+	auto& joints = m_joints.write();
+	Joint& joint = joints[jointId];
 
 	const Transform Tcurr = joint.getTransform();
 	const Transform Tnext(Tcurr.translation(), rotation);
 	joint.setTransform(Tnext);
 
-	for (uint32_t i = 0; i < (uint32_t)m_joints.size(); ++i)
+	for (uint32_t i = 0; i < (uint32_t)joints.size(); ++i)
 	{
-		Joint& child = m_joints[i];
+		Joint& child = joints[i];
 		if (child.getParent() == jointId)
 		{
 			const Transform Tchild = Tnext.inverse() * Tcurr * child.getTransform();
@@ -336,8 +341,10 @@ void Model::setJointRotation(uint32_t jointId, const Quaternion& rotation)
 		}
 	}
 
-	for (auto animation : m_animations)
+	for (uint32_t k = 0; k < (uint32_t)m_animations.size(); ++k)
 	{
+		Animation* animation = editAnimation(k);
+
 		for (uint32_t i = 0; i < animation->getKeyFrameCount(); ++i)
 		{
 			Ref< Pose > pose = new Pose(*animation->getKeyFramePose(i));
@@ -353,9 +360,9 @@ void Model::setJointRotation(uint32_t jointId, const Quaternion& rotation)
 			pose->setJointTransform(jointId, TposeNew);
 
 			const Transform TposeDelta = TposeNew.inverse() * TposeCurr;
-			for (uint32_t j = 0; j < (uint32_t)m_joints.size(); ++j)
+			for (uint32_t j = 0; j < (uint32_t)joints.size(); ++j)
 			{
-				const Joint& child = m_joints[j];
+				const Joint& child = joints[j];
 				if (child.getParent() == jointId)
 				{
 					const Transform tmp0 = pose->getJointTransform(j);
@@ -376,6 +383,14 @@ uint32_t Model::addAnimation(Animation* animation)
 	return id;
 }
 
+Animation* Model::editAnimation(uint32_t animationIndex)
+{
+	// Animations might be shared with other models; modify a copy.
+	Ref< Animation > animation = new Animation(*m_animations[animationIndex]);
+	m_animations[animationIndex] = animation;
+	return animation;
+}
+
 const Animation* Model::findAnimation(const std::wstring& animationName) const
 {
 	const auto i = std::find_if(m_animations.begin(), m_animations.end(), [&](const Animation* anim) {
@@ -393,13 +408,13 @@ uint32_t Model::addBlendTarget(const std::wstring& blendTargetName)
 	m_blendTargets.push_back(blendTargetName);
 	const uint32_t id = uint32_t(m_blendTargets.size() - 1);
 
-	m_blendTargetPositions[id] = m_positions.values();
+	m_blendTargetPositions.write()[id] = m_positions.read().values();
 	return id;
 }
 
 void Model::setBlendTargetPosition(uint32_t blendTargetIndex, uint32_t positionIndex, const Vector4& position)
 {
-	AlignedVector< Vector4 >& positions = m_blendTargetPositions[blendTargetIndex];
+	AlignedVector< Vector4 >& positions = m_blendTargetPositions.write()[blendTargetIndex];
 	if (positionIndex >= positions.size())
 		positions.resize(positionIndex + 1);
 	positions[positionIndex] = position;
@@ -407,8 +422,9 @@ void Model::setBlendTargetPosition(uint32_t blendTargetIndex, uint32_t positionI
 
 const Vector4& Model::getBlendTargetPosition(uint32_t blendTargetIndex, uint32_t positionIndex) const
 {
-	auto it = m_blendTargetPositions.find(blendTargetIndex);
-	if (it != m_blendTargetPositions.end())
+	const auto& blendTargetPositions = m_blendTargetPositions.read();
+	auto it = blendTargetPositions.find(blendTargetIndex);
+	if (it != blendTargetPositions.end())
 		return it->second[positionIndex];
 	else
 		return Vector4::origo();
@@ -419,55 +435,67 @@ void Model::serialize(ISerializer& s)
 	if (s.getVersion< Model >() >= 1)
 		PropertyGroup::serialize(s);
 
-	s >> MemberAlignedVector< Material, MemberComposite< Material > >(L"materials", m_materials);
-
 	if (s.getDirection() == ISerializer::Direction::Read)
 	{
+		s >> MemberAlignedVector< Material, MemberComposite< Material > >(L"materials", m_materials.write());
+
 		AlignedVector< Vertex > vertices;
 		s >> MemberAlignedVector< Vertex, MemberComposite< Vertex > >(L"vertices", vertices);
-		m_vertices.swap(vertices);
+		m_vertices.write().swap(vertices);
 
-		s >> MemberAlignedVector< Polygon, MemberComposite< Polygon > >(L"polygons", m_polygons);
+		s >> MemberAlignedVector< Polygon, MemberComposite< Polygon > >(L"polygons", m_polygons.write());
 
 		AlignedVector< Vector4 > positions;
 		s >> MemberAlignedVector< Vector4 >(L"positions", positions);
-		m_positions.swap(positions);
+		m_positions.write().swap(positions);
 
 		AlignedVector< Vector4 > colors;
 		s >> MemberAlignedVector< Vector4 >(L"colors", colors);
-		m_colors.swap(colors);
+		m_colors.write().swap(colors);
 
 		AlignedVector< Vector4 > normals;
 		s >> MemberAlignedVector< Vector4 >(L"normals", normals);
-		m_normals.swap(normals);
+		m_normals.write().swap(normals);
 
 		AlignedVector< Vector2 > texCoords;
 		s >> MemberAlignedVector< Vector2 >(L"texCoords", texCoords);
-		m_texCoords.swap(texCoords);
+		m_texCoords.write().swap(texCoords);
 	}
 	else // ISerializer::Direction::Write
 	{
-		auto& values = const_cast< AlignedVector< Vertex >& >(m_vertices.values());
+		// Writing doesn't modify model thus we access shared data
+		// directly to prevent it being copied.
+		auto& materials = const_cast< AlignedVector< Material >& >(m_materials.read());
+		s >> MemberAlignedVector< Material, MemberComposite< Material > >(L"materials", materials);
+
+		auto& values = const_cast< AlignedVector< Vertex >& >(m_vertices.read().values());
 		s >> MemberAlignedVector< Vertex, MemberComposite< Vertex > >(L"vertices", values);
 
-		s >> MemberAlignedVector< Polygon, MemberComposite< Polygon > >(L"polygons", m_polygons);
+		auto& polygons = const_cast< AlignedVector< Polygon >& >(m_polygons.read());
+		s >> MemberAlignedVector< Polygon, MemberComposite< Polygon > >(L"polygons", polygons);
 
-		auto& positions = const_cast< AlignedVector< Vector4 >& >(m_positions.values());
+		auto& positions = const_cast< AlignedVector< Vector4 >& >(m_positions.read().values());
 		s >> MemberAlignedVector< Vector4 >(L"positions", positions);
 
-		auto& colors = const_cast< AlignedVector< Vector4 >& >(m_colors.values());
+		auto& colors = const_cast< AlignedVector< Vector4 >& >(m_colors.read().values());
 		s >> MemberAlignedVector< Vector4 >(L"colors", colors);
 
-		auto& normals = const_cast< AlignedVector< Vector4 >& >(m_normals.values());
+		auto& normals = const_cast< AlignedVector< Vector4 >& >(m_normals.read().values());
 		s >> MemberAlignedVector< Vector4 >(L"normals", normals);
 
-		auto& texCoords = const_cast< AlignedVector< Vector2 >& >(m_texCoords.values());
+		auto& texCoords = const_cast< AlignedVector< Vector2 >& >(m_texCoords.read().values());
 		s >> MemberAlignedVector< Vector2 >(L"texCoords", texCoords);
 	}
 
 	s >> MemberAlignedVector< std::wstring >(L"texCoordChannels", m_texCoordChannels);
 
-	s >> MemberAlignedVector< Joint, MemberComposite< Joint > >(L"joints", m_joints);
+	if (s.getDirection() == ISerializer::Direction::Read)
+		s >> MemberAlignedVector< Joint, MemberComposite< Joint > >(L"joints", m_joints.write());
+	else
+	{
+		auto& joints = const_cast< AlignedVector< Joint >& >(m_joints.read());
+		s >> MemberAlignedVector< Joint, MemberComposite< Joint > >(L"joints", joints);
+	}
 
 	s >> MemberRefArray< Animation >(L"animations", m_animations);
 
@@ -478,7 +506,7 @@ void Model::serialize(ISerializer& s)
 		AlignedVector< Vector4 >,
 		Member< uint32_t >,
 		MemberAlignedVector< Vector4 >
-	>(L"blendTargetPositions", m_blendTargetPositions);
+	>(L"blendTargetPositions", m_blendTargetPositions.write());
 
 #if defined(_DEBUG)
 	if (s.getDirection() == ISerializer::Direction::Read)
@@ -488,20 +516,21 @@ void Model::serialize(ISerializer& s)
 
 void Model::validate() const
 {
-	for (const auto& indices : m_vertices.indices())
+	const auto& vertices = m_vertices.read();
+	for (const auto& indices : vertices.indices())
 	{
 		T_FATAL_ASSERT(!indices.second.empty());
 		for (auto vertexId : indices.second)
-			T_FATAL_ASSERT(vertexId < m_vertices.size());
+			T_FATAL_ASSERT(vertexId < vertices.size());
 	}
 
-	for (const auto& polygon : m_polygons)
+	for (const auto& polygon : m_polygons.read())
 	{
 		T_FATAL_ASSERT(polygon.getVertexCount() > 0);
-		T_FATAL_ASSERT(polygon.getMaterial() < m_materials.size());
+		T_FATAL_ASSERT(polygon.getMaterial() < m_materials.read().size());
 
 		for (auto vertexId : polygon.getVertices())
-			T_FATAL_ASSERT(vertexId < m_vertices.size());
+			T_FATAL_ASSERT(vertexId < vertices.size());
 	}
 }
 
@@ -14,6 +14,7 @@
 #include "Core/Settings/PropertyGroup.h"
 #include "Model/Animation.h"
 #include "Model/Types.h"
+#include "Model/CopyOnWrite.h"
 #include "Model/Grid2.h"
 #include "Model/Grid3.h"
 #include "Model/HashVector.h"
@@ -56,6 +57,13 @@ public:
 
 	Model();
 
+	/*! Copy model.
+	 *
+	 * Geometry is shared with source model until
+	 * modified, thus copying is cheap.
+	 */
+	Model(const Model& model) = default;
+
 	void clear(uint32_t clearFlags = CfAll);
 
 	Aabb3 getBoundingBox() const;
@@ -69,59 +77,61 @@ public:
 
 	bool removeMaterial(uint32_t index);
 
-	const Material& getMaterial(uint32_t index) const { return m_materials[index]; }
+	const Material& getMaterial(uint32_t index) const { return m_materials.read()[index]; }
 
-	uint32_t getMaterialCount() const { return uint32_t(m_materials.size()); }
+	uint32_t getMaterialCount() const { return uint32_t(m_materials.read().size()); }
 
-	void setMaterials(const AlignedVector< Material >& materials) { m_materials = materials; }
+	void setMaterials(const AlignedVector< Material >& materials) { m_materials.write() = materials; }
 
-	const AlignedVector< Material >& getMaterials() const { return m_materials; }
+	const AlignedVector< Material >& getMaterials() const { return m_materials.read(); }
 
-	AlignedVector< Material >& getMaterials() { return m_materials; }
+	/*! Get mutable materials, detach from shared copies. */
+	AlignedVector< Material >& editMaterials() { return m_materials.write(); }
 
 	//!@}
 
 	/*! \name Vertices */
 	//!@{
 
-	void reserveVertices(uint32_t vertexCapacity) { m_vertices.reserve(vertexCapacity); }
+	void reserveVertices(uint32_t vertexCapacity) { m_vertices.write().reserve(vertexCapacity); }
 
 	uint32_t addVertex(const Vertex& vertex);
 
 	uint32_t addUniqueVertex(const Vertex& vertex);
 
-	void setVertex(uint32_t index, const Vertex& vertex) { m_vertices.set(index, vertex); }
+	void setVertex(uint32_t index, const Vertex& vertex) { m_vertices.write().set(index, vertex); }
 
-	const Vertex& getVertex(uint32_t index) const { return m_vertices[index]; }
+	const Vertex& getVertex(uint32_t index) const { return m_vertices.read()[index]; }
 
-	uint32_t getVertexCount() const { return uint32_t(m_vertices.size()); }
+	uint32_t getVertexCount() const { return uint32_t(m_vertices.read().size()); }
 
-	void setVertices(const AlignedVector< Vertex >& vertices) { m_vertices.replace(vertices); }
+	void setVertices(const AlignedVector< Vertex >& vertices) { m_vertices.write().replace(vertices); }
 
-	const AlignedVector< Vertex >& getVertices() const { return m_vertices.values(); }
+	const AlignedVector< Vertex >& getVertices() const { return m_vertices.read().values(); }
 
 	//!@}
 
 	/*! \name Polygons */
 	//!@{
 
-	void reservePolygons(uint32_t polygonCapacity) { m_polygons.reserve(polygonCapacity); }
+	void reservePolygons(uint32_t polygonCapacity) { m_polygons.write().reserve(polygonCapacity); }
 
 	uint32_t addPolygon(const Polygon& polygon);
 
 	uint32_t addUniquePolygon(const Polygon& polygon);
 
-	void setPolygon(uint32_t index, const Polygon& polygon) { m_polygons[index] = polygon; }
+	void setPolygon(uint32_t index, const Polygon& polygon) { m_polygons.write()[index] = polygon; }
 
-	const Polygon& getPolygon(uint32_t index) const { return m_polygons[index]; }
+	const Polygon& getPolygon(uint32_t index) const { return m_polygons.read()[index]; }
 
-	uint32_t getPolygonCount() const { return uint32_t(m_polygons.size()); }
+	uint32_t getPolygonCount() const { return uint32_t(m_polygons.read().size()); }
 
-	void setPolygons(const AlignedVector< Polygon >& polygons) { m_polygons = polygons; }
+	void setPolygons(const AlignedVector< Polygon >& polygons) { m_polygons.write() = polygons; }
 
-	const AlignedVector< Polygon >& getPolygons() const { return m_polygons; }
+	const AlignedVector< Polygon >& getPolygons() const { return m_polygons.read(); }
 
-	AlignedVector< Polygon >& getPolygons() { return m_polygons; }
+	/*! Get mutable polygons, detach from shared copies. */
+	AlignedVector< Polygon >& editPolygons() { return m_polygons.write(); }
 
 	//!@}
 
@@ -134,17 +144,17 @@ public:
 
 	uint32_t addUniquePosition(const Vector4& position, float distance = 0.01f);
 
-	uint32_t getPositionCount() const { return m_positions.size(); }
+	uint32_t getPositionCount() const { return m_positions.read().size(); }
 
-	void setPosition(uint32_t index, const Vector4& position) { m_positions.set(index, position); }
+	void setPosition(uint32_t index, const Vector4& position) { m_positions.write().set(index, position); }
 
-	const Vector4& getPosition(uint32_t index) const { return m_positions.get(index, Vector4::zero()); }
+	const Vector4& getPosition(uint32_t index) const { return m_positions.read().get(index, Vector4::zero()); }
 
 	const Vector4& getVertexPosition(uint32_t vertexIndex) const { return getPosition(getVertex(vertexIndex).getPosition()); }
 
-	void setPositions(const AlignedVector< Vector4 >& positions) { m_positions.replace(positions); }
+	void setPositions(const AlignedVector< Vector4 >& positions) { m_positions.write().replace(positions); }
 
-	const AlignedVector< Vector4 >& getPositions() const { return m_positions.values(); }
+	const AlignedVector< Vector4 >& getPositions() const { return m_positions.read().values(); }
 
 	//!@}
 
@@ -155,13 +165,13 @@ public:
 
 	uint32_t addUniqueColor(const Vector4& color);
 
-	uint32_t getColorCount() const { return m_colors.size(); }
+	uint32_t getColorCount() const { return m_colors.read().size(); }
 
-	const Vector4& getColor(uint32_t index) const { return m_colors.get(index, Vector4::zero()); }
+	const Vector4& getColor(uint32_t index) const { return m_colors.read().get(index, Vector4::zero()); }
 
-	void setColors(const AlignedVector< Vector4 >& colors) { m_colors.replace(colors); }
+	void setColors(const AlignedVector< Vector4 >& colors) { m_colors.write().replace(colors); }
 
-	const AlignedVector< Vector4 >& getColors() const { return m_colors.values(); }
+	const AlignedVector< Vector4 >& getColors() const { return m_colors.read().values(); }
 
 	void reserveColors(uint32_t colorCapacity);
 
@@ -174,13 +184,13 @@ public:
 
 	uint32_t addUniqueNormal(const Vector4& normal);
 
-	uint32_t getNormalCount() const { return m_normals.size(); }
+	uint32_t getNormalCount() const { return m_normals.read().size(); }
 
-	const Vector4& getNormal(uint32_t index) const { return m_normals.get(index, Vector4::zero()); }
+	const Vector4& getNormal(uint32_t index) const { return m_normals.read().get(index, Vector4::zero()); }
 
-	void setNormals(const AlignedVector< Vector4 >& normals) { m_normals.replace(normals); }
+	void setNormals(const AlignedVector< Vector4 >& normals) { m_normals.write().replace(normals); }
 
-	const AlignedVector< Vector4 >& getNormals() const { return m_normals.values(); }
+	const AlignedVector< Vector4 >& getNormals() const { return m_normals.read().values(); }
 
 	void reserveNormals(uint32_t normalCapacity);
 
@@ -193,11 +203,11 @@ public:
 
 	uint32_t addUniqueTexCoord(const Vector2& texCoord);
 
-	const Vector2& getTexCoord(uint32_t index) const { return m_texCoords.get(index, Vector2::zero()); }
+	const Vector2& getTexCoord(uint32_t index) const { return m_texCoords.read().get(index, Vector2::zero()); }
 
-	void setTexCoords(const AlignedVector< Vector2 >& texCoords) { m_texCoords.replace(texCoords); }
+	void setTexCoords(const AlignedVector< Vector2 >& texCoords) { m_texCoords.write().replace(texCoords); }
 
-	const AlignedVector< Vector2 >& getTexCoords() const { return m_texCoords.values(); }
+	const AlignedVector< Vector2 >& getTexCoords() const { return m_texCoords.read().values(); }
 
 	uint32_t addUniqueTexCoordChannel(const std::wstring& channelId);
 
@@ -216,13 +226,13 @@ public:
 
 	uint32_t addUniqueJoint(const Joint& joint);
 
-	uint32_t getJointCount() const { return (uint32_t)m_joints.size(); }
+	uint32_t getJointCount() const { return (uint32_t)m_joints.read().size(); }
 
-	const Joint& getJoint(uint32_t jointIndex) const { return m_joints[jointIndex]; }
+	const Joint& getJoint(uint32_t jointIndex) const { return m_joints.read()[jointIndex]; }
 
 	void setJoints(const AlignedVector< Joint >& joints);
 
-	const AlignedVector< Joint >& getJoints() const { return m_joints; }
+	const AlignedVector< Joint >& getJoints() const { return m_joints.read(); }
 
 	uint32_t findJointIndex(const std::wstring& jointName) const;
 
@@ -243,6 +253,9 @@ public:
 
 	const Animation* getAnimation(uint32_t animationIndex) const { return m_animations[animationIndex]; }
 
+	/*! Get mutable animation, animation is copied first since it might be shared with other models. */
+	Animation* editAnimation(uint32_t animationIndex);
+
 	const Animation* findAnimation(const std::wstring& animationName) const;
 
 	const RefArray< Animation >& getAnimations() const { return m_animations; }
@@ -267,18 +280,18 @@ public:
 	virtual void serialize(ISerializer& s) override final;
 
 private:
-	AlignedVector< Material > m_materials;
-	HashVector< Vertex, VertexHashFunction > m_vertices;
-	AlignedVector< Polygon > m_polygons;
-	Grid3< Vector4 > m_positions;
-	Grid3< Vector4 > m_colors;
-	Grid3< Vector4 > m_normals;
-	Grid2< Vector2 > m_texCoords;
+	CopyOnWrite< AlignedVector< Material > > m_materials;
+	CopyOnWrite< HashVector< Vertex, VertexHashFunction > > m_vertices;
+	CopyOnWrite< AlignedVector< Polygon > > m_polygons;
+	CopyOnWrite< Grid3< Vector4 > > m_positions;
+	CopyOnWrite< Grid3< Vector4 > > m_colors;
+	CopyOnWrite< Grid3< Vector4 > > m_normals;
+	CopyOnWrite< Grid2< Vector2 > > m_texCoords;
 	AlignedVector< std::wstring > m_texCoordChannels;
-	AlignedVector< Joint > m_joints;
+	CopyOnWrite< AlignedVector< Joint > > m_joints;
 	RefArray< Animation > m_animations;
 	AlignedVector< std::wstring > m_blendTargets;
-	SmallMap< uint32_t, AlignedVector< Vector4 > > m_blendTargetPositions;
+	CopyOnWrite< SmallMap< uint32_t, AlignedVector< Vector4 > > > m_blendTargetPositions;
 
 	void validate() const;
 };
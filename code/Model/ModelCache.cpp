@@ -11,7 +11,6 @@
 #include "Core/Misc/Murmur3.h"
 #include "Core/Misc/String.h"
 #include "Core/Serialization/BinarySerializer.h"
-#include "Core/Serialization/DeepClone.h"
 #include "Core/Singleton/SingletonManager.h"
 #include "Core/Thread/Acquire.h"
 #include "Core/Thread/JobManager.h"
@@ -24,6 +23,8 @@ namespace traktor::model
 	namespace
 	{
 
+const uint64_t c_defaultMemoryBudget = 1024ULL * 1024ULL * 1024ULL;
+
 uint32_t hash(const std::wstring& text)
 {
 	Murmur3 cs;
@@ -33,6 +34,21 @@ uint32_t hash(const std::wstring& text)
 	return cs.get();
 }
 
+/*! Estimate memory used by model, not accurate but good enough to enforce budget. */
+uint64_t estimateMemoryUsage(const Model* model)
+{
+	uint64_t memoryUsage = sizeof(Model);
+	memoryUsage += model->getMaterialCount() * sizeof(Material);
+	memoryUsage += model->getVertexCount() * (sizeof(Vertex) + 2 * sizeof(uint32_t));
+	memoryUsage += model->getPolygonCount() * sizeof(Polygon);
+	memoryUsage += (model->getPositionCount() + model->getColorCount() + model->getNormalCount()) * (sizeof(Vector4) + sizeof(uint32_t));
+	memoryUsage += model->getTexCoords().size() * (sizeof(Vector2) + sizeof(uint32_t));
+	memoryUsage += model->getJointCount() * sizeof(Joint);
+	for (auto animation : model->getAnimations())
+		memoryUsage += animation->getKeyFrameCount() * model->getJointCount() * sizeof(Transform);
+	return memoryUsage;
+}
+
 	}
 
 ModelCache& ModelCache::getInstance()
@@ -51,6 +67,12 @@ void ModelCache::destroy()
 	delete this;
 }
 
+void ModelCache::setMemoryBudget(uint64_t memoryBudget)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	m_memoryBudget = memoryBudget;
+}
+
 Ref< const Model > ModelCache::get(const Path& cachePath, const Path& fileName, const std::wstring& filter)
 {
 	const auto key = std::make_pair(fileName, filter);
@@ -61,11 +83,16 @@ Ref< const Model > ModelCache::get(const Path& cachePath, const Path& fileName,
 		return nullptr;
 
 	// First check if we have recent model loaded into memory.
-	auto it = m_models.find(key);
-	if (it != m_models.end())
 	{
-		if (it->second.timeStamp >= file->getLastWriteTime())
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		auto it = m_models.find(key);
+		if (it != m_models.end() && it->second.timeStamp >= file->getLastWriteTime())
+		{
+			it->second.lastUsed = ++m_tick;
+			m_statistics.hits++;
 			return it->second.model;
+		}
+		m_statistics.misses++;
 	}
 
 	// Calculate hash of resolved file name.
@@ -87,9 +114,10 @@ Ref< const Model > ModelCache::get(const Path& cachePath, const Path& fileName,
 		// Valid cache entry found; read from model from cache,
 		// do not use filter as it's written into cache after filter has been applied.
 		Ref< const Model > model = ModelFormat::readAny(cachedFileName, L"");
+		if (model)
 		{
 			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
-			m_models.insert(key, { model, file->getLastWriteTime() });
+			insert(key, model, file->getLastWriteTime());
 		}
 		return model;
 	}
@@ -103,7 +131,7 @@ Ref< const Model > ModelCache::get(const Path& cachePath, const Path& fileName,
 		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 
 		// Add model to memory map.
-		m_models.insert(key, { model, file->getLastWriteTime() });
+		insert(key, model, file->getLastWriteTime());
 
 		// Write cached copy of post-operation model.
 		const Path intermediateFileName = cachedFileName.getPathNameNoExtension() + L"~." + cachedFileName.getExtension();
@@ -131,7 +159,51 @@ Ref< const Model > ModelCache::get(const Path& cachePath, const Path& fileName,
 Ref< Model > ModelCache::getMutable(const Path& cachePath, const Path& fileName, const std::wstring& filter)
 {
 	Ref< const Model > model = get(cachePath, fileName, filter);
-	return model != nullptr ? DeepClone(model).create< Model >() : nullptr;
+	return model != nullptr ? new Model(*model) : nullptr;
+}
+
+ModelCache::Statistics ModelCache::getStatistics() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	Statistics statistics = m_statistics;
+	statistics.count = (uint32_t)m_models.size();
+	statistics.memoryUsage = m_memoryUsage;
+	return statistics;
+}
+
+ModelCache::ModelCache()
+:	m_memoryBudget(c_defaultMemoryBudget)
+{
+}
+
+void ModelCache::insert(const key_t& key, const Model* model, const DateTime& timeStamp)
+{
+	// Replace outdated model.
+	auto it = m_models.find(key);
+	if (it != m_models.end())
+	{
+		m_memoryUsage -= it->second.memoryUsage;
+		m_models.erase(it);
+	}
+
+	const uint64_t memoryUsage = estimateMemoryUsage(model);
+	m_models.insert(key, { model, timeStamp, memoryUsage, ++m_tick });
+	m_memoryUsage += memoryUsage;
+
+	// Evict least recently used models until we're within budget,
+	// always keep the model just inserted.
+	while (m_memoryUsage > m_memoryBudget && m_models.size() > 1)
+	{
+		auto lru = m_models.end();
+		for (auto it = m_models.begin(); it != m_models.end(); ++it)
+		{
+			if (lru == m_models.end() || it->second.lastUsed < lru->second.lastUsed)
+				lru = it;
+		}
+		m_memoryUsage -= lru->second.memoryUsage;
+		m_models.erase(lru);
+		m_statistics.evictions++;
+	}
 }
 
 }
@@ -10,6 +10,7 @@
 
 #include "Core/Ref.h"
 #include "Core/RefArray.h"
+#include "Core/Containers/SmallMap.h"
 #include "Core/Date/DateTime.h"
 #include "Core/Io/Path.h"
 #include "Core/Singleton/ISingleton.h"
@@ -41,23 +42,58 @@ class Model;
 class T_DLLCLASS ModelCache : public ISingleton
 {
 public:
+	struct Statistics
+	{
+		uint32_t hits = 0;			//!< Number of requests served from memory.
+		uint32_t misses = 0;		//!< Number of requests which needed to read model.
+		uint32_t evictions = 0;		//!< Number of models evicted from memory.
+		uint32_t count = 0;			//!< Number of models in memory.
+		uint64_t memoryUsage = 0;	//!< Estimated memory used by models in memory.
+	};
+
 	static ModelCache& getInstance();
 
 	virtual void destroy();
 
+	/*! Set memory budget of models kept in memory.
+	 *
+	 * When budget is exceeded least recently used
+	 * models are evicted from memory.
+	 */
+	void setMemoryBudget(uint64_t memoryBudget);
+
 	Ref< const Model > get(const Path& cachePath, const Path& fileName, const std::wstring& filter);
 
+	/*! Get mutable copy of model.
+	 *
+	 * Geometry is shared with cached model until
+	 * modified thus only modified data is duplicated.
+	 */
 	Ref< Model > getMutable(const Path& cachePath, const Path& fileName, const std::wstring& filter);
 
+	Statistics getStatistics() const;
+
 private:
+	typedef std::pair< Path, std::wstring > key_t;
+
 	struct ModelWithStamp
 	{
 		Ref< const Model > model;
 		DateTime timeStamp;
+		uint64_t memoryUsage = 0;
+		uint64_t lastUsed = 0;
 	};
 
-	Semaphore m_lock;
-	SmallMap< std::pair< Path, std::wstring >, ModelWithStamp > m_models;
+	mutable Semaphore m_lock;
+	SmallMap< key_t, ModelWithStamp > m_models;
+	uint64_t m_memoryBudget;
+	uint64_t m_memoryUsage = 0;
+	uint64_t m_tick = 0;
+	Statistics m_statistics;
+
+	ModelCache();
+
+	void insert(const key_t& key, const Model* model, const DateTime& timeStamp);
 };
 
 }
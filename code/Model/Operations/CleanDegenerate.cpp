@@ -17,7 +17,7 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.model.CleanDegenerate", CleanDegenerate, IModel
 
 bool CleanDegenerate::apply(Model& model) const
 {
-	auto& polygons = model.getPolygons();
+	auto& polygons = model.editPolygons();
 	for (size_t i = 0; i < polygons.size(); )
 	{
 		Polygon& polygon = polygons[i];
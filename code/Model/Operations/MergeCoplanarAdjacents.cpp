@@ -30,7 +30,7 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.model.MergeCoplanarAdjacents", MergeCoplanarAdj
 
 bool MergeCoplanarAdjacents::apply(Model& model) const
 {
-	AlignedVector< Polygon >& polygons = model.getPolygons();
+	AlignedVector< Polygon >& polygons = model.editPolygons();
 	Winding3 w;
 	Plane p;
 
@@ -128,7 +128,7 @@ bool MergeModel::apply(Model& model) const
 		outputPolygons.push_back(outputPolygon);
 	}
 
-	AlignedVector< Polygon >& mergedPolygons = model.getPolygons();
+	AlignedVector< Polygon >& mergedPolygons = model.editPolygons();
 	mergedPolygons.reserve(mergedPolygons.size() + sourcePolygons.size());
 	mergedPolygons.insert(mergedPolygons.end(), outputPolygons.begin(), outputPolygons.end());
 
@@ -22,7 +22,7 @@ bool MergeTVertices::apply(Model& model) const
 	const auto& modelVertices = model.getVertices();
 	const auto& modelPositions = model.getPositions();
 
-	for (auto& polygon : model.getPolygons())
+	for (auto& polygon : model.editPolygons())
 	{
 		auto polygonVertices = polygon.getVertices();
 
@@ -283,7 +283,7 @@ bool Reduce::apply(Model& model) const
 	Triangulate().apply(model);
 
 	Ref< ModelAdjacency > adjacency = new ModelAdjacency(&model, ModelAdjacency::Mode::ByPosition);
-	AlignedVector< Polygon >& polygons = model.getPolygons();
+	AlignedVector< Polygon >& polygons = model.editPolygons();
 
 	// Calculate triangle errors.
 	AlignedVector< float > errors(polygons.size());
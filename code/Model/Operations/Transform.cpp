@@ -44,8 +44,7 @@ bool Transform::apply(Model& model) const
 	}
 	model.setJoints(joints);
 
-	auto animations = model.getAnimations();
-	if (!animations.empty())
+	if (model.getAnimationCount() > 0)
 	{
 		const Matrix44 transformZeroOffset(
 			m_transform.axisX(),
@@ -54,8 +53,9 @@ bool Transform::apply(Model& model) const
 			Vector4::origo()
 		);
 
-		for (auto animation : animations)
+		for (uint32_t k = 0; k < model.getAnimationCount(); ++k)
 		{
+			Animation* animation = model.editAnimation(k);
 			for (uint32_t i = 0; i < animation->getKeyFrameCount(); ++i)
 			{
 				Ref< Pose > pose = new Pose(*animation->getKeyFramePose(i));
@@ -21,7 +21,7 @@ bool Unweld::apply(Model& model) const
 	AlignedVector< Vertex > inputVertices = model.getVertices();
 
 	model.setVertices(AlignedVector< Vertex >());
-	for (auto& polygon : model.getPolygons())
+	for (auto& polygon : model.editPolygons())
 	{
 		auto polverts = polygon.getVertices();
 		for (auto& polvert : polverts)
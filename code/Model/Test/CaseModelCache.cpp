@@ -0,0 +1,115 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Io/FileSystem.h"
+#include "Core/Math/Matrix44.h"
+#include "Core/Test/MathCompare.h"
+#include "Model/Animation.h"
+#include "Model/Model.h"
+#include "Model/ModelCache.h"
+#include "Model/ModelFormat.h"
+#include "Model/Pose.h"
+#include "Model/Operations/Transform.h"
+#include "Model/Test/CaseModelCache.h"
+
+namespace traktor::model::test
+{
+	namespace
+	{
+
+const Path c_cachePath(L"CaseModelCache/Cache");
+const Path c_modelA(L"CaseModelCache/A.tmd");
+const Path c_modelB(L"CaseModelCache/B.tmd");
+
+Ref< Model > createModel()
+{
+	Ref< Model > model = new Model();
+
+	model->addMaterial(Material(L"Default"));
+	const uint32_t p0 = model->addPosition(Vector4(0.0f, 0.0f, 0.0f, 1.0f));
+	const uint32_t p1 = model->addPosition(Vector4(1.0f, 0.0f, 0.0f, 1.0f));
+	const uint32_t p2 = model->addPosition(Vector4(0.0f, 1.0f, 0.0f, 1.0f));
+	model->addPolygon(Polygon(
+		0,
+		model->addVertex(Vertex(p0)),
+		model->addVertex(Vertex(p1)),
+		model->addVertex(Vertex(p2))
+	));
+
+	const uint32_t root = model->addJoint(Joint(c_InvalidIndex, L"Root", traktor::Transform(Vector4(0.0f, 1.0f, 0.0f)), 1.0f));
+	model->addJoint(Joint(root, L"Child", traktor::Transform(Vector4(0.0f, 1.0f, 0.0f)), 1.0f));
+
+	Ref< Pose > pose = new Pose();
+	pose->setJointTransform(0, traktor::Transform(Vector4(0.0f, 1.0f, 0.0f)));
+	pose->setJointTransform(1, traktor::Transform(Vector4(0.0f, 1.0f, 0.0f)));
+
+	Ref< Animation > animation = new Animation();
+	animation->setName(L"Idle");
+	animation->insertKeyFrame(0.0f, pose);
+	model->addAnimation(animation);
+
+	return model;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.model.test.CaseModelCache", 0, CaseModelCache, traktor::test::Case)
+
+void CaseModelCache::run()
+{
+	ModelCache& modelCache = ModelCache::getInstance();
+
+	CASE_ASSERT(FileSystem::getInstance().makeAllDirectories(c_cachePath));
+	CASE_ASSERT(ModelFormat::writeAny(c_modelA, createModel()));
+	CASE_ASSERT(ModelFormat::writeAny(c_modelB, createModel()));
+
+	// Modifying a mutable copy must not affect cached model.
+	{
+		Ref< const Model > cached = modelCache.get(c_cachePath, c_modelA, L"");
+		CASE_ASSERT(cached != nullptr);
+		if (!cached)
+			return;
+
+		Ref< Model > mutableModel = modelCache.getMutable(c_cachePath, c_modelA, L"");
+		CASE_ASSERT(mutableModel != nullptr);
+		if (!mutableModel)
+			return;
+
+		CASE_ASSERT(Transform(traktor::scale(2.0f, 2.0f, 2.0f)).apply(*mutableModel));
+
+		CASE_ASSERT_COMPARE(mutableModel->getPosition(1).x(), 2.0f, traktor::test::fuzzyEqual);
+		CASE_ASSERT_COMPARE(mutableModel->getAnimation(0)->getKeyFramePose(0)->getJointTransform(0).translation().y(), 2.0f, traktor::test::fuzzyEqual);
+
+		Ref< const Model > cachedAgain = modelCache.get(c_cachePath, c_modelA, L"");
+		CASE_ASSERT(cachedAgain == cached);
+		CASE_ASSERT_COMPARE(cachedAgain->getPosition(1).x(), 1.0f, traktor::test::fuzzyEqual);
+		CASE_ASSERT_COMPARE(cachedAgain->getAnimation(0)->getKeyFramePose(0)->getJointTransform(0).translation().y(), 1.0f, traktor::test::fuzzyEqual);
+		CASE_ASSERT_COMPARE(cachedAgain->getAnimation(0)->getKeyFramePose(0)->getJointTransform(1).translation().y(), 1.0f, traktor::test::fuzzyEqual);
+	}
+
+	// Least recently used model is evicted when budget is exceeded.
+	{
+		modelCache.setMemoryBudget(1);
+
+		const ModelCache::Statistics before = modelCache.getStatistics();
+
+		CASE_ASSERT(modelCache.get(c_cachePath, c_modelB, L"") != nullptr);
+		CASE_ASSERT(modelCache.get(c_cachePath, c_modelB, L"") != nullptr);
+		CASE_ASSERT(modelCache.get(c_cachePath, c_modelA, L"") != nullptr);
+
+		const ModelCache::Statistics after = modelCache.getStatistics();
+		CASE_ASSERT_EQUAL(after.misses - before.misses, 2U);
+		CASE_ASSERT_EQUAL(after.hits - before.hits, 1U);
+		CASE_ASSERT_EQUAL(after.evictions - before.evictions, 2U);
+		CASE_ASSERT_EQUAL(after.count, 1U);
+
+		modelCache.setMemoryBudget(1024ULL * 1024ULL * 1024ULL);
+	}
+}
+
+}
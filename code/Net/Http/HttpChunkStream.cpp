@@ -15,30 +15,38 @@ namespace traktor::net
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.net.HttpChunkStream", HttpChunkStream, IStream)
 
-HttpChunkStream::HttpChunkStream(IStream* stream)
+HttpChunkStream::HttpChunkStream(IStream* stream, Mode mode)
 :	m_stream(stream)
+,	m_mode(mode)
 ,	m_available(-1)
 {
-	T_ASSERT(m_stream->canRead());
+	T_ASSERT(m_mode != Mode::Read || m_stream->canRead());
+	T_ASSERT(m_mode != Mode::Write || m_stream->canWrite());
 }
 
 void HttpChunkStream::close()
 {
 	if (m_stream)
 	{
-		m_stream->close();
+		if (m_mode == Mode::Write)
+		{
+			m_stream->write("0\r\n\r\n", 5);
+			m_stream->flush();
+		}
+		else
+			m_stream->close();
 		m_stream = nullptr;
 	}
 }
 
 bool HttpChunkStream::canRead() const
 {
-	return true;
+	return m_mode == Mode::Read;
 }
 
 bool HttpChunkStream::canWrite() const
 {
-	return false;
+	return m_mode == Mode::Write;
 }
 
 bool HttpChunkStream::canSeek() const
@@ -53,6 +61,9 @@ int64_t HttpChunkStream::tell() const
 
 int64_t HttpChunkStream::available() const
 {
+	if (m_mode != Mode::Read)
+		return 0;
+
 	if (m_available > 0)
 		return m_available;
 
@@ -66,6 +77,9 @@ int64_t HttpChunkStream::seek(SeekOriginType origin, int64_t offset)
 
 int64_t HttpChunkStream::read(void* block, int64_t nbytes)
 {
+	if (m_mode != Mode::Read)
+		return 0;
+
 	if (m_available == -1)
 	{
 		char buf[16];
@@ -95,7 +109,9 @@ int64_t HttpChunkStream::read(void* block, int64_t nbytes)
 #if defined(_MSC_VER)
 		sscanf_s(buf, "%I64x", &m_available);
 #else
-		std::sscanf(buf, "%x", &m_available);
+		unsigned long long available = 0;
+		std::sscanf(buf, "%llx", &available);
+		m_available = (int64_t)available;
 #endif
 	}
 
@@ -115,11 +131,32 @@ int64_t HttpChunkStream::read(void* block, int64_t nbytes)
 
 int64_t HttpChunkStream::write(const void* block, int64_t nbytes)
 {
-	return 0;
+	if (m_mode != Mode::Write || !m_stream)
+		return 0;
+
+	// Empty chunk would terminate stream.
+	if (nbytes <= 0)
+		return 0;
+
+	char buf[32];
+	const int32_t nbuf = std::snprintf(buf, sizeof(buf), "%llx\r\n", (unsigned long long)nbytes);
+	if (m_stream->write(buf, nbuf) != nbuf)
+		return -1;
+
+	const int64_t nwritten = m_stream->write(block, nbytes);
+	if (nwritten != nbytes)
+		return -1;
+
+	if (m_stream->write("\r\n", 2) != 2)
+		return -1;
+
+	return nwritten;
 }
 
 void HttpChunkStream::flush()
 {
+	if (m_mode == Mode::Write && m_stream)
+		m_stream->flush();
 }
 
 }
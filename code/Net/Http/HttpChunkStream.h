@@ -24,15 +24,24 @@ namespace traktor::net
 
 /*! HTTP chunk based stream.
  *
- * \note This stream is read-only and should not
- * be written to.
+ * In read mode chunks are decoded from the underlying stream;
+ * in write mode each write is encoded as a chunk and closing the
+ * stream writes the terminating chunk. The underlying stream is
+ * left open in write mode since it's typically a persistent
+ * connection.
  */
 class T_DLLCLASS HttpChunkStream : public IStream
 {
 	T_RTTI_CLASS;
 
 public:
-	explicit HttpChunkStream(IStream* stream);
+	enum class Mode
+	{
+		Read,
+		Write
+	};
+
+	explicit HttpChunkStream(IStream* stream, Mode mode = Mode::Read);
 
 	virtual void close() override final;
 
@@ -56,6 +65,7 @@ public:
 
 private:
 	Ref< IStream > m_stream;
+	Mode m_mode;
 	int64_t m_available;
 };
 
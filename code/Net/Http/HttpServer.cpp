@@ -7,7 +7,10 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
 #include "Core/RefArray.h"
+#include "Core/Containers/SmallMap.h"
+#include "Core/Io/BufferedStream.h"
 #include "Core/Io/FileOutputStream.h"
+#include "Core/Io/MemoryStream.h"
 #include "Core/Io/StreamCopy.h"
 #include "Core/Io/StreamStream.h"
 #include "Core/Io/StringReader.h"
@@ -17,14 +20,71 @@
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/StringSplit.h"
+#include "Core/Misc/TString.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Event.h"
+#include "Core/Thread/Semaphore.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Thread/ThreadPool.h"
+#include "Core/Timer/Timer.h"
 #include "Net/SocketAddressIPv4.h"
+#include "Net/SocketPoller.h"
 #include "Net/SocketStream.h"
 #include "Net/TcpSocket.h"
+#include "Net/Http/HttpChunkStream.h"
 #include "Net/Http/HttpRequest.h"
 #include "Net/Http/HttpServer.h"
 
 namespace traktor::net
 {
+	namespace
+	{
+
+const double c_keepAliveTimeout = 30.0;					//!< Seconds until an idle connection is closed.
+const uint32_t c_maxRequestSize = 16 * 1024 * 1024;		//!< Largest request, including payload, accepted on a kept alive connection.
+
+/*! Extract session id from cookie. */
+std::wstring getSession(const HttpRequest* request)
+{
+	if (!request->hasValue(L"Cookie"))
+		return L"";
+
+	const std::wstring cookie = request->getValue(L"Cookie");
+
+	StringSplit< std::wstring > ss(cookie, L";");
+	for (StringSplit< std::wstring >::const_iterator i = ss.begin(); i != ss.end(); ++i)
+	{
+		const std::wstring& kv = *i;
+
+		const size_t p = kv.find(L'=');
+		if (p != kv.npos)
+		{
+			const std::wstring k = kv.substr(0, p);
+			if (k == L"SESSIONID")
+				return kv.substr(p + 1);
+		}
+	}
+
+	return L"";
+}
+
+/*! Find end of request header, return offset to first byte after header or 0 if incomplete. */
+size_t findHeaderEnd(const AlignedVector< uint8_t >& buffer)
+{
+	for (size_t i = 0; i < buffer.size(); ++i)
+	{
+		if (buffer[i] != '\n')
+			continue;
+		if (i + 1 < buffer.size() && buffer[i + 1] == '\n')
+			return i + 2;
+		if (i + 2 < buffer.size() && buffer[i + 1] == '\r' && buffer[i + 2] == '\n')
+			return i + 3;
+	}
+	return 0;
+}
+
+	}
 
 class HttpServerImpl : public Object
 {
@@ -39,41 +99,183 @@ public:
 		destroy();
 	}
 
-	bool create(const SocketAddressIPv4& bind)
+	bool create(const SocketAddressIPv4& bind, int32_t workerCount)
 	{
-		if (!m_serverSocket.bind(bind, true))
+		m_serverSocket = new TcpSocket();
+		if (!m_serverSocket->bind(bind, true))
+			return false;
+
+		if (!m_serverSocket->listen())
+			return false;
+
+		if (workerCount <= 0)
+			return true;
+
+		// Connections, including server socket, are polled by a single
+		// thread and requests are processed by a fixed set of workers.
+		m_poller = new SocketPoller();
+		if (!m_poller->create())
+		{
+			log::error << L"Unable to create HTTP connection poller." << Endl;
 			return false;
+		}
 
-		if (!m_serverSocket.listen())
+		if (!m_poller->add(m_serverSocket))
+		{
+			log::error << L"Unable to poll HTTP server socket." << Endl;
 			return false;
+		}
+
+		ThreadPool::getInstance().spawn([this]()
+			{
+				RefArray< Socket > ready;
+				double lastSweep = m_timer.getElapsedTime();
+				while (!m_pollThread->stopped())
+				{
+					if (m_poller->wait(100, ready) > 0)
+					{
+						RefArray< Connection > connections;
+						for (auto socket : ready)
+						{
+							if (socket == m_serverSocket.ptr())
+							{
+								acceptConnections();
+								m_poller->rearm(m_serverSocket);
+								continue;
+							}
+
+							T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+							auto it = m_connections.find(socket);
+							if (it != m_connections.end())
+							{
+								it->second->busy = true;
+								connections.push_back(it->second);
+							}
+						}
+
+						if (!connections.empty())
+						{
+							{
+								T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_readyQueueLock);
+								for (auto connection : connections)
+									m_readyQueue.push_back(connection);
+							}
+							m_readyQueueEvent.pulse((int32_t)connections.size());
+						}
+					}
+
+					const double time = m_timer.getElapsedTime();
+					if (time - lastSweep >= 1.0)
+					{
+						closeIdleConnections(time);
+						lastSweep = time;
+					}
+				}
+			},
+			m_pollThread
+		);
+
+		m_workerThreads.resize(workerCount, nullptr);
+		for (int32_t i = 0; i < workerCount; ++i)
+		{
+			ThreadPool::getInstance().spawn([=, this]()
+				{
+					while (!m_workerThreads[i]->stopped())
+					{
+						Ref< Connection > connection;
+						{
+							T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_readyQueueLock);
+							if (!m_readyQueue.empty())
+							{
+								connection = m_readyQueue.front();
+								m_readyQueue.pop_front();
+							}
+						}
+						if (!connection)
+						{
+							m_readyQueueEvent.wait(100);
+							continue;
+						}
+
+						// Process pending requests; re-arm connection afterwards
+						// so it's polled again.
+						if (processConnection(connection))
+						{
+							{
+								T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+								connection->lastActivity = m_timer.getElapsedTime();
+								connection->busy = false;
+							}
+							m_poller->rearm(connection->socket);
+						}
+						else
+							closeConnection(connection);
+					}
+				},
+				m_workerThreads[i]
+			);
+		}
 
 		return true;
 	}
 
 	void destroy()
 	{
-		m_listener = nullptr;
-		m_serverSocket.close();
+		if (m_pollThread)
+			ThreadPool::getInstance().stop(m_pollThread);
+
+		for (auto& workerThread : m_workerThreads)
+		{
+			if (workerThread)
+			{
+				m_readyQueueEvent.broadcast();
+				ThreadPool::getInstance().stop(workerThread);
+			}
+		}
+		m_workerThreads.clear();
+
+		m_readyQueue.clear();
+		for (auto& it : m_connections)
+			it.second->socket->close();
+		m_connections.clear();
+
+		safeDestroy(m_poller);
+
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_listenerLock);
+			m_listener = nullptr;
+		}
+
+		safeClose(m_serverSocket);
 	}
 
 	int32_t getListenPort()
 	{
-		return dynamic_type_cast< net::SocketAddressIPv4* >(m_serverSocket.getLocalAddress())->getPort();
+		return dynamic_type_cast< net::SocketAddressIPv4* >(m_serverSocket->getLocalAddress())->getPort();
 	}
 
 	void setRequestListener(HttpServer::IRequestListener* listener)
 	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_listenerLock);
 		m_listener = listener;
 	}
 
 	void update(int32_t duration)
 	{
+		// Connections are served by background threads.
+		if (m_poller)
+		{
+			if (duration > 0)
+				ThreadManager::getInstance().getCurrentThread()->sleep(duration);
+			return;
+		}
+
 		for (; duration >= 0; duration -= 100)
 		{
-			if (!m_serverSocket.select(true, false, false, 100))
+			if (!m_serverSocket->select(true, false, false, 100))
 				continue;
 
-			Ref< TcpSocket > clientSocket = m_serverSocket.accept();
+			Ref< TcpSocket > clientSocket = m_serverSocket->accept();
 			if (!clientSocket)
 				continue;
 
@@ -117,48 +319,22 @@ public:
 				Ref< IStream > ds;
 				int32_t result = 503;
 				bool cache = true;
-				std::wstring session;
+				std::wstring session = getSession(request);
 
-				// Extract session id from cookie.
-				if (request->hasValue(L"Cookie"))
+				if (request->getMethod() == HttpRequest::MtPost || request->getMethod() == HttpRequest::MtPut)
 				{
-					const std::wstring cookie = request->getValue(L"Cookie");
-
-					StringSplit< std::wstring > ss(cookie, L";");
-					for (StringSplit< std::wstring >::const_iterator i = ss.begin(); i != ss.end(); ++i)
+					const int32_t contentLength = parseString< int32_t >(request->getValue(L"Content-Length"));
+					if (contentLength > 0)
 					{
-						const std::wstring& kv = *i;
-
-						const size_t p = kv.find(L'=');
-						if (p != kv.npos)
-						{
-							const std::wstring k = kv.substr(0, p);
-							if (k == L"SESSIONID")
-							{
-								session = kv.substr(p + 1);
-								break;
-							}
-						}
+						StreamStream payloadStream(&clientStream, clientStream.tell() + contentLength);
+						result = dispatch(request, &payloadStream, ssr, ds, cache, session);
 					}
+					else
+						log::warning << L"Got PUT/POST request but no \"Content-Length\"; ignoring request." << Endl;
 				}
-
-				if (m_listener)
+				else
 				{
-					if (request->getMethod() == HttpRequest::MtPost || request->getMethod() == HttpRequest::MtPut)
-					{
-						const int32_t contentLength = parseString< int32_t >(request->getValue(L"Content-Length"));
-						if (contentLength > 0)
-						{
-							StreamStream payloadStream(&clientStream, clientStream.tell() + contentLength);
-							result = m_listener->httpClientRequest(m_server, request, &payloadStream, ssr, ds, cache, session);
-						}
-						else
-							log::warning << L"Got PUT/POST request but no \"Content-Length\"; ignoring request." << Endl;
-					}
-					else
-					{
-						result = m_listener->httpClientRequest(m_server, request, nullptr, ssr, ds, cache, session);
-					}
+					result = dispatch(request, nullptr, ssr, ds, cache, session);
 				}
 
 				FileOutputStream os(&clientStream, new Utf8Encoding(), OutputStream::LineEnd::Win);
@@ -191,22 +367,256 @@ public:
 	}
 
 private:
+	/*! Kept alive client connection. */
+	class Connection : public Object
+	{
+	public:
+		Ref< TcpSocket > socket;
+		AlignedVector< uint8_t > buffer;	//!< Received data not yet consumed by a request.
+		double lastActivity = 0.0;
+		bool busy = false;					//!< Connection is queued or being processed by a worker.
+	};
+
 	HttpServer* m_server;
-	TcpSocket m_serverSocket;
+	Ref< TcpSocket > m_serverSocket;
 	Ref< HttpServer::IRequestListener > m_listener;
+	Semaphore m_listenerLock;
+	Ref< SocketPoller > m_poller;
+	SmallMap< const Socket*, Ref< Connection > > m_connections;
+	Semaphore m_connectionsLock;
+	RefArray< Connection > m_readyQueue;
+	Semaphore m_readyQueueLock;
+	Event m_readyQueueEvent;
+	Thread* m_pollThread = nullptr;
+	AlignedVector< Thread* > m_workerThreads;
+	Timer m_timer;
+
+	int32_t dispatch(const HttpRequest* request, IStream* payloadStream, OutputStream& os, Ref< IStream >& outStream, bool& outCache, std::wstring& inoutSession)
+	{
+		Ref< HttpServer::IRequestListener > listener;
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_listenerLock);
+			listener = m_listener;
+		}
+		if (listener)
+			return listener->httpClientRequest(m_server, request, payloadStream, os, outStream, outCache, inoutSession);
+		else
+			return 503;
+	}
+
+	/*! Accept all pending connections, called from poll thread. */
+	void acceptConnections()
+	{
+		while (m_serverSocket->select(true, false, false, 0) > 0)
+		{
+			Ref< TcpSocket > clientSocket = m_serverSocket->accept();
+			if (!clientSocket)
+				break;
+
+			clientSocket->setNoDelay(true);
+
+			Ref< Connection > connection = new Connection();
+			connection->socket = clientSocket;
+			connection->lastActivity = m_timer.getElapsedTime();
+
+			{
+				T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+				m_connections[clientSocket] = connection;
+			}
+
+			if (!m_poller->add(clientSocket))
+			{
+				log::error << L"Unable to poll HTTP connection." << Endl;
+				{
+					T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+					m_connections.remove(clientSocket);
+				}
+				clientSocket->close();
+			}
+		}
+	}
+
+	/*! Close connections which have been idle too long, called from poll thread. */
+	void closeIdleConnections(double time)
+	{
+		RefArray< Connection > idle;
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+			for (auto it = m_connections.begin(); it != m_connections.end(); )
+			{
+				if (!it->second->busy && time - it->second->lastActivity >= c_keepAliveTimeout)
+				{
+					idle.push_back(it->second);
+					it = m_connections.erase(it);
+				}
+				else
+					++it;
+			}
+		}
+		for (auto connection : idle)
+		{
+			m_poller->remove(connection->socket);
+			connection->socket->close();
+		}
+	}
+
+	void closeConnection(Connection* connection)
+	{
+		m_poller->remove(connection->socket);
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_connectionsLock);
+			m_connections.remove(connection->socket);
+		}
+		connection->socket->close();
+	}
+
+	/*! Receive pending data and respond to all complete requests.
+	 *
+	 * \return False if connection should be closed.
+	 */
+	bool processConnection(Connection* connection)
+	{
+		bool closed = false;
+
+		// Receive all pending data without blocking.
+		uint8_t tmp[4096];
+		while (connection->socket->select(true, false, false, 0) > 0)
+		{
+			const int32_t nrecv = connection->socket->recv(tmp, sizeof(tmp));
+			if (nrecv <= 0)
+			{
+				closed = true;
+				break;
+			}
+			connection->buffer.insert(connection->buffer.end(), tmp, tmp + nrecv);
+			if (connection->buffer.size() > c_maxRequestSize)
+			{
+				log::warning << L"HTTP request too large; closing connection." << Endl;
+				return false;
+			}
+		}
+
+		BufferedStream clientStream(new SocketStream(connection->socket, false, true));
+
+		// Respond to pipelined requests in order.
+		for (;;)
+		{
+			const size_t headerEnd = findHeaderEnd(connection->buffer);
+			if (headerEnd == 0)
+				break;
+
+			const std::wstring header = mbstows(Utf8Encoding(), std::string_view((const char*)connection->buffer.c_ptr(), headerEnd));
+
+			Ref< HttpRequest > request = HttpRequest::parse(header);
+			if (!request)
+				return false;
+
+			if (request->hasValue(L"Transfer-Encoding"))
+			{
+				log::warning << L"Chunked HTTP requests not supported; closing connection." << Endl;
+				return false;
+			}
+
+			const int32_t contentLength = request->hasValue(L"Content-Length") ? parseString< int32_t >(request->getValue(L"Content-Length")) : 0;
+			if (contentLength < 0 || headerEnd + contentLength > c_maxRequestSize)
+				return false;
+
+			// Wait for entire payload.
+			if (connection->buffer.size() < headerEnd + contentLength)
+				break;
+
+			// HTTP/1.1 connections are persistent unless explicitly closed, HTTP/1.0 only if requested.
+			const std::wstring requestLine = header.substr(0, header.find_first_of(L"\r\n"));
+			const std::wstring connectionValue = toLower(request->getValue(L"Connection"));
+			const bool keepAlive = endsWith(requestLine, L"HTTP/1.0") ? (connectionValue == L"keep-alive") : (connectionValue != L"close");
+
+			StringOutputStream ssr;
+			Ref< IStream > ds;
+			bool cache = true;
+			std::wstring session = getSession(request);
+			int32_t result;
+
+			if (contentLength > 0)
+			{
+				MemoryStream payloadStream(connection->buffer.c_ptr() + headerEnd, contentLength);
+				result = dispatch(request, &payloadStream, ssr, ds, cache, session);
+			}
+			else
+				result = dispatch(request, nullptr, ssr, ds, cache, session);
+
+			connection->buffer.erase(connection->buffer.begin(), connection->buffer.begin() + headerEnd + contentLength);
+
+			// Content is either sent with known length or chunked when provided as a stream.
+			const bool sendBody = (request->getMethod() != HttpRequest::MtHead);
+			const std::string content = !ds ? wstombs(Utf8Encoding(), ssr.str()) : std::string();
+
+			StringOutputStream sh;
+			if (result >= 200 && result < 300)
+				sh << L"HTTP/1.1 " << result << L" OK\r\n";
+			else
+				sh << L"HTTP/1.1 " << result << L" ERROR\r\n";
+
+			if (!session.empty())
+				sh << L"Set-Cookie: SESSIONID=" << session << L";path=/\r\n";
+
+			if (!cache)
+				sh << L"Cache-Control: no-cache\r\n";
+
+			sh << (keepAlive ? L"Connection: keep-alive\r\n" : L"Connection: close\r\n");
+
+			if (ds)
+				sh << L"Transfer-Encoding: chunked\r\n";
+			else
+				sh << L"Content-Length: " << int32_t(content.size()) << L"\r\n";
+
+			sh << L"\r\n";
+
+			const std::string responseHeader = wstombs(Utf8Encoding(), sh.str());
+			if (clientStream.write(responseHeader.c_str(), responseHeader.size()) != (int64_t)responseHeader.size())
+				return false;
+
+			if (sendBody)
+			{
+				if (ds)
+				{
+					HttpChunkStream chunkStream(&clientStream, HttpChunkStream::Mode::Write);
+					if (!StreamCopy(&chunkStream, ds).execute())
+					{
+						log::error << L"Unable to transfer entire stream to client; partially transmitted data." << Endl;
+						return false;
+					}
+					chunkStream.close();
+				}
+				else if (!content.empty())
+				{
+					if (clientStream.write(content.c_str(), content.size()) != (int64_t)content.size())
+						return false;
+				}
+			}
+
+			if (!keepAlive)
+			{
+				clientStream.flush();
+				return false;
+			}
+		}
+
+		clientStream.flush();
+		return !closed;
+	}
 };
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.net.HttpServer", HttpServer, Object)
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.net.HttpServer.IRequestListener", HttpServer::IRequestListener, Object)
 
-bool HttpServer::create(const SocketAddressIPv4& bind)
+bool HttpServer::create(const SocketAddressIPv4& bind, int32_t workerCount)
 {
 	if (m_impl)
 		return false;
 
 	Ref< HttpServerImpl > impl = new HttpServerImpl(this);
-	if (!impl->create(bind))
+	if (!impl->create(bind, workerCount))
 		return false;
 
 	m_impl = impl;
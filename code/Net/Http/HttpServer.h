@@ -58,7 +58,22 @@ public:
 		) = 0;
 	};
 
-	bool create(const SocketAddressIPv4& bind);
+	/*! Create server.
+	 *
+	 * If worker count is zero then connections are accepted and
+	 * served one at a time from update, each connection is closed
+	 * after a single request.
+	 *
+	 * Otherwise connections are kept alive and polled by a background
+	 * thread; requests, including pipelined requests, are dispatched
+	 * to listener from a pool of worker threads thus listener must
+	 * be thread safe.
+	 *
+	 * \param bind Address to bind server socket.
+	 * \param workerCount Number of worker threads.
+	 * \return True if server created.
+	 */
+	bool create(const SocketAddressIPv4& bind, int32_t workerCount = 0);
 
 	void destroy();
 
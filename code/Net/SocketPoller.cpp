@@ -0,0 +1,208 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <cerrno>
+#if defined(__LINUX__) || defined(__RPI__)
+#	include <sys/epoll.h>
+#elif !defined(_WIN32)
+#	include <poll.h>
+#endif
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Net/Platform.h"
+#include "Net/SocketPoller.h"
+
+namespace traktor::net
+{
+	namespace
+	{
+
+#if !defined(__LINUX__) && !defined(__RPI__)
+/*! Longest time spent in poll; sockets armed while polling are not part of current poll set. */
+const int32_t c_maxPollTimeout = 20;
+#endif
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.net.SocketPoller", SocketPoller, Object)
+
+SocketPoller::SocketPoller()
+:	m_epoll(-1)
+{
+}
+
+SocketPoller::~SocketPoller()
+{
+	destroy();
+}
+
+bool SocketPoller::create()
+{
+#if defined(__LINUX__) || defined(__RPI__)
+	m_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+	if (m_epoll < 0)
+		return false;
+#endif
+	return true;
+}
+
+void SocketPoller::destroy()
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+#if defined(__LINUX__) || defined(__RPI__)
+	if (m_epoll >= 0)
+	{
+		::close(m_epoll);
+		m_epoll = -1;
+	}
+#endif
+	m_sockets.clear();
+}
+
+bool SocketPoller::add(Socket* socket)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	const Socket::handle_t handle = socket->handle();
+	if (m_sockets.find(handle) != m_sockets.end())
+		return false;
+
+#if defined(__LINUX__) || defined(__RPI__)
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+	ev.data.fd = (int)handle;
+	if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, (int)handle, &ev) != 0)
+		return false;
+#endif
+
+	m_sockets[handle] = { socket, true };
+	return true;
+}
+
+bool SocketPoller::rearm(Socket* socket)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	auto it = m_sockets.find(socket->handle());
+	if (it == m_sockets.end())
+		return false;
+
+#if defined(__LINUX__) || defined(__RPI__)
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+	ev.data.fd = (int)it->first;
+	if (::epoll_ctl(m_epoll, EPOLL_CTL_MOD, (int)it->first, &ev) != 0)
+		return false;
+#endif
+
+	it->second.armed = true;
+	return true;
+}
+
+void SocketPoller::remove(Socket* socket)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+
+	auto it = m_sockets.find(socket->handle());
+	if (it == m_sockets.end())
+		return;
+
+#if defined(__LINUX__) || defined(__RPI__)
+	::epoll_ctl(m_epoll, EPOLL_CTL_DEL, (int)it->first, nullptr);
+#endif
+
+	m_sockets.erase(it);
+}
+
+int32_t SocketPoller::wait(int32_t timeout, RefArray< Socket >& outReady)
+{
+	outReady.resize(0);
+
+#if defined(__LINUX__) || defined(__RPI__)
+	struct epoll_event events[64];
+	const int32_t nevents = ::epoll_wait(m_epoll, events, sizeof_array(events), timeout);
+	if (nevents < 0)
+		return errno == EINTR ? 0 : -1;
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	for (int32_t i = 0; i < nevents; ++i)
+	{
+		auto it = m_sockets.find((Socket::handle_t)events[i].data.fd);
+		if (it == m_sockets.end() || !it->second.armed)
+			continue;
+
+		it->second.armed = false;
+		outReady.push_back(it->second.socket);
+	}
+#else
+	AlignedVector< Socket::handle_t > handles;
+#	if defined(_WIN32)
+	AlignedVector< WSAPOLLFD > fds;
+#	else
+	AlignedVector< struct pollfd > fds;
+#	endif
+
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		for (const auto& it : m_sockets)
+		{
+			if (!it.second.armed)
+				continue;
+
+			auto& fd = fds.push_back();
+			fd.fd = (SOCKET)it.first;
+			fd.events = POLLIN;
+			fd.revents = 0;
+
+			handles.push_back(it.first);
+		}
+	}
+
+	const int32_t pollTimeout = (timeout >= 0) ? std::min(timeout, c_maxPollTimeout) : c_maxPollTimeout;
+	if (fds.empty())
+	{
+		ThreadManager::getInstance().getCurrentThread()->sleep(pollTimeout);
+		return 0;
+	}
+
+#	if defined(_WIN32)
+	const int32_t rv = ::WSAPoll(fds.ptr(), (ULONG)fds.size(), pollTimeout);
+#	else
+	const int32_t rv = ::poll(fds.ptr(), (nfds_t)fds.size(), pollTimeout);
+#	endif
+	if (rv <= 0)
+		return rv < 0 ? -1 : 0;
+
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	for (uint32_t i = 0; i < fds.size(); ++i)
+	{
+		if (fds[i].revents == 0)
+			continue;
+
+		auto it = m_sockets.find(handles[i]);
+		if (it == m_sockets.end() || !it->second.armed)
+			continue;
+
+		it->second.armed = false;
+		outReady.push_back(it->second.socket);
+	}
+#endif
+
+	return (int32_t)outReady.size();
+}
+
+int32_t SocketPoller::count() const
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+	return (int32_t)m_sockets.size();
+}
+
+}
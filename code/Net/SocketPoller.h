@@ -0,0 +1,84 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/RefArray.h"
+#include "Core/Containers/SmallMap.h"
+#include "Core/Thread/Semaphore.h"
+#include "Net/Socket.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_NET_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::net
+{
+
+/*! Socket readiness poller.
+ * \ingroup Net
+ *
+ * Wait for pending reads on a large set of sockets.
+ * A socket is only reported once, it must be re-armed
+ * before it's reported again; thus it's safe to process
+ * a ready socket on another thread while polling continues.
+ *
+ * Using epoll on Linux and poll on other platforms.
+ */
+class T_DLLCLASS SocketPoller : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	SocketPoller();
+
+	virtual ~SocketPoller();
+
+	bool create();
+
+	void destroy();
+
+	/*! Add socket, socket is initially armed. */
+	bool add(Socket* socket);
+
+	/*! Re-arm socket after it has been reported ready. */
+	bool rearm(Socket* socket);
+
+	/*! Remove socket. */
+	void remove(Socket* socket);
+
+	/*! Wait until any armed socket has pending reads.
+	 *
+	 * \param timeout Timeout in milliseconds.
+	 * \param outReady Sockets with pending reads, these are disarmed.
+	 * \return Number of ready sockets, -1 if error.
+	 */
+	int32_t wait(int32_t timeout, RefArray< Socket >& outReady);
+
+	/*! Number of registered sockets. */
+	int32_t count() const;
+
+private:
+	struct Entry
+	{
+		Ref< Socket > socket;
+		bool armed;
+	};
+
+	mutable Semaphore m_lock;
+	SmallMap< Socket::handle_t, Entry > m_sockets;
+	int m_epoll;
+};
+
+}
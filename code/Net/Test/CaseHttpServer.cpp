@@ -0,0 +1,290 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "Core/Io/MemoryStream.h"
+#include "Core/Io/OutputStream.h"
+#include "Core/Log/Log.h"
+#include "Core/Misc/String.h"
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
+#include "Net/Network.h"
+#include "Net/SocketAddressIPv4.h"
+#include "Net/TcpSocket.h"
+#include "Net/Http/HttpRequest.h"
+#include "Net/Http/HttpServer.h"
+#include "Net/Test/CaseHttpServer.h"
+
+namespace traktor::net::test
+{
+	namespace
+	{
+
+const int32_t c_clientCount = 8;
+const int32_t c_requestsPerClient = 400;
+const int32_t c_pipelineDepth = 4;
+const int32_t c_streamSize = 100000;
+
+class TestListener : public HttpServer::IRequestListener
+{
+public:
+	TestListener()
+	:	m_stream(c_streamSize)
+	{
+		for (int32_t i = 0; i < c_streamSize; ++i)
+			m_stream[i] = uint8_t(i * 7);
+	}
+
+	virtual int32_t httpClientRequest(
+		HttpServer* server,
+		const HttpRequest* request,
+		IStream* clientStream,
+		OutputStream& os,
+		Ref< IStream >& outStream,
+		bool& outCache,
+		std::wstring& inoutSession
+	) override final
+	{
+		if (request->getResource() == L"/stream")
+			outStream = new MemoryStream(m_stream.c_ptr(), m_stream.size());
+		else
+			os << L"Hello " << request->getResource();
+		return 200;
+	}
+
+	const AlignedVector< uint8_t >& getStream() const { return m_stream; }
+
+private:
+	AlignedVector< uint8_t > m_stream;
+};
+
+/*! Client side response reader, buffering received data. */
+class ResponseReader
+{
+public:
+	explicit ResponseReader(TcpSocket* socket)
+	:	m_socket(socket)
+	{
+	}
+
+	bool send(const std::string& request)
+	{
+		return m_socket->send(request.c_str(), (int)request.size()) == (int)request.size();
+	}
+
+	bool readResponse(std::string& outBody)
+	{
+		std::string header;
+		if (!readUntil("\r\n\r\n", header))
+			return false;
+		if (!startsWith(header, "HTTP/1.1 200"))
+			return false;
+
+		const size_t p = header.find("Content-Length: ");
+		if (p != header.npos)
+			return read(std::atoi(header.c_str() + p + 16), outBody);
+
+		if (header.find("Transfer-Encoding: chunked") == header.npos)
+			return false;
+
+		outBody.clear();
+		for (;;)
+		{
+			std::string line, chunk;
+			if (!readUntil("\r\n", line))
+				return false;
+
+			const int32_t size = (int32_t)std::strtol(line.c_str(), nullptr, 16);
+			if (!read(size + 2, chunk))
+				return false;
+			if (size == 0)
+				return true;
+
+			outBody.append(chunk, 0, size);
+		}
+	}
+
+private:
+	TcpSocket* m_socket;
+	std::string m_buffer;
+
+	bool fill()
+	{
+		if (m_socket->select(true, false, false, 5000) <= 0)
+			return false;
+
+		char tmp[65536];
+		const int32_t nrecv = m_socket->recv(tmp, sizeof(tmp));
+		if (nrecv <= 0)
+			return false;
+
+		m_buffer.append(tmp, nrecv);
+		return true;
+	}
+
+	bool readUntil(const char* delimiter, std::string& outData)
+	{
+		size_t p;
+		while ((p = m_buffer.find(delimiter)) == m_buffer.npos)
+		{
+			if (!fill())
+				return false;
+		}
+		p += std::strlen(delimiter);
+		outData = m_buffer.substr(0, p);
+		m_buffer.erase(0, p);
+		return true;
+	}
+
+	bool read(int32_t size, std::string& outData)
+	{
+		while ((int32_t)m_buffer.size() < size)
+		{
+			if (!fill())
+				return false;
+		}
+		outData = m_buffer.substr(0, size);
+		m_buffer.erase(0, size);
+		return true;
+	}
+};
+
+std::string formatRequest(const std::string& resource)
+{
+	return "GET " + resource + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.net.test.CaseHttpServer", 0, CaseHttpServer, traktor::test::Case)
+
+void CaseHttpServer::run()
+{
+	Network::initialize();
+
+	Ref< TestListener > listener = new TestListener();
+
+	Ref< HttpServer > server = new HttpServer();
+	CASE_ASSERT(server->create(SocketAddressIPv4(0), 4));
+	server->setRequestListener(listener);
+
+	const SocketAddressIPv4 address(L"localhost", server->getListenPort());
+
+	// Slow client holding a connection with an incomplete request must not stall other clients.
+	Ref< TcpSocket > slowSocket = new TcpSocket();
+	CASE_ASSERT(slowSocket->connect(address));
+	slowSocket->send("GET /slow HTTP/1.1\r\n", 20);
+
+	// Chunked response of stream content.
+	{
+		Ref< TcpSocket > socket = new TcpSocket();
+		CASE_ASSERT(socket->connect(address));
+
+		ResponseReader reader(socket);
+		std::string body;
+		CASE_ASSERT(reader.send(formatRequest("/stream")));
+		CASE_ASSERT(reader.readResponse(body));
+		CASE_ASSERT_EQUAL(body.size(), listener->getStream().size());
+		CASE_ASSERT(body.size() == listener->getStream().size() && std::memcmp(body.c_str(), listener->getStream().c_ptr(), body.size()) == 0);
+
+		// Same connection is reused for next request.
+		CASE_ASSERT(reader.send(formatRequest("/after")));
+		CASE_ASSERT(reader.readResponse(body));
+		CASE_ASSERT(body == "Hello /after");
+
+		socket->close();
+	}
+
+	// Load generation; each client issue pipelined requests on a single kept alive connection.
+	AlignedVector< double > latencies[c_clientCount];
+	std::atomic< int32_t > failures(0);
+	Thread* clientThreads[c_clientCount];
+
+	Timer timer;
+
+	for (int32_t i = 0; i < c_clientCount; ++i)
+	{
+		clientThreads[i] = ThreadManager::getInstance().create([&, i]() {
+			Ref< TcpSocket > socket = new TcpSocket();
+			if (!socket->connect(address))
+			{
+				++failures;
+				return;
+			}
+			socket->setNoDelay(true);
+
+			ResponseReader reader(socket);
+			Timer requestTimer;
+
+			for (int32_t j = 0; j < c_requestsPerClient; j += c_pipelineDepth)
+			{
+				const double start = requestTimer.getElapsedTime();
+
+				std::string requests;
+				for (int32_t k = 0; k < c_pipelineDepth; ++k)
+					requests += formatRequest("/c" + std::to_string(i) + "/r" + std::to_string(j + k));
+				if (!reader.send(requests))
+				{
+					++failures;
+					break;
+				}
+
+				for (int32_t k = 0; k < c_pipelineDepth; ++k)
+				{
+					std::string body;
+					if (!reader.readResponse(body) || body != "Hello /c" + std::to_string(i) + "/r" + std::to_string(j + k))
+					{
+						++failures;
+						socket->close();
+						return;
+					}
+					latencies[i].push_back(requestTimer.getElapsedTime() - start);
+				}
+			}
+
+			socket->close();
+		});
+		clientThreads[i]->start();
+	}
+
+	for (int32_t i = 0; i < c_clientCount; ++i)
+	{
+		clientThreads[i]->wait();
+		ThreadManager::getInstance().destroy(clientThreads[i]);
+	}
+
+	const double duration = timer.getElapsedTime();
+
+	AlignedVector< double > all;
+	for (int32_t i = 0; i < c_clientCount; ++i)
+		all.insert(all.end(), latencies[i].begin(), latencies[i].end());
+	std::sort(all.begin(), all.end());
+
+	CASE_ASSERT_EQUAL(failures.load(), 0);
+	CASE_ASSERT_EQUAL((int32_t)all.size(), c_clientCount * c_requestsPerClient);
+
+	if (!all.empty())
+	{
+		const double p99 = all[(all.size() * 99) / 100];
+		log::info << L"HTTP server; " << int32_t(all.size() / duration) << L" requests/s, p99 latency " << int32_t(p99 * 1000000.0) << L" us" << Endl;
+	}
+
+	slowSocket->close();
+
+	server->destroy();
+	server = nullptr;
+
+	Network::finalize();
+}
+
+}
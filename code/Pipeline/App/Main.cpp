@@ -47,6 +47,7 @@
 #include "Editor/IPipeline.h"
 #include "Editor/Pipeline/PipelineBuilder.h"
 #include "Editor/Pipeline/PipelineDbFlat.h"
+#include "Editor/Pipeline/PipelineDependencyCache.h"
 #include "Editor/PipelineDependencySet.h"
 #include "Editor/Pipeline/PipelineDependsIncremental.h"
 #include "Editor/Pipeline/PipelineDependsParallel.h"
@@ -408,6 +409,16 @@ bool perform(const PipelineParameters& params)
 	editor::PipelineFactory pipelineFactory(settings);
 	editor::PipelineDependencySet pipelineDependencySet;
 
+	// Load dependency cache; ignored when rebuilding so all dependencies are rescanned.
+	const std::wstring dependencyCachePath = settings->getProperty< std::wstring >(L"Pipeline.DependencyCache");
+	Ref< editor::PipelineDependencyCache > dependencyCache;
+	if (!dependencyCachePath.empty())
+	{
+		dependencyCache = new editor::PipelineDependencyCache(dependencyCachePath);
+		if (!params.getRebuild())
+			dependencyCache->load();
+	}
+
 	// Collect dependencies.
 	Ref< editor::IPipelineDepends > pipelineDepends;
 	if (settings->getProperty< bool >(L"Pipeline.DependsThreads", true))
@@ -418,7 +429,8 @@ bool perform(const PipelineParameters& params)
 			outputDatabaseAndCache.database,
 			&pipelineDependencySet,
 			pipelineDb,
-			sourceDatabaseAndCache.cache
+			sourceDatabaseAndCache.cache,
+			dependencyCache
 		);
 	}
 	else
@@ -458,7 +470,8 @@ bool perform(const PipelineParameters& params)
 		}
 	}
 
-	pipelineDepends->waitUntilFinished();
+	if (pipelineDepends->waitUntilFinished() && dependencyCache)
+		dependencyCache->save();
 
 	traktor::log::info << DecreaseIndent;
 
@@ -0,0 +1,77 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Core/Memory/Alloc.h"
+#include "Core/Thread/Atomic.h"
+#include "Render/Null/BufferNull.h"
+#include "Render/Null/ContextNull.h"
+
+namespace traktor::render
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.render.BufferNull", BufferNull, Buffer)
+
+BufferNull::BufferNull(ContextNull* context, uint32_t bufferSize, uint32_t& instances)
+:	Buffer(bufferSize)
+,	m_context(context)
+,	m_instances(instances)
+{
+	Atomic::increment((int32_t&)m_instances);
+
+	m_data = (uint8_t*)Alloc::acquireAlign(bufferSize, 16, T_FILE_LINE);
+	std::memset(m_data, 0, bufferSize);
+	m_bufferView = BufferViewNull(m_data, bufferSize);
+
+	m_context->memoryUsage += bufferSize;
+	m_context->allocationCount++;
+}
+
+BufferNull::~BufferNull()
+{
+	destroy();
+	Atomic::decrement((int32_t&)m_instances);
+}
+
+void BufferNull::destroy()
+{
+	T_ASSERT(!m_locked);
+	if (m_data)
+	{
+		Alloc::freeAlign(m_data);
+		m_data = nullptr;
+		m_bufferView = BufferViewNull();
+
+		m_context->memoryUsage -= getBufferSize();
+		m_context->allocationCount--;
+	}
+}
+
+void* BufferNull::lock()
+{
+	T_ASSERT(!m_locked);
+	if (!m_data)
+		return nullptr;
+
+	m_locked = true;
+	return m_data;
+}
+
+void BufferNull::unlock()
+{
+	T_ASSERT(m_locked);
+	m_context->bytesUploaded += getBufferSize();
+	m_locked = false;
+}
+
+const IBufferView* BufferNull::getBufferView() const
+{
+	return &m_bufferView;
+}
+
+}
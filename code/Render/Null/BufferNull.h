@@ -0,0 +1,48 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Render/Buffer.h"
+#include "Render/Null/BufferViewNull.h"
+
+namespace traktor::render
+{
+
+class ContextNull;
+
+/*! Buffer kept in system memory.
+ * \ingroup Null
+ */
+class BufferNull : public Buffer
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit BufferNull(ContextNull* context, uint32_t bufferSize, uint32_t& instances);
+
+	virtual ~BufferNull();
+
+	virtual void destroy() override final;
+
+	virtual void* lock() override final;
+
+	virtual void unlock() override final;
+
+	virtual const IBufferView* getBufferView() const override final;
+
+private:
+	Ref< ContextNull > m_context;
+	uint32_t& m_instances;
+	uint8_t* m_data = nullptr;
+	BufferViewNull m_bufferView;
+	bool m_locked = false;
+};
+
+}
@@ -0,0 +1,22 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Render/Null/BufferViewNull.h"
+
+namespace traktor::render
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.render.BufferViewNull", BufferViewNull, IBufferView)
+
+BufferViewNull::BufferViewNull(const uint8_t* data, uint32_t size)
+:	m_data(data)
+,	m_size(size)
+{
+}
+
+}
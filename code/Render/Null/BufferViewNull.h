@@ -0,0 +1,37 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Render/IBufferView.h"
+
+namespace traktor::render
+{
+
+/*!
+ * \ingroup Null
+ */
+class BufferViewNull : public IBufferView
+{
+	T_RTTI_CLASS;
+
+public:
+	BufferViewNull() = default;
+
+	explicit BufferViewNull(const uint8_t* data, uint32_t size);
+
+	const uint8_t* getData() const { return m_data; }
+
+	uint32_t getSize() const { return m_size; }
+
+private:
+	const uint8_t* m_data = nullptr;
+	uint32_t m_size = 0;
+};
+
+}
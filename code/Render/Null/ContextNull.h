@@ -0,0 +1,40 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include "Core/Object.h"
+
+namespace traktor::render
+{
+
+/*! Counters shared by all resources of null render system.
+ * \ingroup Null
+ *
+ * Resources can be created, locked and bound from
+ * any thread thus all counters are atomic.
+ */
+class ContextNull : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	std::atomic< uint64_t > memoryUsage = 0;
+	std::atomic< uint64_t > allocationCount = 0;
+	std::atomic< uint64_t > bytesUploaded = 0;
+	std::atomic< uint64_t > frames = 0;
+	std::atomic< uint64_t > passes = 0;
+	std::atomic< uint64_t > drawCalls = 0;
+	std::atomic< uint64_t > computeCalls = 0;
+	std::atomic< uint64_t > primitives = 0;
+	std::atomic< uint64_t > programBinds = 0;
+	std::atomic< uint64_t > parameterBinds = 0;
+};
+
+}
@@ -0,0 +1,84 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Thread/Atomic.h"
+#include "Render/Null/ContextNull.h"
+#include "Render/Null/ProgramNull.h"
+
+namespace traktor::render
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.render.ProgramNull", ProgramNull, IProgram)
+
+ProgramNull::ProgramNull(ContextNull* context, uint32_t& instances)
+:	m_context(context)
+,	m_instances(instances)
+{
+	Atomic::increment((int32_t&)m_instances);
+}
+
+ProgramNull::~ProgramNull()
+{
+	Atomic::decrement((int32_t&)m_instances);
+}
+
+void ProgramNull::destroy()
+{
+}
+
+void ProgramNull::setFloatParameter(handle_t handle, float param)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setFloatArrayParameter(handle_t handle, const float* param, int length)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setVectorParameter(handle_t handle, const Vector4& param)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setVectorArrayParameter(handle_t handle, const Vector4* param, int length)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setMatrixParameter(handle_t handle, const Matrix44& param)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setMatrixArrayParameter(handle_t handle, const Matrix44* param, int length)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setTextureParameter(handle_t handle, ITexture* texture)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setImageViewParameter(handle_t handle, ITexture* imageView, int mip)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setBufferViewParameter(handle_t handle, const IBufferView* bufferView)
+{
+	m_context->parameterBinds++;
+}
+
+void ProgramNull::setStencilReference(uint32_t stencilReference)
+{
+	m_context->parameterBinds++;
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Render/IProgram.h"
+
+namespace traktor::render
+{
+
+class ContextNull;
+
+/*! Program which only records parameter bindings.
+ * \ingroup Null
+ */
+class ProgramNull : public IProgram
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit ProgramNull(ContextNull* context, uint32_t& instances);
+
+	virtual ~ProgramNull();
+
+	virtual void destroy() override final;
+
+	virtual void setFloatParameter(handle_t handle, float param) override final;
+
+	virtual void setFloatArrayParameter(handle_t handle, const float* param, int length) override final;
+
+	virtual void setVectorParameter(handle_t handle, const Vector4& param) override final;
+
+	virtual void setVectorArrayParameter(handle_t handle, const Vector4* param, int length) override final;
+
+	virtual void setMatrixParameter(handle_t handle, const Matrix44& param) override final;
+
+	virtual void setMatrixArrayParameter(handle_t handle, const Matrix44* param, int length) override final;
+
+	virtual void setTextureParameter(handle_t handle, ITexture* texture) override final;
+
+	virtual void setImageViewParameter(handle_t handle, ITexture* imageView, int mip) override final;
+
+	virtual void setBufferViewParameter(handle_t handle, const IBufferView* bufferView) override final;
+
+	virtual void setStencilReference(uint32_t stencilReference) override final;
+
+private:
+	Ref< ContextNull > m_context;
+	uint32_t& m_instances;
+};
+
+}
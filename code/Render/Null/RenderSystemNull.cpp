@@ -0,0 +1,179 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Render/VertexElement.h"
+#include "Render/Null/BufferNull.h"
+#include "Render/Null/ContextNull.h"
+#include "Render/Null/ProgramNull.h"
+#include "Render/Null/RenderSystemNull.h"
+#include "Render/Null/RenderTargetSetNull.h"
+#include "Render/Null/RenderViewNull.h"
+#include "Render/Null/TextureNull.h"
+#include "Render/Null/VertexLayoutNull.h"
+
+namespace traktor::render
+{
+	namespace
+	{
+
+const DisplayMode c_displayMode = { 1280, 720, 32, 96, 60.0f };
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.render.RenderSystemNull", 0, RenderSystemNull, IRenderSystem)
+
+RenderSystemNull::RenderSystemNull()
+:	m_context(new ContextNull())
+{
+}
+
+bool RenderSystemNull::create(const RenderSystemDesc& desc)
+{
+	return true;
+}
+
+void RenderSystemNull::destroy()
+{
+}
+
+bool RenderSystemNull::reset(const RenderSystemDesc& desc)
+{
+	return true;
+}
+
+void RenderSystemNull::getInformation(RenderSystemInformation& outInfo) const
+{
+	outInfo.vendor = AdapterVendorType::Unknown;
+	outInfo.dedicatedMemoryTotal = 0;
+	outInfo.sharedMemoryTotal = 0;
+	outInfo.dedicatedMemoryAvailable = 0;
+	outInfo.sharedMemoryAvailable = 0;
+}
+
+uint32_t RenderSystemNull::getDisplayCount() const
+{
+	return 1;
+}
+
+uint32_t RenderSystemNull::getDisplayModeCount(uint32_t display) const
+{
+	return 1;
+}
+
+DisplayMode RenderSystemNull::getDisplayMode(uint32_t display, uint32_t index) const
+{
+	return c_displayMode;
+}
+
+DisplayMode RenderSystemNull::getCurrentDisplayMode(uint32_t display) const
+{
+	return c_displayMode;
+}
+
+float RenderSystemNull::getDisplayAspectRatio(uint32_t display) const
+{
+	return (float)c_displayMode.width / c_displayMode.height;
+}
+
+Ref< IRenderView > RenderSystemNull::createRenderView(const RenderViewDefaultDesc& desc)
+{
+	Ref< RenderViewNull > renderView = new RenderViewNull(m_context);
+	renderView->reset(desc);
+	return renderView;
+}
+
+Ref< IRenderView > RenderSystemNull::createRenderView(const RenderViewEmbeddedDesc& desc)
+{
+	return new RenderViewNull(m_context);
+}
+
+Ref< Buffer > RenderSystemNull::createBuffer(uint32_t usage, uint32_t bufferSize, bool dynamic)
+{
+	return new BufferNull(m_context, bufferSize, m_statistics.buffers);
+}
+
+Ref< const IVertexLayout > RenderSystemNull::createVertexLayout(const AlignedVector< VertexElement >& vertexElements)
+{
+	return new VertexLayoutNull(getVertexSize(vertexElements));
+}
+
+Ref< ITexture > RenderSystemNull::createSimpleTexture(const SimpleTextureCreateDesc& desc, const wchar_t* const tag)
+{
+	Ref< TextureNull > texture = new TextureNull(m_context, m_statistics.simpleTextures);
+	if (texture->create(desc))
+		return texture;
+	else
+		return nullptr;
+}
+
+Ref< ITexture > RenderSystemNull::createCubeTexture(const CubeTextureCreateDesc& desc, const wchar_t* const tag)
+{
+	Ref< TextureNull > texture = new TextureNull(m_context, m_statistics.cubeTextures);
+	if (texture->create(desc))
+		return texture;
+	else
+		return nullptr;
+}
+
+Ref< ITexture > RenderSystemNull::createVolumeTexture(const VolumeTextureCreateDesc& desc, const wchar_t* const tag)
+{
+	Ref< TextureNull > texture = new TextureNull(m_context, m_statistics.volumeTextures);
+	if (texture->create(desc))
+		return texture;
+	else
+		return nullptr;
+}
+
+Ref< IRenderTargetSet > RenderSystemNull::createRenderTargetSet(const RenderTargetSetCreateDesc& desc, IRenderTargetSet* sharedDepthStencil, const wchar_t* const tag)
+{
+	Ref< RenderTargetSetNull > renderTargetSet = new RenderTargetSetNull(m_context, m_statistics.renderTargetSets);
+	if (renderTargetSet->create(desc, sharedDepthStencil, m_statistics.simpleTextures))
+		return renderTargetSet;
+	else
+		return nullptr;
+}
+
+Ref< IProgram > RenderSystemNull::createProgram(const ProgramResource* programResource, const wchar_t* const tag)
+{
+	if (!programResource)
+		return nullptr;
+	return new ProgramNull(m_context, m_statistics.programs);
+}
+
+void RenderSystemNull::purge()
+{
+}
+
+void RenderSystemNull::getStatistics(RenderSystemStatistics& outStatistics) const
+{
+	outStatistics = m_statistics;
+	outStatistics.memoryAvailable = 0;
+	outStatistics.memoryUsage = m_context->memoryUsage;
+	outStatistics.allocationCount = m_context->allocationCount;
+}
+
+void* RenderSystemNull::getInternalHandle() const
+{
+	return nullptr;
+}
+
+RenderSystemNull::StatisticsNull RenderSystemNull::getStatisticsNull() const
+{
+	StatisticsNull statistics;
+	statistics.frames = m_context->frames;
+	statistics.passes = m_context->passes;
+	statistics.drawCalls = m_context->drawCalls;
+	statistics.computeCalls = m_context->computeCalls;
+	statistics.primitives = m_context->primitives;
+	statistics.programBinds = m_context->programBinds;
+	statistics.parameterBinds = m_context->parameterBinds;
+	statistics.bytesUploaded = m_context->bytesUploaded;
+	return statistics;
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Render/IRenderSystem.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_RENDER_NULL_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::render
+{
+
+class ContextNull;
+
+/*! Null render system.
+ * \ingroup Null
+ *
+ * Headless render system which accept all resources
+ * and commands without rendering anything. Intended
+ * for servers, automated tests and to measure
+ * CPU side cost of renderers without a GPU.
+ *
+ * Programs are created from resources compiled
+ * for any other render system.
+ */
+class T_DLLCLASS RenderSystemNull : public IRenderSystem
+{
+	T_RTTI_CLASS;
+
+public:
+	/*! Recorded counters since render system was created. */
+	struct StatisticsNull
+	{
+		uint64_t frames = 0;
+		uint64_t passes = 0;
+		uint64_t drawCalls = 0;
+		uint64_t computeCalls = 0;
+		uint64_t primitives = 0;
+		uint64_t programBinds = 0;
+		uint64_t parameterBinds = 0;
+		uint64_t bytesUploaded = 0;
+	};
+
+	RenderSystemNull();
+
+	virtual bool create(const RenderSystemDesc& desc) override final;
+
+	virtual void destroy() override final;
+
+	virtual bool reset(const RenderSystemDesc& desc) override final;
+
+	virtual void getInformation(RenderSystemInformation& outInfo) const override final;
+
+	virtual uint32_t getDisplayCount() const override final;
+
+	virtual uint32_t getDisplayModeCount(uint32_t display) const override final;
+
+	virtual DisplayMode getDisplayMode(uint32_t display, uint32_t index) const override final;
+
+	virtual DisplayMode getCurrentDisplayMode(uint32_t display) const override final;
+
+	virtual float getDisplayAspectRatio(uint32_t display) const override final;
+
+	virtual Ref< IRenderView > createRenderView(const RenderViewDefaultDesc& desc) override final;
+
+	virtual Ref< IRenderView > createRenderView(const RenderViewEmbeddedDesc& desc) override final;
+
+	virtual Ref< Buffer > createBuffer(uint32_t usage, uint32_t bufferSize, bool dynamic) override final;
+
+	virtual Ref< const IVertexLayout > createVertexLayout(const AlignedVector< VertexElement >& vertexElements) override final;
+
+	virtual Ref< ITexture > createSimpleTexture(const SimpleTextureCreateDesc& desc, const wchar_t* const tag) override final;
+
+	virtual Ref< ITexture > createCubeTexture(const CubeTextureCreateDesc& desc, const wchar_t* const tag) override final;
+
+	virtual Ref< ITexture > createVolumeTexture(const VolumeTextureCreateDesc& desc, const wchar_t* const tag) override final;
+
+	virtual Ref< IRenderTargetSet > createRenderTargetSet(const RenderTargetSetCreateDesc& desc, IRenderTargetSet* sharedDepthStencil, const wchar_t* const tag) override final;
+
+	virtual Ref< IProgram > createProgram(const ProgramResource* programResource, const wchar_t* const tag) override final;
+
+	virtual void purge() override final;
+
+	virtual void getStatistics(RenderSystemStatistics& outStatistics) const override final;
+
+	virtual void* getInternalHandle() const override final;
+
+	/*! Get snapshot of recorded counters. */
+	StatisticsNull getStatisticsNull() const;
+
+private:
+	Ref< ContextNull > m_context;
+	RenderSystemStatistics m_statistics;
+};
+
+}
@@ -0,0 +1,103 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Core/Thread/Atomic.h"
+#include "Render/Null/ContextNull.h"
+#include "Render/Null/RenderTargetSetNull.h"
+#include "Render/Null/TextureNull.h"
+
+namespace traktor::render
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.render.RenderTargetSetNull", RenderTargetSetNull, IRenderTargetSet)
+
+RenderTargetSetNull::RenderTargetSetNull(ContextNull* context, uint32_t& instances)
+:	m_context(context)
+,	m_instances(instances)
+{
+	Atomic::increment((int32_t&)m_instances);
+}
+
+RenderTargetSetNull::~RenderTargetSetNull()
+{
+	destroy();
+	Atomic::decrement((int32_t&)m_instances);
+}
+
+bool RenderTargetSetNull::create(const RenderTargetSetCreateDesc& desc, IRenderTargetSet* sharedDepthStencil, uint32_t& textureInstances)
+{
+	m_width = desc.width;
+	m_height = desc.height;
+
+	for (int32_t i = 0; i < desc.count; ++i)
+	{
+		Ref< TextureNull > colorTexture = new TextureNull(m_context, textureInstances);
+		if (!colorTexture->create(desc.width, desc.height, desc.targets[i].format))
+			return false;
+		m_colorTextures.push_back(colorTexture);
+	}
+
+	if (sharedDepthStencil)
+		m_depthTexture = static_cast< TextureNull* >(sharedDepthStencil->getDepthTexture());
+	else if (desc.createDepthStencil)
+	{
+		m_depthTexture = new TextureNull(m_context, textureInstances);
+		if (!m_depthTexture->create(desc.width, desc.height, TfR32F))
+			return false;
+	}
+
+	return true;
+}
+
+void RenderTargetSetNull::destroy()
+{
+	for (auto colorTexture : m_colorTextures)
+		colorTexture->destroy();
+	m_colorTextures.clear();
+	m_depthTexture = nullptr;
+}
+
+int32_t RenderTargetSetNull::getWidth() const
+{
+	return m_width;
+}
+
+int32_t RenderTargetSetNull::getHeight() const
+{
+	return m_height;
+}
+
+ITexture* RenderTargetSetNull::getColorTexture(int32_t index) const
+{
+	return index >= 0 && index < (int32_t)m_colorTextures.size() ? m_colorTextures[index] : nullptr;
+}
+
+ITexture* RenderTargetSetNull::getDepthTexture() const
+{
+	return m_depthTexture;
+}
+
+bool RenderTargetSetNull::read(int32_t index, void* buffer) const
+{
+	if (index < 0 || index >= (int32_t)m_colorTextures.size())
+		return false;
+
+	const TextureNull* colorTexture = m_colorTextures[index];
+	const uint32_t size = getTextureMipPitch(colorTexture->getFormat(), m_width, m_height);
+
+	const uint8_t* data = colorTexture->getData(0, 0);
+	if (data)
+		std::memcpy(buffer, data, size);
+	else
+		std::memset(buffer, 0, size);
+
+	return true;
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/RefArray.h"
+#include "Render/IRenderTargetSet.h"
+#include "Render/Types.h"
+
+namespace traktor::render
+{
+
+class ContextNull;
+class TextureNull;
+
+/*! Render target set kept in system memory.
+ * \ingroup Null
+ */
+class RenderTargetSetNull : public IRenderTargetSet
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit RenderTargetSetNull(ContextNull* context, uint32_t& instances);
+
+	virtual ~RenderTargetSetNull();
+
+	bool create(const RenderTargetSetCreateDesc& desc, IRenderTargetSet* sharedDepthStencil, uint32_t& textureInstances);
+
+	virtual void destroy() override final;
+
+	virtual int32_t getWidth() const override final;
+
+	virtual int32_t getHeight() const override final;
+
+	virtual ITexture* getColorTexture(int32_t index) const override final;
+
+	virtual ITexture* getDepthTexture() const override final;
+
+	virtual bool read(int32_t index, void* buffer) const override final;
+
+private:
+	Ref< ContextNull > m_context;
+	uint32_t& m_instances;
+	int32_t m_width = 0;
+	int32_t m_height = 0;
+	RefArray< TextureNull > m_colorTextures;
+	Ref< TextureNull > m_depthTexture;
+};
+
+}
@@ -0,0 +1,226 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Render/Null/ContextNull.h"
+#include "Render/Null/RenderViewNull.h"
+
+namespace traktor::render
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.render.RenderViewNull", RenderViewNull, IRenderView)
+
+RenderViewNull::RenderViewNull(ContextNull* context)
+:	m_context(context)
+{
+}
+
+bool RenderViewNull::nextEvent(RenderEvent& outEvent)
+{
+	return false;
+}
+
+void RenderViewNull::close()
+{
+}
+
+bool RenderViewNull::reset(const RenderViewDefaultDesc& desc)
+{
+	return reset(desc.displayMode.width, desc.displayMode.height);
+}
+
+bool RenderViewNull::reset(int32_t width, int32_t height)
+{
+	if (width > 0 && height > 0)
+	{
+		m_width = width;
+		m_height = height;
+	}
+	return true;
+}
+
+uint32_t RenderViewNull::getDisplay() const
+{
+	return 0;
+}
+
+int RenderViewNull::getWidth() const
+{
+	return m_width;
+}
+
+int RenderViewNull::getHeight() const
+{
+	return m_height;
+}
+
+bool RenderViewNull::isActive() const
+{
+	return true;
+}
+
+bool RenderViewNull::isMinimized() const
+{
+	return false;
+}
+
+bool RenderViewNull::isFullScreen() const
+{
+	return false;
+}
+
+void RenderViewNull::showCursor()
+{
+	m_cursorVisible = true;
+}
+
+void RenderViewNull::hideCursor()
+{
+	m_cursorVisible = false;
+}
+
+bool RenderViewNull::isCursorVisible() const
+{
+	return m_cursorVisible;
+}
+
+bool RenderViewNull::setGamma(float gamma)
+{
+	return true;
+}
+
+void RenderViewNull::setViewport(const Viewport& viewport)
+{
+}
+
+SystemWindow RenderViewNull::getSystemWindow()
+{
+	return SystemWindow();
+}
+
+bool RenderViewNull::beginFrame()
+{
+	m_statistics = RenderViewStatistics();
+	m_boundProgram = nullptr;
+	m_timeQueries.resize(0);
+	m_context->frames++;
+	return true;
+}
+
+void RenderViewNull::endFrame()
+{
+}
+
+void RenderViewNull::present()
+{
+}
+
+bool RenderViewNull::beginPass(const Clear* clear, uint32_t load, uint32_t store)
+{
+	m_statistics.passCount++;
+	m_context->passes++;
+	return true;
+}
+
+bool RenderViewNull::beginPass(IRenderTargetSet* renderTargetSet, const Clear* clear, uint32_t load, uint32_t store)
+{
+	return beginPass(clear, load, store);
+}
+
+bool RenderViewNull::beginPass(IRenderTargetSet* renderTargetSet, int32_t renderTarget, const Clear* clear, uint32_t load, uint32_t store)
+{
+	return beginPass(clear, load, store);
+}
+
+void RenderViewNull::endPass()
+{
+}
+
+void RenderViewNull::draw(const IBufferView* vertexBuffer, const IVertexLayout* vertexLayout, const IBufferView* indexBuffer, IndexType indexType, IProgram* program, const Primitives& primitives, uint32_t instanceCount)
+{
+	if (program != m_boundProgram)
+	{
+		m_context->programBinds++;
+		m_boundProgram = program;
+	}
+
+	const uint32_t primitiveCount = primitives.count * instanceCount;
+	m_statistics.drawCalls++;
+	m_statistics.primitiveCount += primitiveCount;
+	m_context->drawCalls++;
+	m_context->primitives += primitiveCount;
+}
+
+void RenderViewNull::drawIndirect(const IBufferView* vertexBuffer, const IVertexLayout* vertexLayout, const IBufferView* indexBuffer, IndexType indexType, IProgram* program, PrimitiveType primitiveType, const IBufferView* drawBuffer, uint32_t drawOffset, uint32_t drawCount)
+{
+	if (program != m_boundProgram)
+	{
+		m_context->programBinds++;
+		m_boundProgram = program;
+	}
+
+	m_statistics.drawCalls += drawCount;
+	m_context->drawCalls += drawCount;
+}
+
+void RenderViewNull::compute(IProgram* program, const int32_t* workSize)
+{
+	m_context->computeCalls++;
+}
+
+void RenderViewNull::computeIndirect(IProgram* program, const IBufferView* workBuffer, uint32_t workOffset)
+{
+	m_context->computeCalls++;
+}
+
+void RenderViewNull::barrier(Stage from, Stage to, ITexture* written, uint32_t writtenMip)
+{
+}
+
+bool RenderViewNull::copy(ITexture* destinationTexture, const Region& destinationRegion, ITexture* sourceTexture, const Region& sourceRegion)
+{
+	return true;
+}
+
+int32_t RenderViewNull::beginTimeQuery()
+{
+	const int32_t query = (int32_t)m_timeQueries.size();
+	const double now = m_timer.getElapsedTime();
+	m_timeQueries.push_back(now);
+	m_timeQueries.push_back(now);
+	return query;
+}
+
+void RenderViewNull::endTimeQuery(int32_t query)
+{
+	m_timeQueries[query + 1] = m_timer.getElapsedTime();
+}
+
+bool RenderViewNull::getTimeQuery(int32_t query, bool wait, double& outStart, double& outEnd) const
+{
+	if (query < 0 || query + 1 >= (int32_t)m_timeQueries.size())
+		return false;
+
+	outStart = m_timeQueries[query];
+	outEnd = m_timeQueries[query + 1];
+	return true;
+}
+
+void RenderViewNull::pushMarker(const std::wstring& marker)
+{
+}
+
+void RenderViewNull::popMarker()
+{
+}
+
+void RenderViewNull::getStatistics(RenderViewStatistics& outStatistics) const
+{
+	outStatistics = m_statistics;
+}
+
+}
@@ -0,0 +1,115 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Timer/Timer.h"
+#include "Render/IRenderView.h"
+
+namespace traktor::render
+{
+
+class ContextNull;
+
+/*! Render view without any output.
+ * \ingroup Null
+ *
+ * All commands are accepted and counted but nothing
+ * is ever rendered.
+ */
+class RenderViewNull : public IRenderView
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit RenderViewNull(ContextNull* context);
+
+	virtual bool nextEvent(RenderEvent& outEvent) override final;
+
+	virtual void close() override final;
+
+	virtual bool reset(const RenderViewDefaultDesc& desc) override final;
+
+	virtual bool reset(int32_t width, int32_t height) override final;
+
+	virtual uint32_t getDisplay() const override final;
+
+	virtual int getWidth() const override final;
+
+	virtual int getHeight() const override final;
+
+	virtual bool isActive() const override final;
+
+	virtual bool isMinimized() const override final;
+
+	virtual bool isFullScreen() const override final;
+
+	virtual void showCursor() override final;
+
+	virtual void hideCursor() override final;
+
+	virtual bool isCursorVisible() const override final;
+
+	virtual bool setGamma(float gamma) override final;
+
+	virtual void setViewport(const Viewport& viewport) override final;
+
+	virtual SystemWindow getSystemWindow() override final;
+
+	virtual bool beginFrame() override final;
+
+	virtual void endFrame() override final;
+
+	virtual void present() override final;
+
+	virtual bool beginPass(const Clear* clear, uint32_t load, uint32_t store) override final;
+
+	virtual bool beginPass(IRenderTargetSet* renderTargetSet, const Clear* clear, uint32_t load, uint32_t store) override final;
+
+	virtual bool beginPass(IRenderTargetSet* renderTargetSet, int32_t renderTarget, const Clear* clear, uint32_t load, uint32_t store) override final;
+
+	virtual void endPass() override final;
+
+	virtual void draw(const IBufferView* vertexBuffer, const IVertexLayout* vertexLayout, const IBufferView* indexBuffer, IndexType indexType, IProgram* program, const Primitives& primitives, uint32_t instanceCount) override final;
+
+	virtual void drawIndirect(const IBufferView* vertexBuffer, const IVertexLayout* vertexLayout, const IBufferView* indexBuffer, IndexType indexType, IProgram* program, PrimitiveType primitiveType, const IBufferView* drawBuffer, uint32_t drawOffset, uint32_t drawCount) override final;
+
+	virtual void compute(IProgram* program, const int32_t* workSize) override final;
+
+	virtual void computeIndirect(IProgram* program, const IBufferView* workBuffer, uint32_t workOffset) override final;
+
+	virtual void barrier(Stage from, Stage to, ITexture* written, uint32_t writtenMip) override final;
+
+	virtual bool copy(ITexture* destinationTexture, const Region& destinationRegion, ITexture* sourceTexture, const Region& sourceRegion) override final;
+
+	virtual int32_t beginTimeQuery() override final;
+
+	virtual void endTimeQuery(int32_t query) override final;
+
+	virtual bool getTimeQuery(int32_t query, bool wait, double& outStart, double& outEnd) const override final;
+
+	virtual void pushMarker(const std::wstring& marker) override final;
+
+	virtual void popMarker() override final;
+
+	virtual void getStatistics(RenderViewStatistics& outStatistics) const override final;
+
+private:
+	Ref< ContextNull > m_context;
+	int32_t m_width = 1280;
+	int32_t m_height = 720;
+	bool m_cursorVisible = true;
+	IProgram* m_boundProgram = nullptr;
+	Timer m_timer;
+	AlignedVector< double > m_timeQueries;	//!< Start and end time of each query in current frame.
+	RenderViewStatistics m_statistics;
+};
+
+}
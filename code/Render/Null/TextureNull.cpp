@@ -0,0 +1,153 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cstring>
+#include "Core/Thread/Atomic.h"
+#include "Render/Null/ContextNull.h"
+#include "Render/Null/TextureNull.h"
+
+namespace traktor::render
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.render.TextureNull", TextureNull, ITexture)
+
+TextureNull::TextureNull(ContextNull* context, uint32_t& instances)
+:	m_context(context)
+,	m_instances(instances)
+{
+	Atomic::increment((int32_t&)m_instances);
+}
+
+TextureNull::~TextureNull()
+{
+	destroy();
+	Atomic::decrement((int32_t&)m_instances);
+}
+
+bool TextureNull::create(const SimpleTextureCreateDesc& desc)
+{
+	layout(1, desc.width, desc.height, 1, desc.mipCount, desc.format, desc.immutable);
+	for (int32_t mip = 0; mip < desc.mipCount; ++mip)
+	{
+		if (desc.initialData[mip].data)
+			upload(0, mip, desc.initialData[mip].data);
+	}
+	return true;
+}
+
+bool TextureNull::create(const CubeTextureCreateDesc& desc)
+{
+	layout(6, desc.side, desc.side, 1, desc.mipCount, desc.format, desc.immutable);
+	for (int32_t side = 0; side < 6; ++side)
+	{
+		for (int32_t mip = 0; mip < desc.mipCount; ++mip)
+		{
+			if (desc.initialData[side * desc.mipCount + mip].data)
+				upload(side, mip, desc.initialData[side * desc.mipCount + mip].data);
+		}
+	}
+	return true;
+}
+
+bool TextureNull::create(const VolumeTextureCreateDesc& desc)
+{
+	layout(1, desc.width, desc.height, desc.depth, 1, desc.format, desc.immutable);
+	if (desc.initialData[0].data)
+		upload(0, 0, desc.initialData[0].data);
+	return true;
+}
+
+bool TextureNull::create(int32_t width, int32_t height, TextureFormat format)
+{
+	layout(1, width, height, 1, 1, format, false);
+	return true;
+}
+
+void TextureNull::destroy()
+{
+	if (!m_offsets.empty())
+	{
+		m_context->memoryUsage -= m_data.size();
+		m_context->allocationCount--;
+		m_offsets.clear();
+		m_data.clear();
+	}
+}
+
+ITexture::Size TextureNull::getSize() const
+{
+	return m_size;
+}
+
+bool TextureNull::lock(int32_t side, int32_t level, Lock& lock)
+{
+	if (m_immutable || m_data.empty())
+		return false;
+	if (side < 0 || side >= m_sides || level < 0 || level >= m_size.mips)
+		return false;
+
+	lock.pitch = getTextureRowPitch(m_format, m_size.x, level);
+	lock.bits = &m_data[m_offsets[side * m_size.mips + level]];
+	return true;
+}
+
+void TextureNull::unlock(int32_t side, int32_t level)
+{
+	const int32_t index = side * m_size.mips + level;
+	m_context->bytesUploaded += m_offsets[index + 1] - m_offsets[index];
+}
+
+ITexture* TextureNull::resolve()
+{
+	return this;
+}
+
+const uint8_t* TextureNull::getData(int32_t side, int32_t level) const
+{
+	if (m_data.empty())
+		return nullptr;
+	return &m_data[m_offsets[side * m_size.mips + level]];
+}
+
+void TextureNull::layout(int32_t sides, int32_t width, int32_t height, int32_t depth, int32_t mips, TextureFormat format, bool immutable)
+{
+	m_size = { width, height, depth, mips };
+	m_sides = sides;
+	m_format = format;
+	m_immutable = immutable;
+
+	uint32_t offset = 0;
+	m_offsets.resize(0);
+	for (int32_t side = 0; side < sides; ++side)
+	{
+		for (int32_t mip = 0; mip < mips; ++mip)
+		{
+			m_offsets.push_back(offset);
+			offset += getTextureMipPitch(format, width, height, mip) * std::max(depth >> mip, 1);
+		}
+	}
+	m_offsets.push_back(offset);
+
+	if (!m_immutable)
+	{
+		m_data.resize(offset, 0);
+		m_context->memoryUsage += offset;
+	}
+	m_context->allocationCount++;
+}
+
+void TextureNull::upload(int32_t side, int32_t level, const void* data)
+{
+	const int32_t index = side * m_size.mips + level;
+	const uint32_t size = m_offsets[index + 1] - m_offsets[index];
+	if (!m_data.empty())
+		std::memcpy(&m_data[m_offsets[index]], data, size);
+	m_context->bytesUploaded += size;
+}
+
+}
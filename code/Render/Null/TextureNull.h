@@ -0,0 +1,73 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Render/ITexture.h"
+#include "Render/Types.h"
+
+namespace traktor::render
+{
+
+class ContextNull;
+
+/*! Texture kept in system memory.
+ * \ingroup Null
+ *
+ * Storage is only allocated for mutable textures,
+ * immutable textures only record uploaded size.
+ */
+class TextureNull : public ITexture
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit TextureNull(ContextNull* context, uint32_t& instances);
+
+	virtual ~TextureNull();
+
+	bool create(const SimpleTextureCreateDesc& desc);
+
+	bool create(const CubeTextureCreateDesc& desc);
+
+	bool create(const VolumeTextureCreateDesc& desc);
+
+	bool create(int32_t width, int32_t height, TextureFormat format);
+
+	virtual void destroy() override final;
+
+	virtual Size getSize() const override final;
+
+	virtual bool lock(int32_t side, int32_t level, Lock& lock) override final;
+
+	virtual void unlock(int32_t side, int32_t level) override final;
+
+	virtual ITexture* resolve() override final;
+
+	TextureFormat getFormat() const { return m_format; }
+
+	const uint8_t* getData(int32_t side, int32_t level) const;
+
+private:
+	Ref< ContextNull > m_context;
+	uint32_t& m_instances;
+	Size m_size = { 0, 0, 0, 0 };
+	int32_t m_sides = 0;
+	TextureFormat m_format = TfInvalid;
+	bool m_immutable = false;
+	AlignedVector< uint32_t > m_offsets;	//!< Offset into data of each side and mip level, last is total size.
+	AlignedVector< uint8_t > m_data;
+
+	void layout(int32_t sides, int32_t width, int32_t height, int32_t depth, int32_t mips, TextureFormat format, bool immutable);
+
+	void upload(int32_t side, int32_t level, const void* data);
+};
+
+}
@@ -0,0 +1,21 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Render/Null/VertexLayoutNull.h"
+
+namespace traktor::render
+{
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.render.VertexLayoutNull", VertexLayoutNull, IVertexLayout)
+
+VertexLayoutNull::VertexLayoutNull(uint32_t vertexSize)
+:	m_vertexSize(vertexSize)
+{
+}
+
+}
@@ -0,0 +1,32 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Render/IVertexLayout.h"
+
+namespace traktor::render
+{
+
+/*!
+ * \ingroup Null
+ */
+class VertexLayoutNull : public IVertexLayout
+{
+	T_RTTI_CLASS;
+
+public:
+	explicit VertexLayoutNull(uint32_t vertexSize);
+
+	uint32_t getVertexSize() const { return m_vertexSize; }
+
+private:
+	uint32_t m_vertexSize;
+};
+
+}
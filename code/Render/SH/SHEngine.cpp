@@ -106,6 +106,25 @@ void SHEngine::generateCoefficients(SHFunction* function, bool parallell, SHCoef
 		outResult[i] *= factor;
 }
 
+void SHEngine::generateCoefficients(const AlignedVector< Vector4 >& samples, SHCoeffs& outResult) const
+{
+	T_ASSERT(samples.size() == m_samplePoints.size());
+
+	const float weight = 4.0 * PI;
+	const uint32_t nsp = (uint32_t)m_samplePoints.size();
+
+	outResult.resize(m_bandCount);
+	for (uint32_t i = 0; i < nsp; ++i)
+	{
+		for (uint32_t n = 0; n < m_coefficientCount; ++n)
+			outResult[n] += samples[i] * m_samplePoints[i].coefficients[n];
+	}
+
+	const Scalar factor(weight / nsp);
+	for (uint32_t i = 0; i < m_coefficientCount; ++i)
+		outResult[i] *= factor;
+}
+
 // SHMatrix SHEngine::generateTransferMatrix(SHFunction* function) const
 // {
 // 	const double weight = 4.0 * PI;
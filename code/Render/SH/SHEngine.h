@@ -47,6 +47,11 @@ public:
 
 	void generateCoefficients(SHFunction* function, bool parallell, SHCoeffs& outResult);
 
+	/*! Project pre-evaluated samples, one per sample point in order. */
+	void generateCoefficients(const AlignedVector< Vector4 >& samples, SHCoeffs& outResult) const;
+
+	const AlignedVector< Sample >& getSamplePoints() const { return m_samplePoints; }
+
 	// SHMatrix generateTransferMatrix(SHFunction* function) const;
 
 private:
@@ -87,6 +87,18 @@ public:
 	 */
 	virtual bool isCacheable(const TypeInfo& productType) const = 0;
 
+	/*! Check if resources can be created asynchronously.
+	 *
+	 * Factories which create resources, and bind dependent
+	 * resources, through thread safe paths only, such as not
+	 * creating any render resources, can opt in to be called
+	 * from resource loader threads. Resources of other
+	 * factories are always created on calling thread.
+	 *
+	 * \return True if factory is thread safe.
+	 */
+	virtual bool isAsyncSafe() const { return false; }
+
 	/*! Create resource from guid.
 	 *
 	 * Create a specified resource from a guid.
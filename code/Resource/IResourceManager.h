@@ -10,6 +10,7 @@
 
 #include "Core/Object.h"
 #include "Core/Guid.h"
+#include "Core/Containers/SmallMap.h"
 #include "Resource/Id.h"
 #include "Resource/IdProxy.h"
 #include "Resource/Proxy.h"
@@ -29,6 +30,16 @@ class IResourceFactory;
 class ResourceBundle;
 class ResourceHandle;
 
+/*! Resource load timings.
+ * \ingroup Resource
+ */
+struct ResourceLoadStatistics
+{
+	uint32_t count = 0;				//!< Number of resources created.
+	double totalTime = 0.0;			//!< Total time spent in factory, in seconds.
+	double maxTime = 0.0;			//!< Longest time spent creating a single resource, in seconds.
+};
+
 /*! Resource manager statistics.
  * \ingroup Resource
  */
@@ -36,6 +47,9 @@ struct ResourceManagerStatistics
 {
 	uint32_t residentCount = 0;		//!< Number of resident resources.
 	uint32_t exclusiveCount = 0;	//!< Number of exclusive (non-shareable) resources.
+	uint32_t pendingCount = 0;		//!< Number of asynchronous loads waiting in queue.
+	uint32_t loadingCount = 0;		//!< Number of asynchronous loads currently in progress.
+	SmallMap< const TypeInfo*, ResourceLoadStatistics > loadTimings;	//!< Load timings per product type.
 };
 
 /*! Resource manager interface.
@@ -70,6 +84,17 @@ public:
 	 */
 	virtual bool load(const ResourceBundle* bundle) = 0;
 
+	/*! Load all resources in bundle asynchronously.
+	 *
+	 * Resources are queued and created on job threads,
+	 * method returns immediately.
+	 *
+	 * \param bundle Resource bundle.
+	 * \param priority Load priority, higher priority are loaded first.
+	 * \return True if all resources queued successfully.
+	 */
+	virtual bool loadAsync(const ResourceBundle* bundle, int32_t priority) = 0;
+
 	/*! Bind handle to resource identifier.
 	 *
 	 * \param productType Type of product.
@@ -78,6 +103,34 @@ public:
 	 */
 	virtual Ref< ResourceHandle > bind(const TypeInfo& productType, const Guid& guid) = 0;
 
+	/*! Bind handle to resource identifier asynchronously.
+	 *
+	 * Handle is returned immediately and resource
+	 * is replaced into handle when it has been created
+	 * on a job thread. Non-cacheable resources are
+	 * always created synchronously.
+	 *
+	 * \param productType Type of product.
+	 * \param guid Resource identifier.
+	 * \param priority Load priority, higher priority are loaded first.
+	 * \return Resource handle.
+	 */
+	virtual Ref< ResourceHandle > bindAsync(const TypeInfo& productType, const Guid& guid, int32_t priority) = 0;
+
+	/*! Cancel pending asynchronous load.
+	 *
+	 * \param guid Resource identifier.
+	 * \return True if a pending load was cancelled.
+	 */
+	virtual bool cancel(const Guid& guid) = 0;
+
+	/*! Wait until all asynchronous loads has finished.
+	 *
+	 * \param timeout Timeout in milliseconds; -1 if infinite timeout.
+	 * \return True if all loads finished, false if timeout.
+	 */
+	virtual bool wait(int32_t timeout = -1) = 0;
+
 	/*! Reload resource.
 	 *
 	 * \param guid Resource identifier.
@@ -144,6 +197,27 @@ public:
 		outProxy.replace(handle);
 		return bool(handle->get() != nullptr);
 	}
+
+	/*! Bind handle to resource identifier asynchronously.
+	 *
+	 * \param id Resource identifier.
+	 * \param outProxy Resource proxy, resource is null until loaded.
+	 * \param priority Load priority.
+	 * \return True if handle bound.
+	 */
+	template <
+		typename ResourceType,
+		typename ProductType
+	>
+	bool bindAsync(const Id< ResourceType >& id, Proxy< ProductType >& outProxy, int32_t priority = 0)
+	{
+		Ref< ResourceHandle > handle = bindAsync(type_of< ProductType >(), id, priority);
+		if (!handle)
+			return false;
+
+		outProxy = Proxy< ProductType >(handle);
+		return true;
+	}
 };
 
 }
@@ -13,4 +13,16 @@ namespace traktor::resource
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.resource.ResourceHandle", ResourceHandle, Object)
 
+ResourceHandle::~ResourceHandle()
+{
+	replace(nullptr);
+}
+
+void ResourceHandle::replace(Object* object) const
+{
+	T_SAFE_ADDREF(object);
+	Object* previous = m_object.exchange(object, std::memory_order_acq_rel);
+	T_SAFE_RELEASE(previous);
+}
+
 }
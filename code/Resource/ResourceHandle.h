@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Object.h"
 #include "Core/Ref.h"
 
@@ -30,24 +31,30 @@ class T_DLLCLASS ResourceHandle : public Object
 	T_RTTI_CLASS;
 
 public:
+	virtual ~ResourceHandle();
+
 	/*! Replace resource object.
+	 *
+	 * Object is published atomically since resources
+	 * can be loaded by asynchronous loader threads
+	 * while being read through proxies.
 	 *
 	 * \param object New resource object.
 	 */
-	void replace(Object* object) { m_object = object; }
+	void replace(Object* object) const;
 
 	/*! Get resource object.
 	 *
 	 * \return Resource object.
 	 */
-	Object* get() const { return m_object; }
+	Object* get() const { return m_object.load(std::memory_order_acquire); }
 
 	/*! Flush resource object.
 	 */
-	void flush() { m_object = nullptr; }
+	void flush() { replace(nullptr); }
 
-protected:
-	mutable Ref< Object > m_object;
+private:
+	mutable std::atomic< Object* > m_object = nullptr;
 };
 
 }
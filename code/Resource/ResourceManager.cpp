@@ -11,6 +11,7 @@
 #include "Core/Thread/Acquire.h"
 #include "Core/Thread/Thread.h"
 #include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/Timer.h"
 #include "Database/Database.h"
 #include "Database/Instance.h"
 #include "Resource/ExclusiveResourceHandle.h"
@@ -24,10 +25,16 @@ namespace traktor::resource
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.resource.ResourceManager", ResourceManager, IResourceManager)
 
-ResourceManager::ResourceManager(db::Database* database, bool verbose)
+ResourceManager::ResourceManager(db::Database* database, bool verbose, int32_t maxAsyncLoads)
 :	m_database(database)
 ,	m_verbose(verbose)
 {
+	// Limit number of concurrent loads to what database provider is able to read concurrently.
+	m_maxAsyncLoads = m_database ? m_database->getMaxConcurrentReads() : 1;
+	if (maxAsyncLoads > 0)
+		m_maxAsyncLoads = std::min(m_maxAsyncLoads, maxAsyncLoads);
+	m_maxAsyncLoads = std::max< int32_t >(m_maxAsyncLoads, 1);
+	m_asyncIdle.set();
 }
 
 ResourceManager::~ResourceManager()
@@ -37,6 +44,21 @@ ResourceManager::~ResourceManager()
 
 void ResourceManager::destroy()
 {
+	// Discard all queued asynchronous loads and wait for those in progress.
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+		m_asyncQueue.clear();
+		updateAsyncIdle();
+	}
+	wait(-1);
+
+	for (auto thread : m_asyncThreads)
+	{
+		thread->stop();
+		ThreadManager::getInstance().destroy(thread);
+	}
+	m_asyncThreads.clear();
+
 	for (auto& residentHandle : m_residentHandles)
 		residentHandle.second->replace(nullptr);
 
@@ -74,7 +96,6 @@ void ResourceManager::removeAllFactories()
 
 bool ResourceManager::load(const ResourceBundle* bundle)
 {
-	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	for (const auto& resource : bundle->get())
 	{
 		// Get resource instance from database.
@@ -116,30 +137,104 @@ bool ResourceManager::load(const ResourceBundle* bundle)
 			continue;
 		}
 
-		Ref< ResidentResourceHandle > residentHandle = m_residentHandles[resource.second];
-		if (residentHandle == nullptr || residentHandle->get() == nullptr)
-		{
-			const TypeInfo& productType = *(*productTypes.begin());
+		const TypeInfo& productType = *(*productTypes.begin());
 
-			if (!residentHandle)
-			{
-				residentHandle = new ResidentResourceHandle(productType, bundle->persistent());
-				m_residentHandles[resource.second] = residentHandle;
-			}
+		Ref< ResidentResourceHandle > residentHandle;
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+			Ref< ResidentResourceHandle >& handle = m_residentHandles[resource.second];
+			if (!handle)
+				handle = new ResidentResourceHandle(productType, bundle->persistent());
+			residentHandle = handle;
+		}
 
+		// Load resource unless already loaded; a queued asynchronous request is
+		// stolen and if resource is being loaded by another thread we wait for it.
+		if (acquireLoad(residentHandle))
+		{
 			load(instance, factory, productType, residentHandle);
+			releaseLoad(residentHandle);
+		}
 
-			if (!residentHandle->get())
-			{
-				log::error << L"Unable to preload resource " << resource.second.format() << L"; skipped." << Endl;
-				continue;
-			}
+		if (!residentHandle->get())
+		{
+			log::error << L"Unable to preload resource " << resource.second.format() << L"; skipped." << Endl;
+			continue;
 		}
 	}
 
 	return true;
 }
 
+bool ResourceManager::loadAsync(const ResourceBundle* bundle, int32_t priority)
+{
+	for (const auto& resource : bundle->get())
+	{
+		// Get resource instance from database.
+		Ref< db::Instance > instance = m_database->getInstance(resource.second);
+		if (!instance)
+		{
+			log::error << L"Unable to preload resource " << resource.second.format() << L"; no such instance." << Endl;
+			return false;
+		}
+
+		// Get type of resource.
+		const TypeInfo* resourceType = instance->getPrimaryType();
+		if (!resourceType)
+		{
+			log::error << L"Unable to preload resource " << resource.second.format() << L"; unable to read resource type." << Endl;
+			return false;
+		}
+
+		// Find factory which can create products from resource.
+		const IResourceFactory* factory = findFactory(*resourceType);
+		if (!factory)
+		{
+			log::error << L"Unable to preload resource " << resource.second.format() << L"; no factory for specified resource type \"" << resourceType->getName() << L"\"." << Endl;
+			return false;
+		}
+
+		// Determine product type; must be explicitly determined if we can safely preload the resource.
+		const TypeInfoSet productTypes = factory->getProductTypes(*resourceType);
+		if (productTypes.size() != 1)
+		{
+			log::warning << L"Unable to preload resource " << resource.second.format() << L"; unable to determine product type, skipped." << Endl;
+			continue;
+		}
+
+		const bool cacheable = factory->isCacheable(*resource.first);
+		if (!cacheable)
+		{
+			log::warning << L"Unable to preload resource " << resource.second.format() << L"; resource non cacheable, skipped." << Endl;
+			continue;
+		}
+
+		const TypeInfo& productType = *(*productTypes.begin());
+
+		Ref< ResidentResourceHandle > residentHandle;
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+			Ref< ResidentResourceHandle >& handle = m_residentHandles[resource.second];
+			if (!handle)
+				handle = new ResidentResourceHandle(productType, bundle->persistent());
+			residentHandle = handle;
+		}
+
+		if (residentHandle->get())
+			continue;
+
+		// Factory must explicitly allow being called from loader threads.
+		if (factory->isAsyncSafe())
+			enqueueAsync(resource.second, instance, factory, productType, residentHandle, priority);
+		else if (acquireLoad(residentHandle))
+		{
+			load(instance, factory, productType, residentHandle);
+			releaseLoad(residentHandle);
+		}
+	}
+	return true;
+}
+
 Ref< ResourceHandle > ResourceManager::bind(const TypeInfo& productType, const Guid& guid)
 {
 	Ref< ResourceHandle > handle;
@@ -214,15 +309,99 @@ Ref< ResourceHandle > ResourceManager::bind(const TypeInfo& productType, const G
 	}
 	T_ASSERT(handle);
 
-	// If no resource loaded into handle then load resource through factory.
-	if (!handle->get())
+	// If no resource loaded into handle then load resource through factory; cached
+	// resource might be queued, or currently loading, asynchronously.
+	if (cacheable)
+	{
+		if (acquireLoad(handle))
+		{
+			load(instance, factory, productType, handle);
+			releaseLoad(handle);
+		}
+	}
+	else if (!handle->get())
 		load(instance, factory, productType, handle);
 
 	return handle;
 }
 
+Ref< ResourceHandle > ResourceManager::bindAsync(const TypeInfo& productType, const Guid& guid, int32_t priority)
+{
+	if (guid.isNull() || !guid.isValid())
+	{
+		if (!guid.isNull())
+			log::error << L"Unable to bind a " << productType.getName() << L" resource; invalid id." << Endl;
+		return nullptr;
+	}
+
+	// Get resource instance from database.
+	Ref< db::Instance > instance = m_database->getInstance(guid);
+	if (!instance)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; no such instance (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
+
+	// Get type of resource.
+	const TypeInfo* resourceType = instance->getPrimaryType();
+	if (!resourceType)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; unable to read resource type (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
+
+	// Find factory which can create products from resource.
+	const IResourceFactory* factory = findFactory(*resourceType);
+	if (!factory)
+	{
+		log::error << L"Unable to bind a " << productType.getName() << L" resource; no factory for instance type \"" << resourceType->getName() << L"\" (" << guid.format() << L")." << Endl;
+		return nullptr;
+	}
+
+	// Exclusive handles are reused as soon as they're empty so we
+	// cannot leave them pending; load those, and resources of factories
+	// which cannot be called from loader threads, synchronously.
+	if (!factory->isCacheable(productType) || !factory->isAsyncSafe())
+		return bind(productType, guid);
+
+	Ref< ResidentResourceHandle > residentHandle;
+	{
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
+		Ref< ResidentResourceHandle >& handle = m_residentHandles[guid];
+		if (!handle)
+			handle = new ResidentResourceHandle(productType, false);
+		residentHandle = handle;
+	}
+
+	if (!residentHandle->get())
+		enqueueAsync(guid, instance, factory, productType, residentHandle, priority);
+
+	return residentHandle;
+}
+
+bool ResourceManager::cancel(const Guid& guid)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+	const auto it = std::find_if(m_asyncQueue.begin(), m_asyncQueue.end(), [&](const AsyncRequest& request) {
+		return request.guid == guid;
+	});
+	if (it == m_asyncQueue.end())
+		return false;
+	m_asyncQueue.erase(it);
+	updateAsyncIdle();
+	return true;
+}
+
+bool ResourceManager::wait(int32_t timeout)
+{
+	return m_asyncIdle.wait(timeout);
+}
+
 bool ResourceManager::reload(const Guid& guid, bool flushedOnly)
 {
+	// Ensure no asynchronous load replace resources behind our back.
+	wait(-1);
+
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 
 	if (guid.isNull() || !guid.isValid())
@@ -275,6 +454,9 @@ bool ResourceManager::reload(const Guid& guid, bool flushedOnly)
 
 void ResourceManager::reload(const TypeInfo& productType, bool flushedOnly)
 {
+	// Ensure no asynchronous load replace resources behind our back.
+	wait(-1);
+
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 
 	for (auto i = m_exclusiveHandles.begin(); i != m_exclusiveHandles.end(); ++i)
@@ -338,6 +520,9 @@ void ResourceManager::reload(const TypeInfo& productType, bool flushedOnly)
 
 void ResourceManager::unload(const TypeInfo& productType)
 {
+	// Ensure no asynchronous load replace resources behind our back.
+	wait(-1);
+
 	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_lock);
 	for (auto& pair : m_exclusiveHandles)
 	{
@@ -395,6 +580,10 @@ void ResourceManager::getStatistics(ResourceManagerStatistics& outStatistics) co
 	}
 
 	m_lock.release();
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+	outStatistics.pendingCount = (uint32_t)m_asyncQueue.size();
+	outStatistics.loadingCount = (uint32_t)m_asyncLoading.size();
+	outStatistics.loadTimings = m_loadTimings;
 }
 
 const IResourceFactory* ResourceManager::findFactory(const TypeInfo& resourceType) const
@@ -420,9 +609,19 @@ void ResourceManager::load(const db::Instance* instance, const IResourceFactory*
 		return;
 	}
 
+	Timer timer;
 	Ref< Object > object = factory->create(this, m_database, instance, productType, handle->get());
 	if (object)
 	{
+		const double duration = timer.getElapsedTime();
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+			auto& timing = m_loadTimings[&productType];
+			timing.count++;
+			timing.totalTime += duration;
+			timing.maxTime = std::max(timing.maxTime, duration);
+		}
+
 		if (m_verbose)
 			log::info << L"Resource \"" << instance->getGuid().format() << L"\" (" << type_name(object) << L") created." << Endl;
 
@@ -436,4 +635,152 @@ void ResourceManager::load(const db::Instance* instance, const IResourceFactory*
 		log::error << L"Unable to create resource \"" << instance->getGuid().format() << L"\" (" << productType.getName() << L") using factory \"" << type_name(factory) << L"\"." << Endl;
 }
 
+void ResourceManager::enqueueAsync(const Guid& guid, db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle, int32_t priority)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+
+	// Already queued; only raise priority.
+	for (auto& request : m_asyncQueue)
+	{
+		if (request.handle == handle)
+		{
+			request.priority = std::max(request.priority, priority);
+			return;
+		}
+	}
+
+	// Already being loaded.
+	for (const auto& loading : m_asyncLoading)
+	{
+		if (loading.handle == handle)
+			return;
+	}
+
+	auto& request = m_asyncQueue.push_back();
+	request.guid = guid;
+	request.instance = instance;
+	request.factory = factory;
+	request.productType = &productType;
+	request.handle = handle;
+	request.priority = priority;
+	request.sequence = m_asyncSequence++;
+
+	updateAsyncIdle();
+
+	// Loads are performed by dedicated threads since they block on database I/O,
+	// create threads lazily up to the limit of concurrent loads.
+	if ((int32_t)m_asyncThreads.size() < std::min< int32_t >(m_maxAsyncLoads, (int32_t)(m_asyncQueue.size() + m_asyncLoading.size())))
+	{
+		Thread* thread = ThreadManager::getInstance().create([this](){ threadAsyncLoad(); }, L"Resource loader");
+		if (thread)
+		{
+			thread->start(Thread::Below);
+			m_asyncThreads.push_back(thread);
+		}
+	}
+
+	m_asyncQueued.pulse();
+}
+
+bool ResourceManager::acquireLoad(const ResourceHandle* handle)
+{
+	for (;;)
+	{
+		Signal finished;
+
+		// Steal queued request, or register to be signaled when load in progress has finished.
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+
+			if (handle->get())
+				return false;
+
+			auto it = std::remove_if(m_asyncQueue.begin(), m_asyncQueue.end(), [&](const AsyncRequest& request) {
+				return request.handle == handle;
+			});
+			m_asyncQueue.erase(it, m_asyncQueue.end());
+
+			auto it2 = std::find_if(m_asyncLoading.begin(), m_asyncLoading.end(), [&](const AsyncLoading& loading) {
+				return loading.handle == handle;
+			});
+			if (it2 == m_asyncLoading.end())
+			{
+				auto& loading = m_asyncLoading.push_back();
+				loading.handle = handle;
+				loading.async = false;
+				updateAsyncIdle();
+				return true;
+			}
+
+			it2->waiters.push_back(&finished);
+		}
+
+		finished.wait();
+
+		// Loader signals while holding lock; ensure it's done with our signal before it's destroyed.
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+	}
+}
+
+void ResourceManager::releaseLoad(const ResourceHandle* handle)
+{
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+	auto it = std::find_if(m_asyncLoading.begin(), m_asyncLoading.end(), [&](const AsyncLoading& loading) {
+		return loading.handle == handle;
+	});
+	T_FATAL_ASSERT(it != m_asyncLoading.end());
+	for (auto waiter : it->waiters)
+		waiter->set();
+	m_asyncLoading.erase(it);
+	updateAsyncIdle();
+}
+
+void ResourceManager::updateAsyncIdle()
+{
+	// Only asynchronous loads are considered; loads performed by
+	// threads binding resources are waited for by those threads.
+	const bool busy = !m_asyncQueue.empty() || std::any_of(m_asyncLoading.begin(), m_asyncLoading.end(), [](const AsyncLoading& loading) {
+		return loading.async;
+	});
+	if (busy)
+		m_asyncIdle.reset();
+	else
+		m_asyncIdle.set();
+}
+
+void ResourceManager::threadAsyncLoad()
+{
+	Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+	while (!currentThread->stopped())
+	{
+		if (!m_asyncQueued.wait(100))
+			continue;
+
+		AsyncRequest request;
+		{
+			T_ANONYMOUS_VAR(Acquire< Semaphore >)(m_asyncLock);
+
+			// Request might have been cancelled or stolen.
+			if (m_asyncQueue.empty())
+				continue;
+
+			// Pick request with highest priority, first come first serve if equal priority.
+			auto it = std::max_element(m_asyncQueue.begin(), m_asyncQueue.end(), [](const AsyncRequest& lh, const AsyncRequest& rh) {
+				if (lh.priority != rh.priority)
+					return lh.priority < rh.priority;
+				else
+					return lh.sequence > rh.sequence;
+			});
+			request = *it;
+			m_asyncQueue.erase(it);
+			m_asyncLoading.push_back().handle = request.handle;
+		}
+
+		if (!request.handle->get())
+			load(request.instance, request.factory, *request.productType, request.handle);
+
+		releaseLoad(request.handle);
+	}
+}
+
 }
@@ -11,7 +11,9 @@
 #include <utility>
 #include "Core/RefArray.h"
 #include "Core/Containers/SmallMap.h"
+#include "Core/Thread/Event.h"
 #include "Core/Thread/Semaphore.h"
+#include "Core/Thread/Signal.h"
 #include "Resource/IResourceManager.h"
 
 // import/export mechanism.
@@ -22,6 +24,13 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class Thread;
+
+}
+
 namespace traktor::db
 {
 
@@ -45,7 +54,13 @@ class T_DLLCLASS ResourceManager : public IResourceManager
 	T_RTTI_CLASS;
 
 public:
-	explicit ResourceManager(db::Database* database, bool verbose);
+	/*! Construct resource manager.
+	 *
+	 * \param database Output database.
+	 * \param verbose Log each created resource.
+	 * \param maxAsyncLoads Maximum number of concurrent asynchronous loads from database, 0 if determined by database provider.
+	 */
+	explicit ResourceManager(db::Database* database, bool verbose, int32_t maxAsyncLoads = 0);
 
 	virtual ~ResourceManager();
 
@@ -59,8 +74,16 @@ public:
 
 	virtual bool load(const ResourceBundle* bundle) override final;
 
+	virtual bool loadAsync(const ResourceBundle* bundle, int32_t priority) override final;
+
 	virtual Ref< ResourceHandle > bind(const TypeInfo& productType, const Guid& guid) override final;
 
+	virtual Ref< ResourceHandle > bindAsync(const TypeInfo& productType, const Guid& guid, int32_t priority) override final;
+
+	virtual bool cancel(const Guid& guid) override final;
+
+	virtual bool wait(int32_t timeout = -1) override final;
+
 	virtual bool reload(const Guid& guid, bool flushedOnly) override final;
 
 	virtual void reload(const TypeInfo& productType, bool flushedOnly) override final;
@@ -72,16 +95,62 @@ public:
 	virtual void getStatistics(ResourceManagerStatistics& outStatistics) const override final;
 
 private:
+	struct AsyncRequest
+	{
+		Guid guid;
+		Ref< db::Instance > instance;
+		Ref< const IResourceFactory > factory;
+		const TypeInfo* productType = nullptr;
+		Ref< ResourceHandle > handle;
+		int32_t priority = 0;
+		uint32_t sequence = 0;
+	};
+
+	struct AsyncLoading
+	{
+		const ResourceHandle* handle = nullptr;
+		bool async = true;					//!< Loaded by loader thread, false if loaded by thread binding resource.
+		AlignedVector< Signal* > waiters;	//!< Signaled when load has finished.
+	};
+
 	Ref< db::Database > m_database;
 	AlignedVector< std::pair< const TypeInfo*, Ref< const IResourceFactory > > > m_resourceFactories;
 	SmallMap< Guid, Ref< ResidentResourceHandle > > m_residentHandles;
 	SmallMap< Guid, RefArray< ExclusiveResourceHandle > > m_exclusiveHandles;
+	AlignedVector< AsyncRequest > m_asyncQueue;
+	AlignedVector< AsyncLoading > m_asyncLoading;
+	SmallMap< const TypeInfo*, ResourceLoadStatistics > m_loadTimings;
+	AlignedVector< Thread* > m_asyncThreads;
+	Event m_asyncQueued;	//!< Pulsed once for each queued request.
+	Signal m_asyncIdle;		//!< Set when no requests are queued nor loading.
+	mutable Semaphore m_asyncLock;
 	mutable Semaphore m_lock;
+	int32_t m_maxAsyncLoads;
+	uint32_t m_asyncSequence = 0;
 	bool m_verbose;
 
 	const IResourceFactory* findFactory(const TypeInfo& resourceType) const;
 
 	void load(const db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle);
+
+	void enqueueAsync(const Guid& guid, db::Instance* instance, const IResourceFactory* factory, const TypeInfo& productType, ResourceHandle* handle, int32_t priority);
+
+	/*! Acquire exclusive right to load resource into handle.
+	 *
+	 * Queued asynchronous request of handle is stolen, if handle
+	 * is being loaded by another thread we wait until it's finished.
+	 *
+	 * \return True if acquired, false if resource already loaded.
+	 */
+	bool acquireLoad(const ResourceHandle* handle);
+
+	/*! Release right to load resource, notify waiting threads. */
+	void releaseLoad(const ResourceHandle* handle);
+
+	/*! Update idle signal, must be called with async lock held. */
+	void updateAsyncIdle();
+
+	void threadAsyncLoad();
 };
 
 }
@@ -115,6 +115,13 @@ bool MigrateTargetAction::execute(IProgressListener* progressListener)
 	db::ConnectionString outputDatabaseCs(L"provider=traktor.db.CompactDatabase;fileName=Content.compact;flushAlways=false");
 	db::ConnectionString applicationDatabaseCs(L"provider=traktor.db.CompactDatabase;fileName=Content.compact;readOnly=true");
 
+	// Emit a memory mapped, packed, archive instead if requested.
+	if (m_globalSettings->getProperty< bool >(L"Runtime.PackedDatabase", false))
+	{
+		outputDatabaseCs = db::ConnectionString(L"provider=traktor.db.PackedDatabase;fileName=Content.pak");
+		applicationDatabaseCs = db::ConnectionString(L"provider=traktor.db.PackedDatabase;fileName=Content.pak");
+	}
+
 	// Create migration configuration.
 	Ref< PropertyGroup > migrateConfiguration = new PropertyGroup();
 
@@ -161,9 +161,11 @@ void AudioLayer::update(const UpdateInfo& info)
 			m_autoPlay = true;
 	}
 
-	// Start playing sound if auto play is enabled.
+	// Start playing sound if auto play is enabled, sound might
+	// not have been loaded yet if bound asynchronously.
 	if (
 		m_autoPlay &&
+		m_sound &&
 		(!m_handle || !m_handle->isPlaying())
 	)
 	{
@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include "Core/Settings/PropertyBoolean.h"
+#include "Core/Settings/PropertyGroup.h"
 #include "Resource/IResourceManager.h"
 #include "Resource/Member.h"
 #include "Runtime/IEnvironment.h"
@@ -28,9 +30,18 @@ Ref< Layer > AudioLayerData::createInstance(Stage* stage, IEnvironment* environm
 	resource::IResourceManager* resourceManager = environment->getResource()->getResourceManager();
 	resource::Proxy< sound::Sound > sound;
 
-	// Bind proxies to resource manager.
-	if (!resourceManager->bind(m_sound, sound))
-		return nullptr;
+	// Bind proxies to resource manager; sound is bound asynchronously if resources
+	// are preloaded asynchronously, layer starts playing as soon as sound is loaded.
+	if (environment->getSettings()->getProperty< bool >(L"Runtime.AsyncPreloadResources", false))
+	{
+		if (!resourceManager->bindAsync(m_sound, sound))
+			return nullptr;
+	}
+	else
+	{
+		if (!resourceManager->bind(m_sound, sound))
+			return nullptr;
+	}
 
 	// Create layer instance.
 	return new AudioLayer(
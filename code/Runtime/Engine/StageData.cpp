@@ -51,8 +51,18 @@ Ref< Stage > StageData::createInstance(IEnvironment* environment, const Object*
 			Ref< const resource::ResourceBundle > resourceBundle = environment->getDatabase()->getObjectReadOnly< resource::ResourceBundle >(m_resourceBundle);
 			if (resourceBundle)
 			{
-				log::info << L"Preloading bundle \"" << m_resourceBundle.format() << L"\"..." << Endl;
-				resourceManager->load(resourceBundle);
+				// Asynchronous preloading let bundle resources be created on job threads while
+				// the stage is being created; binds of pending resources are resolved on demand.
+				if (environment->getSettings()->getProperty< bool >(L"Runtime.AsyncPreloadResources", false))
+				{
+					log::info << L"Preloading bundle \"" << m_resourceBundle.format() << L"\" asynchronously..." << Endl;
+					resourceManager->loadAsync(resourceBundle, 0);
+				}
+				else
+				{
+					log::info << L"Preloading bundle \"" << m_resourceBundle.format() << L"\"..." << Endl;
+					resourceManager->load(resourceBundle);
+				}
 			}
 		}
 	}
@@ -28,6 +28,9 @@
 #include "Runtime/Target/TargetProfilerDictionary.h"
 #include "Runtime/Target/TargetProfilerEvents.h"
 #include "Core/Platform.h"
+#include "Core/Io/FileOutputStream.h"
+#include "Core/Io/FileSystem.h"
+#include "Core/Io/Utf8Encoding.h"
 #include "Core/Library/Library.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Float.h"
@@ -46,6 +49,7 @@
 #include "Core/Thread/JobManager.h"
 #include "Core/Thread/Thread.h"
 #include "Core/Thread/ThreadManager.h"
+#include "Core/Timer/MetricsSnapshot.h"
 #include "Core/Timer/Profiler.h"
 #include "Database/Database.h"
 #include "Database/Events/EvtInstanceCommitted.h"
@@ -63,6 +67,8 @@ namespace traktor::runtime
 	{
 
 const int32_t c_databasePollInterval = 5;
+const double c_metricsExportInterval = 30.0;
+const double c_metricsPublishInterval = 1.0;
 
 class TargetPerformanceListener : public RefCountImpl< Profiler::IReportListener >
 {
@@ -383,6 +389,24 @@ bool Application::create(
 		log::info << L"Using single threaded rendering." << Endl;
 
 	m_pauseYield = settings->getProperty< bool >(L"Runtime.PauseYield", false);
+
+	// Frame phase metrics, durations in seconds.
+	Metrics& metrics = Metrics::getInstance();
+	m_metricFrame = metrics.registerHistogram(L"Runtime/Frame", 0.0001, 1.0);
+	m_metricUpdate = metrics.registerHistogram(L"Runtime/Update", 0.0001, 1.0);
+	m_metricPhysics = metrics.registerHistogram(L"Runtime/Physics", 0.0001, 1.0);
+	m_metricInput = metrics.registerHistogram(L"Runtime/Input", 0.0001, 1.0);
+	m_metricBuild = metrics.registerHistogram(L"Runtime/Build", 0.0001, 1.0);
+	m_metricRenderCPU = metrics.registerHistogram(L"Runtime/RenderCPU", 0.0001, 1.0);
+	m_metricRenderGPU = metrics.registerHistogram(L"Runtime/RenderGPU", 0.0001, 1.0);
+	m_metricGarbageCollect = metrics.registerHistogram(L"Runtime/GarbageCollect", 0.0001, 1.0);
+	m_metricSteps = metrics.registerCounter(L"Runtime/Steps");
+	m_metricCollisions = metrics.registerCounter(L"Runtime/Collisions");
+
+	// Export metrics to file, useful for long running sessions.
+	m_metricsFile = settings->getProperty< std::wstring >(L"Runtime.MetricsFile", L"");
+	m_metricsExportTime = m_timer.getElapsedTime();
+
 	m_settings = settings;
 	return true;
 }
@@ -391,6 +415,9 @@ void Application::destroy()
 {
 	Profiler::getInstance().setListener(nullptr);
 
+	if (!m_metricsFile.empty())
+		exportMetrics();
+
 	if (m_threadRender)
 	{
 		m_threadRender->stop();
@@ -641,6 +668,7 @@ bool Application::update()
 						// update phase, just continue as fast as possible.
 						renderCollision = true;
 						++m_renderCollisions;
+						Metrics::getInstance().increment(m_metricCollisions);
 					}
 				}
 
@@ -909,6 +937,28 @@ bool Application::update()
 		}
 
 #if T_MEASURE_PERFORMANCE
+		// Record frame phase metrics.
+		{
+			Metrics& metrics = Metrics::getInstance();
+			metrics.record(m_metricFrame, m_updateInfo.m_frameDeltaTime);
+			if (updateCount > 0)
+			{
+				metrics.record(m_metricUpdate, updateDuration / updateCount);
+				metrics.record(m_metricPhysics, physicsDuration / updateCount);
+				metrics.record(m_metricInput, inputDuration / updateCount);
+			}
+			metrics.record(m_metricBuild, buildTimeEnd - buildTimeStart);
+			metrics.record(m_metricRenderCPU, m_renderCpuDurations[0]);
+			if (m_renderGpuDuration > 0.0)
+				metrics.record(m_metricRenderGPU, m_renderGpuDuration);
+			metrics.record(m_metricGarbageCollect, gcDuration);
+			metrics.increment(m_metricSteps, updateCount);
+		}
+
+		// Export periodically in case application doesn't terminate gracefully.
+		if (!m_metricsFile.empty() && m_timer.getElapsedTime() - m_metricsExportTime >= c_metricsExportInterval)
+			exportMetrics();
+
 		// Publish performance to target manager.
 		if (m_targetManagerConnection && m_targetManagerConnection->connected())
 		{
@@ -989,6 +1039,20 @@ bool Application::update()
 					tp.activeSoundChannels = m_audioServer->getActiveSoundChannels();
 				m_targetPerformance.publish(m_targetManagerConnection->getTransport(), tp);
 			}
+
+			// Metrics, only those changed since last publish thus histograms are per interval.
+			if (m_timer.getElapsedTime() - m_metricsPublishTime >= c_metricsPublishInterval)
+			{
+				MetricsSnapshot snapshot;
+				Metrics::getInstance().snapshot(snapshot);
+
+				TpsMetrics tp;
+				snapshot.delta(m_metricsPublished, tp.metrics);
+				m_targetPerformance.publish(m_targetManagerConnection->getTransport(), tp);
+
+				m_metricsPublished.getEntries().swap(snapshot.getEntries());
+				m_metricsPublishTime = m_timer.getElapsedTime();
+			}
 		}
 #endif
 	}
@@ -1066,6 +1130,24 @@ void Application::pollDatabase()
 	}
 }
 
+void Application::exportMetrics()
+{
+	MetricsSnapshot snapshot;
+	Metrics::getInstance().snapshot(snapshot);
+
+	Ref< IStream > file = FileSystem::getInstance().open(m_metricsFile, File::FmWrite);
+	if (file)
+	{
+		FileOutputStream os(file, new Utf8Encoding());
+		snapshot.report(os);
+		os.close();
+	}
+	else
+		log::warning << L"Unable to export metrics to \"" << m_metricsFile << L"\"." << Endl;
+
+	m_metricsExportTime = m_timer.getElapsedTime();
+}
+
 void Application::threadDatabase()
 {
 	while (!m_threadDatabase->stopped())
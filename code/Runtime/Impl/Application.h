@@ -18,6 +18,8 @@
 #include "Core/Math/Color4f.h"
 #include "Core/Thread/TicketLock.h"
 #include "Core/Thread/Signal.h"
+#include "Core/Timer/Metrics.h"
+#include "Core/Timer/MetricsSnapshot.h"
 #include "Core/Timer/Timer.h"
 #include "Render/Types.h"
 
@@ -132,10 +134,26 @@ private:
 	UpdateInfo m_updateInfoRender;
 	render::RenderViewStatistics m_renderViewStats;
 	TargetPerformance m_targetPerformance;
+	Metrics::handle_t m_metricFrame = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricUpdate = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricPhysics = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricInput = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricBuild = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricRenderCPU = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricRenderGPU = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricGarbageCollect = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricSteps = Metrics::InvalidHandle;
+	Metrics::handle_t m_metricCollisions = Metrics::InvalidHandle;
+	std::wstring m_metricsFile;
+	double m_metricsExportTime = 0.0;
+	MetricsSnapshot m_metricsPublished;		//!< Metrics at last publish to target manager.
+	double m_metricsPublishTime = 0.0;
 	bool m_pauseYield = false;
 
 	void pollDatabase();
 
+	void exportMetrics();
+
 	void threadDatabase();
 
 	void threadRender();
@@ -52,6 +52,7 @@ bool AudioServer::create(const PropertyGroup* settings, const SystemApplication&
 	sound::AudioSystemCreateDesc ascd;
 	ascd.sysapp = sysapp;
 	ascd.channels = settings->getProperty< int32_t >(L"Audio.Channels", 16);
+	ascd.maxActiveChannels = settings->getProperty< int32_t >(L"Audio.MaxActiveChannels", 0);
 	ascd.driverDesc.sampleRate = settings->getProperty< int32_t >(L"Audio.SampleRate", 44100);
 	ascd.driverDesc.bitsPerSample = settings->getProperty< int32_t >(L"Audio.BitsPerSample", 16);
 	ascd.driverDesc.hwChannels = settings->getProperty< int32_t >(L"Audio.HwChannels", 2);
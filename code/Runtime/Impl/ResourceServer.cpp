@@ -13,6 +13,7 @@
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Settings/PropertyBoolean.h"
 #include "Core/Settings/PropertyGroup.h"
+#include "Core/Settings/PropertyInteger.h"
 #include "Render/IRenderSystem.h"
 #include "Resource/IResourceFactory.h"
 #include "Resource/ResourceManager.h"
@@ -25,7 +26,11 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.runtime.ResourceServer", ResourceServer, IResou
 
 bool ResourceServer::create(const PropertyGroup* settings, db::Database* database)
 {
-	m_resourceManager = new resource::ResourceManager(database, settings->getProperty< bool >(L"Resource.Verbose", false));
+	m_resourceManager = new resource::ResourceManager(
+		database,
+		settings->getProperty< bool >(L"Resource.Verbose", false),
+		settings->getProperty< int32_t >(L"Resource.MaxAsyncLoads", 0)
+	);
 	return true;
 }
 
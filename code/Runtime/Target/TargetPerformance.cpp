@@ -12,6 +12,7 @@
 #include "Core/Serialization/ISerializer.h"
 #include "Core/Serialization/Member.h"
 #include "Core/Serialization/MemberComplex.h"
+#include "Core/Serialization/MemberComposite.h"
 #include "Net/BidirectionalObjectTransport.h"
 #include "Runtime/Target/TargetPerformance.h"
 
@@ -184,6 +185,19 @@ void TpsAudio::serialize(ISerializer& s)
 	s >> Member< uint32_t >(L"activeSoundChannels", activeSoundChannels);
 }
 
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.runtime.TpsMetrics", 0, TpsMetrics, TargetPerfSet)
+
+bool TpsMetrics::check(const TargetPerfSet& old) const
+{
+	// Each set only contain metrics changed since previous set.
+	return !metrics.getEntries().empty();
+}
+
+void TpsMetrics::serialize(ISerializer& s)
+{
+	s >> MemberComposite< MetricsSnapshot >(L"metrics", metrics);
+}
+
 T_IMPLEMENT_RTTI_CLASS(L"traktor.runtime.TargetPerformance", TargetPerformance, Object)
 
 void TargetPerformance::publish(net::BidirectionalObjectTransport* transport, const TargetPerfSet& performance)
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Core/Serialization/ISerializable.h"
+#include "Core/Timer/MetricsSnapshot.h"
 #include "Core/Timer/Timer.h"
 #include "Render/Types.h"
 
@@ -128,6 +129,24 @@ public:
 	virtual void serialize(ISerializer& s) override final;
 };
 
+/*! Metrics changed since previous published set.
+ *
+ * Modules register their own counters, gauges and
+ * histograms in Metrics, thus no need to extend
+ * fixed performance sets.
+ */
+class T_DLLCLASS TpsMetrics : public TargetPerfSet
+{
+	T_RTTI_CLASS;
+
+public:
+	MetricsSnapshot metrics;
+
+	virtual bool check(const TargetPerfSet& old) const override final;
+
+	virtual void serialize(ISerializer& s) override final;
+};
+
 class T_DLLCLASS TargetPerformance : public Object
 {
 	T_RTTI_CLASS;
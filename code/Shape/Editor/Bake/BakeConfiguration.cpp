@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include "Core/Misc/Murmur3.h"
 #include "Core/Serialization/AttributeDirection.h"
 #include "Core/Serialization/AttributePrivate.h"
@@ -32,6 +33,16 @@ uint32_t BakeConfiguration::calculateModelRelevanteHash() const
 	return cs.get();
 }
 
+Ref< BakeConfiguration > BakeConfiguration::createPreview(uint32_t sampleDivisor) const
+{
+	T_ASSERT(sampleDivisor > 0);
+	Ref< BakeConfiguration > preview = new BakeConfiguration(*this);
+	preview->m_primarySampleCount = std::max< uint32_t >(m_primarySampleCount / sampleDivisor, 1);
+	preview->m_secondarySampleCount = std::max< uint32_t >(m_secondarySampleCount / sampleDivisor, 1);
+	preview->m_shadowSampleCount = std::max< uint32_t >(m_shadowSampleCount / sampleDivisor, 1);
+	return preview;
+}
+
 void BakeConfiguration::serialize(ISerializer& s)
 {
 	T_FATAL_ASSERT(s.getVersion< BakeConfiguration >() >= 17);
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Core/Guid.h"
+#include "Core/Ref.h"
 #include "Core/Math/Vector4.h"
 #include "Core/Serialization/ISerializable.h"
 
@@ -56,6 +57,9 @@ public:
 
 	uint32_t calculateModelRelevanteHash() const;
 
+	/*! Create a copy of this configuration with sample counts divided by sampleDivisor, used for quick preview bakes. */
+	Ref< BakeConfiguration > createPreview(uint32_t sampleDivisor) const;
+
 	virtual void serialize(ISerializer& s) override final;
 
 private:
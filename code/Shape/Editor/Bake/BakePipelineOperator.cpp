@@ -365,6 +365,7 @@ bool BakePipelineOperator::create(const editor::IPipelineSettings* settings)
 	m_assetPath = settings->getPropertyExcludeHash< std::wstring >(L"Pipeline.AssetPath", L"");
 	m_modelCachePath = settings->getPropertyExcludeHash< std::wstring >(L"Pipeline.ModelCache.Path", L"");
 	m_compressionMethod = settings->getPropertyIncludeHash< std::wstring >(L"BakePipelineOperator.CompressionMethod", L"FP16");
+	m_cachePath = settings->getPropertyExcludeHash< std::wstring >(L"BakePipelineOperator.CachePath", L"");
 	m_asynchronous = settings->getPropertyIncludeHash< bool >(L"Pipeline.TargetEditor", false) && !settings->getPropertyExcludeHash< bool >(L"Pipeline.TargetEditor.Build", false);
 	m_traceIrradianceGrid = settings->getPropertyIncludeHash< bool >(L"BakePipelineOperator.TraceIrradianceGrid", true);
 	m_traceCameras = settings->getPropertyIncludeHash< bool >(L"BakePipelineOperator.TraceImages", false);
@@ -400,7 +401,7 @@ bool BakePipelineOperator::create(const editor::IPipelineSettings* settings)
 
 	// In case we're running synchronous mode we create our own tracer processor.
 	if (!m_asynchronous)
-		ms_tracerProcessor = new TracerProcessor(m_tracerType, m_compressionMethod, false);
+		ms_tracerProcessor = new TracerProcessor(m_tracerType, m_compressionMethod, m_cachePath, false);
 
 	return true;
 }
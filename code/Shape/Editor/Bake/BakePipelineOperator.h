@@ -72,6 +72,7 @@ private:
 	std::wstring m_modelCachePath;
 	const TypeInfo* m_tracerType = nullptr;
 	std::wstring m_compressionMethod;
+	std::wstring m_cachePath;
 	bool m_asynchronous = false;
 	bool m_traceIrradianceGrid = false;
 	bool m_traceCameras = false;
@@ -6,7 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
-#include <functional>
+#include <algorithm>
 #include <embree4/rtcore.h>
 #include <embree4/rtcore_ray.h>
 #include "Core/Log/Log.h"
@@ -19,15 +19,12 @@
 #include "Drawing/PixelFormat.h"
 #include "Model/Operations/MergeModel.h"
 #include "Render/SH/SHEngine.h"
-#include "Render/SH/SHFunction.h"
 #include "Shape/Editor/Bake/BakeConfiguration.h"
 #include "Shape/Editor/Bake/GBuffer.h"
 #include "Shape/Editor/Bake/IProbe.h"
 #include "Shape/Editor/Bake/Embree/RayTracerEmbree.h"
 #include "Shape/Editor/Bake/Embree/SplitModel.h"
 
-#define USE_LAMBERTIAN_DIRECTION
-
 #if defined (_MSC_VER)
 #	define T_ALIGN64 __declspec(align(64))
 #elif defined(__GNUC__) || defined(__ANDROID__)
@@ -43,23 +40,6 @@ const Scalar p(1.0f / (2.0f * PI));
 const float c_epsilonOffset = 0.00001f;
 const int32_t c_valid[16] = { -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
 
-class WrappedSHFunction : public render::SHFunction
-{
-public:
-	explicit WrappedSHFunction(const std::function< Vector4 (const Vector4&) >& fn)
-	:	m_fn(fn)
-	{
-	}
-
-	virtual Vector4 evaluate(const Polar& direction) const override final
-	{
-		return m_fn(direction.toUnitCartesian());
-	}
-
-private:
-	std::function< Vector4 (const Vector4&) > m_fn;
-};
-
 Scalar attenuation(const Scalar& distance)
 {
 	return clamp(1.0_simd / (distance * distance), 0.0_simd, 1.0_simd);
@@ -72,21 +52,6 @@ Scalar attenuation(const Scalar& distance, const Scalar& range)
 	return k0 * k1;
 }
 
-Vector4 lambertianDirection(const Vector2& uv, const Vector4& direction)
-{
-	// Calculate random direction, with Gaussian probability distribution.
-	const float sin2_theta = uv.x;
-	const float cos2_theta = 1.0f - sin2_theta;
-	const float sin_theta = std::sqrt(sin2_theta);
-	const float cos_theta = std::sqrt(cos2_theta);
-	const float orientation = uv.y * TWO_PI;
-	const Vector4 dir(sin_theta * std::cos(orientation), sin_theta * std::sin(orientation), cos_theta, 0.0f);
-
-	Vector4 u, v;
-	orthogonalFrame(direction, u, v);
-	return (Matrix44(u, v, direction, Vector4::zero()) * dir).xyz0().normalized();
-}
-
 void constructRay(const Vector4& position, const Vector4& direction, float far, RTCRay& outRay)
 {
 	position.storeAligned(&outRay.org_x);
@@ -157,6 +122,14 @@ float wrap(float n)
 	return n - std::floor(n);
 }
 
+uint32_t octant(const Vector4& direction)
+{
+	return
+		(direction.x() < 0.0f ? 1 : 0) |
+		(direction.y() < 0.0f ? 2 : 0) |
+		(direction.z() < 0.0f ? 4 : 0);
+}
+
 	}
 
 T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.shape.RayTracerEmbree", 0, RayTracerEmbree, IRayTracer)
@@ -313,37 +286,60 @@ void RayTracerEmbree::commit()
 
 Ref< render::SHCoeffs > RayTracerEmbree::traceProbe(const Vector4& position) const
 {
+	constexpr int32_t SampleBatch = 16;
 	static thread_local RandomGeometry random;
+	static thread_local AlignedVector< Vector4 > samples;
 	static const float ProbeSize = 4.0f;
 
-	WrappedSHFunction shFunction([&] (const Vector4& unit) -> Vector4 {
+	const auto& samplePoints = m_shEngine->getSamplePoints();
+	const int32_t sampleCount = (int32_t)samplePoints.size();
+	samples.resize(sampleCount);
 
-		RTCRayHit T_ALIGN64 rh;
-		constructRayHit(position, unit, ProbeSize, rh);
+	RTCRayHit16 T_ALIGN64 rhv;
+	int32_t T_ALIGN64 valid[16];
+	float T_MATH_ALIGN16 normal[4];
 
-		RTCIntersectArguments iargs;
-		rtcInitIntersectArguments(&iargs);
-		iargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
-		rtcIntersect1(m_scene, &rh, &iargs);
+	RTCIntersectArguments iargs;
+	rtcInitIntersectArguments(&iargs);
+	iargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
 
-		if (rh.hit.geomID != RTC_INVALID_GEOMETRY_ID)
+	// Intersect probe directions in packets, then trace path from each direction.
+	for (int32_t i = 0; i < sampleCount; i += SampleBatch)
+	{
+		const int32_t count = std::min(sampleCount - i, SampleBatch);
+		for (int32_t j = 0; j < SampleBatch; ++j)
+		{
+			valid[j] = (j < count) ? -1 : 0;
+			if (j < count)
+				constructRayHit16(position, samplePoints[i + j].direction.toUnitCartesian(), ProbeSize, j, rhv);
+		}
+
+		rtcIntersect16(valid, m_scene, &rhv, &iargs);
+		m_rayCount += count;
+
+		for (int32_t j = 0; j < count; ++j)
 		{
-			float T_MATH_ALIGN16 normal[4];
-			const RTCGeometry geometry = rtcGetGeometry(m_scene, rh.hit.geomID);
-			rtcInterpolate0(geometry, rh.hit.primID, rh.hit.u, rh.hit.v, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, normal, 3);
-			const Vector4 hitNormal = Vector4::loadAligned(normal).xyz0().normalized();
-			if (dot3(hitNormal, unit) > 0.0f)
+			const Vector4 unit = samplePoints[i + j].direction.toUnitCartesian();
+			Scalar offset = 0.1_simd;
+
+			if (rhv.hit.geomID[j] != RTC_INVALID_GEOMETRY_ID)
 			{
-				// Probe most likely inside geometry; offset position.
-				return tracePath0(position + unit * Scalar(ProbeSize), unit, random, 0);
+				const RTCGeometry geometry = rtcGetGeometry(m_scene, rhv.hit.geomID[j]);
+				rtcInterpolate0(geometry, rhv.hit.primID[j], rhv.hit.u[j], rhv.hit.v[j], RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, normal, 3);
+				const Vector4 hitNormal = Vector4::loadAligned(normal).xyz0().normalized();
+				if (dot3(hitNormal, unit) > 0.0f)
+				{
+					// Probe most likely inside geometry; offset position.
+					offset = Scalar(ProbeSize);
+				}
 			}
-		}
 
-		return tracePath0(position + unit * 0.1_simd, unit, random, 0);
-	});
+			samples[i + j] = tracePath0(position + unit * offset, unit, random, 0);
+		}
+	}
 
 	Ref< render::SHCoeffs > shCoeffs = new render::SHCoeffs();
-	m_shEngine->generateCoefficients(&shFunction, false, *shCoeffs);
+	m_shEngine->generateCoefficients(samples, *shCoeffs);
 	return shCoeffs;
 }
 
@@ -356,14 +352,30 @@ void RayTracerEmbree::traceLightmap(const model::Model* model, const GBuffer* gb
 	const auto& polygons = model->getPolygons();
 	const auto& materials = model->getMaterials();
 
-	for (int32_t y = region[1]; y < region[3]; ++y)
+	// Texels are processed in batches of adjacent texels so
+	// occlusion rays can be traced in coherent packets.
+	int32_t xs[16], ys[16];
+	Vector4 origins[16], normals[16], ups[16];
+	Scalar occlusions[16], skyOcclusions[16];
+	int32_t count = 0;
+
+	for (int32_t i = 0; i < 16; ++i)
 	{
-		for (int32_t x = region[0]; x < region[2]; ++x)
-		{
-			const auto& e = gbuffer->get(x, y);
-			if (e.polygon == ~0U)
-				continue;
+		ups[i] = Vector4(0.0f, 1.0f, 0.0f);
+		occlusions[i] = 1.0_simd;
+	}
+
+	auto shade = [&]() {
+		// Trace ambient occlusion.
+		if (ambientOcclusion > Scalar(FUZZY_EPSILON))
+			traceOcclusion(origins, normals, count, 1.0f, random, occlusions);
 
+		// Trace sky occlusion.
+		traceOcclusion(origins, ups, count, 1000.0f, random, skyOcclusions);
+
+		for (int32_t i = 0; i < count; ++i)
+		{
+			const auto& e = gbuffer->get(xs[i], ys[i]);
 			const auto& originPolygon = polygons[e.polygon];
 			const auto& originMaterial = materials[originPolygon.getMaterial()];
 
@@ -372,19 +384,42 @@ void RayTracerEmbree::traceLightmap(const model::Model* model, const GBuffer* gb
 			// Trace IBL and indirect illumination.
 			const Color4f incoming = tracePath0(e.position, e.normal, random, 0);
 
-			// Trace ambient occlusion.
-			Scalar occlusion = 1.0_simd;
-			if (ambientOcclusion > Scalar(FUZZY_EPSILON))
-				occlusion = (1.0_simd - ambientOcclusion) + ambientOcclusion * traceOcclusion(e.position, e.normal, 1.0f, random);
-
-			// Trace sky occlusion.
-			const Scalar skyOcclusion = power(traceOcclusion(e.position, Vector4(0.0f, 1.0f, 0.0f), 1000.0f, random), 0.25_simd);
+			const Scalar occlusion = (1.0_simd - ambientOcclusion) + ambientOcclusion * occlusions[i];
+			const Scalar skyOcclusion = power(skyOcclusions[i], 0.25_simd);
 
 			// Combine and write final lumel.
 			const Color4f lightmapColor = emittance + incoming * occlusion;
-			lightmapDiffuse->setPixel(x, y, lightmapColor.rgb0() + Color4f(0.0f, 0.0f, 0.0f, skyOcclusion));
+			lightmapDiffuse->setPixel(xs[i], ys[i], lightmapColor.rgb0() + Color4f(0.0f, 0.0f, 0.0f, skyOcclusion));
+		}
+
+		count = 0;
+	};
+
+	for (int32_t y = region[1]; y < region[3]; ++y)
+	{
+		for (int32_t x = region[0]; x < region[2]; ++x)
+		{
+			const auto& e = gbuffer->get(x, y);
+			if (e.polygon == ~0U)
+				continue;
+
+			xs[count] = x;
+			ys[count] = y;
+			origins[count] = e.position;
+			normals[count] = e.normal;
+
+			if (++count >= 16)
+				shade();
 		}
 	}
+
+	if (count > 0)
+		shade();
+}
+
+uint64_t RayTracerEmbree::getRayCount() const
+{
+	return m_rayCount;
 }
 
 Color4f RayTracerEmbree::traceRay(const Vector4& position, const Vector4& direction) const
@@ -399,6 +434,7 @@ Color4f RayTracerEmbree::traceRay(const Vector4& position, const Vector4& direct
 	rtcInitIntersectArguments(&iargs);
 	iargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
 	rtcIntersect1(m_scene, &rh, &iargs);
+	++m_rayCount;
 
 	if (rh.hit.geomID == RTC_INVALID_GEOMETRY_ID)
 	{
@@ -469,6 +505,8 @@ Color4f RayTracerEmbree::tracePath0(
 ) const
 {
 	constexpr int SampleBatch = 16;
+	static thread_local AlignedVector< Vector4 > directions;
+	static thread_local ShadowStream shadowStream;
 	float T_MATH_ALIGN16 normalTmp[4];
 
 	int32_t sampleCount = m_configuration->getSecondarySampleCount();
@@ -476,29 +514,38 @@ Color4f RayTracerEmbree::tracePath0(
 		return Color4f(0.0f, 0.0f, 0.0f, 0.0f);
 	sampleCount = alignUp(sampleCount, SampleBatch);
 
+	// Generate directions across hemisphere, sort by octant so packets are coherent.
+	directions.resize(sampleCount);
+	for (int32_t i = 0; i < sampleCount; ++i)
+	{
+		const Vector2 uv = Quasirandom::hammersley(i, sampleCount, random);
+		directions[i] = Quasirandom::uniformHemiSphere(uv, normal);
+	}
+	std::sort(directions.begin(), directions.end(), [](const Vector4& lh, const Vector4& rh) {
+		return octant(lh) < octant(rh);
+	});
+
 	Color4f color(0.0f, 0.0f, 0.0f, 0.0f);
+	shadowStream.reset();
 
 	RTCRayHit16 T_ALIGN64 rhv;
-	Vector4 directions[SampleBatch];
 
-	// Sample across hemisphere.
+	RTCIntersectArguments iargs;
+	rtcInitIntersectArguments(&iargs);
+	iargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
+
+	// Trace packets and shade hits, shadow rays from all hits are deferred into a stream.
 	for (int32_t i = 0; i < sampleCount; i += SampleBatch)
 	{
 		for (int32_t j = 0; j < SampleBatch; ++j)
-		{
-			const Vector2 uv = Quasirandom::hammersley(i + j, sampleCount, random);
-			directions[j] = Quasirandom::uniformHemiSphere(uv, normal);
-			constructRayHit16(origin, directions[j], m_configuration->getMaxPathDistance(), j, rhv);
-		}
+			constructRayHit16(origin, directions[i + j], m_configuration->getMaxPathDistance(), j, rhv);
 
-		RTCIntersectArguments iargs;
-		rtcInitIntersectArguments(&iargs);
-		iargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
 		rtcIntersect16(c_valid, m_scene, &rhv, &iargs);
+		m_rayCount += SampleBatch;
 
 		for (int32_t j = 0; j < SampleBatch; ++j)
 		{
-			const auto& direction = directions[j];
+			const auto& direction = directions[i + j];
 
 			if (rhv.hit.geomID[j] == RTC_INVALID_GEOMETRY_ID)
 			{
@@ -535,37 +582,21 @@ Color4f RayTracerEmbree::tracePath0(
 				hitMaterialColor = hitMaterialColor.linear();
 			}
 			const Color4f emittance = hitMaterialColor * Scalar(100.0f * hitMaterial.getEmissive());
-			const Color4f BRDF = hitMaterialColor; // / Scalar(PI);
-
-			const Vector2 uv(random.nextFloat(), random.nextFloat());
-
-#if !defined(USE_LAMBERTIAN_DIRECTION)
-			const Vector4 newDirection = Quasirandom::uniformHemiSphere(uv, hitNormal);
-			const Scalar probability = 1.0_simd;
-#else
-			const Vector4 newDirection = lambertianDirection(uv, hitNormal);
-			const Scalar probability = 0.78532_simd; // 1.0_simd / Scalar(PI);	// PDF from cosine weighted direction, if uniform then this should be 1.
-#endif
+			color += emittance / hitDistance;
 
-			// const Scalar cosPhi = dot3(newDirection, hitNormal);
-			const Scalar cosPhi = abs(dot3(-direction, hitNormal));
-			const Color4f incoming = traceSinglePath(hitOrigin, newDirection, m_configuration->getMaxPathDistance(), random, extraLightMask, 1);
-			const Color4f direct = sampleAnalyticalLights(
-				random,
+			// Direct lighting at hit, weighted by hit albedo.
+			generateShadowRays(
 				hitOrigin,
 				hitNormal,
+				hitMaterialColor,
 				Light::LmIndirect | extraLightMask,
-				true
+				true,
+				shadowStream
 			);
-
-			const Color4f output =
-				emittance / hitDistance +
-				direct * hitMaterialColor;
-				(incoming * BRDF * cosPhi / probability);
-			color += output;
 		}
 	}
 
+	color += traceShadowRays(shadowStream);
 	color /= Scalar((float)sampleCount);
 
 	// Sample direct lighting from analytical lights.
@@ -574,130 +605,61 @@ Color4f RayTracerEmbree::tracePath0(
 	return color;
 }
 
-Color4f RayTracerEmbree::traceSinglePath(
-	const Vector4& origin,
-	const Vector4& direction,
+void RayTracerEmbree::traceOcclusion(
+	const Vector4* origins,
+	const Vector4* normals,
+	int32_t count,
 	float maxDistance,
 	RandomGeometry& random,
-	uint32_t extraLightMask,
-	int32_t depth
+	Scalar* outOcclusion
 ) const
 {
-	float T_MATH_ALIGN16 normalTmp[4];
-
-	if (depth > 3 || maxDistance <= 0.0f)
-		return Color4f(0.0f, 0.0f, 0.0f, 0.0f);
-
-	RTCRayHit T_ALIGN64 rh;
-	constructRayHit(origin, direction, maxDistance, rh);
-
-	RTCIntersectArguments iargs;
-	rtcInitIntersectArguments(&iargs);
-	iargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
-	rtcIntersect1(m_scene, &rh, &iargs);
+	T_ASSERT(count > 0 && count <= 16);
 
-	if (rh.hit.geomID == RTC_INVALID_GEOMETRY_ID)
+	int32_t sampleCount = m_configuration->getShadowSampleCount();
+	if (sampleCount <= 0)
 	{
-		// Nothing hit, sample sky if available else it's all black.
-		if (m_environment)
-			return m_environment->sampleRadiance(direction);
-		else
-			return Color4f(0.0f, 0.0f, 0.0f, 0.0f);
+		for (int32_t j = 0; j < count; ++j)
+			outOcclusion[j] = 1.0_simd;
+		return;
 	}
+	sampleCount = alignUp(sampleCount, 16);
 
-	const RTCGeometry geometry = rtcGetGeometry(m_scene, rh.hit.geomID);
+	RTCRay16 T_ALIGN64 rv;
+	int32_t T_ALIGN64 valid[16];
+	int32_t unoccluded[16] = { 0 };
 
-	const Scalar hitDistance = Scalar(rh.ray.tfar);
-	const Vector4 hitOrigin = (origin + direction * hitDistance).xyz1();
-	rtcInterpolate0(geometry, rh.hit.primID, rh.hit.u, rh.hit.v, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, normalTmp, 3);
-	const Vector4 hitNormal = Vector4::loadAligned(normalTmp).xyz0().normalized();
+	for (int32_t j = 0; j < 16; ++j)
+		valid[j] = (j < count) ? -1 : 0;
 
-	const uint32_t offset = m_materialOffset[rh.hit.geomID];
-	const auto& hitMaterial = *m_materials[offset + rh.hit.primID];
+	RTCOccludedArguments oargs;
+	rtcInitOccludedArguments(&oargs);
+	oargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
 
-	Color4f hitMaterialColor = hitMaterial.getColor().linear();
-	const auto& image = hitMaterial.getDiffuseMap().image;
-	if (image)
+	// Each packet contain the same sample from adjacent texels thus rays are coherent.
+	for (int32_t i = 0; i < sampleCount; ++i)
 	{
-		const uint32_t slot = 1;
-		float texCoord[2] = { 0.0f, 0.0f };
-		rtcInterpolate0(geometry, rh.hit.primID, rh.hit.u, rh.hit.v, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, slot, texCoord, 2);
-
-		image->getPixel(
-			(int32_t)(wrap(texCoord[0]) * image->getWidth()),
-			(int32_t)(wrap(texCoord[1]) * image->getHeight()),
-			hitMaterialColor
-		);
-		hitMaterialColor = hitMaterialColor.linear();
-	}
-	const Color4f emittance = hitMaterialColor * Scalar(100.0f * hitMaterial.getEmissive());
-	const Color4f BRDF = hitMaterialColor; // / Scalar(PI);
-
-	const Vector2 uv(random.nextFloat(), random.nextFloat());
-
-#if !defined(USE_LAMBERTIAN_DIRECTION)
-	const Vector4 newDirection = Quasirandom::uniformHemiSphere(uv, hitNormal);
-	const Scalar probability = 1.0_simd;
-#else
-	const Vector4 newDirection = lambertianDirection(uv, hitNormal);
-	const Scalar probability = 0.78532_simd; // 1.0_simd / Scalar(PI);	// PDF from cosine weighted direction, if uniform then this should be 1.
-#endif
-
-	//const Scalar cosPhi = dot3(newDirection, hitNormal);
-	const Scalar cosPhi = dot3(-direction, hitNormal);
-	const Color4f incoming = traceSinglePath(hitOrigin, newDirection, maxDistance - hitDistance, random, extraLightMask, depth + 1);
-	const Color4f direct = sampleAnalyticalLights(
-		random,
-		hitOrigin,
-		hitNormal,
-		Light::LmIndirect | extraLightMask,
-		true
-	);
-
-	const Color4f output = emittance / hitDistance + (incoming * BRDF * cosPhi / probability) + direct * hitMaterialColor; // * cosPhi;
-	return output;
-
-	//const Color4f incoming = direct + traceSinglePath(hitOrigin, newDirection, maxDistance - hitDistance, random, extraLightMask, depth + 1);
-	//const Color4f color = incoming * dot3(hitNormal, -direction) * hitMaterialColor;
-	//return color;
-}
-
-Scalar RayTracerEmbree::traceOcclusion(
-	const Vector4& origin,
-	const Vector4& normal,
-	float maxDistance,
-	RandomGeometry& random
-) const
-{
-	const int32_t sampleCount = alignUp(m_configuration->getShadowSampleCount(), 16);
-	RTCRay16 T_ALIGN64 rv;
-	int32_t unoccluded = 0;
-
-	for (int32_t i = 0; i < sampleCount; i += 16)
-	{
-		for (int32_t j = 0; j < 16; ++j)
+		for (int32_t j = 0; j < count; ++j)
 		{
-			const Vector2 uv = Quasirandom::hammersley(i + j, sampleCount, random);
-			const Vector4 direction = Quasirandom::uniformHemiSphere(uv, normal);
-			T_FATAL_ASSERT(dot3(direction, normal) >= 0.0_simd);
-			constructRay16(origin, direction, maxDistance, j, rv);
+			const Vector2 uv = Quasirandom::hammersley(i, sampleCount, random);
+			const Vector4 direction = Quasirandom::uniformHemiSphere(uv, normals[j]);
+			T_ASSERT(dot3(direction, normals[j]) >= 0.0_simd);
+			constructRay16(origins[j], direction, maxDistance, j, rv);
 		}
 
-		// Intersect test all rays using ray streams.
-		RTCOccludedArguments oargs;
-		rtcInitOccludedArguments(&oargs);
-		oargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
-		rtcOccluded16(c_valid, m_scene, &rv, &oargs);
+		rtcOccluded16(valid, m_scene, &rv, &oargs);
+		m_rayCount += count;
 
-		// Count number of occluded rays.
-		for (int32_t j = 0; j < 16; ++j)
+		// Count number of unoccluded rays.
+		for (int32_t j = 0; j < count; ++j)
 		{
 			if (rv.tfar[j] > rv.tnear[j])
-				unoccluded++;
+				unoccluded[j]++;
 		}
 	}
 
-	return Scalar(float(unoccluded) / sampleCount);
+	for (int32_t j = 0; j < count; ++j)
+		outOcclusion[j] = Scalar(float(unoccluded[j]) / sampleCount);
 }
 
 Color4f RayTracerEmbree::sampleAnalyticalLights(
@@ -707,15 +669,29 @@ Color4f RayTracerEmbree::sampleAnalyticalLights(
 	uint8_t mask,
 	bool bounce
  ) const
+{
+	static thread_local ShadowStream shadowStream;
+	shadowStream.reset();
+	generateShadowRays(origin, normal, Color4f(1.0f, 1.0f, 1.0f, 1.0f), mask, bounce, shadowStream);
+	return traceShadowRays(shadowStream);
+}
+
+void RayTracerEmbree::generateShadowRays(
+	const Vector4& origin,
+	const Vector4& normal,
+	const Color4f& weight,
+	uint8_t mask,
+	bool bounce,
+	ShadowStream& stream
+) const
 {
 	const uint32_t shadowSampleCount = !bounce ? (uint32_t)m_shadowSampleOffsets.size() : (m_shadowSampleOffsets.size() > 0 ? 1 : 0);
 	const float shadowRadius = !bounce ? m_configuration->getPointLightShadowRadius() : 0.0f;
 	const Scalar lightAttenution = Scalar(m_configuration->getAnalyticalLightAttenuation());
-	RTCRay T_ALIGN64 r = {};
 
-	Color4f contribution(0.0f, 0.0f, 0.0f, 0.0f);
-	for (const auto& light : m_lights)
+	for (uint32_t i = 0; i < (uint32_t)m_lights.size(); ++i)
 	{
+		const auto& light = m_lights[i];
 		if ((light.mask & mask) == 0)
 			continue;
 
@@ -727,43 +703,18 @@ Color4f RayTracerEmbree::sampleAnalyticalLights(
 				if (phi <= 0.0f)
 					break;
 
-				Scalar shadowAttenuate = 1.0_simd;
+				const uint32_t group = (uint32_t)stream.groups.size();
+				stream.groups.push_back({ light.color * phi * lightAttenution * weight, (int32_t)shadowSampleCount, 0 });
 
-				if (shadowSampleCount > 0)
+				Vector4 u, v;
+				orthogonalFrame(normal, u, v);
+
+				for (uint32_t j = 0; j < shadowSampleCount; ++j)
 				{
-					Vector4 u, v;
-					orthogonalFrame(normal, u, v);
-
-					int32_t shadowCount = 0;
-					for (uint32_t j = 0; j < shadowSampleCount; ++j)
-					{
-						const Vector4 traceDirection = -light.direction;
-						const Vector2 uv = m_shadowSampleOffsets[j];
-						Vector4 lumelPosition = origin;
-						lumelPosition += u * Scalar(uv.x * shadowRadius) + v * Scalar(uv.y * shadowRadius);
-
-						lumelPosition.storeAligned(&r.org_x); 
-						traceDirection.storeAligned(&r.dir_x);
-
-						r.tnear = c_epsilonOffset;
-						r.time = 0.0f;
-						r.tfar = 1000.0f;
-						r.mask = -1;
-						r.id = 0;
-						r.flags = 0;
-		
-						RTCOccludedArguments oargs;
-						rtcInitOccludedArguments(&oargs);
-						oargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
-						rtcOccluded1(m_scene, &r, &oargs);
-
-						if (r.tfar < 0.0f)
-							shadowCount++;
-					}
-					shadowAttenuate = Scalar(1.0f - float(shadowCount) / shadowSampleCount);
+					const Vector2 uv = m_shadowSampleOffsets[j];
+					const Vector4 lumelPosition = origin + u * Scalar(uv.x * shadowRadius) + v * Scalar(uv.y * shadowRadius);
+					stream.rays.push_back({ lumelPosition, -light.direction, 1000.0f, i, group });
 				}
-
-				contribution += light.color * phi * shadowAttenuate * lightAttenution;
 			}
 			break;
 
@@ -782,43 +733,18 @@ Color4f RayTracerEmbree::sampleAnalyticalLights(
 				if (f <= 0.0_simd)
 					break;
 
-				Scalar shadowAttenuate = 1.0_simd;
+				const uint32_t group = (uint32_t)stream.groups.size();
+				stream.groups.push_back({ light.color * phi * min(f, 1.0_simd) * lightAttenution * weight, (int32_t)shadowSampleCount, 0 });
 
-				if (shadowSampleCount > 0)
+				Vector4 u, v;
+				orthogonalFrame(lightDirection, u, v);
+
+				for (uint32_t j = 0; j < shadowSampleCount; ++j)
 				{
-					Vector4 u, v;
-					orthogonalFrame(lightDirection, u, v);
-
-					int32_t shadowCount = 0;
-					for (uint32_t j = 0; j < shadowSampleCount; ++j)
-					{
-						const Vector4 lumelPosition = origin;
-						const Vector2 uv = m_shadowSampleOffsets[j];
-						Vector4 traceDirection = (light.position - origin).xyz0().normalized();
-						traceDirection = (light.position + u * Scalar(uv.x * shadowRadius) + v * Scalar(uv.y * shadowRadius) - origin).xyz0().normalized();
-
-						lumelPosition.storeAligned(&r.org_x); 
-						traceDirection.storeAligned(&r.dir_x);
-
-						r.tnear = c_epsilonOffset;
-						r.time = 0.0f;
-						r.tfar = lightDistance - c_epsilonOffset * 2;
-						r.mask = -1;
-						r.id = 0;
-						r.flags = 0;
-		
-						RTCOccludedArguments oargs;
-						rtcInitOccludedArguments(&oargs);
-						oargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
-						rtcOccluded1(m_scene, &r, &oargs);
-
-						if (r.tfar < 0.0f)
-							shadowCount++;
-					}
-					shadowAttenuate = Scalar(1.0f - float(shadowCount) / shadowSampleCount);
+					const Vector2 uv = m_shadowSampleOffsets[j];
+					const Vector4 traceDirection = (light.position + u * Scalar(uv.x * shadowRadius) + v * Scalar(uv.y * shadowRadius) - origin).xyz0().normalized();
+					stream.rays.push_back({ origin, traceDirection, (float)lightDistance - c_epsilonOffset * 2.0f, i, group });
 				}
-
-				contribution += light.color * phi * min(f, 1.0_simd) * shadowAttenuate * lightAttenution;
 			}
 			break;
 
@@ -842,47 +768,71 @@ Color4f RayTracerEmbree::sampleAnalyticalLights(
 				if (k2 <= 0.0_simd)
 					break;
 
-				Scalar shadowAttenuate = 1.0_simd;
+				const uint32_t group = (uint32_t)stream.groups.size();
+				stream.groups.push_back({ light.color * k0 * k1 * k2 * lightAttenution * weight, (int32_t)shadowSampleCount, 0 });
+
+				Vector4 u, v;
+				orthogonalFrame(-lightToPoint, u, v);
 
-				if (shadowSampleCount > 0)
+				for (uint32_t j = 0; j < shadowSampleCount; ++j)
 				{
-					Vector4 u, v;
-					orthogonalFrame(-lightToPoint, u, v);
-
-					int32_t shadowCount = 0;
-					for (uint32_t j = 0; j < shadowSampleCount; ++j)
-					{
-						const Vector4 lumelPosition = origin;
-						const Vector2 uv = m_shadowSampleOffsets[j];
-						Vector4 traceDirection = (light.position - origin).xyz0().normalized();
-						traceDirection = (light.position + u * Scalar(uv.x * shadowRadius) + v * Scalar(uv.y * shadowRadius) - origin).xyz0().normalized();
-
-						lumelPosition.storeAligned(&r.org_x); 
-						traceDirection.storeAligned(&r.dir_x);
-
-						r.tnear = c_epsilonOffset;
-						r.time = 0.0f;
-						r.tfar = lightDistance - c_epsilonOffset * 2;
-						r.mask = -1;
-						r.id = 0;
-						r.flags = 0;
-		
-						RTCOccludedArguments oargs;
-						rtcInitOccludedArguments(&oargs);
-						oargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
-						rtcOccluded1(m_scene, &r, &oargs);
-
-						if (r.tfar < 0.0f)
-							shadowCount++;
-					}
-					shadowAttenuate = Scalar(1.0f - float(shadowCount) / shadowSampleCount);
+					const Vector2 uv = m_shadowSampleOffsets[j];
+					const Vector4 traceDirection = (light.position + u * Scalar(uv.x * shadowRadius) + v * Scalar(uv.y * shadowRadius) - origin).xyz0().normalized();
+					stream.rays.push_back({ origin, traceDirection, (float)lightDistance - c_epsilonOffset * 2.0f, i, group });
 				}
-
-				contribution += light.color * k0 * k1 * k2 * shadowAttenuate * lightAttenution;
 			}
 			break;
 		}
 	}
+}
+
+Color4f RayTracerEmbree::traceShadowRays(ShadowStream& stream) const
+{
+	RTCRay16 T_ALIGN64 rv;
+	int32_t T_ALIGN64 valid[16];
+
+	// Group rays towards the same light into same packets.
+	std::sort(stream.rays.begin(), stream.rays.end(), [](const ShadowRay& lh, const ShadowRay& rh) {
+		return lh.light < rh.light;
+	});
+
+	RTCOccludedArguments oargs;
+	rtcInitOccludedArguments(&oargs);
+	oargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
+
+	const uint32_t rayCount = (uint32_t)stream.rays.size();
+	for (uint32_t i = 0; i < rayCount; i += 16)
+	{
+		const uint32_t count = std::min< uint32_t >(rayCount - i, 16);
+		for (uint32_t j = 0; j < 16; ++j)
+		{
+			if (j < count)
+			{
+				const auto& shadowRay = stream.rays[i + j];
+				constructRay16(shadowRay.origin, shadowRay.direction, shadowRay.far, j, rv);
+				rv.tnear[j] = c_epsilonOffset;
+				valid[j] = -1;
+			}
+			else
+				valid[j] = 0;
+		}
+
+		rtcOccluded16(valid, m_scene, &rv, &oargs);
+		m_rayCount += count;
+
+		for (uint32_t j = 0; j < count; ++j)
+		{
+			if (rv.tfar[j] < 0.0f)
+				stream.groups[stream.rays[i + j].group].occludedCount++;
+		}
+	}
+
+	Color4f contribution(0.0f, 0.0f, 0.0f, 0.0f);
+	for (const auto& group : stream.groups)
+	{
+		const Scalar shadowAttenuate = (group.rayCount > 0) ? Scalar(1.0f - float(group.occludedCount) / group.rayCount) : 1.0_simd;
+		contribution += group.contribution * shadowAttenuate;
+	}
 	return contribution;
 }
 
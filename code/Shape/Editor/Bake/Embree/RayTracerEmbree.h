@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <embree4/rtcore.h>
 #include "Model/Model.h"
 #include "Shape/Editor/Bake/IRayTracer.h"
@@ -54,6 +55,8 @@ public:
 
 	virtual Color4f traceRay(const Vector4& position, const Vector4& direction) const override final;
 
+	virtual uint64_t getRayCount() const override final;
+
 private:
 	struct Surface
 	{
@@ -69,6 +72,35 @@ private:
 		operator const Vector4& () const { return position; }
 	};
 
+	struct ShadowRay
+	{
+		Vector4 origin;
+		Vector4 direction;
+		float far;
+		uint32_t light;
+		uint32_t group;
+	};
+
+	struct ShadowGroup
+	{
+		Color4f contribution;	//!< Unshadowed contribution of light.
+		int32_t rayCount;
+		int32_t occludedCount;
+	};
+
+	//! Shadow rays are generated into a stream and traced in packets once all rays are known.
+	struct ShadowStream
+	{
+		AlignedVector< ShadowRay > rays;
+		AlignedVector< ShadowGroup > groups;
+
+		void reset()
+		{
+			rays.resize(0);
+			groups.resize(0);
+		}
+	};
+
 	const BakeConfiguration* m_configuration = nullptr;
 	Ref< const IProbe > m_environment;
 	AlignedVector< Vector2 > m_shadowSampleOffsets;
@@ -81,6 +113,7 @@ private:
 	AlignedVector< const model::Material* > m_materials;
 	Ref< render::SHEngine > m_shEngine;
 	Aabb3 m_boundingBox;
+	mutable std::atomic< uint64_t > m_rayCount = 0;
 
 	Color4f tracePath0(
 		const Vector4& origin,
@@ -89,30 +122,34 @@ private:
 		uint32_t extraLightMask
 	) const;
 
-	Color4f traceSinglePath(
-		const Vector4& origin,
-		const Vector4& direction,
+	void traceOcclusion(
+		const Vector4* origins,
+		const Vector4* normals,
+		int32_t count,
 		float maxDistance,
 		RandomGeometry& random,
-		uint32_t extraLightMask,
-		int32_t depth
+		Scalar* outOcclusion
 	) const;
 
-	Scalar traceOcclusion(
+	Color4f sampleAnalyticalLights(
+		RandomGeometry& random,
 		const Vector4& origin,
 		const Vector4& normal,
-		float maxDistance,
-		RandomGeometry& random
+		uint8_t mask,
+		bool bounce
 	) const;
 
-	Color4f sampleAnalyticalLights(
-		RandomGeometry& random,
+	void generateShadowRays(
 		const Vector4& origin,
 		const Vector4& normal,
+		const Color4f& weight,
 		uint8_t mask,
-		bool bounce
+		bool bounce,
+		ShadowStream& stream
 	) const;
 
+	Color4f traceShadowRays(ShadowStream& stream) const;
+
 	static void alphaTestFilter(const RTCFilterFunctionNArguments* args);
 
 	static void shadowOccluded(const RTCFilterFunctionNArguments* args);
@@ -73,6 +73,9 @@ public:
 	virtual void traceLightmap(const model::Model* model, const GBuffer* gbuffer, drawing::Image* lightmapDiffuse, const int32_t region[4]) const = 0;
 
 	virtual Color4f traceRay(const Vector4& position, const Vector4& direction) const = 0;
+
+	/*! Get number of rays traced since created, used to measure tracing performance. */
+	virtual uint64_t getRayCount() const = 0;
 };
 
 }
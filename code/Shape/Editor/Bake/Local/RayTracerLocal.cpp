@@ -166,6 +166,11 @@ Color4f RayTracerLocal::traceRay(const Vector4& position, const Vector4& directi
 	return Color4f(0.0f, 0.0f, 0.0f, 1.0f);
 }
 
+uint64_t RayTracerLocal::getRayCount() const
+{
+	return m_rayCount;
+}
+
 /*
 Ref< drawing::Image > RayTracerLocal::traceDirect(const GBuffer* gbuffer) const
 {
@@ -347,6 +352,7 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 				Scalar phi = dot3(normal, -light.direction);
 				if (phi > 0.0f)
 				{
+					++m_rayCount;
 					if (!m_sah.queryAnyIntersection(
 						origin + normal * c_epsilonOffset,
 						-light.direction,
@@ -399,6 +405,7 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 
 						Vector4 shadowDirection = (light.position + u * Scalar(a * pointLightShadowRadius) + v * Scalar(b * pointLightShadowRadius) - origin).xyz0();
 
+						++m_rayCount;
 						if (m_sah.queryAnyIntersection(origin + normal * c_epsilonOffset, shadowDirection.normalized(), lightDistance - c_epsilonOffset, -1, sahCache))
 							shadowCount++;
 					}
@@ -452,6 +459,7 @@ Color4f RayTracerLocal::sampleAnalyticalLights(
 
 						Vector4 shadowDirection = (light.position + u * Scalar(a * pointLightShadowRadius) + v * Scalar(b * pointLightShadowRadius) - origin).xyz0();
 
+						++m_rayCount;
 						if (m_sah.queryAnyIntersection(origin + normal * c_epsilonOffset, shadowDirection.normalized(), lightDistance - c_epsilonOffset, -1, sahCache))
 							shadowCount++;
 					}
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Math/RandomGeometry.h"
 #include "Core/Math/SahTree.h"
 #include "Shape/Editor/Bake/IRayTracer.h"
@@ -44,6 +45,8 @@ public:
 
 	virtual Color4f traceRay(const Vector4& position, const Vector4& direction) const override final;
 
+	virtual uint64_t getRayCount() const override final;
+
 private:
 	struct Surface
 	{
@@ -56,6 +59,7 @@ private:
 	AlignedVector< Winding3 > m_windings;
 	AlignedVector< Surface > m_surfaces;
 	float m_maxDistance;
+	mutable std::atomic< uint64_t > m_rayCount = 0;
 
     void cullLights(const GBuffer* gbuffer, AlignedVector< Light >& outLights) const;
 
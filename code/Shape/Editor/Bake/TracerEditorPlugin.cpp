@@ -72,9 +72,12 @@ void TracerEditorPlugin::handleWorkspaceOpened()
 	if (!tracerType)
 		return;
 
+	const std::wstring cachePath = m_editor->getSettings()->getProperty< std::wstring >(L"BakePipelineOperator.CachePath", L"");
+
     BakePipelineOperator::setTracerProcessor(new TracerProcessor(
 		tracerType,
 		L"FP16",
+		cachePath,
 		true
 	));
 }
@@ -8,17 +8,22 @@
  */
 #include <numeric>
 #include "Compress/Lzf/DeflateStreamLzf.h"
+#include "Compress/Lzf/InflateStreamLzf.h"
 #include "Core/Io/BufferedStream.h"
+#include "Core/Io/DynamicMemoryStream.h"
 #include "Core/Io/FileSystem.h"
+#include "Core/Io/Reader.h"
 #include "Core/Io/Writer.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Const.h"
 #include "Core/Math/Format.h"
 #include "Core/Math/Random.h"
 #include "Core/Math/Winding3.h"
+#include "Core/Misc/MD5.h"
 #include "Core/Misc/SafeDestroy.h"
 #include "Core/Misc/String.h"
 #include "Core/Misc/TString.h"
+#include "Core/Serialization/DeepHash.h"
 #include "Core/Singleton/SingletonManager.h"
 #include "Core/Thread/Acquire.h"
 #include "Core/Thread/Job.h"
@@ -44,6 +49,7 @@
 #include "Render/SH/SHCoeffs.h"
 #include "Shape/Editor/Bake/BakeConfiguration.h"
 #include "Shape/Editor/Bake/GBuffer.h"
+#include "Shape/Editor/Bake/IProbe.h"
 #include "Shape/Editor/Bake/IRayTracer.h"
 #include "Shape/Editor/Bake/TracerCamera.h"
 #include "Shape/Editor/Bake/TracerEnvironment.h"
@@ -60,6 +66,9 @@ namespace traktor::shape
 	namespace
 	{
 
+const uint32_t c_cacheVersion = 1;
+const uint32_t c_previewSampleDivisor = 8;
+
 Ref< drawing::Image > denoise(const GBuffer& gbuffer, drawing::Image* lightmap, bool directional)
 {
 	const int32_t width = lightmap->getWidth();
@@ -260,13 +269,185 @@ bool writeTexture(
 	return true;
 }
 
+bool writeIrradiance(db::Instance* outputInstance, const AlignedVector< uint8_t >& data)
+{
+	if (!outputInstance->checkout())
+		return false;
+
+	Ref< world::IrradianceGridResource > outputResource = new world::IrradianceGridResource();
+	outputInstance->setObject(outputResource);
+
+	// Create output data stream.
+	Ref< IStream > stream = outputInstance->writeData(L"Data");
+	if (!stream)
+	{
+		outputInstance->revert();
+		return false;
+	}
+
+	Writer(stream).write(data.c_ptr(), data.size());
+	stream->close();
+
+	if (!outputInstance->commit())
+		return false;
+
+	return true;
+}
+
+void feedVector(MD5& md5, const Vector4& v)
+{
+	float e[4];
+	v.storeUnaligned(e);
+	md5.feedBuffer(e, sizeof(e));
+}
+
+void feedTransform(MD5& md5, const Transform& transform)
+{
+	feedVector(md5, transform.translation());
+	feedVector(md5, transform.rotation().e);
+}
+
+void feedLight(MD5& md5, const Light& light)
+{
+	md5.feed((int32_t)light.type);
+	feedVector(md5, light.position);
+	feedVector(md5, light.direction);
+	feedVector(md5, (Vector4)light.color);
+	md5.feed((float)light.range);
+	md5.feed((float)light.radius);
+	md5.feed(light.surface);
+	md5.feed(light.mask);
+}
+
+/*! Calculate cache keys of each lightmap and irradiance output.
+ *
+ * A lightmap key includes everything which might affect the
+ * result of the output; the output model itself, models which are
+ * within path distance from output and lights which reach output
+ * including models which might cast shadows from those lights.
+ * Influence is approximated conservatively using bounding boxes.
+ */
+void calculateKeys(const TracerTask* task, const TypeInfo* rayTracerType, AlignedVector< std::wstring >& outOutputKeys, AlignedVector< std::wstring >& outIrradianceKeys)
+{
+	const auto configuration = task->getConfiguration();
+	const auto& tracerModels = task->getTracerModels();
+	const auto& tracerLights = task->getTracerLights();
+
+	// Hash scene content once as it's shared among all outputs.
+	const uint32_t configurationHash = DeepHash(configuration).get();
+
+	AlignedVector< uint32_t > environmentHashes;
+	for (auto tracerEnvironment : task->getTracerEnvironments())
+		environmentHashes.push_back(DeepHash(tracerEnvironment->getEnvironment()).get());
+
+	AlignedVector< uint32_t > modelHashes;
+	AlignedVector< Aabb3 > modelBoundingBoxes;
+	Aabb3 sceneBoundingBox;
+	for (auto tracerModel : tracerModels)
+	{
+		modelHashes.push_back(DeepHash(tracerModel->getModel()).get());
+		modelBoundingBoxes.push_back(tracerModel->getModel()->getBoundingBox().transform(tracerModel->getTransform()));
+		sceneBoundingBox.contain(modelBoundingBoxes.back());
+	}
+
+	const Scalar sceneSize = !sceneBoundingBox.empty() ? (sceneBoundingBox.getExtent() * 2.0_simd).length() : 0.0_simd;
+	const Scalar maxPathDistance(configuration->getMaxPathDistance());
+
+	auto beginKey = [&](MD5& md5) {
+		md5.begin();
+		md5.feed(c_cacheVersion);
+		md5.feed(configurationHash);
+		md5.feed(rayTracerType->getName());
+		for (auto environmentHash : environmentHashes)
+			md5.feed(environmentHash);
+	};
+
+	outOutputKeys.resize(0);
+	for (auto tracerOutput : task->getTracerOutputs())
+	{
+		MD5 md5;
+		beginKey(md5);
+
+		md5.feed(DeepHash(tracerOutput->getModel()).get());
+		feedTransform(md5, tracerOutput->getTransform());
+		md5.feed(tracerOutput->getLightmapSize());
+
+		const Aabb3 outputBoundingBox = tracerOutput->getModel()->getBoundingBox().transform(tracerOutput->getTransform());
+		const Aabb3 influenceBoundingBox = outputBoundingBox.expand(maxPathDistance);
+
+		// Include lights which can reach output, either directly or through a bounce,
+		// and determine volumes in which an occluder might cast a shadow onto output.
+		AlignedVector< Aabb3 > shadowBoundingBoxes;
+		for (auto tracerLight : tracerLights)
+		{
+			const Light& light = tracerLight->getLight();
+			Aabb3 shadowBoundingBox = influenceBoundingBox;
+			if (light.type == Light::LtDirectional)
+			{
+				const Vector4 offset = -light.direction * sceneSize;
+				shadowBoundingBox.contain(influenceBoundingBox.mn + offset);
+				shadowBoundingBox.contain(influenceBoundingBox.mx + offset);
+			}
+			else
+			{
+				if (!influenceBoundingBox.queryIntersectionSphere(light.position, light.range))
+					continue;
+				shadowBoundingBox.contain(light.position);
+			}
+			shadowBoundingBoxes.push_back(shadowBoundingBox);
+			feedLight(md5, light);
+		}
+
+		// Include models which might affect output.
+		for (uint32_t i = 0; i < tracerModels.size(); ++i)
+		{
+			const Aabb3& modelBoundingBox = modelBoundingBoxes[i];
+			bool affects = modelBoundingBox.overlap(influenceBoundingBox);
+			for (uint32_t j = 0; !affects && j < shadowBoundingBoxes.size(); ++j)
+				affects = modelBoundingBox.overlap(shadowBoundingBoxes[j]);
+			if (affects)
+			{
+				md5.feed(modelHashes[i]);
+				feedTransform(md5, tracerModels[i]->getTransform());
+			}
+		}
+
+		md5.end();
+		outOutputKeys.push_back(md5.format());
+	}
+
+	// Irradiance probes can be affected by entire scene.
+	outIrradianceKeys.resize(0);
+	for (auto tracerIrradiance : task->getTracerIrradiances())
+	{
+		MD5 md5;
+		beginKey(md5);
+
+		feedVector(md5, tracerIrradiance->getBoundingBox().mn);
+		feedVector(md5, tracerIrradiance->getBoundingBox().mx);
+
+		for (auto tracerLight : tracerLights)
+			feedLight(md5, tracerLight->getLight());
+
+		for (uint32_t i = 0; i < tracerModels.size(); ++i)
+		{
+			md5.feed(modelHashes[i]);
+			feedTransform(md5, tracerModels[i]->getTransform());
+		}
+
+		md5.end();
+		outIrradianceKeys.push_back(md5.format());
+	}
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.shape.TracerProcessor", TracerProcessor, Object)
 
-TracerProcessor::TracerProcessor(const TypeInfo* rayTracerType, const std::wstring& compressionMethod, bool editor)
+TracerProcessor::TracerProcessor(const TypeInfo* rayTracerType, const std::wstring& compressionMethod, const std::wstring& cachePath, bool editor)
 :   m_rayTracerType(rayTracerType)
 ,	m_compressionMethod(compressionMethod)
+,	m_cachePath(cachePath)
 ,	m_editor(editor)
 ,   m_thread(nullptr)
 {
@@ -416,10 +597,162 @@ bool TracerProcessor::process(const TracerTask* task)
 	// Update status.
 	m_status.description = str(L"Preparing (%d models, %d lights)...", task->getTracerModels().size(), task->getTracerLights().size());
 
-   	// Create raytracer implementation.
+	const auto& tracerOutputs = task->getTracerOutputs();
+	const auto& tracerIrradiances = task->getTracerIrradiances();
+
+	// Calculate cache keys of all outputs so we can skip tracing those which are unchanged.
+	AlignedVector< std::wstring > outputKeys;
+	AlignedVector< std::wstring > irradianceKeys;
+	calculateKeys(task, m_rayTracerType, outputKeys, irradianceKeys);
+
+	// Reuse lightmaps from bake cache.
+	RefArray< const TracerOutput > pendingOutputs;
+	AlignedVector< std::wstring > pendingOutputKeys;
+	for (uint32_t i = 0; i < tracerOutputs.size(); ++i)
+	{
+		auto tracerOutput = tracerOutputs[i];
+
+		Ref< drawing::Image > lightmapDiffuse = readCachedLightmap(outputKeys[i]);
+		if (lightmapDiffuse && writeTexture(
+			tracerOutput->getLightmapDiffuseInstance(),
+			m_compressionMethod,
+			true,
+			lightmapDiffuse
+		))
+			continue;
+
+		pendingOutputs.push_back(tracerOutput);
+		pendingOutputKeys.push_back(outputKeys[i]);
+	}
+
+	// Reuse irradiance grids from bake cache.
+	RefArray< const TracerIrradiance > pendingIrradiances;
+	AlignedVector< std::wstring > pendingIrradianceKeys;
+	for (uint32_t i = 0; i < tracerIrradiances.size(); ++i)
+	{
+		auto tracerIrradiance = tracerIrradiances[i];
+
+		AlignedVector< uint8_t > data;
+		if (readCachedIrradiance(irradianceKeys[i], data) && writeIrradiance(tracerIrradiance->getIrradianceInstance(), data))
+			continue;
+
+		pendingIrradiances.push_back(tracerIrradiance);
+		pendingIrradianceKeys.push_back(irradianceKeys[i]);
+	}
+
+	const uint32_t reused = (uint32_t)((tracerOutputs.size() - pendingOutputs.size()) + (tracerIrradiances.size() - pendingIrradiances.size()));
+	if (reused > 0)
+		log::info << L"Reused " << reused << L" of " << (uint32_t)(tracerOutputs.size() + tracerIrradiances.size()) << L" output(s) from bake cache." << Endl;
+
+	if (pendingOutputs.empty() && pendingIrradiances.empty() && task->getTracerCameras().empty())
+		return true;
+
+	// Trace a low-sample preview of modified lightmaps first in editor
+	// so user get quick feedback; final lightmaps replace them when finished.
+	if (m_editor && !pendingOutputs.empty())
+	{
+		Ref< BakeConfiguration > previewConfiguration = configuration->createPreview(c_previewSampleDivisor);
+		Ref< IRayTracer > previewRayTracer = createRayTracer(task, previewConfiguration);
+		if (!previewRayTracer)
+			return false;
+
+		const bool result = traceLightmaps(previewRayTracer, previewConfiguration, pendingOutputs, pendingOutputKeys, true);
+		previewRayTracer->destroy();
+		if (!result)
+			return false;
+	}
+
+	if (m_cancelled)
+		return false;
+
+	Ref< IRayTracer > rayTracer = createRayTracer(task, configuration);
+	if (!rayTracer)
+		return false;
+
+	// Trace lightmaps.
+	if (!traceLightmaps(rayTracer, configuration, pendingOutputs, pendingOutputKeys, false))
+		return false;
+
+	// Trace irradiance grids.
+	for (uint32_t i = 0; !m_cancelled && i < pendingIrradiances.size(); ++i)
+	{
+		auto tracerIrradiance = pendingIrradiances[i];
+
+		AlignedVector< uint8_t > data;
+		if (!traceIrradiance(task, rayTracer, tracerIrradiance, data))
+			return false;
+
+		if (m_cancelled)
+			break;
+
+		writeCachedIrradiance(pendingIrradianceKeys[i], data);
+
+		if (!writeIrradiance(tracerIrradiance->getIrradianceInstance(), data))
+		{
+			log::error << L"Trace failed; unable to create output irradiance grid for \"" << tracerIrradiance->getIrradianceInstance()->getName() << L"\"." << Endl;
+			return false;
+		}
+	}
+
+	// Trace camera views.
+	const auto& tracerCameras = task->getTracerCameras();
+	for (uint32_t i = 0; !m_cancelled && i < tracerCameras.size(); ++i)
+	{
+		auto tracerCamera = tracerCameras[i];
+
+		Ref< drawing::Image > image = new drawing::Image(
+			drawing::PixelFormat::getR8G8B8A8(),
+			tracerCamera->getWidth(),
+			tracerCamera->getHeight()
+		);
+
+		const Transform transform = tracerCamera->getTransform();
+		const float fov = tracerCamera->getFieldOfView();
+		const float aspect = ((float)image->getWidth()) / image->getHeight();
+
+		m_status.description = str(L"Image %d", i);
+		m_status.current = 0;
+		m_status.total = image->getHeight();
+
+		for (int32_t y = 0; y < image->getHeight(); ++y)
+		{
+			const float fy = 1.0f - 2.0f * ((float)y / image->getHeight());
+
+			m_status.current = y;
+
+			for (int32_t x = 0; x < image->getWidth(); ++x)
+			{
+				const float fx = 2.0f * ((float)x / image->getWidth()) - 1.0f;
+
+				const float Px = fx * tan(fov / 2.0f) * aspect;
+				const float Py = fy * tan(fov / 2.0f);
+				
+				const Vector4 origin = transform.translation().xyz1();
+				const Vector4 direction = transform * Vector4(Px, Py, 1.0f, 0.0f).normalized();
+
+				const Color4f color = rayTracer->traceRay(origin, direction);
+				image->setPixel(x, y, color);
+			}
+		}
+
+		const drawing::TonemapFilter tonemapFilter;
+		image->apply(&tonemapFilter);
+
+		const drawing::GammaFilter gammaFilter(1.0f, 2.2f);
+		image->apply(&gammaFilter);
+
+		image->save(str(L"Preview%04d.png", i));
+	}
+
+	return true;
+}
+
+Ref< IRayTracer > TracerProcessor::createRayTracer(const TracerTask* task, const BakeConfiguration* configuration) const
+{
+	// Create raytracer implementation.
 	Ref< IRayTracer > rayTracer = mandatory_non_null_type_cast< IRayTracer* >(m_rayTracerType->createInstance());
 	if (!rayTracer->create(configuration))
-		return false;
+		return nullptr;
 
 	// Setup raytracer scene.
 	for (auto tracerEnvironment : task->getTracerEnvironments())
@@ -430,9 +763,12 @@ bool TracerProcessor::process(const TracerTask* task)
 		rayTracer->addModel(tracerModel->getModel(), tracerModel->getTransform());
 
 	rayTracer->commit();
+	return rayTracer;
+}
 
-	// Get output tasks and sort them by priority.
-	const auto& tracerOutputs = task->getTracerOutputs();
+bool TracerProcessor::traceLightmaps(const IRayTracer* rayTracer, const BakeConfiguration* configuration, const RefArray< const TracerOutput >& tracerOutputs, const AlignedVector< std::wstring >& keys, bool preview)
+{
+	const wchar_t* phase = preview ? L"preview" : L"tracing";
 
 	// Calculate total progress.
 	m_status.total = std::accumulate(tracerOutputs.begin(), tracerOutputs.end(), (int32_t)0, [](int32_t acc, const TracerOutput* iter) {
@@ -440,6 +776,9 @@ bool TracerProcessor::process(const TracerTask* task)
 	});
 	m_status.current = 0;
 
+	Timer timer;
+	const uint64_t rayCountStart = rayTracer->getRayCount();
+
 	// Trace each lightmap in task.
 	for (uint32_t i = 0; !m_cancelled && i < tracerOutputs.size(); ++i)
 	{
@@ -452,7 +791,7 @@ bool TracerProcessor::process(const TracerTask* task)
 		const uint32_t channel = renderModel->getTexCoordChannel(L"Lightmap");
 
 		// Update status.
-		m_status.description = str(L"%d/%d (gbuffer)...", i + 1, (int32_t)tracerOutputs.size(), width);
+		m_status.description = str(L"%d/%d (gbuffer)...", i + 1, (int32_t)tracerOutputs.size());
 
 		// Create GBuffer of mesh's geometry.
 		GBuffer gbuffer;
@@ -506,7 +845,7 @@ bool TracerProcessor::process(const TracerTask* task)
 		lightmapDiffuse->clear(Color4f(0.0f, 0.0f, 0.0f, 0.0f));
 
 		// Update status.
-		m_status.description = str(L"%d/%d (tracing)...", i + 1, (int32_t)tracerOutputs.size(), width);
+		m_status.description = str(L"%d/%d (%ls)...", i + 1, (int32_t)tracerOutputs.size(), phase);
 
 		RefArray< Job > jobs;
 		for (int32_t ty = 0; !m_cancelled && ty < height; ty += 16)
@@ -531,217 +870,297 @@ bool TracerProcessor::process(const TracerTask* task)
 			break;
 
 		// Update status.
-		m_status.description = str(L"%d/%d (filter)...", i + 1, (int32_t)tracerOutputs.size(), width);
+		m_status.description = str(L"%d/%d (filter)...", i + 1, (int32_t)tracerOutputs.size());
+
+		// De-noise lightmap.
+		if (configuration->getEnableDenoise())
+			lightmapDiffuse = denoise(gbuffer, lightmapDiffuse, false);
+
+		// Only final lightmaps are stored in cache.
+		if (!preview)
+			writeCachedLightmap(keys[i], lightmapDiffuse);
 
 		// Create final output instance.
-		if (lightmapDiffuse)
+		const bool result = writeTexture(
+			tracerOutput->getLightmapDiffuseInstance(),
+			m_compressionMethod,
+			true,
+			lightmapDiffuse
+		);
+		if (!result)
 		{
-			// De-noise lightmap.
-			if (configuration->getEnableDenoise())
-				lightmapDiffuse = denoise(gbuffer, lightmapDiffuse, false);
-
-			const bool result = writeTexture(
-				tracerOutput->getLightmapDiffuseInstance(),
-				m_compressionMethod,
-				true,
-				lightmapDiffuse
-			);
-			if (!result)
-			{
-				log::error << L"Trace failed; unable to create output lightmap texture for \"" << tracerOutput->getLightmapDiffuseInstance()->getName() << L"\"." << Endl;
-				return false;
-			}
+			log::error << L"Trace failed; unable to create output lightmap texture for \"" << tracerOutput->getLightmapDiffuseInstance()->getName() << L"\"." << Endl;
+			return false;
 		}
 	}
 
-	// Trace irradiance grids.
-	const auto& tracerIrradiances = task->getTracerIrradiances();
-	for (uint32_t i = 0; !m_cancelled && i < tracerIrradiances.size(); ++i)
+	// Measure throughput of ray tracer backend.
+	const double duration = timer.getElapsedTime();
+	const uint64_t rayCount = rayTracer->getRayCount() - rayCountStart;
+	if (rayCount > 0 && duration > 0.0)
 	{
-		auto tracerIrradiance = tracerIrradiances[i];
-		const Vector4 gridDensity = configuration->getIrradianceGridDensity();
+		m_status.raysPerSecond = rayCount / duration;
+		log::info << L"Traced " << rayCount << L" rays (" << phase << L") in " << formatDuration(duration) << L" using " << type_name(rayTracer) << L", " << (int64_t)(m_status.raysPerSecond / 1000.0) << L" Krays/s." << Endl;
+	}
 
-		// Determine bounding box from all trace models if no one is already provided.
-		Aabb3 boundingBox = tracerIrradiance->getBoundingBox();
-		if (boundingBox.empty())
-		{
-			for (auto tracerModel : task->getTracerModels())
-				boundingBox.contain(tracerModel->getModel()->getBoundingBox().transform(tracerModel->getTransform()));
-		}
+	return true;
+}
+
+bool TracerProcessor::traceIrradiance(const TracerTask* task, const IRayTracer* rayTracer, const TracerIrradiance* tracerIrradiance, AlignedVector< uint8_t >& outData)
+{
+	const Vector4 gridDensity = task->getConfiguration()->getIrradianceGridDensity();
 
-		// Shrink a tiny bit so we can easily align volume to walls etc in editor.
-		boundingBox.expand(0.025_simd);
+	// Determine bounding box from all trace models if no one is already provided.
+	Aabb3 boundingBox = tracerIrradiance->getBoundingBox();
+	if (boundingBox.empty())
+	{
+		for (auto tracerModel : task->getTracerModels())
+			boundingBox.contain(tracerModel->getModel()->getBoundingBox().transform(tracerModel->getTransform()));
+	}
 
-		const Vector4 worldSize = boundingBox.getExtent() * 2.0_simd;
+	// Shrink a tiny bit so we can easily align volume to walls etc in editor.
+	boundingBox.expand(0.025_simd);
 
-		const int32_t gridX = clamp((int32_t)(worldSize.x() * gridDensity.x() + 0.5f), 2, 128);
-		const int32_t gridY = clamp((int32_t)(worldSize.y() * gridDensity.y() + 0.5f), 2, 128);
-		const int32_t gridZ = clamp((int32_t)(worldSize.z() * gridDensity.z() + 0.5f), 2, 128);
+	const Vector4 worldSize = boundingBox.getExtent() * 2.0_simd;
 
-		log::debug << L"Irradiance bounding box " << boundingBox.mn << L" -> " << boundingBox.mx << Endl;
-		log::debug << L"Grid size " << gridX << L", " << gridY << L", " << gridZ << Endl;
+	const int32_t gridX = clamp((int32_t)(worldSize.x() * gridDensity.x() + 0.5f), 2, 128);
+	const int32_t gridY = clamp((int32_t)(worldSize.y() * gridDensity.y() + 0.5f), 2, 128);
+	const int32_t gridZ = clamp((int32_t)(worldSize.z() * gridDensity.z() + 0.5f), 2, 128);
 
-		m_status.description = str(L"Irradiance grid (%d, %d, %d)", gridX, gridY, gridZ);
-		m_status.current = 0;
-		m_status.total = gridX * gridY * gridZ;
+	log::debug << L"Irradiance bounding box " << boundingBox.mn << L" -> " << boundingBox.mx << Endl;
+	log::debug << L"Grid size " << gridX << L", " << gridY << L", " << gridZ << Endl;
 
-		RefArray< render::SHCoeffs > shs(gridX * gridY * gridZ);
-		RefArray< Job > jobs;
+	m_status.description = str(L"Irradiance grid (%d, %d, %d)", gridX, gridY, gridZ);
+	m_status.current = 0;
+	m_status.total = gridX * gridY * gridZ;
 
-		for (int32_t x = 0; !m_cancelled && x < gridX; ++x)
+	Timer timer;
+	const uint64_t rayCountStart = rayTracer->getRayCount();
+
+	RefArray< render::SHCoeffs > shs(gridX * gridY * gridZ);
+	RefArray< Job > jobs;
+
+	for (int32_t x = 0; !m_cancelled && x < gridX; ++x)
+	{
+		const float fx = x / (float)(gridX - 1.0f);
+		for (int32_t y = 0; !m_cancelled && y < gridY; ++y)
 		{
-			const float fx = x / (float)(gridX - 1.0f);
-			for (int32_t y = 0; !m_cancelled && y < gridY; ++y)
+			const float fy = y / (float)(gridY - 1.0f);
+			for (int32_t z = 0; !m_cancelled && z < gridZ; ++z)
 			{
-				const float fy = y / (float)(gridY - 1.0f);
-				for (int32_t z = 0; !m_cancelled && z < gridZ; ++z)
+				const float fz = z / (float)(gridZ - 1.0f);
+		
+				const Vector4 position = boundingBox.mn + (boundingBox.mx - boundingBox.mn) * Vector4(fx, fy, fz);
+				const uint32_t index = x * gridY * gridZ + y * gridZ + z;
+
+				Ref< Job > job = m_queue->add([&, position, index]() {
+					shs[index] = rayTracer->traceProbe(position.xyz1());
+				});
+				jobs.push_back(job);
+
+				// Keep number of pending jobs at a reasonable level.
+				while (jobs.size() > 128)
 				{
-					const float fz = z / (float)(gridZ - 1.0f);
-			
-					const Vector4 position = boundingBox.mn + (boundingBox.mx - boundingBox.mn) * Vector4(fx, fy, fz);
-					const uint32_t index = x * gridY * gridZ + y * gridZ + z;
-
-					Ref< Job > job = m_queue->add([&, position, index]() {
-						shs[index] = rayTracer->traceProbe(position.xyz1());
+					m_queue->waitCurrent();
+					auto it = std::remove_if(jobs.begin(), jobs.end(), [](Job* job) {
+						return job->wait(0);
 					});
-					jobs.push_back(job);
-
-					// Keep number of pending jobs at a reasonable level.
-					while (jobs.size() > 128)
-					{
-						m_queue->waitCurrent();
-						auto it = std::remove_if(jobs.begin(), jobs.end(), [](Job* job) {
-							return job->wait(0);
-						});
-						jobs.erase(it, jobs.end());
-					}
-
-					m_status.current++;
+					jobs.erase(it, jobs.end());
 				}
-			}
-		}
 
-		while (!jobs.empty())
-		{
-			m_queue->waitCurrent();
-			auto it = std::remove_if(jobs.begin(), jobs.end(), [](Job* job) {
-				return job->wait(0);
-			});
-			jobs.erase(it, jobs.end());
+				m_status.current++;
+			}
 		}
+	}
 
-		if (m_cancelled)
-			break;
-
-		// Create output instance.
-		Ref< db::Instance > outputInstance = tracerIrradiance->getIrradianceInstance();
-		if (!outputInstance->checkout())
-			return false;
+	while (!jobs.empty())
+	{
+		m_queue->waitCurrent();
+		auto it = std::remove_if(jobs.begin(), jobs.end(), [](Job* job) {
+			return job->wait(0);
+		});
+		jobs.erase(it, jobs.end());
+	}
 
-		Ref< world::IrradianceGridResource > outputResource = new world::IrradianceGridResource();
-		outputInstance->setObject(outputResource);
+	if (m_cancelled)
+		return true;
 
-		// Create output data stream.
-		Ref< IStream > stream = outputInstance->writeData(L"Data");
-		if (!stream)
-		{
-			log::error << L"Trace failed; unable to create irradiance instance data stream." << Endl;
-			outputInstance->revert();
-			return false;
-		}
+	// Measure throughput of ray tracer backend.
+	const double duration = timer.getElapsedTime();
+	const uint64_t rayCount = rayTracer->getRayCount() - rayCountStart;
+	if (rayCount > 0 && duration > 0.0)
+	{
+		m_status.raysPerSecond = rayCount / duration;
+		log::info << L"Traced " << rayCount << L" rays (irradiance) in " << formatDuration(duration) << L" using " << type_name(rayTracer) << L", " << (int64_t)(m_status.raysPerSecond / 1000.0) << L" Krays/s." << Endl;
+	}
 
-		Writer writer(stream);
+	// Serialize grid into data blob, same layout as irradiance grid resource data.
+	DynamicMemoryStream stream(outData, false, true);
+	Writer writer(&stream);
 
-		writer << uint32_t(2);
+	writer << uint32_t(2);
 
-		writer << (uint32_t)gridX;	// width
-		writer << (uint32_t)gridY;	// height
-		writer << (uint32_t)gridZ;	// depth
+	writer << (uint32_t)gridX;	// width
+	writer << (uint32_t)gridY;	// height
+	writer << (uint32_t)gridZ;	// depth
 
-		writer << boundingBox.mn.x();
-		writer << boundingBox.mn.y();
-		writer << boundingBox.mn.z();
-		writer << boundingBox.mx.x();
-		writer << boundingBox.mx.y();
-		writer << boundingBox.mx.z();
+	writer << boundingBox.mn.x();
+	writer << boundingBox.mn.y();
+	writer << boundingBox.mn.z();
+	writer << boundingBox.mx.x();
+	writer << boundingBox.mx.y();
+	writer << boundingBox.mx.z();
 
-		for (auto sh : shs)
+	for (auto sh : shs)
+	{
+		if (!sh)
 		{
-			if (!sh)
-			{
-				log::error << L"Trace failed; unable to trace irradiance probe." << Endl;
-				return false;
-			}
-			T_FATAL_ASSERT(sh->get().size() == 9);
-			for (int32_t i = 0; i < 9; ++i)
-			{
-				const auto& c = (*sh)[i];
-				writer << c.x();
-				writer << c.y();
-				writer << c.z();
-			}
+			log::error << L"Trace failed; unable to trace irradiance probe." << Endl;
+			return false;
+		}
+		T_FATAL_ASSERT(sh->get().size() == 9);
+		for (int32_t i = 0; i < 9; ++i)
+		{
+			const auto& c = (*sh)[i];
+			writer << c.x();
+			writer << c.y();
+			writer << c.z();
 		}
+	}
+
+	return true;
+}
 
+Ref< drawing::Image > TracerProcessor::readCachedLightmap(const std::wstring& key) const
+{
+	if (m_cachePath.empty())
+		return nullptr;
+
+	Ref< IStream > file = FileSystem::getInstance().open(m_cachePath + L"/" + key + L".lightmap", File::FmRead);
+	if (!file)
+		return nullptr;
+
+	Ref< IStream > stream = new BufferedStream(new compress::InflateStreamLzf(file), 64 * 1024);
+	Reader reader(stream);
+
+	uint32_t version;
+	int32_t width, height;
+	reader >> version;
+	reader >> width;
+	reader >> height;
+	if (version != c_cacheVersion || width <= 0 || height <= 0)
+	{
 		stream->close();
+		return nullptr;
+	}
+
+	Ref< drawing::Image > lightmap = new drawing::Image(
+		drawing::PixelFormat::getRGBAF32(),
+		width,
+		height
+	);
 
-		if (!outputInstance->commit())
+	// Read row by row to keep each read within stream buffer.
+	const int64_t pitch = lightmap->getDataSize() / height;
+	uint8_t* data = static_cast< uint8_t* >(lightmap->getData());
+	for (int32_t y = 0; y < height; ++y)
+	{
+		if (reader.read(data + y * pitch, pitch) != pitch)
 		{
-			log::error << L"Trace failed; unable to commit output instance." << Endl;
-			return false;
+			stream->close();
+			return nullptr;
 		}
 	}
 
-	// Trace camera views.
-	const auto& tracerCameras = task->getTracerCameras();
-	for (uint32_t i = 0; !m_cancelled && i < tracerCameras.size(); ++i)
+	stream->close();
+	return lightmap;
+}
+
+void TracerProcessor::writeCachedLightmap(const std::wstring& key, const drawing::Image* lightmap) const
+{
+	if (m_cachePath.empty())
+		return;
+
+	T_ASSERT(lightmap->getPixelFormat() == drawing::PixelFormat::getRGBAF32());
+
+	// Write into temporary file first so a partial file is never read.
+	const std::wstring fileName = m_cachePath + L"/" + key + L".lightmap";
+	if (!FileSystem::getInstance().makeAllDirectories(m_cachePath))
+		return;
+
+	Ref< IStream > file = FileSystem::getInstance().open(fileName + L"~", File::FmWrite);
+	if (!file)
 	{
-		auto tracerCamera = tracerCameras[i];
+		log::warning << L"Unable to write lightmap to bake cache \"" << m_cachePath << L"\"." << Endl;
+		return;
+	}
 
-		Ref< drawing::Image > image = new drawing::Image(
-			drawing::PixelFormat::getR8G8B8A8(),
-			tracerCamera->getWidth(),
-			tracerCamera->getHeight()
-		);
+	Ref< IStream > stream = new BufferedStream(new compress::DeflateStreamLzf(file), 64 * 1024);
+	Writer writer(stream);
 
-		const Transform transform = tracerCamera->getTransform();
-		const float fov = tracerCamera->getFieldOfView();
-		const float aspect = ((float)image->getWidth()) / image->getHeight();
+	writer << c_cacheVersion;
+	writer << int32_t(lightmap->getWidth());
+	writer << int32_t(lightmap->getHeight());
+	writer.write(lightmap->getData(), lightmap->getDataSize());
 
-		m_status.description = str(L"Image %d", i);
-		m_status.current = 0;
-		m_status.total = image->getHeight();
+	stream->close();
+	file->close();
 
-		for (int32_t y = 0; y < image->getHeight(); ++y)
-		{
-			const float fy = 1.0f - 2.0f * ((float)y / image->getHeight());
+	FileSystem::getInstance().move(fileName, fileName + L"~", true);
+}
 
-			m_status.current = y;
+bool TracerProcessor::readCachedIrradiance(const std::wstring& key, AlignedVector< uint8_t >& outData) const
+{
+	if (m_cachePath.empty())
+		return false;
 
-			for (int32_t x = 0; x < image->getWidth(); ++x)
-			{
-				const float fx = 2.0f * ((float)x / image->getWidth()) - 1.0f;
+	Ref< IStream > file = FileSystem::getInstance().open(m_cachePath + L"/" + key + L".irradiance", File::FmRead);
+	if (!file)
+		return false;
 
-				const float Px = fx * tan(fov / 2.0f) * aspect;
-				const float Py = fy * tan(fov / 2.0f);
-				
-				const Vector4 origin = transform.translation().xyz1();
-				const Vector4 direction = transform * Vector4(Px, Py, 1.0f, 0.0f).normalized();
+	Ref< IStream > stream = new BufferedStream(file);
+	Reader reader(stream);
 
-				const Color4f color = rayTracer->traceRay(origin, direction);
-				image->setPixel(x, y, color);
-			}
-		}
+	uint32_t version, size;
+	reader >> version;
+	reader >> size;
+	if (version != c_cacheVersion || size == 0)
+	{
+		stream->close();
+		return false;
+	}
 
-		const drawing::TonemapFilter tonemapFilter;
-		image->apply(&tonemapFilter);
+	outData.resize(size);
+	const bool result = (reader.read(outData.ptr(), size) == size);
 
-		const drawing::GammaFilter gammaFilter(1.0f, 2.2f);
-		image->apply(&gammaFilter);
+	stream->close();
+	return result;
+}
 
-		image->save(str(L"Preview%04d.png", i));
+void TracerProcessor::writeCachedIrradiance(const std::wstring& key, const AlignedVector< uint8_t >& data) const
+{
+	if (m_cachePath.empty())
+		return;
+
+	// Write into temporary file first so a partial file is never read.
+	const std::wstring fileName = m_cachePath + L"/" + key + L".irradiance";
+	if (!FileSystem::getInstance().makeAllDirectories(m_cachePath))
+		return;
+
+	Ref< IStream > file = FileSystem::getInstance().open(fileName + L"~", File::FmWrite);
+	if (!file)
+	{
+		log::warning << L"Unable to write irradiance grid to bake cache \"" << m_cachePath << L"\"." << Endl;
+		return;
 	}
 
-	return true;
+	Writer writer(file);
+	writer << c_cacheVersion;
+	writer << (uint32_t)data.size();
+	writer.write(data.c_ptr(), data.size());
+	file->close();
+
+	FileSystem::getInstance().move(fileName, fileName + L"~", true);
 }
 
 }
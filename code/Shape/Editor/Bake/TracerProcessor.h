@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/RefArray.h"
 #include "Core/Thread/Event.h"
 #include "Core/Thread/Semaphore.h"
@@ -31,9 +32,20 @@ class Thread;
 
 }
 
+namespace traktor::drawing
+{
+
+class Image;
+
+}
+
 namespace traktor::shape
 {
 
+class BakeConfiguration;
+class IRayTracer;
+class TracerIrradiance;
+class TracerOutput;
 class TracerTask;
 
 class T_DLLCLASS TracerProcessor : public Object
@@ -46,10 +58,17 @@ public:
 		bool active = false;
 		uint32_t current = 0;
 		uint32_t total = 0;
+		double raysPerSecond = 0.0;	//!< Measured throughput of ray tracer backend during last tracing pass.
 		std::wstring description;
 	};
 
-	explicit TracerProcessor(const TypeInfo* rayTracerType, const std::wstring& compressionMethod, bool editor);
+	/*!
+	 * \param rayTracerType Type of ray tracer backend, must implement IRayTracer.
+	 * \param compressionMethod Lightmap texture compression method.
+	 * \param cachePath Path to local bake cache, unchanged outputs are reused from cache. Empty path disables cache.
+	 * \param editor If running from editor; a low-sample preview is traced and written before final outputs.
+	 */
+	explicit TracerProcessor(const TypeInfo* rayTracerType, const std::wstring& compressionMethod, const std::wstring& cachePath, bool editor);
 
 	virtual ~TracerProcessor();
 
@@ -68,6 +87,7 @@ public:
 private:
 	const TypeInfo* m_rayTracerType = nullptr;
 	std::wstring m_compressionMethod;
+	std::wstring m_cachePath;
 	bool m_editor = false;
 	Thread* m_thread = nullptr;
 	Ref< JobQueue > m_queue;
@@ -82,6 +102,20 @@ private:
 	void processorThread();
 
 	bool process(const TracerTask* task);
+
+	Ref< IRayTracer > createRayTracer(const TracerTask* task, const BakeConfiguration* configuration) const;
+
+	bool traceLightmaps(const IRayTracer* rayTracer, const BakeConfiguration* configuration, const RefArray< const TracerOutput >& tracerOutputs, const AlignedVector< std::wstring >& keys, bool preview);
+
+	bool traceIrradiance(const TracerTask* task, const IRayTracer* rayTracer, const TracerIrradiance* tracerIrradiance, AlignedVector< uint8_t >& outData);
+
+	Ref< drawing::Image > readCachedLightmap(const std::wstring& key) const;
+
+	void writeCachedLightmap(const std::wstring& key, const drawing::Image* lightmap) const;
+
+	bool readCachedIrradiance(const std::wstring& key, AlignedVector< uint8_t >& outData) const;
+
+	void writeCachedIrradiance(const std::wstring& key, const AlignedVector< uint8_t >& data) const;
 };
 
 }
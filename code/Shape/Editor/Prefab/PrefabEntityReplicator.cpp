@@ -156,7 +156,7 @@ Ref< model::Model > PrefabEntityReplicator::createVisualModel(
 	).apply(*outputModel);
 
 	// Bind texture references in material maps.
-	for (auto& material : outputModel->getMaterials())
+	for (auto& material : outputModel->editMaterials())
 	{
 		const auto it = materialShaders.find(material.getName());
 		if (it != materialShaders.end())
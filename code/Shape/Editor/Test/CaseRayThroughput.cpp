@@ -0,0 +1,318 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include <embree4/rtcore.h>
+#include <embree4/rtcore_ray.h>
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Quasirandom.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+#include "Shape/Editor/Test/CaseRayThroughput.h"
+
+#if defined (_MSC_VER)
+#	define T_ALIGN64 __declspec(align(64))
+#elif defined(__GNUC__) || defined(__ANDROID__)
+#	define T_ALIGN64 __attribute__((aligned(64)))
+#endif
+
+namespace traktor::shape::test
+{
+	namespace
+	{
+
+const int32_t c_boxCount = 2000;
+const int32_t c_texelDim = 128;
+const int32_t c_sampleCount = 64;
+const float c_maxDistance = 20.0f;
+
+struct Ray
+{
+	Vector4 origin;
+	Vector4 direction;
+};
+
+/*! Add axis aligned box as 12 triangles. */
+void addBox(const Vector4& mn, const Vector4& mx, AlignedVector< float >& outVertices, AlignedVector< uint32_t >& outIndices)
+{
+	const uint32_t base = (uint32_t)(outVertices.size() / 3);
+	for (int32_t i = 0; i < 8; ++i)
+	{
+		outVertices.push_back((i & 1) ? mx.x() : mn.x());
+		outVertices.push_back((i & 2) ? mx.y() : mn.y());
+		outVertices.push_back((i & 4) ? mx.z() : mn.z());
+	}
+
+	const uint32_t faces[6][4] =
+	{
+		{ 0, 2, 6, 4 }, { 1, 5, 7, 3 },
+		{ 0, 4, 5, 1 }, { 2, 3, 7, 6 },
+		{ 0, 1, 3, 2 }, { 4, 6, 7, 5 }
+	};
+	for (const auto& face : faces)
+	{
+		outIndices.push_back(base + face[0]);
+		outIndices.push_back(base + face[1]);
+		outIndices.push_back(base + face[2]);
+		outIndices.push_back(base + face[0]);
+		outIndices.push_back(base + face[2]);
+		outIndices.push_back(base + face[3]);
+	}
+}
+
+RTCScene createScene(RTCDevice device)
+{
+	AlignedVector< float > vertices;
+	AlignedVector< uint32_t > indices;
+
+	// Ground plane with boxes scattered on top, similar in
+	// density to an outdoor level.
+	addBox(Vector4(-100.0f, -1.0f, -100.0f), Vector4(100.0f, 0.0f, 100.0f), vertices, indices);
+
+	Random random(1234);
+	for (int32_t i = 0; i < c_boxCount; ++i)
+	{
+		const float x = random.nextFloat() * 140.0f - 70.0f;
+		const float z = random.nextFloat() * 140.0f - 70.0f;
+		const float w = 0.5f + random.nextFloat() * 3.0f;
+		const float h = 0.5f + random.nextFloat() * 8.0f;
+		addBox(Vector4(x, 0.0f, z), Vector4(x + w, h, z + w), vertices, indices);
+	}
+
+	RTCGeometry mesh = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+
+	float* vb = (float*)rtcSetNewGeometryBuffer(mesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, 3 * sizeof(float), vertices.size() / 3);
+	std::copy(vertices.begin(), vertices.end(), vb);
+
+	uint32_t* ib = (uint32_t*)rtcSetNewGeometryBuffer(mesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, 3 * sizeof(uint32_t), indices.size() / 3);
+	std::copy(indices.begin(), indices.end(), ib);
+
+	rtcCommitGeometry(mesh);
+
+	RTCScene scene = rtcNewScene(device);
+	rtcSetSceneBuildQuality(scene, RTC_BUILD_QUALITY_HIGH);
+	rtcAttachGeometry(scene, mesh);
+	rtcReleaseGeometry(mesh);
+	rtcCommitScene(scene);
+	return scene;
+}
+
+/*! Generate rays as lightmap tracer; each group of 16 rays has same sample from adjacent texels. */
+void generateRays(AlignedVector< Ray >& outRays)
+{
+	const Vector4 normal(0.0f, 1.0f, 0.0f, 0.0f);
+	Random random;
+
+	outRays.resize(0);
+	outRays.reserve(c_texelDim * c_texelDim * c_sampleCount);
+
+	for (int32_t y = 0; y < c_texelDim; ++y)
+	{
+		for (int32_t x = 0; x < c_texelDim; x += 16)
+		{
+			for (int32_t i = 0; i < c_sampleCount; ++i)
+			{
+				for (int32_t j = 0; j < 16; ++j)
+				{
+					const Vector4 origin(
+						-64.0f + (x + j) * (128.0f / c_texelDim),
+						0.01f,
+						-64.0f + y * (128.0f / c_texelDim),
+						1.0f
+					);
+					const Vector2 uv = Quasirandom::hammersley(i, c_sampleCount, random);
+					outRays.push_back({ origin, Quasirandom::uniformHemiSphere(uv, normal) });
+				}
+			}
+		}
+	}
+}
+
+void constructRay(const Ray& ray, RTCRay& outRay)
+{
+	outRay.org_x = ray.origin.x();
+	outRay.org_y = ray.origin.y();
+	outRay.org_z = ray.origin.z();
+	outRay.dir_x = ray.direction.x();
+	outRay.dir_y = ray.direction.y();
+	outRay.dir_z = ray.direction.z();
+	outRay.tnear = 0.001f;
+	outRay.time = 0.0f;
+	outRay.tfar = c_maxDistance;
+	outRay.mask = -1;
+	outRay.id = 0;
+	outRay.flags = 0;
+}
+
+void constructRay16(const Ray& ray, int32_t index, RTCRay16& outRay)
+{
+	outRay.org_x[index] = ray.origin.x();
+	outRay.org_y[index] = ray.origin.y();
+	outRay.org_z[index] = ray.origin.z();
+	outRay.dir_x[index] = ray.direction.x();
+	outRay.dir_y[index] = ray.direction.y();
+	outRay.dir_z[index] = ray.direction.z();
+	outRay.tnear[index] = 0.001f;
+	outRay.time[index] = 0.0f;
+	outRay.tfar[index] = c_maxDistance;
+	outRay.mask[index] = -1;
+	outRay.id[index] = 0;
+	outRay.flags[index] = 0;
+}
+
+int32_t occludedSingle(RTCScene scene, const AlignedVector< Ray >& rays)
+{
+	RTCOccludedArguments oargs;
+	rtcInitOccludedArguments(&oargs);
+	oargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
+
+	int32_t occluded = 0;
+	RTCRay T_ALIGN64 r;
+	for (const auto& ray : rays)
+	{
+		constructRay(ray, r);
+		rtcOccluded1(scene, &r, &oargs);
+		if (r.tfar < 0.0f)
+			occluded++;
+	}
+	return occluded;
+}
+
+int32_t occludedPacket(RTCScene scene, const AlignedVector< Ray >& rays)
+{
+	RTCOccludedArguments oargs;
+	rtcInitOccludedArguments(&oargs);
+	oargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
+
+	int32_t T_ALIGN64 valid[16];
+	for (int32_t j = 0; j < 16; ++j)
+		valid[j] = -1;
+
+	int32_t occluded = 0;
+	RTCRay16 T_ALIGN64 rv;
+	for (size_t i = 0; i < rays.size(); i += 16)
+	{
+		for (int32_t j = 0; j < 16; ++j)
+			constructRay16(rays[i + j], j, rv);
+		rtcOccluded16(valid, scene, &rv, &oargs);
+		for (int32_t j = 0; j < 16; ++j)
+		{
+			if (rv.tfar[j] < 0.0f)
+				occluded++;
+		}
+	}
+	return occluded;
+}
+
+int32_t intersectSingle(RTCScene scene, const AlignedVector< Ray >& rays)
+{
+	RTCIntersectArguments iargs;
+	rtcInitIntersectArguments(&iargs);
+	iargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
+
+	int32_t hits = 0;
+	RTCRayHit T_ALIGN64 rh;
+	for (const auto& ray : rays)
+	{
+		constructRay(ray, rh.ray);
+		rh.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+		rh.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+		rtcIntersect1(scene, &rh, &iargs);
+		if (rh.hit.geomID != RTC_INVALID_GEOMETRY_ID)
+			hits++;
+	}
+	return hits;
+}
+
+int32_t intersectPacket(RTCScene scene, const AlignedVector< Ray >& rays)
+{
+	RTCIntersectArguments iargs;
+	rtcInitIntersectArguments(&iargs);
+	iargs.feature_mask = (RTCFeatureFlags)RTC_FEATURE_FLAG_TRIANGLE;
+
+	int32_t T_ALIGN64 valid[16];
+	for (int32_t j = 0; j < 16; ++j)
+		valid[j] = -1;
+
+	int32_t hits = 0;
+	RTCRayHit16 T_ALIGN64 rhv;
+	for (size_t i = 0; i < rays.size(); i += 16)
+	{
+		for (int32_t j = 0; j < 16; ++j)
+		{
+			constructRay16(rays[i + j], j, rhv.ray);
+			rhv.hit.geomID[j] = RTC_INVALID_GEOMETRY_ID;
+			rhv.hit.instID[0][j] = RTC_INVALID_GEOMETRY_ID;
+		}
+		rtcIntersect16(valid, scene, &rhv, &iargs);
+		for (int32_t j = 0; j < 16; ++j)
+		{
+			if (rhv.hit.geomID[j] != RTC_INVALID_GEOMETRY_ID)
+				hits++;
+		}
+	}
+	return hits;
+}
+
+/*! Measure best rays per second out of a few runs. */
+template < typename TraceFn >
+double measure(RTCScene scene, const AlignedVector< Ray >& rays, TraceFn traceFn, int32_t& outResult)
+{
+	Timer timer;
+	double duration = 1e9;
+	for (int32_t i = 0; i < 3; ++i)
+	{
+		const double start = timer.getElapsedTime();
+		outResult = traceFn(scene, rays);
+		duration = std::min(duration, timer.getElapsedTime() - start);
+	}
+	return rays.size() / duration;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.shape.test.CaseRayThroughput", 0, CaseRayThroughput, traktor::test::Case)
+
+void CaseRayThroughput::run()
+{
+	RTCDevice device = rtcNewDevice(nullptr);
+	CASE_ASSERT(device != nullptr);
+	if (!device)
+		return;
+
+	RTCScene scene = createScene(device);
+	CASE_ASSERT(rtcGetDeviceError(device) == RTC_ERROR_NONE);
+
+	AlignedVector< Ray > rays;
+	generateRays(rays);
+
+	// Occlusion rays, as traced for shadows and ambient occlusion.
+	{
+		int32_t single = 0, packet = 0;
+		const double singleRate = measure(scene, rays, occludedSingle, single);
+		const double packetRate = measure(scene, rays, occludedPacket, packet);
+		CASE_ASSERT_EQUAL(single, packet);
+		CASE_ASSERT(single > 0 && single < (int32_t)rays.size());
+		log::info << L"Occluded; single " << int32_t(singleRate / 1000.0) << L" Krays/s, packet " << int32_t(packetRate / 1000.0) << L" Krays/s (" << packetRate / singleRate << L"x)" << Endl;
+	}
+
+	// Intersection rays, as traced for indirect bounces.
+	{
+		int32_t single = 0, packet = 0;
+		const double singleRate = measure(scene, rays, intersectSingle, single);
+		const double packetRate = measure(scene, rays, intersectPacket, packet);
+		CASE_ASSERT_EQUAL(single, packet);
+		log::info << L"Intersect; single " << int32_t(singleRate / 1000.0) << L" Krays/s, packet " << int32_t(packetRate / 1000.0) << L" Krays/s (" << packetRate / singleRate << L"x)" << Endl;
+	}
+
+	rtcReleaseScene(scene);
+	rtcReleaseDevice(device);
+}
+
+}
@@ -0,0 +1,38 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Test/Case.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_SHAPE_EDITOR_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::shape::test
+{
+
+/*! Benchmark packet versus single ray tracing of bake rays.
+ *
+ * Rays are generated the same way as the lightmap tracer,
+ * same hemisphere sample for 16 adjacent texels, and traced
+ * through Embree both one at a time and in 16-wide packets.
+ */
+class T_DLLCLASS CaseRayThroughput : public traktor::test::Case
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void run() override final;
+};
+
+}
@@ -59,6 +59,8 @@ AudioChannel::AudioChannel(uint32_t id, uint32_t hwSampleRate, uint32_t hwFrameS
 ,	m_hwFrameSamples(hwFrameSamples)
 ,	m_volume(1.0f)
 ,	m_pitch(1.0f)
+,	m_priority(0)
+,	m_skipTime(0.0)
 ,	m_playing(false)
 ,	m_allowRepeat(false)
 ,	m_outputSamplesIn(0)
@@ -98,6 +100,16 @@ float AudioChannel::getPitch() const
 	return m_pitch;
 }
 
+void AudioChannel::setPriority(uint32_t priority)
+{
+	m_priority = priority;
+}
+
+uint32_t AudioChannel::getPriority() const
+{
+	return m_priority;
+}
+
 void AudioChannel::setFilter(const IAudioFilter* filter)
 {
 	StateFilter& sf = m_stateFilter.beginWrite();
@@ -177,25 +189,9 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 {
 	StateSound& ss = m_stateSound;
 
-	// Read pending sound state from fifo.
-	{
-		StateSound next;
-		if (m_stateSoundFifo.get(next))
-			ss = next;
-	}
-
 	if (!ss.buffer || !ss.cursor)
 		return false;
 
-	if (!m_allowRepeat)
-		ss.cursor->disableRepeat();
-
-	// Push pending parameters.
-	StateParameter& sp = m_stateParameters.read();
-	for (uint32_t i = 0; i < sp.set.size(); ++i)
-		ss.cursor->setParameter(sp.set[i].first, sp.set[i].second);
-	sp.set.clear();
-
 	const IAudioBuffer* soundBuffer = ss.buffer;
 	T_ASSERT(soundBuffer);
 
@@ -220,36 +216,8 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 		AudioBlock block = { { 0 }, m_hwFrameSamples, 0, 0 };
 		if (!soundBuffer->getBlock(ss.cursor, mixer, block))
 		{
-			// No more blocks from sound buffer.
-			if (m_allowRepeat && ss.repeat)
-			{
-				ss.cursor->reset();
-
-				// Skip samples when repeating.
-				uint32_t skip = ss.repeatFrom;
-				while (skip > 0)
-				{
-					AudioBlock skipBlock = { { 0 }, m_hwFrameSamples, 0, 0 };
-					if (soundBuffer->getBlock(ss.cursor, mixer, skipBlock))
-						skip -= min(skip, skipBlock.samplesCount);
-					else
-					{
-						ss.buffer = nullptr;
-						ss.cursor = nullptr;
-						m_playing = false;
-						return false;
-					}
-				}
-
-				if (!soundBuffer->getBlock(ss.cursor, mixer, block))
-				{
-					ss.buffer = nullptr;
-					ss.cursor = nullptr;
-					m_playing = false;
-					return false;
-				}
-			}
-			else
+			// No more blocks from sound buffer; rewind if repeating.
+			if (!rewind(mixer) || !soundBuffer->getBlock(ss.cursor, mixer, block))
 			{
 				ss.buffer = nullptr;
 				ss.cursor = nullptr;
@@ -335,6 +303,109 @@ bool AudioChannel::getBlock(const IAudioMixer* mixer, AudioBlock& outBlock)
 		outBlock.samples[i] = m_outputSamples[i];
 
 	outBlock.category = ss.category;
+	m_skipTime = 0.0;
+	return true;
+}
+
+bool AudioChannel::skipBlock(const IAudioMixer* mixer)
+{
+	StateSound& ss = m_stateSound;
+
+	if (!ss.buffer || !ss.cursor)
+		return false;
+
+	const IAudioBuffer* soundBuffer = ss.buffer;
+	T_ASSERT(soundBuffer);
+
+	// Discard pending output samples, will not be used when channel becomes audible again.
+	m_outputSamplesIn = 0;
+
+	// Advance cursor by duration of a hardware frame in sound's time.
+	m_skipTime += (double(m_hwFrameSamples) * m_pitch) / m_hwSampleRate;
+	bool rewound = false;
+	while (m_skipTime > 0.0)
+	{
+		AudioBlock block = { { 0 }, m_hwFrameSamples, 0, 0 };
+		if (!soundBuffer->skip(ss.cursor, mixer, block))
+		{
+			// Rewind if repeating, unless we just rewound and still didn't get any samples.
+			if (rewound || !rewind(mixer))
+			{
+				ss.buffer = nullptr;
+				ss.cursor = nullptr;
+				m_playing = false;
+				m_skipTime = 0.0;
+				return false;
+			}
+			rewound = true;
+			continue;
+		}
+
+		rewound = false;
+
+		// We might get a null block; does not indicate end of stream.
+		if (!block.samplesCount || !block.sampleRate)
+			break;
+
+		m_skipTime -= double(block.samplesCount) / block.sampleRate;
+	}
+
+	return true;
+}
+
+bool AudioChannel::updateState()
+{
+	StateSound& ss = m_stateSound;
+
+	// Read pending sound state from fifo.
+	{
+		StateSound next;
+		if (m_stateSoundFifo.get(next))
+		{
+			ss = next;
+			m_skipTime = 0.0;
+		}
+	}
+
+	if (!ss.buffer || !ss.cursor)
+		return false;
+
+	if (!m_allowRepeat)
+		ss.cursor->disableRepeat();
+
+	// Push pending parameters.
+	StateParameter& sp = m_stateParameters.read();
+	for (uint32_t i = 0; i < sp.set.size(); ++i)
+		ss.cursor->setParameter(sp.set[i].first, sp.set[i].second);
+	sp.set.clear();
+
+	return true;
+}
+
+bool AudioChannel::rewind(const IAudioMixer* mixer)
+{
+	StateSound& ss = m_stateSound;
+
+	if (!m_allowRepeat || !ss.repeat)
+		return false;
+
+	ss.cursor->reset();
+
+	// Skip samples when repeating.
+	uint32_t skip = ss.repeatFrom;
+	while (skip > 0)
+	{
+		AudioBlock skipBlock = { { 0 }, m_hwFrameSamples, 0, 0 };
+		if (!ss.buffer->skip(ss.cursor, mixer, skipBlock))
+			return false;
+
+		// We might get a null block, such as when streaming, does not indicate end of stream.
+		if (!skipBlock.samplesCount)
+			break;
+
+		skip -= min(skip, skipBlock.samplesCount);
+	}
+
 	return true;
 }
 
@@ -61,6 +61,12 @@ public:
 	/*! Get current pitch. */
 	float getPitch() const;
 
+	/*! Set channel priority, low priority channels are virtualized first. */
+	void setPriority(uint32_t priority);
+
+	/*! Get channel priority. */
+	uint32_t getPriority() const;
+
 	/*! Associate filter in channel. */
 	void setFilter(const IAudioFilter* filter);
 
@@ -96,9 +102,12 @@ public:
 	/*! Return current playing sound's cursor. */
 	IAudioBufferCursor* getCursor();
 
-	/*! Get next mixed and prepared sound block. */
+	/*! Get next mixed and prepared sound block, state must have been updated first. */
 	bool getBlock(const IAudioMixer* mixer, AudioBlock& outBlock);
 
+	/*! Advance current sound a block without decoding nor filtering, state must have been updated first. */
+	bool skipBlock(const IAudioMixer* mixer);
+
 private:
 	friend class AudioSystem;
 
@@ -128,6 +137,8 @@ private:
 	uint32_t m_hwFrameSamples;	//< Hardware frame size in samples.
 	float m_volume;
 	float m_pitch;
+	uint32_t m_priority;
+	double m_skipTime;			//< Accumulated time to skip when virtualized.
 	bool m_playing;
 	bool m_allowRepeat;
 	
@@ -138,6 +149,10 @@ private:
 
 	float* m_outputSamples[SbcMaxChannelCount];
 	uint32_t m_outputSamplesIn;
+
+	bool updateState();
+
+	bool rewind(const IAudioMixer* mixer);
 };
 
 }
@@ -36,6 +36,11 @@ bool AudioResourceFactory::isCacheable(const TypeInfo& productType) const
 	return true;
 }
 
+bool AudioResourceFactory::isAsyncSafe() const
+{
+	return true;
+}
+
 Ref< Object > AudioResourceFactory::create(resource::IResourceManager* resourceManager, const db::Database* database, const db::Instance* instance, const TypeInfo& productType, const Object* current) const
 {
 	Ref< const IAudioResource > resource = instance->getObject< IAudioResource >();
@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <limits>
 #include "Core/Log/Log.h"
@@ -14,7 +16,10 @@
 #include "Core/Math/Vector4.h"
 #include "Core/Memory/Alloc.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/System/OS.h"
 #include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobManager.h"
+#include "Core/Thread/Signal.h"
 #include "Core/Thread/ThreadManager.h"
 #include "Core/Timer/Timer.h"
 #include "Sound/AudioChannel.h"
@@ -30,6 +35,82 @@
 
 namespace traktor::sound
 {
+	namespace
+	{
+
+const float c_audibleThreshold = 0.001f;	//!< Channels with lower effective volume (-60 dB) are virtualized.
+const double c_deadlineFactor = 0.5;		//!< Fraction of frame duration spent generating channel blocks.
+const uint32_t c_maxMixerJobs = 8;
+
+/*! Channel blocks to be generated in a single mixer frame.
+ *
+ * Blocks are claimed one by one both by the mixer thread
+ * and helper jobs; helpers which start after all blocks
+ * has been claimed will just return thus mixer thread
+ * never need to wait for helpers to be scheduled, only
+ * for blocks already claimed by helpers to finish.
+ */
+class MixerWork : public Object
+{
+public:
+	struct Item
+	{
+		AudioChannel* channel;
+		AudioBlock* block;
+		AudioSystem::ChannelPerformance* performance;
+		bool virtualize;
+	};
+
+	AlignedVector< Item > items;
+	const IAudioMixer* mixer = nullptr;
+	const Timer* timer = nullptr;
+	double deadline = 0.0;
+	std::atomic< int32_t > next = 0;
+	std::atomic< int32_t > completed = 0;
+	std::atomic< int32_t > missed = 0;
+	Signal finished;	//!< Set when all blocks has been completed.
+
+	void process()
+	{
+		const int32_t count = (int32_t)items.size();
+		for (;;)
+		{
+			const int32_t index = next++;
+			if (index >= count)
+				break;
+
+			Item& item = items[index];
+			if (!item.virtualize)
+			{
+				// Skip channel if we're already past deadline to ensure frame get submitted in time.
+				const double startTime = timer->getElapsedTime();
+				if (startTime < deadline)
+				{
+					item.channel->getBlock(mixer, *item.block);
+					item.performance->time = (timer->getElapsedTime() - startTime) * 0.1 + item.performance->time.load() * 0.9;
+					item.performance->active = true;
+				}
+				else
+				{
+					item.channel->skipBlock(mixer);
+					item.performance->missedDeadlines++;
+					item.performance->virtualized = true;
+					missed++;
+				}
+			}
+			else
+			{
+				item.channel->skipBlock(mixer);
+				item.performance->virtualized = true;
+			}
+
+			if (++completed == count)
+				finished.set();
+		}
+	}
+};
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.AudioSystem", AudioSystem, Object)
 
@@ -38,6 +119,7 @@ AudioSystem::AudioSystem(IAudioDriver* driver)
 ,	m_suspended(false)
 ,	m_volume(1.0f)
 ,	m_threadMixer(0)
+,	m_missedDeadlines(0)
 ,	m_samplesData(0)
 ,	m_time(0.0)
 ,	m_mixerThreadTime(0.0)
@@ -104,6 +186,11 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 
 	// Set play parameters.
 	m_requestBlocks.resize(desc.channels);
+	m_channelPerformances.resize(desc.channels);
+	m_channelAudibility.resize(desc.channels, 0.0f);
+	m_activeChannels.reserve(desc.channels);
+	m_virtualChannels.reserve(desc.channels);
+	m_missedDeadlines = 0;
 	m_time = 0.0;
 
 	// Start thread.
@@ -113,14 +200,7 @@ bool AudioSystem::create(const AudioSystemCreateDesc& desc)
 
 void AudioSystem::destroy()
 {
-	// Release all channels to ensure submission thread no longer tries to request blocks from channels.
-	{
-		m_channelsLock.wait();
-		m_channels.clear();
-		m_channelsLock.release();
-	}
-
-	// Terminate mixer thread.
+	// Terminate mixer thread first, mixer might still reference samples owned by channels.
 	if (m_threadMixer)
 	{
 		m_threadMixer->stop();
@@ -128,6 +208,13 @@ void AudioSystem::destroy()
 		m_threadMixer = nullptr;
 	}
 
+	// Release all channels.
+	{
+		m_channelsLock.wait();
+		m_channels.clear();
+		m_channelsLock.release();
+	}
+
 	// Free mixer and memory resources.
 	m_mixer = nullptr;
 	safeDestroy(m_driver);
@@ -263,28 +350,94 @@ void AudioSystem::getThreadPerformances(double& outMixerTime) const
 	outMixerTime = m_mixerThreadTime;
 }
 
+void AudioSystem::getThreadPerformances(double& outMixerTime, AlignedVector< ChannelPerformance >& outChannels, uint32_t& outMissedDeadlines) const
+{
+	outMixerTime = m_mixerThreadTime;
+	outChannels = m_channelPerformances;
+	outMissedDeadlines = m_missedDeadlines;
+}
+
 void AudioSystem::threadMixer()
 {
 	AudioBlock frameBlock;
 	Timer timerMixer;
 	uint32_t channelsCount;
 
+	const double frameDuration = double(m_desc.driverDesc.frameSamples) / m_desc.driverDesc.sampleRate;
+	const uint32_t maxJobs = std::min< uint32_t >(OS::getInstance().getCPUCoreCount(), c_maxMixerJobs);
+
 	timerMixer.reset();
 	while (!m_threadMixer->stopped())
 	{
-		double startTime = timerMixer.getElapsedTime();
-		double deltaTime = timerMixer.getDeltaTime();
+		const double startTime = timerMixer.getElapsedTime();
 
 		// Read blocks from channels.
 		m_channelsLock.wait();
 		{
 			channelsCount = uint32_t(m_channels.size());
+
+			// Determine which channels are audible; inaudible channels are virtualized.
+			m_activeChannels.resize(0);
+			m_virtualChannels.resize(0);
 			for (uint32_t i = 0; i < channelsCount; ++i)
 			{
+				AudioChannel* channel = m_channels[i];
+
 				m_requestBlocks[i].samplesCount = m_desc.driverDesc.frameSamples;
 				m_requestBlocks[i].maxChannel = 0;
 				m_requestBlocks[i].category = 0;
-				m_channels[i]->getBlock(m_mixer, m_requestBlocks[i]);
+				m_channelPerformances[i].active = false;
+				m_channelPerformances[i].virtualized = false;
+
+				if (!channel->updateState())
+					continue;
+
+				const AudioChannel::StateSound& ss = channel->m_stateSound;
+				m_channelAudibility[i] = m_volume * getVolume(ss.category) * channel->m_volume * ss.volume;
+
+				if (m_channelAudibility[i] >= c_audibleThreshold)
+					m_activeChannels.push_back(i);
+				else
+					m_virtualChannels.push_back(i);
+			}
+
+			// Virtualize lowest priority, and least audible, channels if too many channels are active.
+			if (m_desc.maxActiveChannels > 0 && m_activeChannels.size() > m_desc.maxActiveChannels)
+			{
+				std::sort(m_activeChannels.begin(), m_activeChannels.end(), [&](uint32_t lh, uint32_t rh) {
+					const uint32_t lp = m_channels[lh]->m_priority;
+					const uint32_t rp = m_channels[rh]->m_priority;
+					if (lp != rp)
+						return lp > rp;
+					return m_channelAudibility[lh] > m_channelAudibility[rh];
+				});
+				m_virtualChannels.insert(m_virtualChannels.end(), m_activeChannels.begin() + m_desc.maxActiveChannels, m_activeChannels.end());
+				m_activeChannels.resize(m_desc.maxActiveChannels);
+			}
+
+			// Generate channel blocks, spread across job threads, with a deadline.
+			if (!m_activeChannels.empty() || !m_virtualChannels.empty())
+			{
+				Ref< MixerWork > work = new MixerWork();
+				work->items.reserve(m_activeChannels.size() + m_virtualChannels.size());
+				for (auto i : m_activeChannels)
+					work->items.push_back({ m_channels[i], &m_requestBlocks[i], &m_channelPerformances[i], false });
+				for (auto i : m_virtualChannels)
+					work->items.push_back({ m_channels[i], &m_requestBlocks[i], &m_channelPerformances[i], true });
+				work->mixer = m_mixer;
+				work->timer = &timerMixer;
+				work->deadline = startTime + frameDuration * c_deadlineFactor;
+
+				const uint32_t jobCount = std::min< uint32_t >((uint32_t)m_activeChannels.size(), maxJobs);
+				for (uint32_t i = 1; i < jobCount; ++i)
+					JobManager::getInstance().add([=](){ work->process(); });
+
+				work->process();
+
+				// Wait until blocks claimed by helper jobs are finished.
+				work->finished.wait();
+
+				m_missedDeadlines += work->missed;
 			}
 		}
 		m_channelsLock.release();
@@ -8,6 +8,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include "Core/Object.h"
 #include "Core/RefArray.h"
 #include "Core/Containers/AlignedVector.h"
@@ -46,6 +47,32 @@ class T_DLLCLASS AudioSystem : public Object
 	T_RTTI_CLASS;
 
 public:
+	/*! Virtual channel performance.
+	 *
+	 * Updated from mixer helper jobs thus all
+	 * members are atomic.
+	 */
+	struct ChannelPerformance
+	{
+		std::atomic< double > time = 0.0;				//!< Average duration of generating channel block in seconds.
+		std::atomic< uint32_t > missedDeadlines = 0;	//!< Number of blocks skipped since they couldn't be generated before mixer deadline.
+		std::atomic< bool > active = false;				//!< Channel block was generated last frame.
+		std::atomic< bool > virtualized = false;		//!< Channel was virtualized last frame.
+
+		ChannelPerformance() = default;
+
+		ChannelPerformance(const ChannelPerformance& rh) { *this = rh; }
+
+		ChannelPerformance& operator = (const ChannelPerformance& rh)
+		{
+			time = rh.time.load();
+			missedDeadlines = rh.missedDeadlines.load();
+			active = rh.active.load();
+			virtualized = rh.virtualized.load();
+			return *this;
+		}
+	};
+
 	explicit AudioSystem(IAudioDriver* driver);
 
 	/*! Create audio system.
@@ -125,6 +152,14 @@ public:
 	 */
 	void getThreadPerformances(double& outMixerTime) const;
 
+	/*! Query performance of each thread and virtual channel.
+	 *
+	 * \param outMixerTime Last mixer thread duration in seconds.
+	 * \param outChannels Performance of each virtual channel.
+	 * \param outMissedDeadlines Total number of channel blocks skipped due to missed mixer deadline.
+	 */
+	void getThreadPerformances(double& outMixerTime, AlignedVector< ChannelPerformance >& outChannels, uint32_t& outMissedDeadlines) const;
+
 private:
 	Ref< IAudioDriver > m_driver;
 	Ref< IAudioMixer > m_mixer;
@@ -135,6 +170,11 @@ private:
 	Thread* m_threadMixer;
 	RefArray< AudioChannel > m_channels;
 	AlignedVector< AudioBlock > m_requestBlocks;
+	AlignedVector< ChannelPerformance > m_channelPerformances;
+	AlignedVector< float > m_channelAudibility;
+	AlignedVector< uint32_t > m_activeChannels;
+	AlignedVector< uint32_t > m_virtualChannels;
+	std::atomic< uint32_t > m_missedDeadlines;
 
 	// \name Submission queue
 	// \{
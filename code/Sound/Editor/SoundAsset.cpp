@@ -18,7 +18,7 @@
 namespace traktor::sound
 {
 
-T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.sound.SoundAsset", 8, SoundAsset, editor::Asset)
+T_IMPLEMENT_RTTI_EDIT_CLASS(L"traktor.sound.SoundAsset", 9, SoundAsset, editor::Asset)
 
 void SoundAsset::serialize(ISerializer& s)
 {
@@ -55,6 +55,9 @@ void SoundAsset::serialize(ISerializer& s)
 			m_gain = linearToDecibel(volumeLin);
 		}
 	}
+
+	if (s.getVersion() >= 9)
+		s >> Member< uint32_t >(L"lookAhead", m_lookAhead);
 }
 
 }
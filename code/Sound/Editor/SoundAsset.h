@@ -43,6 +43,10 @@ public:
 
 	float getGain() const { return m_gain; }
 
+	void setLookAhead(uint32_t lookAhead) { m_lookAhead = lookAhead; }
+
+	uint32_t getLookAhead() const { return m_lookAhead; }
+
 private:
 	friend class SoundPipeline;
 
@@ -51,6 +55,7 @@ private:
 	bool m_preload = false;
 	bool m_compressed = true;
 	float m_gain = 0.0f;
+	uint32_t m_lookAhead = 0;	//!< Number of blocks decoded ahead of mixer when streaming, 0 to decode in mixer thread.
 };
 
 }
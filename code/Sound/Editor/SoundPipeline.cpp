@@ -61,7 +61,7 @@ bool isMute(const AudioBlock& block, uint32_t& outMuteOffset)
 
 	}
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.SoundPipeline", 33, SoundPipeline, editor::IPipeline)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.SoundPipeline", 34, SoundPipeline, editor::IPipeline)
 
 bool SoundPipeline::create(const editor::IPipelineSettings* settings)
 {
@@ -188,6 +188,7 @@ bool SoundPipeline::buildOutput(
 		resource->m_gain = gain;
 		resource->m_range = range;
 		resource->m_preload = soundAsset->m_preload;
+		resource->m_lookAhead = soundAsset->m_lookAhead;
 
 		Ref< db::Instance > instance = pipelineBuilder->createOutputInstance(
 			outputPath,
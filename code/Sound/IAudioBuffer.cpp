@@ -13,4 +13,9 @@ namespace traktor::sound
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.IAudioBuffer", IAudioBuffer, Object)
 
+bool IAudioBuffer::skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	return getBlock(cursor, mixer, outBlock);
+}
+
 }
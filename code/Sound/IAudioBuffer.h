@@ -49,6 +49,17 @@ public:
 	virtual Ref< IAudioBufferCursor > createCursor() const = 0;
 
 	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const = 0;
+
+	/*! Advance cursor without producing samples.
+	 *
+	 * Used by virtualized channels which only need
+	 * to keep track of playback position. Output block
+	 * is updated with number of samples and sample rate
+	 * but sample pointers are not guaranteed to be valid.
+	 *
+	 * Default implementation read block through getBlock.
+	 */
+	virtual bool skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const;
 };
 
 }
@@ -116,6 +116,7 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, uint32_t priority)
 				channel.audioChannel->setFilter(nullptr);
 				channel.audioChannel->setVolume(1.0f);
 				channel.priority = priority;
+				channel.audioChannel->setPriority(priority);
 				channel.fadeOff = -1.0f;
 				channel.time = time;
 				channel.autoStopFar = false;
@@ -147,6 +148,7 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, uint32_t priority)
 				channel.audioChannel->setFilter(nullptr);
 				channel.audioChannel->setVolume(1.0f);
 				channel.priority = priority;
+				channel.audioChannel->setPriority(priority);
 				channel.fadeOff = -1.0f;
 				channel.time = time;
 				channel.autoStopFar = false;
@@ -228,6 +230,7 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, const Vector4& position
 				channel.audioChannel->setFilter(groupFilter);
 				channel.audioChannel->setVolume(1.0f);
 				channel.priority = priority;
+				channel.audioChannel->setPriority(priority);
 				channel.fadeOff = -1.0f;
 				channel.time = time;
 				channel.autoStopFar = autoStopFar;
@@ -259,6 +262,7 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, const Vector4& position
 				channel.audioChannel->setFilter(groupFilter);
 				channel.audioChannel->setVolume(1.0f);
 				channel.priority = priority;
+				channel.audioChannel->setPriority(priority);
 				channel.fadeOff = -1.0f;
 				channel.time = time;
 				channel.autoStopFar = autoStopFar;
@@ -295,6 +299,7 @@ Ref< SoundHandle > SoundPlayer::play(const Sound* sound, const Vector4& position
 				channel.audioChannel->setFilter(groupFilter);
 				channel.audioChannel->setVolume(1.0f);
 				channel.priority = priority;
+				channel.audioChannel->setPriority(priority);
 				channel.fadeOff = -1.0f;
 				channel.time = time;
 				channel.autoStopFar = autoStopFar;
@@ -10,7 +10,8 @@
 #include "Sound/Processor/Graph.h"
 #include "Sound/Processor/GraphBuffer.h"
 #include "Sound/Processor/GraphEvaluator.h"
-#include "Sound/Processor/Nodes/Output.h"
+#include "Sound/Processor/GraphProgram.h"
+#include "Sound/Processor/Node.h"
 
 namespace traktor::sound
 {
@@ -21,7 +22,6 @@ class GraphBufferCursor : public RefCountImpl< IAudioBufferCursor >
 {
 public:
 	Ref< GraphEvaluator > m_evaluator;
-	Ref< const InputPin > m_outputPin;
 
 	virtual void setParameter(handle_t id, float parameter) override final
 	{
@@ -38,32 +38,36 @@ public:
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.GraphBuffer", GraphBuffer, Object)
 
 GraphBuffer::GraphBuffer(const Graph* graph)
-:	m_graph(graph)
+:	m_program(GraphProgram::compile(graph))
 {
 }
 
-Ref< IAudioBufferCursor > GraphBuffer::createCursor() const
+GraphBuffer::GraphBuffer(const GraphProgram* program)
+:	m_program(program)
 {
-	Ref< GraphBufferCursor > graphCursor = new GraphBufferCursor();
+}
 
-	graphCursor->m_evaluator = new GraphEvaluator();
-	if (!graphCursor->m_evaluator->create(m_graph))
+Ref< IAudioBufferCursor > GraphBuffer::createCursor() const
+{
+	if (!m_program)
 	{
-		log::error << L"Unable to create graph evaluator." << Endl;
+		log::error << L"Unable to create graph evaluator; invalid graph." << Endl;
 		return nullptr;
 	}
 
-	for (auto node : m_graph->getNodes())
+	const int32_t outputNode = m_program->getOutputNode();
+	if (outputNode < 0)
 	{
-		if (is_a< Output >(node))
-		{
-			graphCursor->m_outputPin = node->getInputPin(0);
-			break;
-		}
+		log::error << L"Unable to find output pin." << Endl;
+		return nullptr;
 	}
-	if (!graphCursor->m_outputPin)
+
+	Ref< GraphBufferCursor > graphCursor = new GraphBufferCursor();
+
+	graphCursor->m_evaluator = new GraphEvaluator();
+	if (!graphCursor->m_evaluator->create(m_program))
 	{
-		log::error << L"Unable to find output pin." << Endl;
+		log::error << L"Unable to create graph evaluator." << Endl;
 		return nullptr;
 	}
 
@@ -73,14 +77,7 @@ Ref< IAudioBufferCursor > GraphBuffer::createCursor() const
 bool GraphBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
 	GraphBufferCursor* graphCursor = static_cast< GraphBufferCursor* >(cursor);
-
-	graphCursor->m_evaluator->flushCachedBlocks();
-
-	return graphCursor->m_evaluator->evaluateBlock(
-		graphCursor->m_outputPin,
-		mixer,
-		outBlock
-	);
+	return graphCursor->m_evaluator->evaluate(mixer, outBlock);
 }
 
 }
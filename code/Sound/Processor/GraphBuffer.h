@@ -23,6 +23,7 @@ namespace traktor::sound
 {
 
 class Graph;
+class GraphProgram;
 
 /*! GraphBuffer instance.
  */
@@ -33,12 +34,14 @@ class T_DLLCLASS GraphBuffer : public IAudioBuffer
 public:
 	explicit GraphBuffer(const Graph* graph);
 
+	explicit GraphBuffer(const GraphProgram* program);
+
 	virtual Ref< IAudioBufferCursor > createCursor() const override final;
 
 	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final;
 
 private:
-	Ref< const Graph > m_graph;
+	Ref< const GraphProgram > m_program;
 };
 
 }
@@ -10,6 +10,7 @@
 #include "Core/Log/Log.h"
 #include "Core/Math/Vector4.h"
 #include "Core/Memory/Alloc.h"
+#include "Core/Misc/Align.h"
 #include "Sound/IAudioBuffer.h"
 #include "Sound/Processor/Graph.h"
 #include "Sound/Processor/GraphEvaluator.h"
@@ -18,118 +19,155 @@
 
 namespace traktor::sound
 {
+	namespace
+	{
+
+void copySamples(float* dp, const float* sp, uint32_t samplesCount)
+{
+	uint32_t j = 0;
+	for (; j + 16 <= samplesCount; j += 16)
+	{
+		const Vector4 s0 = Vector4::loadAligned(sp + j);
+		const Vector4 s1 = Vector4::loadAligned(sp + j + 4);
+		const Vector4 s2 = Vector4::loadAligned(sp + j + 8);
+		const Vector4 s3 = Vector4::loadAligned(sp + j + 12);
+
+		s0.storeAligned(dp + j);
+		s1.storeAligned(dp + j + 4);
+		s2.storeAligned(dp + j + 8);
+		s3.storeAligned(dp + j + 12);
+	}
+	for (; j < samplesCount; j += 4)
+		Vector4::loadAligned(sp + j).storeAligned(dp + j);
+}
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.GraphEvaluator", GraphEvaluator, Object)
 
+GraphEvaluator::~GraphEvaluator()
+{
+	for (auto& slot : m_slots)
+	{
+		if (slot.copies)
+			Alloc::freeAlign(slot.copies);
+	}
+}
+
 bool GraphEvaluator::create(const Graph* graph)
 {
-	m_graph = graph;
-	for (auto node : graph->getNodes())
+	Ref< const GraphProgram > program = GraphProgram::compile(graph);
+	if (!program)
+		return false;
+
+	return create(program);
+}
+
+bool GraphEvaluator::create(const GraphProgram* program)
+{
+	m_program = program;
+
+	const auto& nodes = program->getNodes();
+	m_cursors.resize(nodes.size());
+	for (size_t i = 0; i < nodes.size(); ++i)
 	{
-		Ref< IAudioBufferCursor > nodeCursor = node->createCursor();
-		if (!nodeCursor)
+		m_cursors[i] = nodes[i]->createCursor();
+		if (!m_cursors[i])
 		{
-			log::error << L"Node \"" << type_name(node) << L"\" failed; no cursor." << Endl;
+			log::error << L"Node \"" << type_name(nodes[i]) << L"\" failed; no cursor." << Endl;
 			return false;
 		}
-
-		m_nodeCursors[node] = nodeCursor;
 	}
+
+	m_slots.resize(program->getOutputs().size());
+	m_generation = 1;
 	m_timer.reset();
 	return true;
 }
 
 void GraphEvaluator::setParameter(handle_t id, float parameter)
 {
-	for (auto it : m_nodeCursors)
-		it.second->setParameter(id, parameter);
+	for (auto cursor : m_cursors)
+		cursor->setParameter(id, parameter);
 }
 
-bool GraphEvaluator::evaluateScalar(const OutputPin* producerPin, float& outScalar) const
+bool GraphEvaluator::evaluate(const IAudioMixer* mixer, AudioBlock& outBlock)
 {
-	const Node* producerNode = producerPin->getNode();
-	T_ASSERT(producerNode != nullptr);
-
-	IAudioBufferCursor* producerCursor = m_nodeCursors[producerNode];
-	if (!producerCursor)
+	const int32_t outputNode = m_program->getOutputNode();
+	if (outputNode < 0)
 		return false;
 
-	if (!producerNode->getScalar(producerCursor, this, outScalar))
-		return false;
+	m_generation++;
 
-	return true;
-}
+	// Evaluate scheduled outputs in order; inputs of each node
+	// have already been evaluated when node is executed.
+	const auto& outputs = m_program->getOutputs();
+	for (const int32_t slot : m_program->getSchedule())
+		executeSlot(outputs[slot], mixer, outBlock);
 
-bool GraphEvaluator::evaluateScalar(const InputPin* consumerPin, float& outScalar) const
-{
-	const OutputPin* producerPin = m_graph->findSourcePin(consumerPin);
-	if (producerPin)
-		return evaluateScalar(producerPin, outScalar);
+	const GraphProgram::Input& input = m_program->getNodeInputs(outputNode)[0];
+	if (input.slot >= 0)
+		return evaluateSlot(outputs[input.slot], mixer, outBlock);
 	else
 		return false;
 }
 
-bool GraphEvaluator::evaluateBlock(const OutputPin* producerPin, const IAudioMixer* mixer, AudioBlock& outBlock) const
+bool GraphEvaluator::evaluateScalar(const OutputPin* producerPin, float& outScalar) const
 {
-	const Node* producerNode = producerPin->getNode();
-	T_ASSERT(producerNode != nullptr);
+	const GraphProgram::Output* output = m_program->findOutput(producerPin);
+	if (!output)
+		return false;
 
-	IAudioBufferCursor* producerCursor = m_nodeCursors[producerNode];
-	if (!producerCursor)
+	const int32_t current = m_current;
+	m_current = output->node;
+	const Node* producerNode = m_program->getNodes()[output->node];
+	const bool result = producerNode->getScalar(m_cursors[output->node], this, outScalar);
+	m_current = current;
+	return result;
+}
+
+bool GraphEvaluator::evaluateScalar(const InputPin* consumerPin, float& outScalar) const
+{
+	const GraphProgram::Input* input = findInput(consumerPin);
+	if (!input || input->node < 0)
 		return false;
 
-	const uint32_t consumerCount = m_graph->getDestinationCount(producerPin);
-	if (consumerCount == 1)
+	if (input->constant)
 	{
-		if (!producerNode->getBlock(producerCursor, this, mixer, outBlock))
-			return false;
+		outScalar = input->value;
+		return true;
 	}
-	else if (consumerCount >= 2)
-	{
-		// Need to buffer output of node since we have multiple consumers.
-		auto it = m_cachedBlocks.find(producerPin);
-		if (it != m_cachedBlocks.end())
-		{
-			if (consumerCount == 2)
-				outBlock = it->second;
-			else
-			{
-				auto copiedBlock = copyBlock(it->second);
-				if (!copiedBlock)
-					return false;
-
-				outBlock = *copiedBlock;		
-			}
-		}
-		else
-		{
-			if (!producerNode->getBlock(producerCursor, this, mixer, outBlock))
-				return false;
 
-			auto copiedBlock = copyBlock(outBlock);
-			if (!copiedBlock)
-				return false;
-
-			m_cachedBlocks[producerPin] = *copiedBlock;
-		}
-	}
+	const int32_t current = m_current;
+	m_current = input->node;
+	const Node* producerNode = m_program->getNodes()[input->node];
+	const bool result = producerNode->getScalar(m_cursors[input->node], this, outScalar);
+	m_current = current;
+	return result;
+}
 
-	return true;
+bool GraphEvaluator::evaluateBlock(const OutputPin* producerPin, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	const GraphProgram::Output* output = m_program->findOutput(producerPin);
+	if (output)
+		return evaluateSlot(*output, mixer, outBlock);
+	else
+		return false;
 }
 
 bool GraphEvaluator::evaluateBlock(const InputPin* consumerPin, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
-	const OutputPin* producerPin = m_graph->findSourcePin(consumerPin);
-	if (producerPin)
-		return evaluateBlock(producerPin, mixer, outBlock);
+	const GraphProgram::Input* input = findInput(consumerPin);
+	if (input && input->slot >= 0)
+		return evaluateSlot(m_program->getOutputs()[input->slot], mixer, outBlock);
 	else
 		return false;
 }
 
 NodePinType GraphEvaluator::evaluatePinType(const InputPin* consumerPin) const
 {
-	const OutputPin* producerPin = m_graph->findSourcePin(consumerPin);
-	return producerPin ? producerPin->getPinType() : NodePinType::Void;
+	const GraphProgram::Input* input = findInput(consumerPin);
+	return input ? input->type : NodePinType::Void;
 }
 
 float GraphEvaluator::getTime() const
@@ -139,57 +177,104 @@ float GraphEvaluator::getTime() const
 
 void GraphEvaluator::flushCachedBlocks()
 {
-	for (auto& block : m_blocks)
+	// Invalidate all slots; slots are lazily evaluated when first consumed.
+	m_generation++;
+}
+
+const GraphProgram::Input* GraphEvaluator::findInput(const InputPin* consumerPin) const
+{
+	// Consumer pin belongs to node being evaluated; resolve through node's flat input table.
+	if (m_current >= 0)
+	{
+		const Node* node = m_program->getNodes()[m_current];
+		const GraphProgram::Input* inputs = m_program->getNodeInputs(m_current);
+		for (size_t i = 0; i < node->getInputPinCount(); ++i)
+		{
+			if (node->getInputPin(i) == consumerPin)
+				return &inputs[i];
+		}
+	}
+	return m_program->findInput(consumerPin);
+}
+
+void GraphEvaluator::executeSlot(const GraphProgram::Output& output, const IAudioMixer* mixer, const AudioBlock& request) const
+{
+	Slot& slot = m_slots[output.slot];
+
+	slot.generation = m_generation;
+	slot.served = 0;
+	slot.block = request;
+
+	const int32_t current = m_current;
+	m_current = output.node;
+	const Node* producerNode = m_program->getNodes()[output.node];
+	slot.valid = producerNode->getBlock(m_cursors[output.node], this, mixer, slot.block);
+	m_current = current;
+
+	// Keep pristine copy of block if multiple consumers since consumers are allowed to modify block in-place.
+	if (slot.valid && output.consumers >= 2)
 	{
+		const uint32_t samplesCount = alignUp(slot.block.samplesCount, 4);
+		if (slot.copiesSamplesCount < samplesCount)
+		{
+			if (slot.copies)
+				Alloc::freeAlign(slot.copies);
+
+			slot.copies = (float*)Alloc::acquireAlign((output.consumers - 1) * SbcMaxChannelCount * samplesCount * sizeof(float), 16, T_FILE_LINE);
+			slot.copiesSamplesCount = samplesCount;
+		}
+
+		// Copy all channels which are served, not only those below max channel.
 		for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
 		{
-			if (block.samples[i])
-				Alloc::freeAlign(block.samples[i]);
+			if (slot.block.samples[i])
+				copySamples(slot.copies + i * slot.copiesSamplesCount, slot.block.samples[i], slot.block.samplesCount);
 		}
 	}
-	m_blocks.clear();
-	m_cachedBlocks.reset();
 }
 
-AudioBlock* GraphEvaluator::copyBlock(const AudioBlock& sourceBlock) const
+bool GraphEvaluator::evaluateSlot(const GraphProgram::Output& output, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
-	if (m_blocks.full())
-		return nullptr;
+	Slot& slot = m_slots[output.slot];
 
-	AudioBlock& block = m_blocks.push_back();
+	// Outputs which are not scheduled are evaluated on demand, once per block.
+	if (slot.generation != m_generation)
+		executeSlot(output, mixer, outBlock);
 
+	if (!slot.valid)
+		return false;
+
+	// First consumer get original block, last consumer get pristine copy
+	// and all other consumers get their own copy of pristine copy.
+	const uint32_t served = slot.served++;
+	if (output.consumers < 2 || served == 0)
+	{
+		outBlock = slot.block;
+		return true;
+	}
+
+	const uint32_t channelStride = slot.copiesSamplesCount;
+	const uint32_t copyStride = SbcMaxChannelCount * channelStride;
+	float* pristine = slot.copies;
+
+	float* copy = pristine;
+	if (served < output.consumers - 1)
+		copy = slot.copies + served * copyStride;
+
+	outBlock = slot.block;
 	for (uint32_t i = 0; i < SbcMaxChannelCount; ++i)
 	{
-		if (sourceBlock.samples[i])
+		if (slot.block.samples[i])
 		{
-			block.samples[i] = (float*)Alloc::acquireAlign(sourceBlock.samplesCount * sizeof(float), 16, T_FILE_LINE);
-
-			const float* sp = sourceBlock.samples[i];
-			float* dp = block.samples[i];
-
-			for (uint32_t j = 0; j < sourceBlock.samplesCount; j += 4 * 4)
-			{
-				const Vector4 s0 = Vector4::loadAligned(sp); sp += 4;
-				const Vector4 s1 = Vector4::loadAligned(sp); sp += 4;
-				const Vector4 s2 = Vector4::loadAligned(sp); sp += 4;
-				const Vector4 s3 = Vector4::loadAligned(sp); sp += 4;
-				
-				s0.storeAligned(dp); dp += 4;
-				s1.storeAligned(dp); dp += 4;
-				s2.storeAligned(dp); dp += 4;
-				s3.storeAligned(dp); dp += 4;
-			}
+			if (copy != pristine)
+				copySamples(copy + i * channelStride, pristine + i * channelStride, slot.block.samplesCount);
+			outBlock.samples[i] = copy + i * channelStride;
 		}
 		else
-			block.samples[i] = nullptr;
+			outBlock.samples[i] = nullptr;
 	}
 
-	block.samplesCount = sourceBlock.samplesCount;
-	block.sampleRate = sourceBlock.sampleRate;
-	block.maxChannel = sourceBlock.maxChannel;
-	block.category = sourceBlock.category;
-
-	return &block;
+	return true;
 }
 
 }
@@ -10,10 +10,10 @@
 
 #include "Core/Object.h"
 #include "Core/Ref.h"
-#include "Core/Containers/SmallMap.h"
-#include "Core/Containers/StaticVector.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Timer/Timer.h"
 #include "Sound/Types.h"
+#include "Sound/Processor/GraphProgram.h"
 #include "Sound/Processor/ProcessorTypes.h"
 
 // import/export mechanism.
@@ -35,15 +35,36 @@ class Node;
 class OutputPin;
 struct AudioBlock;
 
+/*! Graph evaluator.
+ * \ingroup Sound
+ *
+ * Evaluate an instance of a compiled graph program, each
+ * output pin is evaluated at most once per block into its
+ * preassigned slot. Scheduled outputs are evaluated linearly
+ * in topological order, outputs not scheduled are evaluated
+ * on demand.
+ */
 class T_DLLCLASS GraphEvaluator : public Object
 {
 	T_RTTI_CLASS;
 
 public:
+	virtual ~GraphEvaluator();
+
 	bool create(const Graph* graph);
 
+	bool create(const GraphProgram* program);
+
 	void setParameter(handle_t id, float parameter);
 
+	/*! Evaluate next block of graph's output node.
+	 *
+	 * \param mixer Mixer.
+	 * \param outBlock Output block.
+	 * \return True if block evaluated.
+	 */
+	bool evaluate(const IAudioMixer* mixer, AudioBlock& outBlock);
+
 	bool evaluateScalar(const OutputPin* producerPin, float& outScalar) const;
 
 	bool evaluateScalar(const InputPin* consumerPin, float& outScalar) const;
@@ -59,14 +80,28 @@ public:
 	void flushCachedBlocks();
 
 private:
-	Ref< const Graph > m_graph;
-	SmallMap< const Node*, Ref< IAudioBufferCursor > > m_nodeCursors;
+	struct Slot
+	{
+		AudioBlock block;
+		float* copies = nullptr;		//!< Copies of block, one for each additional consumer.
+		uint32_t copiesSamplesCount = 0;
+		uint32_t generation = 0;
+		uint32_t served = 0;
+		bool valid = false;
+	};
+
+	Ref< const GraphProgram > m_program;
+	AlignedVector< Ref< IAudioBufferCursor > > m_cursors;
 	Timer m_timer;
+	mutable AlignedVector< Slot > m_slots;
+	mutable int32_t m_current = -1;		//!< Index of node being evaluated, inputs are resolved relative to this node.
+	uint32_t m_generation = 0;
+
+	const GraphProgram::Input* findInput(const InputPin* consumerPin) const;
 
-	mutable StaticVector< AudioBlock, 128 > m_blocks;
-	mutable SmallMap< const OutputPin*, AudioBlock > m_cachedBlocks;
+	void executeSlot(const GraphProgram::Output& output, const IAudioMixer* mixer, const AudioBlock& request) const;
 
-	AudioBlock* copyBlock(const AudioBlock& sourceBlock) const;
+	bool evaluateSlot(const GraphProgram::Output& output, const IAudioMixer* mixer, AudioBlock& outBlock) const;
 };
 
 }
@@ -0,0 +1,205 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <functional>
+#include "Core/Log/Log.h"
+#include "Core/Math/Float.h"
+#include "Sound/Processor/Graph.h"
+#include "Sound/Processor/GraphProgram.h"
+#include "Sound/Processor/InputPin.h"
+#include "Sound/Processor/Node.h"
+#include "Sound/Processor/OutputPin.h"
+#include "Sound/Processor/Nodes/Add.h"
+#include "Sound/Processor/Nodes/Blend.h"
+#include "Sound/Processor/Nodes/Divide.h"
+#include "Sound/Processor/Nodes/Multiply.h"
+#include "Sound/Processor/Nodes/Output.h"
+#include "Sound/Processor/Nodes/Scalar.h"
+#include "Sound/Processor/Nodes/Subtract.h"
+
+namespace traktor::sound
+{
+	namespace
+	{
+
+/*! Fold scalar output of node if it only depend on constant nodes. */
+bool foldScalar(const Graph* graph, const OutputPin* outputPin, float& outValue)
+{
+	const Node* node = outputPin->getNode();
+
+	if (auto scalar = dynamic_type_cast< const Scalar* >(node))
+	{
+		outValue = scalar->getValue();
+		return true;
+	}
+
+	if (!(is_a< Add >(node) || is_a< Subtract >(node) || is_a< Multiply >(node) || is_a< Divide >(node) || is_a< Blend >(node)))
+		return false;
+
+	float v[3] = { 0.0f, 0.0f, 0.0f };
+	const size_t inputPinCount = node->getInputPinCount();
+	if (inputPinCount > sizeof_array(v))
+		return false;
+
+	for (size_t i = 0; i < inputPinCount; ++i)
+	{
+		const OutputPin* sourcePin = graph->findSourcePin(node->getInputPin(i));
+		if (!sourcePin || !foldScalar(graph, sourcePin, v[i]))
+			return false;
+	}
+
+	if (is_a< Add >(node))
+		outValue = v[0] + v[1];
+	else if (is_a< Subtract >(node))
+		outValue = v[0] - v[1];
+	else if (is_a< Multiply >(node))
+		outValue = v[0] * v[1];
+	else if (is_a< Divide >(node))
+		outValue = v[0] / v[1];
+	else if (is_a< Blend >(node))
+		outValue = lerp(v[0], v[1], v[2]);
+
+	return true;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.GraphProgram", GraphProgram, Object)
+
+Ref< GraphProgram > GraphProgram::compile(const Graph* graph)
+{
+	Ref< GraphProgram > program = new GraphProgram();
+	program->m_graph = graph;
+
+	// Sort nodes topologically, each node is placed after the nodes it depend on.
+	SmallMap< const Node*, int32_t > nodeIndices;
+	SmallMap< const Node*, int32_t > visitState;
+	bool cyclic = false;
+
+	std::function< void(const Node*) > visit = [&](const Node* node) {
+		const int32_t state = visitState[node];
+		if (state == 2)
+			return;
+		if (state == 1)
+		{
+			cyclic = true;
+			return;
+		}
+
+		visitState[node] = 1;
+		for (size_t i = 0; i < node->getInputPinCount(); ++i)
+		{
+			const OutputPin* sourcePin = graph->findSourcePin(node->getInputPin(i));
+			if (sourcePin)
+				visit(sourcePin->getNode());
+		}
+		visitState[node] = 2;
+
+		nodeIndices[node] = (int32_t)program->m_nodes.size();
+		program->m_nodes.push_back(node);
+	};
+
+	for (auto node : graph->getNodes())
+		visit(node);
+
+	if (cyclic)
+	{
+		log::error << L"Unable to compile sound graph; graph contains cycles." << Endl;
+		return nullptr;
+	}
+
+	// Assign a block slot to each output pin.
+	for (int32_t i = 0; i < (int32_t)program->m_nodes.size(); ++i)
+	{
+		const Node* node = program->m_nodes[i];
+		for (size_t j = 0; j < node->getOutputPinCount(); ++j)
+		{
+			const OutputPin* outputPin = node->getOutputPin(j);
+
+			Output& output = program->m_outputs.push_back();
+			output.node = i;
+			output.slot = (int32_t)(program->m_outputs.size() - 1);
+			output.type = outputPin->getPinType();
+			output.consumers = graph->getDestinationCount(outputPin);
+
+			program->m_outputSlots[outputPin] = output.slot;
+		}
+
+		if (is_a< sound::Output >(node) && program->m_outputNode < 0)
+			program->m_outputNode = i;
+	}
+
+	// Resolve all input pins, fold constant scalar inputs.
+	program->m_nodeInputOffsets.resize(program->m_nodes.size());
+	for (int32_t i = 0; i < (int32_t)program->m_nodes.size(); ++i)
+	{
+		const Node* node = program->m_nodes[i];
+		program->m_nodeInputOffsets[i] = (uint32_t)program->m_nodeInputs.size();
+
+		for (size_t j = 0; j < node->getInputPinCount(); ++j)
+		{
+			const InputPin* inputPin = node->getInputPin(j);
+			Input& input = program->m_nodeInputs.push_back();
+
+			const OutputPin* sourcePin = graph->findSourcePin(inputPin);
+			if (sourcePin)
+			{
+				input.node = nodeIndices[sourcePin->getNode()];
+				input.slot = (int32_t)program->m_outputSlots[sourcePin];
+				input.type = sourcePin->getPinType();
+				input.constant = foldScalar(graph, sourcePin, input.value);
+			}
+
+			program->m_inputs[inputPin] = input;
+		}
+	}
+
+	// Schedule signal outputs consumed by output node; nodes are visited in
+	// reverse topological order so all consumers are visited before producer.
+	if (program->m_outputNode >= 0)
+	{
+		AlignedVector< bool > consumed(program->m_nodes.size(), false);
+		consumed[program->m_outputNode] = true;
+
+		for (int32_t i = (int32_t)program->m_nodes.size() - 1; i >= 0; --i)
+		{
+			if (!consumed[i])
+				continue;
+
+			const Input* inputs = program->getNodeInputs(i);
+			for (size_t j = 0; j < program->m_nodes[i]->getInputPinCount(); ++j)
+			{
+				if (inputs[j].node >= 0 && inputs[j].type == NodePinType::Signal && !inputs[j].constant)
+					consumed[inputs[j].node] = true;
+			}
+		}
+
+		// Outputs are in topological order since they're assigned in node order.
+		for (const auto& output : program->m_outputs)
+		{
+			if (consumed[output.node] && output.type == NodePinType::Signal)
+				program->m_schedule.push_back(output.slot);
+		}
+	}
+
+	return program;
+}
+
+const GraphProgram::Input* GraphProgram::findInput(const InputPin* inputPin) const
+{
+	const auto it = m_inputs.find(inputPin);
+	return it != m_inputs.end() ? &it->second : nullptr;
+}
+
+const GraphProgram::Output* GraphProgram::findOutput(const OutputPin* outputPin) const
+{
+	const auto it = m_outputSlots.find(outputPin);
+	return it != m_outputSlots.end() ? &m_outputs[it->second] : nullptr;
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "Core/Object.h"
+#include "Core/Ref.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/SmallMap.h"
+#include "Sound/Processor/ProcessorTypes.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_SOUND_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::sound
+{
+
+class Graph;
+class InputPin;
+class Node;
+class OutputPin;
+
+/*! Compiled graph program.
+ * \ingroup Sound
+ *
+ * Flat representation of a graph, shared by all evaluator
+ * instances, where all edges has been resolved and each
+ * output pin has a preassigned block slot. Scalar inputs
+ * which only depend on constant nodes are folded into
+ * a constant value.
+ *
+ * Signal outputs which are consumed by the graph's output
+ * node, directly or indirectly, are scheduled in topological
+ * order so evaluator can execute them linearly.
+ */
+class T_DLLCLASS GraphProgram : public Object
+{
+	T_RTTI_CLASS;
+
+public:
+	struct Input
+	{
+		int32_t node = -1;						//!< Index of source node, -1 if not connected.
+		int32_t slot = -1;						//!< Slot of source output pin.
+		NodePinType type = NodePinType::Void;	//!< Type of source output pin.
+		bool constant = false;					//!< Source is a constant scalar.
+		float value = 0.0f;						//!< Folded constant value.
+	};
+
+	struct Output
+	{
+		int32_t node = -1;						//!< Index of node.
+		int32_t slot = -1;						//!< Slot of output pin.
+		NodePinType type = NodePinType::Void;	//!< Type of output pin.
+		uint32_t consumers = 0;					//!< Number of connected input pins.
+	};
+
+	/*! Compile graph into program.
+	 *
+	 * \param graph Source graph.
+	 * \return Compiled program, null if graph is invalid.
+	 */
+	static Ref< GraphProgram > compile(const Graph* graph);
+
+	const Graph* getGraph() const { return m_graph; }
+
+	/*! Get nodes in topological order, each node after the nodes it depend on. */
+	const AlignedVector< const Node* >& getNodes() const { return m_nodes; }
+
+	/*! Get output slots. */
+	const AlignedVector< Output >& getOutputs() const { return m_outputs; }
+
+	/*! Get index of graph's output node. */
+	int32_t getOutputNode() const { return m_outputNode; }
+
+	/*! Get output slots to evaluate, in order, for each block. */
+	const AlignedVector< int32_t >& getSchedule() const { return m_schedule; }
+
+	/*! Get resolved inputs of node, in same order as node's input pins. */
+	const Input* getNodeInputs(int32_t node) const { return m_nodeInputs.c_ptr() + m_nodeInputOffsets[node]; }
+
+	const Input* findInput(const InputPin* inputPin) const;
+
+	const Output* findOutput(const OutputPin* outputPin) const;
+
+private:
+	Ref< const Graph > m_graph;
+	AlignedVector< const Node* > m_nodes;
+	AlignedVector< Output > m_outputs;
+	AlignedVector< int32_t > m_schedule;
+	AlignedVector< Input > m_nodeInputs;
+	AlignedVector< uint32_t > m_nodeInputOffsets;
+	SmallMap< const InputPin*, Input > m_inputs;
+	SmallMap< const OutputPin*, uint32_t > m_outputSlots;
+	int32_t m_outputNode = -1;
+};
+
+}
@@ -11,6 +11,7 @@
 #include "Sound/Sound.h"
 #include "Sound/Processor/Graph.h"
 #include "Sound/Processor/GraphBuffer.h"
+#include "Sound/Processor/GraphProgram.h"
 #include "Sound/Processor/GraphResource.h"
 #include "Sound/Processor/Node.h"
 
@@ -40,8 +41,13 @@ Ref< Sound > GraphResource::createSound(resource::IResourceManager* resourceMana
 			return nullptr;
 	}
 
+	// Compile graph once; program is shared by all cursors.
+	Ref< const GraphProgram > program = GraphProgram::compile(m_graph);
+	if (!program)
+		return nullptr;
+
 	return new Sound(
-		new GraphBuffer(m_graph),
+		new GraphBuffer(program),
 		getParameterHandle(m_category),
 		m_gain,
 		m_range
@@ -40,6 +40,8 @@ public:
 
 	virtual void serialize(ISerializer& s) override final;
 
+	void setValue(float value) { m_value = value; }
+
 	float getValue() const { return m_value; }
 
 private:
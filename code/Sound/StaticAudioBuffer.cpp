@@ -225,4 +225,27 @@ bool StaticAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer*
 	return true;
 }
 
+bool StaticAudioBuffer::skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	StaticAudioBufferCursor* ssbc = static_cast< StaticAudioBufferCursor* >(cursor);
+
+	const int32_t position = ssbc->m_position;
+	if (position >= m_samplesCount)
+		return false;
+
+	int32_t samplesCount = m_samplesCount - position;
+	samplesCount = std::min< int32_t >(samplesCount, outBlock.samplesCount);
+	samplesCount = alignDown(samplesCount, 4);
+
+	if (samplesCount <= 0)
+		return false;
+
+	outBlock.samplesCount = samplesCount;
+	outBlock.sampleRate = m_sampleRate;
+	outBlock.maxChannel = 0;
+
+	ssbc->m_position += samplesCount;
+	return true;
+}
+
 }
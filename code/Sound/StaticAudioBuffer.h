@@ -42,6 +42,8 @@ public:
 
 	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final;
 
+	virtual bool skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final;
+
 private:
 	int32_t m_sampleRate = 0;
 	int32_t m_samplesCount = 0;
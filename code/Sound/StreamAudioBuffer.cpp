@@ -6,8 +6,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstring>
 #include "Core/Log/Log.h"
+#include "Core/Memory/Alloc.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/Thread/Acquire.h"
+#include "Core/Thread/JobManager.h"
+#include "Core/Thread/Semaphore.h"
 #include "Sound/IStreamDecoder.h"
 #include "Sound/StreamAudioBuffer.h"
 
@@ -16,9 +21,13 @@ namespace traktor::sound
 	namespace
 	{
 
+const uint32_t c_blockSamples = 2048;	//!< Samples decoded per block when decoding ahead.
+const uint32_t c_headBlocks = 2;		//!< Number of blocks kept decoded at start of stream.
+
 struct StreamAudioBufferCursor : public RefCountImpl< IAudioBufferCursor >
 {
 	uint64_t m_position = 0;
+	bool m_repeat = false;	//!< Cursor has been rewound to repeat stream.
 
 	virtual void setParameter(handle_t id, float parameter)
 	{
@@ -26,14 +35,36 @@ struct StreamAudioBufferCursor : public RefCountImpl< IAudioBufferCursor >
 
 	virtual void disableRepeat()
 	{
+		m_repeat = false;
 	}
 
 	virtual void reset()
 	{
 		m_position = 0;
+		m_repeat = true;
 	}
 };
 
+template < typename CountersType >
+struct CountersRegistry
+{
+	Semaphore lock;
+	SmallMap< const TypeInfo*, CountersType* > counters;
+
+	~CountersRegistry()
+	{
+		for (auto it : counters)
+			delete it.second;
+	}
+};
+
+template < typename CountersType >
+CountersRegistry< CountersType >& getCountersRegistry()
+{
+	static CountersRegistry< CountersType > s_registry;
+	return s_registry;
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.StreamAudioBuffer", StreamAudioBuffer, IAudioBuffer)
@@ -43,16 +74,94 @@ StreamAudioBuffer::~StreamAudioBuffer()
 	destroy();
 }
 
-bool StreamAudioBuffer::create(IStreamDecoder* streamDecoder)
+bool StreamAudioBuffer::create(IStreamDecoder* streamDecoder, uint32_t lookAhead)
 {
-	if ((m_streamDecoder = streamDecoder) != nullptr)
+	if ((m_streamDecoder = streamDecoder) == nullptr)
+		return false;
+
+	// Get shared counters for this type of decoder.
+	{
+		auto& registry = getCountersRegistry< Counters >();
+		T_ANONYMOUS_VAR(Acquire< Semaphore >)(registry.lock);
+		Counters*& counters = registry.counters[&type_of(streamDecoder)];
+		if (!counters)
+			counters = new Counters();
+		m_counters = counters;
+	}
+
+	m_timer.reset();
+
+	if (lookAhead == 0)
+		return true;
+
+	// Probe stream to determine number of channels.
+	AudioBlock block = { { 0 }, c_blockSamples, 0, 0 };
+	if (!m_streamDecoder->getBlock(block) || !block.maxChannel)
 		return true;
-	else
+
+	m_streamDecoder->rewind();
+	m_channels = std::min< uint32_t >(block.maxChannel, SbcMaxChannelCount);
+
+	// Allocate samples of all blocks in a single chunk.
+	m_head.resize(c_headBlocks);
+	m_ring.resize(lookAhead + 1);
+
+	const uint32_t blockCount = (uint32_t)(m_head.size() + m_ring.size());
+	m_samples = (float*)Alloc::acquireAlign(blockCount * m_channels * c_blockSamples * sizeof(float), 16, T_FILE_LINE);
+	if (!m_samples)
 		return false;
+
+	float* samples = m_samples;
+	for (auto& decodedBlock : m_head)
+	{
+		for (uint32_t i = 0; i < m_channels; ++i, samples += c_blockSamples)
+			decodedBlock.samples[i] = samples;
+	}
+	for (auto& decodedBlock : m_ring)
+	{
+		for (uint32_t i = 0; i < m_channels; ++i, samples += c_blockSamples)
+			decodedBlock.samples[i] = samples;
+	}
+
+	// Decode head of stream, kept so we can restart stream without waiting for decoder.
+	uint64_t position = 0;
+	for (uint32_t i = 0; i < c_headBlocks; ++i)
+	{
+		DecodedBlock& decodedBlock = m_head[i];
+		decodedBlock.position = position;
+		if (!decodeBlock(decodedBlock))
+		{
+			m_head.resize(i);
+			m_headEnd = true;
+			break;
+		}
+		position += decodedBlock.samplesCount;
+	}
+
+	m_headSamples = position;
+	m_decoderPosition = position;
+
+	kickDecode();
+	return true;
 }
 
 void StreamAudioBuffer::destroy()
 {
+	if (m_job)
+	{
+		m_job->wait();
+		m_job = nullptr;
+	}
+
+	if (m_samples)
+	{
+		Alloc::freeAlign(m_samples);
+		m_samples = nullptr;
+	}
+
+	m_head.clear();
+	m_ring.clear();
+
 	safeDestroy(m_streamDecoder);
 }
 
@@ -63,6 +172,9 @@ Ref< IAudioBufferCursor > StreamAudioBuffer::createCursor() const
 
 bool StreamAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
 {
+	if (m_samples)
+		return getBlockReadAhead(cursor, outBlock);
+
 	StreamAudioBufferCursor* ssbc = static_cast< StreamAudioBufferCursor* >(cursor);
 	const uint64_t position = ssbc->m_position;
 
@@ -77,7 +189,17 @@ bool StreamAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer*
 	while (m_position <= position)
 	{
 		outBlock.samplesCount = samplesCount;
-		if (!m_streamDecoder->getBlock(outBlock))
+
+		const double start = m_timer.getElapsedTime();
+		const bool result = m_streamDecoder->getBlock(outBlock);
+		const uint64_t decodeTime = (uint64_t)((m_timer.getElapsedTime() - start) * 1e6);
+
+		m_counters->decodedBlocks++;
+		m_counters->decodeTime += decodeTime;
+		if (decodeTime > m_counters->maxDecodeTime)
+			m_counters->maxDecodeTime = decodeTime;
+
+		if (!result)
 			return false;
 
 		m_position += outBlock.samplesCount;
@@ -87,4 +209,235 @@ bool StreamAudioBuffer::getBlock(IAudioBufferCursor* cursor, const IAudioMixer*
 	return true;
 }
 
+bool StreamAudioBuffer::skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const
+{
+	// Stream cannot be advanced without decoding; virtualized stream
+	// sounds are paused, thus not decoded, until audible again.
+	outBlock.samplesCount = 0;
+	outBlock.maxChannel = 0;
+	return true;
+}
+
+void StreamAudioBuffer::getStatistics(SmallMap< const TypeInfo*, Statistics >& outStatistics)
+{
+	auto& registry = getCountersRegistry< Counters >();
+	T_ANONYMOUS_VAR(Acquire< Semaphore >)(registry.lock);
+
+	outStatistics.clear();
+	for (auto it : registry.counters)
+	{
+		Statistics& statistics = outStatistics[it.first];
+		statistics.decodedBlocks = it.second->decodedBlocks;
+		statistics.underruns = it.second->underruns;
+		statistics.decodeTime = it.second->decodeTime / 1e6;
+		statistics.maxDecodeTime = it.second->maxDecodeTime / 1e6;
+	}
+}
+
+bool StreamAudioBuffer::getBlockReadAhead(IAudioBufferCursor* cursor, AudioBlock& outBlock) const
+{
+	T_ANONYMOUS_VAR(Acquire< SpinLock >)(m_consumerLock);
+
+	StreamAudioBufferCursor* ssbc = static_cast< StreamAudioBufferCursor* >(cursor);
+	const uint64_t position = ssbc->m_position;
+
+	m_repeat.store(ssbc->m_repeat, std::memory_order_relaxed);
+
+	// Serve from head of stream.
+	if (position < m_headSamples)
+	{
+		for (const auto& decodedBlock : m_head)
+		{
+			if (position < decodedBlock.position + decodedBlock.samplesCount)
+			{
+				serve(decodedBlock, position, outBlock);
+				ssbc->m_position += outBlock.samplesCount;
+				break;
+			}
+		}
+		kickDecode();
+		return true;
+	}
+	else if (m_headEnd)
+		return false;
+
+	// Serve from ring, blocks are released once cursor has passed them.
+	const uint32_t epoch = m_epoch.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		const uint32_t read = m_read.load(std::memory_order_relaxed);
+		if (read == m_write.load(std::memory_order_acquire))
+			break;
+
+		const DecodedBlock& decodedBlock = m_ring[read % m_ring.size()];
+		if (decodedBlock.epoch != epoch)
+		{
+			m_read.store(read + 1, std::memory_order_release);
+			continue;
+		}
+
+		if (decodedBlock.end)
+		{
+			// Keep end marker until cursor has been rewound, next loop
+			// has already been decoded after the marker.
+			if (position >= decodedBlock.position)
+			{
+				kickDecode();
+				return false;
+			}
+			m_read.store(read + 1, std::memory_order_release);
+			continue;
+		}
+
+		if (position < decodedBlock.position)
+		{
+			// Cursor is behind decoder; need to restart decoder, discard all blocks in ring.
+			T_DEBUG(L"Rewind stream sound decoder");
+			m_epoch.store(epoch + 1, std::memory_order_release);
+			m_read.store(m_write.load(std::memory_order_acquire), std::memory_order_release);
+			break;
+		}
+
+		if (position >= decodedBlock.position + decodedBlock.samplesCount)
+		{
+			m_read.store(read + 1, std::memory_order_release);
+			continue;
+		}
+
+		serve(decodedBlock, position, outBlock);
+		ssbc->m_position += outBlock.samplesCount;
+		kickDecode();
+		return true;
+	}
+
+	// Decoder hasn't caught up; return an empty block which doesn't end stream.
+	m_counters->underruns++;
+	outBlock.samplesCount = 0;
+	kickDecode();
+	return true;
+}
+
+bool StreamAudioBuffer::decodeBlock(DecodedBlock& decodedBlock) const
+{
+	AudioBlock block = { { 0 }, c_blockSamples, 0, 0 };
+
+	const double start = m_timer.getElapsedTime();
+	const bool result = m_streamDecoder->getBlock(block);
+	const uint64_t decodeTime = (uint64_t)((m_timer.getElapsedTime() - start) * 1e6);
+
+	m_counters->decodedBlocks++;
+	m_counters->decodeTime += decodeTime;
+	if (decodeTime > m_counters->maxDecodeTime)
+		m_counters->maxDecodeTime = decodeTime;
+
+	if (!result || !block.samplesCount)
+		return false;
+
+	T_ASSERT(block.samplesCount <= c_blockSamples);
+
+	decodedBlock.samplesCount = std::min(block.samplesCount, c_blockSamples);
+	decodedBlock.sampleRate = block.sampleRate;
+	decodedBlock.maxChannel = std::min(block.maxChannel, m_channels);
+	decodedBlock.end = false;
+
+	for (uint32_t i = 0; i < m_channels; ++i)
+	{
+		if (i < decodedBlock.maxChannel && block.samples[i])
+			std::memcpy(decodedBlock.samples[i], block.samples[i], decodedBlock.samplesCount * sizeof(float));
+		else
+			std::memset(decodedBlock.samples[i], 0, decodedBlock.samplesCount * sizeof(float));
+	}
+
+	return true;
+}
+
+bool StreamAudioBuffer::restartDecoder() const
+{
+	m_streamDecoder->rewind();
+
+	// Skip head of stream since it's already decoded, decoder produce
+	// same sequence of blocks thus positions are kept in sync.
+	AudioBlock block = { { 0 }, c_blockSamples, 0, 0 };
+	uint64_t position = 0;
+	while (position < m_headSamples)
+	{
+		block.samplesCount = c_blockSamples;
+		if (!m_streamDecoder->getBlock(block) || !block.samplesCount)
+			return false;
+		position += block.samplesCount;
+	}
+
+	m_decoderPosition = position;
+	m_decoderEnd = false;
+	return true;
+}
+
+void StreamAudioBuffer::decodeAhead() const
+{
+	for (;;)
+	{
+		const uint32_t write = m_write.load(std::memory_order_relaxed);
+		if (write - m_read.load(std::memory_order_acquire) >= m_ring.size())
+			break;
+
+		// Restart decoder if cursor has been rewound, or speculatively
+		// if end of stream has been reached and sound is looping so loops
+		// can continue seamlessly. Non-looping sounds stop at end marker.
+		const uint32_t epoch = m_epoch.load(std::memory_order_acquire);
+		if (epoch != m_decoderEpoch || (m_decoderEnd && m_repeat.load(std::memory_order_relaxed)))
+		{
+			m_decoderEpoch = epoch;
+			if (!restartDecoder())
+				m_decoderEnd = true;
+		}
+		else if (m_decoderEnd)
+			break;
+
+		DecodedBlock& decodedBlock = m_ring[write % m_ring.size()];
+		decodedBlock.position = m_decoderPosition;
+		decodedBlock.epoch = epoch;
+
+		if (m_decoderEnd || !decodeBlock(decodedBlock))
+		{
+			decodedBlock.samplesCount = 0;
+			decodedBlock.end = true;
+			m_decoderEnd = true;
+		}
+		else
+			m_decoderPosition += decodedBlock.samplesCount;
+
+		m_write.store(write + 1, std::memory_order_release);
+	}
+
+	m_decoding.store(false, std::memory_order_release);
+}
+
+void StreamAudioBuffer::kickDecode() const
+{
+	if (m_headEnd || m_decoding.exchange(true, std::memory_order_acq_rel))
+		return;
+
+	m_job = JobManager::getInstance().add([this]() {
+		decodeAhead();
+	});
+}
+
+void StreamAudioBuffer::serve(const DecodedBlock& decodedBlock, uint64_t position, AudioBlock& outBlock) const
+{
+	const uint32_t offset = (uint32_t)(position - decodedBlock.position);
+	const uint32_t available = decodedBlock.samplesCount - offset;
+
+	// Keep offsets aligned if block is served in multiple pieces.
+	uint32_t samplesCount = std::min(outBlock.samplesCount, available);
+	if (samplesCount < available)
+		samplesCount &= ~3U;
+
+	for (uint32_t i = 0; i < decodedBlock.maxChannel; ++i)
+		outBlock.samples[i] = decodedBlock.samples[i] + offset;
+
+	outBlock.samplesCount = samplesCount;
+	outBlock.sampleRate = decodedBlock.sampleRate;
+	outBlock.maxChannel = decodedBlock.maxChannel;
+}
+
 }
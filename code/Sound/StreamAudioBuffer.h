@@ -8,6 +8,11 @@
  */
 #pragma once
 
+#include <atomic>
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/SmallMap.h"
+#include "Core/Thread/SpinLock.h"
+#include "Core/Timer/Timer.h"
 #include "Sound/IAudioBuffer.h"
 
 // import/export mechanism.
@@ -18,6 +23,13 @@
 #	define T_DLLCLASS T_DLLIMPORT
 #endif
 
+namespace traktor
+{
+
+class Job;
+
+}
+
 namespace traktor::sound
 {
 
@@ -25,15 +37,37 @@ class IStreamDecoder;
 
 /*! Stream audio buffer.
  * \ingroup Sound
+ *
+ * Stream is either decoded synchronously from the mixer
+ * thread or, if a look ahead is specified, decoded ahead
+ * on a background job into a ring of decoded blocks.
+ * The first blocks of the stream are kept decoded
+ * so loops and rewinds can start without waiting
+ * for the decoder. Decoder is only restarted ahead
+ * at end of stream once the sound has looped.
  */
 class T_DLLCLASS StreamAudioBuffer : public IAudioBuffer
 {
 	T_RTTI_CLASS;
 
 public:
+	struct Statistics
+	{
+		uint32_t decodedBlocks = 0;
+		uint32_t underruns = 0;		//!< Number of blocks requested by mixer before being decoded.
+		double decodeTime = 0.0;	//!< Accumulated decode time in seconds.
+		double maxDecodeTime = 0.0;	//!< Longest decode time of a single block in seconds.
+	};
+
 	virtual ~StreamAudioBuffer();
 
-	bool create(IStreamDecoder* streamDecoder);
+	/*! Create stream buffer.
+	 *
+	 * \param streamDecoder Stream decoder, owned by buffer.
+	 * \param lookAhead Number of blocks to decode ahead, 0 to decode synchronously.
+	 * \return True if buffer created.
+	 */
+	bool create(IStreamDecoder* streamDecoder, uint32_t lookAhead = 0);
 
 	void destroy();
 
@@ -41,9 +75,67 @@ public:
 
 	virtual bool getBlock(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final;
 
+	virtual bool skip(IAudioBufferCursor* cursor, const IAudioMixer* mixer, AudioBlock& outBlock) const override final;
+
+	/*! Get statistics of all stream buffers, grouped by decoder type. */
+	static void getStatistics(SmallMap< const TypeInfo*, Statistics >& outStatistics);
+
 private:
+	struct Counters
+	{
+		std::atomic< uint32_t > decodedBlocks = 0;
+		std::atomic< uint32_t > underruns = 0;
+		std::atomic< uint64_t > decodeTime = 0;		//!< Accumulated decode time in microseconds.
+		std::atomic< uint64_t > maxDecodeTime = 0;	//!< Longest decode time in microseconds.
+	};
+
+	struct DecodedBlock
+	{
+		float* samples[SbcMaxChannelCount] = { nullptr };
+		uint64_t position = 0;		//!< Stream position of first sample in block.
+		uint32_t samplesCount = 0;
+		uint32_t sampleRate = 0;
+		uint32_t maxChannel = 0;
+		uint32_t epoch = 0;			//!< Decoder epoch when block was decoded, increased on each rewind.
+		bool end = false;			//!< End of stream marker.
+	};
+
 	Ref< IStreamDecoder > m_streamDecoder;
+	Counters* m_counters = nullptr;
+	Timer m_timer;
 	mutable uint64_t m_position = 0;
+
+	// Read ahead, blocks are produced by decode job and consumed by mixer.
+	float* m_samples = nullptr;
+	uint32_t m_channels = 0;
+	AlignedVector< DecodedBlock > m_head;
+	uint64_t m_headSamples = 0;
+	bool m_headEnd = false;
+	mutable AlignedVector< DecodedBlock > m_ring;
+	mutable std::atomic< uint32_t > m_read = 0;
+	mutable std::atomic< uint32_t > m_write = 0;
+	mutable std::atomic< uint32_t > m_epoch = 0;
+	mutable std::atomic< bool > m_decoding = false;
+	mutable std::atomic< bool > m_repeat = false;		//!< Restart decoder at end of stream, set once sound has looped.
+	mutable Ref< Job > m_job;
+	mutable SpinLock m_consumerLock;
+
+	// Decoder state, only accessed by decode job.
+	mutable uint32_t m_decoderEpoch = 0;
+	mutable uint64_t m_decoderPosition = 0;
+	mutable bool m_decoderEnd = false;
+
+	bool getBlockReadAhead(IAudioBufferCursor* cursor, AudioBlock& outBlock) const;
+
+	bool decodeBlock(DecodedBlock& block) const;
+
+	bool restartDecoder() const;
+
+	void decodeAhead() const;
+
+	void kickDecode() const;
+
+	void serve(const DecodedBlock& block, uint64_t position, AudioBlock& outBlock) const;
 };
 
 }
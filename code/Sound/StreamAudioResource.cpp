@@ -21,7 +21,7 @@
 namespace traktor::sound
 {
 
-T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.StreamAudioResource", 8, StreamAudioResource, IAudioResource)
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.StreamAudioResource", 9, StreamAudioResource, IAudioResource)
 
 Ref< Sound > StreamAudioResource::createSound(resource::IResourceManager* resourceManager, const db::Instance* resourceInstance) const
 {
@@ -59,7 +59,7 @@ Ref< Sound > StreamAudioResource::createSound(resource::IResourceManager* resour
 	}
 
 	Ref< StreamAudioBuffer > soundBuffer = new StreamAudioBuffer();
-	if (!soundBuffer->create(streamDecoder))
+	if (!soundBuffer->create(streamDecoder, m_lookAhead))
 	{
 		log::error << L"Unable to create sound, unable to create stream sound buffer." << Endl;
 		return nullptr;
@@ -81,6 +81,9 @@ void StreamAudioResource::serialize(ISerializer& s)
 	s >> Member< float >(L"gain", m_gain);
 	s >> Member< float >(L"range", m_range);
 	s >> Member< bool >(L"preload", m_preload);
+
+	if (s.getVersion() >= 9)
+		s >> Member< uint32_t >(L"lookAhead", m_lookAhead);
 }
 
 }
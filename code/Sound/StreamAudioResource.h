@@ -41,6 +41,7 @@ private:
 	float m_gain = 0.0f;
 	float m_range = 0.0f;
 	bool m_preload = false;
+	uint32_t m_lookAhead = 0;
 };
 
 }
@@ -0,0 +1,149 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <cmath>
+#include "Core/RefArray.h"
+#include "Core/Log/Log.h"
+#include "Core/Math/Const.h"
+#include "Core/Timer/Timer.h"
+#include "Sound/AudioMixer.h"
+#include "Sound/Processor/Edge.h"
+#include "Sound/Processor/Graph.h"
+#include "Sound/Processor/GraphBuffer.h"
+#include "Sound/Processor/GraphProgram.h"
+#include "Sound/Processor/Nodes/Add.h"
+#include "Sound/Processor/Nodes/Multiply.h"
+#include "Sound/Processor/Nodes/Output.h"
+#include "Sound/Processor/Nodes/Scalar.h"
+#include "Sound/Processor/Nodes/Sine.h"
+#include "Sound/Test/CaseGraph.h"
+
+namespace traktor
+{
+	namespace sound
+	{
+		namespace test
+		{
+			namespace
+			{
+
+const int32_t c_instanceCount = 256;
+const int32_t c_blockCount = 32;
+
+Ref< Scalar > createScalar(Graph* graph, float value)
+{
+	Ref< Scalar > scalar = new Scalar();
+	scalar->setValue(value);
+	graph->addNode(scalar);
+	return scalar;
+}
+
+			}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseGraph", 0, CaseGraph, traktor::test::Case)
+
+void CaseGraph::run()
+{
+	// Frequency -> Sine -> (Sine + Sine) -> Output, amplitude is a foldable constant expression.
+	Ref< Graph > graph = new Graph();
+
+	Ref< Scalar > frequency = createScalar(graph, 11.025f);
+	Ref< Scalar > amplitude1 = createScalar(graph, 0.125f);
+	Ref< Scalar > amplitude2 = createScalar(graph, 2.0f);
+
+	Ref< Multiply > amplitude = new Multiply();
+	graph->addNode(amplitude);
+	graph->addEdge(new Edge(amplitude1->getOutputPin(0), amplitude->getInputPin(0)));
+	graph->addEdge(new Edge(amplitude2->getOutputPin(0), amplitude->getInputPin(1)));
+
+	Ref< Sine > sine = new Sine();
+	graph->addNode(sine);
+	graph->addEdge(new Edge(frequency->getOutputPin(0), sine->getInputPin(0)));
+	graph->addEdge(new Edge(amplitude->getOutputPin(0), sine->getInputPin(1)));
+
+	Ref< Add > add = new Add();
+	graph->addNode(add);
+	graph->addEdge(new Edge(sine->getOutputPin(0), add->getInputPin(0)));
+	graph->addEdge(new Edge(sine->getOutputPin(0), add->getInputPin(1)));
+
+	Ref< Output > output = new Output();
+	graph->addNode(output);
+	graph->addEdge(new Edge(add->getOutputPin(0), output->getInputPin(0)));
+
+	// Compile program, nodes should be sorted and constant expression folded.
+	Ref< const GraphProgram > program = GraphProgram::compile(graph);
+	CASE_ASSERT(program != nullptr);
+	if (!program)
+		return;
+
+	CASE_ASSERT_EQUAL(program->getNodes().size(), graph->getNodes().size());
+	CASE_ASSERT(program->getOutputNode() == (int32_t)program->getNodes().size() - 1);
+
+	const GraphProgram::Input* amplitudeInput = program->findInput(sine->getInputPin(1));
+	CASE_ASSERT(amplitudeInput != nullptr);
+	if (amplitudeInput)
+	{
+		CASE_ASSERT(amplitudeInput->constant);
+		CASE_ASSERT_EQUAL(amplitudeInput->value, 0.25f);
+	}
+
+	// Only signal outputs consumed by output node are scheduled, sine before add.
+	const auto& schedule = program->getSchedule();
+	CASE_ASSERT_EQUAL(schedule.size(), 2);
+	if (schedule.size() == 2)
+	{
+		CASE_ASSERT(program->getNodes()[program->getOutputs()[schedule[0]].node] == sine);
+		CASE_ASSERT(program->getNodes()[program->getOutputs()[schedule[1]].node] == add);
+	}
+
+	// Evaluate a set of concurrent instances of same program.
+	Ref< GraphBuffer > graphBuffer = new GraphBuffer(program);
+	Ref< AudioMixer > mixer = new AudioMixer();
+
+	RefArray< IAudioBufferCursor > cursors;
+	for (int32_t i = 0; i < c_instanceCount; ++i)
+	{
+		Ref< IAudioBufferCursor > cursor = graphBuffer->createCursor();
+		if (cursor)
+			cursors.push_back(cursor);
+	}
+	CASE_ASSERT_EQUAL(cursors.size(), c_instanceCount);
+
+	Timer timer;
+	double duration = 0.0;
+	bool valid = true;
+
+	for (int32_t i = 0; i < c_blockCount; ++i)
+	{
+		const double start = timer.getElapsedTime();
+		for (auto cursor : cursors)
+		{
+			AudioBlock block = { { 0 }, 1024, 0, 0 };
+			if (!graphBuffer->getBlock(cursor, mixer, block) || !block.samples[0])
+			{
+				valid = false;
+				continue;
+			}
+
+			// Both consumers of sine should receive same signal; thus output is twice the sine.
+			const float t = (i * 1024 + 10) / 44100.0f;
+			const float expected = 2.0f * 0.25f * std::sin(TWO_PI * 11.025f * t);
+			if (std::abs(block.samples[0][10] - expected) > 1e-2f)
+				valid = false;
+		}
+		duration += timer.getElapsedTime() - start;
+	}
+
+	CASE_ASSERT(valid);
+
+	log::info << L"Sound graph; " << c_instanceCount << L" instances, " << (duration * 1000.0) / c_blockCount << L" ms per block" << Endl;
+}
+
+		}
+	}
+}
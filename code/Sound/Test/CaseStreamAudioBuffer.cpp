@@ -0,0 +1,157 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Core/Thread/Thread.h"
+#include "Core/Thread/ThreadManager.h"
+#include "Sound/IStreamDecoder.h"
+#include "Sound/StreamAudioBuffer.h"
+#include "Sound/Test/CaseStreamAudioBuffer.h"
+
+namespace traktor
+{
+	namespace sound
+	{
+		namespace test
+		{
+			namespace
+			{
+
+const uint32_t c_streamSamples = 10000;
+
+/*! Decoder producing a ramp where each sample is it's position in stream. */
+class RampStreamDecoder : public IStreamDecoder
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual bool create(IStream* stream) override final { return true; }
+
+	virtual void destroy() override final {}
+
+	virtual double getDuration() const override final { return c_streamSamples / 44100.0; }
+
+	virtual bool getBlock(AudioBlock& outBlock) override final
+	{
+		if (m_position >= c_streamSamples)
+			return false;
+
+		const uint32_t samplesCount = std::min(outBlock.samplesCount, c_streamSamples - m_position);
+		for (uint32_t i = 0; i < samplesCount; ++i)
+			m_samples[i] = float(m_position + i);
+
+		outBlock.samples[0] = m_samples;
+		outBlock.samplesCount = samplesCount;
+		outBlock.sampleRate = 44100;
+		outBlock.maxChannel = 1;
+
+		m_position += samplesCount;
+		return true;
+	}
+
+	virtual void rewind() override final { m_position = 0; }
+
+private:
+	float m_samples[4096];
+	uint32_t m_position = 0;
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.sound.test.RampStreamDecoder", RampStreamDecoder, IStreamDecoder)
+
+/*! Read entire stream from cursor, return number of samples read or -1 if stream isn't continuous. */
+int32_t readStream(const StreamAudioBuffer* buffer, IAudioBufferCursor* cursor)
+{
+	Thread* currentThread = ThreadManager::getInstance().getCurrentThread();
+	uint32_t position = 0;
+	for (;;)
+	{
+		AudioBlock block = { { 0 }, 1000, 0, 0 };
+		if (!buffer->getBlock(cursor, nullptr, block))
+			break;
+
+		// Empty block if decoder hasn't caught up.
+		if (!block.samplesCount)
+		{
+			currentThread->sleep(1);
+			continue;
+		}
+
+		for (uint32_t i = 0; i < block.samplesCount; ++i)
+		{
+			if (block.samples[0][i] != float(position + i))
+				return -1;
+		}
+		position += block.samplesCount;
+	}
+	return (int32_t)position;
+}
+
+			}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.sound.test.CaseStreamAudioBuffer", 0, CaseStreamAudioBuffer, traktor::test::Case)
+
+void CaseStreamAudioBuffer::run()
+{
+	// Synchronous decoding.
+	{
+		Ref< StreamAudioBuffer > buffer = new StreamAudioBuffer();
+		CASE_ASSERT(buffer->create(new RampStreamDecoder()));
+
+		Ref< IAudioBufferCursor > cursor = buffer->createCursor();
+
+		// Skipping, as when virtualized, neither decode nor advance stream.
+		AudioBlock block = { { 0 }, 1000, 0, 0 };
+		CASE_ASSERT(buffer->skip(cursor, nullptr, block));
+		CASE_ASSERT_EQUAL(block.samplesCount, 0);
+
+		CASE_ASSERT_EQUAL(readStream(buffer, cursor), c_streamSamples);
+
+		buffer->destroy();
+	}
+
+	// Decode ahead, read stream once; decoder must not restart at end since sound isn't looping.
+	{
+		SmallMap< const TypeInfo*, StreamAudioBuffer::Statistics > statistics;
+		StreamAudioBuffer::getStatistics(statistics);
+		const uint32_t decodedBefore = statistics[&type_of< RampStreamDecoder >()].decodedBlocks;
+
+		Ref< StreamAudioBuffer > buffer = new StreamAudioBuffer();
+		CASE_ASSERT(buffer->create(new RampStreamDecoder(), 16));
+
+		Ref< IAudioBufferCursor > cursor = buffer->createCursor();
+		CASE_ASSERT_EQUAL(readStream(buffer, cursor), c_streamSamples);
+
+		buffer->destroy();
+
+		// Stream is five blocks, and one more attempt to decode end of stream.
+		StreamAudioBuffer::getStatistics(statistics);
+		CASE_ASSERT(statistics[&type_of< RampStreamDecoder >()].decodedBlocks - decodedBefore <= 6);
+	}
+
+	// Decode ahead, read stream multiple times as if looping.
+	{
+		Ref< StreamAudioBuffer > buffer = new StreamAudioBuffer();
+		CASE_ASSERT(buffer->create(new RampStreamDecoder(), 4));
+
+		Ref< IAudioBufferCursor > cursor = buffer->createCursor();
+		for (int32_t i = 0; i < 3; ++i)
+		{
+			CASE_ASSERT_EQUAL(readStream(buffer, cursor), c_streamSamples);
+			cursor->reset();
+		}
+
+		buffer->destroy();
+	}
+
+	SmallMap< const TypeInfo*, StreamAudioBuffer::Statistics > statistics;
+	StreamAudioBuffer::getStatistics(statistics);
+	CASE_ASSERT(statistics[&type_of< RampStreamDecoder >()].decodedBlocks > 0);
+}
+
+		}
+	}
+}
@@ -98,6 +98,7 @@ void ButtonInstance::eventMouseDown(int x, int y, int button)
 	{
 		m_eventPress.issue();
 		m_state = Button::SmDown;
+		invalidate();
 		m_pushed = true;
 	}
 }
@@ -108,12 +109,14 @@ void ButtonInstance::eventMouseUp(int x, int y, int button)
 	{
 		m_eventRelease.issue();
 		m_state = Button::SmOver;
+		invalidate();
 		m_pushed = false;
 	}
 	else if (!m_inside && m_pushed)
 	{
 		m_eventReleaseOutside.issue();
 		m_state = Button::SmUp;
+		invalidate();
 		m_pushed = false;
 	}
 }
@@ -149,6 +152,7 @@ void ButtonInstance::eventMouseMove(int x, int y, int button)
 				m_state = Button::SmOver;
 		}
 		m_inside = inside;
+		invalidate();
 	}
 }
 
@@ -6,6 +6,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstring>
 #include "Spark/CharacterInstance.h"
 #include "Spark/Context.h"
 #include "Spark/Types.h"
@@ -27,6 +28,8 @@ CharacterInstance::CharacterInstance(
 ,	m_dictionary(dictionary)
 ,	m_parent(parent)
 ,	m_filterColor(0.0f, 0.0f, 0.0f, 0.0f)
+,	m_dirtyTag(0)
+,	m_subtreeDirtyTag(0)
 ,	m_filter(0)
 ,	m_blendMode(0)
 ,	m_visible(true)
@@ -73,7 +76,11 @@ void CharacterInstance::destroy()
 
 void CharacterInstance::setParent(CharacterInstance* parent)
 {
-	m_parent = parent;
+	if (m_parent != parent)
+	{
+		m_parent = parent;
+		invalidate();
+	}
 }
 
 void CharacterInstance::setName(const std::string& name)
@@ -109,7 +116,11 @@ std::string CharacterInstance::getTarget() const
 void CharacterInstance::setColorTransform(const ColorTransform& cxform)
 {
 	clearCacheObject();
-	m_cxform = cxform;
+	if (cxform.mul != m_cxform.mul || cxform.add != m_cxform.add)
+	{
+		m_cxform = cxform;
+		invalidate();
+	}
 }
 
 ColorTransform CharacterInstance::getFullColorTransform() const
@@ -123,7 +134,11 @@ ColorTransform CharacterInstance::getFullColorTransform() const
 void CharacterInstance::setAlpha(float alpha)
 {
 	clearCacheObject();
-	m_cxform.mul.setAlpha(Scalar(alpha));
+	if (float(m_cxform.mul.getAlpha()) != alpha)
+	{
+		m_cxform.mul.setAlpha(Scalar(alpha));
+		invalidate();
+	}
 }
 
 float CharacterInstance::getAlpha() const
@@ -133,7 +148,11 @@ float CharacterInstance::getAlpha() const
 
 void CharacterInstance::setTransform(const Matrix33& transform)
 {
-	m_transform = transform;
+	if (std::memcmp(m_transform.m, transform.m, sizeof(m_transform.m)) != 0)
+	{
+		m_transform = transform;
+		invalidate();
+	}
 }
 
 Matrix33 CharacterInstance::getFullTransform() const
@@ -152,22 +171,38 @@ Vector2 CharacterInstance::transformInto(const CharacterInstance* other, const V
 
 void CharacterInstance::setFilter(uint8_t filter)
 {
-	m_filter = filter;
+	if (m_filter != filter)
+	{
+		m_filter = filter;
+		invalidate();
+	}
 }
 
 void CharacterInstance::setFilterColor(const Color4f& filterColor)
 {
-	m_filterColor = filterColor;
+	if (filterColor != m_filterColor)
+	{
+		m_filterColor = filterColor;
+		invalidate();
+	}
 }
 
 void CharacterInstance::setBlendMode(uint8_t blendMode)
 {
-	m_blendMode = blendMode;
+	if (m_blendMode != blendMode)
+	{
+		m_blendMode = blendMode;
+		invalidate();
+	}
 }
 
 void CharacterInstance::setVisible(bool visible)
 {
-	m_visible = visible;
+	if (m_visible != visible)
+	{
+		m_visible = visible;
+		invalidate();
+	}
 }
 
 void CharacterInstance::setEnabled(bool enabled)
@@ -190,6 +225,13 @@ void CharacterInstance::setWireOutline(bool wireOutline)
 	m_wireOutline = wireOutline;
 }
 
+void CharacterInstance::invalidate()
+{
+	++m_dirtyTag;
+	for (CharacterInstance* parent = m_parent; parent != nullptr; parent = parent->m_parent)
+		++parent->m_subtreeDirtyTag;
+}
+
 void CharacterInstance::eventFrame()
 {
 }
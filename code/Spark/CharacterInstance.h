@@ -219,6 +219,20 @@ public:
 	 */
 	bool getWireOutline() const { return m_wireOutline; }
 
+	/*! Mark instance as changed.
+	 *
+	 * Increments dirty tag of this instance and subtree
+	 * dirty tag of all parents so renderers can detect
+	 * which parts of the hierarchy need to be redrawn.
+	 */
+	void invalidate();
+
+	/*! Get dirty tag; changes each time visual state of this instance is modified. */
+	int32_t getDirtyTag() const { return m_dirtyTag; }
+
+	/*! Get subtree dirty tag; changes each time any descendant is modified. */
+	int32_t getSubtreeDirtyTag() const { return m_subtreeDirtyTag; }
+
 	/*! \name Events */
 	//@{
 
@@ -274,6 +288,8 @@ private:
 	Ref< IRefCount > m_cacheObject;
 	Ref< IRefCount > m_userObject;
 	Color4f m_filterColor;
+	int32_t m_dirtyTag;
+	int32_t m_subtreeDirtyTag;
 	uint8_t m_filter;
 	uint8_t m_blendMode;
 	bool m_visible;
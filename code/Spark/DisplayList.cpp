@@ -26,8 +26,9 @@ const int32_t c_depthOffset = -16384;
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.spark.DisplayList", DisplayList, Object)
 
-DisplayList::DisplayList(Context* context)
+DisplayList::DisplayList(Context* context, CharacterInstance* owner)
 :	m_context(context)
+,	m_owner(owner)
 {
 	reset();
 }
@@ -36,6 +37,7 @@ void DisplayList::reset()
 {
 	m_backgroundColor = Color4f(1.0f, 1.0f, 1.0f, 1.0f);
 	m_layers.clear();
+	invalidate();
 }
 
 void DisplayList::updateBegin(bool reset)
@@ -60,6 +62,7 @@ void DisplayList::updateEnd()
 				i->second.instance->clearCacheObject();
 			}
 			i = m_layers.erase(i);
+			invalidate();
 		}
 		else
 			i++;
@@ -70,7 +73,10 @@ void DisplayList::updateFrame(CharacterInstance* ownerInstance, const Frame* fra
 {
 	// Update background color.
 	if (frame->hasBackgroundColorChanged())
+	{
 		m_backgroundColor = frame->getBackgroundColor();
+		invalidate();
+	}
 
 	// Remove instances from active list.
 	const SmallMap< uint16_t, Frame::RemoveObject >& removeObjects = frame->getRemoveObjects();
@@ -91,6 +97,7 @@ void DisplayList::updateFrame(CharacterInstance* ownerInstance, const Frame* fra
 						j->second.instance->clearCacheObject();
 					}
 					m_layers.erase(j);
+					invalidate();
 				}
 			}
 			else
@@ -101,6 +108,7 @@ void DisplayList::updateFrame(CharacterInstance* ownerInstance, const Frame* fra
 					j->second.instance->clearCacheObject();
 				}
 				m_layers.erase(j);
+				invalidate();
 			}
 		}
 #if defined(_DEBUG)
@@ -153,6 +161,7 @@ void DisplayList::updateFrame(CharacterInstance* ownerInstance, const Frame* fra
 				else
 					log::warning << L"Unable to find character " << placeObject.characterId << L" in dictionary (2)" << Endl;
 #endif
+				invalidate();
 			}
 
 			if (!layer.instance)
@@ -181,6 +190,8 @@ void DisplayList::updateFrame(CharacterInstance* ownerInstance, const Frame* fra
 
 			if (placeObject.has(Frame::PfHasClipDepth))
 			{
+				if (!layer.clipEnable || layer.clipDepth != placeObject.clipDepth + c_depthOffset)
+					invalidate();
 				layer.clipEnable = true;
 				layer.clipDepth = placeObject.clipDepth + c_depthOffset;
 			}
@@ -203,6 +214,7 @@ void DisplayList::updateFrame(CharacterInstance* ownerInstance, const Frame* fra
 					j->second.instance->clearCacheObject();
 				}
 				m_layers.erase(j);
+				invalidate();
 			}
 		}
 	}
@@ -223,6 +235,8 @@ void DisplayList::showObject(int32_t depth, CharacterInstance* characterInstance
 	layer.id = 0;
 	layer.instance = characterInstance;
 	layer.immutable = immutable;
+
+	invalidate();
 }
 
 bool DisplayList::removeObject(CharacterInstance* characterInstance)
@@ -239,6 +253,7 @@ bool DisplayList::removeObject(CharacterInstance* characterInstance)
 	characterInstance->clearCacheObject();
 
 	m_layers.erase(it);
+	invalidate();
 	return true;
 }
 
@@ -255,6 +270,7 @@ bool DisplayList::removeObject(int32_t depth)
 	}
 
 	m_layers.erase(it);
+	invalidate();
 	return true;
 }
 
@@ -309,6 +325,10 @@ void DisplayList::swap(int32_t depth1, int32_t depth2)
 		m_layers.erase(it2);
 		m_layers[depth1] = layer;
 	}
+	else
+		return;
+
+	invalidate();
 }
 
 void DisplayList::getObjects(RefArray< CharacterInstance >& outCharacterInstances) const
@@ -321,4 +341,10 @@ void DisplayList::getObjects(RefArray< CharacterInstance >& outCharacterInstance
 	}
 }
 
+void DisplayList::invalidate()
+{
+	if (m_owner)
+		m_owner->invalidate();
+}
+
 }
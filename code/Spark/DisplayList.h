@@ -48,7 +48,12 @@ public:
 
 	typedef SmallMap< int32_t, Layer > layer_map_t;
 
-	explicit DisplayList(Context* context);
+	/*! Construct display list.
+	 *
+	 * \param context Movie context.
+	 * \param owner Instance owning this display list; invalidated each time layers are modified.
+	 */
+	explicit DisplayList(Context* context, CharacterInstance* owner);
 
 	/*! Reset display list. */
 	void reset();
@@ -225,9 +230,12 @@ public:
 
 private:
 	Context* m_context;
+	CharacterInstance* m_owner;
 	Color4f m_backgroundColor;
 	layer_map_t m_layers;
 	mutable RefArray< CharacterInstance > m_gather;
+
+	void invalidate();
 };
 
 }
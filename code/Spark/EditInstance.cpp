@@ -247,6 +247,7 @@ Vector2 EditInstance::measureText(const std::wstring& text, float width) const
 void EditInstance::setTextBounds(const Aabb2& textBounds)
 {
 	m_textBounds = textBounds;
+	invalidate();
 }
 
 void EditInstance::setTextColor(const Color4f& textColor)
@@ -318,6 +319,7 @@ void EditInstance::setPassword(bool password)
 void EditInstance::setScroll(int32_t scroll)
 {
 	m_scroll = scroll;
+	invalidate();
 }
 
 int32_t EditInstance::getMaxScroll() const
@@ -353,11 +355,13 @@ Ref< TextLayout > EditInstance::prepareTextLayout() const
 void EditInstance::setTextLayout(TextLayout* layout)
 {
 	m_layout = layout;
+	invalidate();
 }
 
 void EditInstance::setRenderClipMask(bool renderClipMask)
 {
 	m_renderClipMask = renderClipMask;
+	invalidate();
 }
 
 Aabb2 EditInstance::getBounds() const
@@ -604,6 +608,7 @@ bool EditInstance::internalParseText(const std::wstring& text)
 	m_htmlText.clear();
 	m_html = false;
 
+	invalidate();
 	return true;
 }
 
@@ -642,6 +647,7 @@ bool EditInstance::internalParseHtml(const std::wstring& html)
 	m_htmlText = html;
 	m_html = true;
 
+	invalidate();
 	return true;
 }
 
@@ -6,10 +6,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include "Core/Math/Const.h"
 #include "Core/Timer/Timer.h"
 #include "Spark/Button.h"
+#include "Spark/Canvas.h"
 #include "Spark/ButtonInstance.h"
 #include "Spark/Context.h"
 #include "Spark/Dictionary.h"
@@ -34,12 +37,92 @@ const ColorTransform c_cxWhite(Color4f(0.0f, 0.0f, 0.0f, 0.0f), Color4f(1.0f, 1.
 
 Timer s_timer;
 
+bool equal(const Matrix33& a, const Matrix33& b)
+{
+	return std::memcmp(a.m, b.m, sizeof(a.m)) == 0;
+}
+
+bool overlaps(const Aabb2& a, const Aabb2& b)
+{
+	return
+		a.mn.x <= b.mx.x && a.mx.x >= b.mn.x &&
+		a.mn.y <= b.mx.y && a.mx.y >= b.mn.y;
+}
+
+/*! Combined tag of all state affecting how instance is rendered.
+ *
+ * All tags are monotonically increasing so sum change
+ * whenever any of the individual tags change.
+ */
+int32_t stateTag(CharacterInstance* instance)
+{
+	int32_t tag = instance->getDirtyTag();
+	if (&type_of(instance) == &type_of< SpriteInstance >())
+	{
+		SpriteInstance* spriteInstance = static_cast< SpriteInstance* >(instance);
+		if (const Canvas* canvas = spriteInstance->getCanvas())
+			tag += canvas->getDirtyTag();
+		if (const SpriteInstance* maskInstance = spriteInstance->getMask())
+			tag += maskInstance->getDirtyTag() + maskInstance->getSubtreeDirtyTag();
+	}
+	return tag;
+}
+
+/*! Check if instance has state which isn't propagated to parents. */
+bool isVolatile(CharacterInstance* instance)
+{
+	const TypeInfo& characterType = type_of(instance);
+	if (&characterType == &type_of< SpriteInstance >())
+	{
+		SpriteInstance* spriteInstance = static_cast< SpriteInstance* >(instance);
+		return spriteInstance->getCanvas() != nullptr || spriteInstance->getMask() != nullptr;
+	}
+	else if (&characterType == &type_of< EditInstance >())
+	{
+		// Focused edit fields has a blinking caret.
+		const Context* context = instance->getContext();
+		return context != nullptr && context->getFocus() == instance;
+	}
+	return false;
+}
+
+/*! Calculate global bounds of a character which isn't tracked as a container. */
+Aabb2 leafBounds(CharacterInstance* instance, const Matrix33& parentTransform)
+{
+	Aabb2 bounds = parentTransform * instance->getBounds();
+
+	const TypeInfo& characterType = type_of(instance);
+	if (&characterType == &type_of< TextInstance >())
+	{
+		const Text* text = static_cast< TextInstance* >(instance)->getText();
+		bounds.contain(parentTransform * instance->getTransform() * text->getTextMatrix() * text->getTextBounds());
+	}
+	else if (&characterType == &type_of< ButtonInstance >())
+	{
+		ButtonInstance* buttonInstance = static_cast< ButtonInstance* >(instance);
+		const Matrix33 buttonTransform = parentTransform * buttonInstance->getTransform();
+		for (const auto& layer : buttonInstance->getButton()->getButtonLayers())
+		{
+			const CharacterInstance* referenceInstance = buttonInstance->getCharacterInstance(layer.characterId);
+			if (referenceInstance)
+				bounds.contain(buttonTransform * layer.placeMatrix * referenceInstance->getBounds());
+		}
+	}
+
+	return bounds;
+}
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.spark.MovieRenderer", MovieRenderer, Object)
 
 MovieRenderer::MovieRenderer(IDisplayRenderer* displayRenderer)
 :	m_displayRenderer(displayRenderer)
+,	m_current(0)
+,	m_frameTransform(Vector4::zero())
+,	m_viewSize(0.0f, 0.0f)
+,	m_backgroundColor(0.0f, 0.0f, 0.0f, 0.0f)
+,	m_invalid(true)
 {
 }
 
@@ -52,7 +135,66 @@ void MovieRenderer::render(
 )
 {
 	const Color4f& backgroundColor = movieInstance->getDisplayList().getBackgroundColor();
-	const Aabb2 dirtyRegion = frameBounds;
+
+	// Update retained hierarchy, accumulate region which has changed since last frame.
+	const AlignedVector< RetainedNode >& previous = m_retained[m_current];
+	m_current = 1 - m_current;
+	m_retained[m_current].resize(0);
+
+	const RetainedNode* previousRoot = (!previous.empty() && previous.front().instance == movieInstance) ? &previous.front() : nullptr;
+	if (!previousRoot)
+		m_invalid = true;
+
+	m_dirtyRegion = Aabb2();
+	updateRetained(
+		movieInstance,
+		Matrix33::identity(),
+		Matrix33::identity(),
+		previousRoot,
+		false
+	);
+
+	// Gather bounds of all containers so we can cull entire subtrees while rendering.
+	m_containerBounds.resize(0);
+	for (const auto& node : m_retained[m_current])
+	{
+		if (node.container)
+			m_containerBounds.push_back(std::make_pair(node.instance, node.bounds));
+	}
+	std::sort(m_containerBounds.begin(), m_containerBounds.end(), [](const std::pair< const CharacterInstance*, Aabb2 >& lh, const std::pair< const CharacterInstance*, Aabb2 >& rh) {
+		return lh.first < rh.first;
+	});
+
+	// Repaint entire frame if frame setup has changed or display renderer cannot do partial repaints.
+	if (
+		m_invalid ||
+		!m_displayRenderer->wantDirtyRegion() ||
+		frameBounds != m_frameBounds ||
+		!(frameTransform == m_frameTransform) ||
+		viewWidth != m_viewSize.x ||
+		viewHeight != m_viewSize.y ||
+		backgroundColor != m_backgroundColor
+	)
+		m_dirtyRegion = frameBounds;
+	else if (m_dirtyRegion.empty())
+	{
+		// Nothing has changed since last frame; display renderer still have last frame.
+		return;
+	}
+
+	m_frameBounds = frameBounds;
+	m_frameTransform = frameTransform;
+	m_viewSize.set(viewWidth, viewHeight);
+	m_backgroundColor = backgroundColor;
+	m_invalid = false;
+
+	// Only characters which overlap both visible part of frame and dirty region need to be rendered.
+	const Vector2 Ft_offset(frameTransform.x(), frameTransform.y());
+	const Vector2 Ft_scale(frameTransform.z(), frameTransform.w());
+	Aabb2 frameBoundsVisible;
+	frameBoundsVisible.mn = frameBounds.mn + (frameBounds.mx - frameBounds.mn) * (Ft_offset / Ft_scale);
+	frameBoundsVisible.mx = frameBounds.mn + (frameBounds.mx - frameBounds.mn) * ((Vector2::one() - Ft_offset) / Ft_scale);
+	m_cullRegion = m_dirtyRegion.overlapped(frameBoundsVisible);
 
 	m_displayRenderer->begin(
 		*movieInstance->getDictionary(),
@@ -61,7 +203,7 @@ void MovieRenderer::render(
 		frameTransform,
 		viewWidth,
 		viewHeight,
-		dirtyRegion
+		m_dirtyRegion
 	);
 
 	const float fl = std::numeric_limits< float >::max();
@@ -81,6 +223,135 @@ void MovieRenderer::render(
 	m_displayRenderer->end();
 }
 
+void MovieRenderer::invalidate()
+{
+	m_invalid = true;
+}
+
+Aabb2 MovieRenderer::updateRetained(
+	CharacterInstance* instance,
+	const Matrix33& parentTransform,
+	const Matrix33& transform,
+	const RetainedNode* previous,
+	bool force
+)
+{
+	AlignedVector< RetainedNode >& nodes = m_retained[m_current];
+
+	SpriteInstance* spriteInstance = (&type_of(instance) == &type_of< SpriteInstance >()) ? static_cast< SpriteInstance* >(instance) : nullptr;
+	const bool container = (spriteInstance != nullptr && spriteInstance->getSprite()->getScalingGrid().empty());
+	const bool volatileInstance = isVolatile(instance);
+	const int32_t dirtyTag = stateTag(instance);
+	const int32_t subtreeDirtyTag = instance->getSubtreeDirtyTag();
+
+	bool changed = (force || previous == nullptr || previous->dirtyTag != dirtyTag || !equal(previous->transform, transform));
+	if (!container && !changed)
+		changed = (previous->subtreeDirtyTag != subtreeDirtyTag || volatileInstance);
+
+	// Nothing has changed in entire subtree; reuse retained nodes as-is.
+	if (!changed && previous->subtreeDirtyTag == subtreeDirtyTag && !previous->isVolatile)
+	{
+		nodes.insert(nodes.end(), previous, previous + previous->descendants + 1);
+		return previous->bounds;
+	}
+
+	const uint32_t index = uint32_t(nodes.size());
+	nodes.push_back();
+
+	Aabb2 bounds;
+	bool subtreeVolatile = volatileInstance;
+
+	if (instance->isVisible())
+	{
+		if (container)
+		{
+			if (const Canvas* canvas = spriteInstance->getCanvas())
+				bounds.contain(transform * canvas->getBounds());
+
+			// Children are usually in same order as last frame so keep a cursor
+			// where to start searching for previous child node.
+			const RetainedNode* previousBegin = previous ? previous + 1 : nullptr;
+			const RetainedNode* previousEnd = previous ? previous + 1 + previous->descendants : nullptr;
+			const RetainedNode* cursor = previousBegin;
+
+			for (const auto& it : spriteInstance->getDisplayList().getLayers())
+			{
+				CharacterInstance* child = it.second.instance;
+				if (!child)
+					continue;
+
+				const RetainedNode* previousChild = nullptr;
+				for (int32_t pass = 0; pass < 2 && !previousChild; ++pass)
+				{
+					const RetainedNode* from = (pass == 0) ? cursor : previousBegin;
+					const RetainedNode* to = (pass == 0) ? previousEnd : cursor;
+					for (const RetainedNode* p = from; p < to; p += p->descendants + 1)
+					{
+						if (p->instance == child)
+						{
+							previousChild = p;
+							break;
+						}
+					}
+				}
+				if (previousChild)
+					cursor = previousChild + previousChild->descendants + 1;
+
+				const uint32_t childIndex = uint32_t(nodes.size());
+				bounds.contain(updateRetained(
+					child,
+					transform,
+					transform * child->getTransform(),
+					previousChild,
+					changed
+				));
+				subtreeVolatile |= nodes[childIndex].isVolatile;
+			}
+		}
+		else
+			bounds = leafBounds(instance, parentTransform);
+	}
+
+	RetainedNode& node = nodes[index];
+	node.instance = instance;
+	node.transform = transform;
+	node.bounds = bounds;
+	node.dirtyTag = dirtyTag;
+	node.subtreeDirtyTag = subtreeDirtyTag;
+	node.descendants = uint32_t(nodes.size()) - index - 1;
+	node.container = container;
+	node.isVolatile = subtreeVolatile;
+
+	// Top-most changed node; both previous and current area need to be repainted.
+	if (changed && !force)
+	{
+		if (previous)
+			m_dirtyRegion.contain(previous->bounds);
+		m_dirtyRegion.contain(bounds);
+	}
+
+	return bounds;
+}
+
+bool MovieRenderer::isCulled(
+	CharacterInstance* characterInstance,
+	const Matrix33& transform
+) const
+{
+	if (&type_of(characterInstance) == &type_of< SpriteInstance >())
+	{
+		const auto it = std::lower_bound(m_containerBounds.begin(), m_containerBounds.end(), characterInstance, [](const std::pair< const CharacterInstance*, Aabb2 >& lh, const CharacterInstance* rh) {
+			return lh.first < rh;
+		});
+		if (it != m_containerBounds.end() && it->first == characterInstance)
+			return !overlaps(it->second, m_cullRegion);
+
+		// Not tracked as a container, ex. sprites inside scaling grids.
+		return false;
+	}
+	return !overlaps(leafBounds(characterInstance, transform), m_cullRegion);
+}
+
 void MovieRenderer::renderSprite(
 	SpriteInstance* spriteInstance,
 	const Matrix33& transform,
@@ -534,6 +805,11 @@ void MovieRenderer::renderCharacter(
 	if (!renderAsMask && cxTransform2.mul.getAlpha() + cxTransform2.add.getAlpha() <= FUZZY_EPSILON)
 		return;
 
+	// Don't render characters outside of region being repainted; masks are
+	// always rendered to keep stencil balanced.
+	if (!renderAsMask && isCulled(characterInstance, transform))
+		return;
+
 	Dictionary* dictionary = characterInstance->getDictionary();
 	T_ASSERT(dictionary);
 
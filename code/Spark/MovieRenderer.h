@@ -9,7 +9,9 @@
 #pragma once
 
 #include "Core/Object.h"
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Aabb2.h"
+#include "Core/Math/Color4f.h"
 #include "Core/Math/Matrix33.h"
 
 // import/export mechanism.
@@ -32,6 +34,12 @@ class CharacterInstance;
 
 /*! Movie renderer.
  * \ingroup Spark
+ *
+ * Renderer keep a retained copy of the instance hierarchy
+ * from last frame in order to determine which region of the
+ * frame has changed. If display renderer support dirty regions
+ * then only changed region is repainted; characters outside
+ * of region are culled as whole subtrees.
  */
 class T_DLLCLASS MovieRenderer : public Object
 {
@@ -48,8 +56,49 @@ public:
 		float viewHeight
 	);
 
+	/*! Force entire frame to be repainted next time movie is rendered. */
+	void invalidate();
+
+	/*! Get region, in frame space, which was repainted by last render. */
+	const Aabb2& getDirtyRegion() const { return m_dirtyRegion; }
+
 private:
+	struct RetainedNode
+	{
+		const CharacterInstance* instance;
+		Matrix33 transform;			//!< Global transform of instance.
+		Aabb2 bounds;				//!< Global bounds of instance, including all descendants.
+		int32_t dirtyTag;
+		int32_t subtreeDirtyTag;
+		uint32_t descendants;		//!< Number of following nodes which belong to this node's subtree.
+		bool container;				//!< Node's children are tracked individually.
+		bool isVolatile;			//!< Subtree contain state not tracked by tags; must always be visited.
+	};
+
 	Ref< IDisplayRenderer > m_displayRenderer;
+	AlignedVector< RetainedNode > m_retained[2];
+	AlignedVector< std::pair< const CharacterInstance*, Aabb2 > > m_containerBounds;
+	uint32_t m_current;
+	Aabb2 m_frameBounds;
+	Vector4 m_frameTransform;
+	Vector2 m_viewSize;
+	Color4f m_backgroundColor;
+	Aabb2 m_dirtyRegion;
+	Aabb2 m_cullRegion;
+	bool m_invalid;
+
+	Aabb2 updateRetained(
+		CharacterInstance* instance,
+		const Matrix33& parentTransform,
+		const Matrix33& transform,
+		const RetainedNode* previous,
+		bool force
+	);
+
+	bool isCulled(
+		CharacterInstance* characterInstance,
+		const Matrix33& transform
+	) const;
 
 	void renderSprite(
 		SpriteInstance* spriteInstance,
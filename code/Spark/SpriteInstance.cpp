@@ -32,7 +32,7 @@ T_IMPLEMENT_RTTI_CLASS(L"traktor.spark.SpriteInstance", SpriteInstance, Characte
 SpriteInstance::SpriteInstance(Context* context, Dictionary* dictionary, CharacterInstance* parent, const Sprite* sprite)
 :	CharacterInstance(context, dictionary, parent)
 ,	m_sprite(sprite)
-,	m_displayList(context)
+,	m_displayList(context, this)
 ,	m_mask(nullptr)
 ,	m_mouseX(0)
 ,	m_mouseY(0)
@@ -474,6 +474,7 @@ void SpriteInstance::setMask(SpriteInstance* mask)
 	clearCacheObject();
 	if ((m_mask = mask) != nullptr)
 		m_mask->setVisible(false);
+	invalidate();
 }
 
 CharacterInstance* SpriteInstance::getMember(const std::string& childName) const
@@ -490,7 +491,10 @@ Canvas* SpriteInstance::createCanvas()
 {
 	clearCacheObject();
 	if (!m_canvas)
+	{
 		m_canvas = new Canvas();
+		invalidate();
+	}
 	return m_canvas;
 }
 
@@ -6,6 +6,8 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cmath>
+#include <cstring>
 #include "Drawing/Image.h"
 #include "Drawing/Raster.h"
 #include "Spark/ColorTransform.h"
@@ -23,6 +25,35 @@ namespace traktor::spark
 	{
 
 const static Matrix33 c_textureTS = translate(0.5f, 0.5f) * scale(1.0f / 32768.0f, 1.0f / 32768.0f);
+const int32_t c_dirtyMargin = 2;	//!< Margin, in pixels, added around dirty region to include anti-aliased edges.
+
+void clearRect(drawing::Image* image, const int32_t rect[4], const Color4f& color)
+{
+	const int32_t width = rect[2] - rect[0];
+	const int32_t height = rect[3] - rect[1];
+	if (width <= 0 || height <= 0)
+		return;
+
+	// Clear first row then replicate into remaining rows.
+	for (int32_t x = rect[0]; x < rect[2]; ++x)
+		image->setPixelUnsafe(x, rect[1], color);
+
+	const int32_t pixelSize = image->getPixelFormat().getByteSize();
+	const int32_t pitch = image->getWidth() * pixelSize;
+	uint8_t* first = static_cast< uint8_t* >(image->getData()) + rect[1] * pitch + rect[0] * pixelSize;
+	for (int32_t y = 1; y < height; ++y)
+		std::memcpy(first + y * pitch, first, width * pixelSize);
+}
+
+bool isIdentity(const Matrix33& m)
+{
+	for (int32_t i = 0; i < 9; ++i)
+	{
+		if (m.m[i] != Matrix33::identity().m[i])
+			return false;
+	}
+	return true;
+}
 
 	}
 
@@ -32,15 +63,20 @@ SwDisplayRenderer::SwDisplayRenderer(drawing::Image* image, bool clearBackground
 :	m_image(image)
 ,	m_transform(Matrix33::identity())
 ,	m_clearBackground(clearBackground)
+,	m_retained(false)
 ,	m_writeMask(false)
 ,	m_writeEnable(true)
 {
 	m_raster = new drawing::Raster(m_image);
+	m_dirtyRect[0] = m_dirtyRect[1] = 0;
+	m_dirtyRect[2] = image->getWidth();
+	m_dirtyRect[3] = image->getHeight();
 }
 
 void SwDisplayRenderer::setTransform(const Matrix33& transform)
 {
 	m_transform = transform;
+	m_retained = false;
 }
 
 void SwDisplayRenderer::setImage(drawing::Image* image)
@@ -48,11 +84,14 @@ void SwDisplayRenderer::setImage(drawing::Image* image)
 	T_ASSERT(image->getPixelFormat() == m_image->getPixelFormat());
 	m_image = image;
 	m_raster = new drawing::Raster(m_image);
+	m_retained = false;
 }
 
 bool SwDisplayRenderer::wantDirtyRegion() const
 {
-	return false;
+	// Partial repaint only possible if we own entire image and
+	// previous frame is still intact.
+	return m_clearBackground && m_retained && isIdentity(m_transform);
 }
 
 void SwDisplayRenderer::begin(
@@ -65,10 +104,50 @@ void SwDisplayRenderer::begin(
 	const Aabb2& dirtyRegion
 )
 {
-	if (m_clearBackground)
-		m_image->clear(backgroundColor.rgb0());
+	const int32_t width = m_image->getWidth();
+	const int32_t height = m_image->getHeight();
+
 	m_frameBounds = frameBounds;
 	m_frameTransform = frameTransform;
+
+	// Convert dirty region into pixels.
+	const Matrix33 frameToRaster =
+		traktor::scale(width / m_frameBounds.mx.x, height / m_frameBounds.mx.y) *
+		traktor::scale(m_frameTransform.z(), m_frameTransform.w()) *
+		traktor::translate(m_frameTransform.x(), m_frameTransform.y());
+
+	const Aabb2 dirtyRaster = frameToRaster * dirtyRegion;
+	if (!dirtyRaster.empty())
+	{
+		m_dirtyRect[0] = clamp(int32_t(std::floor(dirtyRaster.mn.x)) - c_dirtyMargin, 0, width);
+		m_dirtyRect[1] = clamp(int32_t(std::floor(dirtyRaster.mn.y)) - c_dirtyMargin, 0, height);
+		m_dirtyRect[2] = clamp(int32_t(std::ceil(dirtyRaster.mx.x)) + c_dirtyMargin, 0, width);
+		m_dirtyRect[3] = clamp(int32_t(std::ceil(dirtyRaster.mx.y)) + c_dirtyMargin, 0, height);
+	}
+	else
+	{
+		m_dirtyRect[0] = m_dirtyRect[1] = 0;
+		m_dirtyRect[2] = m_dirtyRect[3] = 0;
+	}
+
+	const bool partial = (m_dirtyRect[0] > 0 || m_dirtyRect[1] > 0 || m_dirtyRect[2] < width || m_dirtyRect[3] < height);
+	if (partial)
+	{
+		m_raster->setClipRect(
+			m_dirtyRect[0],
+			m_dirtyRect[1],
+			m_dirtyRect[2] - m_dirtyRect[0],
+			m_dirtyRect[3] - m_dirtyRect[1]
+		);
+		if (m_clearBackground)
+			clearRect(m_image, m_dirtyRect, backgroundColor.rgb0());
+	}
+	else
+	{
+		m_raster->resetClipRect();
+		if (m_clearBackground)
+			m_image->clear(backgroundColor.rgb0());
+	}
 }
 
 void SwDisplayRenderer::beginSprite(const SpriteInstance& sprite, const Matrix33& transform)
@@ -98,7 +177,7 @@ void SwDisplayRenderer::beginMask(bool increment)
 			m_image->getWidth(),
 			m_image->getHeight()
 		));
-		m_mask.back()->clear(Color4f(0.0f, 0.0f, 0.0f, 0.0f));
+		clearRect(m_mask.back(), m_dirtyRect, Color4f(0.0f, 0.0f, 0.0f, 0.0f));
 		m_raster->setImage(m_mask.back());
 		if (m_mask.size() >= 2)
 			m_raster->setMask(m_mask[m_mask.size() - 2]);
@@ -514,6 +593,7 @@ void SwDisplayRenderer::renderCanvas(const Matrix33& transform, const Canvas& ca
 
 void SwDisplayRenderer::end()
 {
+	m_retained = true;
 }
 
 }
@@ -99,7 +99,9 @@ private:
 	Matrix33 m_transform;
 	Aabb2 m_frameBounds;
 	Vector4 m_frameTransform;
+	int32_t m_dirtyRect[4];		//!< [left, top, right, bottom] in pixels, region being repainted.
 	bool m_clearBackground;
+	bool m_retained;			//!< Image still contain previous frame; only dirty region need to be repainted.
 	bool m_writeMask;
 	bool m_writeEnable;
 };
@@ -11,6 +11,9 @@
 #include "Core/Log/Log.h"
 #include "Core/Math/Half.h"
 #include "Core/Math/RandomGeometry.h"
+#include "Core/Misc/Align.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobManager.h"
 #include "Heightfield/Heightfield.h"
 #include "Render/ITexture.h"
 #include "Render/Context/RenderContext.h"
@@ -38,6 +41,10 @@ const render::Handle s_handleTerrain_Surface(L"Terrain_Surface");
 const render::Handle s_handleTerrain_WorldExtent(L"Terrain_WorldExtent");
 const render::Handle s_handleForest_Eye(L"Forest_Eye");
 
+const int32_t c_clusterGridSize = 16;			//!< Size of cluster in heightfield grid units.
+const uint32_t c_minInstancesPerJob = 4096;		//!< Minimum number of instances to cull on each job.
+const uint32_t c_maxCullJobs = 8;
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.terrain.ForestComponent", ForestComponent, TerrainLayerComponent)
@@ -108,51 +115,10 @@ void ForestComponent::build(
 	{
 		const bool updateClusters = (bool)((worldRenderPass.getPassFlags() & world::IWorldRenderPass::First) != 0);
 		if (updateClusters)
-		{
-			m_lod0Indices.resize(0);
-			m_lod1Indices.resize(0);
-			m_lod2Indices.resize(0);
-
-			for (uint32_t i = 0; i < (uint32_t)m_trees.size(); ++i)
-			{
-				const auto& tree = m_trees[i];
-
-				float distance = 0.0f;
-				if (!worldRenderView.isBoxVisible(
-					m_boundingBox,
-					Transform(tree.position),
-					distance
-				))
-					continue;
-
-				if (distance < m_data.m_lod0distance)
-					m_lod0Indices.push_back(i);
-				else if (distance < m_data.m_lod1distance)
-					m_lod1Indices.push_back(i);
-				else if (distance < m_data.m_lod2distance)
-					m_lod2Indices.push_back(i);
-			}
-		}
+			cull(worldRenderView, false);
 	}
 	else
-	{
-		m_lodShadowIndices.resize(0);
-
-		for (uint32_t i = 0; i < (uint32_t)m_trees.size(); ++i)
-		{
-			const auto& tree = m_trees[i];
-
-			float distance = 0.0f;
-			if (!worldRenderView.isBoxVisible(
-				m_boundingBox,
-				Transform(tree.position),
-				distance
-			))
-				continue;
-
-			m_lodShadowIndices.push_back(i);
-		}
-	}
+		cull(worldRenderView, true);
 
 	render::RenderContext* renderContext = context.getRenderContext();
 
@@ -257,6 +223,171 @@ void ForestComponent::build(
 */
 }
 
+void ForestComponent::cull(const world::WorldRenderView& worldRenderView, bool shadow)
+{
+	const LayerCuller culler(worldRenderView.getCullFrustum(), worldRenderView.getView());
+	const Scalar radius = m_boundingBox.getExtent().length();
+	const float lodDistances[] = { m_data.m_lod0distance, m_data.m_lod1distance, m_data.m_lod2distance };
+
+	// Cull clusters, four at a time.
+	m_visibleClusters.resize(0);
+
+	uint32_t visibleInstances = 0;
+	for (int32_t i = 0; i < (int32_t)m_clusters.size(); i += 4)
+	{
+		Vector4 viewZ;
+		uint32_t inside;
+		uint32_t visible = culler.cull4(
+			Vector4::loadAligned(&m_clusterX[i]),
+			Vector4::loadAligned(&m_clusterY[i]),
+			Vector4::loadAligned(&m_clusterZ[i]),
+			Vector4::loadAligned(&m_clusterRadius[i]),
+			viewZ,
+			inside
+		);
+		visible &= (1 << std::min< int32_t >((int32_t)m_clusters.size() - i, 4)) - 1;
+
+		for (int32_t j = 0; j < 4; ++j)
+		{
+			if ((visible & (1 << j)) == 0)
+				continue;
+
+			const Cluster& cluster = m_clusters[i + j];
+			m_visibleClusters.push_back({ i + j, (inside & (1 << j)) != 0 });
+			visibleInstances += cluster.to - cluster.from;
+		}
+	}
+
+	// Split visible clusters into chunks of roughly equal number of instances.
+	const uint32_t jobCount = clamp< uint32_t >(visibleInstances / c_minInstancesPerJob, 1, std::min< uint32_t >(OS::getInstance().getCPUCoreCount(), c_maxCullJobs));
+	const uint32_t instancesPerJob = (visibleInstances + jobCount - 1) / jobCount;
+
+	m_cullChunks.resize(jobCount);
+	{
+		int32_t from = 0;
+		for (uint32_t i = 0; i < jobCount; ++i)
+		{
+			int32_t to = from;
+			for (uint32_t count = 0; to < (int32_t)m_visibleClusters.size() && (count < instancesPerJob || i == jobCount - 1); ++to)
+			{
+				const Cluster& cluster = m_clusters[m_visibleClusters[to].cluster];
+				count += cluster.to - cluster.from;
+			}
+			m_cullChunks[i].from = from;
+			m_cullChunks[i].to = to;
+			from = to;
+		}
+	}
+
+	// Cull instances of visible clusters, four at a time, and bucket by distance.
+	auto cullChunk = [&](CullChunk& chunk) {
+		chunk.tested = 0;
+		for (auto& lodIndices : chunk.lodIndices)
+			lodIndices.resize(0);
+
+		for (int32_t i = chunk.from; i < chunk.to; ++i)
+		{
+			const VisibleCluster& visibleCluster = m_visibleClusters[i];
+			const Cluster& cluster = m_clusters[visibleCluster.cluster];
+
+			if (!visibleCluster.inside)
+				chunk.tested += cluster.to - cluster.from;
+
+			for (int32_t j = cluster.from; j < cluster.to; j += 4)
+			{
+				Vector4 viewZ;
+				uint32_t inside;
+				uint32_t visible = culler.cull4(
+					Vector4::loadUnaligned(&m_treeX[j]),
+					Vector4::loadUnaligned(&m_treeY[j]),
+					Vector4::loadUnaligned(&m_treeZ[j]),
+					Vector4(radius),
+					viewZ,
+					inside
+				);
+
+				// All instances of a cluster completely inside frustum are also inside.
+				const uint32_t valid = (1 << std::min< int32_t >(cluster.to - j, 4)) - 1;
+				visible = visibleCluster.inside ? valid : (visible & valid);
+				if (!visible)
+					continue;
+
+				// Distance used to select LOD is view z of bounds center plus bounds radius,
+				// ie. same distance as given by WorldRenderView::isBoxVisible.
+				const Vector4 distance = viewZ + Vector4(radius);
+				for (int32_t k = 0; k < 4; ++k)
+				{
+					if ((visible & (1 << k)) == 0)
+						continue;
+
+					if (shadow)
+					{
+						chunk.lodIndices[0].push_back(j + k);
+						continue;
+					}
+
+					const float d = distance[k];
+#if defined(_DEBUG)
+					float referenceDistance;
+					if (worldRenderView.isBoxVisible(m_boundingBox, Transform(m_trees[j + k].position), referenceDistance))
+						T_ASSERT(std::abs(d - referenceDistance) <= 0.001f * std::max(std::abs(referenceDistance), 1.0f));
+#endif
+					for (int32_t lod = 0; lod < 3; ++lod)
+					{
+						if (d < lodDistances[lod])
+						{
+							chunk.lodIndices[lod].push_back(j + k);
+							break;
+						}
+					}
+				}
+			}
+		}
+	};
+
+	if (jobCount > 1)
+	{
+		StaticVector< Job::task_t, c_maxCullJobs > jobs;
+		for (auto& chunk : m_cullChunks)
+			jobs.push_back([&](){ cullChunk(chunk); });
+		JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+	}
+	else
+		cullChunk(m_cullChunks[0]);
+
+	// Merge result of each chunk, keep order of instances.
+	m_statistics.clusters = (uint32_t)m_clusters.size();
+	m_statistics.visibleClusters = (uint32_t)m_visibleClusters.size();
+	m_statistics.instances = (uint32_t)m_trees.size();
+	m_statistics.testedInstances = 0;
+
+	if (shadow)
+	{
+		m_lodShadowIndices.resize(0);
+		for (const auto& chunk : m_cullChunks)
+		{
+			m_lodShadowIndices.insert(m_lodShadowIndices.end(), chunk.lodIndices[0].begin(), chunk.lodIndices[0].end());
+			m_statistics.testedInstances += chunk.tested;
+		}
+		m_statistics.visibleInstances = (uint32_t)m_lodShadowIndices.size();
+	}
+	else
+	{
+		AlignedVector< uint32_t >* lodIndices[] = { &m_lod0Indices, &m_lod1Indices, &m_lod2Indices };
+		for (int32_t lod = 0; lod < 3; ++lod)
+		{
+			lodIndices[lod]->resize(0);
+			for (const auto& chunk : m_cullChunks)
+				lodIndices[lod]->insert(lodIndices[lod]->end(), chunk.lodIndices[lod].begin(), chunk.lodIndices[lod].end());
+		}
+		for (const auto& chunk : m_cullChunks)
+			m_statistics.testedInstances += chunk.tested;
+		m_statistics.visibleInstances = (uint32_t)(m_lod0Indices.size() + m_lod1Indices.size() + m_lod2Indices.size());
+	}
+
+	m_cullMetrics.report(m_statistics);
+}
+
 void ForestComponent::updatePatches()
 {
 	auto terrainComponent = m_owner->getComponent< TerrainComponent >();
@@ -311,6 +442,85 @@ void ForestComponent::updatePatches()
 			tree.scale = random.nextFloat() * m_data.m_randomScale + (1.0f - m_data.m_randomScale);
 		}
 	}
+
+	// Sort trees into clusters of grid cells.
+	const int32_t clustersPerRow = (size + c_clusterGridSize - 1) / c_clusterGridSize;
+	const int32_t cellCount = clustersPerRow * clustersPerRow;
+
+	AlignedVector< int32_t > treeCells(m_trees.size());
+	AlignedVector< int32_t > cellOffsets;
+	cellOffsets.resize(cellCount + 1, 0);
+	for (size_t i = 0; i < m_trees.size(); ++i)
+	{
+		float gx, gz;
+		heightfield->worldToGrid(m_trees[i].position.x(), m_trees[i].position.z(), gx, gz);
+
+		const int32_t cx = clamp((int32_t)gx / c_clusterGridSize, 0, clustersPerRow - 1);
+		const int32_t cz = clamp((int32_t)gz / c_clusterGridSize, 0, clustersPerRow - 1);
+		treeCells[i] = cx + cz * clustersPerRow;
+		cellOffsets[treeCells[i] + 1]++;
+	}
+	for (int32_t i = 0; i < cellCount; ++i)
+		cellOffsets[i + 1] += cellOffsets[i];
+
+	AlignedVector< Tree > trees(m_trees.size());
+	{
+		AlignedVector< int32_t > cellWrite(cellOffsets.begin(), cellOffsets.end() - 1);
+		for (size_t i = 0; i < m_trees.size(); ++i)
+			trees[cellWrite[treeCells[i]]++] = m_trees[i];
+	}
+	m_trees.swap(trees);
+
+	// Separate tree bounds centers so they can be culled four at a time.
+	const Vector4 boundingBoxCenter = m_boundingBox.getCenter();
+	const size_t paddedTreeCount = alignUp(m_trees.size(), 4) + 4;
+
+	m_treeX.resize(paddedTreeCount, 0.0f);
+	m_treeY.resize(paddedTreeCount, 0.0f);
+	m_treeZ.resize(paddedTreeCount, 0.0f);
+
+	for (size_t i = 0; i < m_trees.size(); ++i)
+	{
+		const Vector4 center = m_trees[i].position + boundingBoxCenter;
+		m_treeX[i] = center.x();
+		m_treeY[i] = center.y();
+		m_treeZ[i] = center.z();
+	}
+
+	// Create clusters with bounds enclosing all trees.
+	m_clusters.resize(0);
+	m_clusterX.resize(0);
+	m_clusterY.resize(0);
+	m_clusterZ.resize(0);
+	m_clusterRadius.resize(0);
+
+	for (int32_t i = 0; i < cellCount; ++i)
+	{
+		const int32_t from = cellOffsets[i];
+		const int32_t to = cellOffsets[i + 1];
+		if (from >= to)
+			continue;
+
+		Aabb3 clusterBoundingBox;
+		for (int32_t j = from; j < to; ++j)
+		{
+			clusterBoundingBox.contain(m_trees[j].position + m_boundingBox.mn);
+			clusterBoundingBox.contain(m_trees[j].position + m_boundingBox.mx);
+		}
+
+		const Vector4 center = clusterBoundingBox.getCenter();
+		m_clusters.push_back({ from, to });
+		m_clusterX.push_back(center.x());
+		m_clusterY.push_back(center.y());
+		m_clusterZ.push_back(center.z());
+		m_clusterRadius.push_back(clusterBoundingBox.getExtent().length());
+	}
+
+	const size_t paddedClusterCount = alignUp(m_clusters.size(), 4);
+	m_clusterX.resize(paddedClusterCount, 0.0f);
+	m_clusterY.resize(paddedClusterCount, 0.0f);
+	m_clusterZ.resize(paddedClusterCount, 0.0f);
+	m_clusterRadius.resize(paddedClusterCount, 0.0f);
 }
 
 }
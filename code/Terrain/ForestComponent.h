@@ -13,6 +13,7 @@
 #include "Mesh/Instance/InstanceMesh.h"
 #include "Resource/Proxy.h"
 #include "Terrain/ForestComponentData.h"
+#include "Terrain/LayerCuller.h"
 #include "Terrain/TerrainLayerComponent.h"
 
 namespace traktor::render
@@ -61,6 +62,8 @@ public:
 
 	virtual void updatePatches() override final;
 
+	const LayerCullStatistics& getCullStatistics() const { return m_statistics; }
+
 private:
 	struct Tree
 	{
@@ -69,18 +72,52 @@ private:
 		float scale;
 	};
 
+	struct Cluster
+	{
+		int32_t from;
+		int32_t to;
+	};
+
+	struct VisibleCluster
+	{
+		int32_t cluster;
+		bool inside;
+	};
+
+	struct CullChunk
+	{
+		int32_t from;		//!< First visible cluster.
+		int32_t to;			//!< Last visible cluster (exclusive).
+		uint32_t tested;
+		AlignedVector< uint32_t > lodIndices[3];
+	};
+
 	world::Entity* m_owner = nullptr;
 	ForestComponentData m_data;
 	resource::Proxy< mesh::InstanceMesh > m_lod0mesh;
 	resource::Proxy< mesh::InstanceMesh > m_lod1mesh;
 	resource::Proxy< mesh::InstanceMesh > m_lod2mesh;
 	AlignedVector< Tree > m_trees;
+	AlignedVector< float > m_treeX;				//!< Center of tree bounds, padded to be read four at a time.
+	AlignedVector< float > m_treeY;
+	AlignedVector< float > m_treeZ;
+	AlignedVector< Cluster > m_clusters;
+	AlignedVector< float > m_clusterX;			//!< Center of cluster bounds, padded to be read four at a time.
+	AlignedVector< float > m_clusterY;
+	AlignedVector< float > m_clusterZ;
+	AlignedVector< float > m_clusterRadius;
+	AlignedVector< VisibleCluster > m_visibleClusters;
+	AlignedVector< CullChunk > m_cullChunks;
 	AlignedVector< uint32_t > m_lod0Indices;
 	AlignedVector< uint32_t > m_lod1Indices;
 	AlignedVector< uint32_t > m_lod2Indices;
 	AlignedVector< uint32_t > m_lodShadowIndices;
 	//AlignedVector< mesh::InstanceMesh::RenderInstance > m_instanceData;
 	Aabb3 m_boundingBox;
+	LayerCullStatistics m_statistics;
+	LayerCullMetrics m_cullMetrics = LayerCullMetrics(L"Forest");
+
+	void cull(const world::WorldRenderView& worldRenderView, bool shadow);
 };
 
 }
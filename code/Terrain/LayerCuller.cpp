@@ -0,0 +1,57 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include "Terrain/LayerCuller.h"
+
+namespace traktor::terrain
+{
+
+LayerCuller::LayerCuller(const Frustum& frustum, const Matrix44& view)
+{
+	// Since view is rigid, distance to a view space plane is the same as
+	// distance to the plane transformed into world space.
+	const Matrix44 viewT = view.transpose();
+	for (const auto& plane : frustum.planes)
+	{
+		const Vector4 n = viewT * plane.normal().xyz0();
+		auto& plane4 = m_planes.push_back();
+		plane4.x = Vector4(n.x());
+		plane4.y = Vector4(n.y());
+		plane4.z = Vector4(n.z());
+		plane4.w = Vector4(n.w() - plane.distance());
+	}
+
+	m_viewZ.x = Vector4(view.get(2, 0));
+	m_viewZ.y = Vector4(view.get(2, 1));
+	m_viewZ.z = Vector4(view.get(2, 2));
+	m_viewZ.w = Vector4(view.get(2, 3));
+}
+
+LayerCullMetrics::LayerCullMetrics(const std::wstring& layerName)
+{
+	Metrics& metrics = Metrics::getInstance();
+	m_culls = metrics.registerCounter(L"Terrain/" + layerName + L"/Culls");
+	m_clusters = metrics.registerCounter(L"Terrain/" + layerName + L"/Clusters");
+	m_visibleClusters = metrics.registerCounter(L"Terrain/" + layerName + L"/VisibleClusters");
+	m_instances = metrics.registerCounter(L"Terrain/" + layerName + L"/Instances");
+	m_testedInstances = metrics.registerCounter(L"Terrain/" + layerName + L"/TestedInstances");
+	m_visibleInstances = metrics.registerCounter(L"Terrain/" + layerName + L"/VisibleInstances");
+}
+
+void LayerCullMetrics::report(const LayerCullStatistics& statistics) const
+{
+	Metrics& metrics = Metrics::getInstance();
+	metrics.increment(m_culls);
+	metrics.increment(m_clusters, statistics.clusters);
+	metrics.increment(m_visibleClusters, statistics.visibleClusters);
+	metrics.increment(m_instances, statistics.instances);
+	metrics.increment(m_testedInstances, statistics.testedInstances);
+	metrics.increment(m_visibleInstances, statistics.visibleInstances);
+}
+
+}
@@ -0,0 +1,126 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <limits>
+#include <string>
+#include "Core/Containers/StaticVector.h"
+#include "Core/Math/Frustum.h"
+#include "Core/Math/Matrix44.h"
+#include "Core/Math/Vector4.h"
+#include "Core/Timer/Metrics.h"
+
+// import/export mechanism.
+#undef T_DLLCLASS
+#if defined(T_TERRAIN_EXPORT)
+#	define T_DLLCLASS T_DLLEXPORT
+#else
+#	define T_DLLCLASS T_DLLIMPORT
+#endif
+
+namespace traktor::terrain
+{
+
+/*! Culling statistics of a terrain layer.
+ * \ingroup Terrain
+ */
+struct LayerCullStatistics
+{
+	uint32_t clusters = 0;			//!< Total number of clusters.
+	uint32_t visibleClusters = 0;	//!< Clusters passing cluster culling.
+	uint32_t instances = 0;			//!< Total number of instances.
+	uint32_t testedInstances = 0;	//!< Instances in partially visible clusters, tested individually.
+	uint32_t visibleInstances = 0;	//!< Instances passing culling.
+};
+
+/*! Report culling statistics of a terrain layer as metrics.
+ * \ingroup Terrain
+ *
+ * Counters are shared by all layers of same kind and
+ * accumulated for each cull; difference between two
+ * metric snapshots give culling work of interval.
+ */
+class T_DLLCLASS LayerCullMetrics
+{
+public:
+	explicit LayerCullMetrics(const std::wstring& layerName);
+
+	void report(const LayerCullStatistics& statistics) const;
+
+private:
+	Metrics::handle_t m_culls;
+	Metrics::handle_t m_clusters;
+	Metrics::handle_t m_visibleClusters;
+	Metrics::handle_t m_instances;
+	Metrics::handle_t m_testedInstances;
+	Metrics::handle_t m_visibleInstances;
+};
+
+/*! Cull bounding spheres, four at a time, against a view frustum.
+ * \ingroup Terrain
+ *
+ * Frustum planes are transformed into world space once
+ * so spheres can be tested directly from world space
+ * positions stored in separate x, y and z arrays.
+ * View transform is assumed to be rigid.
+ */
+class T_DLLCLASS LayerCuller
+{
+public:
+	explicit LayerCuller(const Frustum& frustum, const Matrix44& view);
+
+	/*! Cull four spheres.
+	 *
+	 * \param x World space x of sphere centers.
+	 * \param y World space y of sphere centers.
+	 * \param z World space z of sphere centers.
+	 * \param radius Radius of spheres.
+	 * \param outViewZ View space z of sphere centers.
+	 * \param outInside Mask of spheres completely inside frustum.
+	 * \return Mask of spheres at least partially inside frustum.
+	 */
+	inline uint32_t cull4(const Vector4& x, const Vector4& y, const Vector4& z, const Vector4& radius, Vector4& outViewZ, uint32_t& outInside) const
+	{
+		Vector4 mnd(Scalar(std::numeric_limits< float >::max()));
+		for (const auto& plane : m_planes)
+			mnd = min(mnd, plane.x * x + plane.y * y + plane.z * z + plane.w);
+
+		outViewZ = m_viewZ.x * x + m_viewZ.y * y + m_viewZ.z * z + m_viewZ.w;
+
+		T_MATH_ALIGN16 float e[4];
+		T_MATH_ALIGN16 float r[4];
+		mnd.storeAligned(e);
+		radius.storeAligned(r);
+
+		uint32_t visible = 0;
+		outInside = 0;
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			if (e[i] >= -r[i])
+				visible |= 1 << i;
+			if (e[i] >= r[i])
+				outInside |= 1 << i;
+		}
+		return visible;
+	}
+
+private:
+	struct Plane4
+	{
+		Vector4 x;
+		Vector4 y;
+		Vector4 z;
+		Vector4 w;
+	};
+
+	StaticVector< Plane4, 12 > m_planes;
+	Plane4 m_viewZ;
+};
+
+}
@@ -11,6 +11,9 @@
 #include "Core/Log/Log.h"
 #include "Core/Math/Half.h"
 #include "Core/Math/RandomGeometry.h"
+#include "Core/Misc/Align.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobManager.h"
 #include "Heightfield/Heightfield.h"
 #include "Render/ITexture.h"
 #include "Render/Context/RenderContext.h"
@@ -38,6 +41,10 @@ const render::Handle s_handleTerrain_WorldExtent(L"Terrain_WorldExtent");
 const render::Handle s_handleRubble_Eye(L"Rubble_Eye");
 const render::Handle s_handleRubble_MaxDistance(L"Rubble_MaxDistance");
 
+const int32_t c_minInstancesPerJob = 1024;	//!< Minimum number of instances to scatter on each job.
+const uint32_t c_maxScatterJobs = 8;
+const float c_rotationSlack = 0.035f;		//!< Sine of view rotation, in radians, allowed before instances are culled again.
+
 	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.terrain.RubbleComponent", RubbleComponent, TerrainLayerComponent)
@@ -128,51 +135,176 @@ void RubbleComponent::build(
 			m_eye = eye;
 			m_fwd = fwd;
 
-			for (auto& cluster : m_clusters)
+			const LayerCuller culler(viewFrustum, view);
+			const Vector4 clusterRadius = Vector4(Scalar(m_clusterSize));
+
+			// Cull clusters, four at a time, and collect clusters which have become visible.
+			m_scatterClusters.resize(0);
+
+			int32_t scatterInstanceCount = 0;
+			uint32_t visibleClusterCount = 0;
+			uint32_t testedInstanceCount = 0;
+
+			for (int32_t i = 0; i < (int32_t)m_clusters.size(); i += 4)
 			{
-				cluster.distance = (cluster.center - eye).length();
+				Vector4 viewZ;
+				uint32_t inside;
+				uint32_t visible = culler.cull4(
+					Vector4::loadAligned(&m_clusterX[i]),
+					Vector4::loadAligned(&m_clusterY[i]),
+					Vector4::loadAligned(&m_clusterZ[i]),
+					clusterRadius,
+					viewZ,
+					inside
+				);
+
+				const int32_t count = std::min< int32_t >((int32_t)m_clusters.size() - i, 4);
+				for (int32_t j = 0; j < count; ++j)
+				{
+					Cluster& cluster = m_clusters[i + j];
+					cluster.distance = (cluster.center - eye).length();
+
+					const bool wasVisible = cluster.visible;
+					cluster.visible = (bool)((visible & (1 << j)) != 0);
+					cluster.inside = (bool)((inside & (1 << j)) != 0);
+					if (!cluster.visible)
+						continue;
+
+					visibleClusterCount++;
+					if (!cluster.inside)
+						testedInstanceCount += cluster.to - cluster.from;
+
+					if (!wasVisible)
+					{
+						m_scatterClusters.push_back(i + j);
+						scatterInstanceCount += cluster.to - cluster.from;
+					}
+				}
+			}
+
+			// Scatter instances of clusters which have become visible, each cluster own it's range of instances.
+			auto scatterClusters = [&](int32_t from, int32_t to) {
+				for (int32_t i = from; i < to; ++i)
+				{
+					const Cluster& cluster = m_clusters[m_scatterClusters[i]];
+
+					const float randomScaleAmount = cluster.rubbleDef->randomScaleAmount;
+					const float randomTilt = cluster.rubbleDef->randomTilt;
+					const float upness = cluster.rubbleDef->upness;
+
+					RandomGeometry random(cluster.seed);
+					for (int32_t j = cluster.from; j < cluster.to; ++j)
+					{
+						const float dx = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
+						const float dz = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
+
+						// Calculate world position.
+						const float px = cluster.center.x() + dx;
+						const float pz = cluster.center.z() + dz;
+						const float py = heightfield->getWorldHeight(px, pz);
+
+						// Get ground normal.
+						float gx, gz;
+						heightfield->worldToGrid(px, pz, gx, gz);
+						const Vector4 normal = heightfield->normalAt(gx, gz);
+
+						// Calculate rotation.
+						const float rx = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
+						const float rz = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
+						const float head = random.nextFloat() * TWO_PI;
+						const Quaternion Qu = slerp(Quaternion(Vector4(0.0f, 1.0f, 0.0f), normal), Quaternion::identity(), upness);
+						const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz);
+						const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head);
+
+						// Update instance data.
+						m_instances[j].position = Vector4(px, py, pz, 0.0f);
+						m_instances[j].rotation = Qr * Qu * Qh;
+						m_instances[j].scale = random.nextFloat() * randomScaleAmount + (1.0f - randomScaleAmount);
+					}
+				}
+			};
 
-				const bool visible = cluster.visible;
-				cluster.visible = (bool)(viewFrustum.inside(view * cluster.center, Scalar(m_clusterSize)) != Frustum::Result::Outside);
+			const int32_t scatterClusterCount = (int32_t)m_scatterClusters.size();
+			const uint32_t jobCount = clamp< uint32_t >(scatterInstanceCount / c_minInstancesPerJob, 1, std::min< uint32_t >(OS::getInstance().getCPUCoreCount(), c_maxScatterJobs));
+			if (jobCount > 1)
+			{
+				StaticVector< Job::task_t, c_maxScatterJobs > jobs;
+				for (uint32_t i = 0; i < jobCount; ++i)
+				{
+					const int32_t from = (scatterClusterCount * i) / jobCount;
+					const int32_t to = (scatterClusterCount * (i + 1)) / jobCount;
+					jobs.push_back([=, &scatterClusters](){ scatterClusters(from, to); });
+				}
+				JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
+			}
+			else
+				scatterClusters(0, scatterClusterCount);
+
+			// Collect visible instances; instances of clusters partially inside frustum are culled
+			// individually, four at a time. Since culling is only updated when view has moved or
+			// rotated enough the bounds are grown to keep instances visible until next update.
+			m_visibleInstances.resize(0);
+			for (auto& cluster : m_clusters)
+			{
+				cluster.visibleFrom = (int32_t)m_visibleInstances.size();
+				cluster.visibleTo = cluster.visibleFrom;
 				if (!cluster.visible)
 					continue;
-				if (cluster.visible && visible)
+
+				if (cluster.inside || !cluster.rubbleDef->mesh)
+				{
+					for (int32_t j = cluster.from; j < cluster.to; ++j)
+						m_visibleInstances.push_back(j);
+					cluster.visibleTo = (int32_t)m_visibleInstances.size();
 					continue;
+				}
 
-				const float randomScaleAmount = cluster.rubbleDef->randomScaleAmount;
-				const float randomTilt = cluster.rubbleDef->randomTilt;
-				const float upness = cluster.rubbleDef->upness;
+				const Aabb3& boundingBox = cluster.rubbleDef->mesh->getBoundingBox();
+				const float meshRadius = boundingBox.getCenter().xyz0().length() + boundingBox.getExtent().length();
 
-				RandomGeometry random(cluster.seed);
-				for (int32_t j = cluster.from; j < cluster.to; ++j)
+				T_MATH_ALIGN16 float bx[4];
+				T_MATH_ALIGN16 float by[4];
+				T_MATH_ALIGN16 float bz[4];
+				T_MATH_ALIGN16 float br[4];
+
+				for (int32_t j = cluster.from; j < cluster.to; j += 4)
 				{
-					const float dx = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
-					const float dz = (random.nextFloat() * 2.0f - 1.0f) * m_clusterSize;
-
-					// Calculate world position.
-					const float px = cluster.center.x() + dx;
-					const float pz = cluster.center.z() + dz;
-					const float py = terrain->getHeightfield()->getWorldHeight(px, pz);
-
-					// Get ground normal.
-					float gx, gz;
-					heightfield->worldToGrid(px, pz, gx, gz);
-					const Vector4 normal = heightfield->normalAt(gx, gz);
-
-					// Calculate rotation.
-					const float rx = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
-					const float rz = (random.nextFloat() * 2.0f - 1.0f) * randomTilt;
-					const float head = random.nextFloat() * TWO_PI;
-					const Quaternion Qu = slerp(Quaternion(Vector4(0.0f, 1.0f, 0.0f), normal), Quaternion::identity(), upness);
-					const Quaternion Qr = Quaternion::fromAxisAngle(Vector4(1.0f, 0.0f, 0.0f), rx) * Quaternion::fromAxisAngle(Vector4(0.0f, 0.0f, 1.0f), rz);
-					const Quaternion Qh = Quaternion::fromAxisAngle(Vector4(0.0f, 1.0f, 0.0f), head);
-
-					// Update instance data.
-					m_instances[j].position = Vector4(px, py, pz, 0.0f);
-					m_instances[j].rotation = Qr * Qu * Qh;
-					m_instances[j].scale = random.nextFloat() * randomScaleAmount + (1.0f - randomScaleAmount);
+					const int32_t count = std::min< int32_t >(cluster.to - j, 4);
+					for (int32_t k = 0; k < count; ++k)
+					{
+						const Instance& instance = m_instances[j + k];
+						bx[k] = instance.position.x();
+						by[k] = instance.position.y();
+						bz[k] = instance.position.z();
+						br[k] = meshRadius * instance.scale + m_clusterSize / 2.0f + (instance.position.xyz1() - eye).length() * c_rotationSlack;
+					}
+
+					Vector4 viewZ;
+					uint32_t inside;
+					const uint32_t visible = culler.cull4(
+						Vector4::loadAligned(bx),
+						Vector4::loadAligned(by),
+						Vector4::loadAligned(bz),
+						Vector4::loadAligned(br),
+						viewZ,
+						inside
+					);
+					for (int32_t k = 0; k < count; ++k)
+					{
+						if ((visible & (1 << k)) != 0)
+							m_visibleInstances.push_back(j + k);
+					}
 				}
+
+				cluster.visibleTo = (int32_t)m_visibleInstances.size();
 			}
+
+			m_statistics.clusters = (uint32_t)m_clusters.size();
+			m_statistics.visibleClusters = visibleClusterCount;
+			m_statistics.instances = (uint32_t)m_instances.size();
+			m_statistics.testedInstances = testedInstanceCount;
+			m_statistics.visibleInstances = (uint32_t)m_visibleInstances.size();
+			m_cullMetrics.report(m_statistics);
 		}
 	}
 
@@ -195,17 +327,17 @@ void RubbleComponent::build(
 		if (!cluster.visible)
 			continue;
 
-		const int32_t count = cluster.to - cluster.from;
-		for (int32_t j = 0; j < count; )
+		for (int32_t j = cluster.visibleFrom; j < cluster.visibleTo; )
 		{
-			const int32_t batch = std::min< int32_t >(count - j, mesh::InstanceMesh::MaxInstanceCount);
+			const int32_t batch = std::min< int32_t >(cluster.visibleTo - j, mesh::InstanceMesh::MaxInstanceCount);
 
 			m_instanceData.resize(batch);
 			for (int32_t k = 0; k < batch; ++k, ++j)
 			{
-				m_instances[j + cluster.from].position.storeAligned( m_instanceData[k].data.translation );
-				m_instances[j + cluster.from].rotation.e.storeAligned( m_instanceData[k].data.rotation );
-				m_instanceData[k].data.scale = m_instances[j + cluster.from].scale;
+				const Instance& instance = m_instances[m_visibleInstances[j]];
+				instance.position.storeAligned( m_instanceData[k].data.translation );
+				instance.rotation.e.storeAligned( m_instanceData[k].data.rotation );
+				m_instanceData[k].data.scale = instance.scale;
 				m_instanceData[k].distance = cluster.distance;
 			}
 
@@ -223,7 +355,11 @@ void RubbleComponent::build(
 void RubbleComponent::updatePatches()
 {
 	m_instances.resize(0);
+	m_visibleInstances.resize(0);
 	m_clusters.resize(0);
+	m_clusterX.resize(0);
+	m_clusterY.resize(0);
+	m_clusterZ.resize(0);
 
 	auto terrainComponent = m_owner->getComponent< TerrainComponent >();
 	if (!terrainComponent)
@@ -307,12 +443,24 @@ void RubbleComponent::updatePatches()
 					c.seed = (int32_t)random.next();
 					c.from = from;
 					c.to = to;
+					c.visibleFrom = 0;
+					c.visibleTo = 0;
 					c.visible = false;
+					c.inside = false;
+
+					m_clusterX.push_back(wx);
+					m_clusterY.push_back(wy);
+					m_clusterZ.push_back(wz);
 				}
 			}
 		}
 	}
 
+	const size_t paddedClusterCount = alignUp(m_clusters.size(), 4);
+	m_clusterX.resize(paddedClusterCount, 0.0f);
+	m_clusterY.resize(paddedClusterCount, 0.0f);
+	m_clusterZ.resize(paddedClusterCount, 0.0f);
+
 	// Move last eye position, forces rescatter of visible clusters.
 	m_eye = Vector4::zero();
 }
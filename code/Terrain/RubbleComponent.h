@@ -12,6 +12,7 @@
 #include "Core/Math/Vector4.h"
 #include "Mesh/Instance/InstanceMesh.h"
 #include "Resource/Proxy.h"
+#include "Terrain/LayerCuller.h"
 #include "Terrain/TerrainLayerComponent.h"
 #include "Terrain/RubbleComponentData.h"
 
@@ -61,6 +62,8 @@ public:
 
 	virtual void updatePatches() override final;
 
+	const LayerCullStatistics& getCullStatistics() const { return m_statistics; }
+
 private:
 	struct RubbleMesh
 	{
@@ -87,7 +90,10 @@ private:
 		int32_t seed;
 		int32_t from;
 		int32_t to;
+		int32_t visibleFrom;	//!< Range of visible instances.
+		int32_t visibleTo;
 		bool visible;
+		bool inside;			//!< Cluster completely inside frustum, no need to cull instances.
 	};
 
 	world::Entity* m_owner = nullptr;
@@ -95,9 +101,16 @@ private:
 	AlignedVector< RubbleMesh > m_rubble;
 	AlignedVector< Instance > m_instances;
 	AlignedVector< Cluster > m_clusters;
+	AlignedVector< float > m_clusterX;			//!< Cluster centers, padded to be read four at a time.
+	AlignedVector< float > m_clusterY;
+	AlignedVector< float > m_clusterZ;
+	AlignedVector< int32_t > m_scatterClusters;
+	AlignedVector< int32_t > m_visibleInstances;	//!< Indices of visible instances, grouped by cluster.
 	float m_clusterSize = 0.0f;
 	Vector4 m_eye = Vector4::zero();
 	Vector4 m_fwd = Vector4::zero();
+	LayerCullStatistics m_statistics;
+	LayerCullMetrics m_cullMetrics = LayerCullMetrics(L"Rubble");
 	//AlignedVector< mesh::InstanceMesh::RenderInstance > m_instanceData;
 };
 
@@ -6,12 +6,16 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstring>
 #include <limits>
 #include "Core/Containers/StaticVector.h"
 #include "Core/Log/Log.h"
 #include "Core/Math/Half.h"
 #include "Core/Math/Quasirandom.h"
 #include "Core/Math/RandomGeometry.h"
+#include "Core/Misc/Align.h"
+#include "Core/System/OS.h"
+#include "Core/Thread/JobManager.h"
 #include "Heightfield/Heightfield.h"
 #include "Resource/IResourceManager.h"
 #include "Render/Buffer.h"
@@ -34,6 +38,9 @@ namespace traktor::terrain
 	{
 
 const int32_t c_maxInstanceCount = 180;
+const int32_t c_minInstancesPerJob = 4096;	//!< Minimum number of plants to generate on each job.
+const uint32_t c_maxPlantJobs = 8;
+const float c_plantRadius = 2.0f;			//!< Radius of plant bounds relative to plant scale, conservative since plants sway in wind.
 
 #pragma pack(1)
 struct Vertex
@@ -191,6 +198,7 @@ void UndergrowthComponent::build(
 		return;
 
 	const auto& terrain = terrainComponent->getTerrain();
+	const auto& heightfield = terrain->getHeightfield();
 
 	// Update clusters at first pass from eye pow.
 	bool updateClusters = (bool)((worldRenderPass.getPassFlags() & world::IWorldRenderPass::First) != 0);
@@ -213,47 +221,151 @@ void UndergrowthComponent::build(
 		Frustum viewFrustum = worldRenderView.getViewFrustum();
 		viewFrustum.setFarZ(Scalar(m_layerData.m_spreadDistance + m_clusterSize));
 
-		vs.drawInstanceCount = 0;
+		const LayerCuller culler(viewFrustum, view);
+		const Vector4 clusterRadius = Vector4(Scalar(m_clusterSize));
 
-		PlantData* plantData = (PlantData*)vs.plantBuffer->lock();
-		int32_t* orderPtr = (int32_t*)vs.orderBuffer->lock();
+		// Cull clusters, four at a time.
+		m_visibleClusters.resize(0);
 
-		// Only perform "replanting" half of clusters each frame.
-		const Scalar clusterSize(m_clusterSize);
-		//for (uint32_t i = vs.count % 2; i < m_clusters.size(); i += 2)
-		for (uint32_t i = 0; i < m_clusters.size(); ++i)
+		int32_t candidateInstanceCount = 0;
+		uint32_t testedInstanceCount = 0;
+		for (int32_t i = 0; i < (int32_t)m_clusters.size(); i += 4)
 		{
-			const Cluster& cluster = m_clusters[i];
+			Vector4 viewZ;
+			uint32_t inside;
+			uint32_t visible = culler.cull4(
+				Vector4::loadAligned(&m_clusterX[i]),
+				Vector4::loadAligned(&m_clusterY[i]),
+				Vector4::loadAligned(&m_clusterZ[i]),
+				clusterRadius,
+				viewZ,
+				inside
+			);
+			visible &= (1 << std::min< int32_t >((int32_t)m_clusters.size() - i, 4)) - 1;
+
+			for (int32_t j = 0; j < 4; ++j)
+			{
+				if ((visible & (1 << j)) == 0)
+					continue;
 
-			if (viewFrustum.inside(view * cluster.center, clusterSize) == Frustum::Result::Outside)
-				continue;
+				const Cluster& cluster = m_clusters[i + j];
+				const bool clusterInside = (inside & (1 << j)) != 0;
+				m_visibleClusters.push_back({ i + j, candidateInstanceCount, 0, clusterInside });
+				candidateInstanceCount += cluster.to - cluster.from;
+				if (!clusterInside)
+					testedInstanceCount += cluster.to - cluster.from;
+			}
+		}
 
-			RandomGeometry random(int32_t(cluster.center.x() * 919.0f + cluster.center.z() * 463.0f));
-			for (int32_t j = cluster.from; j < cluster.to; ++j)
+		m_order.resize(candidateInstanceCount);
+
+		PlantData* plantData = (PlantData*)vs.plantBuffer->lock();
+
+		// Generate plants of visible clusters, each cluster write to it's own range of plants.
+		// Plants of clusters partially inside frustum are culled individually, four at a time.
+		auto plantClusters = [&](int32_t from, int32_t to) {
+			T_MATH_ALIGN16 float bx[4];
+			T_MATH_ALIGN16 float by[4];
+			T_MATH_ALIGN16 float bz[4];
+			T_MATH_ALIGN16 float br[4];
+
+			for (int32_t i = from; i < to; ++i)
 			{
-				const Vector2 ruv = Quasirandom::hammersley(j - cluster.from, cluster.to - cluster.from, random);
+				VisibleCluster& visibleCluster = m_visibleClusters[i];
+				const Cluster& cluster = m_clusters[visibleCluster.cluster];
+				int32_t* orderBase = m_order.ptr() + visibleCluster.offset;
+				int32_t* orderPtr = orderBase;
+
+				RandomGeometry random(int32_t(cluster.center.x() * 919.0f + cluster.center.z() * 463.0f));
+				for (int32_t j = cluster.from; j < cluster.to; ++j)
+				{
+					const Vector2 ruv = Quasirandom::hammersley(j - cluster.from, cluster.to - cluster.from, random);
+
+					const float dx = (ruv.x * 2.2f - 1.1f) * m_clusterSize;
+					const float dz = (ruv.y * 2.2f - 1.1f) * m_clusterSize;
+
+					const float px = cluster.center.x() + dx;
+					const float pz = cluster.center.z() + dz;
+
+					auto& pd = plantData[j];
+					pd.positionX = px;
+					pd.positionZ = pz;
+					pd.plant = float(cluster.plant);
+					pd.scale = cluster.plantScale * (random.nextFloat() * 0.5f + 0.5f);
+					pd.random = random.nextFloat();
 
-				const float dx = (ruv.x * 2.2f - 1.1f) * m_clusterSize;
-				const float dz = (ruv.y * 2.2f - 1.1f) * m_clusterSize;
+					if (visibleCluster.inside)
+					{
+						*orderPtr++ = j;
+						continue;
+					}
 
-				const float px = cluster.center.x() + dx;
-				const float pz = cluster.center.z() + dz;
+					const int32_t lane = (j - cluster.from) & 3;
+					bx[lane] = px;
+					by[lane] = heightfield->getWorldHeight(px, pz);
+					bz[lane] = pz;
+					br[lane] = pd.scale * c_plantRadius;
 
-				auto& pd = plantData[j];
-				pd.positionX = px;
-				pd.positionZ = pz;
-				pd.plant = float(cluster.plant);
-				pd.scale = cluster.plantScale * (random.nextFloat() * 0.5f + 0.5f);
-				pd.random = random.nextFloat();
+					if (lane == 3 || j == cluster.to - 1)
+					{
+						Vector4 viewZ;
+						uint32_t inside;
+						const uint32_t visible = culler.cull4(
+							Vector4::loadAligned(bx),
+							Vector4::loadAligned(by),
+							Vector4::loadAligned(bz),
+							Vector4::loadAligned(br),
+							viewZ,
+							inside
+						);
+						for (int32_t k = 0; k <= lane; ++k)
+						{
+							if ((visible & (1 << k)) != 0)
+								*orderPtr++ = j - lane + k;
+						}
+					}
+				}
 
-				*orderPtr++ = j;
+				visibleCluster.count = (int32_t)(orderPtr - orderBase);
 			}
+		};
 
-			vs.drawInstanceCount += cluster.to - cluster.from;
+		const int32_t visibleClusterCount = (int32_t)m_visibleClusters.size();
+		const uint32_t jobCount = clamp< uint32_t >(candidateInstanceCount / c_minInstancesPerJob, 1, std::min< uint32_t >(OS::getInstance().getCPUCoreCount(), c_maxPlantJobs));
+		if (jobCount > 1)
+		{
+			StaticVector< Job::task_t, c_maxPlantJobs > jobs;
+			for (uint32_t i = 0; i < jobCount; ++i)
+			{
+				const int32_t from = (visibleClusterCount * i) / jobCount;
+				const int32_t to = (visibleClusterCount * (i + 1)) / jobCount;
+				jobs.push_back([=, &plantClusters](){ plantClusters(from, to); });
+			}
+			JobManager::getInstance().fork(jobs.c_ptr(), jobs.size());
 		}
+		else
+			plantClusters(0, visibleClusterCount);
 
 		vs.plantBuffer->unlock();
+
+		// Compact order of visible plants into order buffer.
+		int32_t* order = (int32_t*)vs.orderBuffer->lock();
+		int32_t drawInstanceCount = 0;
+		for (const auto& visibleCluster : m_visibleClusters)
+		{
+			std::memcpy(order + drawInstanceCount, m_order.c_ptr() + visibleCluster.offset, visibleCluster.count * sizeof(int32_t));
+			drawInstanceCount += visibleCluster.count;
+		}
 		vs.orderBuffer->unlock();
+
+		vs.drawInstanceCount = drawInstanceCount;
+
+		m_statistics.clusters = (uint32_t)m_clusters.size();
+		m_statistics.visibleClusters = (uint32_t)visibleClusterCount;
+		m_statistics.instances = m_plantsCount;
+		m_statistics.testedInstances = testedInstanceCount;
+		m_statistics.visibleInstances = (uint32_t)drawInstanceCount;
+		m_cullMetrics.report(m_statistics);
 	}
 
 	auto sp = worldRenderPass.getProgram(m_shader);
@@ -298,6 +410,9 @@ void UndergrowthComponent::build(
 void UndergrowthComponent::updatePatches()
 {
 	m_clusters.resize(0);
+	m_clusterX.resize(0);
+	m_clusterY.resize(0);
+	m_clusterZ.resize(0);
 	m_plantsCount = 0;
 
 	auto terrainComponent = m_owner->getComponent< TerrainComponent >();
@@ -377,12 +492,21 @@ void UndergrowthComponent::updatePatches()
 						c.to = to;
 						m_clusters.push_back(c);
 
+						m_clusterX.push_back(wx);
+						m_clusterY.push_back(wy);
+						m_clusterZ.push_back(wz);
+
 						m_plantsCount = to;
 					}
 				}
 			}
 		}
 	}
+
+	const size_t paddedClusterCount = alignUp(m_clusters.size(), 4);
+	m_clusterX.resize(paddedClusterCount, 0.0f);
+	m_clusterY.resize(paddedClusterCount, 0.0f);
+	m_clusterZ.resize(paddedClusterCount, 0.0f);
 }
 
 }
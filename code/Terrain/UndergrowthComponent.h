@@ -12,6 +12,7 @@
 #include "Core/Math/Vector4.h"
 #include "Core/Thread/SpinLock.h"
 #include "Resource/Proxy.h"
+#include "Terrain/LayerCuller.h"
 #include "Terrain/TerrainLayerComponent.h"
 #include "Terrain/UndergrowthComponentData.h"
 
@@ -64,6 +65,8 @@ public:
 
 	virtual void updatePatches() override final;
 
+	const LayerCullStatistics& getCullStatistics() const { return m_statistics; }
+
 private:
 	struct Cluster
 	{
@@ -74,6 +77,14 @@ private:
 		int32_t to;
 	};
 
+	struct VisibleCluster
+	{
+		int32_t cluster;
+		int32_t offset;		//!< Offset into order of visible plants.
+		int32_t count;		//!< Number of visible plants in cluster.
+		bool inside;		//!< Cluster completely inside frustum, no need to cull plants.
+	};
+
 	struct ViewState
 	{
 		Ref< render::Buffer > plantBuffer;
@@ -89,9 +100,16 @@ private:
 	Ref< render::Buffer > m_indexBuffer;
 	resource::Proxy< render::Shader > m_shader;
 	AlignedVector< Cluster > m_clusters;
+	AlignedVector< float > m_clusterX;			//!< Cluster centers, padded to be read four at a time.
+	AlignedVector< float > m_clusterY;
+	AlignedVector< float > m_clusterZ;
+	AlignedVector< VisibleCluster > m_visibleClusters;
+	AlignedVector< int32_t > m_order;			//!< Visible plants of each visible cluster, compacted into order buffer.
 	SmallMap< int32_t, ViewState > m_viewState;
 	float m_clusterSize = 0.0f;
 	uint32_t m_plantsCount = 0;
+	LayerCullStatistics m_statistics;
+	LayerCullMetrics m_cullMetrics = LayerCullMetrics(L"Undergrowth");
 };
 
 }
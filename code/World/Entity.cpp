@@ -8,6 +8,7 @@
  */
 #include "World/Entity.h"
 #include "World/IEntityComponent.h"
+#include "World/World.h"
 
 namespace traktor::world
 {
@@ -113,16 +114,20 @@ void Entity::setComponent(IEntityComponent* component)
 	component->setTransform(m_transform);
 
 	// Replace existing component of same type.
-	for (auto comp : m_components)
+	for (size_t i = 0; i < m_components.size(); ++i)
 	{
-		if (is_type_of(type_of(comp), type_of(component)))
+		if (is_type_of(type_of(m_components[i]), type_of(component)))
 		{
-			comp = component;
+			if (m_world != nullptr)
+				m_world->replaceComponent(this, m_components[i], component);
+			m_components[i] = component;
 			return;
 		}
 	}
 
 	// No such component, add last.
+	if (m_world != nullptr)
+		m_world->replaceComponent(this, nullptr, component);
 	m_components.push_back(component);
 }
 
@@ -6,8 +6,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <cstring>
+#include <limits>
+#include "Core/Containers/AlignedVector.h"
 #include "Core/Math/Range.h"
+#include "Core/Misc/Align.h"
 #include "Core/Misc/SafeDestroy.h"
+#include "Core/Thread/JobManager.h"
 #include "Core/Timer/Profiler.h"
 #include "Render/Buffer.h"
 #include "Render/IRenderSystem.h"
@@ -17,6 +22,39 @@
 
 namespace traktor::world
 {
+	namespace
+	{
+
+const float c_infinite = std::numeric_limits< float >::max();
+const Vector4 c_laneBits(1.0f, 2.0f, 4.0f, 8.0f);
+
+/*! View space bounds of a light. */
+struct LightBounds
+{
+	Vector4 position;
+	float range;
+	Range< float > sphereZ;	//!< Depth range of light sphere.
+	Range< float > boundZ;	//!< Depth range of light volume, ie. cone of spot lights.
+	int32_t index;
+};
+
+/*! Four lights in SoA layout. */
+struct LightGroup
+{
+	float T_ALIGN16 x[4];
+	float T_ALIGN16 y[4];
+	float T_ALIGN16 z[4];
+	float T_ALIGN16 range[4];
+	int32_t index[4];
+};
+
+/*! Side plane normals of a tile, all planes pass through origin. */
+struct TilePlanes
+{
+	Vector4 normals[4];
+};
+
+	}
 
 T_IMPLEMENT_RTTI_CLASS(L"traktor.world.LightClusterPass", LightClusterPass, Object)
 
@@ -68,25 +106,74 @@ void LightClusterPass::setup(
 	TileShaderData* tileShaderData = (TileShaderData*)m_tileSBuffer->lock();
 	LightIndexShaderData* lightIndexShaderData = (LightIndexShaderData*)m_lightIndexSBuffer->lock();
 
-	StaticVector< Vector4, c_maxLightCount > lightPositions;
-	StaticVector< int32_t, c_maxLightCount > sliceLights;
+	// Calculate view space bounds of lights, these are independent of slice so
+	// we only need to calculate them once, in particular bounds of spot cones.
+	AlignedVector< LightBounds > lightBounds;
+	lightBounds.reserve(gatheredView.lights.size());
 
-	// Calculate positions of lights in view space.
-	for (const auto& light : gatheredView.lights)
+	for (uint32_t i = 0; i < gatheredView.lights.size(); ++i)
 	{
-		if (light)
+		const auto light = gatheredView.lights[i];
+		if (light == nullptr || light->getLightType() == LightType::Disabled)
+			continue;
+
+		LightBounds& lb = lightBounds.push_back();
+		lb.index = (int32_t)i;
+
+		if (light->getLightType() == LightType::Directional)
+		{
+			// Directional lights affect all clusters.
+			lb.position = Vector4::zero();
+			lb.range = c_infinite;
+			lb.sphereZ = Range< float >(-c_infinite, c_infinite);
+			lb.boundZ = Range< float >(-c_infinite, c_infinite);
+		}
+		else if (light->getLightType() == LightType::Point)
 		{
 			const Vector4 lightPosition = light->getTransform().translation().xyz1();
-			lightPositions.push_back(worldRenderView.getView() * lightPosition);
+			lb.position = worldRenderView.getView() * lightPosition;
+			lb.range = light->getFarRange();
+
+			const float lz = lb.position.z();
+			lb.sphereZ = Range< float >(lz - lb.range, lz + lb.range);
+			lb.boundZ = lb.sphereZ;
+		}
+		else if (light->getLightType() == LightType::Spot)
+		{
+			const Vector4 lightPosition = light->getTransform().translation().xyz1();
+			lb.position = worldRenderView.getView() * lightPosition;
+			lb.range = light->getFarRange();
+
+			const float lz = lb.position.z();
+			lb.sphereZ = Range< float >(lz - lb.range, lz + lb.range);
+
+			Frustum spotFrustum;
+			spotFrustum.buildPerspective(light->getRadius(), 1.0f, 0.0f, lb.range);
+
+			const Matrix44 lmt = worldRenderView.getView() * light->getTransform().toMatrix44() * rotateX(deg2rad(90.0f));
+
+			lb.boundZ = Range< float >(lz, lz);
+			for (int32_t j = 4; j < 8; ++j)
+			{
+				const float z = (lmt * spotFrustum.corners[j].xyz1()).z();
+				lb.boundZ.min = std::min(lb.boundZ.min, z);
+				lb.boundZ.max = std::max(lb.boundZ.max, z);
+			}
 		}
-		else
-			lightPositions.push_back(Vector4::zero());
 	}
 
-	// Update tile data.
+	// No lights, no need to bin anything.
+	if (lightBounds.empty())
+	{
+		std::memset(tileShaderData, 0, ClusterDimXY * ClusterDimXY * ClusterDimZ * sizeof(TileShaderData));
+		m_lightIndexSBuffer->unlock();
+		m_tileSBuffer->unlock();
+		return;
+	}
+
+	// Calculate XY tile planes, all planes pass through view origin.
 	const Scalar dx(1.0f / ClusterDimXY);
 	const Scalar dy(1.0f / ClusterDimXY);
-	const Scalar dz(1.0f / ClusterDimZ);
 
 	const Vector4& tl = viewFrustum.corners[0];
 	const Vector4& tr = viewFrustum.corners[1];
@@ -98,8 +185,7 @@ void LightClusterPass::setup(
 	const Scalar vnz = viewFrustum.getNearZ();
 	const Scalar vfz = viewFrustum.getFarZ();
 
-	// Calculate XY tile frustums.
-	Frustum tileFrustums[ClusterDimXY * ClusterDimXY];
+	TilePlanes tilePlanes[ClusterDimXY * ClusterDimXY];
 	for (int32_t y = 0; y < ClusterDimXY; ++y)
 	{
 		const Scalar fy = Scalar((float)y) * dy;
@@ -112,131 +198,106 @@ void LightClusterPass::setup(
 			const Vector4 c = tl + vx * (fx + dx) + vy * (fy + dy);
 			const Vector4 d = tl + vx * fx + vy * (fy + dy);
 
-			auto& tileFrustum = tileFrustums[x + y * ClusterDimXY];
-			tileFrustum.planes[Frustum::Left] = Plane(Vector4::zero(), d, a);
-			tileFrustum.planes[Frustum::Right] = Plane(Vector4::zero(), b, c);
-			tileFrustum.planes[Frustum::Bottom] = Plane(Vector4::zero(), c, d);
-			tileFrustum.planes[Frustum::Top] = Plane(Vector4::zero(), a, b);
+			auto& tp = tilePlanes[x + y * ClusterDimXY];
+			tp.normals[0] = Plane(Vector4::zero(), d, a).normal();
+			tp.normals[1] = Plane(Vector4::zero(), b, c).normal();
+			tp.normals[2] = Plane(Vector4::zero(), c, d).normal();
+			tp.normals[3] = Plane(Vector4::zero(), a, b).normal();
 		}
 	}
 
-	// Group lights per cluster.
-	uint32_t lightOffset = 0;
-	for (int32_t z = 0; z < ClusterDimZ; ++z)
+	// Each slice is binned by its own job; each tile has a fixed range of
+	// MaxLightsPerCluster entries in light index buffer so jobs never overlap.
+	const uint32_t groupCount = (uint32_t)(lightBounds.size() + 3) / 4;
+	AlignedVector< LightGroup > lightGroups(ClusterDimZ * groupCount);
+
+	auto binSlice = [&](int32_t z)
 	{
 		const float fz = (float)z;
-		const Scalar snz = vnz * power(vfz / vnz, Scalar(fz) / Scalar(ClusterDimZ));
-		const Scalar sfz = vnz * power(vfz / vnz, Scalar(fz + 1.0f) / Scalar(ClusterDimZ));
+		const float snz = vnz * power(vfz / vnz, Scalar(fz) / Scalar(ClusterDimZ));
+		const float sfz = vnz * power(vfz / vnz, Scalar(fz + 1.0f) / Scalar(ClusterDimZ));
 
-		// Gather all lights intersecting slice.
-		sliceLights.clear();
-		for (uint32_t i = 0; i < gatheredView.lights.size(); ++i)
-		{
-			const auto light = gatheredView.lights[i];
-			if (light == nullptr)
-				continue;
+		// Gather all lights intersecting slice into groups of four, SoA layout.
+		LightGroup* groups = &lightGroups[z * groupCount];
+		uint32_t sliceLightCount = 0;
 
-			if (light->getLightType() == LightType::Directional)
-			{
-				sliceLights.push_back(i);
-			}
-			else if (light->getLightType() == LightType::Point)
-			{
-				const Scalar lr = light->getFarRange();
-				const Scalar lz = lightPositions[i].z();
-				if (lz + lr >= snz && lz - lr <= sfz)
-					sliceLights.push_back(i);
-			}
-			else if (light->getLightType() == LightType::Spot)
+		for (const auto& lb : lightBounds)
+		{
+			if (
+				lb.sphereZ.max >= snz && lb.sphereZ.min <= sfz &&
+				lb.boundZ.max >= snz && lb.boundZ.min <= sfz
+			)
 			{
-				const Scalar lr = light->getFarRange();
-				const Scalar lz = lightPositions[i].z();
-				if (lz + lr >= snz && lz - lr <= sfz)
-				{
-					Frustum spotFrustum;
-					spotFrustum.buildPerspective(light->getRadius(), 1.0f, 0.0f, lr);
-
-					Matrix44 lmt = light->getTransform().toMatrix44() * rotateX(deg2rad(90.0f));
-
-					Vector4 fr[4] =
-					{
-						lmt * spotFrustum.corners[4],
-						lmt * spotFrustum.corners[5],
-						lmt * spotFrustum.corners[6],
-						lmt * spotFrustum.corners[7]
-					};
-
-					Vector4 p[5];
-					p[0] = lightPositions[i];
-					p[1] = worldRenderView.getView() * fr[0].xyz1();
-					p[2] = worldRenderView.getView() * fr[1].xyz1();
-					p[3] = worldRenderView.getView() * fr[2].xyz1();
-					p[4] = worldRenderView.getView() * fr[3].xyz1();
-
-					Range< Scalar > bb;
-					bb.min = lz;
-					bb.max = lz;
-					for (int i = 0; i < 5; ++i)
-					{
-						bb.min = min(bb.min, p[i].z());
-						bb.max = max(bb.max, p[i].z());
-					}
-					if (Range< Scalar >::intersection(bb, Range< Scalar >(snz, sfz)).delta() >= 0.0_simd)
-						sliceLights.push_back(i);
-				}
+				auto& group = groups[sliceLightCount / 4];
+				const uint32_t lane = sliceLightCount % 4;
+				group.x[lane] = lb.position.x();
+				group.y[lane] = lb.position.y();
+				group.z[lane] = lb.position.z();
+				group.range[lane] = lb.range;
+				group.index[lane] = lb.index;
+				++sliceLightCount;
 			}
 		}
 
-		if (sliceLights.empty())
-			continue;
+		// Pad last group with lights which are always outside.
+		for (uint32_t i = sliceLightCount; i < alignUp(sliceLightCount, 4); ++i)
+		{
+			auto& group = groups[i / 4];
+			const uint32_t lane = i % 4;
+			group.x[lane] = 0.0f;
+			group.y[lane] = 0.0f;
+			group.z[lane] = 0.0f;
+			group.range[lane] = -c_infinite;
+			group.index[lane] = -1;
+		}
+
+		const uint32_t sliceGroupCount = (sliceLightCount + 3) / 4;
 
-		for (int32_t y = 0; y < ClusterDimXY; ++y)
+		// Near and far planes of tile frustum are already culled by slice
+		// so only need to test lights against side planes of each tile.
+		for (int32_t i = 0; i < ClusterDimXY * ClusterDimXY; ++i)
 		{
-			for (int32_t x = 0; x < ClusterDimXY; ++x)
-			{
-				auto& tileFrustum = tileFrustums[x + y * ClusterDimXY];
-				tileFrustum.planes[Frustum::Near] = Plane(Vector4(0.0f, 0.0f, 1.0f), snz);
-				tileFrustum.planes[Frustum::Far] = Plane(Vector4(0.0f, 0.0f, -1.0f), -sfz);
+			const auto& tp = tilePlanes[i];
+			const Scalar nx[] = { tp.normals[0].x(), tp.normals[1].x(), tp.normals[2].x(), tp.normals[3].x() };
+			const Scalar ny[] = { tp.normals[0].y(), tp.normals[1].y(), tp.normals[2].y(), tp.normals[3].y() };
+			const Scalar nz[] = { tp.normals[0].z(), tp.normals[1].z(), tp.normals[2].z(), tp.normals[3].z() };
+
+			const uint32_t tileOffset = i + z * ClusterDimXY * ClusterDimXY;
+			const uint32_t lightOffset = tileOffset * MaxLightsPerCluster;
 
-				int32_t count = 0;
-				for (uint32_t i = 0; i < sliceLights.size(); ++i)
+			int32_t count = 0;
+			for (uint32_t j = 0; j < sliceGroupCount && count < MaxLightsPerCluster; ++j)
+			{
+				const auto& group = groups[j];
+				const Vector4 gx = Vector4::loadAligned(group.x);
+				const Vector4 gy = Vector4::loadAligned(group.y);
+				const Vector4 gz = Vector4::loadAligned(group.z);
+				const Vector4 gr = Vector4::loadAligned(group.range);
+
+				// Light sphere is outside tile if distance to any plane is less than -range.
+				Vector4 margin = gx * nx[0] + gy * ny[0] + gz * nz[0];
+				margin = min(margin, gx * nx[1] + gy * ny[1] + gz * nz[1]);
+				margin = min(margin, gx * nx[2] + gy * ny[2] + gz * nz[2]);
+				margin = min(margin, gx * nx[3] + gy * ny[3] + gz * nz[3]);
+				margin += gr;
+
+				const int32_t mask = (int32_t)(float)horizontalAdd4(select(margin, Vector4::zero(), c_laneBits));
+				for (int32_t k = 0; k < 4 && count < MaxLightsPerCluster; ++k)
 				{
-					const int32_t lightIndex = sliceLights[i];
-					const auto light = gatheredView.lights[lightIndex];
-					if (light->getLightType() == LightType::Directional)
-					{
-						lightIndexShaderData[lightOffset + count].lightIndex[0] = lightIndex;
-						++count;
-					}
-					else if (light->getLightType() == LightType::Point)
-					{
-						if (tileFrustum.inside(lightPositions[lightIndex], light->getFarRange()) != Frustum::Result::Outside)
-						{
-							lightIndexShaderData[lightOffset + count].lightIndex[0] = lightIndex;
-							++count;
-						}
-					}
-					else if (light->getLightType() == LightType::Spot)
-					{
-						// \fixme Implement frustum to frustum culling.
-						if (tileFrustum.inside(lightPositions[lightIndex], light->getFarRange()) != Frustum::Result::Outside)
-						{
-							lightIndexShaderData[lightOffset + count].lightIndex[0] = lightIndex;
-							++count;
-						}
-					}
-					if (count >= MaxLightsPerCluster)
-						break;
+					if ((mask & (1 << k)) != 0)
+						lightIndexShaderData[lightOffset + count++].lightIndex[0] = group.index[k];
 				}
-
-				const uint32_t tileOffset = x + y * ClusterDimXY + z * ClusterDimXY * ClusterDimXY;
-				tileShaderData[tileOffset].lightOffsetAndCount[0] = (int32_t)lightOffset;
-				tileShaderData[tileOffset].lightOffsetAndCount[1] = count;
-
-				lightOffset += count;
 			}
+
+			tileShaderData[tileOffset].lightOffsetAndCount[0] = (int32_t)lightOffset;
+			tileShaderData[tileOffset].lightOffsetAndCount[1] = count;
 		}
-	}
+	};
+
+	Job::task_t jobs[ClusterDimZ];
+	for (int32_t z = 0; z < ClusterDimZ; ++z)
+		jobs[z] = [&, z](){ binSlice(z); };
+	JobManager::getInstance().fork(jobs, sizeof_array(jobs));
 
 	m_lightIndexSBuffer->unlock();
 	m_tileSBuffer->unlock();
@@ -224,31 +224,46 @@ void WorldRendererShared::gather(const World* world, const std::function< bool(c
 			m_gatheredView.irradianceGrid = irradianceGridComponent->getIrradianceGrid();
 	}
 
-	for (auto entity : world->getEntities())
+	// Iterate components grouped by type, so we only need to find renderer and
+	// classify once per type instead of once per component.
+	for (const auto& it : world->getRegisteredComponents())
 	{
-		const EntityState state = entity->getState();
-
-		if (filter != nullptr && filter(state) == false)
+		const TypeInfo& componentType = *it.first;
+		const auto& components = it.second;
+		if (components.empty())
 			continue;
-		else if (filter == nullptr && state.visible == false)
+
+		IEntityRenderer* entityRenderer = m_entityRenderers->find(componentType);
+		const bool light = is_type_of(type_of< LightComponent >(), componentType);
+		const bool probe = !light && is_type_of(type_of< ProbeComponent >(), componentType);
+		const bool fog = !light && !probe && is_type_of(type_of< FogComponent >(), componentType);
+
+		if (!entityRenderer && !light && !probe && !fog)
 			continue;
 
-		for (auto component : entity->getComponents())
+		for (const auto& rc : components)
 		{
-			IEntityRenderer* entityRenderer = m_entityRenderers->find(type_of(component));
+			const EntityState& state = rc.owner->getState();
+
+			if (filter != nullptr && filter(state) == false)
+				continue;
+			else if (filter == nullptr && state.visible == false)
+				continue;
+
 			if (entityRenderer)
-				m_gatheredView.renderables.push_back({ entityRenderer, component, state });
+				m_gatheredView.renderables.push_back({ entityRenderer, rc.component, state });
 
 			// Filter out components used to setup frame's lighting etc.
-			if (auto lightComponent = dynamic_type_cast< const LightComponent* >(component))
+			if (light)
 			{
+				auto lightComponent = static_cast< const LightComponent* >(rc.component);
 				if (lightComponent->getLightType() != LightType::Disabled && !lights.full())
 					lights.push_back(lightComponent);
 			}
-			else if (auto probeComponent = dynamic_type_cast< const ProbeComponent* >(component))
-				m_gatheredView.probes.push_back(probeComponent);
-			else if (auto fogComponent = dynamic_type_cast< const FogComponent* >(component))
-				m_gatheredView.fog = fogComponent;
+			else if (probe)
+				m_gatheredView.probes.push_back(static_cast< const ProbeComponent* >(rc.component));
+			else if (fog)
+				m_gatheredView.fog = static_cast< const FogComponent* >(rc.component);
 		}
 	}
 
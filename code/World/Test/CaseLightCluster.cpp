@@ -0,0 +1,211 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Core/Log/Log.h"
+#include "Core/Math/Random.h"
+#include "Core/Timer/Timer.h"
+#include "Render/Buffer.h"
+#include "Render/IRenderSystem.h"
+#include "World/Entity.h"
+#include "World/WorldRenderSettings.h"
+#include "World/WorldRenderView.h"
+#include "World/Entity/LightComponent.h"
+#include "World/Shared/Passes/LightClusterPass.h"
+#include "World/Test/CaseLightCluster.h"
+
+namespace traktor::world::test
+{
+	namespace
+	{
+
+/*! System memory buffer, content readable by test after setup. */
+class BufferMemory : public render::Buffer
+{
+public:
+	explicit BufferMemory(uint32_t bufferSize)
+	:	render::Buffer(bufferSize)
+	,	m_data(bufferSize, 0)
+	{
+	}
+
+	virtual void destroy() override {}
+
+	virtual void* lock() override { return m_data.ptr(); }
+
+	virtual void unlock() override {}
+
+	virtual const render::IBufferView* getBufferView() const override { return nullptr; }
+
+	const uint8_t* getData() const { return m_data.c_ptr(); }
+
+private:
+	AlignedVector< uint8_t > m_data;
+};
+
+/*! Render system which only create memory buffers. */
+class RenderSystemMemory : public render::IRenderSystem
+{
+public:
+	virtual bool create(const render::RenderSystemDesc& desc) override { return true; }
+
+	virtual void destroy() override {}
+
+	virtual bool reset(const render::RenderSystemDesc& desc) override { return true; }
+
+	virtual void getInformation(render::RenderSystemInformation& outInfo) const override {}
+
+	virtual uint32_t getDisplayCount() const override { return 0; }
+
+	virtual uint32_t getDisplayModeCount(uint32_t display) const override { return 0; }
+
+	virtual render::DisplayMode getDisplayMode(uint32_t display, uint32_t index) const override { return render::DisplayMode(); }
+
+	virtual render::DisplayMode getCurrentDisplayMode(uint32_t display) const override { return render::DisplayMode(); }
+
+	virtual float getDisplayAspectRatio(uint32_t display) const override { return 0.0f; }
+
+	virtual Ref< render::IRenderView > createRenderView(const render::RenderViewDefaultDesc& desc) override { return nullptr; }
+
+	virtual Ref< render::IRenderView > createRenderView(const render::RenderViewEmbeddedDesc& desc) override { return nullptr; }
+
+	virtual Ref< render::Buffer > createBuffer(uint32_t usage, uint32_t bufferSize, bool dynamic) override { return new BufferMemory(bufferSize); }
+
+	virtual Ref< const render::IVertexLayout > createVertexLayout(const AlignedVector< render::VertexElement >& vertexElements) override { return nullptr; }
+
+	virtual Ref< render::ITexture > createSimpleTexture(const render::SimpleTextureCreateDesc& desc, const wchar_t* const tag) override { return nullptr; }
+
+	virtual Ref< render::ITexture > createCubeTexture(const render::CubeTextureCreateDesc& desc, const wchar_t* const tag) override { return nullptr; }
+
+	virtual Ref< render::ITexture > createVolumeTexture(const render::VolumeTextureCreateDesc& desc, const wchar_t* const tag) override { return nullptr; }
+
+	virtual Ref< render::IRenderTargetSet > createRenderTargetSet(const render::RenderTargetSetCreateDesc& desc, render::IRenderTargetSet* sharedDepthStencil, const wchar_t* const tag) override { return nullptr; }
+
+	virtual Ref< render::IProgram > createProgram(const render::ProgramResource* programResource, const wchar_t* const tag) override { return nullptr; }
+
+	virtual void purge() override {}
+
+	virtual void getStatistics(render::RenderSystemStatistics& outStatistics) const override {}
+
+	virtual void* getInternalHandle() const override { return nullptr; }
+};
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.world.test.CaseLightCluster", 0, CaseLightCluster, traktor::test::Case)
+
+void CaseLightCluster::run()
+{
+	const uint32_t tileCount = ClusterDimXY * ClusterDimXY * ClusterDimZ;
+
+	WorldRenderView worldRenderView;
+	worldRenderView.setPerspective(1920.0f, 1080.0f, 16.0f / 9.0f, deg2rad(70.0f), 0.1f, 200.0f);
+	worldRenderView.setView(Matrix44::identity(), Matrix44::identity());
+
+	RenderSystemMemory renderSystem;
+
+	const int32_t lightCounts[] = { 64, 256, 1024 };
+	for (int32_t lightCount : lightCounts)
+	{
+		Random random(1234);
+		RefArray< Entity > entities;
+		GatherView gatheredView;
+
+		// First light is directional, affect all clusters.
+		// Second light is a point light behind camera, affect no clusters.
+		for (int32_t i = 0; i < lightCount; ++i)
+		{
+			LightType lightType = (random.nextFloat() < 0.7f) ? LightType::Point : LightType::Spot;
+			Vector4 position(random.nextFloat() * 200.0f - 100.0f, random.nextFloat() * 100.0f - 50.0f, random.nextFloat() * 150.0f, 1.0f);
+			float range = 2.0f + random.nextFloat() * 10.0f;
+
+			if (i == 0)
+				lightType = LightType::Directional;
+			else if (i == 1)
+			{
+				lightType = LightType::Point;
+				position = Vector4(0.0f, 0.0f, -50.0f, 1.0f);
+				range = 2.0f;
+			}
+
+			Ref< LightComponent > light = new LightComponent(
+				lightType,
+				Vector4(1.0f, 1.0f, 1.0f, 1.0f),
+				false,
+				0.0f,
+				range,
+				deg2rad(20.0f + random.nextFloat() * 40.0f),
+				0.0f,
+				0.0f
+			);
+
+			RefArray< IEntityComponent > components;
+			components.push_back(light);
+			entities.push_back(new Entity(
+				Guid(),
+				L"",
+				Transform(position, Quaternion::fromEulerAngles(random.nextFloat() * 6.0f, random.nextFloat() * 6.0f, 0.0f)),
+				EntityState::All,
+				components
+			));
+
+			gatheredView.lights.push_back(light);
+		}
+
+		Ref< LightClusterPass > lightClusterPass = new LightClusterPass(WorldRenderSettings());
+		CASE_ASSERT(lightClusterPass->create(&renderSystem));
+
+		Timer timer;
+		double setupTime = 1e9;
+		for (int32_t i = 0; i < 20; ++i)
+		{
+			const double start = timer.getElapsedTime();
+			lightClusterPass->setup(worldRenderView, gatheredView);
+			setupTime = std::min(setupTime, timer.getElapsedTime() - start);
+		}
+
+		// Validate binned light lists.
+		const auto tiles = (const LightClusterPass::TileShaderData*)static_cast< BufferMemory* >(lightClusterPass->getTileSBuffer())->getData();
+		const auto lightIndices = (const LightClusterPass::LightIndexShaderData*)static_cast< BufferMemory* >(lightClusterPass->getLightIndexSBuffer())->getData();
+
+		int32_t binnedCount = 0;
+		bool valid = true;
+		for (uint32_t i = 0; i < tileCount; ++i)
+		{
+			const int32_t offset = tiles[i].lightOffsetAndCount[0];
+			const int32_t count = tiles[i].lightOffsetAndCount[1];
+
+			if (offset != (int32_t)(i * MaxLightsPerCluster) || count <= 0 || count > MaxLightsPerCluster)
+			{
+				valid = false;
+				continue;
+			}
+
+			// Directional light first in every tile, then ascending light order.
+			if (lightIndices[offset].lightIndex[0] != 0)
+				valid = false;
+
+			for (int32_t j = 1; j < count; ++j)
+			{
+				const int32_t lightIndex = lightIndices[offset + j].lightIndex[0];
+				if (lightIndex <= lightIndices[offset + j - 1].lightIndex[0] || lightIndex >= lightCount || lightIndex == 1)
+					valid = false;
+			}
+
+			binnedCount += count;
+		}
+		CASE_ASSERT(valid);
+		CASE_ASSERT(binnedCount > (int32_t)tileCount);
+
+		log::info << L"Light cluster " << lightCount << L" lights; setup " << int32_t(setupTime * 1000000.0) << L" us, binned " << binnedCount << Endl;
+
+		lightClusterPass->destroy();
+	}
+}
+
+}
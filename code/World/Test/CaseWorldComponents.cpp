@@ -0,0 +1,228 @@
+/*
+ * TRAKTOR
+ * Copyright (c) 2024 Anders Pistol.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+#include <algorithm>
+#include "Core/Log/Log.h"
+#include "Core/Timer/Timer.h"
+#include "World/Entity.h"
+#include "World/IEntityComponent.h"
+#include "World/World.h"
+#include "World/WorldTypes.h"
+#include "World/Test/CaseWorldComponents.h"
+
+namespace traktor::world::test
+{
+	namespace
+	{
+
+class ComponentA : public IEntityComponent
+{
+	T_RTTI_CLASS;
+
+public:
+	virtual void destroy() override {}
+
+	virtual void setOwner(Entity* owner) override { m_owner = owner; }
+
+	virtual void setTransform(const Transform& transform) override {}
+
+	virtual Aabb3 getBoundingBox() const override { return Aabb3(); }
+
+	virtual void update(const UpdateParams& update) override {}
+
+	Entity* m_owner = nullptr;
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.world.test.ComponentA", ComponentA, IEntityComponent)
+
+class ComponentB : public ComponentA
+{
+	T_RTTI_CLASS;
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.world.test.ComponentB", ComponentB, ComponentA)
+
+/*! Add and remove entities during update. */
+class ComponentMutate : public ComponentA
+{
+	T_RTTI_CLASS;
+
+public:
+	Ref< Entity > m_add;
+	Ref< Entity > m_remove;
+
+	virtual void update(const UpdateParams& update) override
+	{
+		World* world = m_owner->getWorld();
+		if (m_add)
+		{
+			world->addEntity(m_add);
+			m_add->setComponent(new ComponentB());
+		}
+		if (m_remove)
+		{
+			world->removeEntity(m_remove);
+			m_remove->setComponent(new ComponentB());
+		}
+	}
+};
+
+T_IMPLEMENT_RTTI_CLASS(L"traktor.world.test.ComponentMutate", ComponentMutate, ComponentA)
+
+Ref< Entity > createEntity(const RefArray< IEntityComponent >& components)
+{
+	return new Entity(Guid(), L"", Transform::identity(), EntityState::All, components);
+}
+
+Ref< Entity > createEntity(IEntityComponent* component)
+{
+	RefArray< IEntityComponent > components;
+	components.push_back(component);
+	return createEntity(components);
+}
+
+/*! Check registered components exactly match components of all entities in world. */
+bool validateRegistered(const World* world)
+{
+	uint32_t registeredCount = 0;
+	for (const auto& it : world->getRegisteredComponents())
+	{
+		for (const auto& rc : it.second)
+		{
+			if (&type_of(rc.component) != it.first)
+				return false;
+			if (rc.owner->getWorld() != world)
+				return false;
+			if (std::find(rc.owner->getComponents().begin(), rc.owner->getComponents().end(), rc.component) == rc.owner->getComponents().end())
+				return false;
+			++registeredCount;
+		}
+	}
+
+	uint32_t componentCount = 0;
+	for (auto entity : world->getEntities())
+		componentCount += (uint32_t)entity->getComponents().size();
+
+	return registeredCount == componentCount;
+}
+
+	}
+
+T_IMPLEMENT_RTTI_FACTORY_CLASS(L"traktor.world.test.CaseWorldComponents", 0, CaseWorldComponents, traktor::test::Case)
+
+void CaseWorldComponents::run()
+{
+	// Add, replace and remove.
+	{
+		Ref< World > world = new World(nullptr, nullptr);
+
+		Ref< Entity > entity = createEntity(new ComponentA());
+		world->addEntity(entity);
+		CASE_ASSERT(validateRegistered(world));
+
+		entity->setComponent(new ComponentA());
+		CASE_ASSERT(entity->getComponents().size() == 1);
+		CASE_ASSERT(validateRegistered(world));
+
+		entity->setComponent(new ComponentB());
+		CASE_ASSERT(entity->getComponents().size() == 1);
+		CASE_ASSERT(validateRegistered(world));
+
+		world->removeEntity(entity);
+		CASE_ASSERT(validateRegistered(world));
+
+		world->destroy();
+	}
+
+	// Entities added and removed during update are registered when actually added or removed.
+	{
+		Ref< World > world = new World(nullptr, nullptr);
+
+		Ref< ComponentMutate > mutate = new ComponentMutate();
+		mutate->m_add = createEntity(new ComponentA());
+		mutate->m_remove = createEntity(new ComponentA());
+
+		world->addEntity(createEntity(mutate));
+		world->addEntity(mutate->m_remove);
+		CASE_ASSERT(validateRegistered(world));
+
+		world->update(UpdateParams());
+		CASE_ASSERT(world->haveEntity(mutate->m_add));
+		CASE_ASSERT(!world->haveEntity(mutate->m_remove));
+		CASE_ASSERT(validateRegistered(world));
+
+		mutate->m_add = nullptr;
+		mutate->m_remove = nullptr;
+		world->destroy();
+	}
+
+	// Benchmark gathering visible components; registered lists compared to traversing entities.
+	{
+		Ref< World > world = new World(nullptr, nullptr);
+		for (int32_t i = 0; i < 50000; ++i)
+		{
+			RefArray< IEntityComponent > components;
+			components.push_back(new ComponentA());
+			if ((i % 3) == 0)
+				components.push_back(new ComponentB());
+			Ref< Entity > entity = createEntity(components);
+			entity->setVisible((i % 10) != 3);
+			world->addEntity(entity);
+		}
+		for (int32_t i = 0; i < 1000; ++i)
+		{
+			Ref< Entity > entity = world->getEntities()[i * 7];
+			world->removeEntity(entity);
+		}
+		CASE_ASSERT(validateRegistered(world));
+
+		Timer timer;
+
+		uint32_t traverseCount = 0;
+		for (int32_t i = 0; i < 20; ++i)
+		{
+			for (auto entity : world->getEntities())
+			{
+				if (!entity->isVisible())
+					continue;
+				for (auto component : entity->getComponents())
+				{
+					if (is_type_of(type_of< ComponentB >(), type_of(component)))
+						++traverseCount;
+				}
+			}
+		}
+
+		const double traverseTime = timer.getDeltaTime();
+
+		uint32_t registeredCount = 0;
+		for (int32_t i = 0; i < 20; ++i)
+		{
+			for (const auto& it : world->getRegisteredComponents())
+			{
+				if (!is_type_of(type_of< ComponentB >(), *it.first))
+					continue;
+				for (const auto& rc : it.second)
+				{
+					if (rc.owner->isVisible())
+						++registeredCount;
+				}
+			}
+		}
+
+		const double registeredTime = timer.getDeltaTime();
+
+		CASE_ASSERT(traverseCount == registeredCount);
+
+		log::info << L"World gather 50k entities; traverse " << int32_t(traverseTime * 1000000.0 / 20.0) << L" us, registered " << int32_t(registeredTime * 1000000.0 / 20.0) << L" us" << Endl;
+
+		world->destroy();
+	}
+}
+
+}
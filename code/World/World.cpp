@@ -6,7 +6,9 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at https://mozilla.org/MPL/2.0/.
  */
+#include <algorithm>
 #include "World/Entity.h"
+#include "World/IEntityComponent.h"
 #include "World/IWorldComponent.h"
 #include "World/World.h"
 #include "World/Entity/CullingComponent.h"
@@ -37,6 +39,9 @@ void World::destroy()
 	}
 	m_entities.clear();
 
+	m_registeredComponents.clear();
+	m_registeredIndices.clear();
+
 	for (auto component : m_components)
 		component->destroy();
 	m_components.clear();
@@ -76,7 +81,11 @@ void World::addEntity(Entity* entity)
 	if (m_update)
 		m_deferredAdd.push_back(entity);
 	else
+	{
 		m_entities.push_back(entity);
+		for (auto component : entity->getComponents())
+			registerComponent(entity, component);
+	}
 	entity->setWorld(this);
 }
 
@@ -87,11 +96,18 @@ void World::removeEntity(Entity* entity)
 
 	T_FATAL_ASSERT(entity->getWorld() == this);
 	if (m_update)
+	{
+		// Entity no longer notify us about component changes so we
+		// keep it's current components until it's actually removed.
 		m_deferredRemove.push_back(entity);
+		m_deferredUnregister.insert(m_deferredUnregister.end(), entity->getComponents().begin(), entity->getComponents().end());
+	}
 	else
 	{
 		const bool removed = m_entities.remove(entity);
 		T_FATAL_ASSERT(removed);
+		for (auto component : entity->getComponents())
+			unregisterComponent(component);
 	}
 	entity->setWorld(nullptr);
 }
@@ -169,6 +185,11 @@ void World::update(const UpdateParams& update)
 	if (!m_deferredAdd.empty())
 	{
 		m_entities.insert(m_entities.end(), m_deferredAdd.begin(), m_deferredAdd.end());
+		for (auto entity : m_deferredAdd)
+		{
+			for (auto component : entity->getComponents())
+				registerComponent(entity, component);
+		}
 		m_deferredAdd.resize(0);
 	}
 
@@ -181,7 +202,49 @@ void World::update(const UpdateParams& update)
 			T_FATAL_ASSERT(removed);
 		}
 		m_deferredRemove.resize(0);
+
+		for (auto component : m_deferredUnregister)
+			unregisterComponent(component);
+		m_deferredUnregister.resize(0);
+	}
+}
+
+void World::replaceComponent(const Entity* owner, IEntityComponent* oldComponent, IEntityComponent* newComponent)
+{
+	// Components of entities pending to be added are registered when entity is actually added.
+	if (std::find(m_deferredAdd.begin(), m_deferredAdd.end(), owner) != m_deferredAdd.end())
+		return;
+
+	if (oldComponent != nullptr)
+		unregisterComponent(oldComponent);
+	registerComponent(owner, newComponent);
+}
+
+void World::registerComponent(const Entity* owner, IEntityComponent* component)
+{
+	auto& components = m_registeredComponents[&type_of(component)];
+	const auto it = m_registeredIndices.insert(std::make_pair(component, (uint32_t)components.size()));
+	if (it.second)
+		components.push_back({ component, owner });
+}
+
+void World::unregisterComponent(const IEntityComponent* component)
+{
+	const auto it = m_registeredIndices.find(component);
+	if (it == m_registeredIndices.end())
+		return;
+
+	// Move last component into removed component's slot.
+	auto& components = m_registeredComponents[&type_of(component)];
+	const uint32_t index = it->second;
+	if (index != components.size() - 1)
+	{
+		components[index] = components.back();
+		m_registeredIndices[components[index].component] = index;
 	}
+	components.pop_back();
+
+	m_registeredIndices.erase(it);
 }
 
 }
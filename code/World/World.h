@@ -8,9 +8,12 @@
  */
 #pragma once
 
+#include <map>
 #include "Core/Guid.h"
 #include "Core/Object.h"
 #include "Core/RefArray.h"
+#include "Core/Containers/AlignedVector.h"
+#include "Core/Containers/SmallMap.h"
 #include "Core/Math/Vector4.h"
 
 // import/export mechanism.
@@ -39,6 +42,7 @@ namespace traktor::world
 {
 
 class Entity;
+class IEntityComponent;
 class IWorldComponent;
 struct UpdateParams;
 
@@ -53,6 +57,15 @@ class T_DLLCLASS World : public Object
 	T_RTTI_CLASS;
 
 public:
+	struct RegisteredComponent
+	{
+		IEntityComponent* component;
+		const Entity* owner;
+	};
+
+	typedef AlignedVector< RegisteredComponent > registered_components_t;
+	typedef SmallMap< const TypeInfo*, registered_components_t > registered_component_map_t;
+
 	explicit World(resource::IResourceManager* resourceManager, render::IRenderSystem* renderSystem);
 
 	void destroy();
@@ -117,12 +130,37 @@ public:
 	/*! Get all entities of this world. */
 	const RefArray< Entity >& getEntities() const { return m_entities; }
 
+	/*! Get components of all entities in this world, grouped by exact component type.
+	 *
+	 * Lists are maintained incrementally as entities and
+	 * components are added or removed so systems, such as
+	 * world renderers, can iterate components of a certain
+	 * type without traversing all entities.
+	 *
+	 * Entities added or removed during update are reflected
+	 * first when they are actually added or removed at the
+	 * end of update. Order of components within a list is
+	 * not preserved.
+	 */
+	const registered_component_map_t& getRegisteredComponents() const { return m_registeredComponents; }
+
 private:
+	friend class Entity;
+
 	RefArray< IWorldComponent > m_components;
 	RefArray< Entity > m_entities;
 	RefArray< Entity > m_deferredAdd;
 	RefArray< Entity > m_deferredRemove;
+	RefArray< IEntityComponent > m_deferredUnregister;	//!< Components of entities removed during update, kept alive until unregistered.
 	bool m_update = false;
+	registered_component_map_t m_registeredComponents;
+	std::map< const IEntityComponent*, uint32_t > m_registeredIndices;	//!< Index of component in it's type list.
+
+	void replaceComponent(const Entity* owner, IEntityComponent* oldComponent, IEntityComponent* newComponent);
+
+	void registerComponent(const Entity* owner, IEntityComponent* component);
+
+	void unregisterComponent(const IEntityComponent* component);
 };
 
 }